@@ -0,0 +1,102 @@
+/**
+ * @file BaudDetector.h
+ * @brief Automatische Erkennung der Baudrate eines angeschlossenen Geräts.
+ *
+ * Die Erkennung läuft in zwei Stufen:
+ *  1. Die UART misst die kürzeste Pulsbreite auf RX (`UartPort::measureBaud()`). Liegt der
+ *     Messwert nahe an einer Kandidatenrate, wird diese zuerst geprüft.
+ *  2. Für jede Kandidatenrate wird die UART neu gestartet, eine kurze Stichprobe empfangen und
+ *     deren Lesbarkeit bewertet. Eine Rate mit ausreichend hoher Bewertung wird sofort
+ *     übernommen, ansonsten gewinnt nach dem Durchlauf die beste Rate oberhalb der Mindestbewertung.
+ *
+ * Mit passender Pulsmessung steht die Rate nach Messfenster plus einer Stichprobe fest, also
+ * nach wenigen hundert Millisekunden.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef BAUDDETECTOR_H
+#define BAUDDETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "UartPort.h"
+
+/**
+ * @struct BaudDetectResult
+ * @brief Ergebnis eines Erkennungslaufs.
+ */
+struct BaudDetectResult {
+	uint32_t baud;       ///< Erkannte Baudrate oder 0, wenn keine Rate überzeugt hat
+	float score;         ///< Bewertung der erkannten (bzw. besten) Stichprobe, 0..1
+	uint32_t measured;   ///< Aus der Pulsbreite gemessene Rate (0 = keine Messung)
+	uint16_t probes;     ///< Anzahl der geprüften Raten
+	uint32_t elapsedMs;  ///< Dauer des Laufs
+};
+
+/**
+ * @class BaudDetector
+ * @brief Ermittelt die Baudrate über Pulsmessung und Bewertung dekodierter Stichproben.
+ */
+class BaudDetector {
+   public:
+	static constexpr uint32_t MEASURE_MS = 100;   ///< Messfenster der Pulsbreite
+	static constexpr uint32_t PROBE_MS = 150;     ///< Maximale Dauer einer Stichprobe
+	static constexpr size_t SAMPLE_BYTES = 64;    ///< Bytes pro Stichprobe
+	static constexpr size_t MIN_BYTES = 8;        ///< Mindestgröße einer bewertbaren Stichprobe
+	static constexpr float LOCK_SCORE = 0.9f;     ///< Ab dieser Bewertung wird sofort übernommen
+	static constexpr float ACCEPT_SCORE = 0.75f;  ///< Mindestbewertung der besten Rate
+	static constexpr uint32_t TOLERANCE_PCT = 8;  ///< Zulässige Abweichung der Pulsmessung in Prozent
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param port UART, auf der gemessen und empfangen wird.
+	 */
+	explicit BaudDetector(UartPort &port);
+
+	/**
+	 * @brief Bewertet, wie sehr eine Stichprobe nach lesbarer Geräteausgabe aussieht.
+	 *
+	 * Druckbare ASCII-Zeichen, CR/LF/TAB und gültige UTF-8-Sequenzen zählen als lesbar. Bei
+	 * falscher Rate entstehen vor allem Steuerzeichen, Bytes mit gesetztem Bit 7 und Satzzeichen;
+	 * enthält eine Stichprobe kaum Buchstaben oder Ziffern, wird die Bewertung halbiert.
+	 *
+	 * @param data Stichprobe.
+	 * @param len Länge der Stichprobe.
+	 * @return Bewertung zwischen 0 (unlesbar) und 1 (vollständig lesbar).
+	 */
+	static float score(const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Ordnet eine gemessene Rate der nächstgelegenen Kandidatenrate zu.
+	 *
+	 * @param measured Gemessene Rate.
+	 * @param candidates Kandidatenraten.
+	 * @param count Anzahl der Kandidaten.
+	 * @return Kandidatenrate innerhalb von TOLERANCE_PCT oder 0.
+	 */
+	static uint32_t nearestBaud(uint32_t measured, const uint32_t *candidates, size_t count);
+
+	/**
+	 * @brief Führt einen Erkennungslauf aus (blockiert, bis eine Rate feststeht).
+	 *
+	 * Die UART ist danach auf die erkannte Rate eingestellt, ohne Treffer wieder auf `fallback`.
+	 *
+	 * @param candidates Kandidatenraten in Prüfreihenfolge.
+	 * @param count Anzahl der Kandidaten.
+	 * @param fallback Rate, auf die ohne Treffer zurückgestellt wird.
+	 * @return Ergebnis des Laufs.
+	 */
+	BaudDetectResult detect(const uint32_t *candidates, size_t count, uint32_t fallback);
+
+   private:
+	UartPort &_port;  ///< Zu untersuchende UART
+
+	size_t sample(uint8_t *buf, size_t len);
+	static size_t resyncOffset(const uint8_t *buf, size_t len);
+};
+
+#endif  // BAUDDETECTOR_H
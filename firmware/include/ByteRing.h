@@ -0,0 +1,72 @@
+/**
+ * @file ByteRing.h
+ * @brief Ringpuffer für Bytes auf einem vom Aufrufer bereitgestellten Speicherbereich.
+ *
+ * Der Puffer allokiert selbst nichts und ist nicht threadsicher; Sperren übernimmt der Besitzer.
+ * Schreiben und Lesen über die Umbruchstelle hinweg erledigen jeweils höchstens zwei `memcpy`.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef BYTERING_H
+#define BYTERING_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class ByteRing
+ * @brief FIFO für Bytes mit fester Kapazität.
+ */
+class ByteRing {
+   public:
+	/**
+	 * @brief Erzeugt einen leeren Ring ohne Speicher (Kapazität 0).
+	 */
+	ByteRing();
+
+	/**
+	 * @brief Setzt den Speicherbereich und leert den Ring.
+	 *
+	 * @param buf Speicherbereich (Besitz bleibt beim Aufrufer).
+	 * @param capacity Größe des Speicherbereichs in Bytes.
+	 */
+	void reset(uint8_t *buf, size_t capacity);
+
+	/**
+	 * @brief Verwirft den gesamten Inhalt.
+	 */
+	void clear();
+
+	/**
+	 * @brief Hängt `len` Bytes an.
+	 *
+	 * @return false, wenn nicht genug Platz frei ist (es wird dann nichts geschrieben).
+	 */
+	bool push(const void *data, size_t len);
+
+	/**
+	 * @brief Kopiert Bytes ab `offset` (relativ zum ältesten Byte), ohne sie zu entfernen.
+	 *
+	 * @return Anzahl der kopierten Bytes.
+	 */
+	size_t peek(void *out, size_t len, size_t offset = 0) const;
+
+	/**
+	 * @brief Entfernt die ältesten `len` Bytes.
+	 */
+	void drop(size_t len);
+
+	size_t capacity() const;  ///< Gesamtgröße
+	size_t size() const;      ///< Belegte Bytes
+	size_t space() const;     ///< Freie Bytes
+
+   private:
+	uint8_t *_buf;     ///< Speicherbereich
+	size_t _capacity;  ///< Größe des Speicherbereichs
+	size_t _head;      ///< Position des ältesten Bytes
+	size_t _size;      ///< Belegte Bytes
+};
+
+#endif  // BYTERING_H
@@ -0,0 +1,66 @@
+/**
+ * @file CaptureStore.h
+ * @brief Abstrakter Dateispeicher für Mitschnitte der seriellen Schnittstelle.
+ *
+ * Der SerialRecorder schreibt ausschließlich über diese Schnittstelle. Auf dem ESP32 wird sie
+ * von `LittleFsCaptureStore` (Verzeichnis `/logs/device`) implementiert, in den nativen
+ * Unit-Tests von einem Speicher im RAM (`test/support/FakeCaptureStore.h`).
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef CAPTURESTORE_H
+#define CAPTURESTORE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class CaptureStore
+ * @brief Ablage von Mitschnittdateien; immer nur eine Datei ist zum Schreiben geöffnet.
+ */
+class CaptureStore {
+   public:
+	virtual ~CaptureStore() {}
+
+	/**
+	 * @brief Legt eine Datei neu an (oder leert sie) und öffnet sie zum Anhängen.
+	 *
+	 * @param name Dateiname ohne Verzeichnis.
+	 * @return false, wenn die Datei nicht angelegt werden konnte.
+	 */
+	virtual bool open(const char *name) = 0;
+
+	/**
+	 * @brief Hängt Daten an die geöffnete Datei an.
+	 *
+	 * @return Anzahl der geschriebenen Bytes.
+	 */
+	virtual size_t write(const uint8_t *data, size_t len) = 0;
+
+	/**
+	 * @brief Schließt die geöffnete Datei.
+	 */
+	virtual void close() = 0;
+
+	/**
+	 * @brief Belegter Speicher aller Mitschnittdateien in Bytes.
+	 */
+	virtual size_t usedBytes() = 0;
+
+	/**
+	 * @brief Freier Speicher des Dateisystems in Bytes.
+	 */
+	virtual size_t freeBytes() = 0;
+
+	/**
+	 * @brief Löscht die älteste Mitschnittdatei außer `keep`.
+	 *
+	 * @param keep Name der Datei, die erhalten bleiben muss (aktuelles Segment).
+	 * @return Größe der gelöschten Datei, 0 wenn nichts gelöscht werden konnte.
+	 */
+	virtual size_t removeOldest(const char *keep) = 0;
+};
+
+#endif  // CAPTURESTORE_H
@@ -0,0 +1,53 @@
+/**
+ * @file CriticalSection.h
+ * @brief Kurzer gegenseitiger Ausschluss für die hardwareunabhängigen Module.
+ *
+ * Auf dem ESP32 ein `portMUX_TYPE` mit `portENTER_CRITICAL`/`portEXIT_CRITICAL` (wie im
+ * StatusHandler), im `env:native` ein `std::mutex`. Innerhalb des Abschnitts darf weder
+ * blockiert noch Speicher angefordert werden.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef CRITICALSECTION_H
+#define CRITICALSECTION_H
+
+#ifdef UNIT_TEST
+#include <mutex>
+#else
+#include <freertos/FreeRTOS.h>
+#endif
+
+/**
+ * @class CriticalSection
+ * @brief Sperre für kurze Abschnitte zwischen Tasks.
+ */
+class CriticalSection {
+   public:
+#ifdef UNIT_TEST
+	void enter() {
+		_mutex.lock();
+	}
+	void exit() {
+		_mutex.unlock();
+	}
+
+   private:
+	std::mutex _mutex;  ///< Host-Sperre
+#else
+	CriticalSection() : _mux(portMUX_INITIALIZER_UNLOCKED) {
+	}
+	void enter() {
+		portENTER_CRITICAL(&_mux);
+	}
+	void exit() {
+		portEXIT_CRITICAL(&_mux);
+	}
+
+   private:
+	portMUX_TYPE _mux;  ///< Spinlock des ESP32
+#endif
+};
+
+#endif  // CRITICALSECTION_H
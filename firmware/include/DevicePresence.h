@@ -0,0 +1,151 @@
+/**
+ * @file DevicePresence.h
+ * @brief Entprellte Erkennung, ob an einer UART ein Gerät angeschlossen ist.
+ *
+ * Lebenszeichen eines Geräts sind empfangene Bytes (activity()) und, falls die RX-Leitung
+ * einen Pull-down hat, ihr Ruhepegel HIGH (level()). Daraus leitet update() zwei Ereignisse ab:
+ *  - verbunden: sofort mit dem ersten empfangenen Byte (die UART hat ein vollständiges Zeichen
+ *    erkannt); ein HIGH-Pegel allein erst nach mindestens `debounceMs`, ohne dass dazwischen
+ *    `idleMs` Stille lag (ein einzelner Störimpuls beim Einstecken reicht nicht),
+ *  - getrennt: `idleMs` ohne Lebenszeichen oder, mit Pegelauswertung, RX durchgehend LOW
+ *    über `debounceMs` (Leitung nicht mehr getrieben).
+ *
+ * Die Klasse merkt sich nur Zeitstempel und entscheidet erst in update(); sie kann deshalb
+ * direkt aus dem Empfangspfad gefüttert werden.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef DEVICEPRESENCE_H
+#define DEVICEPRESENCE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum DevicePresenceEvent
+ * @brief Ergebnis von DevicePresence::update().
+ */
+enum DevicePresenceEvent {
+	PRESENCE_NONE,         ///< Keine Änderung
+	PRESENCE_CONNECTED,    ///< Gerät wurde erkannt
+	PRESENCE_DISCONNECTED  ///< Gerät ist nicht mehr da
+};
+
+/**
+ * @struct DevicePresenceConfig
+ * @brief Schwellen der Geräteerkennung.
+ */
+struct DevicePresenceConfig {
+	uint32_t debounceMs;  ///< Mindestdauer des HIGH-Pegels bis "verbunden" bzw. des LOW-Pegels bis "getrennt" (0 = sofort)
+	uint32_t idleMs;      ///< Stille bis "getrennt" (0 = nie wegen Stille)
+	bool levelSense;      ///< RX-Pegel auswerten (nur mit Pull-down auf RX sinnvoll)
+};
+
+/**
+ * @struct DevicePresenceStats
+ * @brief Zähler der Geräteerkennung.
+ */
+struct DevicePresenceStats {
+	uint32_t connects;     ///< Gemeldete Verbindungen
+	uint32_t disconnects;  ///< Gemeldete Trennungen
+	uint32_t glitches;     ///< Verworfene Pegel-Lebenszeichen (kürzer als debounceMs, danach Stille)
+};
+
+/**
+ * @class DevicePresence
+ * @brief Zustandsautomat aus Lebenszeichen und Zeitschwellen.
+ */
+class DevicePresence {
+   public:
+	static constexpr uint32_t DEFAULT_DEBOUNCE_MS = 50;  ///< Standard-Entprellzeit
+	static constexpr uint32_t DEFAULT_IDLE_MS = 30000;   ///< Standard-Stille bis "getrennt"
+	static constexpr uint32_t MAX_MS = 3600000;          ///< Obergrenze beider Schwellen
+
+	/**
+	 * @brief Konstruktor; startet mit defaultConfig() im Zustand "getrennt".
+	 */
+	DevicePresence();
+
+	/**
+	 * @brief Standard: 50 ms Entprellung, 30 s Stille, ohne Pegelauswertung.
+	 */
+	static DevicePresenceConfig defaultConfig();
+
+	/**
+	 * @brief Prüft eine Konfiguration auf Plausibilität.
+	 */
+	static bool validate(const DevicePresenceConfig &config);
+
+	/**
+	 * @brief Übernimmt neue Schwellen; der aktuelle Zustand bleibt erhalten.
+	 *
+	 * @return false, wenn die Konfiguration ungültig ist.
+	 */
+	bool configure(const DevicePresenceConfig &config);
+
+	/**
+	 * @brief Gibt die aktive Konfiguration zurück.
+	 */
+	const DevicePresenceConfig &config() const;
+
+	/**
+	 * @brief Meldet empfangene Bytes (oder eine Flanke auf RX).
+	 *
+	 * @param nowMs Aktuelle Zeit in ms.
+	 */
+	void activity(uint32_t nowMs);
+
+	/**
+	 * @brief Meldet den abgetasteten RX-Pegel (wird ohne `levelSense` ignoriert).
+	 *
+	 * @param high true bei Ruhepegel HIGH.
+	 * @param nowMs Aktuelle Zeit in ms.
+	 */
+	void level(bool high, uint32_t nowMs);
+
+	/**
+	 * @brief Wertet die Schwellen aus.
+	 *
+	 * @param nowMs Aktuelle Zeit in ms.
+	 * @return PRESENCE_CONNECTED/PRESENCE_DISCONNECTED bei einem Wechsel, sonst PRESENCE_NONE.
+	 */
+	DevicePresenceEvent update(uint32_t nowMs);
+
+	/**
+	 * @brief true, solange ein Gerät als verbunden gilt.
+	 */
+	bool present() const;
+
+	/**
+	 * @brief Zeit des letzten Lebenszeichens in ms (nur gültig, wenn hasActivity()).
+	 */
+	uint32_t lastSeen() const;
+
+	/**
+	 * @brief true, sobald es mindestens ein Lebenszeichen gab.
+	 */
+	bool hasActivity() const;
+
+	/**
+	 * @brief Gibt die Zähler zurück.
+	 */
+	const DevicePresenceStats &stats() const;
+
+   private:
+	DevicePresenceConfig _cfg;    ///< Aktive Schwellen
+	DevicePresenceStats _stats;   ///< Zähler
+	bool _present;                ///< Gerät gilt als verbunden
+	bool _seen;                   ///< Es gab mindestens ein Lebenszeichen
+	bool _candidate;              ///< Lebenszeichen laufen, "verbunden" noch nicht bestätigt
+	bool _received;               ///< Unter den laufenden Lebenszeichen sind empfangene Bytes
+	uint32_t _firstSeen;          ///< Beginn der laufenden Lebenszeichen
+	uint32_t _lastSeen;           ///< Letztes Lebenszeichen
+	bool _low;                    ///< RX liegt seit _lowSince auf LOW
+	uint32_t _lowSince;           ///< Beginn des LOW-Pegels
+
+	void seen(uint32_t nowMs);
+};
+
+#endif  // DEVICEPRESENCE_H
@@ -0,0 +1,78 @@
+/**
+ * @file EspUartPort.h
+ * @brief UartPort-Implementierung auf Basis des ESP-IDF-UART-Treibers.
+ *
+ * Im Gegensatz zu `HardwareSerial` wird der Treiber direkt mit einer Event-Queue installiert,
+ * sodass die SerialBridge auf Daten, FIFO-Überläufe, Breaks und erkannte Zeilenenden
+ * blockieren kann. Der Ringpuffer ist für die höchste unterstützte Rate bemessen; Wechsel der
+ * Baudrate stellen nur den laufenden Treiber um.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef ESPUARTPORT_H
+#define ESPUARTPORT_H
+
+#include <Arduino.h>
+#include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+#include "UartPort.h"
+
+/**
+ * @class EspUartPort
+ * @brief Zugriff auf eine Hardware-UART des ESP32 über den IDF-Treiber.
+ */
+class EspUartPort : public UartPort {
+   public:
+	static constexpr int EVENT_QUEUE_LEN = 20;        ///< Länge der Treiber-Event-Queue
+	static constexpr uint8_t RX_TIMEOUT_SYMBOLS = 3;  ///< RX-Timeout in Zeichenzeiten bis zum Data-Event
+	static constexpr uint8_t RTS_THRESHOLD = 100;     ///< RX-FIFO-Füllstand, ab dem RTS zurückgenommen wird
+	static constexpr uint8_t XON_THRESHOLD = 20;      ///< RX-FIFO-Füllstand, unter dem XON gesendet wird
+	static constexpr uint8_t XOFF_THRESHOLD = 100;    ///< RX-FIFO-Füllstand, ab dem XOFF gesendet wird
+	static constexpr uint32_t AUTOBAUD_MIN_EDGES = 30;  ///< Mindestanzahl Flanken für eine Pulsmessung
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param uartNum UART-Nummer (z. B. UART_NUM_2).
+	 * @param rxPin RX-Pin.
+	 * @param txPin TX-Pin.
+	 * @param rtsPin RTS-Pin (auch DE-Pin im RS-485-Betrieb), -1 = nicht belegt.
+	 * @param ctsPin CTS-Pin, -1 = nicht belegt.
+	 * @param bootPin Boot-Leitung zum Controller (aktiv low), -1 = nicht belegt.
+	 * @param resetPin Reset-Leitung zum Controller (aktiv low), -1 = nicht belegt.
+	 */
+	EspUartPort(uart_port_t uartNum, int8_t rxPin, int8_t txPin, int8_t rtsPin = -1, int8_t ctsPin = -1, int8_t bootPin = -1, int8_t resetPin = -1);
+
+	bool begin(uint32_t baud) override;
+	size_t available() override;
+	size_t read(uint8_t *buf, size_t len) override;
+	size_t write(const uint8_t *buf, size_t len) override;
+	void flushInput() override;
+	bool waitEvent(UartEvent &evt, uint32_t timeoutMs) override;
+	void sleep(uint32_t ms) override;
+	uint32_t now() override;
+	bool waitTxDone(uint32_t timeoutMs) override;
+	bool setFlowControl(SerialFlowControl mode) override;
+	void setDriverEnable(bool on) override;
+	void delayMicros(uint32_t us) override;
+	uint32_t measureBaud(uint32_t windowMs) override;
+	bool setBootLines(bool boot, bool reset) override;
+
+   private:
+	uart_port_t _uartNum;      ///< UART-Nummer
+	int8_t _rxPin, _txPin;     ///< RX- und TX-Pin
+	int8_t _rtsPin, _ctsPin;   ///< RTS-/DE- und CTS-Pin
+	int8_t _bootPin, _resetPin;  ///< Boot- und Reset-Leitung zum Controller
+	QueueHandle_t _queue;      ///< Event-Queue des Treibers
+	bool _installed;           ///< Treiber installiert?
+	SerialFlowControl _flow;   ///< Aktive Flusskontrolle (wird bei der Installation gesetzt)
+	bool _dePinReady;          ///< DE-Pin bereits als Ausgang konfiguriert?
+
+	bool applyFlowControl();
+};
+
+#endif  // ESPUARTPORT_H
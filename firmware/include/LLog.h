@@ -16,6 +16,10 @@
  * Das Logging kann zur Laufzeit aktiviert oder deaktiviert werden. Die Klasse bietet zusätzlich einfache
  * Methoden zum Loggen mit oder ohne Zeilenumbruch, und mit/ohne Zeitstempel.
  *
+ * Aufrufer formatieren nur in einen vorab angelegten Eintrag der sperrfreien LogQueue; Zeitstempel,
+ * serielle Ausgabe und Dateizugriffe erledigt die Schreib-Task (startWriter()) gebündelt mit
+ * niedriger Priorität. Vor dem Start der Task wird wie bisher sofort geschrieben.
+ *
  * @author Simon Marcel Linden
  * @since 1.0.0
  */
@@ -26,15 +30,33 @@
 #include <Arduino.h>
 #include <LittleFS.h>
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
 #include <ctime>
 #include <vector>
 
+#include "LogCodec.h"
+#include "LogFilter.h"
+#include "LogJournal.h"
+#include "LogQueue.h"
+#include "LogSegments.h"
+
 /**
  * @brief Singleton-Klasse zur Verwaltung von systemweitem Logging.
  *
- * Erstellt und verwendet separate Logdateien für jedes Log-Level:
- * debug.log, info.log, system.log, warning.log, error.log
- * im Unterverzeichnis /logs/system. Logs werden zusätzlich auf der seriellen Konsole ausgegeben.
+ * Alle Kategorien (debug, info, system, warning, error, ...) landen in einem gemeinsamen Journal
+ * aus Segmenten `/logs/system/journal.<n>.log`; jede Zeile trägt die Bitmaske ihrer Kategorien
+ * (siehe LogJournal) und wird nur einmal geschrieben. Größe und Zahl der Segmente sowie das
+ * Gesamtbudget für `/logs` sind begrenzt, die ältesten Segmente werden zuerst gelöscht (siehe
+ * LogSegments). Logs werden zusätzlich auf der seriellen Konsole ausgegeben.
+ * Alte Kategoriedateien (`<event>.log`) werden beim Start einmalig ins Journal übernommen.
+ *
+ * Neue Aufrufe nutzen LOGF() mit Kategorie-Bitmaske (LogFilter): gesperrte Kategorien kosten
+ * weder Formatierung noch Allokation, zur Übersetzungszeit gesperrte gar nichts. Häufige
+ * Meldungen mit festem Text nutzen LOGB() mit einem Format aus LogFormats.h: Sie werden nie auf
+ * dem Gerät formatiert, außer für die serielle Konsole, und belegen im Journal nur wenige Bytes.
  */
 class LLog {
    public:
@@ -44,6 +66,20 @@ class LLog {
 	static LLog &getInstance();
 
 	static const std::vector<String> Events;
+	static constexpr const char *JOURNAL_DIR = "/logs/system";  ///< Verzeichnis der Journal-Segmente
+
+	/**
+	 * @brief Pfad eines Journal-Segments (`/logs/system/journal.<seq>.log`).
+	 */
+	static String segmentPath(uint32_t seq);
+
+	/**
+	 * @brief Bit einer Kategorie im Journal (Bit i = Events[i]; unbekannte gehen nach "general").
+	 *
+	 * @param event Kategorie, z. B. "info" oder "[INFO]" (Groß-/Kleinschreibung egal).
+	 */
+	static uint16_t categoryBit(const char *event);
+
 	/**
 	 * @brief Gibt eine Lognachricht ohne Zeilenumbruch aus.
 	 *
@@ -103,22 +139,80 @@ class LLog {
 	void log(const std::vector<String> &events, const String &message, bool newLine = true);
 
 	/**
-	 * @brief Löscht den Inhalt einer einzelnen Log-Datei.
+	 * @brief Formatiert eine Meldung direkt in die Warteschlange (ohne Heap, mit Zeitstempel).
+	 *
+	 * Nicht direkt aufrufen, sondern über LOGF(), das vorher die Kategorien prüft.
+	 *
+	 * @param cats Kategorien (LogCategory).
+	 * @param fmt printf-Format, gefolgt von den Argumenten.
+	 */
+	void emitf(uint32_t cats, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+	/**
+	 * @brief Reiht einen binären Eintrag ein: Format-ID und kodierte Argumente, ohne Formatierung.
+	 *
+	 * Nicht direkt aufrufen, sondern über LOGB(), das vorher die Kategorien prüft.
+	 *
+	 * @tparam Id Format aus LogFormats.h.
+	 * @param cats Kategorien (LogCategory).
+	 * @param args Argumente passend zum Format (zur Übersetzungszeit geprüft).
+	 */
+	template <uint16_t Id, typename... Args>
+	void emitb(uint32_t cats, Args... args) {
+		static_assert(LogFormatCheck<Id, Args...>::value, "LOGB: Argumente passen nicht zum Format in LogFormats.h");
+		uint32_t ticket;
+		LogRecord *rec = _queue.reserve(ticket);
+		if (rec) {
+			rec->time = (uint32_t)::time(nullptr);
+			rec->files = LogFilter::journalBits(cats);
+			rec->flags = LOG_RECORD_NEWLINE | LOG_RECORD_TIMESTAMP | LOG_RECORD_BINARY;
+			rec->format = Id;
+			rec->cats = (uint16_t)cats;
+			rec->tags[0] = '\0';
+			rec->argBytes = (uint8_t)LogCodec::encode((uint8_t *)rec->text, sizeof(rec->text), args...);
+			_queue.commit(ticket);
+		}
+		wake();
+	}
+
+	/**
+	 * @brief Setzt die zur Laufzeit freigegebenen Kategorien und speichert sie.
+	 *
+	 * @param mask Bitmaske aus LogCategory.
+	 */
+	static void setCategories(uint32_t mask);
+
+	/**
+	 * @brief Entfernt alle Einträge einer Kategorie aus dem Journal.
 	 * @param event Event-Name ohne ".log".
 	 */
 	void clearLog(const String &event);
 
 	/**
-	 * @brief Löscht mehrere Log-Dateien.
+	 * @brief Entfernt die Einträge mehrerer Kategorien (ein Durchlauf durch das Journal).
 	 * @param events Vektor der Event-Namen ohne ".log".
 	 */
 	void clearLogs(const std::vector<String> &events);
 
 	/**
-	 * @brief Automatisches Aufräumen: löscht Logdateien, die größer als maxSize sind.
-	 * @param maxSize Maximale Dateigröße in Bytes (Default: 1000 KB).
+	 * @brief Pfade aller Journal-Segmente, ältestes zuerst.
+	 */
+	std::vector<String> journalSegments();
+
+	/**
+	 * @brief Gesamtgröße des Journals in Bytes (aus der Buchführung, ohne Dateizugriff).
+	 */
+	uint32_t journalBytes();
+
+	/**
+	 * @brief Setzt Segmentgröße, Segmentzahl und Budget, speichert sie und räumt sofort auf.
+	 */
+	void setRotation(const LogRotationConfig &config);
+
+	/**
+	 * @brief Aktuelle Grenzen der Rotation.
 	 */
-	void clearLargeLogs(size_t maxSize = 100 * 1024);
+	LogRotationConfig rotationConfig();
 
 	/**
      * @brief Erstellt (oder überschreibt) eine Logdatei im Verzeichnis /logs/device.
@@ -139,7 +233,50 @@ class LLog {
 	 */
 	static bool isFileLogging();
 
+	/**
+	 * @brief Startet die Schreib-Task; ab dann reihen Aufrufer nur noch ein.
+	 *
+	 * Registriert zusätzlich einen Shutdown-Handler, der vor `esp_restart()` alle wartenden
+	 * Einträge schreibt.
+	 *
+	 * @param priority FreeRTOS-Priorität (niedrig halten).
+	 * @param core CPU-Kern.
+	 */
+	void startWriter(UBaseType_t priority = 1, BaseType_t core = 0);
+
+	/**
+	 * @brief Schreibt alle wartenden Einträge sofort im aufrufenden Task.
+	 *
+	 * Für geplante Neustarts und Fehlerpfade; wartet höchstens FLUSH_WAIT_MS auf die Schreib-Task.
+	 */
+	void flush();
+
+	/**
+	 * @brief Zähler der Warteschlange (eingereiht, verworfen, höchster Füllstand).
+	 */
+	LogQueueStats queueStats() const;
+
    private:
+	static constexpr uint32_t WRITER_INTERVAL_MS = 200;   ///< Spätestens so oft schreibt die Schreib-Task
+	static constexpr size_t WRITER_BATCH = 8;             ///< Einträge je Block (eine Dateiöffnung)
+	static constexpr uint32_t FLUSH_WAIT_MS = 200;        ///< Wartezeit von flush() auf einen laufenden Block
+	static constexpr uint32_t SEGMENT_BYTES = 32 * 1024;  ///< Standard: Größe eines Segments
+	static constexpr uint16_t SEGMENT_COUNT = 16;         ///< Standard: Höchstzahl der Segmente
+	static constexpr uint32_t LOG_BUDGET = 1024 * 1024;   ///< Standard: Budget für /logs
+	static constexpr uint32_t NO_MARK = 0xFFFFFFFFu;      ///< Noch keine Zeitmarke geschrieben
+	static constexpr size_t BINARY_PAYLOAD = LogCodec::ENTRY_HEADER + LogRecord::TEXT;  ///< Größter Inhalt einer binären Zeile
+
+	LogQueue _queue;                                       ///< Eingereihte, noch nicht geschriebene Einträge
+	TaskHandle_t _writerTask;                              ///< Schreib-Task (nullptr = synchron schreiben)
+	SemaphoreHandle_t _drainLock;                          ///< Nur ein Verbraucher der Warteschlange
+	uint32_t _reportedDrops;                               ///< Bereits gemeldete verworfene Einträge
+	char _lines[WRITER_BATCH][LogQueue::LINE_BYTES];       ///< Formatierte Zeilen eines Blocks
+	LogSegments _segments;                                 ///< Segmente und Größen (unter _drainLock)
+	uint32_t _markTime;                                    ///< Letzte Zeitmarke für binäre Einträge
+	uint32_t _markSeq;                                     ///< Segment der letzten Zeitmarke (NO_MARK = keine)
+	uint8_t _payload[BINARY_PAYLOAD];                      ///< Inhalt einer binären Zeile
+	char _binaryLine[LogJournal::binaryLineBytes(BINARY_PAYLOAD)];  ///< Maskierte binäre Zeile, Lesepuffer von clearCategories()
+
 	LLog();
 	LLog(const LLog &) = delete;
 	void operator=(const LLog &) = delete;
@@ -155,20 +292,114 @@ class LLog {
 	void logMessage(const std::vector<String> &levels, const String &message, bool newLine = true, bool timestamp = true);
 
 	/**
-	 * @brief Erzeugt einen Zeitstempel im Format YYYY-MM-DD hh:mm:ss.
+	 * @brief Reiht einen Eintrag ein und weckt ggf. die Schreib-Task.
+	 *
+	 * @param tags Kategorien, z. B. "[SYSTEM][INFO]".
+	 * @param files Kategorien im Journal (Bit i = Events[i]).
+	 * @param flags LogRecordFlags.
+	 * @param message Nachricht.
+	 */
+	void enqueue(const char *tags, uint16_t files, uint8_t flags, const String &message);
+
+	/**
+	 * @brief Schreibt sofort (ohne Schreib-Task) oder weckt die Schreib-Task bei halb voller
+	 *        Warteschlange.
+	 */
+	void wake();
+
+	/**
+	 * @brief Schreibt alle fertigen Einträge blockweise (Aufrufer hält _drainLock).
+	 *
+	 * @return Anzahl der geschriebenen Einträge.
+	 */
+	size_t drain();
+
+	/**
+	 * @brief Schreibt einen binären Eintrag ins Journal, bei Bedarf mit neuer Zeitmarke davor.
+	 *
+	 * Eine Zeitmarke folgt beim ersten Eintrag eines Segments und wenn der Abstand nicht mehr
+	 * in LogCodec::MARK_SPAN passt (Aufrufer hält _drainLock).
+	 *
+	 * @return Geschriebene Bytes.
+	 */
+	size_t writeBinary(File &f, const LogRecord &rec);
+
+	/**
+	 * @brief Task-Funktion der Schreib-Task.
+	 */
+	static void writerTaskFunc(void *param);
+
+	/**
+	 * @brief Shutdown-Handler: schreibt vor einem Neustart alle wartenden Einträge.
 	 */
-	String getTimestamp();
+	static void onShutdown();
 
 	static bool m_fileLogging;  ///< File-Logging an/aus
 
 	/**
-	 * @brief Schreibt eine bereits formatierte Zeile in die Logdatei.
-	 *        (Nur auf Dateisystem)
+	 * @brief Öffnet das aktuelle Segment zum Anhängen (legt es bei Bedarf an).
+	 */
+	File openJournal();
+
+	/**
+	 * @brief Liest die vorhandenen Segmente und ihre Größen ein (einmalig beim Start).
+	 *
+	 * Übernimmt ein ungeteiltes `journal.log` als jüngstes Segment.
+	 */
+	void scanSegments();
+
+	/**
+	 * @brief Löscht älteste Segmente, bis Segmentzahl und Budget eingehalten sind (Aufrufer hält
+	 *        _drainLock oder es läuft noch keine Schreib-Task).
+	 */
+	void enforceLimits();
+
+	/**
+	 * @brief Summe der Dateien unter `/logs/device`.
+	 */
+	static uint32_t deviceLogBytes();
+
+	/**
+	 * @brief Übernimmt alte Kategoriedateien (`<event>.log`) ins Journal und löscht sie.
+	 *
+	 * Jede Zeile erhält nur das Bit ihrer bisherigen Datei; die Ansicht einer Kategorie zeigt
+	 * danach genau den alten Dateiinhalt vor den neuen Einträgen.
+	 */
+	void migrateLegacyLogs();
+
+	/**
+	 * @brief Schreibt das Journal ohne die angegebenen Kategorien neu.
+	 *
+	 * @param bits Zu entfernende Kategorien.
 	 */
-	void logToFile(const String &filename, const String &entry);
+	void clearCategories(uint16_t bits);
 };
 
 // Convenience-Makro für globale Instanz
 #define logger LLog::getInstance()
 
+/**
+ * @brief Loggt eine Meldung mit Kategorie-Bitmaske und printf-Format.
+ *
+ * Die Kategorien müssen ein konstanter Ausdruck sein; Argumente werden nur ausgewertet, wenn
+ * die Meldung ausgegeben wird. Strings als `const char *` übergeben (`c_str()`).
+ *
+ * @code
+ * LOGF(LOG_CAT_SYSTEM | LOG_CAT_INFO | LOG_CAT_WIFI, "Verbunden mit %s", ssid.c_str());
+ * @endcode
+ */
+#define LOGF(cats, ...) LOG_IF_ENABLED(cats, LLog::getInstance().emitf((cats), __VA_ARGS__))
+
+/**
+ * @brief Loggt eine häufige Meldung binär: Format-ID aus LogFormats.h plus rohe Argumente.
+ *
+ * Wie LOGF(), aber ohne Formatierung im Aufrufer; ins Journal gelangen wenige Bytes, der Text
+ * entsteht erst beim Anzeigen. Anzahl und Typen der Argumente prüft der Compiler.
+ *
+ * @code
+ * LOGB(LOG_CAT_SOCKET | LOG_CAT_INFO, LOG_FMT_WS_CLIENT_CONNECTED, (unsigned)client->id());
+ * @endcode
+ */
+#define LOGB(cats, id, ...) LOG_IF_ENABLED(cats, LLog::getInstance().emitb<(id)>((cats), ##__VA_ARGS__))
+
 #endif  // LLOG_H
@@ -0,0 +1,48 @@
+/**
+ * @file LittleFsCaptureStore.h
+ * @brief CaptureStore auf LittleFS im Verzeichnis `/logs/device`.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef LITTLEFSCAPTURESTORE_H
+#define LITTLEFSCAPTURESTORE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#include "CaptureStore.h"
+
+/**
+ * @class LittleFsCaptureStore
+ * @brief Legt Mitschnitte als `*.cap`-Dateien unter `/logs/device` ab.
+ *
+ * Mehrere Kanäle teilen sich das Verzeichnis; jede Instanz trägt sich in eine Liste ein, damit
+ * `removeOldest()` kein Segment löscht, das ein anderer Kanal gerade beschreibt.
+ */
+class LittleFsCaptureStore : public CaptureStore {
+   public:
+	static constexpr const char *DIR = "/logs/device";  ///< Ablageverzeichnis
+	static constexpr size_t MAX_STORES = 4;             ///< Maximale Anzahl gleichzeitiger Instanzen
+
+	LittleFsCaptureStore();
+	~LittleFsCaptureStore();
+
+	bool open(const char *name) override;
+	size_t write(const uint8_t *data, size_t len) override;
+	void close() override;
+	size_t usedBytes() override;
+	size_t freeBytes() override;
+	size_t removeOldest(const char *keep) override;
+
+   private:
+	File _file;    ///< Geöffnetes Segment
+	String _name;  ///< Name des geöffneten Segments
+
+	static LittleFsCaptureStore *_stores[MAX_STORES];  ///< Alle Instanzen (für removeOldest)
+
+	static bool isOpen(const String &name);
+};
+
+#endif  // LITTLEFSCAPTURESTORE_H
@@ -0,0 +1,159 @@
+/**
+ * @file LogCodec.h
+ * @brief Kompakte Kodierung binärer Logeinträge (Format-ID plus rohe Argumente).
+ *
+ * Ein mit LOGB() erzeugter Eintrag wird nicht formatiert: In die Warteschlange und ins Journal
+ * gelangen nur die ID aus LogFormats.h und die Argumente. Zahlen werden als LEB128-Varint
+ * abgelegt (vorzeichenbehaftete per Zigzag), Texte mit Länge davor. Im Journal wird daraus eine
+ * binäre Zeile (LogJournal::encodeBinary()) mit diesem Inhalt:
+ *
+ * - Zeitmarke (Journal-Bits 0): Varint mit der Unix-Zeit.
+ * - Eintrag: Varint Kategorien (LogCategory), Varint Sekunden seit der letzten Zeitmarke im
+ *   selben Segment, Varint Format-ID, Argumente.
+ *
+ * Eine typische Meldung wie `WS Client connected: 3` belegt so 7 statt rund 65 Bytes.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef LOGCODEC_H
+#define LOGCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "LogFormats.h"
+
+/**
+ * @struct LogBinaryEntry
+ * @brief Zerlegter Eintrag einer binären Journalzeile.
+ */
+struct LogBinaryEntry {
+	uint32_t cats;        ///< Kategorien (LogCategory)
+	uint32_t delta;       ///< Sekunden seit der Zeitmarke
+	uint16_t format;      ///< Format-ID (LogFormatId)
+	const uint8_t *args;  ///< Kodierte Argumente
+	size_t argBytes;      ///< Länge der Argumente
+};
+
+/**
+ * @class LogCodec
+ * @brief Kodieren und Darstellen binärer Logeinträge (ohne Dateizugriff).
+ */
+class LogCodec {
+   public:
+	static constexpr size_t MAX_STRING = 64;      ///< Höchstlänge eines Text-Arguments
+	static constexpr uint32_t MARK_SPAN = 16383;  ///< Größter Abstand zur Zeitmarke (Varint mit 2 Bytes)
+	static constexpr size_t ENTRY_HEADER = 9;     ///< Höchstens Kategorien, Abstand und ID vor den Argumenten
+
+	/**
+	 * @brief Schreibt eine Zahl als Varint.
+	 *
+	 * @return Geschriebene Bytes oder 0, wenn der Puffer nicht reicht.
+	 */
+	static size_t putUnsigned(uint8_t *buf, size_t size, uint32_t value);
+
+	/**
+	 * @brief Schreibt eine vorzeichenbehaftete Zahl (Zigzag, dann Varint).
+	 */
+	static size_t putSigned(uint8_t *buf, size_t size, int32_t value);
+
+	/**
+	 * @brief Schreibt einen Text mit Länge davor (höchstens MAX_STRING Bytes, nullptr wie "").
+	 */
+	static size_t putString(uint8_t *buf, size_t size, const char *text);
+
+	/**
+	 * @brief Liest einen Varint.
+	 *
+	 * @param p Leseposition, wird weitergesetzt.
+	 * @param end Ende der Daten.
+	 * @param value Erhält den Wert.
+	 * @return false bei unvollständigen Daten.
+	 */
+	static bool getUnsigned(const uint8_t *&p, const uint8_t *end, uint32_t &value);
+
+	/**
+	 * @brief Kodiert die Argumente eines Aufrufs in der Reihenfolge des Formats.
+	 *
+	 * @return Länge der kodierten Argumente.
+	 */
+	static size_t encode(uint8_t *, size_t) {
+		return 0;
+	}
+
+	template <typename T, typename... Rest>
+	static size_t encode(uint8_t *buf, size_t size, T value, Rest... rest) {
+		size_t n = putArg(buf, size, value);
+		return n + encode(buf + n, size - n, rest...);
+	}
+
+	/**
+	 * @brief Formattext zu einer ID.
+	 *
+	 * @return Format oder nullptr bei unbekannter ID (z. B. Journal einer neueren Firmware).
+	 */
+	static const char *format(uint16_t id);
+
+	/**
+	 * @brief Setzt den Text einer Meldung aus Format und Argumenten zusammen.
+	 *
+	 * Unbekannte IDs erscheinen als `<Format #id>`, unvollständige Argumente als `<?>`.
+	 *
+	 * @return Länge ohne '\0'.
+	 */
+	static size_t render(uint16_t id, const uint8_t *args, size_t argBytes, char *out, size_t size);
+
+	/**
+	 * @brief Setzt eine vollständige Logzeile zusammen wie LogQueue::format(), z. B.
+	 *        `[SOCKET][INFO][2025-01-01 12:00:00] WS Client connected: 3`.
+	 *
+	 * @param cats Kategorien.
+	 * @param time Unix-Zeit.
+	 * @return Länge ohne '\0'.
+	 */
+	static size_t renderLine(uint32_t cats, uint32_t time, uint16_t id, const uint8_t *args, size_t argBytes, char *out, size_t size);
+
+	/**
+	 * @brief Kodiert eine Zeitmarke (Inhalt einer Journalzeile mit Journal-Bits 0).
+	 *
+	 * @return Länge.
+	 */
+	static size_t encodeMark(uint32_t time, uint8_t *buf, size_t size);
+
+	/**
+	 * @brief Liest eine Zeitmarke.
+	 */
+	static bool decodeMark(const uint8_t *buf, size_t len, uint32_t &time);
+
+	/**
+	 * @brief Kodiert einen Eintrag (Inhalt einer Journalzeile mit Journal-Bits ungleich 0).
+	 *
+	 * @return Länge oder 0, wenn der Puffer nicht reicht.
+	 */
+	static size_t encodeEntry(uint32_t cats, uint32_t delta, uint16_t id, const uint8_t *args, size_t argBytes, uint8_t *buf, size_t size);
+
+	/**
+	 * @brief Zerlegt einen Eintrag; die Argumente zeigen in `buf`.
+	 */
+	static bool decodeEntry(const uint8_t *buf, size_t len, LogBinaryEntry &entry);
+
+   private:
+	static size_t putArg(uint8_t *buf, size_t size, const char *value) {
+		return putString(buf, size, value);
+	}
+
+	template <typename T>
+	static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, size_t>::type putArg(uint8_t *buf, size_t size, T value) {
+		return putSigned(buf, size, (int32_t)value);
+	}
+
+	template <typename T>
+	static typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, size_t>::type putArg(uint8_t *buf, size_t size, T value) {
+		return putUnsigned(buf, size, (uint32_t)value);
+	}
+};
+
+#endif  // LOGCODEC_H
@@ -0,0 +1,142 @@
+/**
+ * @file LogFilter.h
+ * @brief Log-Kategorien als Bitmaske mit Filter zur Übersetzungs- und Laufzeit.
+ *
+ * Kategorien einer Meldung werden als konstante Bitmaske angegeben, z. B.
+ * `LOG_CAT_SYSTEM | LOG_CAT_INFO | LOG_CAT_WIFI`. Eine Meldung wird nur ausgegeben, wenn alle
+ * ihre Kategorien freigegeben sind:
+ *
+ * - Zur Übersetzungszeit über `LOG_BUILD_CATEGORIES` (Build-Flag, Standard: alle). LOGF() mit
+ *   einer dort fehlenden Kategorie wird vom Compiler vollständig entfernt, inklusive Text und
+ *   Argumenten.
+ * - Zur Laufzeit über setEnabled(). Gesperrte Meldungen kehren vor jeder Auswertung der
+ *   Argumente, Formatierung oder Allokation zurück.
+ *
+ * Die Bits 0–7 entsprechen den Kategorien des Log-Journals (LLog::Events), die übrigen sind
+ * Themen (wifi, device, ...) und landen im Journal wie bisher unter "general".
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef LOGFILTER_H
+#define LOGFILTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef LOG_BUILD_CATEGORIES
+#define LOG_BUILD_CATEGORIES 0xFFFFFFFFu  ///< Übersetzte Kategorien (Build-Flag)
+#endif
+
+/**
+ * @enum LogCategory
+ * @brief Kategorien einer Logmeldung (Bits, kombinierbar).
+ */
+enum LogCategory : uint32_t {
+	LOG_CAT_DEBUG = 1u << 0,        ///< Journal: debug
+	LOG_CAT_INFO = 1u << 1,         ///< Journal: info
+	LOG_CAT_SYSTEM = 1u << 2,       ///< Journal: system
+	LOG_CAT_WARNING = 1u << 3,      ///< Journal: warning
+	LOG_CAT_ERROR = 1u << 4,        ///< Journal: error
+	LOG_CAT_SOCKET = 1u << 5,       ///< Journal: socket
+	LOG_CAT_HTTP = 1u << 6,         ///< Journal: http
+	LOG_CAT_GENERAL = 1u << 7,      ///< Journal: general
+	LOG_CAT_WIFI = 1u << 8,         ///< Thema: WLAN
+	LOG_CAT_DEVICE = 1u << 9,       ///< Thema: angeschlossenes Gerät
+	LOG_CAT_FILESYSTEM = 1u << 10,  ///< Thema: Dateisystem
+	LOG_CAT_SERIAL = 1u << 11,      ///< Thema: serielle Daten
+	LOG_CAT_LLOG = 1u << 12         ///< Thema: Logsystem selbst
+};
+
+/**
+ * @class LogFilter
+ * @brief Prüfung und Darstellung von Kategorie-Masken (ohne Ausgabe).
+ */
+class LogFilter {
+   public:
+	static constexpr uint32_t JOURNAL_MASK = 0xFFu;  ///< Bits mit eigener Journal-Kategorie
+
+	/**
+	 * @brief Prüft, ob alle Kategorien übersetzt werden (konstanter Ausdruck).
+	 */
+	static constexpr bool built(uint32_t cats) {
+		return (cats & ~(uint32_t)(LOG_BUILD_CATEGORIES)) == 0;
+	}
+
+	/**
+	 * @brief Prüft, ob alle Kategorien zur Laufzeit freigegeben sind (ein atomarer Lesezugriff).
+	 */
+	static bool enabled(uint32_t cats) {
+		return (cats & ~_enabled.load(std::memory_order_relaxed)) == 0;
+	}
+
+	/**
+	 * @brief Setzt die zur Laufzeit freigegebenen Kategorien.
+	 */
+	static void setEnabled(uint32_t mask);
+
+	/**
+	 * @brief Zur Laufzeit freigegebene Kategorien.
+	 */
+	static uint32_t enabledMask();
+
+	/**
+	 * @brief Kategorie zu einem Namen ("info", "[INFO]", Groß-/Kleinschreibung egal).
+	 *
+	 * @return Bit oder 0 bei unbekanntem Namen.
+	 */
+	static uint32_t parse(const char *name);
+
+	/**
+	 * @brief Name einer Kategorie in Kleinbuchstaben.
+	 *
+	 * @param bit Genau ein Bit aus LogCategory.
+	 * @return Name oder nullptr.
+	 */
+	static const char *name(uint32_t bit);
+
+	/**
+	 * @brief Schreibt die Kategorien als Präfix, z. B. "[SYSTEM][INFO][WIFI]".
+	 *
+	 * Die Reihenfolge ist fest (Quelle, Level, Thema) und entspricht den bisherigen Aufrufen;
+	 * passt eine Kategorie nicht mehr in den Puffer, entfällt sie.
+	 *
+	 * @param cats Kategorien.
+	 * @param buf Zielpuffer.
+	 * @param size Größe des Puffers.
+	 * @return Länge ohne '\0'.
+	 */
+	static size_t tags(uint32_t cats, char *buf, size_t size);
+
+	/**
+	 * @brief Bitmaske im Log-Journal: Journal-Kategorien direkt, Themen als "general".
+	 */
+	static uint16_t journalBits(uint32_t cats);
+
+   private:
+	static std::atomic<uint32_t> _enabled;  ///< Zur Laufzeit freigegebene Kategorien
+};
+
+/**
+ * @brief Erzwingt die Auswertung von LogFilter::built() zur Übersetzungszeit.
+ */
+template <uint32_t Cats>
+struct LogBuilt {
+	static constexpr bool value = LogFilter::built(Cats);  ///< Kategorien werden übersetzt
+};
+
+/**
+ * @brief Führt die Anweisung nur aus, wenn alle Kategorien übersetzt und freigegeben sind.
+ *
+ * Grundlage von LOGF() (LLog.h); die Kategorien müssen ein konstanter Ausdruck sein.
+ */
+#define LOG_IF_ENABLED(cats, ...)                                                   \
+	do {                                                                            \
+		if (LogBuilt<(uint32_t)(cats)>::value && LogFilter::enabled(cats)) {        \
+			__VA_ARGS__;                                                            \
+		}                                                                           \
+	} while (0)
+
+#endif  // LOGFILTER_H
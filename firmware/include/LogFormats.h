@@ -0,0 +1,161 @@
+/**
+ * @file LogFormats.h
+ * @brief Tabelle der internierten Formate für binäre Logeinträge (LOGB).
+ *
+ * Häufige Meldungen mit festem Text und wenigen Zahlen werden nicht als Textzeile, sondern als
+ * Format-ID plus rohe Argumente ins Journal geschrieben (siehe LogCodec). Der Text entsteht erst
+ * beim Anzeigen (`/logfile`) oder im Host-Werkzeug `tools/log-decoder`, das diese Tabelle
+ * ebenfalls einbindet.
+ *
+ * Regeln für die Tabelle:
+ * - Die ID ist die Position in LOG_FORMAT_TABLE und steht im Flash. Neue Formate nur hinten
+ *   anhängen; nicht mehr genutzte Einträge stehen lassen, nie umsortieren oder löschen.
+ * - Erlaubte Umwandlungen: `%d`, `%i` (vorzeichenbehaftet), `%u`, `%x`, `%X` (vorzeichenlos),
+ *   `%s` und `%%`, jeweils mit Flags, Breite und Genauigkeit (`%02u`, `%.8s`), ohne `*` und ohne
+ *   Längenangaben; Zahlen haben höchstens 32 Bit.
+ * - Argumenttypen prüft der Compiler beim Aufruf von LOGB() (LogFormatCheck).
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef LOGFORMATS_H
+#define LOGFORMATS_H
+
+#include <cstdint>
+#include <type_traits>
+
+// clang-format off
+/**
+ * @brief Internierte Formate: X(Name, "Format"). Nur hinten anhängen!
+ */
+#define LOG_FORMAT_TABLE(X)                                                         \
+	X(WS_CLIENT_CONNECTED, "WS Client connected: %u")                               \
+	X(WS_CLIENT_DISCONNECTED, "WS Client disconnected: %u")                         \
+	X(WS_CLIENT_ERROR, "WS Error on client %u")                                     \
+	X(WS_CLIENT_PONG, "WS Pong from client %u")                                     \
+	X(WS_CLIENT_TOO_SLOW, "WS Client %u zu langsam, Verbindung wird getrennt")      \
+	X(WS_NO_SEND_BUFFER, "Kein Sendepuffer für WS Client %u frei")                  \
+	X(WIFI_SCAN_FOUND, "Scan gefunden: %d Netze")                                   \
+	X(DEVICE_CONNECTED, "%sDevice connected")                                       \
+	X(DEVICE_DISCONNECTED, "%sDevice disconnected (%u ms ohne Lebenszeichen)")      \
+	X(UART_OVERFLOW, "%sUART-Überlauf, Empfangsdaten verworfen")
+// clang-format on
+
+/**
+ * @enum LogFormatId
+ * @brief IDs der internierten Formate (LOG_FMT_<Name>).
+ */
+enum LogFormatId : uint16_t {
+	LOG_FMT_NONE = 0,  ///< Reserviert (kein Format)
+#define LOG_FORMAT_ID(name, fmt) LOG_FMT_##name,
+	LOG_FORMAT_TABLE(LOG_FORMAT_ID)
+#undef LOG_FORMAT_ID
+	LOG_FMT_COUNT  ///< Anzahl der IDs inkl. LOG_FMT_NONE
+};
+
+/// Formattexte nach ID (Index 0 = LOG_FMT_NONE)
+constexpr const char *const LOG_FORMAT_STRINGS[] = {
+    nullptr,
+#define LOG_FORMAT_STRING(name, fmt) fmt,
+    LOG_FORMAT_TABLE(LOG_FORMAT_STRING)
+#undef LOG_FORMAT_STRING
+};
+
+/**
+ * @brief Prüft, ob ein Zeichen eine erlaubte Umwandlung ist.
+ */
+constexpr bool logIsConversion(char c) {
+	return c == 'd' || c == 'i' || c == 'u' || c == 'x' || c == 'X' || c == 's';
+}
+
+/**
+ * @brief Prüft, ob ein Zeichen zu Flags, Breite oder Genauigkeit gehört.
+ */
+constexpr bool logIsModifier(char c) {
+	return c == '-' || c == '+' || c == ' ' || c == '#' || c == '.' || (c >= '0' && c <= '9');
+}
+
+/**
+ * @brief Zeiger hinter das '%' der nächsten Umwandlung ("%%" zählt nicht) oder auf das Ende.
+ */
+constexpr const char *logNextSpec(const char *f) {
+	return *f == '\0' ? f : *f != '%' ? logNextSpec(f + 1) : f[1] == '%' ? logNextSpec(f + 2) : f + 1;
+}
+
+/**
+ * @brief Überspringt Flags, Breite und Genauigkeit einer Umwandlung.
+ */
+constexpr const char *logSpecEnd(const char *s) {
+	return logIsModifier(*s) ? logSpecEnd(s + 1) : s;
+}
+
+constexpr char logConversion(const char *fmt, unsigned index);
+
+/**
+ * @brief Umwandlung ab einer Angabe (hinter '%'); '?' bei ungültiger Angabe.
+ */
+constexpr char logConversionAt(const char *spec, unsigned index) {
+	return *spec == '\0'                         ? '\0'
+	       : !logIsConversion(*logSpecEnd(spec)) ? '?'
+	       : index == 0                          ? *logSpecEnd(spec)
+	                                             : logConversion(logSpecEnd(spec) + 1, index - 1);
+}
+
+/**
+ * @brief Umwandlungszeichen der index-ten Umwandlung eines Formats.
+ *
+ * @return Zeichen wie 'u', '\0' wenn es weniger Umwandlungen gibt, '?' bei ungültiger Angabe.
+ */
+constexpr char logConversion(const char *fmt, unsigned index) {
+	return logConversionAt(logNextSpec(fmt), index);
+}
+
+/**
+ * @brief Kodierung eines Argumenttyps: 'd' vorzeichenbehaftet, 'u' vorzeichenlos, 's' Text,
+ *        '?' nicht erlaubt (z. B. String, float, 64 Bit, enum).
+ */
+template <typename T>
+struct LogArgKind {
+	static constexpr char value = std::is_convertible<T, const char *>::value               ? 's'
+	                              : !std::is_integral<T>::value || sizeof(T) > sizeof(uint32_t) ? '?'
+	                              : std::is_signed<T>::value                                    ? 'd'
+	                                                                                            : 'u';
+};
+
+/**
+ * @brief Prüft, ob ein Argument zur Umwandlung passt.
+ */
+constexpr bool logKindMatches(char kind, char conv) {
+	return kind == 's' ? conv == 's' : kind == 'd' ? (conv == 'd' || conv == 'i') : kind == 'u' ? (conv == 'u' || conv == 'x' || conv == 'X') : false;
+}
+
+/**
+ * @brief Prüft die Argumente ab Position I gegen die Umwandlungen eines Formats.
+ */
+template <unsigned I, typename... Args>
+struct LogArgsMatch;
+
+template <unsigned I>
+struct LogArgsMatch<I> {
+	static constexpr bool check(const char *fmt) {
+		return logConversion(fmt, I) == '\0';
+	}
+};
+
+template <unsigned I, typename T, typename... Rest>
+struct LogArgsMatch<I, T, Rest...> {
+	static constexpr bool check(const char *fmt) {
+		return logKindMatches(LogArgKind<T>::value, logConversion(fmt, I)) && LogArgsMatch<I + 1, Rest...>::check(fmt);
+	}
+};
+
+/**
+ * @brief Prüft zur Übersetzungszeit, ob Anzahl und Typen der Argumente zum Format passen.
+ */
+template <uint16_t Id, typename... Args>
+struct LogFormatCheck {
+	static constexpr bool value = Id > LOG_FMT_NONE && Id < LOG_FMT_COUNT && LogArgsMatch<0, typename std::decay<Args>::type...>::check(LOG_FORMAT_STRINGS[Id]);  ///< Aufruf passt
+};
+
+#endif  // LOGFORMATS_H
@@ -0,0 +1,120 @@
+/**
+ * @file LogJournal.h
+ * @brief Zeilenformat des gemeinsamen Logjournals aller Kategorien.
+ *
+ * Statt jede Meldung in bis zu vier Kategoriedateien zu schreiben, hängt LLog sie genau einmal
+ * an `/logs/system/journal.log` an. Jede Zeile beginnt mit der Kategorie-Bitmaske als vier
+ * Hex-Ziffern und einem Leerzeichen, danach folgt die bisherige Logzeile:
+ *
+ * @code
+ * 0006 [SYSTEM][INFO][2025-01-01 12:00:00] System startet...
+ * @endcode
+ *
+ * Bit i steht für LLog::Events[i]. Die Ansicht einer Kategorie (`/logfile?level=`) liest das
+ * Journal und zeigt nur Zeilen mit gesetztem Bit, ohne das Präfix.
+ *
+ * Binäre Einträge (LOGB, siehe LogCodec) stehen als eigene Zeilen dazwischen: BINARY_MARK,
+ * danach ein Byte mit der Bitmaske und der kodierte Inhalt. Die Bytes 0x00, '\n', '\r' und
+ * ESCAPE werden als ESCAPE, Byte ^ 0x40 geschrieben, damit jede Zeile zeilenweise lesbar bleibt.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef LOGJOURNAL_H
+#define LOGJOURNAL_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LogJournal
+ * @brief Kodieren, Lesen und Bearbeiten von Journalzeilen (ohne Dateizugriff).
+ */
+class LogJournal {
+   public:
+	static constexpr size_t PREFIX_LEN = 5;     ///< "XXXX " vor der Logzeile
+	static constexpr char BINARY_MARK = '\x1E';  ///< Erstes Zeichen einer binären Zeile
+	static constexpr char ESCAPE = '\x10';       ///< Maskiert Sonderbytes in binären Zeilen
+
+	/**
+	 * @brief Größte binäre Zeile (ohne Zeilenende, inkl. '\0') für einen Inhalt von `payload` Bytes.
+	 */
+	static constexpr size_t binaryLineBytes(size_t payload) {
+		return 2 + 2 * (payload + 1);
+	}
+
+	/**
+	 * @brief Schreibt das Präfix einer Zeile.
+	 *
+	 * @param files Kategorie-Bitmaske.
+	 * @param buf Zielpuffer mit mindestens PREFIX_LEN + 1 Bytes.
+	 * @return PREFIX_LEN.
+	 */
+	static size_t prefix(uint16_t files, char *buf);
+
+	/**
+	 * @brief Zerlegt eine Journalzeile (ohne Zeilenende).
+	 *
+	 * @param line Zeile.
+	 * @param len Länge der Zeile.
+	 * @param files Erhält die Bitmaske.
+	 * @param text Erhält den Beginn der Logzeile.
+	 * @return false, wenn kein gültiges Präfix vorhanden ist (z. B. Zeile aus einer alten Datei).
+	 */
+	static bool parse(const char *line, size_t len, uint16_t &files, const char *&text);
+
+	/**
+	 * @brief Entfernt Kategorien aus einer Zeile (Präfix wird in der Zeile überschrieben).
+	 *
+	 * @param line Zeile mit gültigem Präfix.
+	 * @param len Länge der Zeile.
+	 * @param bits Zu entfernende Kategorien.
+	 * @return false, wenn danach keine Kategorie übrig ist (Zeile entfällt) oder die Zeile
+	 *         ungültig ist.
+	 */
+	static bool clearBits(char *line, size_t len, uint16_t bits);
+
+	/**
+	 * @brief Prüft, ob eine Zeile binär ist.
+	 */
+	static bool isBinary(const char *line, size_t len);
+
+	/**
+	 * @brief Schreibt eine binäre Zeile (ohne Zeilenende).
+	 *
+	 * @param files Kategorie-Bitmaske (0 = Zeitmarke, siehe LogCodec).
+	 * @param payload Inhalt.
+	 * @param len Länge des Inhalts.
+	 * @param line Zielpuffer.
+	 * @param size Größe des Puffers (binaryLineBytes(len) reicht immer).
+	 * @return Länge der Zeile oder 0, wenn der Puffer nicht reicht.
+	 */
+	static size_t encodeBinary(uint8_t files, const uint8_t *payload, size_t len, char *line, size_t size);
+
+	/**
+	 * @brief Zerlegt eine binäre Zeile (ohne Zeilenende).
+	 *
+	 * @param line Zeile.
+	 * @param len Länge der Zeile.
+	 * @param files Erhält die Bitmaske.
+	 * @param payload Puffer für den Inhalt.
+	 * @param size Größe des Puffers.
+	 * @param payloadLen Erhält die Länge des Inhalts.
+	 * @return false, wenn die Zeile nicht binär oder beschädigt ist.
+	 */
+	static bool parseBinary(const char *line, size_t len, uint8_t &files, uint8_t *payload, size_t size, size_t &payloadLen);
+
+	/**
+	 * @brief Entfernt Kategorien aus einer binären Zeile; Zeitmarken bleiben unverändert.
+	 *
+	 * @param line Binäre Zeile.
+	 * @param len Länge der Zeile.
+	 * @param size Größe des Puffers (die Zeile kann um ein Byte wachsen).
+	 * @param bits Zu entfernende Kategorien.
+	 * @return Neue Länge oder 0, wenn die Zeile entfällt.
+	 */
+	static size_t clearBinaryBits(char *line, size_t len, size_t size, uint16_t bits);
+};
+
+#endif  // LOGJOURNAL_H
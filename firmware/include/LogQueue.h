@@ -0,0 +1,191 @@
+/**
+ * @file LogQueue.h
+ * @brief Sperrfreie Warteschlange (mehrere Erzeuger, ein Verbraucher) für Logeinträge.
+ *
+ * Aufrufer von LLog reservieren einen vorab angelegten Eintrag, kopieren Kategorien und Text
+ * hinein und geben ihn frei; Zeitstempel, serielle Ausgabe und Dateizugriffe erledigt danach
+ * die Schreib-Task von LLog gebündelt. Die Warteschlange folgt dem begrenzten Ringpuffer mit
+ * Sequenznummer je Zelle (D. Vyukov): Erzeuger reservieren per Compare-and-Swap, der
+ * Verbraucher liest ohne Sperre. Ist der Ring voll, wird der Eintrag verworfen und gezählt,
+ * der Aufrufer blockiert nie.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef LOGQUEUE_H
+#define LOGQUEUE_H
+
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum LogRecordFlags
+ * @brief Ausgabeoptionen eines Logeintrags.
+ */
+enum LogRecordFlags : uint8_t {
+	LOG_RECORD_NEWLINE = 0x01,    ///< Zeilenumbruch auf der seriellen Konsole
+	LOG_RECORD_TIMESTAMP = 0x02,  ///< Zeitstempel voranstellen
+	LOG_RECORD_SPACED = 0x04,     ///< Leerzeichen zwischen Kategorie und Zeitstempel (Einzel-Level)
+	LOG_RECORD_TRUNCATED = 0x08,  ///< Text wurde gekürzt
+	LOG_RECORD_BINARY = 0x10      ///< text enthält kodierte Argumente zu format (LOGB, siehe LogCodec)
+};
+
+/**
+ * @struct LogRecord
+ * @brief Ein Logeintrag fester Größe.
+ */
+struct LogRecord {
+	static constexpr size_t TAGS = 40;   ///< Platz für die Kategorien inkl. '\0'
+	static constexpr size_t TEXT = 208;  ///< Platz für den Text inkl. '\0'
+	uint32_t time;                       ///< Unix-Zeit beim Einreihen (s)
+	uint16_t files;                      ///< Kategorien im Journal (Bit i = LLog::Events[i])
+	uint8_t flags;                       ///< LogRecordFlags
+	uint8_t argBytes;                    ///< Länge der Argumente (LOG_RECORD_BINARY)
+	uint16_t format;                     ///< Format-ID (LOG_RECORD_BINARY)
+	uint16_t cats;                       ///< Kategorien als LogCategory (LOG_RECORD_BINARY)
+	char tags[TAGS];                     ///< Kategorien wie "[SYSTEM][INFO]" (nicht bei LOG_RECORD_BINARY)
+	char text[TEXT];                     ///< Nachricht bzw. kodierte Argumente
+};
+
+/**
+ * @struct LogQueueStats
+ * @brief Zähler der Warteschlange.
+ */
+struct LogQueueStats {
+	uint32_t enqueued;   ///< Eingereihte Einträge
+	uint32_t dropped;    ///< Wegen vollem Ring verworfene Einträge
+	uint32_t highWater;  ///< Höchster Füllstand
+};
+
+/**
+ * @class LogQueue
+ * @brief Begrenzter MPSC-Ring für Logeinträge.
+ */
+class LogQueue {
+   public:
+	static constexpr size_t SLOTS = 32;                                            ///< Anzahl der Einträge (Zweierpotenz)
+	static constexpr size_t LINE_BYTES = LogRecord::TAGS + LogRecord::TEXT + 24;  ///< Größte formatierte Zeile inkl. '\0'
+
+	LogQueue();
+
+	/**
+	 * @brief Reserviert einen Eintrag (Erzeuger, sperrfrei).
+	 *
+	 * @param ticket Erhält die Position für commit().
+	 * @return Eintrag zum Befüllen oder nullptr, wenn der Ring voll ist (wird gezählt).
+	 */
+	LogRecord *reserve(uint32_t &ticket);
+
+	/**
+	 * @brief Gibt einen befüllten Eintrag für den Verbraucher frei.
+	 *
+	 * @param ticket Position aus reserve().
+	 */
+	void commit(uint32_t ticket);
+
+	/**
+	 * @brief Reiht einen Eintrag ein: reserve(), kopieren, commit().
+	 *
+	 * Zu lange Texte werden an einer Zeichengrenze (UTF-8) gekürzt und mit "..." markiert.
+	 *
+	 * @param tags Kategorien (werden ggf. gekürzt).
+	 * @param files Kategorien im Journal.
+	 * @param flags LogRecordFlags.
+	 * @param time Unix-Zeit.
+	 * @param text Nachricht.
+	 * @param len Länge der Nachricht.
+	 * @return false, wenn der Ring voll ist.
+	 */
+	bool push(const char *tags, uint16_t files, uint8_t flags, uint32_t time, const char *text, size_t len);
+
+	/**
+	 * @brief Reiht einen Eintrag ein und formatiert den Text direkt in die Zelle (ohne Heap).
+	 *
+	 * Zu lange Texte werden wie bei push() gekürzt.
+	 *
+	 * @param tags Kategorien.
+	 * @param files Kategorien im Journal.
+	 * @param flags LogRecordFlags.
+	 * @param time Unix-Zeit.
+	 * @param fmt printf-Format.
+	 * @param args Argumente.
+	 * @return false, wenn der Ring voll ist (es wird dann nicht formatiert).
+	 */
+	bool pushv(const char *tags, uint16_t files, uint8_t flags, uint32_t time, const char *fmt, va_list args);
+
+	/**
+	 * @brief Formatiert einen Eintrag als Logzeile (ohne Zeilenende).
+	 *
+	 * Einzel-Level: `[INFO] [YYYY-MM-DD hh:mm:ss] Text`, mehrere Kategorien:
+	 * `[SYSTEM][INFO][YYYY-MM-DD hh:mm:ss] Text`, ohne Zeitstempel `[INFO] Text`. Binäre
+	 * Einträge werden erst hier aus Format und Argumenten zusammengesetzt (LogCodec).
+	 *
+	 * @param record Eintrag.
+	 * @param buf Zielpuffer.
+	 * @param size Größe des Puffers (LINE_BYTES reicht immer).
+	 * @return Länge der Zeile.
+	 */
+	static size_t format(const LogRecord &record, char *buf, size_t size);
+
+	/**
+	 * @brief Formatiert Kategorien, Zeitstempel und Text wie format().
+	 *
+	 * @param tags Kategorien wie "[SYSTEM][INFO]".
+	 * @param flags LogRecordFlags (TIMESTAMP, SPACED).
+	 * @param time Unix-Zeit.
+	 * @param text Nachricht.
+	 * @param buf Zielpuffer.
+	 * @param size Größe des Puffers.
+	 * @return Länge der Zeile.
+	 */
+	static size_t formatLine(const char *tags, uint8_t flags, uint32_t time, const char *text, char *buf, size_t size);
+
+	/**
+	 * @brief Liefert die nächsten fertigen Einträge, ohne sie zu entfernen (nur Verbraucher).
+	 *
+	 * Ein noch nicht freigegebener Eintrag beendet die Folge; dahinterliegende fertige Einträge
+	 * kommen beim nächsten Aufruf.
+	 *
+	 * @param out Feld für die Zeiger.
+	 * @param max Größe des Felds.
+	 * @return Anzahl der Einträge.
+	 */
+	size_t peek(const LogRecord **out, size_t max) const;
+
+	/**
+	 * @brief Entfernt die ersten `count` Einträge aus peek() (nur Verbraucher).
+	 */
+	void release(size_t count);
+
+	/**
+	 * @brief Reservierte, noch nicht entfernte Einträge.
+	 */
+	size_t pending() const;
+
+	/**
+	 * @brief Kopie der Zähler.
+	 */
+	LogQueueStats stats() const;
+
+   private:
+	/**
+	 * @struct Cell
+	 * @brief Zelle mit Sequenznummer: gleich Position = frei, Position + 1 = befüllt.
+	 */
+	struct Cell {
+		std::atomic<uint32_t> seq;  ///< Zustand der Zelle
+		LogRecord record;           ///< Inhalt
+	};
+
+	Cell _cells[SLOTS];                ///< Ring
+	std::atomic<uint32_t> _head;       ///< Nächste Schreibposition (Erzeuger)
+	std::atomic<uint32_t> _tail;       ///< Nächste Leseposition (Verbraucher)
+	std::atomic<uint32_t> _enqueued;   ///< Zähler eingereiht
+	std::atomic<uint32_t> _dropped;    ///< Zähler verworfen
+	std::atomic<uint32_t> _highWater;  ///< Höchster Füllstand
+};
+
+#endif  // LOGQUEUE_H
@@ -0,0 +1,148 @@
+/**
+ * @file LogSegments.h
+ * @brief Buchführung und Rotationsregeln für die Segmente des Log-Journals.
+ *
+ * Das Journal besteht aus Segmenten `/logs/system/journal.<n>.log` mit fortlaufender Nummer n;
+ * geschrieben wird immer in das jüngste. Überschreitet es die Segmentgröße, beginnt ein neues.
+ * Sind mehr Segmente als erlaubt vorhanden oder belegt `/logs` insgesamt mehr als das Budget,
+ * werden die ältesten Segmente gelöscht (das aktuelle nie). Die Größen werden hier
+ * mitgeführt, damit der Schreibpfad ohne `open`/`size` entscheiden kann; Dateizugriffe
+ * erledigt LLog.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef LOGSEGMENTS_H
+#define LOGSEGMENTS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct LogRotationConfig
+ * @brief Grenzen der Rotation.
+ */
+struct LogRotationConfig {
+	uint32_t segmentBytes;  ///< Größe, ab der ein neues Segment beginnt
+	uint16_t segments;      ///< Höchstzahl der Segmente (1 bis LogSegments::MAX_SEGMENTS)
+	uint32_t budget;        ///< Gesamtbudget für `/logs` in Bytes (inkl. Gerätelogs)
+};
+
+/**
+ * @class LogSegments
+ * @brief Nummern und Größen der Journal-Segmente (ohne Dateizugriff).
+ */
+class LogSegments {
+   public:
+	static constexpr size_t MAX_SEGMENTS = 32;          ///< Obergrenze für LogRotationConfig::segments
+	static constexpr uint32_t MIN_SEGMENT_BYTES = 4096;  ///< Kleinste sinnvolle Segmentgröße
+
+	explicit LogSegments(const LogRotationConfig &config);
+
+	/**
+	 * @brief Setzt neue Grenzen (ungültige Werte werden begrenzt).
+	 */
+	void configure(const LogRotationConfig &config);
+
+	/**
+	 * @brief Gibt die aktuellen Grenzen zurück.
+	 */
+	LogRotationConfig config() const;
+
+	/**
+	 * @brief Vergisst alle Segmente (vor einem neuen Verzeichnisscan).
+	 */
+	void clear();
+
+	/**
+	 * @brief Meldet ein vorhandenes Segment (Verzeichnisscan, beliebige Reihenfolge).
+	 *
+	 * @param seq Nummer des Segments.
+	 * @param bytes Größe der Datei.
+	 * @return false, wenn die Buchführung mit jüngeren Segmenten voll ist; der Aufrufer
+	 *         löscht dieses dann.
+	 */
+	bool add(uint32_t seq, uint32_t bytes);
+
+	/**
+	 * @brief Nummer des Segments, in das geschrieben wird (legt bei Bedarf Segment 0 an).
+	 */
+	uint32_t active();
+
+	/**
+	 * @brief Anzahl bekannter Segmente.
+	 */
+	size_t count() const;
+
+	/**
+	 * @brief Nummer des i-ten Segments, vom ältesten an.
+	 */
+	uint32_t seqAt(size_t index) const;
+
+	/**
+	 * @brief Größe des i-ten Segments, vom ältesten an.
+	 */
+	uint32_t bytesAt(size_t index) const;
+
+	/**
+	 * @brief Summe aller Segmente.
+	 */
+	uint32_t journalBytes() const;
+
+	/**
+	 * @brief Setzt den übrigen Platzbedarf unter `/logs` (Gerätelogs, Mitschnitte).
+	 */
+	void setExternalBytes(uint32_t bytes);
+
+	/**
+	 * @brief Prüft, ob vor dem Schreiben von `incoming` Bytes ein neues Segment beginnen muss.
+	 *
+	 * Ein leeres Segment wird nie gewechselt, auch wenn ein Block allein größer ist.
+	 */
+	bool needsRotation(uint32_t incoming) const;
+
+	/**
+	 * @brief Beginnt ein neues, leeres Segment.
+	 *
+	 * @return Nummer des neuen Segments.
+	 */
+	uint32_t rotate();
+
+	/**
+	 * @brief Verbucht geschriebene Bytes im aktuellen Segment.
+	 */
+	void appended(uint32_t bytes);
+
+	/**
+	 * @brief Setzt die Größe eines Segments (nach dem Neuschreiben).
+	 */
+	void resize(uint32_t seq, uint32_t bytes);
+
+	/**
+	 * @brief Liefert das nächste zu löschende Segment, solange eine Grenze überschritten ist.
+	 *
+	 * Das aktuelle Segment wird nie geliefert. Der Aufrufer löscht die Datei und ruft danach
+	 * dropOldest() auf.
+	 *
+	 * @param seq Erhält die Nummer des ältesten Segments.
+	 * @return false, wenn alle Grenzen eingehalten sind.
+	 */
+	bool overLimit(uint32_t &seq) const;
+
+	/**
+	 * @brief Entfernt das älteste Segment aus der Buchführung.
+	 */
+	void dropOldest();
+
+   private:
+	static constexpr size_t CAPACITY = MAX_SEGMENTS + 1;  ///< Platz für ein frisch rotiertes Segment
+
+	LogRotationConfig _config;  ///< Grenzen
+	uint32_t _seq[CAPACITY];    ///< Nummern, aufsteigend (ältestes zuerst)
+	uint32_t _bytes[CAPACITY];  ///< Größen passend zu _seq
+	size_t _count;              ///< Belegte Einträge
+	uint32_t _externalBytes;    ///< Übriger Platzbedarf unter /logs
+};
+
+#endif  // LOGSEGMENTS_H
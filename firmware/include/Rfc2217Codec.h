@@ -0,0 +1,151 @@
+/**
+ * @file Rfc2217Codec.h
+ * @brief Telnet-Protokoll mit COM-Port-Steuerung nach RFC 2217 für eine TCP-Verbindung.
+ *
+ * Der Codec trennt einen empfangenen Telnet-Strom in Nutzdaten und Steuerbefehle:
+ *  - `IAC IAC` wird zu einem Datenbyte 0xFF, alle anderen Telnet-Befehle werden entfernt,
+ *  - Optionen werden ausgehandelt (BINARY, SUPPRESS-GO-AHEAD und COM-PORT-OPTION werden
+ *    angenommen, alle anderen abgelehnt),
+ *  - COM-PORT-Befehle (Baudrate, Datenformat, Steuerleitungen, Puffer leeren) werden über
+ *    SerialTcpPort ausgeführt und mit dem tatsächlich aktiven Wert beantwortet.
+ *
+ * Befehle dürfen an beliebiger Stelle über Blockgrenzen geteilt sein; der Zustand bleibt
+ * zwischen den Aufrufen von decode() erhalten. Antworten sammelt der Codec in einem eigenen
+ * Puffer, den der Server vor den nächsten Nutzdaten abholt.
+ *
+ * Die UART arbeitet immer mit 8N1; Anfragen für Datenbits, Parität und Stoppbits werden mit
+ * diesen Werten beantwortet. Zugriffe ohne Schreibrecht (Mithörer) erhalten auf jede Anfrage
+ * nur die aktuellen Werte, ohne dass sich an der UART etwas ändert.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef RFC2217CODEC_H
+#define RFC2217CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SerialTcpPort.h"
+
+/**
+ * @class Rfc2217Codec
+ * @brief Zustand einer Telnet/RFC-2217-Sitzung auf Serverseite.
+ */
+class Rfc2217Codec {
+   public:
+	static constexpr uint8_t IAC = 255;              ///< Telnet: Befehlseinleitung
+	static constexpr uint8_t DONT = 254;             ///< Telnet: Option beim Partner ablehnen
+	static constexpr uint8_t DO = 253;               ///< Telnet: Option beim Partner anfordern
+	static constexpr uint8_t WONT = 252;             ///< Telnet: Option selbst ablehnen
+	static constexpr uint8_t WILL = 251;             ///< Telnet: Option selbst anbieten
+	static constexpr uint8_t SB = 250;               ///< Telnet: Beginn einer Subnegotiation
+	static constexpr uint8_t SE = 240;               ///< Telnet: Ende einer Subnegotiation
+	static constexpr uint8_t OPT_BINARY = 0;         ///< Option TRANSMIT-BINARY (RFC 856)
+	static constexpr uint8_t OPT_SGA = 3;            ///< Option SUPPRESS-GO-AHEAD (RFC 858)
+	static constexpr uint8_t OPT_COM_PORT = 44;      ///< Option COM-PORT-OPTION (RFC 2217)
+	static constexpr uint8_t SERVER_OFFSET = 100;    ///< Antwortcode = Befehlscode + 100
+	static constexpr size_t REPLY_MAX = 128;         ///< Kapazität des Antwortpuffers
+	static constexpr size_t SUBNEG_MAX = 32;         ///< Maximale Länge einer Subnegotiation
+	static constexpr const char *SIGNATURE = "HS-Access";  ///< Antwort auf SIGNATURE
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param port Serielle Seite, auf die COM-Port-Befehle wirken.
+	 */
+	explicit Rfc2217Codec(SerialTcpPort &port);
+
+	/**
+	 * @brief Setzt den Zustand für eine neue Verbindung zurück und legt die eigenen
+	 *        Optionsanfragen (WILL/DO BINARY, WILL/DO SGA, DO COM-PORT-OPTION) in den Antwortpuffer.
+	 */
+	void begin();
+
+	/**
+	 * @brief Verarbeitet empfangene Bytes.
+	 *
+	 * @param in Vom Client empfangene Bytes.
+	 * @param len Anzahl der Bytes.
+	 * @param data Ausgabe der Nutzdaten (mindestens `len` Bytes).
+	 * @param control true, wenn der Client die UART steuern darf.
+	 * @return Anzahl der Nutzdaten in `data`.
+	 */
+	size_t decode(const uint8_t *in, size_t len, uint8_t *data, bool control);
+
+	/**
+	 * @brief Anzahl der Bytes im Antwortpuffer.
+	 */
+	size_t pendingReply() const;
+
+	/**
+	 * @brief Entnimmt Antworten aus dem Antwortpuffer.
+	 *
+	 * @param out Zielpuffer.
+	 * @param cap Größe des Zielpuffers.
+	 * @return Anzahl der kopierten Bytes.
+	 */
+	size_t takeReply(uint8_t *out, size_t cap);
+
+	/**
+	 * @brief true, sobald der Client COM-PORT-OPTION angeboten hat.
+	 */
+	bool comPortActive() const;
+
+	/**
+	 * @brief Anzahl der verworfenen Antworten (Antwortpuffer voll).
+	 */
+	uint32_t droppedReplies() const;
+
+	/**
+	 * @brief Maskiert Nutzdaten für den Versand (0xFF wird verdoppelt).
+	 *
+	 * @param in Nutzdaten.
+	 * @param len Anzahl der Nutzdaten.
+	 * @param out Zielpuffer.
+	 * @param cap Größe des Zielpuffers.
+	 * @param consumed Ausgabe: Anzahl der übernommenen Nutzdaten.
+	 * @return Anzahl der Bytes in `out`.
+	 */
+	static size_t escape(const uint8_t *in, size_t len, uint8_t *out, size_t cap, size_t &consumed);
+
+   private:
+	static constexpr uint8_t ST_DATA = 0;    ///< Nutzdaten
+	static constexpr uint8_t ST_IAC = 1;     ///< Nach IAC
+	static constexpr uint8_t ST_OPTION = 2;  ///< Nach WILL/WONT/DO/DONT, Optionsbyte folgt
+	static constexpr uint8_t ST_SB = 3;      ///< Innerhalb einer Subnegotiation
+	static constexpr uint8_t ST_SB_IAC = 4;  ///< IAC innerhalb einer Subnegotiation
+
+	SerialTcpPort &_port;           ///< Serielle Seite
+	uint8_t _state;                 ///< ST_DATA, ...
+	uint8_t _verb;                  ///< ST_OPTION: empfangenes WILL/WONT/DO/DONT
+	uint8_t _local;                 ///< Bitmaske: bei uns aktive Optionen
+	uint8_t _remote;                ///< Bitmaske: beim Client aktive Optionen
+	uint8_t _localPending;          ///< Bitmaske: eigene WILL/WONT ohne Antwort
+	uint8_t _remotePending;         ///< Bitmaske: eigene DO/DONT ohne Antwort
+	bool _lastCr;                   ///< Letztes Datenbyte war CR (NUL danach verwerfen, ohne BINARY)
+	uint8_t _sb[SUBNEG_MAX];        ///< Inhalt der laufenden Subnegotiation
+	size_t _sbLen;                  ///< Füllstand von _sb
+	bool _sbOverflow;               ///< Subnegotiation war länger als SUBNEG_MAX
+	uint8_t _reply[REPLY_MAX];      ///< Ausstehende Antworten
+	size_t _replyLen;               ///< Füllstand von _reply
+	uint32_t _droppedReplies;       ///< Verworfene Antworten
+	uint8_t _flow;                  ///< Gemeldete Flusskontrolle (SET-CONTROL 1..3)
+	uint8_t _breakState;            ///< Gemeldeter BREAK-Zustand (SET-CONTROL 5/6)
+	uint8_t _dtr;                   ///< Gemeldeter DTR-Zustand (SET-CONTROL 8/9)
+	uint8_t _rts;                   ///< Gemeldeter RTS-Zustand (SET-CONTROL 11/12)
+	uint8_t _lineMask;              ///< SET-LINESTATE-MASK des Clients
+	uint8_t _modemMask;             ///< SET-MODEMSTATE-MASK des Clients
+
+	static uint8_t optionBit(uint8_t option);
+	void negotiate(uint8_t verb, uint8_t option);
+	void subnegotiation(bool control);
+	void comPortCommand(uint8_t code, const uint8_t *arg, size_t len, bool control);
+	uint8_t setControl(uint8_t value, bool control);
+	void sendOption(uint8_t verb, uint8_t option);
+	void sendComPort(uint8_t code, const uint8_t *arg, size_t len);
+	bool queue(const uint8_t *data, size_t len);
+};
+
+#endif  // RFC2217CODEC_H
@@ -16,11 +16,51 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <ESPAsyncWebServer.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
+#include "BaudDetector.h"
+#include "CaptureStore.h"
+#include "DevicePresence.h"
 #include "LLog.h"
+#include "SerialCoalescer.h"
+#include "SerialFrame.h"
+#include "SerialFileStream.h"
+#include "SerialFramer.h"
+#include "SerialLineFilter.h"
+#include "SerialPassthrough.h"
+#include "SerialPoller.h"
+#include "SerialRecorder.h"
+#include "SerialRxPump.h"
+#include "SerialScriptEngine.h"
+#include "SerialScrollback.h"
+#include "SerialTcpServer.h"
+#include "SerialTrigger.h"
+#include "SerialTx.h"
+#include "UartPort.h"
+#include "WsOutbox.h"
+
+/**
+ * @enum SerialReplayMode
+ * @brief Startpunkt beim Nachladen aus dem Verlaufspuffer.
+ */
+enum SerialReplayMode {
+	SERIAL_REPLAY_FROM_SEQ,  ///< Ab einer laufenden Nummer
+	SERIAL_REPLAY_TAIL       ///< Die letzten N Bytes
+};
+
+/**
+ * @struct SerialTriggerSnapshot
+ * @brief Kopf des letzten Schnappschusses, den eine Regel ausgelöst hat.
+ */
+struct SerialTriggerSnapshot {
+	char rule[SerialTriggerRule::MAX_NAME];  ///< Auslösende Regel
+	uint64_t timestamp;                      ///< Empfangszeit der auslösenden Zeile in µs
+	uint32_t takenMs;                        ///< Zeitpunkt des Schnappschusses
+	uint32_t firstSeq;                       ///< Nummer des ersten enthaltenen Blocks
+	uint32_t lastSeq;                        ///< Nummer des letzten enthaltenen Blocks
+	size_t len;                              ///< Länge der Daten
+};
 
 /**
  * @class SerialBridge
@@ -29,18 +69,59 @@
  * Ermöglicht das Lesen und Schreiben serieller Daten sowie die Weiterleitung
  * an WebSocket-Clients. Unterstützt dynamische Baudratenänderung, Gerätezustandserkennung
  * und gepufferte Datenübertragung.
+ *
+ * Clients erhalten serielle Daten standardmäßig als JSON ("incoming"). Clients, die den
+ * Binärkanal aktiviert haben, bekommen stattdessen Frames nach `SerialFrame.h`.
+ *
+ * Bei hoher Zeilenrate werden mehrere Zeilen innerhalb eines Latenzbudgets zu einer
+ * Nachricht gebündelt (siehe SerialCoalescer).
+ *
+ * Alle verteilten Blöcke landen zusätzlich im Verlaufspuffer (SerialScrollback). Clients
+ * können daraus ab einer laufenden Nummer oder die letzten N Bytes nachladen; das Replay
+ * läuft blockweise in der Bridge-Task und nur, solange der Datenpuffer des Clients Platz hat.
+ *
+ * Zu sendende Daten gehen über eine eigene TX-Task (SerialTx): `sendData()` reiht nur ein und
+ * kehrt sofort zurück, der anfragende Client erhält nach der Übertragung `serial`/`send`/`done`.
+ *
+ * Pro UART gibt es eine eigene Instanz mit eigener Kanal-ID, eigenen Tasks und Puffern; alle
+ * WebSocket-Nachrichten tragen das Feld `channel`.
+ *
+ * Auf Wunsch wird der rohe RX/TX-Strom mitgeschnitten (SerialRecorder); geschrieben wird in
+ * einer eigenen, niedrig priorisierten Task, sodass Empfang und Versand nie auf den Flash warten.
+ *
+ * Optional ist die UART zusätzlich direkt per TCP erreichbar (SerialTcpServer, roh und
+ * RFC 2217). Empfangene Blöcke gehen ohne JSON an die TCP-Clients, Daten des schreibenden
+ * TCP-Clients laufen wie `sendData()` über die TX-Task.
+ *
+ * Befehlsskripte (SerialScriptEngine) laufen in einer eigenen Skript-Task: Sie senden über die
+ * TX-Task, bekommen während des Laufs alle RX-Blöcke und melden dem Auftraggeber am Ende ein
+ * Ergebnis mit erfassten Feldern (`serial`/`run`/`done`).
+ *
+ * Konfigurierte Abfragen (SerialPoller) schickt die Bridge-Task selbst in festen Abständen und
+ * wertet die Antworten in einen Feldspeicher aus. Clients abonnieren einzelne Felder und
+ * erhalten nur deren Änderungen (`serial`/`field`/`changed`) statt jeder Rohzeile.
+ *
+ * Clients mit Zeilenfilter (SerialLineFilter) bekommen keine gebündelten Blöcke, sondern nur die
+ * passenden Zeilen einzeln. Ausgewertet wird jede Zeile einmal in der Bridge-Task für alle
+ * Clients; den übersetzten Filter gibt es nur, solange mindestens ein Client einen gesetzt hat.
  */
 class SerialBridge {
    public:
+	static constexpr size_t MAX_CLIENTS = 8;                  ///< Maximale Anzahl verwalteter WebSocket-Clients
+	static constexpr size_t SCROLLBACK_PSRAM_BYTES = 262144;  ///< Verlaufspuffer, wenn PSRAM vorhanden ist
+	static constexpr size_t SCROLLBACK_RAM_BYTES = 16384;     ///< Verlaufspuffer im internen RAM
+
 	/**
 	 * @brief Konstruktor.
 	 *
-	 * @param serial Referenz auf die HardwareSerial-Instanz.
-	 * @param ws Referenz auf die WebSocket-Instanz.
+	 * @param port Referenz auf die UART-Schnittstelle.
+	 * @param out Sendewarteschlangen der WebSocket-Clients.
+	 * @param captures Ablage für Mitschnitte (eigene Instanz pro Kanal).
+	 * @param channel Kanal-ID in allen WebSocket-Nachrichten und Binär-Headern.
 	 * @param rxPin Pin für RX (Empfang).
 	 * @param txPin Pin für TX (Senden).
 	 */
-	SerialBridge(HardwareSerial &serial, AsyncWebSocket &ws, uint8_t rxPin, uint8_t txPin);
+	SerialBridge(UartPort &port, WsOutbox &out, CaptureStore &captures, uint8_t channel, uint8_t rxPin, uint8_t txPin);
 
 	/**
 	 * @brief Initialisiert die serielle Schnittstelle mit der angegebenen Baudrate.
@@ -50,7 +131,7 @@ class SerialBridge {
 	void begin(uint32_t baud);
 
 	/**
-	 * @brief Startet die Task zur kontinuierlichen Überwachung der seriellen Schnittstelle.
+	 * @brief Startet die Tasks für Empfang (Bridge-Task), Versand (TX-Task) und Mitschnitt.
 	 *
 	 * @param taskHandle Optionaler Zeiger zum Erhalt des TaskHandles.
 	 * @param priority Priorität der Task (Default: 3).
@@ -66,6 +147,15 @@ class SerialBridge {
 	 */
 	bool setBaud(uint32_t newBaud);
 
+	/**
+	 * @brief Startet die automatische Baudratenerkennung in der Bridge-Task.
+	 *
+	 * Das Ergebnis wird über `serial`/`status` (Feld `autoBaud`) an alle Clients gemeldet.
+	 *
+	 * @return false, wenn bereits eine Erkennung läuft.
+	 */
+	bool startAutoBaud();
+
 	/**
 	 * @brief Prüft, ob eine gegebene Baudrate zulässig ist.
 	 *
@@ -81,6 +171,133 @@ class SerialBridge {
 	 */
 	bool isDeviceConnected() const;
 
+	/**
+	 * @brief Gibt die Kanal-ID dieser Bridge zurück.
+	 */
+	uint8_t getChannel() const;
+
+	/**
+	 * @brief Setzt die Schwellen der Geräteerkennung.
+	 *
+	 * Die Bridge-Task übernimmt sie beim nächsten Durchlauf; der aktuelle Zustand bleibt erhalten.
+	 *
+	 * @param config Entprellung, Stille bis "getrennt" und Pegelauswertung.
+	 * @return false bei ungültigen Schwellen (siehe DevicePresence::validate).
+	 */
+	bool setPresence(const DevicePresenceConfig &config);
+
+	/**
+	 * @brief Gibt die zuletzt gesetzten Schwellen der Geräteerkennung zurück.
+	 */
+	DevicePresenceConfig getPresence() const;
+
+	/**
+	 * @brief Gibt die Zähler der Geräteerkennung zurück.
+	 */
+	DevicePresenceStats getPresenceStats() const;
+
+	/**
+	 * @brief Setzt die zyklischen Abfragen; die Bridge-Task übernimmt sie beim nächsten Durchlauf.
+	 *
+	 * Abonnements einzelner Felder verfallen dabei (Indizes werden neu vergeben), Abonnements
+	 * aller Felder bleiben bestehen.
+	 *
+	 * @param config Abfragen (count = 0 schaltet ab).
+	 * @param error Puffer für die Fehlerbeschreibung.
+	 * @param size Größe des Puffers.
+	 * @return false bei ungültiger Konfiguration (siehe SerialPoller::validate).
+	 */
+	bool setPoll(const SerialPollerConfig &config, char *error, size_t size);
+
+	/**
+	 * @brief Gibt die zuletzt gesetzten Abfragen zurück (nur aus dem WebSocket-Kontext).
+	 */
+	const SerialPollerConfig &getPoll() const;
+
+	/**
+	 * @brief Zugriff auf Feldspeicher und Zähler der Abfragen.
+	 */
+	const SerialPoller &getPoller() const;
+
+	/**
+	 * @brief Legt fest, über welche Felder ein Client benachrichtigt wird.
+	 *
+	 * @param id Client-ID.
+	 * @param mask Bitmaske der Feldindizes (POLL_ALL_FIELDS = alle, 0 = keine).
+	 * @return false, wenn der Client nicht registriert ist.
+	 */
+	bool setFieldSubscription(uint32_t id, uint32_t mask);
+
+	static constexpr uint32_t POLL_ALL_FIELDS = 0xFFFFFFFF;  ///< Abonnement aller Felder
+
+	/**
+	 * @brief Setzt den Zeilenfilter eines Clients (nur aus dem WebSocket-Kontext).
+	 *
+	 * Der Filter aller Clients wird neu übersetzt und von der Bridge-Task beim nächsten
+	 * Durchlauf übernommen. Ein leerer Regelsatz (count = 0) hebt den Filter auf.
+	 *
+	 * @param id Client-ID.
+	 * @param spec Regelsatz.
+	 * @param error Puffer für die Fehlerbeschreibung.
+	 * @param size Größe des Puffers.
+	 * @return false, wenn der Client nicht registriert ist, eine Regel ungültig ist oder die
+	 *         gemeinsamen Muster erschöpft sind; der bisherige Filter bleibt dann aktiv.
+	 */
+	bool setFilter(uint32_t id, const SerialFilterSpec &spec, char *error, size_t size);
+
+	/**
+	 * @brief Gibt den Zeilenfilter eines Clients zurück (nur aus dem WebSocket-Kontext).
+	 *
+	 * @param id Client-ID.
+	 * @param spec Regelsatz (count = 0: kein Filter).
+	 * @param lines Bisher zugestellte Zeilen.
+	 * @return false, wenn der Client nicht registriert ist.
+	 */
+	bool getFilter(uint32_t id, SerialFilterSpec &spec, uint32_t &lines) const;
+
+	static constexpr size_t TRIGGER_SNAPSHOT_BYTES = 4096;  ///< Umfang eines Schnappschusses
+
+	/**
+	 * @brief Übersetzt neue Regeln und übergibt sie an die Bridge-Task.
+	 *
+	 * @param config Regeln (count = 0 schaltet ab).
+	 * @param error Puffer für die Fehlerbeschreibung.
+	 * @param size Größe des Puffers.
+	 * @return false bei ungültiger Regel oder fehlendem Speicher; die bisherigen Regeln bleiben.
+	 */
+	bool setTriggers(const SerialTriggerConfig &config, char *error, size_t size);
+
+	/**
+	 * @brief Kopie einer aktiven Regel und ihrer Zähler.
+	 *
+	 * @return false bei ungültigem Index oder ohne Regeln.
+	 */
+	bool getTrigger(size_t index, SerialTriggerRule &rule, SerialTriggerStats &stats) const;
+
+	/**
+	 * @brief Von diesem Kanal gesetzte Status (Bit 0: Warnung, Bit 1: Fehler).
+	 */
+	uint8_t getTriggerStatus() const;
+
+	/**
+	 * @brief Quittiert die Status dieses Kanals; die LED erlischt, wenn kein Kanal sie mehr setzt.
+	 */
+	void ackTriggers();
+
+	/**
+	 * @brief Kopiert den letzten Schnappschuss.
+	 *
+	 * @param info Kopf des Schnappschusses.
+	 * @param data Zielpuffer (mindestens TRIGGER_SNAPSHOT_BYTES).
+	 * @return false, wenn es keinen gibt oder er gerade neu geschrieben wird.
+	 */
+	bool getTriggerSnapshot(SerialTriggerSnapshot &info, uint8_t *data) const;
+
+	/**
+	 * @brief Millisekunden seit dem letzten Lebenszeichen des Geräts (UINT32_MAX = noch keines).
+	 */
+	uint32_t msSinceDeviceSeen() const;
+
 	/**
 	 * @brief Gibt die aktuell verwendete Baudrate zurück.
 	 *
@@ -94,23 +311,604 @@ class SerialBridge {
 	void sendAvailability();
 
 	/**
-	 * @brief Sendet Daten über die serielle Schnittstelle.
+	 * @brief Reiht Daten zum Senden über die serielle Schnittstelle ein.
 	 *
 	 * @param data Der zu sendende String.
+	 * @param clientId Client, der nach der Übertragung `serial`/`send`/`done` erhält (0 = keiner).
+	 * @return Auftragsnummer oder 0, wenn die Sendewarteschlange voll ist.
+	 */
+	uint32_t sendData(const String &data, uint32_t clientId = 0);
+
+	/**
+	 * @brief Prüft und übernimmt neue Einstellungen des Sendepfads.
+	 *
+	 * Die TX-Task wendet sie vor dem nächsten Auftrag an.
+	 *
+	 * @param config Flusskontrolle, Pacing und RS-485-Zeiten.
+	 * @return false bei ungültigen Einstellungen (siehe SerialTx::validate).
+	 */
+	bool setTxConfig(const SerialTxConfig &config);
+
+	/**
+	 * @brief Gibt die zuletzt gesetzten Einstellungen des Sendepfads zurück.
+	 */
+	SerialTxConfig getTxConfig() const;
+
+	/**
+	 * @brief Gibt die Zähler des Sendepfads zurück.
+	 */
+	SerialTxStats getTxStats() const;
+
+	/**
+	 * @brief Gibt die Zähler des Empfangspfads zurück.
+	 */
+	const SerialRxStats &getRxStats() const;
+
+	/**
+	 * @brief Registriert einen neu verbundenen WebSocket-Client (zunächst im JSON-Modus).
+	 *
+	 * @param id Client-ID.
+	 */
+	void addClient(uint32_t id);
+
+	/**
+	 * @brief Entfernt einen getrennten WebSocket-Client.
+	 *
+	 * @param id Client-ID.
+	 */
+	void removeClient(uint32_t id);
+
+	/**
+	 * @brief Schaltet für einen Client zwischen JSON und binären Frames um.
+	 *
+	 * @param id Client-ID.
+	 * @param enabled true = binäre Frames, false = JSON.
+	 * @return false, wenn der Client nicht registriert ist.
+	 */
+	bool setBinary(uint32_t id, bool enabled);
+
+	/**
+	 * @brief Setzt Latenzbudget und maximale Nachrichtengröße für das Bündeln.
+	 *
+	 * Die Werte werden von der Bridge-Task beim nächsten Durchlauf übernommen.
+	 *
+	 * @param latencyMs Maximale Verzögerung einer Zeile in ms (0 = jede Zeile einzeln).
+	 * @param maxFrameBytes Maximale Nutzdaten pro Nachricht (höchstens SerialCoalescer::MAX_FRAME).
+	 */
+	void setCoalescing(uint32_t latencyMs, size_t maxFrameBytes);
+
+	/**
+	 * @brief Gibt die Zähler des Bündelns zurück (Nachrichten/s, Zeilen pro Nachricht, ...).
+	 */
+	SerialCoalescerStats getCoalescerStats() const;
+
+	/**
+	 * @brief Setzt das Framing des Empfangsstroms (Zeilen, Endekennung, Länge, STX/ETX, ...).
+	 *
+	 * Die Einstellung wird von der Bridge-Task beim nächsten Durchlauf übernommen; ein
+	 * angefangener Datensatz wird vorher noch nach altem Verfahren ausgegeben.
+	 *
+	 * @param config Neue Einstellung.
+	 * @return false, wenn die Einstellung ungültig ist (siehe SerialFramer::validate).
+	 */
+	bool setFraming(const SerialFramerConfig &config);
+
+	/**
+	 * @brief Gibt die zuletzt gesetzte Framing-Einstellung zurück.
+	 */
+	SerialFramerConfig getFraming() const;
+
+	/**
+	 * @brief Gibt die Zähler des Framers zurück.
+	 */
+	SerialFramerStats getFramerStats() const;
+
+	/**
+	 * @brief Startet einen Mitschnitt nach `/logs/device/<session>.cap`.
+	 *
+	 * @param session Sitzungsname (siehe SerialRecorder::validate).
+	 * @param config Rotation und Quote.
+	 * @return false bei ungültigen Parametern oder laufendem Mitschnitt.
+	 */
+	bool startRecording(const String &session, const SerialRecorderConfig &config);
+
+	/**
+	 * @brief Beendet den laufenden Mitschnitt; gepufferte Daten werden noch geschrieben.
+	 */
+	void stopRecording();
+
+	/**
+	 * @brief Zugriff auf den Mitschnitt (Status und Zähler).
+	 */
+	const SerialRecorder &getRecorder() const;
+
+	/**
+	 * @brief Öffnet, ändert oder schließt den TCP-Zugang (roh und RFC 2217).
+	 *
+	 * Die TCP-Task übernimmt die Einstellung beim nächsten Durchlauf; bestehende Verbindungen
+	 * werden dabei getrennt.
+	 *
+	 * @param config Aktivierung und Ports.
+	 * @return false, wenn bei aktivem Zugang kein Port oder zweimal derselbe Port angegeben ist.
+	 */
+	bool setTcp(const SerialTcpConfig &config);
+
+	/**
+	 * @brief Gibt die zuletzt gesetzte Einstellung des TCP-Zugangs zurück.
+	 */
+	SerialTcpConfig getTcp() const;
+
+	/**
+	 * @brief Zugriff auf den TCP-Server (Verbindungen und Zähler).
+	 */
+	const SerialTcpServer &getTcpServer() const;
+
+	/**
+	 * @brief Reiht ein Befehlsskript zur Ausführung in der Skript-Task ein.
+	 *
+	 * Das Ergebnis geht nach dem Lauf als `serial`/`run`/`done` an den Client.
+	 *
+	 * @param clientId Auftraggeber.
+	 * @param name Skriptname für Ergebnis und Log ("" = direkt übergeben).
+	 * @param source Skripttext (siehe SerialScript).
+	 * @return Auftragsnummer oder 0, wenn bereits ein Auftrag wartet oder der Text zu groß ist.
+	 */
+	uint32_t runScript(uint32_t clientId, const String &name, const String &source);
+
+	/**
+	 * @brief Bricht ein wartendes oder laufendes Skript ab.
+	 *
+	 * @param job Auftragsnummer (0 = jedes).
+	 * @return false, wenn kein solcher Auftrag existiert.
+	 */
+	bool cancelScript(uint32_t job);
+
+	/**
+	 * @brief Zugriff auf die Skriptausführung (Zustand und Zähler).
+	 */
+	const SerialScriptEngine &getScriptEngine() const;
+
+	/**
+	 * @brief Fordert das Nachladen aus dem Verlaufspuffer für einen Client an.
+	 *
+	 * Die Bridge-Task beantwortet die Anfrage mit `serial`/`replay` (Bereich), sendet die Blöcke
+	 * mit gesetztem Replay-Flag und schließt mit `serial`/`replay`/`done` ab. Eine laufende
+	 * Anfrage desselben Clients wird ersetzt.
+	 *
+	 * @param id Client-ID.
+	 * @param mode Startpunkt.
+	 * @param arg Laufende Nummer bzw. Anzahl Bytes.
+	 * @return false, wenn der Client nicht registriert ist.
+	 */
+	bool requestReplay(uint32_t id, SerialReplayMode mode, uint32_t arg);
+
+	/**
+	 * @brief Startet das Durchreichen (z. B. Flashen eines angeschlossenen Controllers).
+	 *
+	 * Die TX-Task stellt die Rate ein, führt die Boot-Sequenz aus und meldet sich mit
+	 * `serial`/`passthrough`/`ready`. Danach gehen Upload-Blöcke des Besitzers unverändert auf
+	 * die UART, Empfangsdaten als Binär-Frames mit SERIAL_FRAME_FLAG_RAW nur an ihn. Framer,
+	 * Skripte, Abfragen, Regeln und der TCP-Zugang ruhen so lange.
+	 *
+	 * @param id Client-ID des Besitzers.
+	 * @param config Parameter der Übertragung.
+	 * @param error Puffer für die Fehlerbeschreibung.
+	 * @param size Größe des Puffers.
+	 * @return false, wenn die Parameter ungültig sind, bereits durchgereicht wird, eine
+	 *         Baudratenerkennung oder ein Skript läuft oder kein Speicher frei ist.
 	 */
-	void sendData(const String &data);
+	bool startPassthrough(uint32_t id, const SerialPassthroughConfig &config, char *error, size_t size);
+
+	/**
+	 * @brief Beendet das Durchreichen.
+	 *
+	 * @param id Client-ID (muss der Besitzer sein).
+	 * @param discard true = noch nicht geschriebene Daten verwerfen (Abbruch).
+	 * @return false, wenn der Client nicht Besitzer ist.
+	 */
+	bool stopPassthrough(uint32_t id, bool discard);
+
+	/**
+	 * @brief Übernimmt einen Upload-Block des Besitzers.
+	 *
+	 * @param id Client-ID.
+	 * @param offset Position des Blocks in der Übertragung.
+	 * @param data Nutzdaten.
+	 * @param len Länge der Nutzdaten.
+	 * @return Ergebnis; UPLOAD_INACTIVE auch, wenn der Client nicht Besitzer ist.
+	 */
+	SerialUploadResult uploadPassthrough(uint32_t id, uint32_t offset, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Zugriff auf das Durchreichen (Zustand und Zähler).
+	 */
+	const SerialPassthrough &getPassthrough() const;
+
+	/**
+	 * @brief Fordert einen Reset des angeschlossenen Controllers über die Boot-Leitungen an.
+	 *
+	 * Die TX-Task führt ihn aus und meldet das Ergebnis als `serial`/`passthrough`/`reset`.
+	 *
+	 * @param id Client für die Rückmeldung.
+	 * @param mode BOOT_MODE_BOOTLOADER oder BOOT_MODE_RUN.
+	 * @return false bei ungültigem Modus, laufendem Durchreichen oder offener Anforderung.
+	 */
+	bool requestTargetReset(uint32_t id, uint8_t mode);
+
+	/**
+	 * @brief Beginnt eine Dateiübertragung (HTTP-Upload) an das Gerät.
+	 *
+	 * Die TX-Task sendet die Datei zeilenweise mit Zeilenpause und ggf. Warten auf den Prompt
+	 * und meldet Fortschritt und Ergebnis als `serial`/`stream` an alle Clients. Abfragen ruhen
+	 * so lange; manuelle Sendeaufträge bleiben möglich (z. B. ein Abbruchbefehl).
+	 *
+	 * @param config Parameter der Übertragung.
+	 * @param error Puffer für die Fehlerbeschreibung.
+	 * @param size Größe des Puffers.
+	 * @return false bei ungültigen Parametern, laufender Übertragung, Durchreichen, Skript,
+	 *         Baudratenerkennung oder wenn kein Speicher frei ist.
+	 */
+	bool startStream(const SerialFileStreamConfig &config, char *error, size_t size);
+
+	/**
+	 * @brief Übergibt einen Teil der Datei und weckt die TX-Task (blockiert nicht).
+	 *
+	 * @return Anzahl der übernommenen Bytes (weniger als len, wenn der Puffer voll ist).
+	 */
+	size_t feedStream(const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Meldet das Ende der Datei.
+	 */
+	void endStream();
+
+	/**
+	 * @brief Bricht die Dateiübertragung ab.
+	 *
+	 * @return false, wenn keine Übertragung läuft.
+	 */
+	bool cancelStream();
+
+	/**
+	 * @brief Zugriff auf die Dateiübertragung (Zustand, Parameter und Zähler).
+	 */
+	const SerialFileStream &getStream() const;
 
    private:
-	HardwareSerial &_serial;  ///< Referenz auf die serielle Schnittstelle
-	AsyncWebSocket &_ws;      ///< Referenz auf den WebSocket-Server
-	uint8_t _rxPin, _txPin;   ///< RX- und TX-Pin
-	uint32_t _baudRate;       ///< Aktuelle Baudrate
-	bool _deviceConnected;    ///< Status der Geräteverbindung
+	UartPort &_port;         ///< Referenz auf die serielle Schnittstelle
+	WsOutbox &_out;          ///< Sendewarteschlangen der WebSocket-Clients
+	uint8_t _rxPin, _txPin;  ///< RX- und TX-Pin
+	uint32_t _baudRate;      ///< Aktuelle Baudrate
+	bool _deviceConnected;   ///< Status der Geräteverbindung
+	SerialRxPump _rx;        ///< Empfangspfad (Event-Queue oder Polling)
+	uint8_t _channel;        ///< Kanal-ID im Binär-Header
+	uint32_t _seq;           ///< Laufende Nummer der gesendeten Datenblöcke
+
+	/**
+	 * @struct ClientSlot
+	 * @brief Empfangsoptionen eines WebSocket-Clients.
+	 */
+	struct ClientSlot {
+		uint32_t id;             ///< Client-ID
+		bool used;               ///< Slot belegt
+		bool binary;             ///< Binärkanal aktiviert
+		uint32_t fields;         ///< Abonnierte Felder des Pollers (Bitmaske)
+		uint8_t replay;          ///< Replay-Zustand (REPLAY_IDLE, ...)
+		uint8_t replayMode;      ///< SerialReplayMode der Anfrage
+		uint32_t replayArg;      ///< Argument der Anfrage
+		uint32_t replayChunks;   ///< Bereits nachgeladene Blöcke
+		uint32_t replayMissing;  ///< Nicht mehr vorhandene Blöcke
+		uint64_t replayPos;      ///< Leseposition im Verlaufspuffer
+		uint64_t replayEnd;      ///< Ende des Replays (Stand bei Anfrage)
+	};
+	static constexpr uint8_t REPLAY_IDLE = 0;       ///< Kein Replay
+	static constexpr uint8_t REPLAY_REQUESTED = 1;  ///< Angefordert, Startpunkt noch offen
+	static constexpr uint8_t REPLAY_ACTIVE = 2;     ///< Läuft
+	ClientSlot _clients[MAX_CLIENTS];  ///< Registrierte Clients
+	mutable portMUX_TYPE _clientsMux;  ///< Schutz von _clients (AsyncTCP- vs. Bridge-Task)
+
+	static constexpr uint32_t IDLE_WAKE_MS = 250;    ///< Maximale Wartezeit ohne Daten (Geräteerkennung)
+	static constexpr size_t RX_CHUNK = 256;          ///< Blockgröße beim Auslesen der UART
+	static constexpr size_t LOG_HEX_BYTES = 32;      ///< Bytes eines Binär-Datensatzes im Geräte-Log
+	SerialFramer _framer;                            ///< Zerlegt den Empfangsstrom in Datensätze
+	char _lineBuffer[SerialFramer::MAX_RECORD + 1];  ///< Hex-Dump binärer Datensätze für das Log
+	char _logPrefix[8];                              ///< logTag() als C-String für LOGF()
+	uint32_t _lastRx;                                ///< Zeitstempel des letzten Zeicheneingangs
+	SerialFramerConfig _framingConfig;               ///< Angeforderte Einstellung (von setFraming)
+	volatile bool _framingDirty;                     ///< Neue Einstellung liegt für die Task bereit
+
+	SerialCoalescer _coalescer;    ///< Bündelt Zeilen zu Nachrichten
+	uint32_t _coalesceLatency;     ///< Angefordertes Latenzbudget (von setCoalescing)
+	size_t _coalesceFrame;         ///< Angeforderte Nachrichtengröße (von setCoalescing)
+	volatile bool _coalesceDirty;  ///< Neue Werte liegen für die Task bereit
+
+	/// Nullterminierte Nutzdaten für ArduinoJson
+	char _textBuffer[SerialCoalescer::MAX_FRAME + 1];
+	/// Header und Nutzdaten eines Binär-Frames
+	uint8_t _frameBuffer[SERIAL_FRAME_HEADER_LEN + SerialCoalescer::MAX_FRAME];
+
+	static constexpr size_t REPLAY_RESERVE = 2048;      ///< Platz im Client-Puffer, der für Live-Daten frei bleibt
+	static constexpr size_t REPLAY_BURST = 4;           ///< Blöcke pro Client und Durchlauf
+	static constexpr uint32_t REPLAY_INTERVAL_MS = 10;  ///< Wartezeit der Task während eines Replays
+	SerialScrollback _scrollback;                       ///< Verlaufspuffer der verteilten Blöcke
+	uint8_t *_scrollbackMem;                            ///< Speicher des Verlaufspuffers (PSRAM oder RAM)
+
+	SerialTx _tx;              ///< Sendewarteschlange
+	TaskHandle_t _txTask;      ///< TX-Task (wird bei neuen Aufträgen benachrichtigt)
+	SerialTxConfig _txConfig;  ///< Angeforderte Einstellungen (von setTxConfig)
+	volatile bool _txDirty;    ///< Neue Einstellungen liegen für die TX-Task bereit
+
+	SerialRecorder _recorder;  ///< Mitschnitt des RX/TX-Stroms
+	TaskHandle_t _recTask;     ///< Schreib-Task des Mitschnitts
+
+	/**
+	 * @class TcpLink
+	 * @brief Serielle Seite des TCP-Servers: Versand über die TX-Task, Baudrate über setBaud().
+	 */
+	class TcpLink : public SerialTcpPort {
+	   public:
+		explicit TcpLink(SerialBridge &bridge) : _bridge(bridge) {
+		}
+		size_t write(const uint8_t *data, size_t len) override;
+		uint32_t setBaud(uint32_t baud) override;
+		uint32_t baud() override;
+		void purge(bool rx, bool tx) override;
+
+	   private:
+		SerialBridge &_bridge;  ///< Zugehörige Bridge
+	};
+	TcpLink _tcpLink;              ///< Serielle Seite des TCP-Servers
+	SerialTcpServer _tcp;          ///< Roh-/RFC-2217-Server
+	TaskHandle_t _tcpTask;         ///< TCP-Task (wird bei neuer Einstellung benachrichtigt)
+	SerialTcpConfig _tcpConfig;    ///< Angeforderte Einstellung (von setTcp)
+	volatile bool _tcpDirty;       ///< Neue Einstellung liegt für die TCP-Task bereit
+
+	SerialScriptEngine _script;    ///< Ausführung von Befehlsskripten
+	TaskHandle_t _scriptTask;      ///< Skript-Task (bei Aufträgen und RX-Daten benachrichtigt)
+
+	SerialPoller _poller;              ///< Zyklische Abfragen und Feldspeicher (Bridge-Task)
+	SerialPollerConfig _pollConfig;    ///< Angeforderte Abfragen (von setPoll, nur WebSocket-Kontext)
+	SerialPollerConfig *_pollPending;  ///< Kopie der neuen Abfragen für die Task (Heap)
+	volatile bool _pollDirty;          ///< Neue Abfragen liegen für die Task bereit
+
+	static_assert(MAX_CLIENTS <= SerialLineFilter::MAX_SLOTS, "Ein Filter-Slot pro Client");
+	SerialFilterSpec *_filterSpecs;              ///< Regelsätze je Slot (WebSocket-Kontext, erst beim ersten Filter angelegt)
+	uint32_t _filterOwner[MAX_CLIENTS];          ///< Client-ID je Regelsatz (WebSocket-Kontext)
+	SerialLineFilter *_filterPending;            ///< Neuer Filter für die Task (nullptr = keiner)
+	uint32_t _filterPendingIds[MAX_CLIENTS];     ///< Client-IDs zum neuen Filter
+	volatile bool _filterDirty;                  ///< Neuer Filter liegt für die Task bereit
+	SerialLineFilter *_filter;                   ///< Aktiver Filter (Bridge-Task)
+	uint32_t _filterIds[MAX_CLIENTS];            ///< Client-IDs zum aktiven Filter (Bridge-Task)
+	volatile uint32_t _filterSeq[MAX_CLIENTS];   ///< Zugestellte Zeilen je Slot (Bridge-Task)
+
+	/**
+	 * @brief Übersetzt die Regelsätze aller Slots und übergibt den Filter an die Bridge-Task.
+	 *
+	 * @return false bei ungültigem Regelsatz oder fehlendem Speicher.
+	 */
+	bool rebuildFilter(char *error, size_t size);
+
+	/**
+	 * @brief Slots, deren Client gerade einen aktiven Filter hat (Bridge-Task).
+	 */
+	uint32_t filteredSlots(const ClientSlot *clients) const;
+
+	/**
+	 * @brief Stellt eine Zeile den Clients zu, deren Filter sie durchlässt (Bridge-Task).
+	 */
+	void deliverFiltered(const uint8_t *line, size_t len, uint16_t flags, uint64_t rxUs);
+
+	static constexpr uint8_t SNAPSHOT_EMPTY = 0;    ///< Noch kein Schnappschuss
+	static constexpr uint8_t SNAPSHOT_READY = 1;    ///< Schnappschuss lesbar
+	static constexpr uint8_t SNAPSHOT_FILLING = 2;  ///< Bridge-Task schreibt
+	static constexpr uint8_t SNAPSHOT_READING = 3;  ///< WebSocket-Kontext liest
+	static constexpr size_t ALERT_TEXT = 160;       ///< Zeichen der Zeile in Alarm und Log
+	SerialTrigger *_trigger;                        ///< Aktive Regeln (Bridge-Task; von außen nur unter _clientsMux)
+	SerialTrigger *_triggerPending;                 ///< Neue Regeln für die Task (nullptr = keine)
+	volatile bool _triggerDirty;                    ///< Neue Regeln liegen für die Task bereit
+	uint8_t *_snapshotData;                         ///< Daten des Schnappschusses (beim ersten angelegt)
+	SerialTriggerSnapshot _snapshot;                ///< Kopf des Schnappschusses
+	mutable volatile uint8_t _snapshotState;        ///< SNAPSHOT_EMPTY, ...
+
+	/**
+	 * @brief Führt die Aktionen ausgelöster Regeln aus (Bridge-Task).
+	 */
+	void fireTriggers(uint32_t fired, const uint8_t *line, size_t len, uint64_t rxUs);
+
+	/**
+	 * @brief Hält das Ende des Verlaufspuffers einschließlich der auslösenden Zeile fest.
+	 */
+	void takeSnapshot(const char *rule, uint64_t rxUs);
+
+	/**
+	 * @brief Setzt den LED-Status einer Regel für diesen Kanal.
+	 */
+	void raiseTriggerStatus(uint8_t level);
+
+	/**
+	 * @brief Sende-Callback von Skripten und Poller: reiht in die TX-Task ein.
+	 */
+	static bool onQueueSend(void *ctx, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Änderungs-Callback des Pollers: meldet `serial`/`field`/`changed` an die Abonnenten.
+	 */
+	static void onPollUpdate(void *ctx, uint32_t changed);
+
+	/**
+	 * @brief Ergebnis-Callback der Skriptausführung: meldet `serial`/`run`/`done` an den Client.
+	 */
+	static void onScriptDone(void *ctx, const SerialScriptResult &result);
+
+	static constexpr uint8_t AUTOBAUD_IDLE = 0;     ///< Keine Erkennung gelaufen
+	static constexpr uint8_t AUTOBAUD_RUNNING = 1;  ///< Erkennung läuft
+	static constexpr uint8_t AUTOBAUD_LOCKED = 2;   ///< Rate erkannt und übernommen
+	static constexpr uint8_t AUTOBAUD_FAILED = 3;   ///< Keine Rate erkannt, alte Rate aktiv
+	BaudDetector _baudDetector;                     ///< Pulsmessung und Bewertung der Stichproben
+	BaudDetectResult _autoBaud;                     ///< Ergebnis der letzten Erkennung
+	volatile uint8_t _autoBaudState;                ///< AUTOBAUD_IDLE, ...
+	volatile bool _autoBaudRequested;               ///< Erkennung wurde angefordert
+
+	/**
+	 * @brief Führt die angeforderte Baudratenerkennung aus (nur aus der Bridge-Task).
+	 */
+	void runAutoBaud();
+
+	DevicePresence _presence;               ///< Entprellte Geräteerkennung
+	DevicePresenceConfig _presenceConfig;   ///< Angeforderte Schwellen (von setPresence)
+	volatile bool _presenceDirty;           ///< Neue Schwellen liegen für die Task bereit
+
+	/**
+	 * @brief Wertet die Geräteerkennung aus und meldet Wechsel (Log, StatusHandler, Clients).
+	 */
+	void checkDevice();
+
+	/**
+	 * @brief Führt SERIAL_CONNECTED/SERIAL_NOT_CONNECTED im StatusHandler über alle Kanäle nach.
+	 *
+	 * @param connected true, wenn dieser Kanal ein Gerät erkannt hat.
+	 */
+	static void updateSerialStatus(bool connected);
+
+	/**
+	 * @brief Präfix für Logmeldungen ("" auf Kanal 0, sonst "[chN] ").
+	 */
+	String logTag() const;
+
+	/**
+	 * @brief Callback des Framers: sendet einen fertigen Datensatz an alle Clients.
+	 *
+	 * @param ctx Zeiger auf die SerialBridge-Instanz.
+	 * @param line Datensatz (nicht nullterminiert).
+	 * @param len Länge des Datensatzes.
+	 * @param complete true bei Zeilenende/Maximallänge (wird geloggt), false nach Timeout.
+	 * @param rxUs Empfangszeitpunkt des ersten Bytes in µs.
+	 */
+	static void onLine(void *ctx, const uint8_t *line, size_t len, bool complete, uint64_t rxUs);
+
+	/**
+	 * @brief Callback des Coalescers: sendet eine (gebündelte) Nachricht an alle Clients.
+	 *
+	 * @param ctx Zeiger auf die SerialBridge-Instanz.
+	 * @param data Eine oder mehrere Zeilen.
+	 * @param len Länge der Daten.
+	 * @param lines Anzahl der Zeilen.
+	 * @param flags SerialFrameFlags der letzten Zeile.
+	 * @param rxUs Empfangszeitpunkt der ersten Zeile in µs.
+	 */
+	static void onFrame(void *ctx, const uint8_t *data, size_t len, uint16_t lines, uint16_t flags, uint64_t rxUs);
+
+	/**
+	 * @brief Verteilt einen Datenblock an alle Clients, je nach Modus als JSON oder Binär-Frame.
+	 *
+	 * @param data Rohdaten.
+	 * @param len Länge der Daten.
+	 * @param flags SerialFrameFlags für den Binär-Header.
+	 * @param rxUs Empfangszeitpunkt in µs (`ts` bzw. Header-Zeitstempel).
+	 */
+	void broadcast(const uint8_t *data, size_t len, uint16_t flags, uint64_t rxUs);
+
+	/**
+	 * @brief Sendet für alle Clients mit laufendem Replay die nächsten Blöcke.
+	 *
+	 * @return true, solange noch ein Replay läuft.
+	 */
+	bool pumpReplay();
+
+	/**
+	 * @brief Verschickt einen Block aus dem Verlaufspuffer an einen Client.
+	 */
+	void sendReplayChunk(const ClientSlot &slot, const SerialScrollbackRecord &rec);
+
+	static constexpr uint32_t PASSTHROUGH_WAKE_MS = 100;  ///< Wartezeit der TX-Task während des Durchreichens
+	static constexpr uint32_t PASSTHROUGH_ACK_BYTES = SerialPassthrough::BUFFER_BYTES / 4;  ///< Geschriebene Bytes je Quittung
+	SerialPassthrough _passthrough;      ///< Durchreichen zum Controller (Puffer und Boot-Leitungen)
+	uint8_t *_passthroughMem;            ///< Speicher des Durchreichens (nur während einer Übertragung)
+	uint32_t _passthroughSeq;            ///< Laufende Nummer der RAW-Frames an den Besitzer
+	uint32_t _passthroughAcked;          ///< Zuletzt quittierte Bytes (TX-Task)
+	size_t _passthroughRxLen;            ///< Gesammelte Empfangsbytes in _frameBuffer (Bridge-Task)
+	uint64_t _passthroughRxUs;           ///< Empfangszeit des ersten gesammelten Bytes
+	volatile uint8_t _bootRequest;       ///< Angeforderter Reset (SerialBootMode, von requestTargetReset)
+	uint32_t _bootRequester;             ///< Client für die Rückmeldung zum Reset
+
+	static constexpr uint32_t STREAM_PROGRESS_MS = 500;  ///< Abstand der Fortschrittsmeldungen einer Dateiübertragung
+	SerialFileStream _stream;            ///< Dateiübertragung (Puffer, Zeilentakt, Prompt)
+	uint8_t *_streamMem;                 ///< Speicher der Dateiübertragung (nur während einer Übertragung)
+	uint32_t _streamReported;            ///< Gesendete Bytes bei der letzten Fortschrittsmeldung (TX-Task)
+	uint32_t _streamReportMs;            ///< Zeitpunkt der letzten Fortschrittsmeldung (TX-Task)
+	uint32_t _streamWait;                ///< Wartezeit der TX-Task bis zum nächsten Durchlauf (ms)
+
+	/**
+	 * @brief Bedient die Dateiübertragung in der TX-Task: Senden, Fortschritt, Ende.
+	 */
+	void serviceStream();
+
+	/**
+	 * @brief Schließt die Dateiübertragung ab, gibt den Speicher frei und meldet das Ergebnis.
+	 */
+	void finishStream();
+
+	/**
+	 * @brief Sendet ein `serial`/`stream`-Event an alle Clients.
+	 *
+	 * @param status Status des Events.
+	 * @param details Details (darf leer sein).
+	 * @param error Fehlerbeschreibung oder nullptr.
+	 */
+	void sendStreamEvent(const char *status, JsonObjectConst details, const char *error = nullptr);
+
+	/**
+	 * @brief Bedient das Durchreichen in der TX-Task: Start, Schreiben, Quittungen, Ende.
+	 */
+	void servicePassthrough();
 
-	static constexpr uint32_t BATCH_TIMEOUT_MS = 20;  ///< Timeout (ms) für Batch-Verarbeitung
-	char _batchBuffer[256];                           ///< Puffer für empfangene Zeichen
-	size_t _batchIndex;                               ///< Aktuelle Position im Batch-Puffer
-	uint32_t _lastRx;                                 ///< Zeitstempel des letzten Zeicheneingangs
+	/**
+	 * @brief Schließt das Durchreichen ab, gibt den Speicher frei und meldet das Ergebnis.
+	 *
+	 * @param error Fehlerbeschreibung oder nullptr.
+	 */
+	void finishPassthrough(const char *error);
+
+	/**
+	 * @brief Sendet ein `serial`/`passthrough`-Event an einen Client.
+	 *
+	 * @param id Client-ID.
+	 * @param status Status des Events.
+	 * @param details Details (darf leer sein).
+	 * @param error Fehlerbeschreibung oder nullptr.
+	 */
+	void sendPassthroughEvent(uint32_t id, const char *status, JsonObjectConst details, const char *error = nullptr);
+
+	/**
+	 * @brief Sammelt Empfangsdaten für den Besitzer des Durchreichens (Bridge-Task).
+	 */
+	void collectPassthroughRx(const uint8_t *data, size_t len, uint64_t rxUs);
+
+	/**
+	 * @brief Sendet die gesammelten Empfangsdaten als RAW-Frame an den Besitzer.
+	 */
+	void flushPassthroughRx();
+
+	/**
+	 * @brief Callback der SerialTx: meldet dem Client einen übertragenen Auftrag.
+	 *
+	 * @param ctx Zeiger auf die SerialBridge-Instanz.
+	 * @param client Client-ID (0 = keine Meldung).
+	 * @param job Auftragsnummer.
+	 * @param bytes Übertragene Bytes.
+	 * @param ok false, wenn das Sendeende nicht bestätigt wurde.
+	 */
+	static void onTxDone(void *ctx, uint32_t client, uint32_t job, size_t bytes, bool ok);
+
+	/**
+	 * @brief Mithörer der SerialTx: schneidet gesendete Bytes mit.
+	 */
+	static void onTxData(void *ctx, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Weck-Callback des SerialRecorder.
+	 */
+	static void onRecorderWake(void *ctx);
 
 	/**
 	 * @brief Interne Task-Funktion für FreeRTOS zur seriellen Datenverarbeitung.
@@ -118,6 +916,34 @@ class SerialBridge {
 	 * @param param Zeiger auf die SerialBridge-Instanz.
 	 */
 	static void taskFunc(void *param);
+
+	/**
+	 * @brief Task-Funktion der TX-Task: überträgt eingereihte Aufträge.
+	 *
+	 * @param param Zeiger auf die SerialBridge-Instanz.
+	 */
+	static void txTaskFunc(void *param);
+
+	/**
+	 * @brief Task-Funktion der Schreib-Task: schreibt volle Mitschnittpuffer auf das Dateisystem.
+	 *
+	 * @param param Zeiger auf die SerialBridge-Instanz.
+	 */
+	static void recTaskFunc(void *param);
+
+	/**
+	 * @brief Task-Funktion der TCP-Task: nimmt Verbindungen an und bedient die Sockets.
+	 *
+	 * @param param Zeiger auf die SerialBridge-Instanz.
+	 */
+	static void tcpTaskFunc(void *param);
+
+	/**
+	 * @brief Task-Funktion der Skript-Task: führt eingereihte Befehlsskripte aus.
+	 *
+	 * @param param Zeiger auf die SerialBridge-Instanz.
+	 */
+	static void scriptTaskFunc(void *param);
 };
 
 #endif  // SERIALBRIDGE_H
@@ -0,0 +1,146 @@
+/**
+ * @file SerialCoalescer.h
+ * @brief Adaptives Bündeln serieller Zeilen zu größeren WebSocket-Nachrichten.
+ *
+ * Bei wenig Verkehr wird jede Zeile sofort weitergereicht. Kommt innerhalb des Latenzbudgets
+ * nach einer gesendeten Nachricht weitere Ausgabe, werden die Zeilen gesammelt und spätestens
+ * nach Ablauf des Budgets oder bei Erreichen der maximalen Framegröße als eine Nachricht
+ * ausgegeben. So entstehen unter Last wenige große statt tausender kleiner Frames.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALCOALESCER_H
+#define SERIALCOALESCER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct SerialCoalescerStats
+ * @brief Zähler zum Abstimmen des Bündelns.
+ */
+struct SerialCoalescerStats {
+	uint32_t frames;            ///< Ausgegebene Nachrichten gesamt
+	uint32_t lines;             ///< Eingegangene Zeilen gesamt
+	uint32_t bytes;             ///< Ausgegebene Nutzdaten gesamt
+	uint32_t immediate;         ///< Zeilen, die ohne Wartezeit ausgegeben wurden
+	uint32_t maxLinesPerFrame;  ///< Größte Anzahl Zeilen in einer Nachricht
+	float framesPerSec;         ///< Nachrichten pro Sekunde (letztes volles Messfenster)
+	float linesPerFrame;        ///< Zeilen pro Nachricht (letztes volles Messfenster)
+};
+
+/**
+ * @class SerialCoalescer
+ * @brief Sammelt Zeilen innerhalb eines Latenzbudgets zu einer Nachricht.
+ */
+class SerialCoalescer {
+   public:
+	static constexpr size_t MAX_FRAME = 2048;            ///< Kapazität des Sammelpuffers
+	static constexpr uint32_t DEFAULT_LATENCY_MS = 20;   ///< Standard-Latenzbudget
+	static constexpr uint32_t MAX_LATENCY_MS = 1000;     ///< Größtes Latenzbudget (darüber wirkt die Anzeige nicht mehr live)
+	static constexpr size_t DEFAULT_FRAME_BYTES = 1024;  ///< Standard-Maximalgröße einer Nachricht
+	static constexpr uint32_t RATE_WINDOW_MS = 1000;     ///< Messfenster für die Raten
+
+	/**
+	 * @brief Callback für eine fertige Nachricht.
+	 *
+	 * @param ctx Benutzerkontext.
+	 * @param data Nutzdaten (eine oder mehrere Zeilen, nur während des Aufrufs gültig).
+	 * @param len Länge der Nutzdaten.
+	 * @param lines Anzahl der enthaltenen Zeilen.
+	 * @param flags Flags der zuletzt hinzugefügten Zeile (SerialFrameFlags).
+	 * @param rxUs Empfangszeitpunkt der ersten enthaltenen Zeile in µs.
+	 */
+	typedef void (*FrameSink)(void *ctx, const uint8_t *data, size_t len, uint16_t lines, uint16_t flags, uint64_t rxUs);
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param sink Callback für fertige Nachrichten.
+	 * @param ctx Benutzerkontext.
+	 */
+	SerialCoalescer(FrameSink sink, void *ctx);
+
+	/**
+	 * @brief Setzt Latenzbudget und maximale Nachrichtengröße.
+	 *
+	 * @param latencyMs Maximale Verzögerung einer Zeile (0 = nie bündeln), begrenzt auf MAX_LATENCY_MS.
+	 * @param maxFrameBytes Maximale Nachrichtengröße, begrenzt auf MAX_FRAME.
+	 */
+	void configure(uint32_t latencyMs, size_t maxFrameBytes);
+
+	/**
+	 * @brief Nimmt eine Zeile entgegen und gibt sie sofort oder später aus.
+	 *
+	 * @param line Zeile.
+	 * @param len Länge der Zeile.
+	 * @param flags SerialFrameFlags der Zeile.
+	 * @param now Aktuelle Zeit in ms.
+	 * @param rxUs Empfangszeitpunkt der Zeile in µs.
+	 */
+	void add(const uint8_t *line, size_t len, uint16_t flags, uint32_t now, uint64_t rxUs = 0);
+
+	/**
+	 * @brief Gibt gesammelte Zeilen aus, wenn das Latenzbudget abgelaufen ist.
+	 *
+	 * @param now Aktuelle Zeit in ms.
+	 * @return true, wenn eine Nachricht ausgegeben wurde.
+	 */
+	bool poll(uint32_t now);
+
+	/**
+	 * @brief Gibt gesammelte Zeilen sofort aus.
+	 *
+	 * @param now Aktuelle Zeit in ms.
+	 */
+	void flush(uint32_t now);
+
+	/**
+	 * @brief Millisekunden bis zur nächsten fälligen Ausgabe.
+	 *
+	 * @param now Aktuelle Zeit in ms.
+	 * @return Wartezeit oder UINT32_MAX, wenn nichts gesammelt ist.
+	 */
+	uint32_t msUntilDue(uint32_t now) const;
+
+	/**
+	 * @brief Gibt die Zähler zurück.
+	 */
+	const SerialCoalescerStats &stats() const;
+
+	/**
+	 * @brief Gibt das aktuelle Latenzbudget in ms zurück.
+	 */
+	uint32_t latencyMs() const;
+
+	/**
+	 * @brief Gibt die aktuelle maximale Nachrichtengröße zurück.
+	 */
+	size_t maxFrameBytes() const;
+
+   private:
+	FrameSink _sink;          ///< Callback für fertige Nachrichten
+	void *_ctx;               ///< Benutzerkontext
+	uint32_t _latencyMs;      ///< Latenzbudget
+	size_t _maxFrame;         ///< Maximale Nachrichtengröße
+	uint8_t _buf[MAX_FRAME];  ///< Sammelpuffer
+	size_t _len;              ///< Füllstand des Sammelpuffers
+	uint16_t _lines;          ///< Zeilen im Sammelpuffer
+	uint16_t _flags;          ///< Flags der letzten gesammelten Zeile
+	uint64_t _firstUs;        ///< Empfangszeitpunkt der ersten gesammelten Zeile
+	uint32_t _dueAt;          ///< Spätester Ausgabezeitpunkt der gesammelten Zeilen
+	uint32_t _lastEmit;       ///< Zeitpunkt der letzten Ausgabe
+	bool _emitted;            ///< Wurde schon einmal ausgegeben?
+
+	SerialCoalescerStats _stats;  ///< Zähler
+	uint32_t _windowStart;        ///< Beginn des aktuellen Messfensters
+	uint32_t _windowFrames;       ///< Nachrichten im aktuellen Messfenster
+	uint32_t _windowLines;        ///< Zeilen im aktuellen Messfenster
+
+	void emit(const uint8_t *data, size_t len, uint16_t lines, uint16_t flags, uint32_t now, uint64_t rxUs);
+	void updateRates(uint32_t now);
+};
+
+#endif  // SERIALCOALESCER_H
@@ -0,0 +1,208 @@
+/**
+ * @file SerialFileStream.h
+ * @brief Sendet eine hochgeladene Datei zeilenweise und getaktet an die UART.
+ *
+ * Lange Konfigurations- oder Rezepturdateien werden per HTTP-POST hochgeladen und, ohne sie
+ * vollständig zwischenzuspeichern, an das Gerät weitergegeben:
+ *  - offer() übernimmt Teile des Request-Bodys threadsicher in einen Ringpuffer fester Größe;
+ *    ist er voll, nimmt es weniger an und der HTTP-Handler wartet (der TCP-Empfang stockt
+ *    dann, der Sender bremst),
+ *  - poll() läuft in der TX-Task: entnimmt jeweils eine Zeile (bzw. höchstens PIECE_BYTES),
+ *    wandelt auf Wunsch '\n' in "\r\n" und reicht sie über einen Callback an die
+ *    Sendewarteschlange; danach wird die Zeilenpause abgewartet und ggf. auf den Prompt des
+ *    Geräts,
+ *  - onRx() bekommt aus der Bridge-Task die Empfangsdaten und erkennt den Prompt (KMP, auch
+ *    über Blockgrenzen).
+ *
+ * Der Speicherbedarf ist unabhängig von der Dateigröße (MEMORY_BYTES, von begin() übernommen).
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALFILESTREAM_H
+#define SERIALFILESTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ByteRing.h"
+#include "CriticalSection.h"
+
+/**
+ * @enum SerialFileStreamState
+ * @brief Zustand einer Übertragung.
+ */
+enum SerialFileStreamState : uint8_t {
+	FILE_STREAM_IDLE,     ///< Keine Übertragung
+	FILE_STREAM_RUNNING,  ///< Daten werden angenommen und gesendet
+	FILE_STREAM_DONE,     ///< Alles gesendet, Ergebnis noch nicht abgeholt
+	FILE_STREAM_FAILED    ///< Abgebrochen, Ergebnis noch nicht abgeholt
+};
+
+/**
+ * @enum SerialFileStreamError
+ * @brief Grund für FILE_STREAM_FAILED.
+ */
+enum SerialFileStreamError : uint8_t {
+	FILE_STREAM_OK,              ///< Kein Fehler
+	FILE_STREAM_PROMPT_TIMEOUT,  ///< Prompt kam nicht innerhalb von promptTimeoutMs
+	FILE_STREAM_CANCELLED        ///< Per cancel() abgebrochen (Client, Verbindungsabbruch)
+};
+
+/**
+ * @struct SerialFileStreamConfig
+ * @brief Parameter einer Übertragung.
+ */
+struct SerialFileStreamConfig {
+	static constexpr size_t MAX_PROMPT = 16;  ///< Maximale Länge des Prompts inkl. '\0'
+	uint32_t size;                            ///< Angekündigte Größe in Bytes (0 = unbekannt, nur für den Fortschritt)
+	uint32_t lineDelayMs;                     ///< Pause nach jeder Zeile (0 = keine)
+	char prompt[MAX_PROMPT];                  ///< Nach jeder Zeile auf diesen Text warten ("" = nicht warten)
+	uint32_t promptTimeoutMs;                 ///< Höchstens so lange auf den Prompt warten
+	bool crlf;                                ///< '\n' als "\r\n" senden (ein vorhandenes '\r' bleibt)
+};
+
+/**
+ * @struct SerialFileStreamStats
+ * @brief Zähler einer Übertragung.
+ */
+struct SerialFileStreamStats {
+	uint32_t received;      ///< Angenommene Bytes der Datei
+	uint32_t sent;          ///< An die Sendewarteschlange übergebene Bytes (inkl. eingefügter '\r')
+	uint32_t lines;         ///< Gesendete Zeilen
+	uint32_t prompts;       ///< Erkannte Prompts
+	uint32_t elapsedMs;     ///< Laufzeit von begin() bis zum Ende
+	size_t maxBuffered;     ///< Höchster Füllstand des Ringpuffers
+	uint8_t error;          ///< SerialFileStreamError
+};
+
+/**
+ * @class SerialFileStream
+ * @brief Ringpuffer, Zeilentakt und Prompt-Erkennung einer Dateiübertragung.
+ */
+class SerialFileStream {
+   public:
+	static constexpr size_t BUFFER_BYTES = 4096;                      ///< Ringpuffer zwischen HTTP-Handler und TX-Task
+	static constexpr size_t PIECE_BYTES = 256;                        ///< Größter Block pro Übergabe (ohne Zeilenende)
+	static constexpr size_t MEMORY_BYTES = BUFFER_BYTES + PIECE_BYTES + 1;  ///< Speicherbedarf für begin()
+	static constexpr uint32_t MAX_LINE_DELAY_MS = 10000;              ///< Obergrenze der Zeilenpause
+	static constexpr uint32_t DEFAULT_PROMPT_TIMEOUT_MS = 2000;       ///< Voreinstellung für promptTimeoutMs
+	static constexpr uint32_t MAX_PROMPT_TIMEOUT_MS = 30000;          ///< Obergrenze für promptTimeoutMs
+	static constexpr uint32_t SEND_RETRY_MS = 10;                     ///< Wartezeit bei voller Sendewarteschlange
+
+	/**
+	 * @brief Callback zum Einreihen von Sendedaten.
+	 *
+	 * @return false, wenn die Warteschlange voll ist (es wird später erneut versucht).
+	 */
+	typedef bool (*SendFn)(void *ctx, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param send Sende-Callback.
+	 * @param ctx Benutzerkontext für den Callback.
+	 */
+	SerialFileStream(SendFn send, void *ctx);
+
+	/**
+	 * @brief Prüft die Parameter (Pause, Prompt-Länge, Timeout).
+	 */
+	static bool validate(const SerialFileStreamConfig &config);
+
+	/**
+	 * @brief Beginnt eine Übertragung.
+	 *
+	 * @param config Parameter.
+	 * @param mem Speicher mit MEMORY_BYTES (Besitz bleibt beim Aufrufer, frei erst nach close()).
+	 * @param nowMs Aktuelle Zeit in ms.
+	 * @return false bei ungültigen Parametern oder laufender Übertragung.
+	 */
+	bool begin(const SerialFileStreamConfig &config, uint8_t *mem, uint32_t nowMs);
+
+	/**
+	 * @brief Übernimmt Daten der Datei (threadsicher, blockiert nicht).
+	 *
+	 * @return Anzahl der übernommenen Bytes (0, wenn der Puffer voll ist oder nichts läuft).
+	 */
+	size_t offer(const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Meldet das Ende der Datei; nach dem letzten Byte endet die Übertragung mit FILE_STREAM_DONE.
+	 */
+	void endInput();
+
+	/**
+	 * @brief Bricht die Übertragung ab; Ungesendetes wird verworfen.
+	 */
+	void cancel();
+
+	/**
+	 * @brief Übergibt empfangene Bytes (aus der Bridge-Task, blockiert nicht).
+	 *
+	 * @return true, wenn dabei der erwartete Prompt erkannt wurde und die TX-Task geweckt werden sollte.
+	 */
+	bool onRx(const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Ein Durchlauf der TX-Task: übergibt höchstens einen Block.
+	 *
+	 * @param nowMs Aktuelle Zeit in ms.
+	 * @return 0, wenn ein Block übergeben wurde (nach dem Senden erneut aufrufen), sonst die
+	 *         empfohlene Wartezeit in ms (UINT32_MAX = bis neue Daten kommen).
+	 */
+	uint32_t poll(uint32_t nowMs);
+
+	/**
+	 * @brief Schließt eine beendete Übertragung ab; danach darf der Speicher freigegeben werden.
+	 *
+	 * @param nowMs Aktuelle Zeit in ms.
+	 * @return Endstand der Zähler.
+	 */
+	SerialFileStreamStats close(uint32_t nowMs);
+
+	SerialFileStreamState state() const;            ///< Aktueller Zustand
+	const SerialFileStreamConfig &config() const;  ///< Parameter der laufenden Übertragung
+
+	/**
+	 * @brief Kopie der Zähler (threadsicher).
+	 */
+	SerialFileStreamStats stats() const;
+
+	/**
+	 * @brief Beschreibung eines Fehlers für Log und Clients.
+	 */
+	static const char *errorText(uint8_t error);
+
+   private:
+	SendFn _send;                     ///< Sende-Callback
+	void *_ctx;                       ///< Benutzerkontext
+	SerialFileStreamConfig _config;   ///< Parameter der laufenden Übertragung
+	volatile uint8_t _state;          ///< SerialFileStreamState
+	ByteRing _ring;                   ///< Angenommene, noch nicht übergebene Bytes
+	bool _inputDone;                  ///< Ende der Datei gemeldet
+	bool _cancel;                     ///< Abbruch angefordert
+	bool _armed;                      ///< Prompt wird erwartet
+	bool _promptSeen;                 ///< Prompt seit dem Scharfschalten erkannt
+	size_t _matchPos;                 ///< Bereits passende Zeichen des Prompts
+	uint8_t _fail[SerialFileStreamConfig::MAX_PROMPT];  ///< KMP-Tabelle des Prompts
+	size_t _promptLen;                ///< Länge des Prompts
+	uint32_t _startMs;                ///< Beginn der Übertragung
+	SerialFileStreamStats _stats;     ///< Zähler
+	mutable CriticalSection _lock;    ///< Schutz von Puffer, Zustand, Prompt und Zählern
+
+	// Nur TX-Task
+	uint8_t *_piece;      ///< Arbeitspuffer für den nächsten Block
+	size_t _pieceLen;     ///< Länge des noch nicht übergebenen Blocks (0 = keiner)
+	bool _pieceEol;       ///< Block endet mit einem Zeilenende
+	bool _lineSent;       ///< Zeile wurde übergeben, Pause/Prompt beginnt beim nächsten poll()
+	bool _pacing;         ///< Zeilenpause bzw. Prompt-Wartezeit läuft
+	uint32_t _waitFrom;   ///< Beginn von Zeilenpause und Prompt-Wartezeit
+	uint8_t _last;        ///< Letztes übergebenes Byte der Datei (für die CR-Einfügung)
+
+	void fail(uint8_t error, uint32_t nowMs);
+	size_t takePiece();
+};
+
+#endif  // SERIALFILESTREAM_H
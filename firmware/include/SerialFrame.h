@@ -0,0 +1,80 @@
+/**
+ * @file SerialFrame.h
+ * @brief Binäres WebSocket-Frameformat für serielle Daten.
+ *
+ * Clients, die den Binärkanal aktiviert haben (`serial`/`binary`/`enable`), erhalten serielle
+ * Daten nicht mehr als JSON-Dokument, sondern als binäres WebSocket-Frame:
+ *
+ * | Offset | Größe | Feld      | Beschreibung                                   |
+ * | ------ | ----- | --------- | ---------------------------------------------- |
+ * | 0      | 1     | version   | Formatversion (SERIAL_FRAME_VERSION)           |
+ * | 1      | 1     | channel   | Kanal-ID der seriellen Schnittstelle           |
+ * | 2      | 2     | flags     | SerialFrameFlags, Little Endian                |
+ * | 4      | 4     | seq       | Laufende Nummer pro Kanal, Little Endian       |
+ * | 8      | 8     | timestamp | Empfangszeit in µs seit Systemstart, Little Endian |
+ * | 16     | n     | payload   | Rohdaten, unverändert (auch NUL, kein UTF-8)   |
+ *
+ * `seq` zählt jedes gesendete Frame eines Kanals lückenlos hoch; fehlende Nummern bedeuten
+ * verworfene Nachrichten. `timestamp` ist der Zeitpunkt (`esp_timer`), zu dem das erste Byte
+ * der ersten enthaltenen Zeile aus der UART gelesen wurde. Frames mit
+ * SERIAL_FRAME_FLAG_FILTERED enthalten genau eine Zeile; ihr `seq` zählt die dem Client
+ * zugestellten Zeilen und ist unabhängig von den ungefilterten Blöcken. Frames mit
+ * SERIAL_FRAME_FLAG_RAW gehen während des Durchreichens nur an dessen Besitzer, enthalten
+ * beliebig geschnittene Rohdaten und zählen `seq` je Übertragung ab 0. Version 1 (bis 1.1.0)
+ * hatte einen 12-Byte-Header mit Millisekunden-Zeitstempel.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALFRAME_H
+#define SERIALFRAME_H
+
+#include <cstddef>
+#include <cstdint>
+
+/// Version des Binärformats
+constexpr uint8_t SERIAL_FRAME_VERSION = 2;
+
+/// Länge des Frame-Headers in Bytes
+constexpr size_t SERIAL_FRAME_HEADER_LEN = 16;
+
+/**
+ * @enum SerialFrameFlags
+ * @brief Bitflags im Frame-Header.
+ */
+enum SerialFrameFlags : uint16_t {
+	SERIAL_FRAME_FLAG_NONE = 0x0000,      ///< Keine Besonderheiten
+	SERIAL_FRAME_FLAG_PARTIAL = 0x0001,   ///< Zeile ohne Zeilenende (Flush nach Timeout)
+	SERIAL_FRAME_FLAG_REPLAY = 0x0002,    ///< Nachgeladener Block aus dem Verlaufspuffer
+	SERIAL_FRAME_FLAG_FILTERED = 0x0004,  ///< Einzelne Zeile nach dem Zeilenfilter des Clients
+	SERIAL_FRAME_FLAG_RAW = 0x0008,       ///< Ungeframte Empfangsdaten während des Durchreichens
+};
+
+/**
+ * @struct SerialFrameHeader
+ * @brief Dekodierter Frame-Header.
+ */
+struct SerialFrameHeader {
+	uint8_t version;     ///< Formatversion
+	uint8_t channel;     ///< Kanal-ID
+	uint16_t flags;      ///< SerialFrameFlags
+	uint32_t seq;        ///< Laufende Nummer
+	uint64_t timestamp;  ///< Empfangszeit in µs
+};
+
+/**
+ * @brief Schreibt den Header in `out` (mindestens SERIAL_FRAME_HEADER_LEN Bytes).
+ *
+ * @return Anzahl der geschriebenen Bytes (SERIAL_FRAME_HEADER_LEN).
+ */
+size_t encodeSerialFrameHeader(const SerialFrameHeader &hdr, uint8_t *out);
+
+/**
+ * @brief Liest einen Header aus `in`.
+ *
+ * @return false, wenn `len` zu kurz ist oder die Version nicht unterstützt wird.
+ */
+bool decodeSerialFrameHeader(const uint8_t *in, size_t len, SerialFrameHeader &hdr);
+
+#endif  // SERIALFRAME_H
@@ -0,0 +1,218 @@
+/**
+ * @file SerialFramer.h
+ * @brief Zerlegt den seriellen Empfangsstrom in Datensätze (Zeilen oder Binär-Telegramme).
+ *
+ * Der Framer bekommt empfangene Bytes blockweise übergeben und reicht fertige Datensätze als
+ * Zeiger in den Eingabeblock an einen Callback weiter. Nur ein über Blockgrenzen hinweg
+ * angefangener Datensatz wird in den internen Puffer kopiert; pro Byte wird nichts allokiert.
+ *
+ * Unterstützte Verfahren (SerialFramingMode):
+ *  - Zeilen mit einer Menge von Trennzeichen (Standard `\r`/`\n`, CR+LF zählt als ein Zeilenende),
+ *  - Datensätze mit einer mehrbytigen Endekennung (z. B. `"\r\n>"`),
+ *  - Datensätze fester Länge,
+ *  - Datensätze mit 1- oder 2-Byte-Längenpräfix,
+ *  - STX/ETX-Telegramme,
+ *  - Datensätze, die durch eine Sendepause begrenzt sind.
+ *
+ * Die Trennzeichen werden wortweise gesucht (SWAR). Jeder Datensatz endet spätestens nach
+ * `maxRecord` Bytes. Häufige Einstellungen sind als benannte Geräteprofile hinterlegt.
+ *
+ * Jeder Block trägt den Empfangszeitpunkt in µs; ein Datensatz erhält den Zeitpunkt des Blocks,
+ * in dem sein erstes Byte ankam.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALFRAMER_H
+#define SERIALFRAMER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum SerialFramingMode
+ * @brief Verfahren, nach dem der Empfangsstrom in Datensätze zerlegt wird.
+ */
+enum SerialFramingMode {
+	SERIAL_FRAMING_LINE,        ///< Ende an einem Zeichen aus `delimiters`
+	SERIAL_FRAMING_TERMINATOR,  ///< Ende an der Bytefolge `terminator`
+	SERIAL_FRAMING_FIXED,       ///< Je `fixedLen` Bytes ein Datensatz
+	SERIAL_FRAMING_LENGTH,      ///< Längenpräfix mit `lengthBytes` Bytes
+	SERIAL_FRAMING_STX_ETX,     ///< Von `stx` bis einschließlich `etx`
+	SERIAL_FRAMING_IDLE         ///< Ende nach `timeoutMs` ohne neue Bytes
+};
+
+/**
+ * @struct SerialFramerConfig
+ * @brief Einstellungen des Framers. Nicht benötigte Felder des gewählten Verfahrens werden ignoriert.
+ */
+struct SerialFramerConfig {
+	SerialFramingMode mode;         ///< Verfahren
+	uint8_t delimiters[4];          ///< LINE: Trennzeichen
+	uint8_t delimiterCount;         ///< LINE: Anzahl der Trennzeichen (1..4)
+	bool joinCrLf;                  ///< LINE: CR direkt gefolgt von LF gilt als ein Zeilenende
+	uint8_t terminator[8];          ///< TERMINATOR: Endekennung
+	uint8_t terminatorLen;          ///< TERMINATOR: Länge der Endekennung (1..8)
+	uint16_t fixedLen;              ///< FIXED: Länge eines Datensatzes
+	uint8_t lengthBytes;            ///< LENGTH: Größe des Präfixes (1 oder 2)
+	bool lengthBigEndian;           ///< LENGTH: 2-Byte-Präfix als Big Endian
+	bool lengthIncludesHeader;      ///< LENGTH: Längenangabe enthält das Präfix selbst
+	uint8_t stx;                    ///< STX_ETX: Startzeichen
+	uint8_t etx;                    ///< STX_ETX: Endezeichen
+	uint32_t timeoutMs;             ///< Pause, nach der ein angefangener Datensatz ausgegeben wird (0 = nie)
+	uint16_t maxRecord;             ///< Maximale Länge eines Datensatzes (1..MAX_RECORD)
+};
+
+/**
+ * @struct SerialFramerStats
+ * @brief Zähler des Framers.
+ */
+struct SerialFramerStats {
+	uint32_t records;    ///< Ausgegebene Datensätze
+	uint32_t split;      ///< An der Maximallänge getrennte Datensätze
+	uint32_t partial;    ///< Nach Timeout unvollständig ausgegebene Datensätze
+	uint32_t discarded;  ///< Verworfene Bytes (außerhalb von STX/ETX, ungültige Länge)
+};
+
+/**
+ * @class SerialFramer
+ * @brief Konfigurierbarer Framer ohne Kopie pro Byte.
+ */
+class SerialFramer {
+   public:
+	static constexpr size_t MAX_RECORD = 1024;         ///< Kapazität des Datensatzpuffers
+	static constexpr uint16_t DEFAULT_MAX_RECORD = 255;  ///< Standardlänge (wie der bisherige 256-Byte-Batch-Puffer)
+	static constexpr uint32_t DEFAULT_TIMEOUT_MS = 20;   ///< Standard-Timeout für angefangene Zeilen
+
+	/**
+	 * @brief Callback für einen fertigen Datensatz.
+	 *
+	 * @param ctx Benutzerkontext.
+	 * @param record Zeiger auf den Datensatz (nur während des Aufrufs gültig, nicht nullterminiert).
+	 * @param len Länge des Datensatzes in Bytes.
+	 * @param complete true, wenn der Datensatz regulär oder an der Maximallänge abgeschlossen wurde,
+	 *                 false bei einem Flush nach Timeout.
+	 * @param rxUs Empfangszeitpunkt des ersten Bytes in µs (wie an feed() übergeben).
+	 */
+	typedef void (*LineSink)(void *ctx, const uint8_t *record, size_t len, bool complete, uint64_t rxUs);
+
+	/**
+	 * @brief Konstruktor; startet mit defaultConfig().
+	 *
+	 * @param sink Callback für fertige Datensätze.
+	 * @param ctx Benutzerkontext für den Callback.
+	 */
+	SerialFramer(LineSink sink, void *ctx);
+
+	/**
+	 * @brief Standard: Zeilen an `\r`/`\n`, CR+LF als ein Zeilenende, 255 Bytes, 20 ms Timeout.
+	 */
+	static SerialFramerConfig defaultConfig();
+
+	/**
+	 * @brief Liefert ein benanntes Geräteprofil.
+	 *
+	 * @param name Profilname (`text`, `text-raw`, `crlf`, `stx-etx`, `length8`, `length16`, `idle`).
+	 * @param out Ausgabeparameter.
+	 * @return false bei unbekanntem Namen.
+	 */
+	static bool profile(const char *name, SerialFramerConfig &out);
+
+	/**
+	 * @brief Prüft eine Konfiguration auf Plausibilität.
+	 */
+	static bool validate(const SerialFramerConfig &config);
+
+	/**
+	 * @brief Übernimmt eine neue Konfiguration; ein angefangener Datensatz wird vorher ausgegeben.
+	 *
+	 * @return false, wenn die Konfiguration ungültig ist (die alte bleibt dann aktiv).
+	 */
+	bool configure(const SerialFramerConfig &config);
+
+	/**
+	 * @brief Gibt die aktive Konfiguration zurück.
+	 */
+	const SerialFramerConfig &config() const;
+
+	/**
+	 * @brief true, wenn die Datensätze Text sind (LINE, TERMINATOR).
+	 */
+	bool isText() const;
+
+	/**
+	 * @brief Übergibt einen Block empfangener Bytes.
+	 *
+	 * @param data Empfangene Bytes.
+	 * @param len Anzahl der Bytes.
+	 * @param rxUs Empfangszeitpunkt des Blocks in µs.
+	 */
+	void feed(const uint8_t *data, size_t len, uint64_t rxUs = 0);
+
+	/**
+	 * @brief Gibt einen angefangenen Datensatz aus (nach `timeoutMs` ohne neue Bytes).
+	 *
+	 * Im Modus IDLE ist das das reguläre Ende eines Datensatzes, sonst ist er unvollständig.
+	 *
+	 * @return true, wenn ein Datensatz ausgegeben wurde.
+	 */
+	bool flush();
+
+	/**
+	 * @brief Anzahl der Bytes eines angefangenen, noch nicht ausgegebenen Datensatzes.
+	 */
+	size_t pending() const;
+
+	/**
+	 * @brief Gibt die Zähler zurück.
+	 */
+	const SerialFramerStats &stats() const;
+
+	/**
+	 * @brief Sucht das erste `\r` oder `\n` im Bereich [begin, end).
+	 *
+	 * @return Zeiger auf das Zeilenende oder `end`, wenn keines gefunden wurde.
+	 */
+	static const uint8_t *findLineEnd(const uint8_t *begin, const uint8_t *end);
+
+	/**
+	 * @brief Sucht das erste Byte aus `set` im Bereich [begin, end).
+	 *
+	 * Verarbeitet ein Maschinenwort pro Schritt (SWAR) und fällt nur für den Rest auf
+	 * byteweisen Vergleich zurück.
+	 *
+	 * @param set Gesuchte Bytes.
+	 * @param count Anzahl der gesuchten Bytes (1..4).
+	 * @return Zeiger auf den Treffer oder `end`.
+	 */
+	static const uint8_t *findAny(const uint8_t *begin, const uint8_t *end, const uint8_t *set, size_t count);
+
+   private:
+	LineSink _sink;               ///< Callback für fertige Datensätze
+	void *_ctx;                   ///< Benutzerkontext
+	SerialFramerConfig _cfg;      ///< Aktive Konfiguration
+	SerialFramerStats _stats;     ///< Zähler
+	uint8_t _carry[MAX_RECORD];   ///< Über Blockgrenzen angefangener Datensatz
+	size_t _carryLen;             ///< Füllstand von _carry
+	size_t _need;                 ///< LENGTH: Gesamtlänge des laufenden Datensatzes (0 = Präfix unvollständig)
+	bool _inFrame;                ///< STX_ETX: innerhalb eines Telegramms
+	bool _pendingCr;              ///< LINE: _carry endet mit CR, ein folgendes LF gehört noch dazu
+	uint64_t _feedUs;             ///< Empfangszeitpunkt des aktuellen Blocks
+	uint64_t _carryUs;            ///< Empfangszeitpunkt des ersten Bytes in _carry
+
+	void emit(const uint8_t *record, size_t len, bool complete);
+	void append(const uint8_t *data, size_t len);
+	void emitCarry(bool complete);
+	void finish(const uint8_t *p, size_t n);
+	void reset();
+
+	const uint8_t *feedLine(const uint8_t *p, const uint8_t *end);
+	const uint8_t *feedTerminator(const uint8_t *p, const uint8_t *end);
+	const uint8_t *feedCounted(const uint8_t *p, const uint8_t *end);
+	const uint8_t *feedStxEtx(const uint8_t *p, const uint8_t *end);
+	const uint8_t *feedIdle(const uint8_t *p, const uint8_t *end);
+	size_t recordLength(const uint8_t *header) const;
+};
+
+#endif  // SERIALFRAMER_H
@@ -0,0 +1,130 @@
+/**
+ * @file SerialLineFilter.h
+ * @brief Serverseitige Zeilenfilter pro WebSocket-Client.
+ *
+ * Jeder Client kann Regeln festlegen, welche Zeilen er bekommen möchte:
+ *  - Art: Präfix (Zeilenanfang), Teilstring oder Ausdruck (SerialPattern),
+ *  - Richtung: einschließen oder ausschließen; ohne einschließende Regel gilt jede Zeile als
+ *    eingeschlossen, eine passende ausschließende Regel gewinnt immer,
+ *  - optional ohne Groß-/Kleinschreibung (nur Präfix und Teilstring).
+ *
+ * Präfixe und Teilstrings aller Clients landen in einem gemeinsamen SerialMultiMatch; eine
+ * Zeile wird also in einem Durchlauf gegen alle geprüft, unabhängig von der Anzahl der
+ * Clients. Ausdrücke werden über alle Clients dedupliziert und nur ausgewertet, wenn das
+ * Ergebnis noch für einen Client zählt.
+ *
+ * Ein SerialLineFilter wird einmal aus allen Regelsätzen gebaut und ist danach unveränderlich;
+ * die SerialBridge baut bei jeder Änderung einen neuen und tauscht ihn in der Bridge-Task aus.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALLINEFILTER_H
+#define SERIALLINEFILTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SerialMultiMatch.h"
+#include "SerialPattern.h"
+
+/**
+ * @enum SerialFilterKind
+ * @brief Art einer Filterregel.
+ */
+enum SerialFilterKind {
+	FILTER_PREFIX,    ///< Zeile beginnt mit dem Text
+	FILTER_CONTAINS,  ///< Zeile enthält den Text
+	FILTER_REGEX      ///< Ausdruck findet einen Treffer
+};
+
+/**
+ * @struct SerialFilterRule
+ * @brief Eine Filterregel.
+ */
+struct SerialFilterRule {
+	static constexpr size_t MAX_TEXT = 64;  ///< Maximale Länge des Textes inkl. '\0'
+	uint8_t kind;                           ///< SerialFilterKind
+	bool exclude;                           ///< Ausschließende Regel
+	bool ignoreCase;                        ///< Groß-/Kleinschreibung ignorieren (nicht bei FILTER_REGEX)
+	char text[MAX_TEXT];                    ///< Text bzw. Ausdruck
+};
+
+/**
+ * @struct SerialFilterSpec
+ * @brief Regelsatz eines Clients (count = 0: kein Filter, alle Zeilen).
+ */
+struct SerialFilterSpec {
+	static constexpr size_t MAX_RULES = 8;  ///< Maximale Anzahl Regeln pro Client
+	SerialFilterRule rules[MAX_RULES];      ///< Regeln
+	size_t count;                           ///< Anzahl der Regeln
+};
+
+/**
+ * @class SerialLineFilter
+ * @brief Übersetzte Regelsätze aller Clients; evaluate() liefert die Empfänger einer Zeile.
+ */
+class SerialLineFilter {
+   public:
+	static constexpr size_t MAX_SLOTS = 8;  ///< Regelsätze (entspricht den Client-Slots der Bridge)
+	static constexpr size_t MAX_REGEX = 4;  ///< Verschiedene Ausdrücke über alle Clients
+
+	SerialLineFilter();
+
+	/**
+	 * @brief Übersetzt alle Regelsätze.
+	 *
+	 * @param specs Regelsatz je Slot.
+	 * @param slots Anzahl der Slots (höchstens MAX_SLOTS).
+	 * @param error Puffer für die Fehlerbeschreibung.
+	 * @param size Größe des Puffers.
+	 * @return false bei ungültiger Regel oder erschöpften Mustern/Ausdrücken.
+	 */
+	bool build(const SerialFilterSpec *specs, size_t slots, char *error, size_t size);
+
+	/**
+	 * @brief Slots mit Regelsatz (Bitmaske); alle anderen bekommen jede Zeile.
+	 */
+	uint32_t filtered() const;
+
+	/**
+	 * @brief Bewertet eine Zeile für alle Slots mit Regelsatz.
+	 *
+	 * @param line Zeile.
+	 * @param len Länge der Zeile.
+	 * @return Bitmaske der Slots, die die Zeile bekommen.
+	 */
+	uint32_t evaluate(const uint8_t *line, size_t len) const;
+
+	/**
+	 * @brief Anzahl der gemeinsamen Teilstringmuster.
+	 */
+	size_t patterns() const;
+
+	/**
+	 * @brief Anzahl der Ausdrücke.
+	 */
+	size_t regexes() const;
+
+   private:
+	/**
+	 * @brief Übersetzter Regelsatz eines Slots.
+	 */
+	struct Slot {
+		uint64_t include;      ///< Einschließende Muster
+		uint64_t exclude;      ///< Ausschließende Muster
+		uint8_t regexInclude;  ///< Einschließende Ausdrücke (Bitmaske)
+		uint8_t regexExclude;  ///< Ausschließende Ausdrücke (Bitmaske)
+		bool hasInclude;       ///< Mindestens eine einschließende Regel
+	};
+
+	SerialMultiMatch _match;                 ///< Präfixe und Teilstrings aller Slots
+	SerialPattern _regex[MAX_REGEX];         ///< Ausdrücke aller Slots (dedupliziert)
+	char _regexText[MAX_REGEX][SerialFilterRule::MAX_TEXT];  ///< Quelltext zur Deduplizierung
+	size_t _regexCount;                      ///< Belegte Ausdrücke
+	Slot _slots[MAX_SLOTS];                  ///< Regelsätze
+	uint32_t _filtered;                      ///< Slots mit Regelsatz
+};
+
+#endif  // SERIALLINEFILTER_H
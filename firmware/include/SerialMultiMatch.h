@@ -0,0 +1,117 @@
+/**
+ * @file SerialMultiMatch.h
+ * @brief Suche nach vielen Teilstrings in einem Durchlauf (Aho-Corasick).
+ *
+ * Alle Muster werden in einen gemeinsamen Präfixbaum mit Fehlerverweisen übersetzt; scan()
+ * läuft einmal über die Zeile und liefert die Menge der gefundenen Muster als Bitmaske. Die
+ * Kosten hängen damit von der Zeilenlänge ab, kaum von der Anzahl der Muster.
+ *
+ * Ein Muster kann auf den Zeilenanfang verankert sein (Präfix). Gleiche Muster werden nur
+ * einmal angelegt; add() liefert dann die bestehende Nummer. Der Speicher ist fest
+ * (MAX_NODES Knoten, Kanten als Liste pro Knoten, Tabelle über alle Zeichen nur für die
+ * Wurzel), es wird nichts allokiert.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALMULTIMATCH_H
+#define SERIALMULTIMATCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class SerialMultiMatch
+ * @brief Aho-Corasick-Automat über Bytefolgen mit bis zu MAX_PATTERNS Mustern.
+ */
+class SerialMultiMatch {
+   public:
+	static constexpr size_t MAX_PATTERNS = 64;     ///< Muster (Bits der Ergebnismaske)
+	static constexpr size_t MAX_NODES = 512;       ///< Knoten des Präfixbaums einschließlich Wurzel
+	static constexpr size_t MAX_PATTERN_LEN = 64;  ///< Maximale Länge eines Musters
+	static constexpr int NO_PATTERN = -1;          ///< Rückgabe von add() bei Fehler
+
+	SerialMultiMatch();
+
+	/**
+	 * @brief Entfernt alle Muster.
+	 */
+	void clear();
+
+	/**
+	 * @brief Fügt ein Muster hinzu (vor build()).
+	 *
+	 * @param text Muster (nicht nullterminiert).
+	 * @param len Länge (1..MAX_PATTERN_LEN).
+	 * @param prefix true = nur am Zeilenanfang.
+	 * @param ignoreCase true = Groß-/Kleinschreibung ignorieren (nur ASCII).
+	 * @return Musternummer (0..MAX_PATTERNS-1) oder NO_PATTERN, wenn es leer/zu lang ist oder
+	 *         Muster bzw. Knoten ausgehen.
+	 */
+	int add(const uint8_t *text, size_t len, bool prefix, bool ignoreCase = false);
+
+	/**
+	 * @brief Berechnet Fehlerverweise und Ausgabemengen; danach ist scan() nutzbar.
+	 */
+	void build();
+
+	/**
+	 * @brief Durchsucht Daten nach allen Mustern.
+	 *
+	 * @param data Daten.
+	 * @param len Länge der Daten.
+	 * @param stopMask Sobald alle diese Muster gefunden sind, endet die Suche (0 = nie vorzeitig).
+	 * @return Bitmaske der gefundenen Muster.
+	 */
+	uint64_t scan(const uint8_t *data, size_t len, uint64_t stopMask = 0) const;
+
+	/**
+	 * @brief Anzahl der Muster.
+	 */
+	size_t patterns() const;
+
+	/**
+	 * @brief Anzahl der belegten Knoten.
+	 */
+	size_t nodes() const;
+
+   private:
+	/**
+	 * @brief Knoten des Präfixbaums.
+	 */
+	struct Node {
+		uint64_t out;    ///< Muster, die hier enden (nach build() inkl. Fehlerkette)
+		uint16_t first;  ///< Erste Kante (NONE = keine)
+		uint16_t fail;   ///< Fehlerverweis
+		uint8_t depth;   ///< Abstand zur Wurzel
+	};
+
+	/**
+	 * @brief Kante zu einem Kindknoten.
+	 */
+	struct Edge {
+		uint16_t next;    ///< Nächste Kante desselben Knotens
+		uint16_t target;  ///< Kindknoten
+		uint8_t ch;       ///< Zeichen
+	};
+
+	static constexpr uint16_t NONE = 0xFFFF;  ///< Keine Kante
+
+	Node _nodes[MAX_NODES];               ///< Knoten (0 = Wurzel)
+	Edge _edges[MAX_NODES];               ///< Kanten (Kante n-1 führt zu Knoten n)
+	size_t _nodeCount;                    ///< Belegte Knoten
+	size_t _patternCount;                 ///< Belegte Muster
+	uint16_t _root[256];                  ///< Übergänge der Wurzel je Zeichen (nach build())
+	uint16_t _patternNode[MAX_PATTERNS];  ///< Endknoten je Muster
+	uint64_t _prefixMask;                 ///< Auf den Zeilenanfang verankerte Muster
+	uint64_t _foldMask;                   ///< Muster ohne Groß-/Kleinschreibung
+	bool _fold;                           ///< Es gibt Muster ohne Groß-/Kleinschreibung
+	size_t _maxPrefix;                    ///< Länge des längsten Präfixmusters
+
+	uint16_t child(uint16_t node, uint8_t ch) const;
+	uint16_t step(uint16_t state, uint8_t ch) const;
+	uint64_t walk(const uint8_t *data, size_t len, bool fold, uint64_t stopMask) const;
+};
+
+#endif  // SERIALMULTIMATCH_H
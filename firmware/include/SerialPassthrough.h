@@ -0,0 +1,301 @@
+/**
+ * @file SerialPassthrough.h
+ * @brief Transparentes Durchreichen binärer Daten zur UART, z. B. zum Flashen angeschlossener Controller.
+ *
+ * Während einer Übertragung gehört die UART einem WebSocket-Client: Er schickt die Daten als
+ * binäre WebSocket-Nachrichten mit kurzem Kopf (siehe unten), die Bridge schreibt sie ohne
+ * Framing, Pacing oder Zeilenlogik auf die Leitung und gibt alle empfangenen Bytes ungeframt an
+ * ihn zurück. Die Rate darf dabei über `baudRates[]` hinausgehen (bis MAX_BAUD).
+ *
+ * Gegendruck: Angenommene Daten landen in einem Zwischenpuffer (BUFFER_BYTES), aus dem die
+ * TX-Task blockweise auf die UART schreibt. Der Client darf nur bis `limit()` senden
+ * (= geschriebene Bytes + Puffergröße); die Bridge meldet den Fortschritt mit
+ * `serial`/`passthrough`/`ack`. Was über das Limit hinausgeht, wird abgelehnt statt gepuffert,
+ * der Speicherbedarf bleibt also fest.
+ *
+ * Kopf einer Upload-Nachricht (Client → ESP32):
+ *
+ * | Offset | Größe | Feld    | Beschreibung                                     |
+ * | ------ | ----- | ------- | ------------------------------------------------ |
+ * | 0      | 1     | version | SERIAL_UPLOAD_VERSION                            |
+ * | 1      | 1     | channel | Kanal-ID                                         |
+ * | 2      | 2     | flags   | Reserviert (0), Little Endian                    |
+ * | 4      | 4     | offset  | Position der Nutzdaten in der Übertragung, LE    |
+ * | 8      | n     | payload | Rohdaten                                         |
+ *
+ * Über den Offset erkennt die Bridge doppelt gesendete (ignoriert) und fehlende Blöcke (abgelehnt).
+ *
+ * Vor und nach der Übertragung kann der Controller über zwei GPIOs wie mit DTR/RTS eines
+ * USB-Adapters in den Bootloader bzw. neu gestartet werden (UartPort::setBootLines).
+ *
+ * `begin()`, `offer()`, `requestStop()` und die Abfragen sind threadsicher; `enter()`,
+ * `drain()`, `finish()`, `close()` und `resetTarget()` laufen in der TX-Task. Als Zeitbasis
+ * dient UartPort::now().
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALPASSTHROUGH_H
+#define SERIALPASSTHROUGH_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ByteRing.h"
+#include "TaskMutex.h"
+#include "UartPort.h"
+
+/// Version des Upload-Kopfs
+constexpr uint8_t SERIAL_UPLOAD_VERSION = 1;
+
+/// Länge des Upload-Kopfs in Bytes
+constexpr size_t SERIAL_UPLOAD_HEADER_LEN = 8;
+
+/**
+ * @struct SerialUploadHeader
+ * @brief Dekodierter Kopf einer Upload-Nachricht.
+ */
+struct SerialUploadHeader {
+	uint8_t version;  ///< Formatversion
+	uint8_t channel;  ///< Kanal-ID
+	uint16_t flags;   ///< Reserviert
+	uint32_t offset;  ///< Position der Nutzdaten in der Übertragung
+};
+
+/**
+ * @brief Schreibt den Kopf in `out` (mindestens SERIAL_UPLOAD_HEADER_LEN Bytes).
+ *
+ * @return Anzahl der geschriebenen Bytes (SERIAL_UPLOAD_HEADER_LEN).
+ */
+size_t encodeSerialUploadHeader(const SerialUploadHeader &hdr, uint8_t *out);
+
+/**
+ * @brief Liest einen Kopf aus `in`.
+ *
+ * @return false, wenn `len` zu kurz ist oder die Version nicht unterstützt wird.
+ */
+bool decodeSerialUploadHeader(const uint8_t *in, size_t len, SerialUploadHeader &hdr);
+
+/**
+ * @enum SerialBootMode
+ * @brief Ansteuerung der Boot-Leitungen vor bzw. nach einer Übertragung.
+ */
+enum SerialBootMode : uint8_t {
+	BOOT_MODE_NONE,        ///< Leitungen nicht anfassen
+	BOOT_MODE_BOOTLOADER,  ///< Reset mit aktivem Boot-Pin: Controller startet den Bootloader
+	BOOT_MODE_RUN          ///< Reset ohne Boot-Pin: Controller startet die Anwendung
+};
+
+/**
+ * @enum SerialPassthroughState
+ * @brief Zustand des Durchreichmodus.
+ */
+enum SerialPassthroughState : uint8_t {
+	PASSTHROUGH_IDLE,      ///< Kein Durchreichen, UART im Normalbetrieb
+	PASSTHROUGH_STARTING,  ///< Angefordert, TX-Task stellt Rate und Boot-Leitungen ein
+	PASSTHROUGH_ACTIVE,    ///< Daten werden durchgereicht
+	PASSTHROUGH_STOPPING   ///< Ende angefordert, Rest wird noch geschrieben (oder verworfen)
+};
+
+/**
+ * @enum SerialUploadResult
+ * @brief Ergebnis von SerialPassthrough::offer().
+ */
+enum SerialUploadResult : uint8_t {
+	UPLOAD_OK,         ///< Angenommen
+	UPLOAD_DUPLICATE,  ///< Bereits angenommen, ignoriert
+	UPLOAD_GAP,        ///< Offset hinter dem erwarteten: Block davor fehlt
+	UPLOAD_OVERFLOW,   ///< Über das Limit hinaus gesendet
+	UPLOAD_TOO_LONG,   ///< Über die angekündigte Größe hinaus
+	UPLOAD_INACTIVE    ///< Kein Durchreichen aktiv (oder Ende angefordert)
+};
+
+/**
+ * @struct SerialPassthroughConfig
+ * @brief Parameter einer Übertragung.
+ */
+struct SerialPassthroughConfig {
+	uint32_t baud;     ///< Baudrate während der Übertragung
+	uint32_t size;     ///< Angekündigte Größe in Bytes (0 = offen, Ende mit requestStop())
+	uint8_t enter;     ///< SerialBootMode vor der Übertragung
+	uint8_t leave;     ///< SerialBootMode danach
+	bool restoreBaud;  ///< Danach wieder die vorherige Rate einstellen
+	uint32_t idleMs;   ///< Abbruch, wenn so lange keine Daten kamen (0 = nie)
+};
+
+/**
+ * @struct SerialPassthroughStats
+ * @brief Zähler und Durchsatz einer Übertragung.
+ */
+struct SerialPassthroughStats {
+	uint32_t owner;        ///< Client-ID des Besitzers
+	uint32_t baud;         ///< Rate während der Übertragung
+	uint32_t received;     ///< Angenommene Bytes
+	uint32_t written;      ///< Auf die UART geschriebene Bytes
+	uint32_t rxBytes;      ///< Vom Controller empfangene Bytes
+	uint32_t chunks;       ///< Angenommene Upload-Nachrichten
+	uint32_t rejected;     ///< Abgelehnte Upload-Nachrichten (Lücke, Limit, Größe)
+	uint32_t elapsedMs;    ///< Dauer ab Bereitschaft bis zum Sendeende
+	uint32_t bytesPerSec;  ///< Effektiver Durchsatz (geschriebene Bytes pro Sekunde)
+	uint8_t linePercent;   ///< Durchsatz in Prozent der Leitungsrate (8N1)
+	size_t maxBuffered;    ///< Höchster Füllstand des Zwischenpuffers
+};
+
+/**
+ * @class SerialPassthrough
+ * @brief Zwischenpuffer mit Gegendruck, Boot-Sequenzen und Durchsatzmessung für eine UART.
+ */
+class SerialPassthrough {
+   public:
+	static constexpr size_t BUFFER_BYTES = 16384;     ///< Zwischenpuffer zur UART (Fenster des Clients)
+	static constexpr size_t WRITE_CHUNK = 4096;       ///< Größter Block pro Schreibvorgang
+	static constexpr size_t MEMORY_BYTES = BUFFER_BYTES + WRITE_CHUNK;  ///< Speicherbedarf für begin()
+	static constexpr uint32_t MIN_BAUD = 1200;        ///< Kleinste Rate
+	static constexpr uint32_t MAX_BAUD = 3000000;     ///< Größte Rate
+	static constexpr uint32_t CHUNK_MS = 50;          ///< Ziel-Sendedauer eines Blocks
+	static constexpr uint32_t RESET_PULSE_MS = 100;   ///< Dauer des Reset-Impulses
+	static constexpr uint32_t BOOT_HOLD_MS = 50;      ///< Boot-Pin nach dem Reset noch halten
+	static constexpr uint32_t DEFAULT_IDLE_MS = 30000;  ///< Voreinstellung für idleMs
+	static constexpr uint32_t MAX_IDLE_MS = 600000;     ///< Größte Wartezeit ohne Daten
+	static constexpr uint32_t TX_DONE_TIMEOUT_MS = 5000;  ///< Maximale Wartezeit auf das Sendeende
+
+	/**
+	 * @brief Mithörer für jeden geschriebenen Block (aus der TX-Task, z. B. für den Mitschnitt).
+	 */
+	typedef void (*TapFn)(void *ctx, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param port UART, auf die geschrieben wird.
+	 */
+	explicit SerialPassthrough(UartPort &port);
+
+	/**
+	 * @brief Registriert einen Mithörer für geschriebene Bytes.
+	 */
+	void onTransmit(TapFn tap, void *ctx);
+
+	/**
+	 * @brief Prüft Rate, Boot-Modi und Wartezeit.
+	 */
+	static bool validate(const SerialPassthroughConfig &config);
+
+	/**
+	 * @brief Blockgröße pro Schreibvorgang: etwa CHUNK_MS an Daten, höchstens WRITE_CHUNK.
+	 */
+	static size_t chunkFor(uint32_t baud);
+
+	/**
+	 * @brief Beginnt eine Übertragung (Zustand STARTING).
+	 *
+	 * @param owner Client-ID des Besitzers.
+	 * @param config Parameter (siehe validate()).
+	 * @param mem Speicher (mindestens MEMORY_BYTES, Besitz bleibt beim Aufrufer bis finish()).
+	 * @return false, wenn bereits eine Übertragung läuft oder die Parameter ungültig sind.
+	 */
+	bool begin(uint32_t owner, const SerialPassthroughConfig &config, uint8_t *mem);
+
+	/**
+	 * @brief Stellt Rate und Boot-Leitungen ein (Zustand ACTIVE, TX-Task).
+	 *
+	 * Die Durchsatzmessung beginnt nach der Boot-Sequenz.
+	 *
+	 * @return false, wenn eine Boot-Sequenz angefordert, aber keine Leitungen verdrahtet sind.
+	 */
+	bool enter();
+
+	/**
+	 * @brief Nimmt Daten eines Upload-Blocks an.
+	 *
+	 * @param offset Position des ersten Bytes in der Übertragung.
+	 * @param data Daten.
+	 * @param len Länge.
+	 * @return UPLOAD_OK bzw. der Grund der Ablehnung.
+	 */
+	SerialUploadResult offer(uint32_t offset, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Schreibt den nächsten Block aus dem Zwischenpuffer auf die UART (TX-Task, blockiert).
+	 *
+	 * @return Anzahl der geschriebenen Bytes (0 = Puffer leer oder nicht aktiv).
+	 */
+	size_t drain();
+
+	/**
+	 * @brief Fordert das Ende an.
+	 *
+	 * @param discard true = noch nicht geschriebene Daten verwerfen (Abbruch).
+	 */
+	void requestStop(bool discard);
+
+	/**
+	 * @brief Ist die Übertragung fertig (Größe erreicht bzw. Ende angefordert und Puffer leer)?
+	 */
+	bool complete() const;
+
+	/**
+	 * @brief Kam länger als idleMs kein Upload-Block?
+	 */
+	bool idle() const;
+
+	/**
+	 * @brief Beendet die Übertragung (TX-Task): Sendeende abwarten, Boot-Sequenz, Rate zurück.
+	 *
+	 * Danach ist der Speicher aus begin() frei; der Zustand bleibt STOPPING bis close().
+	 *
+	 * @param restoreBaud Rate nach der Übertragung (0 = die Übertragungsrate beibehalten).
+	 * @return Endstand der Zähler.
+	 */
+	SerialPassthroughStats finish(uint32_t restoreBaud);
+
+	/**
+	 * @brief Gibt die UART wieder frei (Zustand IDLE).
+	 */
+	void close();
+
+	/**
+	 * @brief Zählt vom Controller empfangene Bytes.
+	 */
+	void onRx(size_t len);
+
+	/**
+	 * @brief Steuert die Boot-Leitungen ohne Übertragung (blockiert für die Impulsdauer).
+	 *
+	 * @param mode BOOT_MODE_BOOTLOADER oder BOOT_MODE_RUN.
+	 * @return false, wenn keine Boot-Leitungen verdrahtet sind.
+	 */
+	bool resetTarget(uint8_t mode);
+
+	SerialPassthroughState state() const;  ///< Aktueller Zustand
+	uint32_t owner() const;                ///< Besitzer (0 = keiner)
+	const SerialPassthroughConfig &config() const;  ///< Parameter der laufenden Übertragung
+	uint32_t written() const;              ///< Auf die UART geschriebene Bytes
+	uint32_t limit() const;                ///< Höchster Offset, bis zu dem der Client senden darf
+	bool aborted() const;                  ///< Wurde mit discard beendet?
+
+	/**
+	 * @brief Kopie der Zähler (elapsedMs und Durchsatz bis jetzt).
+	 */
+	SerialPassthroughStats stats() const;
+
+   private:
+	UartPort &_port;                   ///< Ziel-UART
+	TapFn _tap;                        ///< Mithörer für geschriebene Bytes
+	void *_tapCtx;                     ///< Kontext des Mithörers
+	SerialPassthroughConfig _config;   ///< Parameter der laufenden Übertragung
+	volatile uint8_t _state;           ///< SerialPassthroughState
+	ByteRing _ring;                    ///< Angenommene, noch nicht geschriebene Daten
+	uint8_t *_work;                    ///< Arbeitspuffer der TX-Task (WRITE_CHUNK)
+	bool _discard;                     ///< Rest beim Ende verwerfen
+	uint32_t _lastOfferMs;             ///< Zeitpunkt des letzten Upload-Blocks
+	uint32_t _startMs;                 ///< Beginn der Durchsatzmessung (0 = noch nicht aktiv)
+	SerialPassthroughStats _stats;     ///< Zähler
+	mutable TaskMutex _lock;           ///< Schutz von Puffer, Zustand und Zählern (Mutex: offer() kopiert darunter)
+
+	void runBootSequence(uint8_t mode);
+	static void fillRate(SerialPassthroughStats &stats, uint32_t elapsedMs);
+};
+
+#endif  // SERIALPASSTHROUGH_H
@@ -0,0 +1,153 @@
+/**
+ * @file SerialPattern.h
+ * @brief Kleiner regulärer Ausdruck mit Gruppen für die Auswertung serieller Antworten.
+ *
+ * Unterstützt wird die Teilmenge, die für Antworten von Steuerungen reicht:
+ *  - Literale, `.` (alles außer '\n'), Klassen `[a-z0-9_]`, `[^...]`,
+ *  - Kürzel `\d \w \s \D \W \S` (auch in Klassen) und maskierte Zeichen (`\.`, `\(`, ...),
+ *    dazu `\r \n \t \xHH`,
+ *  - Quantoren `* + ?` (gierig) und `*? +? ??` (genügsam),
+ *  - Alternativen `|`, Gruppen `( )` mit Erfassung und `(?: )` ohne,
+ *  - Anker `^` und `$` (Zeilenanfang bzw. -ende oder Ende der Daten).
+ *
+ * Der Ausdruck wird in ein kleines Programm übersetzt und per Backtracking ausgeführt, ohne
+ * Heap und mit fester Obergrenze für Schritte und Rücksprungstapel; ein entarteter Ausdruck
+ * liefert dadurch "kein Treffer" statt die Task zu blockieren.
+ *
+ * Ohne `/.../` im Skript wird ein Muster als einfacher Teilstring gesucht (literal()).
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALPATTERN_H
+#define SERIALPATTERN_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct SerialPatternMatch
+ * @brief Treffer mit Gruppen; Gruppe 0 ist der gesamte Treffer.
+ */
+struct SerialPatternMatch {
+	static constexpr size_t MAX_GROUPS = 8;  ///< Gruppe 0 und bis zu 7 erfassende Gruppen
+	uint16_t start[MAX_GROUPS];             ///< Beginn je Gruppe (UNSET = nicht beteiligt)
+	uint16_t end[MAX_GROUPS];               ///< Ende je Gruppe (exklusiv)
+	size_t groups;                          ///< Anzahl gültiger Gruppen einschließlich Gruppe 0
+
+	static constexpr uint16_t UNSET = 0xFFFF;  ///< Gruppe hat nicht teilgenommen
+};
+
+/**
+ * @class SerialPattern
+ * @brief Übersetzter Ausdruck bzw. Teilstring; search() sucht den am weitesten links
+ *        beginnenden Treffer.
+ */
+class SerialPattern {
+   public:
+	static constexpr size_t MAX_PROGRAM = 128;     ///< Maximale Anzahl Instruktionen
+	static constexpr size_t MAX_CLASSES = 12;      ///< Maximale Anzahl Zeichenklassen
+	static constexpr size_t MAX_LITERAL = 64;      ///< Maximale Länge eines Teilstrings
+	static constexpr size_t MAX_BACKTRACK = 256;   ///< Einträge des Rücksprungstapels
+	static constexpr uint32_t MAX_STEPS = 50000;   ///< Schrittbudget pro search()
+	static constexpr size_t MAX_TEXT = 0xFFFE;     ///< Maximale Länge des durchsuchten Textes
+	static constexpr size_t MAX_DEPTH = 8;         ///< Maximale Schachtelung von Gruppen
+	static constexpr size_t MAX_LOOPS = 4;         ///< Maximale Anzahl `*`/`+` über Gruppen
+
+	SerialPattern();
+
+	/**
+	 * @brief Übersetzt einen regulären Ausdruck.
+	 *
+	 * @param pattern Ausdruck (nicht nullterminiert).
+	 * @param len Länge des Ausdrucks.
+	 * @return false bei Syntaxfehler oder zu großem Programm (siehe error()).
+	 */
+	bool compile(const char *pattern, size_t len);
+
+	/**
+	 * @brief Setzt einen einfachen Teilstring als Muster.
+	 *
+	 * @return false, wenn er leer oder länger als MAX_LITERAL ist.
+	 */
+	bool literal(const char *text, size_t len);
+
+	/**
+	 * @brief Sucht den ersten Treffer.
+	 *
+	 * @param text Durchsuchte Daten (höchstens MAX_TEXT Bytes).
+	 * @param len Länge der Daten.
+	 * @param match Treffer und Gruppen (nur bei Rückgabe true gültig).
+	 * @return true bei einem Treffer.
+	 */
+	bool search(const uint8_t *text, size_t len, SerialPatternMatch &match) const;
+
+	/**
+	 * @brief Anzahl der Gruppen einschließlich Gruppe 0.
+	 */
+	size_t groups() const;
+
+	/**
+	 * @brief true, wenn die letzte search() am Schrittbudget oder Stapel abgebrochen ist.
+	 */
+	bool exhausted() const;
+
+	/**
+	 * @brief Beschreibung des letzten Übersetzungsfehlers ("" = keiner).
+	 */
+	const char *error() const;
+
+   private:
+	/**
+	 * @brief Instruktion des Backtracking-Programms.
+	 */
+	struct Instr {
+		uint8_t op;   ///< OP_CHAR, ...
+		uint8_t arg;  ///< Zeichen, Klassenindex oder Gruppenslot
+		uint16_t x;   ///< Sprungziel (bevorzugt)
+		uint16_t y;   ///< Alternatives Sprungziel (OP_SPLIT)
+	};
+
+	/**
+	 * @brief Eintrag des Rücksprungstapels: offener Zweig oder zu restaurierender Gruppenslot.
+	 */
+	struct Frame {
+		uint16_t pc;   ///< Instruktion des Zweigs bzw. alter Slotwert
+		uint16_t sp;   ///< Textposition des Zweigs
+		uint8_t slot;  ///< Gruppenslot (FRAME_BRANCH = Zweig)
+	};
+
+	Instr _prog[MAX_PROGRAM];             ///< Programm
+	size_t _len;                          ///< Anzahl der Instruktionen
+	uint8_t _classes[MAX_CLASSES][32];    ///< Bitmasken der Zeichenklassen
+	size_t _classCount;                   ///< Belegte Klassen
+	size_t _groups;                       ///< Gruppen einschließlich Gruppe 0
+	size_t _loops;                        ///< Belegte Schleifenslots (MARK/CHECK)
+	char _literal[MAX_LITERAL];           ///< Teilstring (nur bei _isLiteral)
+	size_t _literalLen;                   ///< Länge des Teilstrings
+	bool _isLiteral;                      ///< Einfache Teilstringsuche statt Programm
+	const char *_error;                   ///< Letzter Übersetzungsfehler
+	mutable bool _exhausted;              ///< Letzte Suche abgebrochen
+	mutable Frame _stack[MAX_BACKTRACK];  ///< Rücksprungstapel von search()
+
+	// Zustand des Übersetzers
+	const char *_src;  ///< Ausdruck
+	size_t _srcLen;    ///< Länge des Ausdrucks
+	size_t _pos;       ///< Leseposition
+	size_t _depth;     ///< Schachtelungstiefe der Gruppen
+
+	bool parseAlt();
+	bool parseConcat();
+	bool parseRepeat();
+	bool parseAtom();
+	bool parseClass();
+	bool parseEscape(uint8_t *set, int &single);
+	int newClass();
+	bool emit(uint8_t op, uint8_t arg = 0, uint16_t x = 0, uint16_t y = 0);
+	bool insert(size_t at, uint8_t op, uint16_t x, uint16_t y);
+	bool fail(const char *msg);
+	bool run(const uint8_t *text, size_t len, size_t startPos, uint16_t *caps, uint32_t &steps) const;
+};
+
+#endif  // SERIALPATTERN_H
@@ -0,0 +1,214 @@
+/**
+ * @file SerialPoller.h
+ * @brief Zyklische Abfragen des Geräts mit Zwischenspeicher der ausgewerteten Werte.
+ *
+ * Statt dass jeder Browser dieselben Abfragen selbst schickt, fragt der ESP32 konfigurierte
+ * Befehle in festen Abständen ab und zerlegt die Antworten per Ausdruck (SerialPattern) in
+ * benannte Felder. Die Felder liegen in einem Zwischenspeicher, aus dem alle Clients bedient
+ * werden; Änderungen meldet ein Callback als Bitmaske der betroffenen Felder.
+ *
+ * Ablauf (alles in der Bridge-Task, nur der Zwischenspeicher ist threadsicher lesbar):
+ *  - service() sendet die am längsten fällige Abfrage, solange keine andere auf Antwort
+ *    wartet; das Gerät bekommt also nie zwei Abfragen gleichzeitig,
+ *  - onRecord() prüft jeden fertigen Datensatz gegen den Ausdruck der wartenden Abfrage;
+ *    Gruppe 1..n landen in den Feldern der Abfrage,
+ *  - läuft die Antwortzeit ab, gelten ihre Felder als veraltet (`stale`), bis wieder eine
+ *    Antwort kommt.
+ *
+ * Übersetzt wird immer nur der Ausdruck der gerade wartenden Abfrage; validate() prüft alle
+ * vorab, damit configure() nicht scheitern kann.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALPOLLER_H
+#define SERIALPOLLER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SerialPattern.h"
+#include "TaskMutex.h"
+
+/**
+ * @struct SerialPollEntry
+ * @brief Eine zyklische Abfrage.
+ */
+struct SerialPollEntry {
+	static constexpr size_t MAX_NAME = 16;      ///< Maximale Länge eines Namens inkl. '\0'
+	static constexpr size_t MAX_REQUEST = 64;   ///< Maximale Länge der Abfrage
+	static constexpr size_t MAX_PATTERN = 96;   ///< Maximale Länge des Ausdrucks inkl. '\0'
+	static constexpr size_t MAX_FIELDS = SerialPatternMatch::MAX_GROUPS - 1;  ///< Felder pro Abfrage
+
+	char name[MAX_NAME];                        ///< Name der Abfrage
+	uint8_t request[MAX_REQUEST];               ///< Zu sendende Bytes
+	size_t requestLen;                          ///< Anzahl der Bytes
+	char pattern[MAX_PATTERN];                  ///< Ausdruck für die Antwort
+	char fields[MAX_FIELDS][MAX_NAME];          ///< Feldnamen für Gruppe 1..n
+	size_t fieldCount;                          ///< Anzahl der Felder
+	uint32_t intervalMs;                        ///< Abstand der Abfragen
+	uint32_t timeoutMs;                         ///< Maximale Wartezeit auf die Antwort
+};
+
+/**
+ * @struct SerialPollerConfig
+ * @brief Alle Abfragen eines Kanals.
+ */
+struct SerialPollerConfig {
+	static constexpr size_t MAX_POLLS = 8;  ///< Maximale Anzahl Abfragen
+	SerialPollEntry polls[MAX_POLLS];       ///< Abfragen
+	size_t count;                           ///< Anzahl der Abfragen (0 = aus)
+	bool hideReplies;                       ///< Erkannte Antworten nicht an die Clients verteilen
+};
+
+/**
+ * @struct SerialPollField
+ * @brief Eintrag des Zwischenspeichers.
+ */
+struct SerialPollField {
+	static constexpr size_t MAX_VALUE = 48;  ///< Maximale Länge eines Wertes inkl. '\0'
+	char name[SerialPollEntry::MAX_NAME];    ///< Feldname
+	char value[MAX_VALUE];                   ///< Letzter Wert (gekürzt)
+	bool set;                                ///< Es gab schon einen Wert
+	bool stale;                              ///< Letzte Abfrage blieb unbeantwortet
+	uint32_t updatedMs;                      ///< Zeitpunkt der letzten Antwort
+	uint32_t changes;                        ///< Anzahl der Wertänderungen
+};
+
+/**
+ * @struct SerialPollStats
+ * @brief Zähler einer Abfrage.
+ */
+struct SerialPollStats {
+	uint32_t requests;   ///< Gesendete Abfragen
+	uint32_t replies;    ///< Erkannte Antworten
+	uint32_t timeouts;   ///< Abfragen ohne Antwort
+	uint32_t lastRttMs;  ///< Antwortzeit der letzten Antwort
+};
+
+/**
+ * @class SerialPoller
+ * @brief Zeitplan, Antwortauswertung und Feldspeicher der zyklischen Abfragen.
+ */
+class SerialPoller {
+   public:
+	static constexpr size_t MAX_FIELDS = 32;              ///< Maximale Anzahl Felder (Bitmaske)
+	static constexpr uint32_t MIN_INTERVAL_MS = 100;      ///< Kleinster Abfrageabstand
+	static constexpr uint32_t MAX_TIMEOUT_MS = 60000;     ///< Größte Antwortzeit
+	static constexpr uint32_t DEFAULT_TIMEOUT_MS = 1000;  ///< Voreinstellung der Antwortzeit
+	static constexpr uint32_t SEND_RETRY_MS = 10;         ///< Wartezeit bei voller Sendewarteschlange
+	static constexpr size_t NO_FIELD = 0xFF;              ///< Feld nicht gefunden
+
+	/**
+	 * @brief Übergibt eine Abfrage zum Senden.
+	 *
+	 * @return false, wenn sie gerade nicht angenommen werden kann (wird erneut versucht).
+	 */
+	typedef bool (*SendFn)(void *ctx, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Meldet geänderte Felder (Bitmaske der Feldindizes, Wert oder `stale`).
+	 */
+	typedef void (*UpdateFn)(void *ctx, uint32_t changed);
+
+	/**
+	 * @brief Konstruktor; ohne configure() ist der Poller aus.
+	 *
+	 * @param send Sende-Callback.
+	 * @param update Änderungs-Callback (darf nullptr sein).
+	 * @param ctx Benutzerkontext beider Callbacks.
+	 */
+	SerialPoller(SendFn send, UpdateFn update, void *ctx);
+
+	/**
+	 * @brief Prüft eine Konfiguration vollständig (Ausdrücke, Gruppen, Feldanzahl, Abstände).
+	 *
+	 * @param cfg Konfiguration.
+	 * @param error Puffer für die Fehlerbeschreibung.
+	 * @param size Größe des Puffers.
+	 * @return true, wenn configure() sie übernehmen kann.
+	 */
+	static bool validate(const SerialPollerConfig &cfg, char *error, size_t size);
+
+	/**
+	 * @brief Übernimmt eine geprüfte Konfiguration; Felder gleichen Namens bleiben erhalten.
+	 *
+	 * Eine wartende Abfrage wird verworfen, alle Abfragen sind sofort fällig.
+	 *
+	 * @param cfg Konfiguration (vorher mit validate() geprüft).
+	 * @param nowMs Aktuelle Zeit in ms.
+	 */
+	void configure(const SerialPollerConfig &cfg, uint32_t nowMs);
+
+	/**
+	 * @brief Aktuelle Konfiguration.
+	 */
+	const SerialPollerConfig &config() const;
+
+	/**
+	 * @brief Verwaltet Antwortzeit und Zeitplan.
+	 *
+	 * @param nowMs Aktuelle Zeit in ms.
+	 * @param mayStart false, solange keine neue Abfrage gesendet werden darf (z. B. Skript läuft).
+	 * @return Zeit bis zur nächsten Aktion in ms (UINT32_MAX = keine Abfragen).
+	 */
+	uint32_t service(uint32_t nowMs, bool mayStart);
+
+	/**
+	 * @brief Prüft einen fertigen Datensatz gegen die wartende Abfrage.
+	 *
+	 * @param data Datensatz.
+	 * @param len Länge des Datensatzes.
+	 * @param nowMs Aktuelle Zeit in ms.
+	 * @return true, wenn der Datensatz die Antwort war.
+	 */
+	bool onRecord(const uint8_t *data, size_t len, uint32_t nowMs);
+
+	/**
+	 * @brief Anzahl der Felder (threadsicher).
+	 */
+	size_t fieldCount() const;
+
+	/**
+	 * @brief Kopie eines Feldes (threadsicher).
+	 *
+	 * @return false bei ungültigem Index.
+	 */
+	bool field(size_t index, SerialPollField &out) const;
+
+	/**
+	 * @brief Sucht ein Feld nach Namen (threadsicher).
+	 *
+	 * @return Index oder NO_FIELD.
+	 */
+	size_t findField(const char *name) const;
+
+	/**
+	 * @brief Zähler einer Abfrage (threadsicher).
+	 *
+	 * @return false bei ungültigem Index.
+	 */
+	bool stats(size_t index, SerialPollStats &out) const;
+
+   private:
+	SendFn _send;                                  ///< Sende-Callback
+	UpdateFn _update;                              ///< Änderungs-Callback
+	void *_ctx;                                    ///< Benutzerkontext
+	SerialPollerConfig _cfg;                       ///< Aktive Konfiguration
+	uint8_t _map[SerialPollerConfig::MAX_POLLS][SerialPollEntry::MAX_FIELDS];  ///< Feldindex je Gruppe
+	uint32_t _due[SerialPollerConfig::MAX_POLLS];  ///< Nächster Sendezeitpunkt je Abfrage
+	size_t _active;                                ///< Wartende Abfrage (MAX_POLLS = keine)
+	uint32_t _sentMs;                              ///< Sendezeitpunkt der wartenden Abfrage
+	SerialPattern _pattern;                        ///< Übersetzter Ausdruck der wartenden Abfrage
+
+	// Threadsicher lesbar (geschützt durch _lock)
+	SerialPollField _fields[MAX_FIELDS];                  ///< Zwischenspeicher
+	size_t _fieldCount;                                   ///< Belegte Felder
+	SerialPollStats _stats[SerialPollerConfig::MAX_POLLS];  ///< Zähler je Abfrage
+	mutable TaskMutex _lock;                              ///< Schutz von Feldern und Zählern (Mutex: configure() ordnet darunter um)
+
+	void expire();
+};
+
+#endif  // SERIALPOLLER_H
@@ -0,0 +1,262 @@
+/**
+ * @file SerialRecorder.h
+ * @brief Mitschnitt des rohen RX/TX-Datenstroms in Segmentdateien.
+ *
+ * Empfangene und gesendete Bytes werden mit Zeitstempel und Richtung in einen von zwei
+ * RAM-Puffern geschrieben. Ist ein Puffer voll (BLOCK = ein Flash-Sektor) oder älter als
+ * FLUSH_INTERVAL_MS, wird er getauscht und von einer niedrig priorisierten Schreib-Task in
+ * einem Stück auf das Dateisystem geschrieben, während der andere Puffer weiter gefüllt wird.
+ * Der Live-Pfad wartet dadurch nie auf den Flash; ist die Schreib-Task zu langsam, werden
+ * Datensätze verworfen und der nächste erhaltene mit CAPTURE_FLAG_GAP markiert.
+ *
+ * Dateiformat (alle Mehrbytefelder Little Endian):
+ *
+ * | Offset | Größe | Feld      | Beschreibung                                   |
+ * | ------ | ----- | --------- | ---------------------------------------------- |
+ * | 0      | 4     | magic     | "HTCP"                                         |
+ * | 4      | 1     | version   | Formatversion (CAPTURE_VERSION)                |
+ * | 5      | 1     | segment   | Segmentnummer innerhalb der Sitzung (0..255)   |
+ * | 6      | 2     | reserved  | 0                                              |
+ * | 8      | 4     | epoch     | Unix-Zeit beim Anlegen (0 = unbekannt)         |
+ * | 12     | 4     | uptime    | Millisekunden seit Systemstart beim Anlegen    |
+ *
+ * Danach folgen Datensätze mit je 16 Byte Kopf: `dir` (1), `flags` (1), `len` (2), `seq` (4),
+ * `timestamp` (8, µs seit Systemstart) und `len` Bytes Rohdaten. `seq` zählt jeden angebotenen
+ * Datensatz der Sitzung, auch verworfene; eine Lücke in `seq` zeigt also, wie viele fehlen.
+ * Ein RX-Datensatz ist genau ein aus der UART gelesener Block, `timestamp` dessen Lesezeitpunkt.
+ * Version 1 hatte 8 Byte Kopf ohne `seq` und mit Millisekunden.
+ *
+ * Segmente heißen `<session>.cap`, `<session>.1.cap`, `<session>.2.cap`, ... Ein neues Segment
+ * beginnt bei Erreichen von maxFileBytes oder maxFileAgeMs. Übersteigen alle Mitschnitte die
+ * Quote oder wird der Platz im Dateisystem knapp, werden die ältesten Dateien gelöscht.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALRECORDER_H
+#define SERIALRECORDER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "CaptureStore.h"
+#include "CriticalSection.h"
+
+/// Version des Mitschnittformats
+constexpr uint8_t CAPTURE_VERSION = 2;
+
+/// Länge des Dateikopfs in Bytes
+constexpr size_t CAPTURE_FILE_HEADER_LEN = 16;
+
+/// Länge des Datensatzkopfs in Bytes
+constexpr size_t CAPTURE_RECORD_HEADER_LEN = 16;
+
+/**
+ * @enum CaptureDirection
+ * @brief Richtung eines Datensatzes.
+ */
+enum CaptureDirection : uint8_t {
+	CAPTURE_RX = 0,  ///< Vom Gerät empfangen
+	CAPTURE_TX = 1   ///< An das Gerät gesendet
+};
+
+/**
+ * @enum CaptureFlags
+ * @brief Bitflags im Datensatzkopf.
+ */
+enum CaptureFlags : uint8_t {
+	CAPTURE_FLAG_NONE = 0x00,  ///< Keine Besonderheiten
+	CAPTURE_FLAG_GAP = 0x01    ///< Davor wurden Datensätze verworfen
+};
+
+/**
+ * @struct CaptureRecordHeader
+ * @brief Dekodierter Datensatzkopf.
+ */
+struct CaptureRecordHeader {
+	uint8_t dir;         ///< CaptureDirection
+	uint8_t flags;       ///< CaptureFlags
+	uint16_t len;        ///< Länge der Rohdaten
+	uint32_t seq;        ///< Laufende Nummer innerhalb der Sitzung
+	uint64_t timestamp;  ///< Zeitstempel in µs
+};
+
+/**
+ * @brief Liest einen Datensatzkopf aus `in`.
+ *
+ * @return false, wenn `len` kürzer als CAPTURE_RECORD_HEADER_LEN ist.
+ */
+bool decodeCaptureRecordHeader(const uint8_t *in, size_t len, CaptureRecordHeader &hdr);
+
+/**
+ * @struct SerialRecorderConfig
+ * @brief Rotation und Speicherquote.
+ */
+struct SerialRecorderConfig {
+	size_t maxFileBytes;    ///< Maximale Größe eines Segments
+	uint32_t maxFileAgeMs;  ///< Maximales Alter eines Segments
+	size_t quotaBytes;      ///< Obergrenze aller Mitschnitte zusammen
+};
+
+/**
+ * @struct SerialRecorderStats
+ * @brief Zähler des laufenden bzw. letzten Mitschnitts.
+ */
+struct SerialRecorderStats {
+	uint32_t records;       ///< Angenommene Datensätze
+	uint32_t bytes;         ///< Auf das Dateisystem geschriebene Bytes
+	uint32_t dropped;       ///< Verworfene Datensätze (beide Puffer voll)
+	uint32_t droppedBytes;  ///< Verworfene Rohdaten
+	uint32_t flushes;       ///< Schreibvorgänge
+	uint32_t segments;      ///< Angelegte Segmente
+	uint32_t deleted;       ///< Wegen der Quote gelöschte Dateien
+};
+
+/**
+ * @class SerialRecorder
+ * @brief Doppelpuffer und Segmentverwaltung für den Mitschnitt.
+ *
+ * `append()` ist aus beliebigen Tasks aufrufbar und blockiert nicht. `start()` und `stop()`
+ * hinterlegen nur eine Anforderung; Dateien öffnet und schreibt ausschließlich `service()`
+ * in der Schreib-Task.
+ */
+class SerialRecorder {
+   public:
+	static constexpr size_t BLOCK = 4096;                         ///< Größe eines RAM-Puffers (ein Flash-Sektor)
+	static constexpr uint32_t FLUSH_INTERVAL_MS = 2000;           ///< Spätestens dann wird ein Puffer geschrieben
+	static constexpr size_t MAX_SESSION = 32;                     ///< Maximale Länge des Sitzungsnamens
+	static constexpr size_t FS_RESERVE_BYTES = 262144;            ///< Im Dateisystem immer frei gelassener Platz
+	static constexpr size_t DEFAULT_MAX_FILE_BYTES = 1048576;     ///< Standard-Segmentgröße
+	static constexpr uint32_t DEFAULT_MAX_FILE_AGE_MS = 3600000;  ///< Standard-Segmentalter (1 h)
+	static constexpr size_t DEFAULT_QUOTA_BYTES = 4194304;        ///< Standard-Quote aller Mitschnitte
+
+	/**
+	 * @brief Callback, wenn die Schreib-Task Arbeit hat (Puffer voll, Start, Stopp).
+	 */
+	typedef void (*WakeFn)(void *ctx);
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param store Ablage der Segmentdateien.
+	 */
+	explicit SerialRecorder(CaptureStore &store);
+	~SerialRecorder();
+
+	/**
+	 * @brief Registriert den Weck-Callback der Schreib-Task.
+	 */
+	void onWake(WakeFn fn, void *ctx);
+
+	/**
+	 * @brief Prüft Sitzungsname und Einstellungen.
+	 *
+	 * Erlaubt sind 1 bis MAX_SESSION Zeichen aus Buchstaben, Ziffern, '-' und '_'. Ein Segment
+	 * muss mindestens einen Puffer fassen, die Quote mindestens zwei Segmente.
+	 */
+	static bool validate(const char *session, const SerialRecorderConfig &config);
+
+	/**
+	 * @brief Fordert einen neuen Mitschnitt an.
+	 *
+	 * @param session Sitzungsname (Dateiname ohne Endung).
+	 * @param config Rotation und Quote.
+	 * @param epoch Aktuelle Unix-Zeit für den Dateikopf (0 = unbekannt).
+	 * @return false bei ungültigem Namen/Einstellungen, fehlendem Speicher oder laufendem Mitschnitt.
+	 */
+	bool start(const char *session, const SerialRecorderConfig &config, uint32_t epoch);
+
+	/**
+	 * @brief Fordert das Beenden an; gepufferte Daten werden noch geschrieben.
+	 */
+	void stop();
+
+	/**
+	 * @brief Übernimmt einen Datensatz in den aktiven Puffer (blockiert nicht).
+	 *
+	 * @param dir Richtung.
+	 * @param data Rohdaten (höchstens BLOCK - CAPTURE_RECORD_HEADER_LEN Bytes werden übernommen).
+	 * @param len Länge der Rohdaten.
+	 * @param timestampUs Zeitstempel in µs seit Systemstart.
+	 * @return false, wenn nicht aufgezeichnet wird oder der Datensatz verworfen wurde.
+	 */
+	bool append(CaptureDirection dir, const uint8_t *data, size_t len, uint64_t timestampUs);
+
+	/**
+	 * @brief Arbeitet Anforderungen und volle Puffer ab (aus der Schreib-Task).
+	 *
+	 * @param now Aktuelle Zeit in ms.
+	 * @return Millisekunden bis zum nächsten nötigen Aufruf (UINT32_MAX = erst nach Wecken).
+	 */
+	uint32_t service(uint32_t now);
+
+	/**
+	 * @brief true, solange aufgezeichnet wird (inkl. angefordertem Start).
+	 */
+	bool active() const;
+
+	/**
+	 * @brief Name der laufenden bzw. letzten Sitzung.
+	 */
+	const char *session() const;
+
+	/**
+	 * @brief Name des aktuellen Segments.
+	 */
+	const char *segmentName() const;
+
+	/**
+	 * @brief Grund des letzten Abbruchs ("" = kein Fehler).
+	 */
+	const char *lastError() const;
+
+	/**
+	 * @brief Aktive Einstellungen.
+	 */
+	SerialRecorderConfig config() const;
+
+	/**
+	 * @brief Kopie der Zähler.
+	 */
+	SerialRecorderStats stats() const;
+
+   private:
+	static constexpr uint8_t STATE_IDLE = 0;       ///< Kein Mitschnitt
+	static constexpr uint8_t STATE_STARTING = 1;   ///< Angefordert, Segment noch nicht offen
+	static constexpr uint8_t STATE_RECORDING = 2;  ///< Segment offen
+	static constexpr int NO_BUFFER = -1;           ///< Kein Puffer zum Schreiben bereit
+
+	CaptureStore &_store;              ///< Ablage
+	WakeFn _wake;                      ///< Weck-Callback
+	void *_wakeCtx;                    ///< Kontext des Weck-Callbacks
+	uint8_t *_buf[2];                  ///< Doppelpuffer (beim ersten Start angelegt)
+	size_t _len[2];                    ///< Füllstand der Puffer
+	int _fill;                         ///< Index des aktiven Puffers
+	int _ready;                        ///< Index des Puffers, den die Schreib-Task schreibt
+	uint32_t _firstAt;                 ///< Zeitstempel des ersten Datensatzes im aktiven Puffer
+	bool _gap;                         ///< Nächster Datensatz bekommt CAPTURE_FLAG_GAP
+	uint32_t _seq;                     ///< Nummer des nächsten Datensatzes
+	volatile uint8_t _state;           ///< STATE_IDLE, ...
+	volatile bool _stopRequested;      ///< stop() wurde aufgerufen
+	char _session[MAX_SESSION + 1];    ///< Sitzungsname
+	char _segment[MAX_SESSION + 16];   ///< Name des aktuellen Segments
+	const char *_error;                ///< Grund des letzten Abbruchs
+	SerialRecorderConfig _config;      ///< Rotation und Quote
+	uint32_t _epoch;                   ///< Unix-Zeit beim Start
+	uint32_t _startMs;                 ///< Zeitstempel beim Start
+	uint32_t _segmentIndex;            ///< Nummer des aktuellen Segments
+	size_t _segmentBytes;              ///< Größe des aktuellen Segments
+	uint32_t _segmentStart;            ///< Zeitpunkt, an dem das Segment angelegt wurde
+	size_t _used;                      ///< Belegung aller Mitschnitte (mitgeführt)
+	size_t _free;                      ///< Freier Platz im Dateisystem (mitgeführt)
+	SerialRecorderStats _stats;        ///< Zähler
+	mutable CriticalSection _lock;     ///< Schutz von Puffern, Zustand und Zählern
+
+	bool openSegment(uint32_t now);
+	bool writeBlock(const uint8_t *data, size_t len, uint32_t now);
+	bool makeRoom(size_t len);
+	void finish(const char *error);
+};
+
+#endif  // SERIALRECORDER_H
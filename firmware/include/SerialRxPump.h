@@ -0,0 +1,115 @@
+/**
+ * @file SerialRxPump.h
+ * @brief Empfangspfad der SerialBridge: wartet auf neue UART-Daten und liest sie blockweise aus.
+ *
+ * Es gibt zwei Betriebsarten:
+ * - `SERIAL_RX_EVENT`: Die Task blockiert auf der Event-Queue des UART-Treibers und wacht nur
+ *   bei Daten, Überlauf, Break oder erkanntem Zeilenende auf.
+ * - `SERIAL_RX_POLLING`: Der bisherige Pfad, der alle `POLL_INTERVAL_MS` aufwacht und nachsieht,
+ *   ob Bytes angekommen sind. Wird mit dem Build-Flag `SERIALBRIDGE_POLLING` als Standard gewählt.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALRXPUMP_H
+#define SERIALRXPUMP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "UartPort.h"
+
+/**
+ * @enum SerialRxMode
+ * @brief Betriebsart des Empfangspfads.
+ */
+enum SerialRxMode {
+	SERIAL_RX_POLLING,  ///< Zyklisches Abfragen alle POLL_INTERVAL_MS
+	SERIAL_RX_EVENT     ///< Blockieren auf der Event-Queue des UART-Treibers
+};
+
+/// Standard-Betriebsart, abhängig vom Build-Flag `SERIALBRIDGE_POLLING`
+#ifdef SERIALBRIDGE_POLLING
+constexpr SerialRxMode SERIAL_RX_DEFAULT_MODE = SERIAL_RX_POLLING;
+#else
+constexpr SerialRxMode SERIAL_RX_DEFAULT_MODE = SERIAL_RX_EVENT;
+#endif
+
+/**
+ * @struct SerialRxStats
+ * @brief Zähler des Empfangspfads (für Diagnose und Tests).
+ */
+struct SerialRxStats {
+	uint32_t wakeups;    ///< Anzahl der Aufwachvorgänge der Task
+	uint32_t bytes;      ///< Insgesamt gelesene Bytes
+	uint32_t overflows;  ///< FIFO- oder Ringpuffer-Überläufe
+	uint32_t breaks;     ///< Erkannte Break-Signale
+	uint32_t patterns;   ///< Erkannte Zeilenenden (Pattern Detect)
+};
+
+/**
+ * @class SerialRxPump
+ * @brief Kapselt das Warten auf und das Auslesen von UART-Daten.
+ */
+class SerialRxPump {
+   public:
+	static constexpr uint32_t POLL_INTERVAL_MS = 5;         ///< Abfrageintervall im Polling-Betrieb
+	static constexpr size_t RX_BUFFER_MIN = 1024;           ///< Untergrenze des Treiber-Ringpuffers
+	static constexpr size_t RX_BUFFER_MAX = 16384;          ///< Obergrenze des Treiber-Ringpuffers
+	static constexpr uint32_t RX_BUFFER_HEADROOM_MS = 100;  ///< Zeitspanne, die der Ringpuffer überbrücken soll
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param port Zu überwachende UART.
+	 * @param mode Betriebsart (Default: abhängig von `SERIALBRIDGE_POLLING`).
+	 */
+	explicit SerialRxPump(UartPort &port, SerialRxMode mode = SERIAL_RX_DEFAULT_MODE);
+
+	/**
+	 * @brief Wartet auf neue Daten und liest sie in `buf`.
+	 *
+	 * Liegen bereits Bytes vor, wird nicht gewartet. Überläufe leeren den Eingang und liefern 0.
+	 *
+	 * @param buf Zielpuffer.
+	 * @param cap Größe des Zielpuffers.
+	 * @param timeoutMs Maximale Wartezeit im Ereignisbetrieb.
+	 * @return Anzahl der gelesenen Bytes (0 bei Timeout oder Überlauf).
+	 */
+	size_t wait(uint8_t *buf, size_t cap, uint32_t timeoutMs);
+
+	/**
+	 * @brief Typ des zuletzt verarbeiteten Ereignisses.
+	 */
+	UartEventType lastEvent() const;
+
+	/**
+	 * @brief Gibt die aktuelle Betriebsart zurück.
+	 */
+	SerialRxMode mode() const;
+
+	/**
+	 * @brief Gibt die gesammelten Zähler zurück.
+	 */
+	const SerialRxStats &stats() const;
+
+	/**
+	 * @brief Berechnet die Größe des Treiber-Ringpuffers aus der Baudrate.
+	 *
+	 * Der Puffer fasst mindestens RX_BUFFER_HEADROOM_MS an Daten (10 Bit pro Byte bei 8N1),
+	 * wird auf die nächste Zweierpotenz gerundet und auf [RX_BUFFER_MIN, RX_BUFFER_MAX] begrenzt.
+	 *
+	 * @param baud Höchste Baudrate, die der Puffer abdecken soll.
+	 * @return Puffergröße in Bytes.
+	 */
+	static size_t rxBufferSizeFor(uint32_t baud);
+
+   private:
+	UartPort &_port;           ///< Überwachte UART
+	SerialRxMode _mode;        ///< Betriebsart
+	UartEventType _lastEvent;  ///< Zuletzt verarbeitetes Ereignis
+	SerialRxStats _stats;      ///< Zähler
+};
+
+#endif  // SERIALRXPUMP_H
@@ -0,0 +1,177 @@
+/**
+ * @file SerialScript.h
+ * @brief Befehlsskripte für Transaktionen mit dem angeschlossenen Gerät (senden, erwarten, verzweigen).
+ *
+ * Ein Skript ist ein zeilenweiser Text; pro Zeile ein Schritt, `#` leitet einen Kommentar ein:
+ *
+ * @code
+ * # Firmware-Version abfragen, bis zu dreimal
+ * start:
+ *   send "VER?\r\n"
+ *   expect /VER (\d+)\.(\d+)/ 500 major minor else again
+ *   done
+ * again:
+ *   retry start 3
+ *   fail "keine Antwort"
+ * @endcode
+ *
+ * Schritte:
+ *  - `<label>:` – Sprungmarke,
+ *  - `send "<text>"` – Text senden (Escapes `\r \n \t \\ \" \xHH`),
+ *  - `expect "<text>"|/<regex>/ [<ms>] [<feld> ...] [else <label>]` – auf Teilstring bzw.
+ *    Ausdruck (siehe SerialPattern) warten; Gruppen 1..n landen in den Feldern. Ohne `else`
+ *    beendet ein Timeout das Skript mit SCRIPT_TIMEOUT,
+ *  - `wait <ms>` – warten, `flush` – bisher Empfangenes verwerfen,
+ *  - `goto <label>`, `if <feld> ["<wert>"] <label>` – springen (bedingt, wenn das Feld gesetzt
+ *    bzw. gleich dem Wert ist),
+ *  - `retry <label> <n>` – höchstens n-mal springen, danach weiter,
+ *  - `done` – erfolgreich beenden (auch am Skriptende), `fail "<text>"` – mit Fehler beenden.
+ *
+ * Die Klasse übersetzt den Text nur in eine Schrittliste; ausgeführt wird sie von
+ * SerialScriptEngine. Alle Texte liegen in einem festen Speicherbereich, es wird nichts
+ * allokiert.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALSCRIPT_H
+#define SERIALSCRIPT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SerialPattern.h"
+
+/**
+ * @enum SerialScriptOp
+ * @brief Art eines Skriptschritts.
+ */
+enum SerialScriptOp {
+	SCRIPT_OP_SEND,    ///< Text senden
+	SCRIPT_OP_EXPECT,  ///< Auf Muster warten
+	SCRIPT_OP_WAIT,    ///< Feste Zeit warten
+	SCRIPT_OP_FLUSH,   ///< Empfangsfenster leeren
+	SCRIPT_OP_GOTO,    ///< Unbedingter Sprung
+	SCRIPT_OP_IF,      ///< Bedingter Sprung über ein Feld
+	SCRIPT_OP_RETRY,   ///< Begrenzt wiederholter Sprung
+	SCRIPT_OP_DONE,    ///< Erfolgreiches Ende
+	SCRIPT_OP_FAIL     ///< Ende mit Fehlermeldung
+};
+
+/**
+ * @struct SerialScriptStep
+ * @brief Übersetzter Skriptschritt.
+ */
+struct SerialScriptStep {
+	uint8_t op;                                            ///< SerialScriptOp
+	bool regex;                                            ///< expect: Text ist ein Ausdruck
+	uint16_t line;                                         ///< Zeile im Quelltext
+	uint16_t text;                                         ///< Offset des Textes im Textspeicher
+	uint16_t textLen;                                      ///< Länge des Textes (0 = keiner)
+	uint32_t arg;                                          ///< Timeout, Wartezeit bzw. Wiederholungen
+	int16_t target;                                        ///< Sprungziel (Schrittindex, -1 = keins)
+	uint8_t field;                                         ///< if: Feldindex
+	uint8_t captures[SerialPatternMatch::MAX_GROUPS - 1];  ///< expect: Feld je Gruppe (NO_FIELD = keins)
+};
+
+/**
+ * @class SerialScript
+ * @brief Übersetzt den Skripttext in Schritte, Sprungziele und Feldnamen.
+ */
+class SerialScript {
+   public:
+	static constexpr size_t MAX_STEPS = 48;               ///< Maximale Anzahl Schritte
+	static constexpr size_t MAX_TEXT = 1024;              ///< Textspeicher (Sendetexte, Muster, Meldungen)
+	static constexpr size_t MAX_LABELS = 16;              ///< Maximale Anzahl Sprungmarken
+	static constexpr size_t MAX_FIELDS = 8;               ///< Maximale Anzahl Felder
+	static constexpr size_t MAX_NAME = 16;                ///< Länge von Marken- und Feldnamen inkl. '\0'
+	static constexpr uint32_t DEFAULT_TIMEOUT_MS = 1000;  ///< Timeout von expect ohne Angabe
+	static constexpr uint32_t MAX_WAIT_MS = 60000;        ///< Obergrenze für Timeouts und Wartezeiten
+	static constexpr uint8_t NO_FIELD = 0xFF;             ///< Gruppe wird keinem Feld zugeordnet
+
+	SerialScript();
+
+	/**
+	 * @brief Übersetzt einen Skripttext.
+	 *
+	 * @param source Skripttext (nicht nullterminiert).
+	 * @param len Länge des Textes.
+	 * @return false bei einem Fehler (siehe error() und errorLine()).
+	 */
+	bool parse(const char *source, size_t len);
+
+	/**
+	 * @brief Anzahl der Schritte.
+	 */
+	size_t stepCount() const;
+
+	/**
+	 * @brief Gibt einen Schritt zurück.
+	 */
+	const SerialScriptStep &step(size_t index) const;
+
+	/**
+	 * @brief Zeiger auf den Text eines Schritts (nicht nullterminiert, Länge in textLen).
+	 */
+	const char *text(const SerialScriptStep &step) const;
+
+	/**
+	 * @brief Anzahl der Felder.
+	 */
+	size_t fieldCount() const;
+
+	/**
+	 * @brief Name eines Feldes.
+	 */
+	const char *fieldName(size_t index) const;
+
+	/**
+	 * @brief Fehlerbeschreibung der letzten parse() ("" = kein Fehler).
+	 */
+	const char *error() const;
+
+	/**
+	 * @brief Zeile des Fehlers (0 = keine Zeile).
+	 */
+	uint16_t errorLine() const;
+
+   private:
+	/**
+	 * @brief Sprungmarke; wird beim ersten Verweis oder bei der Definition angelegt.
+	 */
+	struct Label {
+		char name[MAX_NAME];  ///< Name
+		int16_t step;         ///< Schrittindex (-1 = noch nicht definiert)
+		uint16_t line;        ///< Zeile des ersten Verweises
+	};
+
+	SerialScriptStep _steps[MAX_STEPS];  ///< Schritte
+	size_t _stepCount;                   ///< Anzahl der Schritte
+	char _text[MAX_TEXT];                ///< Textspeicher
+	size_t _textLen;                     ///< Belegter Textspeicher
+	Label _labels[MAX_LABELS];           ///< Sprungmarken
+	size_t _labelCount;                  ///< Anzahl der Sprungmarken
+	char _fields[MAX_FIELDS][MAX_NAME];  ///< Feldnamen
+	size_t _fieldCount;                  ///< Anzahl der Felder
+	const char *_error;                  ///< Fehlerbeschreibung
+	uint16_t _errorLine;                 ///< Zeile des Fehlers
+
+	// Zustand des Übersetzers
+	const char *_line;  ///< Aktuelle Zeile
+	size_t _lineLen;    ///< Länge der Zeile
+	size_t _pos;        ///< Leseposition in der Zeile
+
+	bool parseLine(uint16_t lineNo);
+	void skipSpace();
+	bool atEnd();
+	bool word(const char *&start, size_t &len);
+	bool number(uint32_t &value, uint32_t max);
+	bool quoted(uint16_t &offset, uint16_t &len);
+	bool regex(uint16_t &offset, uint16_t &len);
+	int label(const char *name, size_t len, uint16_t lineNo);
+	int field(const char *name, size_t len);
+	bool fail(const char *msg);
+};
+
+#endif  // SERIALSCRIPT_H
@@ -0,0 +1,215 @@
+/**
+ * @file SerialScriptEngine.h
+ * @brief Führt Befehlsskripte (SerialScript) direkt auf dem ESP32 gegen das Gerät aus.
+ *
+ * Statt jeden Schritt einer Transaktion per WebSocket-Rundreise zu steuern, schickt der Client
+ * ein ganzes Skript (oder den Namen eines auf LittleFS abgelegten) und erhält am Ende ein
+ * Ergebnis mit Status und erfassten Feldern.
+ *
+ * Ablauf:
+ *  - submit() übernimmt den Quelltext threadsicher in einen Auftragsplatz; es wartet höchstens
+ *    ein Auftrag, während einer läuft,
+ *  - poll() läuft in einer eigenen Task: übersetzt den Auftrag, prüft alle Ausdrücke und führt
+ *    die Schritte aus, bis einer warten muss; die Rückgabe ist die empfohlene Wartezeit,
+ *  - onRx() bekommt aus der Bridge-Task alle empfangenen Bytes, aber nur während ein Skript
+ *    läuft; sie landen in einem Ringpuffer und von dort im Suchfenster von `expect`,
+ *  - gesendet wird über einen Callback (auf dem ESP32 die TX-Task der Bridge), das Ergebnis
+ *    geht an einen zweiten Callback.
+ *
+ * Ein Treffer von `expect` verbraucht das Fenster bis zum Trefferende; was danach kam, steht
+ * dem nächsten `expect` zur Verfügung. Läuft das Fenster über, werden die ältesten Bytes
+ * verworfen.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALSCRIPTENGINE_H
+#define SERIALSCRIPTENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ByteRing.h"
+#include "CriticalSection.h"
+#include "SerialPattern.h"
+#include "SerialScript.h"
+
+/**
+ * @enum SerialScriptStatus
+ * @brief Ausgang eines Skriptlaufs.
+ */
+enum SerialScriptStatus {
+	SCRIPT_OK,         ///< `done` oder Skriptende erreicht
+	SCRIPT_FAILED,     ///< `fail` ausgeführt
+	SCRIPT_TIMEOUT,    ///< `expect` ohne `else` abgelaufen oder Gesamtlaufzeit überschritten
+	SCRIPT_ERROR,      ///< Übersetzungsfehler oder Schrittlimit
+	SCRIPT_CANCELLED   ///< Per cancel() abgebrochen
+};
+
+/**
+ * @struct SerialScriptField
+ * @brief Erfasster Wert eines Feldes.
+ */
+struct SerialScriptField {
+	static constexpr size_t MAX_VALUE = 48;  ///< Maximale Länge eines Wertes inkl. '\0'
+	char name[SerialScript::MAX_NAME];       ///< Feldname
+	char value[MAX_VALUE];                   ///< Zuletzt erfasster Wert (gekürzt)
+	bool set;                                ///< Wert wurde erfasst
+};
+
+/**
+ * @struct SerialScriptResult
+ * @brief Ergebnis eines Skriptlaufs (wird an den Ergebnis-Callback übergeben).
+ */
+struct SerialScriptResult {
+	static constexpr size_t MAX_MESSAGE = 64;  ///< Maximale Länge der Meldung inkl. '\0'
+	static constexpr size_t MAX_TAIL = 64;     ///< Unverbrauchter Empfang bei Fehlern inkl. '\0'
+	uint32_t job;                              ///< Auftragsnummer
+	uint32_t client;                           ///< Auftraggeber (Client-ID)
+	char name[32];                             ///< Skriptname ("" = direkt übergeben)
+	SerialScriptStatus status;                 ///< Ausgang
+	char message[MAX_MESSAGE];                 ///< Meldung von `fail` bzw. Fehlerbeschreibung
+	uint16_t line;                             ///< Zeile des letzten ausgeführten Schritts
+	uint32_t elapsedMs;                        ///< Laufzeit
+	uint32_t steps;                            ///< Ausgeführte Schritte
+	uint32_t sentBytes;                        ///< Gesendete Bytes
+	uint32_t rxBytes;                          ///< Während des Laufs empfangene Bytes
+	char tail[MAX_TAIL];                       ///< Ende des unverbrauchten Empfangs (nur bei Fehlern)
+	SerialScriptField fields[SerialScript::MAX_FIELDS];  ///< Felder
+	size_t fieldCount;                                   ///< Anzahl der Felder
+};
+
+/**
+ * @struct SerialScriptStats
+ * @brief Zähler der Skriptausführung.
+ */
+struct SerialScriptStats {
+	uint32_t runs;       ///< Gestartete Läufe
+	uint32_t ok;         ///< Erfolgreiche Läufe
+	uint32_t failed;     ///< Läufe mit SCRIPT_FAILED, SCRIPT_TIMEOUT oder SCRIPT_ERROR
+	uint32_t cancelled;  ///< Abgebrochene Läufe
+	uint32_t rejected;   ///< Abgelehnte Aufträge (Auftragsplatz belegt, Skript zu groß)
+	uint32_t rxDropped;  ///< Wegen vollem Ringpuffer verworfene Empfangsbytes
+};
+
+/**
+ * @class SerialScriptEngine
+ * @brief Auftragsplatz, Empfangspuffer und Zustandsautomat der Skriptausführung.
+ */
+class SerialScriptEngine {
+   public:
+	static constexpr size_t MAX_SOURCE = 2048;          ///< Maximale Größe eines Skripttextes
+	static constexpr size_t RX_BUFFER = 1024;           ///< Ringpuffer zwischen Bridge- und Skript-Task
+	static constexpr size_t WINDOW = 1024;              ///< Suchfenster von `expect`
+	static constexpr uint32_t MAX_RUN_MS = 120000;      ///< Obergrenze der Gesamtlaufzeit
+	static constexpr uint32_t MAX_EXECUTED = 2000;      ///< Obergrenze ausgeführter Schritte pro Lauf
+	static constexpr uint32_t SEND_RETRY_MS = 10;       ///< Wartezeit bei voller Sendewarteschlange
+
+	/**
+	 * @brief Übergibt zu sendende Bytes (aus der Skript-Task).
+	 *
+	 * @return false, wenn sie gerade nicht angenommen werden können (wird erneut versucht).
+	 */
+	typedef bool (*SendFn)(void *ctx, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Meldet das Ergebnis eines Laufs (aus der Skript-Task).
+	 */
+	typedef void (*ResultSink)(void *ctx, const SerialScriptResult &result);
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param send Sende-Callback.
+	 * @param done Ergebnis-Callback (darf nullptr sein).
+	 * @param ctx Benutzerkontext beider Callbacks.
+	 */
+	SerialScriptEngine(SendFn send, ResultSink done, void *ctx);
+
+	/**
+	 * @brief Reiht ein Skript ein (threadsicher, blockiert nicht).
+	 *
+	 * @param client Auftraggeber; wird im Ergebnis zurückgegeben.
+	 * @param name Skriptname für das Ergebnis (darf nullptr sein).
+	 * @param source Skripttext.
+	 * @param len Länge des Textes.
+	 * @return Auftragsnummer oder 0, wenn bereits ein Auftrag wartet oder der Text zu groß ist.
+	 */
+	uint32_t submit(uint32_t client, const char *name, const char *source, size_t len);
+
+	/**
+	 * @brief Bricht einen wartenden oder laufenden Auftrag ab (threadsicher).
+	 *
+	 * @param job Auftragsnummer (0 = jeder).
+	 * @return false, wenn kein solcher Auftrag existiert.
+	 */
+	bool cancel(uint32_t job);
+
+	/**
+	 * @brief Übergibt empfangene Bytes (aus der Bridge-Task, blockiert nicht).
+	 *
+	 * @return true, wenn ein Skript läuft und die Skript-Task geweckt werden sollte.
+	 */
+	bool onRx(const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Ein Durchlauf der Skript-Task.
+	 *
+	 * @param nowMs Aktuelle Zeit in ms.
+	 * @return Empfohlene Wartezeit in ms (UINT32_MAX = kein Auftrag, bis submit() warten).
+	 */
+	uint32_t poll(uint32_t nowMs);
+
+	/**
+	 * @brief true, solange ein Auftrag wartet oder läuft.
+	 */
+	bool busy() const;
+
+	/**
+	 * @brief Gibt die Zähler zurück.
+	 */
+	SerialScriptStats stats() const;
+
+   private:
+	SendFn _send;      ///< Sende-Callback
+	ResultSink _done;  ///< Ergebnis-Callback
+	void *_ctx;        ///< Benutzerkontext
+
+	// Auftragsplatz (geschützt durch _lock)
+	char _pending[MAX_SOURCE];  ///< Quelltext des wartenden Auftrags
+	size_t _pendingLen;         ///< Länge des Quelltextes
+	uint32_t _pendingJob;       ///< Auftragsnummer (0 = Platz frei)
+	uint32_t _pendingClient;    ///< Auftraggeber
+	char _pendingName[32];      ///< Skriptname
+	uint32_t _nextJob;          ///< Letzte vergebene Auftragsnummer
+	uint32_t _cancelJob;        ///< Abzubrechender laufender Auftrag (0 = keiner)
+	uint32_t _runningJob;       ///< Laufender Auftrag (0 = keiner)
+	bool _parsing;              ///< Quelltext wird gerade übersetzt (Platz nicht beschreibbar)
+	bool _listening;            ///< Empfang wird gepuffert (ein Skript läuft)
+	uint8_t _rxMem[RX_BUFFER];  ///< Speicher des Ringpuffers
+	ByteRing _rx;               ///< Empfangene Bytes für die Skript-Task
+	SerialScriptStats _stats;   ///< Zähler
+	mutable CriticalSection _lock;  ///< Schutz von Auftragsplatz, Ringpuffer und Zählern
+
+	// Laufzustand (nur Skript-Task)
+	SerialScript _script;                    ///< Übersetztes Skript
+	SerialPattern _pattern;                  ///< Muster des aktuellen `expect`
+	SerialScriptResult _result;              ///< Ergebnis des laufenden Auftrags
+	bool _running;                           ///< Ein Auftrag läuft
+	size_t _pc;                              ///< Aktueller Schritt
+	bool _stepActive;                        ///< Warten des aktuellen Schritts hat begonnen
+	uint32_t _deadline;                      ///< Ende von `expect`/`wait`
+	uint32_t _started;                       ///< Startzeit des Laufs
+	uint8_t _retries[SerialScript::MAX_STEPS];  ///< Bisherige Sprünge je `retry`
+	uint8_t _window[WINDOW];                 ///< Suchfenster
+	size_t _windowLen;                       ///< Füllstand des Suchfensters
+
+	bool start(uint32_t nowMs);
+	void drain();
+	bool execute(uint32_t nowMs, uint32_t &wait);
+	void capture(const SerialScriptStep &step, const SerialPatternMatch &match);
+	void finish(SerialScriptStatus status, const char *message, uint32_t nowMs);
+};
+
+#endif  // SERIALSCRIPTENGINE_H
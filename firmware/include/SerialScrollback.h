@@ -0,0 +1,116 @@
+/**
+ * @file SerialScrollback.h
+ * @brief Verlaufspuffer der zuletzt empfangenen seriellen Daten für das Nachladen (Replay).
+ *
+ * Jeder an die Clients verteilte Datenblock wird zusätzlich mit seiner laufenden Nummer (seq),
+ * dem Zeitstempel und den SerialFrameFlags in einem Ringpuffer fester Größe abgelegt. Ist der
+ * Puffer voll, werden die ältesten Blöcke überschrieben.
+ *
+ * Gelesen wird über einen Cursor, der eine absolute Byteposition im Datenstrom darstellt. So
+ * lässt sich jederzeit prüfen, ob die Position inzwischen überschrieben wurde.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALSCROLLBACK_H
+#define SERIALSCROLLBACK_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ByteRing.h"
+
+/**
+ * @struct SerialScrollbackRecord
+ * @brief Kopf eines gespeicherten Datenblocks.
+ */
+struct SerialScrollbackRecord {
+	uint64_t timestamp;  ///< Empfangszeit in µs
+	uint32_t seq;        ///< Laufende Nummer des Blocks
+	uint16_t len;        ///< Länge der Nutzdaten
+	uint16_t flags;      ///< SerialFrameFlags
+};
+
+/**
+ * @class SerialScrollback
+ * @brief Ringpuffer mit seq-markierten Datenblöcken. Nicht threadsicher.
+ */
+class SerialScrollback {
+   public:
+	/**
+	 * @brief Erzeugt einen Verlaufspuffer ohne Speicher (nimmt nichts auf).
+	 */
+	SerialScrollback();
+
+	/**
+	 * @brief Setzt den Speicherbereich und leert den Puffer.
+	 *
+	 * @param buf Speicherbereich (Besitz bleibt beim Aufrufer).
+	 * @param capacity Größe in Bytes.
+	 */
+	void reset(uint8_t *buf, size_t capacity);
+
+	/**
+	 * @brief Legt einen Datenblock ab und verdrängt bei Bedarf die ältesten.
+	 *
+	 * Blöcke, die größer als der gesamte Puffer sind, werden ignoriert.
+	 */
+	void append(uint32_t seq, uint64_t timestamp, uint16_t flags, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Cursor auf den ältesten gespeicherten Block.
+	 */
+	uint64_t begin() const;
+
+	/**
+	 * @brief Cursor hinter den neuesten Block.
+	 */
+	uint64_t end() const;
+
+	/**
+	 * @brief Ist der Cursor noch nicht überschrieben?
+	 */
+	bool valid(uint64_t cursor) const;
+
+	/**
+	 * @brief Cursor auf den ersten Block mit einer Nummer ab `seq`.
+	 *
+	 * @param seq Gewünschte Startnummer.
+	 * @param missing Ausgabe: Anzahl der Blöcke vor dem ältesten gespeicherten, die fehlen.
+	 * @return Cursor (end(), wenn alle Blöcke älter als `seq` sind).
+	 */
+	uint64_t seekSeq(uint32_t seq, uint32_t &missing) const;
+
+	/**
+	 * @brief Cursor auf den ältesten Block, ab dem höchstens `bytes` Nutzdaten folgen.
+	 */
+	uint64_t seekTail(size_t bytes) const;
+
+	/**
+	 * @brief Liest den Block am Cursor und setzt den Cursor auf den nächsten.
+	 *
+	 * @param cursor Position (muss valid() sein).
+	 * @param rec Ausgabe: Kopf des Blocks.
+	 * @param out Zielpuffer für die Nutzdaten.
+	 * @param cap Größe des Zielpuffers; längere Blöcke werden abgeschnitten.
+	 * @return false am Ende oder bei ungültigem Cursor.
+	 */
+	bool read(uint64_t &cursor, SerialScrollbackRecord &rec, uint8_t *out, size_t cap) const;
+
+	uint32_t firstSeq() const;  ///< Nummer des ältesten Blocks (nur gültig, wenn nicht leer)
+	uint32_t count() const;     ///< Anzahl gespeicherter Blöcke
+	size_t size() const;        ///< Belegte Bytes inkl. Verwaltungsdaten
+	size_t capacity() const;    ///< Gesamtgröße
+
+   private:
+	ByteRing _ring;      ///< Speicher der Blöcke
+	uint64_t _dropped;   ///< Absolute Position des ältesten Bytes
+	uint32_t _count;     ///< Anzahl gespeicherter Blöcke
+	uint32_t _firstSeq;  ///< Nummer des ältesten Blocks
+
+	bool peekAt(uint64_t cursor, SerialScrollbackRecord &rec) const;
+	void dropOldest();
+};
+
+#endif  // SERIALSCROLLBACK_H
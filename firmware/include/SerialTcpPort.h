@@ -0,0 +1,59 @@
+/**
+ * @file SerialTcpPort.h
+ * @brief Serielle Seite des TCP-Servers (Schreiben, Baudrate, Puffer leeren).
+ *
+ * Der SerialTcpServer greift ausschließlich über diese Schnittstelle auf die UART zu. Auf dem
+ * ESP32 implementiert die SerialBridge sie (Versand über die TX-Task), in den nativen
+ * Unit-Tests eine UART auf einem Pseudo-Terminal (`test/support/PtyUart.h`).
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALTCPPORT_H
+#define SERIALTCPPORT_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class SerialTcpPort
+ * @brief UART aus Sicht eines TCP-Clients.
+ */
+class SerialTcpPort {
+   public:
+	virtual ~SerialTcpPort() {}
+
+	/**
+	 * @brief Reiht Bytes zum Senden über die UART ein.
+	 *
+	 * Darf nicht blockieren. Wird weniger als `len` übernommen, liefert der Server den Rest
+	 * später erneut an und liest solange nicht weiter vom Socket (TCP-Gegendruck).
+	 *
+	 * @return Anzahl der übernommenen Bytes.
+	 */
+	virtual size_t write(const uint8_t *data, size_t len) = 0;
+
+	/**
+	 * @brief Setzt die Baudrate.
+	 *
+	 * @param baud Gewünschte Rate.
+	 * @return Danach aktive Rate (unverändert, wenn `baud` nicht zulässig ist).
+	 */
+	virtual uint32_t setBaud(uint32_t baud) = 0;
+
+	/**
+	 * @brief Aktuell eingestellte Baudrate.
+	 */
+	virtual uint32_t baud() = 0;
+
+	/**
+	 * @brief Verwirft empfangene bzw. noch nicht gesendete Bytes.
+	 *
+	 * @param rx Empfangspuffer leeren.
+	 * @param tx Sendepuffer leeren.
+	 */
+	virtual void purge(bool rx, bool tx) = 0;
+};
+
+#endif  // SERIALTCPPORT_H
@@ -0,0 +1,202 @@
+/**
+ * @file SerialTcpServer.h
+ * @brief TCP-Server für den direkten Zugriff auf eine UART (roh und RFC 2217).
+ *
+ * Desktop-Werkzeuge (Terminalprogramme, Flash-Tools, Python-Skripte) verbinden sich ohne
+ * JSON direkt mit der UART einer SerialBridge:
+ *  - Roh-Port: Bytes gehen unverändert in beide Richtungen (z. B. `nc`, `socat`),
+ *  - RFC-2217-Port: Telnet mit COM-Port-Steuerung, die Baudrate lässt sich in-band setzen
+ *    (z. B. pyserial `rfc2217://`, com0com/HW VSP).
+ *
+ * Pro Kanal darf immer nur ein Client schreiben. Der erste verbundene Client erhält das
+ * Schreibrecht, alle weiteren sind Mithörer: Sie bekommen dieselben Empfangsdaten, ihre
+ * gesendeten Bytes werden verworfen und gezählt. Trennt sich der Schreiber, geht das Recht an
+ * den am längsten verbundenen Mithörer über.
+ *
+ * Empfangene UART-Daten übergibt die Bridge-Task mit onRx(); sie werden pro Client in einen
+ * Ringpuffer kopiert (bei vollem Puffer verworfen und gezählt) und von poll() in der
+ * Server-Task versendet. Kann die UART-Seite Daten des Schreibers nicht sofort übernehmen,
+ * liest der Server von diesem Socket erst weiter, wenn der Rest übergeben ist; der Gegendruck
+ * erreicht den Client über das TCP-Fenster.
+ *
+ * Die Sockets laufen über die BSD-Schnittstelle (lwIP auf dem ESP32, POSIX im `env:native`).
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALTCPSERVER_H
+#define SERIALTCPSERVER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ByteRing.h"
+#include "CriticalSection.h"
+#include "Rfc2217Codec.h"
+#include "SerialTcpPort.h"
+
+/**
+ * @enum SerialTcpMode
+ * @brief Protokoll einer TCP-Verbindung.
+ */
+enum SerialTcpMode {
+	SERIAL_TCP_RAW,     ///< Rohdaten ohne Protokoll
+	SERIAL_TCP_RFC2217  ///< Telnet mit COM-PORT-OPTION
+};
+
+/**
+ * @struct SerialTcpConfig
+ * @brief Ports des Servers.
+ */
+struct SerialTcpConfig {
+	bool enabled;          ///< Server aktiv
+	uint16_t rawPort;      ///< Port für Rohdaten (0 = aus)
+	uint16_t rfc2217Port;  ///< Port für RFC 2217 (0 = aus)
+};
+
+/**
+ * @struct SerialTcpClientInfo
+ * @brief Zustand einer Verbindung für Statusmeldungen.
+ */
+struct SerialTcpClientInfo {
+	uint32_t id;         ///< Laufende Verbindungsnummer
+	uint32_t addr;       ///< IPv4-Adresse des Clients (Netzwerk-Bytefolge)
+	uint16_t port;       ///< Quellport des Clients
+	SerialTcpMode mode;  ///< Protokoll
+	bool writer;         ///< Client hat das Schreibrecht
+	uint32_t rxBytes;    ///< An den Client gesendete UART-Daten
+	uint32_t txBytes;    ///< Vom Client an die UART übergebene Bytes
+	uint32_t dropped;    ///< Wegen vollem Puffer verworfene UART-Daten
+	uint32_t ignored;    ///< Verworfene Bytes eines Mithörers
+};
+
+/**
+ * @struct SerialTcpStats
+ * @brief Zähler des Servers.
+ */
+struct SerialTcpStats {
+	uint32_t accepted;  ///< Angenommene Verbindungen
+	uint32_t rejected;  ///< Abgewiesene Verbindungen (alle Plätze belegt)
+	uint32_t dropped;   ///< Verworfene UART-Daten (alle Clients)
+	uint32_t ignored;   ///< Verworfene Bytes von Mithörern (alle Clients)
+};
+
+/**
+ * @class SerialTcpServer
+ * @brief Roh- und RFC-2217-Server für eine UART; `poll()` läuft in einer eigenen Task.
+ */
+class SerialTcpServer {
+   public:
+	static constexpr size_t MAX_CLIENTS = 4;            ///< Gleichzeitige Verbindungen pro Kanal
+	static constexpr size_t CLIENT_BUFFER = 4096;       ///< Ringpuffer für UART-Daten pro Client
+	static constexpr size_t IO_CHUNK = 512;             ///< Bytes pro recv()/send()
+	static constexpr uint32_t ACTIVE_POLL_MS = 5;       ///< Wartezeit von poll() mit Clients
+	static constexpr uint32_t IDLE_POLL_MS = 250;       ///< Wartezeit von poll() ohne Clients
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param port Serielle Seite (Schreiben, Baudrate, Puffer leeren).
+	 */
+	explicit SerialTcpServer(SerialTcpPort &port);
+
+	/**
+	 * @brief Schließt alle Sockets.
+	 */
+	~SerialTcpServer();
+
+	/**
+	 * @brief Öffnet die Ports; ein bereits laufender Server wird vorher beendet.
+	 *
+	 * @param rawPort Port für Rohdaten (0 = aus).
+	 * @param rfc2217Port Port für RFC 2217 (0 = aus).
+	 * @return false, wenn ein Port nicht geöffnet werden konnte (es bleibt dann keiner offen).
+	 */
+	bool begin(uint16_t rawPort, uint16_t rfc2217Port);
+
+	/**
+	 * @brief Trennt alle Clients und schließt die Ports.
+	 */
+	void end();
+
+	/**
+	 * @brief true, solange mindestens ein Port offen ist.
+	 */
+	bool running() const;
+
+	/**
+	 * @brief Übergibt empfangene UART-Daten an alle Clients (aus der Bridge-Task).
+	 *
+	 * Kopiert nur in die Ringpuffer; blockiert nicht.
+	 *
+	 * @param data Empfangene Bytes.
+	 * @param len Anzahl der Bytes.
+	 */
+	void onRx(const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Ein Durchlauf der Server-Task: Verbindungen annehmen, lesen, senden.
+	 *
+	 * @param timeoutMs Maximale Wartezeit auf Socket-Ereignisse.
+	 * @return Empfohlene Wartezeit bis zum nächsten Aufruf (ACTIVE_POLL_MS oder IDLE_POLL_MS).
+	 */
+	uint32_t poll(uint32_t timeoutMs);
+
+	/**
+	 * @brief Anzahl der verbundenen Clients.
+	 */
+	size_t clientCount() const;
+
+	/**
+	 * @brief Liefert den Zustand aller Verbindungen.
+	 *
+	 * @param out Zielfeld.
+	 * @param max Größe des Zielfelds.
+	 * @return Anzahl der eingetragenen Verbindungen.
+	 */
+	size_t clients(SerialTcpClientInfo *out, size_t max) const;
+
+	/**
+	 * @brief Gibt die Zähler zurück.
+	 */
+	SerialTcpStats stats() const;
+
+   private:
+	/**
+	 * @struct Client
+	 * @brief Zustand einer Verbindung.
+	 */
+	struct Client {
+		int fd;                   ///< Socket (-1 = frei)
+		SerialTcpClientInfo info; ///< Statusdaten
+		ByteRing rx;              ///< UART-Daten, die noch an den Client gehen
+		uint8_t *mem;             ///< Speicher für Ringpuffer, Sendepuffer und Rest des Schreibers
+		uint8_t *out;             ///< Sendepuffer (maskierte Daten, Telnet-Antworten)
+		size_t outLen;            ///< Füllstand von out
+		size_t outPos;            ///< Bereits gesendete Bytes aus out
+		uint8_t *pending;         ///< Noch nicht an die UART übergebene Bytes des Schreibers
+		size_t pendingLen;        ///< Füllstand von pending
+		Rfc2217Codec *codec;      ///< Telnet-Zustand (nur RFC 2217)
+	};
+	static constexpr size_t OUT_BUFFER = 2 * IO_CHUNK;  ///< Maskieren verdoppelt höchstens
+
+	SerialTcpPort &_port;               ///< Serielle Seite
+	int _listenRaw;                     ///< Socket des Roh-Ports (-1 = aus)
+	int _listenRfc;                     ///< Socket des RFC-2217-Ports (-1 = aus)
+	Client _clients[MAX_CLIENTS];       ///< Verbindungen
+	int _writer;                        ///< Index des Schreibers (-1 = keiner)
+	uint32_t _nextId;                   ///< Nächste Verbindungsnummer
+	SerialTcpStats _stats;              ///< Zähler
+	mutable CriticalSection _lock;      ///< Schutz von Ringpuffern und Zählern (Bridge- vs. Server-Task)
+
+	static int listenOn(uint16_t port);
+	void acceptClient(int listenFd, SerialTcpMode mode);
+	void closeClient(size_t index);
+	void receive(size_t index);
+	bool flushPending(Client &c);
+	bool fillOut(Client &c);
+	void transmit(size_t index);
+};
+
+#endif  // SERIALTCPSERVER_H
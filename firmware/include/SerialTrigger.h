@@ -0,0 +1,157 @@
+/**
+ * @file SerialTrigger.h
+ * @brief Regeln, die auf bestimmte Meldungen im seriellen Datenstrom reagieren.
+ *
+ * Eine Regel nennt einen Text (Teilstring oder Zeilenanfang, optional ohne Groß-/
+ * Kleinschreibung) und die Aktionen, die eine passende Zeile auslöst: Alarm an alle Clients,
+ * Eintrag im Log, Status im StatusHandler, Schnappschuss des Verlaufspuffers. Die Aktionen
+ * selbst führt die SerialBridge aus; diese Klasse entscheidet nur, welche Regeln feuern.
+ *
+ * Die Texte aller Regeln werden einmal in einen gemeinsamen SerialMultiMatch übersetzt; jede
+ * Zeile wird also in einem Durchlauf gegen alle Regeln geprüft, die Kosten pro Zeile wachsen
+ * kaum mit der Anzahl der Regeln. Nach einem Auslösen schweigt eine Regel für `cooldownMs`,
+ * Treffer werden trotzdem gezählt.
+ *
+ * onLine() läuft in der Bridge-Task; Regeln und Zähler sind threadsicher lesbar.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALTRIGGER_H
+#define SERIALTRIGGER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "CriticalSection.h"
+#include "SerialMultiMatch.h"
+
+/**
+ * @enum SerialTriggerAction
+ * @brief Aktionen einer Regel (Bitmaske).
+ */
+enum SerialTriggerAction : uint8_t {
+	TRIGGER_ACTION_ALERT = 0x01,     ///< `serial`/`alert` an alle Clients (vorrangig)
+	TRIGGER_ACTION_LOG = 0x02,       ///< Eintrag im Geräte-Log
+	TRIGGER_ACTION_STATUS = 0x04,    ///< Status im StatusHandler (LED) bis zur Quittierung
+	TRIGGER_ACTION_SNAPSHOT = 0x08,  ///< Ende des Verlaufspuffers festhalten
+	TRIGGER_ACTION_ALL = 0x0F        ///< Alle gültigen Bits
+};
+
+/**
+ * @enum SerialTriggerLevel
+ * @brief Schwere einer Regel (Log-Level, Alarmstatus und LED-Status).
+ */
+enum SerialTriggerLevel : uint8_t {
+	TRIGGER_INFO,     ///< Hinweis
+	TRIGGER_WARNING,  ///< Warnung
+	TRIGGER_ERROR     ///< Fehler
+};
+
+/**
+ * @struct SerialTriggerRule
+ * @brief Eine Regel.
+ */
+struct SerialTriggerRule {
+	static constexpr size_t MAX_NAME = 24;  ///< Maximale Länge des Namens inkl. '\0'
+	static constexpr size_t MAX_TEXT = 64;  ///< Maximale Länge des Textes inkl. '\0'
+
+	char name[MAX_NAME];  ///< Name der Regel
+	char text[MAX_TEXT];  ///< Gesuchter Text
+	bool prefix;          ///< true = nur am Zeilenanfang
+	bool ignoreCase;      ///< Groß-/Kleinschreibung ignorieren
+	uint8_t actions;      ///< SerialTriggerAction (Bitmaske)
+	uint8_t level;        ///< SerialTriggerLevel
+	uint32_t cooldownMs;  ///< Mindestabstand zwischen zwei Auslösungen
+};
+
+/**
+ * @struct SerialTriggerConfig
+ * @brief Alle Regeln eines Kanals.
+ */
+struct SerialTriggerConfig {
+	static constexpr size_t MAX_RULES = 32;  ///< Maximale Anzahl Regeln (Bitmaske)
+	SerialTriggerRule rules[MAX_RULES];      ///< Regeln
+	size_t count;                            ///< Anzahl der Regeln (0 = aus)
+};
+
+/**
+ * @struct SerialTriggerStats
+ * @brief Zähler einer Regel.
+ */
+struct SerialTriggerStats {
+	uint32_t hits;    ///< Passende Zeilen
+	uint32_t fired;   ///< Auslösungen (Treffer außerhalb der Sperrzeit)
+	uint32_t lastMs;  ///< Zeitpunkt der letzten Auslösung
+};
+
+/**
+ * @class SerialTrigger
+ * @brief Übersetzte Regeln eines Kanals; onLine() liefert die ausgelösten Regeln einer Zeile.
+ */
+class SerialTrigger {
+   public:
+	static constexpr uint32_t DEFAULT_COOLDOWN_MS = 1000;  ///< Voreinstellung der Sperrzeit
+	static constexpr uint32_t MAX_COOLDOWN_MS = 3600000;   ///< Größte Sperrzeit (1 h)
+
+	SerialTrigger();
+
+	/**
+	 * @brief Prüft und übersetzt die Regeln; Zähler beginnen bei 0.
+	 *
+	 * @param cfg Regeln.
+	 * @param error Puffer für die Fehlerbeschreibung.
+	 * @param size Größe des Puffers.
+	 * @return false bei ungültiger Regel oder vollem Musterspeicher; der Zustand ist dann leer.
+	 */
+	bool build(const SerialTriggerConfig &cfg, char *error, size_t size);
+
+	/**
+	 * @brief Prüft eine Zeile gegen alle Regeln.
+	 *
+	 * @param line Zeile.
+	 * @param len Länge der Zeile.
+	 * @param nowMs Aktuelle Zeit in ms.
+	 * @return Bitmaske der ausgelösten Regeln (Treffer außerhalb ihrer Sperrzeit).
+	 */
+	uint32_t onLine(const uint8_t *line, size_t len, uint32_t nowMs);
+
+	/**
+	 * @brief Anzahl der Regeln.
+	 */
+	size_t count() const;
+
+	/**
+	 * @brief Kopie einer Regel und ihrer Zähler (threadsicher).
+	 *
+	 * @return false bei ungültigem Index.
+	 */
+	bool rule(size_t index, SerialTriggerRule &rule, SerialTriggerStats &stats) const;
+
+	/**
+	 * @brief Regel ohne Kopie (nur Bridge-Task).
+	 */
+	const SerialTriggerRule &rule(size_t index) const;
+
+	/**
+	 * @brief Anzahl der geprüften Zeilen.
+	 */
+	uint32_t lines() const;
+
+	/**
+	 * @brief Anzahl der verschiedenen Muster im Automaten.
+	 */
+	size_t patterns() const;
+
+   private:
+	SerialTriggerConfig _cfg;                               ///< Regeln
+	SerialMultiMatch _match;                                ///< Texte aller Regeln
+	uint8_t _pattern[SerialTriggerConfig::MAX_RULES];       ///< Musternummer je Regel
+	SerialTriggerStats _stats[SerialTriggerConfig::MAX_RULES];  ///< Zähler je Regel
+	uint32_t _armed;                                        ///< Regeln, die schon ausgelöst haben
+	uint32_t _lines;                                        ///< Geprüfte Zeilen
+	mutable CriticalSection _lock;                          ///< Schutz der Zähler
+};
+
+#endif  // SERIALTRIGGER_H
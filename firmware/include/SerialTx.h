@@ -0,0 +1,178 @@
+/**
+ * @file SerialTx.h
+ * @brief Sendewarteschlange mit eigener Task für die serielle Schnittstelle.
+ *
+ * WebSocket-Handler übergeben zu sendende Daten nur noch an die Warteschlange und kehren sofort
+ * zurück; das eigentliche Schreiben auf die UART übernimmt `service()` in der TX-Task. Dort
+ * werden Zeichen- und Zeilenabstände eingehalten, der Sendetreiber eines RS-485-Transceivers
+ * geschaltet und nach jedem Auftrag gewartet, bis das letzte Bit die Leitung verlassen hat.
+ * Anschließend meldet ein Callback den Auftrag als übertragen.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef SERIALTX_H
+#define SERIALTX_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ByteRing.h"
+#include "CriticalSection.h"
+#include "TaskMutex.h"
+#include "UartPort.h"
+
+/**
+ * @struct SerialTxConfig
+ * @brief Einstellungen des Sendepfads.
+ */
+struct SerialTxConfig {
+	SerialFlowControl flow;  ///< Flusskontrolle
+	uint32_t charDelayUs;    ///< Pause nach jedem Zeichen (0 = aus)
+	uint32_t lineDelayMs;    ///< Pause nach jedem '\n' (0 = aus)
+	bool rs485;              ///< DE-Pin um jeden Sendeblock schalten?
+	uint32_t deLeadUs;       ///< Vorlauf zwischen DE ein und erstem Bit
+	uint32_t deTailUs;       ///< Nachlauf zwischen letztem Bit und DE aus
+};
+
+/**
+ * @struct SerialTxStats
+ * @brief Zähler des Sendepfads.
+ */
+struct SerialTxStats {
+	uint32_t jobs;        ///< Angenommene Aufträge
+	uint32_t done;        ///< Vollständig übertragene Aufträge
+	uint32_t rejected;    ///< Wegen voller Warteschlange abgelehnte Aufträge
+	uint32_t bytes;       ///< Übertragene Bytes
+	uint32_t txTimeouts;  ///< Aufträge, deren Abschluss nicht bestätigt werden konnte
+	size_t queuedBytes;   ///< Aktuell wartende Bytes (inkl. Verwaltungsdaten)
+	size_t maxQueued;     ///< Höchster Füllstand der Warteschlange
+};
+
+/**
+ * @class SerialTx
+ * @brief Threadsichere Sendewarteschlange; `service()` läuft in der TX-Task.
+ */
+class SerialTx {
+   public:
+	static constexpr size_t QUEUE_BYTES = 8192;            ///< Größe der Warteschlange
+	static constexpr size_t CHUNK = 256;                   ///< Bytes pro Schreibvorgang
+	static constexpr uint32_t TX_DONE_TIMEOUT_MS = 1000;   ///< Maximale Wartezeit auf das Sendeende
+	static constexpr uint32_t MAX_CHAR_DELAY_US = 100000;  ///< Obergrenze Zeichenabstand
+	static constexpr uint32_t MAX_LINE_DELAY_MS = 10000;   ///< Obergrenze Zeilenabstand
+	static constexpr uint32_t MAX_DE_DELAY_US = 10000;     ///< Obergrenze DE-Vor-/Nachlauf
+
+	/**
+	 * @brief Callback nach vollständiger Übertragung eines Auftrags (aus der TX-Task).
+	 *
+	 * @param ctx Benutzerkontext.
+	 * @param client Beim Einreihen übergebene Client-ID.
+	 * @param job Auftragsnummer.
+	 * @param bytes Anzahl der übertragenen Bytes.
+	 * @param ok false, wenn das Sendeende nicht bestätigt werden konnte.
+	 */
+	typedef void (*DoneSink)(void *ctx, uint32_t client, uint32_t job, size_t bytes, bool ok);
+
+	/**
+	 * @brief Mithörer für jeden geschriebenen Block (aus der TX-Task, z. B. für den Mitschnitt).
+	 *
+	 * @param ctx Benutzerkontext.
+	 * @param data Geschriebene Bytes.
+	 * @param len Anzahl der Bytes.
+	 */
+	typedef void (*TapFn)(void *ctx, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param port UART, auf die geschrieben wird.
+	 * @param done Callback nach der Übertragung (darf nullptr sein).
+	 * @param ctx Benutzerkontext.
+	 */
+	SerialTx(UartPort &port, DoneSink done, void *ctx);
+
+	/**
+	 * @brief Registriert einen Mithörer für gesendete Bytes.
+	 */
+	void onTransmit(TapFn tap, void *ctx);
+
+	/**
+	 * @brief Prüft Einstellungen auf Grenzwerte und gültige Kombinationen.
+	 *
+	 * RS-485 und RTS/CTS schließen sich aus, weil beide den RTS-Pin belegen.
+	 */
+	static bool validate(const SerialTxConfig &config);
+
+	/**
+	 * @brief Übernimmt neue Einstellungen und setzt die Flusskontrolle der UART.
+	 *
+	 * Nur aus der TX-Task oder vor deren Start aufrufen.
+	 *
+	 * @return false bei ungültigen Einstellungen oder nicht unterstützter Flusskontrolle.
+	 */
+	bool configure(const SerialTxConfig &config);
+
+	/**
+	 * @brief Gibt die aktiven Einstellungen zurück.
+	 */
+	const SerialTxConfig &config() const;
+
+	/**
+	 * @brief Reiht Daten zum Senden ein (threadsicher, wartet nie auf die Leitung).
+	 *
+	 * @param client Client-ID, die im Callback zurückgegeben wird.
+	 * @param data Zu sendende Bytes.
+	 * @param len Anzahl der Bytes.
+	 * @return Auftragsnummer (> 0) oder 0, wenn die Warteschlange voll ist.
+	 */
+	uint32_t submit(uint32_t client, const uint8_t *data, size_t len);
+
+	/**
+	 * @brief Überträgt alle wartenden Aufträge (aus der TX-Task).
+	 *
+	 * @return Anzahl der abgeschlossenen Aufträge.
+	 */
+	size_t service();
+
+	/**
+	 * @brief Verwirft alle noch nicht begonnenen Aufträge.
+	 */
+	void clear();
+
+	/**
+	 * @brief Kopie der Zähler.
+	 */
+	SerialTxStats stats() const;
+
+   private:
+	/**
+	 * @brief Verwaltungsdaten vor jedem Auftrag in der Warteschlange.
+	 */
+	struct JobHeader {
+		uint32_t job;     ///< Auftragsnummer
+		uint32_t client;  ///< Client-ID
+		uint32_t len;     ///< Länge der Nutzdaten
+	};
+
+	UartPort &_port;                 ///< Ziel-UART
+	DoneSink _done;                  ///< Abschluss-Callback
+	void *_ctx;                      ///< Benutzerkontext
+	TapFn _tap;                      ///< Mithörer für gesendete Bytes
+	void *_tapCtx;                   ///< Kontext des Mithörers
+	SerialTxConfig _config;          ///< Aktive Einstellungen
+	uint8_t _queueBuf[QUEUE_BYTES];  ///< Speicher der Warteschlange
+	ByteRing _queue;                 ///< Warteschlange aus JobHeader + Nutzdaten
+	uint8_t _chunk[CHUNK];           ///< Arbeitspuffer der TX-Task
+	uint32_t _nextJob;               ///< Letzte vergebene Auftragsnummer
+	bool _deOn;                      ///< DE-Pin aktuell aktiv?
+	SerialTxStats _stats;            ///< Zähler
+	mutable TaskMutex _queueLock;    ///< Schutz der Warteschlange (Mutex: submit() kopiert ganze Aufträge)
+	mutable CriticalSection _lock;   ///< Schutz der Zähler
+
+	void transmit(const uint8_t *data, size_t len);
+	void emit(const uint8_t *data, size_t len);
+	bool finishBurst();
+};
+
+#endif  // SERIALTX_H
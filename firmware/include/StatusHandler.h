@@ -43,7 +43,9 @@ enum SystemStatus {
 	WIFI_AP_DEVICE_AVAILABLE,  ///< Mindestens ein Gerät verbunden (gelb aus)
 	SERIAL_NOT_CONNECTED,      ///< Serielle Verbindung fehlt (gelb blinkend, 1x)
 	SERIAL_CONNECTED,          ///< Serielle Verbindung vorhanden (grün dauerhaft)
-	SERIAL_SEND                ///< Daten werden über Serial versendet (grün blinkend, 3x)
+	SERIAL_SEND,               ///< Daten werden über Serial versendet (grün blinkend, 3x)
+	SERIAL_TRIGGER_WARNING,    ///< Regel auf dem seriellen Datenstrom hat gewarnt (gelb schnell blinkend, 5x)
+	SERIAL_TRIGGER_ERROR       ///< Regel auf dem seriellen Datenstrom meldet Fehler (rot schnell blinkend, 5x)
 };
 
 /**
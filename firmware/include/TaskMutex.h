@@ -0,0 +1,61 @@
+/**
+ * @file TaskMutex.h
+ * @brief Gegenseitiger Ausschluss zwischen Tasks für längere Abschnitte.
+ *
+ * Gegenstück zu CriticalSection für Abschnitte, die größere Datenmengen kopieren: Auf dem ESP32
+ * ein FreeRTOS-Mutex (wie `_drainLock` im LLog), sodass Interrupts und Tasks auf dem anderen
+ * Kern währenddessen weiterlaufen; im `env:native` ein `std::mutex`. Nicht aus ISRs verwenden
+ * und nicht innerhalb eines `portENTER_CRITICAL`-Abschnitts sperren.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef TASKMUTEX_H
+#define TASKMUTEX_H
+
+#ifdef UNIT_TEST
+#include <mutex>
+#else
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif
+
+/**
+ * @class TaskMutex
+ * @brief Sperre für Abschnitte zwischen Tasks, in denen kopiert werden darf.
+ */
+class TaskMutex {
+   public:
+#ifdef UNIT_TEST
+	void enter() {
+		_mutex.lock();
+	}
+	void exit() {
+		_mutex.unlock();
+	}
+
+   private:
+	std::mutex _mutex;  ///< Host-Sperre
+#else
+	TaskMutex() : _mutex(xSemaphoreCreateMutex()) {
+	}
+	~TaskMutex() {
+		vSemaphoreDelete(_mutex);
+	}
+	TaskMutex(const TaskMutex &) = delete;
+	TaskMutex &operator=(const TaskMutex &) = delete;
+
+	void enter() {
+		xSemaphoreTake(_mutex, portMAX_DELAY);
+	}
+	void exit() {
+		xSemaphoreGive(_mutex);
+	}
+
+   private:
+	SemaphoreHandle_t _mutex;  ///< FreeRTOS-Mutex
+#endif
+};
+
+#endif  // TASKMUTEX_H
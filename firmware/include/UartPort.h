@@ -0,0 +1,173 @@
+/**
+ * @file UartPort.h
+ * @brief Abstrakte Schnittstelle auf eine UART, wie sie von der SerialBridge verwendet wird.
+ *
+ * Die SerialBridge greift nicht direkt auf `HardwareSerial` oder den ESP-IDF-Treiber zu, sondern
+ * ausschließlich über diese Schnittstelle. Auf dem ESP32 wird sie von `EspUartPort` implementiert,
+ * in den nativen Unit-Tests von einer Fake-UART mit virtueller Uhr (`test/support/FakeUart.h`).
+ *
+ * Die Header-Datei ist bewusst frei von Arduino-Abhängigkeiten, damit sie im `env:native`
+ * übersetzt werden kann.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef UARTPORT_H
+#define UARTPORT_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum UartEventType
+ * @brief Ereignisse, die der UART-Treiber über seine Event-Queue meldet.
+ */
+enum UartEventType {
+	RX_EVT_NONE,           ///< Kein Ereignis
+	RX_EVT_DATA,           ///< Neue Daten im Ringpuffer
+	RX_EVT_FIFO_OVERFLOW,  ///< Hardware-FIFO übergelaufen, Daten verloren
+	RX_EVT_BUFFER_FULL,    ///< Treiber-Ringpuffer voll, Daten verloren
+	RX_EVT_BREAK,          ///< Break-Signal auf der RX-Leitung erkannt
+	RX_EVT_PATTERN,        ///< Konfiguriertes Muster (Zeilenende) erkannt
+	RX_EVT_TIMEOUT         ///< Kein Ereignis innerhalb der Wartezeit
+};
+
+/**
+ * @struct UartEvent
+ * @brief Ein einzelnes Ereignis aus der Event-Queue des UART-Treibers.
+ */
+struct UartEvent {
+	UartEventType type;  ///< Art des Ereignisses
+	size_t size;         ///< Anzahl der betroffenen Bytes (nur bei RX_EVT_DATA)
+};
+
+/**
+ * @enum SerialFlowControl
+ * @brief Flusskontrolle für den Sendepfad.
+ */
+enum SerialFlowControl {
+	SERIAL_FLOW_NONE,     ///< Keine Flusskontrolle
+	SERIAL_FLOW_RTS_CTS,  ///< Hardware-Flusskontrolle über RTS/CTS
+	SERIAL_FLOW_XON_XOFF  ///< Software-Flusskontrolle über XON/XOFF
+};
+
+/**
+ * @class UartPort
+ * @brief Minimale Schnittstelle für Empfang, Versand und ereignisgesteuertes Warten auf einer UART.
+ */
+class UartPort {
+   public:
+	virtual ~UartPort() {}
+
+	/**
+	 * @brief (Re-)Initialisiert die Schnittstelle mit der angegebenen Baudrate.
+	 *
+	 * @param baud Baudrate.
+	 * @return true, wenn die Schnittstelle betriebsbereit ist.
+	 */
+	virtual bool begin(uint32_t baud) = 0;
+
+	/**
+	 * @brief Anzahl der sofort lesbaren Bytes.
+	 */
+	virtual size_t available() = 0;
+
+	/**
+	 * @brief Liest bis zu `len` Bytes ohne zu blockieren.
+	 *
+	 * @return Anzahl der tatsächlich gelesenen Bytes.
+	 */
+	virtual size_t read(uint8_t *buf, size_t len) = 0;
+
+	/**
+	 * @brief Schreibt `len` Bytes auf die Schnittstelle.
+	 *
+	 * @return Anzahl der übernommenen Bytes.
+	 */
+	virtual size_t write(const uint8_t *buf, size_t len) = 0;
+
+	/**
+	 * @brief Verwirft alle bereits empfangenen, aber noch nicht gelesenen Bytes.
+	 */
+	virtual void flushInput() = 0;
+
+	/**
+	 * @brief Blockiert, bis der Treiber ein Ereignis meldet oder die Wartezeit abläuft.
+	 *
+	 * @param evt Ausgabeparameter für das Ereignis.
+	 * @param timeoutMs Maximale Wartezeit in Millisekunden.
+	 * @return false, wenn die Wartezeit ohne Ereignis abgelaufen ist.
+	 */
+	virtual bool waitEvent(UartEvent &evt, uint32_t timeoutMs) = 0;
+
+	/**
+	 * @brief Legt die aufrufende Task für die angegebene Zeit schlafen (Polling-Pfad).
+	 */
+	virtual void sleep(uint32_t ms) = 0;
+
+	/**
+	 * @brief Monotone Zeitbasis der Schnittstelle in Millisekunden.
+	 */
+	virtual uint32_t now() = 0;
+
+	/**
+	 * @brief Wartet, bis alle geschriebenen Bytes die Leitung verlassen haben.
+	 *
+	 * @param timeoutMs Maximale Wartezeit in Millisekunden.
+	 * @return false, wenn die Wartezeit abgelaufen ist.
+	 */
+	virtual bool waitTxDone(uint32_t timeoutMs) {
+		(void)timeoutMs;
+		return true;
+	}
+
+	/**
+	 * @brief Aktiviert die gewünschte Flusskontrolle.
+	 *
+	 * @return false, wenn die Schnittstelle den Modus nicht unterstützt.
+	 */
+	virtual bool setFlowControl(SerialFlowControl mode) {
+		return mode == SERIAL_FLOW_NONE;
+	}
+
+	/**
+	 * @brief Schaltet den Sendetreiber eines RS-485-Transceivers (DE) ein oder aus.
+	 */
+	virtual void setDriverEnable(bool on) {
+		(void)on;
+	}
+
+	/**
+	 * @brief Kurze aktive Wartezeit in Mikrosekunden (Zeichenabstand, DE-Vor-/Nachlauf).
+	 */
+	virtual void delayMicros(uint32_t us) {
+		(void)us;
+	}
+
+	/**
+	 * @brief Schätzt die Baudrate aus der kürzesten Pulsbreite auf RX (Autobaud-Hardware).
+	 *
+	 * @param windowMs Maximale Messdauer in Millisekunden.
+	 * @return Gemessene Rate oder 0, wenn nicht unterstützt oder kein Verkehr auf der Leitung.
+	 */
+	virtual uint32_t measureBaud(uint32_t windowMs) {
+		(void)windowMs;
+		return 0;
+	}
+
+	/**
+	 * @brief Steuert Boot- und Reset-Leitung des angeschlossenen Controllers (wie DTR/RTS).
+	 *
+	 * @param boot true = Boot-Pin aktiv (Controller startet beim nächsten Reset den Bootloader).
+	 * @param reset true = Reset aktiv (Controller angehalten).
+	 * @return false, wenn keine Boot-Leitungen verdrahtet sind.
+	 */
+	virtual bool setBootLines(bool boot, bool reset) {
+		(void)boot;
+		(void)reset;
+		return false;
+	}
+};
+
+#endif  // UARTPORT_H
@@ -14,6 +14,7 @@
  * - Anzeige aller Systemlogdateien im HTML-Format
  * - Einzelne Logdateien (z. B. `info.log`) direkt im Browser anzeigen
  * - Gerätelogdateien (über `/logs/device`) abrufen
+ * - Dateien zeilenweise an ein Gerät senden (über `/serial/stream`)
  * - SPA-Frontend ausliefern
  *
  * @author Simon Marcel Linden
@@ -26,8 +27,10 @@ class WebServerManager {
 	 *
 	 * Dazu gehören:
 	 * - `/logs`: HTML-Liste aller Systemlogdateien
-	 * - `/logfile?level=...`: Einzelne Systemlogdatei
+	 * - `/logfile?level=...`: Einträge einer Kategorie aus dem Log-Journal
+	 * - `/logfile?segment=...`: ein Journal-Segment unverändert (für tools/log-decoder)
 	 * - `/logs/device?file=...`: Gerätespezifische Logdatei
+	 * - `POST /serial/stream?channel=...`: Datei an die UART senden
 	 * - statische Ressourcen unter `/www/html/`
 	 * - Fallback-Routing für SPA
 	 *
@@ -38,7 +41,7 @@ class WebServerManager {
 	/**
 	 * @brief HTTP-Handler für GET /logs.
 	 *
-	 * Sendet eine HTML-Liste aller im Dateisystem gespeicherten System-Logdateien.
+	 * Sendet eine HTML-Liste der Log-Kategorien mit Links auf ihre Journal-Ansicht.
 	 *
 	 * @param request Eingehende HTTP-Anfrage.
 	 */
@@ -47,7 +50,9 @@ class WebServerManager {
 	/**
 	 * @brief HTTP-Handler für GET /logfile?level=…
 	 *
-	 * Sendet den Inhalt einer bestimmten Systemlogdatei im HTML-Format mit Hervorhebungen.
+	 * Sendet die Einträge einer Kategorie (oder `all`) aus dem Log-Journal im HTML-Format mit
+	 * Hervorhebungen; binäre Einträge werden dabei in Text umgesetzt. Mit `segment` wird ein
+	 * Segment als Datei geliefert.
 	 *
 	 * @param request Eingehende HTTP-Anfrage.
 	 */
@@ -62,7 +67,34 @@ class WebServerManager {
 	 */
 	void serveDeviceLog(AsyncWebServerRequest *request);
 
+	/**
+	 * @brief Body-Handler für POST /serial/stream (roh oder als Multipart-Upload).
+	 *
+	 * Beim ersten Block wird die Übertragung mit den Query-Parametern gestartet, danach gehen
+	 * alle Blöcke an SerialBridge::feedStream(). Ist dessen Puffer voll, wartet der Handler in
+	 * kurzen Schritten; der TCP-Empfang stockt so lange und bremst den Sender.
+	 *
+	 * @param request Eingehende HTTP-Anfrage.
+	 * @param data Daten des Blocks.
+	 * @param len Länge des Blocks.
+	 * @param index Position des Blocks in der Datei.
+	 * @param total Angekündigte Größe (0 = unbekannt).
+	 */
+	void handleStreamData(AsyncWebServerRequest *request, const uint8_t *data, size_t len, size_t index, size_t total);
+
+	/**
+	 * @brief Abschluss von POST /serial/stream: meldet das Dateiende bzw. den Fehler.
+	 *
+	 * Die Antwort (202) bestätigt nur die Annahme; das Ende der Übertragung melden die
+	 * WebSocket-Events `serial`/`stream`.
+	 *
+	 * @param request Eingehende HTTP-Anfrage.
+	 */
+	void finishStream(AsyncWebServerRequest *request);
+
    private:
+	static constexpr uint32_t STREAM_FEED_WAIT_MS = 5;         ///< Wartezeit bei vollem Puffer
+	static constexpr uint32_t STREAM_STALL_MARGIN_MS = 3000;  ///< Zuschlag auf Zeilenpause bzw. Prompt-Wartezeit bis zum Abbruch
 	/**
 	 * @brief Erzeugt HTML-Code zur Anzeige der Systemlogdateien.
 	 *
@@ -3,8 +3,11 @@
 
 #include <ArduinoJson.h>
 #include <ESPAsyncWebServer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 #include "WsEvents.h"
+#include "WsOutbox.h"
 
 /**
  * @class WebSocketManager
@@ -20,6 +23,10 @@
  * - `WS_EVT_ERROR`
  * - `WS_EVT_PONG`
  * - `WS_EVT_DATA`
+ *
+ * Ausgehende Nachrichten laufen über eine WsOutbox: Jeder Client hat eine begrenzte
+ * Warteschlange, Steuerantworten überholen serielle Daten, und eine eigene Task reicht die
+ * Nachrichten erst weiter, wenn der Client sie annehmen kann.
  */
 class WebSocketManager {
    public:
@@ -48,8 +55,59 @@ class WebSocketManager {
 	 */
 	AsyncWebSocket &getSocket();
 
+	/**
+	 * @brief Gibt die Sendewarteschlangen aller Clients zurück.
+	 *
+	 * @return Referenz auf die WsOutbox.
+	 */
+	WsOutbox &getOutbox();
+
+	/**
+	 * @brief Reiht eine Steuerantwort für einen Client ein.
+	 *
+	 * @param client Ziel-Client.
+	 * @param payload JSON-Text.
+	 */
+	void sendControl(AsyncWebSocketClient *client, const String &payload);
+
    private:
-	AsyncWebSocket ws;  ///< Interne WebSocket-Instanz.
+	static constexpr size_t SINK_QUEUE_DEPTH = 4;     ///< Nachrichten, die höchstens in AsyncTCP warten
+	static constexpr uint32_t PUMP_INTERVAL_MS = 10;  ///< Erneuter Sendeversuch bei blockierten Clients
+
+	/**
+	 * @class Sink
+	 * @brief Anbindung der WsOutbox an AsyncWebSocket.
+	 */
+	class Sink : public WsOutboxSink {
+	   public:
+		explicit Sink(AsyncWebSocket &ws) : _ws(ws) {
+		}
+		bool canSend(uint32_t id) override;
+		void send(uint32_t id, const uint8_t *data, size_t len, bool binary) override;
+		void close(uint32_t id) override;
+
+	   private:
+		AsyncWebSocket &_ws;  ///< WebSocket-Server
+	};
+
+	AsyncWebSocket ws;       ///< Interne WebSocket-Instanz.
+	Sink _sink;              ///< Anbindung der Warteschlangen an den WebSocket
+	WsOutbox _outbox;        ///< Sendewarteschlangen pro Client
+	TaskHandle_t _pumpTask;  ///< Task, die die Warteschlangen leert
+
+	/**
+	 * @brief Task zum Leeren der Warteschlangen; wird beim Einreihen geweckt.
+	 *
+	 * @param param Zeiger auf die WebSocketManager-Instanz.
+	 */
+	static void pumpTask(void *param);
+
+	/**
+	 * @brief Callback der WsOutbox: weckt die Pump-Task.
+	 *
+	 * @param ctx Zeiger auf die WebSocketManager-Instanz.
+	 */
+	static void wakePump(void *ctx);
 
 	/**
 	 * @brief Statischer Wrapper für den Ereignis-Callback.
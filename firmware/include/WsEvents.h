@@ -35,6 +35,7 @@ struct ParsedMessage {
 	String command;
 	String key;
 	String value;
+	int channel;  ///< Serieller Kanal (`channel`, Standard 0, -1 = kein ganzzahliger Wert)
 };
 
 /**
@@ -98,6 +99,16 @@ void handleLogEvent(AsyncWebSocketClient *client, const ParsedMessage &msg);
  */
 void handleSerialEvent(AsyncWebSocketClient *client, const ParsedMessage &msg);
 
+/**
+ * @brief Behandelt eingehende binäre Nachrichten (Upload-Blöcke des Durchreichens).
+ *
+ * @param client Der WebSocket-Client.
+ * @param info Frame-Information von AsyncWebSocket (Position des Teils in der Nachricht).
+ * @param data Empfangener Teil.
+ * @param len Länge des Teils.
+ */
+void handleSerialUpload(AsyncWebSocketClient *client, const AwsFrameInfo *info, const uint8_t *data, size_t len);
+
 /*
  * -------------------------------------------------------------------------------------------------
  * Hilfs-Tasks
@@ -169,4 +180,42 @@ void sendResponse(AsyncWebSocketClient *client, const String &event, const Strin
  */
 void sendResponse(AsyncWebSocketClient *client, const String &event, const String &action, const String &status, const JsonVariantConst &details);
 
+/**
+ * @brief Sendet eine Antwort auf ein "serial"-Kommando mit Kanal-ID und `details` als String.
+ *
+ * @param client Ziel-Client.
+ * @param channel Kanal-ID.
+ * @param action Aktion.
+ * @param status Status-String ("success", "error", ...).
+ * @param details Detailinformationen.
+ * @param error Optionaler Fehlertext.
+ */
+void sendSerialResponse(AsyncWebSocketClient *client, int channel, const String &action, const String &status, const String &details,
+                        const String &error = "");
+
+/**
+ * @brief Sendet eine Antwort auf ein "serial"-Kommando mit Kanal-ID und JSON-Wert als Details.
+ *
+ * @param client Ziel-Client.
+ * @param channel Kanal-ID.
+ * @param action Aktion.
+ * @param status "success" oder "error".
+ * @param details Beliebiger JSON-Wert.
+ */
+void sendSerialResponse(AsyncWebSocketClient *client, int channel, const String &action, const String &status, const JsonVariantConst &details);
+
+/**
+ * @brief Lädt die gespeicherten zyklischen Abfragen aller Kanäle (`/poll/ch<N>.json`).
+ *
+ * Wird einmal nach dem Start der SerialBridges aufgerufen.
+ */
+void loadSerialPolls();
+
+/**
+ * @brief Lädt und übersetzt die gespeicherten Regeln aller Kanäle (`/triggers/ch<N>.json`).
+ *
+ * Wird einmal nach dem Start der SerialBridges aufgerufen.
+ */
+void loadSerialTriggers();
+
 #endif  // WSEVENTS_H
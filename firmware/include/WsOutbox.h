@@ -0,0 +1,235 @@
+/**
+ * @file WsOutbox.h
+ * @brief Begrenzte Sendewarteschlangen pro WebSocket-Client mit Prioritäten.
+ *
+ * Jede ausgehende Nachricht landet zuerst in der Warteschlange ihres Clients. Ein Pumpvorgang
+ * (WebSocketManager-Task) reicht sie erst weiter, wenn der Client wieder Daten annehmen kann.
+ * Steuerantworten (`WS_PRIO_CONTROL`) haben Vorrang vor seriellen Massendaten (`WS_PRIO_BULK`),
+ * sodass ein langsamer Client weder den Heap aufbraucht noch Antworten hinter einer Datenflut
+ * verhungern lässt.
+ *
+ * Läuft der Datenpuffer eines Clients über, greift die eingestellte Strategie:
+ * - `WS_SLOW_DROP_OLDEST`: älteste Daten verwerfen, bis die neue Nachricht passt.
+ * - `WS_SLOW_COALESCE`: den gesamten Rückstand verwerfen und dem Client vor den nächsten Daten
+ *   eine einzige `serial`/`gap`-Meldung mit der Anzahl verlorener Nachrichten und Bytes schicken.
+ * - `WS_SLOW_DISCONNECT`: den Client trennen.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#ifndef WSOUTBOX_H
+#define WSOUTBOX_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ByteRing.h"
+#include "TaskMutex.h"
+
+/**
+ * @enum WsPriority
+ * @brief Priorität einer ausgehenden Nachricht.
+ */
+enum WsPriority {
+	WS_PRIO_CONTROL,  ///< Antworten und Statusmeldungen, werden zuerst gesendet
+	WS_PRIO_BULK      ///< Serielle Daten
+};
+
+/**
+ * @enum WsSlowPolicy
+ * @brief Verhalten bei vollem Datenpuffer eines Clients.
+ */
+enum WsSlowPolicy {
+	WS_SLOW_DROP_OLDEST,  ///< Älteste Daten verwerfen
+	WS_SLOW_COALESCE,     ///< Rückstand verwerfen und eine Lückenmeldung senden
+	WS_SLOW_DISCONNECT    ///< Client trennen
+};
+
+/**
+ * @struct WsOutboxConfig
+ * @brief Speicherbudget und Strategie.
+ */
+struct WsOutboxConfig {
+	size_t clientBudget;  ///< Puffer pro Client in Bytes (Steuer- und Datenanteil)
+	size_t totalBudget;   ///< Obergrenze über alle Clients
+	WsSlowPolicy policy;  ///< Strategie bei vollem Datenpuffer
+};
+
+/**
+ * @struct WsClientStats
+ * @brief Zähler eines Clients.
+ */
+struct WsClientStats {
+	uint32_t id;            ///< Client-ID
+	size_t budget;          ///< Zugeteilter Puffer in Bytes
+	size_t queuedBytes;     ///< Aktuell wartende Bytes (inkl. Verwaltungsdaten)
+	uint32_t queued;        ///< Aktuell wartende Nachrichten
+	uint32_t sent;          ///< Weitergereichte Nachrichten
+	uint32_t drops;         ///< Verworfene Nachrichten
+	uint32_t droppedBytes;  ///< Verworfene Nutzdaten
+	uint32_t maxDelayMs;    ///< Längste Wartezeit einer Nachricht in der Warteschlange
+};
+
+/**
+ * @class WsOutboxSink
+ * @brief Schnittstelle zum eigentlichen WebSocket (auf dem ESP32 AsyncWebSocket).
+ */
+class WsOutboxSink {
+   public:
+	virtual ~WsOutboxSink() {
+	}
+
+	/**
+	 * @brief Kann der Client jetzt eine weitere Nachricht annehmen?
+	 */
+	virtual bool canSend(uint32_t id) = 0;
+
+	/**
+	 * @brief Übergibt eine Nachricht an den Client.
+	 */
+	virtual void send(uint32_t id, const uint8_t *data, size_t len, bool binary) = 0;
+
+	/**
+	 * @brief Trennt den Client.
+	 */
+	virtual void close(uint32_t id) = 0;
+};
+
+/**
+ * @class WsOutbox
+ * @brief Sendewarteschlangen aller WebSocket-Clients.
+ *
+ * `enqueue()` und `broadcast()` dürfen aus beliebigen Tasks aufgerufen werden (nicht aus ISRs
+ * oder unter einem Spinlock), `pump()` nur aus einer einzigen Task.
+ */
+class WsOutbox {
+   public:
+	static constexpr size_t MAX_CLIENTS = 8;                ///< Maximale Anzahl verwalteter Clients
+	static constexpr size_t MAX_MESSAGE = 4096;             ///< Größte Nachricht (Zwischenpuffer von pump())
+	static constexpr size_t CONTROL_SHARE = 2048;           ///< Anteil des Client-Puffers für Steuerantworten
+	static constexpr size_t MIN_CLIENT_BUDGET = 3072;       ///< Kleinster sinnvoller Client-Puffer
+	static constexpr size_t DEFAULT_CLIENT_BUDGET = 10240;  ///< Standard-Puffer pro Client
+	static constexpr size_t DEFAULT_TOTAL_BUDGET = 49152;   ///< Standard-Obergrenze über alle Clients
+
+	/**
+	 * @brief Konstruktor.
+	 *
+	 * @param sink Ziel für gesendete Nachrichten.
+	 */
+	explicit WsOutbox(WsOutboxSink &sink);
+
+	~WsOutbox();
+
+	/**
+	 * @brief Setzt Budget und Strategie. Neue Budgets gelten für danach verbundene Clients.
+	 */
+	void configure(const WsOutboxConfig &config);
+
+	/**
+	 * @brief Gibt die aktuelle Konfiguration zurück.
+	 */
+	WsOutboxConfig config() const;
+
+	/**
+	 * @brief Legt die Warteschlange für einen neuen Client an.
+	 *
+	 * @return false, wenn kein Slot oder kein Budget mehr frei ist.
+	 */
+	bool attach(uint32_t id);
+
+	/**
+	 * @brief Gibt die Warteschlange eines getrennten Clients frei.
+	 */
+	void detach(uint32_t id);
+
+	/**
+	 * @brief Reiht eine Nachricht für einen Client ein.
+	 *
+	 * @param id Client-ID.
+	 * @param prio Priorität.
+	 * @param data Nachricht (wird kopiert).
+	 * @param len Länge der Nachricht.
+	 * @param binary true = Binär-Frame, false = Text.
+	 * @param now Aktuelle Zeit in ms.
+	 * @return false, wenn die Nachricht verworfen wurde.
+	 */
+	bool enqueue(uint32_t id, WsPriority prio, const uint8_t *data, size_t len, bool binary, uint32_t now);
+
+	/**
+	 * @brief Reiht eine Nachricht für alle Clients ein.
+	 */
+	void broadcast(WsPriority prio, const uint8_t *data, size_t len, bool binary, uint32_t now);
+
+	/**
+	 * @brief Reicht wartende Nachrichten an alle Clients weiter, die Daten annehmen können.
+	 *
+	 * Pro Durchgang erhält jeder Client höchstens eine Nachricht (Round Robin).
+	 *
+	 * @param now Aktuelle Zeit in ms.
+	 * @return Anzahl der weitergereichten Nachrichten.
+	 */
+	size_t pump(uint32_t now);
+
+	/**
+	 * @brief Setzt einen Callback, der nach jedem erfolgreichen Einreihen aufgerufen wird
+	 *        (z. B. um die Sende-Task zu wecken).
+	 */
+	void onEnqueue(void (*wake)(void *ctx), void *ctx);
+
+	/**
+	 * @brief Freier Platz im Datenpuffer eines Clients.
+	 *
+	 * @return Freie Bytes (0 bei unbekanntem Client).
+	 */
+	size_t bulkSpace(uint32_t id) const;
+
+	/**
+	 * @brief Liefert die Zähler aller verbundenen Clients.
+	 *
+	 * @param out Zielarray.
+	 * @param max Größe des Zielarrays.
+	 * @return Anzahl der geschriebenen Einträge.
+	 */
+	size_t stats(WsClientStats *out, size_t max) const;
+
+   private:
+	/**
+	 * @struct Slot
+	 * @brief Warteschlangen und Zähler eines Clients.
+	 */
+	struct Slot {
+		bool used;             ///< Slot belegt
+		bool closing;          ///< Trennung angefordert, keine Annahme mehr
+		bool closed;           ///< Trennung an den Sink weitergegeben
+		uint8_t *mem;          ///< Speicher beider Ringe
+		ByteRing control;      ///< Steuerantworten
+		ByteRing bulk;         ///< Serielle Daten
+		uint32_t queued;       ///< Wartende Nachrichten (beide Ringe)
+		uint32_t gapMessages;  ///< Noch nicht gemeldete verworfene Nachrichten (WS_SLOW_COALESCE)
+		uint32_t gapBytes;     ///< Noch nicht gemeldete verworfene Bytes (WS_SLOW_COALESCE)
+		WsClientStats stats;   ///< Zähler
+	};
+
+	WsOutboxSink &_sink;              ///< Ziel für gesendete Nachrichten
+	WsOutboxConfig _config;           ///< Budget und Strategie
+	size_t _allocated;                ///< Summe der zugeteilten Puffer
+	Slot _slots[MAX_CLIENTS];         ///< Clients
+	size_t _next;                     ///< Startslot des nächsten Round-Robin-Durchgangs
+	uint8_t _scratch[MAX_MESSAGE];    ///< Zwischenpuffer für die gerade gesendete Nachricht
+	void (*_wake)(void *);            ///< Callback nach dem Einreihen
+	void *_wakeCtx;                   ///< Kontext des Callbacks
+	mutable TaskMutex _lock;          ///< Schutz der Slots (Mutex: Nachrichten werden darunter kopiert)
+
+	void lock() const;
+	void unlock() const;
+	Slot *find(uint32_t id);
+	const Slot *find(uint32_t id) const;
+	void release(Slot &slot);
+	size_t dropOldest(ByteRing &ring, Slot &slot);
+	void dropAll(ByteRing &ring, Slot &slot);
+	bool enqueueLocked(Slot &slot, WsPriority prio, const uint8_t *data, size_t len, bool binary, uint32_t now);
+	bool takeNext(Slot &slot, uint32_t now, size_t &len, bool &binary);
+};
+
+#endif  // WSOUTBOX_H
@@ -28,6 +28,52 @@
 /// TX-Pin für UART2 (Senden)
 #define TXD2 16
 
+/// RTS-Pin für UART2 (Hardware-Flusskontrolle, DE-Pin im RS-485-Betrieb)
+#define RTS2 18
+
+/// CTS-Pin für UART2 (Hardware-Flusskontrolle)
+#define CTS2 19
+
+/// Boot-Leitung zum Controller an UART2 (aktiv low, wie DTR → GPIO0/BOOT0), -1 = nicht verdrahtet
+#ifndef BOOT2
+#define BOOT2 25
+#endif
+
+/// Reset-Leitung zum Controller an UART2 (aktiv low, wie RTS → EN/NRST), -1 = nicht verdrahtet
+#ifndef RST2
+#define RST2 13
+#endif
+
+// === Serielle Kommunikation (UART1, Kanal 1) ===
+
+/// RX-Pin für UART1 (Empfang, GPIO35 ist nur Eingang)
+#define RXD1 35
+
+/// TX-Pin für UART1 (Senden)
+#define TXD1 32
+
+/// Anzahl der gebrückten seriellen Kanäle (1 = nur UART2 wie bisher, 2 = UART2 + UART1 per Build-Flag)
+#ifndef SERIAL_CHANNELS
+#define SERIAL_CHANNELS 1
+#endif
+
+// === TCP-Zugang zur UART (roh und RFC 2217) ===
+
+/// TCP-Port für Rohdaten auf Kanal 0 (Kanal n: Port + n)
+#ifndef SERIAL_TCP_RAW_PORT
+#define SERIAL_TCP_RAW_PORT 4000
+#endif
+
+/// TCP-Port für RFC 2217 auf Kanal 0 (Kanal n: Port + n)
+#ifndef SERIAL_RFC2217_PORT
+#define SERIAL_RFC2217_PORT 2217
+#endif
+
+/// TCP-Zugang beim Start öffnen (1) oder erst per `serial`/`tcp`/`enable` (0)
+#ifndef SERIAL_TCP_AUTOSTART
+#define SERIAL_TCP_AUTOSTART 0
+#endif
+
 // === LED-Pinbelegung ===
 
 /// GPIO-Pin für rote LED
@@ -47,9 +93,11 @@ extern Preferences preferences;
 /**
  * @brief Liste der erlaubten Baudraten für die serielle Kommunikation.
  *
- * Diese Baudraten können dynamisch gesetzt und vom Benutzer ausgewählt werden.
+ * Diese Baudraten können dynamisch gesetzt und vom Benutzer ausgewählt werden. Die hohen Raten
+ * stehen am Ende, damit die automatische Erkennung die üblichen zuerst prüft. Im
+ * Durchreichmodus (`serial`/`passthrough`) ist jede Rate bis SerialPassthrough::MAX_BAUD möglich.
  */
-constexpr int baudRates[] = {115200, 57600, 38400, 19200, 1200, 2400, 4800, 9600};
+constexpr int baudRates[] = {115200, 57600, 38400, 19200, 1200, 2400, 4800, 9600, 230400, 460800, 921600};
 
 /// Anzahl der unterstützten Baudraten
 constexpr size_t NUM_BAUD_RATES = sizeof(baudRates) / sizeof(baudRates[0]);
@@ -0,0 +1,191 @@
+/**
+ * @file BaudDetector.cpp
+ * @brief Automatische Baudratenerkennung über Pulsmessung und Bewertung von Stichproben.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "BaudDetector.h"
+
+namespace {
+
+/**
+ * @brief Länge einer gültigen UTF-8-Mehrbytesequenz ab `p` oder 0.
+ */
+size_t utf8Length(const uint8_t *p, size_t avail) {
+	size_t n;
+	if ((p[0] & 0xE0) == 0xC0 && p[0] >= 0xC2) {
+		n = 2;
+	} else if ((p[0] & 0xF0) == 0xE0) {
+		n = 3;
+	} else if ((p[0] & 0xF8) == 0xF0 && p[0] <= 0xF4) {
+		n = 4;
+	} else {
+		return 0;
+	}
+	if (n > avail) return 0;
+	for (size_t i = 1; i < n; ++i) {
+		if ((p[i] & 0xC0) != 0x80) return 0;
+	}
+	return n;
+}
+
+inline bool isAlnum(uint8_t c) {
+	return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+}  // namespace
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param port UART, auf der gemessen und empfangen wird.
+ */
+BaudDetector::BaudDetector(UartPort &port) : _port(port) {
+}
+
+/**
+ * @brief Bewertet die Lesbarkeit einer Stichprobe.
+ *
+ * @param data Stichprobe.
+ * @param len Länge der Stichprobe.
+ * @return Anteil lesbarer Bytes, halbiert bei weniger als 25 % Buchstaben/Ziffern.
+ */
+float BaudDetector::score(const uint8_t *data, size_t len) {
+	if (len == 0) return 0.0f;
+	size_t good = 0;
+	size_t alnum = 0;
+	for (size_t i = 0; i < len;) {
+		uint8_t c = data[i];
+		if ((c >= 0x20 && c < 0x7F) || c == '\r' || c == '\n' || c == '\t') {
+			good++;
+			if (isAlnum(c)) alnum++;
+			i++;
+			continue;
+		}
+		size_t seq = c >= 0x80 ? utf8Length(data + i, len - i) : 0;
+		if (seq > 0) {
+			good += seq;
+			alnum++;
+			i += seq;
+			continue;
+		}
+		i++;
+	}
+	float s = (float)good / (float)len;
+	if (alnum * 4 < len) s *= 0.5f;
+	return s;
+}
+
+/**
+ * @brief Ordnet eine gemessene Rate der nächstgelegenen Kandidatenrate zu.
+ *
+ * @param measured Gemessene Rate.
+ * @param candidates Kandidatenraten.
+ * @param count Anzahl der Kandidaten.
+ * @return Kandidatenrate innerhalb der Toleranz oder 0.
+ */
+uint32_t BaudDetector::nearestBaud(uint32_t measured, const uint32_t *candidates, size_t count) {
+	if (measured == 0) return 0;
+	uint32_t best = 0;
+	uint32_t bestDiff = UINT32_MAX;
+	for (size_t i = 0; i < count; ++i) {
+		uint32_t c = candidates[i];
+		uint32_t diff = c > measured ? c - measured : measured - c;
+		if (diff < bestDiff) {
+			best = c;
+			bestDiff = diff;
+		}
+	}
+	if (best == 0 || (uint64_t)bestDiff * 100 > (uint64_t)best * TOLERANCE_PCT) return 0;
+	return best;
+}
+
+/**
+ * @brief Anzahl der Bytes am Anfang einer Stichprobe, die nicht bewertet werden.
+ *
+ * Nach dem Umschalten beginnt der Empfänger meist mitten in einem Zeichen und findet bei
+ * durchgehendem Datenstrom erst in der nächsten Sendepause wieder den Zeichenanfang. Liegt ein
+ * Zeilenende in der ersten Hälfte der Stichprobe, wird erst ab dort bewertet.
+ *
+ * @param buf Stichprobe.
+ * @param len Länge der Stichprobe.
+ * @return Position hinter dem ersten Zeilenende oder 0.
+ */
+size_t BaudDetector::resyncOffset(const uint8_t *buf, size_t len) {
+	for (size_t i = 0; i < len / 2; ++i) {
+		if (buf[i] == '\n') return i + 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Empfängt eine Stichprobe auf der aktuell eingestellten Rate.
+ *
+ * @param buf Zielpuffer.
+ * @param len Gewünschte Größe der Stichprobe.
+ * @return Anzahl der empfangenen Bytes (endet nach PROBE_MS).
+ */
+size_t BaudDetector::sample(uint8_t *buf, size_t len) {
+	_port.flushInput();
+	uint32_t start = _port.now();
+	size_t n = 0;
+	while (n < len) {
+		uint32_t elapsed = _port.now() - start;
+		if (elapsed >= PROBE_MS) break;
+		UartEvent evt;
+		_port.waitEvent(evt, PROBE_MS - elapsed);
+		if (_port.available()) n += _port.read(buf + n, len - n);
+	}
+	return n;
+}
+
+/**
+ * @brief Führt einen Erkennungslauf aus.
+ *
+ * @param candidates Kandidatenraten in Prüfreihenfolge.
+ * @param count Anzahl der Kandidaten.
+ * @param fallback Rate, auf die ohne Treffer zurückgestellt wird.
+ * @return Ergebnis des Laufs.
+ */
+BaudDetectResult BaudDetector::detect(const uint32_t *candidates, size_t count, uint32_t fallback) {
+	BaudDetectResult res = {0, 0.0f, 0, 0, 0};
+	uint32_t start = _port.now();
+
+	// 1) Pulsbreite messen; eine passende Rate wird zuerst geprüft
+	res.measured = _port.measureBaud(MEASURE_MS);
+	uint32_t hint = nearestBaud(res.measured, candidates, count);
+
+	// 2) Stichproben: Hinweis zuerst, danach die übrigen Kandidaten in gegebener Reihenfolge
+	uint8_t buf[SAMPLE_BYTES];
+	uint32_t best = 0;
+	uint32_t current = 0;
+	float bestScore = 0.0f;
+	for (size_t i = 0; i <= count; ++i) {
+		uint32_t baud = i == 0 ? hint : candidates[i - 1];
+		if (baud == 0 || (i > 0 && baud == hint)) continue;
+		_port.begin(baud);
+		current = baud;
+		res.probes++;
+		size_t n = sample(buf, sizeof(buf));
+		size_t skip = resyncOffset(buf, n);
+		if (n - skip < MIN_BYTES) continue;
+		float s = score(buf + skip, n - skip);
+		if (s > bestScore) {
+			best = baud;
+			bestScore = s;
+		}
+		if (s >= LOCK_SCORE) break;
+	}
+
+	res.score = bestScore;
+	if (bestScore >= ACCEPT_SCORE) {
+		res.baud = best;
+		if (best != current) _port.begin(best);
+	} else {
+		_port.begin(fallback);
+	}
+	res.elapsedMs = _port.now() - start;
+	return res;
+}
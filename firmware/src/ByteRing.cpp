@@ -0,0 +1,100 @@
+/**
+ * @file ByteRing.cpp
+ * @brief Implementierung des Byte-Ringpuffers.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "ByteRing.h"
+
+#include <cstring>
+
+/**
+ * @brief Erzeugt einen leeren Ring ohne Speicher.
+ */
+ByteRing::ByteRing() : _buf(nullptr), _capacity(0), _head(0), _size(0) {
+}
+
+/**
+ * @brief Setzt den Speicherbereich und leert den Ring.
+ *
+ * @param buf Speicherbereich.
+ * @param capacity Größe in Bytes.
+ */
+void ByteRing::reset(uint8_t *buf, size_t capacity) {
+	_buf = buf;
+	_capacity = buf ? capacity : 0;
+	clear();
+}
+
+/**
+ * @brief Verwirft den gesamten Inhalt.
+ */
+void ByteRing::clear() {
+	_head = 0;
+	_size = 0;
+}
+
+/**
+ * @brief Hängt Bytes an.
+ *
+ * @param data Quelldaten.
+ * @param len Anzahl der Bytes.
+ * @return false bei zu wenig freiem Platz.
+ */
+bool ByteRing::push(const void *data, size_t len) {
+	if (len > space()) return false;
+	const uint8_t *src = static_cast<const uint8_t *>(data);
+	size_t tail = (_head + _size) % (_capacity ? _capacity : 1);
+	size_t first = _capacity - tail < len ? _capacity - tail : len;
+	memcpy(_buf + tail, src, first);
+	memcpy(_buf, src + first, len - first);
+	_size += len;
+	return true;
+}
+
+/**
+ * @brief Kopiert Bytes, ohne sie zu entfernen.
+ *
+ * @param out Zielpuffer.
+ * @param len Gewünschte Anzahl.
+ * @param offset Abstand zum ältesten Byte.
+ * @return Anzahl der kopierten Bytes.
+ */
+size_t ByteRing::peek(void *out, size_t len, size_t offset) const {
+	if (offset >= _size) return 0;
+	if (len > _size - offset) len = _size - offset;
+	uint8_t *dst = static_cast<uint8_t *>(out);
+	size_t pos = (_head + offset) % _capacity;
+	size_t first = _capacity - pos < len ? _capacity - pos : len;
+	memcpy(dst, _buf + pos, first);
+	memcpy(dst + first, _buf, len - first);
+	return len;
+}
+
+/**
+ * @brief Entfernt die ältesten Bytes.
+ *
+ * @param len Anzahl der Bytes (wird auf den Füllstand begrenzt).
+ */
+void ByteRing::drop(size_t len) {
+	if (len >= _size) {
+		clear();
+		return;
+	}
+	_head = (_head + len) % _capacity;
+	_size -= len;
+}
+
+size_t ByteRing::capacity() const {
+	return _capacity;
+}
+
+size_t ByteRing::size() const {
+	return _size;
+}
+
+size_t ByteRing::space() const {
+	return _capacity - _size;
+}
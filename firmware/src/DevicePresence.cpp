@@ -0,0 +1,166 @@
+/**
+ * @file DevicePresence.cpp
+ * @brief Entprellte Geräteerkennung aus empfangenen Bytes und RX-Pegel.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "DevicePresence.h"
+
+/**
+ * @brief Konstruktor.
+ */
+DevicePresence::DevicePresence()
+    : _cfg(defaultConfig()), _stats{0, 0, 0}, _present(false), _seen(false), _candidate(false), _received(false), _firstSeen(0), _lastSeen(0), _low(false), _lowSince(0) {
+}
+
+/**
+ * @brief Standardschwellen.
+ *
+ * @return 50 ms Entprellung, 30 s Stille, ohne Pegelauswertung.
+ */
+DevicePresenceConfig DevicePresence::defaultConfig() {
+	DevicePresenceConfig cfg;
+	cfg.debounceMs = DEFAULT_DEBOUNCE_MS;
+	cfg.idleMs = DEFAULT_IDLE_MS;
+	cfg.levelSense = false;
+	return cfg;
+}
+
+/**
+ * @brief Prüft eine Konfiguration.
+ *
+ * @param config Zu prüfende Schwellen.
+ * @return true, wenn beide Schwellen höchstens MAX_MS betragen und die Stille länger als die
+ *         Entprellung ist.
+ */
+bool DevicePresence::validate(const DevicePresenceConfig &config) {
+	if (config.debounceMs > MAX_MS || config.idleMs > MAX_MS) return false;
+	if (config.idleMs > 0 && config.idleMs <= config.debounceMs) return false;
+	return true;
+}
+
+/**
+ * @brief Übernimmt neue Schwellen.
+ *
+ * @param config Neue Schwellen.
+ * @return false, wenn sie ungültig sind.
+ */
+bool DevicePresence::configure(const DevicePresenceConfig &config) {
+	if (!validate(config)) return false;
+	_cfg = config;
+	if (!_cfg.levelSense) _low = false;
+	return true;
+}
+
+/**
+ * @brief Gibt die aktive Konfiguration zurück.
+ */
+const DevicePresenceConfig &DevicePresence::config() const {
+	return _cfg;
+}
+
+/**
+ * @brief Merkt ein Lebenszeichen.
+ *
+ * Liegt seit dem letzten Lebenszeichen mehr als `idleMs` Stille, beginnt die Entprellung neu.
+ */
+void DevicePresence::seen(uint32_t nowMs) {
+	if (!_present && (!_candidate || (_cfg.idleMs > 0 && nowMs - _lastSeen >= _cfg.idleMs))) {
+		if (_candidate) _stats.glitches++;
+		_candidate = true;
+		_received = false;
+		_firstSeen = nowMs;
+	}
+	_seen = true;
+	_lastSeen = nowMs;
+}
+
+/**
+ * @brief Meldet empfangene Bytes; sie bestätigen das Gerät ohne Entprellung.
+ *
+ * @param nowMs Aktuelle Zeit in ms.
+ */
+void DevicePresence::activity(uint32_t nowMs) {
+	_low = false;
+	seen(nowMs);
+	_received = true;
+}
+
+/**
+ * @brief Meldet den RX-Pegel.
+ *
+ * @param high true bei HIGH.
+ * @param nowMs Aktuelle Zeit in ms.
+ */
+void DevicePresence::level(bool high, uint32_t nowMs) {
+	if (!_cfg.levelSense) return;
+	if (high) {
+		_low = false;
+		seen(nowMs);
+	} else if (!_low) {
+		_low = true;
+		_lowSince = nowMs;
+	}
+}
+
+/**
+ * @brief Wertet die Schwellen aus.
+ *
+ * @param nowMs Aktuelle Zeit in ms.
+ * @return Ereignis bei einem Zustandswechsel.
+ */
+DevicePresenceEvent DevicePresence::update(uint32_t nowMs) {
+	if (!_present) {
+		if (!_candidate) return PRESENCE_NONE;
+		if (_cfg.idleMs > 0 && nowMs - _lastSeen >= _cfg.idleMs) {
+			// Zu kurz für eine Verbindung, danach Stille: Störimpuls
+			_candidate = false;
+			_stats.glitches++;
+			return PRESENCE_NONE;
+		}
+		if (!_received && _lastSeen - _firstSeen < _cfg.debounceMs) return PRESENCE_NONE;
+		_candidate = false;
+		_present = true;
+		_stats.connects++;
+		return PRESENCE_CONNECTED;
+	}
+
+	bool idle = _cfg.idleMs > 0 && nowMs - _lastSeen >= _cfg.idleMs;
+	bool released = _cfg.levelSense && _low && nowMs - _lowSince >= _cfg.debounceMs;
+	if (!idle && !released) return PRESENCE_NONE;
+	_present = false;
+	_candidate = false;
+	_low = false;
+	_stats.disconnects++;
+	return PRESENCE_DISCONNECTED;
+}
+
+/**
+ * @brief true, solange ein Gerät als verbunden gilt.
+ */
+bool DevicePresence::present() const {
+	return _present;
+}
+
+/**
+ * @brief Zeit des letzten Lebenszeichens in ms.
+ */
+uint32_t DevicePresence::lastSeen() const {
+	return _lastSeen;
+}
+
+/**
+ * @brief true, sobald es mindestens ein Lebenszeichen gab.
+ */
+bool DevicePresence::hasActivity() const {
+	return _seen;
+}
+
+/**
+ * @brief Gibt die Zähler zurück.
+ */
+const DevicePresenceStats &DevicePresence::stats() const {
+	return _stats;
+}
@@ -0,0 +1,300 @@
+/**
+ * @file EspUartPort.cpp
+ * @brief UartPort-Implementierung über den ESP-IDF-UART-Treiber mit Event-Queue.
+ *
+ * Der Treiber wird beim ersten `begin()` installiert, der Ringpuffer dabei für die höchste
+ * unterstützte Rate (SerialPassthrough::MAX_BAUD) bemessen. Spätere Aufrufe ändern nur die
+ * Baudrate des laufenden Treibers: Bridge- und TX-Task warten jederzeit auf dessen Event-Queue
+ * bzw. schreiben in ihn, ein Neuinstallieren würde Queue und Puffer unter ihnen freigeben. Zusätzlich wird die Mustererkennung auf `\n` aktiviert, sodass
+ * vollständige Zeilen sofort ein Ereignis auslösen, ohne auf den RX-Timeout warten zu müssen.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "EspUartPort.h"
+
+#include <hal/uart_ll.h>
+
+#include "SerialPassthrough.h"
+#include "SerialRxPump.h"
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param uartNum UART-Nummer (z. B. UART_NUM_2).
+ * @param rxPin RX-Pin.
+ * @param txPin TX-Pin.
+ * @param rtsPin RTS-Pin (auch DE-Pin im RS-485-Betrieb), -1 = nicht belegt.
+ * @param ctsPin CTS-Pin, -1 = nicht belegt.
+ * @param bootPin Boot-Leitung zum Controller, -1 = nicht belegt.
+ * @param resetPin Reset-Leitung zum Controller, -1 = nicht belegt.
+ */
+EspUartPort::EspUartPort(uart_port_t uartNum, int8_t rxPin, int8_t txPin, int8_t rtsPin, int8_t ctsPin, int8_t bootPin, int8_t resetPin)
+    : _uartNum(uartNum),
+      _rxPin(rxPin),
+      _txPin(txPin),
+      _rtsPin(rtsPin),
+      _ctsPin(ctsPin),
+      _bootPin(bootPin),
+      _resetPin(resetPin),
+      _queue(nullptr),
+      _installed(false),
+      _flow(SERIAL_FLOW_NONE),
+      _dePinReady(false) {
+}
+
+/**
+ * @brief Installiert den UART-Treiber bzw. stellt beim bereits installierten Treiber nur die
+ *        Baudrate um.
+ *
+ * Der Ringpuffer ist von Anfang an für SerialPassthrough::MAX_BAUD bemessen und reicht so bei
+ * jeder späteren Rate für RX_BUFFER_HEADROOM_MS.
+ *
+ * @param baud Baudrate.
+ * @return true, wenn Treiber und Pins erfolgreich konfiguriert wurden.
+ */
+bool EspUartPort::begin(uint32_t baud) {
+	if (_installed) {
+		// Mustererkennung und RX-Timeout zählen in Zeichenzeiten und bleiben gültig
+		return uart_set_baudrate(_uartNum, baud) == ESP_OK;
+	}
+
+	uart_config_t cfg = {};
+	cfg.baud_rate = (int)baud;
+	cfg.data_bits = UART_DATA_8_BITS;
+	cfg.parity = UART_PARITY_DISABLE;
+	cfg.stop_bits = UART_STOP_BITS_1;
+	cfg.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+	cfg.source_clk = UART_SCLK_APB;
+
+	int rxSize = (int)SerialRxPump::rxBufferSizeFor(SerialPassthrough::MAX_BAUD);
+	if (uart_driver_install(_uartNum, rxSize, 0, EVENT_QUEUE_LEN, &_queue, 0) != ESP_OK) return false;
+	_installed = true;
+
+	if (uart_param_config(_uartNum, &cfg) != ESP_OK) return false;
+	if (uart_set_pin(_uartNum, _txPin, _rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) != ESP_OK) return false;
+	uart_set_rx_timeout(_uartNum, RX_TIMEOUT_SYMBOLS);
+
+	// Zeilenende als Muster: löst UART_PATTERN_DET aus, sobald '\n' eintrifft
+	uart_enable_pattern_det_baud_intr(_uartNum, '\n', 1, 9, 0, 0);
+	uart_pattern_queue_reset(_uartNum, EVENT_QUEUE_LEN);
+	return applyFlowControl();
+}
+
+/**
+ * @brief Anzahl der im Treiber-Ringpuffer liegenden Bytes.
+ */
+size_t EspUartPort::available() {
+	if (!_installed) return 0;
+	size_t len = 0;
+	uart_get_buffered_data_len(_uartNum, &len);
+	return len;
+}
+
+/**
+ * @brief Liest bis zu `len` Bytes ohne zu blockieren.
+ */
+size_t EspUartPort::read(uint8_t *buf, size_t len) {
+	if (!_installed) return 0;
+	int n = uart_read_bytes(_uartNum, buf, len, 0);
+	return n > 0 ? (size_t)n : 0;
+}
+
+/**
+ * @brief Schreibt `len` Bytes; blockiert, bis alle Bytes im TX-FIFO liegen.
+ */
+size_t EspUartPort::write(const uint8_t *buf, size_t len) {
+	if (!_installed) return 0;
+	int n = uart_write_bytes(_uartNum, (const char *)buf, len);
+	return n > 0 ? (size_t)n : 0;
+}
+
+/**
+ * @brief Verwirft Ringpuffer und ausstehende Ereignisse (nach Überlauf).
+ */
+void EspUartPort::flushInput() {
+	if (!_installed) return;
+	uart_flush_input(_uartNum);
+	xQueueReset(_queue);
+}
+
+/**
+ * @brief Blockiert auf der Event-Queue des Treibers.
+ *
+ * @param evt Ausgabeparameter für das Ereignis.
+ * @param timeoutMs Maximale Wartezeit in Millisekunden.
+ * @return false bei Timeout.
+ */
+bool EspUartPort::waitEvent(UartEvent &evt, uint32_t timeoutMs) {
+	if (!_installed) {
+		vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+		return false;
+	}
+	uart_event_t e;
+	if (xQueueReceive(_queue, &e, pdMS_TO_TICKS(timeoutMs)) != pdTRUE) return false;
+
+	evt.size = e.size;
+	switch (e.type) {
+		case UART_DATA:
+			evt.type = RX_EVT_DATA;
+			break;
+		case UART_FIFO_OVF:
+			evt.type = RX_EVT_FIFO_OVERFLOW;
+			break;
+		case UART_BUFFER_FULL:
+			evt.type = RX_EVT_BUFFER_FULL;
+			break;
+		case UART_BREAK:
+			evt.type = RX_EVT_BREAK;
+			break;
+		case UART_PATTERN_DET:
+			// Position wird nicht benötigt, muss aber aus der Pattern-Queue entfernt werden
+			uart_pattern_pop_pos(_uartNum);
+			evt.type = RX_EVT_PATTERN;
+			break;
+		default:
+			evt.type = RX_EVT_NONE;
+			break;
+	}
+	return true;
+}
+
+/**
+ * @brief Legt die aufrufende Task schlafen (Polling-Pfad).
+ */
+void EspUartPort::sleep(uint32_t ms) {
+	vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+/**
+ * @brief Zeitbasis in Millisekunden seit Systemstart.
+ */
+uint32_t EspUartPort::now() {
+	return millis();
+}
+
+/**
+ * @brief Wartet, bis der TX-FIFO leer ist und das letzte Stoppbit gesendet wurde.
+ *
+ * @param timeoutMs Maximale Wartezeit in Millisekunden.
+ * @return false bei Timeout.
+ */
+bool EspUartPort::waitTxDone(uint32_t timeoutMs) {
+	if (!_installed) return true;
+	return uart_wait_tx_done(_uartNum, pdMS_TO_TICKS(timeoutMs)) == ESP_OK;
+}
+
+/**
+ * @brief Merkt sich die Flusskontrolle und setzt sie bei installiertem Treiber sofort.
+ *
+ * @param mode Gewünschter Modus.
+ * @return false, wenn für RTS/CTS keine Pins belegt sind oder der Treiber ablehnt.
+ */
+bool EspUartPort::setFlowControl(SerialFlowControl mode) {
+	if (mode == SERIAL_FLOW_RTS_CTS && (_rtsPin < 0 || _ctsPin < 0)) return false;
+	_flow = mode;
+	return applyFlowControl();
+}
+
+/**
+ * @brief Überträgt die gemerkte Flusskontrolle auf den Treiber.
+ */
+bool EspUartPort::applyFlowControl() {
+	if (!_installed) return true;
+	switch (_flow) {
+		case SERIAL_FLOW_RTS_CTS:
+			_dePinReady = false;  // RTS gehört jetzt wieder dem UART-Peripheral
+			if (uart_set_pin(_uartNum, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE, _rtsPin, _ctsPin) != ESP_OK) return false;
+			uart_set_sw_flow_ctrl(_uartNum, false, 0, 0);
+			return uart_set_hw_flow_ctrl(_uartNum, UART_HW_FLOWCTRL_CTS_RTS, RTS_THRESHOLD) == ESP_OK;
+		case SERIAL_FLOW_XON_XOFF:
+			uart_set_hw_flow_ctrl(_uartNum, UART_HW_FLOWCTRL_DISABLE, 0);
+			return uart_set_sw_flow_ctrl(_uartNum, true, XON_THRESHOLD, XOFF_THRESHOLD) == ESP_OK;
+		case SERIAL_FLOW_NONE:
+		default:
+			uart_set_sw_flow_ctrl(_uartNum, false, 0, 0);
+			return uart_set_hw_flow_ctrl(_uartNum, UART_HW_FLOWCTRL_DISABLE, 0) == ESP_OK;
+	}
+}
+
+/**
+ * @brief Schaltet den DE-Eingang eines RS-485-Transceivers über den RTS-Pin.
+ *
+ * Der Pin wird per GPIO gesteuert (nicht über den RS-485-Modus des Treibers), damit Vor- und
+ * Nachlaufzeiten unabhängig von der Baudrate eingestellt werden können.
+ */
+void EspUartPort::setDriverEnable(bool on) {
+	if (_rtsPin < 0) return;
+	if (!_dePinReady) {
+		pinMode(_rtsPin, OUTPUT);
+		_dePinReady = true;
+	}
+	digitalWrite(_rtsPin, on ? HIGH : LOW);
+}
+
+/**
+ * @brief Aktive Wartezeit; ganze Millisekunden werden an den Scheduler abgegeben.
+ */
+void EspUartPort::delayMicros(uint32_t us) {
+	if (us >= 1000) {
+		vTaskDelay(pdMS_TO_TICKS(us / 1000));
+		us %= 1000;
+	}
+	if (us) delayMicroseconds(us);
+}
+
+/**
+ * @brief Misst die kürzeste Pulsbreite auf RX über die Autobaud-Hardware der UART.
+ *
+ * Die UART zählt bei aktivierter Autobaud-Erkennung die Flanken auf RX sowie die kürzesten
+ * Low- und High-Pulse in APB-Takten. Der kürzere von beiden entspricht einer Bitzeit, sobald
+ * genug Zeichen gesehen wurden. Der Empfang läuft währenddessen unverändert weiter.
+ *
+ * @param windowMs Maximale Messdauer in Millisekunden.
+ * @return Gemessene Rate oder 0 bei zu wenig Flanken.
+ */
+uint32_t EspUartPort::measureBaud(uint32_t windowMs) {
+	if (!_installed) return 0;
+	uart_dev_t *hw = UART_LL_GET_HW(_uartNum);
+	uart_ll_set_autobaud_en(hw, false);  // Zähler zurücksetzen
+	uart_ll_set_autobaud_en(hw, true);
+
+	TickType_t start = xTaskGetTickCount();
+	while (uart_ll_get_rxd_edge_cnt(hw) < AUTOBAUD_MIN_EDGES && xTaskGetTickCount() - start < pdMS_TO_TICKS(windowMs)) {
+		vTaskDelay(1);
+	}
+	uint32_t edges = uart_ll_get_rxd_edge_cnt(hw);
+	uint32_t low = uart_ll_get_low_pulse_cnt(hw);
+	uint32_t high = uart_ll_get_high_pulse_cnt(hw);
+	uart_ll_set_autobaud_en(hw, false);
+
+	if (edges < AUTOBAUD_MIN_EDGES) return 0;
+	uint32_t pulse = (low < high ? low : high) + 1;
+	return APB_CLK_FREQ / pulse;
+}
+
+/**
+ * @brief Steuert Boot- und Reset-Leitung wie DTR/RTS eines USB-Seriell-Adapters.
+ *
+ * Beide Leitungen sind aktiv low und werden wie Open-Drain betrieben: aktiv = Ausgang LOW,
+ * inaktiv = Eingang, den Pegel bestimmt dann der Pull-up des Controllers.
+ *
+ * @param boot Boot-Pin aktiv.
+ * @param reset Reset aktiv.
+ * @return false, wenn nicht beide Leitungen belegt sind.
+ */
+bool EspUartPort::setBootLines(bool boot, bool reset) {
+	if (_bootPin < 0 || _resetPin < 0) return false;
+	const int8_t pins[] = {_bootPin, _resetPin};
+	const bool active[] = {boot, reset};
+	for (size_t i = 0; i < 2; ++i) {
+		if (active[i]) {
+			digitalWrite(pins[i], LOW);
+			pinMode(pins[i], OUTPUT);
+		} else {
+			pinMode(pins[i], INPUT);
+		}
+	}
+	return true;
+}
@@ -80,6 +80,15 @@ void initFS() {
 	if (!LittleFS.exists("/logs")) {
 		LittleFS.mkdir("/logs");
 	}
+	if (!LittleFS.exists("/scripts")) {
+		LittleFS.mkdir("/scripts");
+	}
+	if (!LittleFS.exists("/poll")) {
+		LittleFS.mkdir("/poll");
+	}
+	if (!LittleFS.exists("/triggers")) {
+		LittleFS.mkdir("/triggers");
+	}
 
 	removeStatus(SYSTEM_INITIALIZING);
 
@@ -27,6 +27,8 @@
 
 #include "LLog.h"
 
+#include <esp_system.h>
+
 #include "global.h"
 
 bool LLog::m_fileLogging = true;
@@ -36,14 +38,15 @@ const std::vector<String> LLog::Events = {"debug", "info", "system", "warning",
  * @brief Konstruktor des LLog-Singletons.
  *
  * Initialisiert das Logging-System, mountet LittleFS und erstellt ggf. die notwendigen
- * Verzeichnisse zur Speicherung der Log-Dateien. Räum beim Intitialiseren automatisch alte Logdateien auf.
+ * Verzeichnisse zur Speicherung der Log-Dateien. Liest die Journal-Segmente ein und
+ * löscht beim Intitialiseren die ältesten, falls Segmentzahl oder Budget überschritten sind.
  * Liest den Status des File-Loggings aus den Preferences.
  * Wenn LittleFS nicht gemountet werden kann, wird eine Fehlermeldung ausgegeben.
  * Wenn das Verzeichnis /logs nicht existiert, wird es erstellt.
  * Wenn das Verzeichnis /logs/system nicht existiert, wird es erstellt.
  * Wenn das Verzeichnis /logs/device nicht existiert, wird es erstellt.
  */
-LLog::LLog() {
+LLog::LLog() : _writerTask(nullptr), _drainLock(xSemaphoreCreateMutex()), _reportedDrops(0), _segments({SEGMENT_BYTES, SEGMENT_COUNT, LOG_BUDGET}), _markTime(0), _markSeq(NO_MARK) {
 	if (!LittleFS.begin()) {
 		logger.log({"system", "error", "filesystem"}, "LittleFS konnte nicht gemountet werden!");
 	}
@@ -53,10 +56,14 @@ LLog::LLog() {
 	Preferences pref;
 	if (pref.begin("debug", true)) {
 		m_fileLogging = pref.getBool("fileLogging", false);
+		LogFilter::setEnabled(pref.getUInt("logMask", LogFilter::enabledMask()));
+		_segments.configure({pref.getUInt("logSegBytes", SEGMENT_BYTES), pref.getUShort("logSegments", SEGMENT_COUNT), pref.getUInt("logBudget", LOG_BUDGET)});
 		pref.end();
 	}
-	// Automatisches Aufräumen beim Start
-	clearLargeLogs();
+	// Segmente einlesen, alte Kategoriedateien einmalig übernehmen, dann aufräumen
+	scanSegments();
+	migrateLegacyLogs();
+	enforceLimits();
 }
 
 /**
@@ -70,67 +77,102 @@ LLog &LLog::getInstance() {
 }
 
 /**
- * @brief Erzeugt einen formatierten Zeitstempel im Format YYYY-MM-DD HH:MM:SS.
+ * @brief Bit einer Kategorie im Journal.
+ *
+ * Vergleicht ohne Groß-/Kleinschreibung und ohne Klammern; unbekannte Kategorien (z. B.
+ * "device", "filesystem") zählen wie bisher zu "general".
+ *
+ * @param event Kategorie, z. B. "info" oder "[INFO]".
+ * @return Bit in LogRecord::files.
+ */
+uint16_t LLog::categoryBit(const char *event) {
+	char name[16];
+	size_t n = 0;
+	for (const char *p = event; *p && n < sizeof(name) - 1; ++p) {
+		if (*p != '[' && *p != ']') name[n++] = (char)tolower((unsigned char)*p);
+	}
+	name[n] = '\0';
+	size_t general = Events.size() - 1;
+	for (size_t i = 0; i < Events.size(); ++i) {
+		if (Events[i] == name) return (uint16_t)(1u << i);
+		if (Events[i] == "general") general = i;
+	}
+	return (uint16_t)(1u << general);
+}
+
+/**
+ * @brief Reiht einen Eintrag ein.
+ *
+ * Im Aufrufer fallen nur das Kopieren in den vorab angelegten Eintrag und ggf. ein
+ * Task-Notify an. Ohne Schreib-Task (früh im Start) wird sofort geschrieben.
+ *
+ * @param tags Kategorien.
+ * @param files Ziel-Logdateien.
+ * @param flags LogRecordFlags.
+ * @param message Nachricht.
+ */
+void LLog::enqueue(const char *tags, uint16_t files, uint8_t flags, const String &message) {
+	_queue.push(tags, files, flags, (uint32_t)time(nullptr), message.c_str(), message.length());
+	wake();
+}
+
+/**
+ * @brief Formatiert eine Meldung direkt in einen Eintrag der Warteschlange.
+ *
+ * Präfix und Journal-Bits kommen aus der Bitmaske, der Text wird erst in der reservierten Zelle
+ * formatiert; es entsteht kein String und keine Allokation.
  *
- * @return Zeitstempel als String.
+ * @param cats Kategorien.
+ * @param fmt printf-Format.
  */
-String LLog::getTimestamp() {
-	time_t now = time(nullptr);
-	struct tm timeinfo;
-	localtime_r(&now, &timeinfo);
-	char buf[20];
-	snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d", timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday, timeinfo.tm_hour,
-	         timeinfo.tm_min, timeinfo.tm_sec);
-	return String(buf);
+void LLog::emitf(uint32_t cats, const char *fmt, ...) {
+	char tags[LogRecord::TAGS];
+	LogFilter::tags(cats, tags, sizeof(tags));
+	va_list args;
+	va_start(args, fmt);
+	_queue.pushv(tags, LogFilter::journalBits(cats), LOG_RECORD_NEWLINE | LOG_RECORD_TIMESTAMP, (uint32_t)time(nullptr), fmt, args);
+	va_end(args);
+	wake();
+}
+
+/**
+ * @brief Schreibt ohne Schreib-Task sofort, sonst weckt es sie bei halb voller Warteschlange.
+ */
+void LLog::wake() {
+	if (!_writerTask) {
+		xSemaphoreTake(_drainLock, portMAX_DELAY);
+		drain();
+		xSemaphoreGive(_drainLock);
+	} else if (_queue.pending() >= LogQueue::SLOTS / 2) {
+		// Halb voll: nicht bis zum nächsten Intervall warten
+		xTaskNotifyGive(_writerTask);
+	}
 }
 
 /**
  * @brief Interne Methode zur Protokollierung einer Log-Nachricht.
  *
- * Diese Methode gibt eine Logzeile sowohl auf der seriellen Schnittstelle aus
- * als auch in die entsprechende Datei im Dateisystem, abhängig vom Log-Level.
+ * Die Zeile wird in der Schreib-Task auf der seriellen Schnittstelle ausgegeben und in die
+ * Datei des Log-Levels geschrieben.
  *
- * @param level Der Log-Level als String (z. B. "[INFO]").
+ * @param level Der Log-Level als String (z. B. "[INFO]").
  * @param message Die zu loggende Nachricht.
  * @param newLine true, um einen Zeilenumbruch am Ende einzufügen.
  * @param timestamp true, um einen Zeitstempel in die Logzeile einzufügen.
  */
 void LLog::logMessage(const char *level, const String &message, bool newLine, bool timestamp) {
-	// 1) Baue Logzeile mit optionalem Zeitstempel
-	String entry;
-	if (timestamp) {
-		entry = String(level) + " [" + getTimestamp() + "] " + message;
-	} else {
-		entry = String(level) + " " + message;
-	}
-
-	// 2) Auf Serial ausgeben
-	if (newLine) {
-		Serial.println(entry);
-	} else {
-		Serial.print(entry);
-	}
-
-	// 3) In Datei speichern
-	String fname = "general.log";
-	// Level-String ohne [] und lowercase
-	String lvl = String(level);
-	lvl.replace("[", "");
-	lvl.replace("]", "");
-	lvl.toLowerCase();
-	auto it = std::find(Events.begin(), Events.end(), lvl);
-	if (it != Events.end()) {
-		fname = *it + ".log";
-	}
-
-	logToFile(fname, entry);
+	if (*level && !LogFilter::enabled(LogFilter::parse(level))) return;
+	uint8_t flags = LOG_RECORD_SPACED;
+	if (newLine) flags |= LOG_RECORD_NEWLINE;
+	if (timestamp) flags |= LOG_RECORD_TIMESTAMP;
+	enqueue(level, categoryBit(level), flags, message);
 }
 
 /**
  * @brief Gibt eine Log-Nachricht mit mehreren Events aus.
  *
  * Die Nachricht wird auf der seriellen Schnittstelle und – je nach Konfiguration – auch
- * in mehrere Logdateien geschrieben (eine pro Event-Kategorie).
+ * in mehrere Logdateien geschrieben (eine pro Event-Kategorie, jede Datei höchstens einmal).
  *
  * @param levels Liste von Event-Kategorien wie "info", "system", "socket".
  * @param message Die zu loggende Nachricht.
@@ -138,68 +180,436 @@ void LLog::logMessage(const char *level, const String &message, bool newLine, bo
  * @param timestamp true, um Zeitstempel voranzustellen.
  */
 void LLog::logMessage(const std::vector<String> &levels, const String &message, bool newLine, bool timestamp) {
-	String prefix;
+	// Präfix direkt in einen Stack-Puffer statt über String-Verkettung
+	char tags[LogRecord::TAGS];
+	size_t n = 0;
+	uint16_t files = 0;
+	uint32_t cats = 0;
+	for (const auto &evt : levels) cats |= LogFilter::parse(evt.c_str());
+	if (!LogFilter::enabled(cats)) return;
 	for (const auto &evt : levels) {
-		String cap = evt;
-		for (size_t i = 0; i < cap.length(); ++i) {
-			cap[i] = toupper(cap[i]);
+		if (n + evt.length() + 2 < sizeof(tags)) {
+			tags[n++] = '[';
+			for (size_t i = 0; i < evt.length(); ++i) tags[n++] = (char)toupper((unsigned char)evt[i]);
+			tags[n++] = ']';
 		}
-		prefix += "[" + cap + "]";
+		files |= categoryBit(evt.c_str());
 	}
+	tags[n] = '\0';
 
-	// 1) Baue Logzeile mit optionalem Zeitstempel
-	String entry;
-	if (timestamp) {
-		entry = prefix + "[" + getTimestamp() + "] " + message;
-	} else {
-		entry = prefix + " " + message;
-	}
-
-	// 2) Auf Serial ausgeben
-	if (newLine) {
-		Serial.println(entry);
-	} else {
-		Serial.print(entry);
-	}
-
-	for (const auto &evt : levels) {
-		// 3) In Datei speichern
-		String fname = "general.log";
-		// Level-String ohne [] und lowercase
-		String lvl = String(evt);
-		lvl.replace("[", "");
-		lvl.replace("]", "");
-		lvl.toLowerCase();
-		auto it = std::find(Events.begin(), Events.end(), lvl);
-		if (it != Events.end()) {
-			fname = *it + ".log";
-		}
+	uint8_t flags = 0;
+	if (newLine) flags |= LOG_RECORD_NEWLINE;
+	if (timestamp) flags |= LOG_RECORD_TIMESTAMP;
+	enqueue(tags, files, flags, message);
+}
 
-		logToFile(fname, entry);
-	}
+/**
+ * @brief Pfad eines Journal-Segments.
+ *
+ * @param seq Nummer des Segments.
+ * @return z. B. "/logs/system/journal.12.log".
+ */
+String LLog::segmentPath(uint32_t seq) {
+	return String(JOURNAL_DIR) + "/journal." + String(seq) + ".log";
 }
 
 /**
- * @brief Schreibt einen Log-Eintrag in die angegebene Datei im LittleFS-Dateisystem.
+ * @brief Öffnet das aktuelle Segment zum Anhängen.
  *
- * @param filename Dateiname der Log-Datei (relativ zu /logs/system/).
- * @param entry Der zu speichernde Log-Eintrag.
+ * @return Geöffnete Datei oder ungültiges Objekt.
  */
-void LLog::logToFile(const String &filename, const String &entry) {
-	if (!m_fileLogging) return;
-	String path = "/logs/system/" + filename;
+File LLog::openJournal() {
+	String path = segmentPath(_segments.active());
 	File f = LittleFS.open(path, FILE_APPEND);
 	if (!f) {
 		File t = LittleFS.open(path, FILE_WRITE);
 		if (t) t.close();
 		f = LittleFS.open(path, FILE_APPEND);
 	}
-	if (f) {
-		f.println(entry);
+	return f;
+}
+
+/**
+ * @brief Liest die Segmente aus `/logs/system` ein.
+ *
+ * Nur hier werden Dateigrößen abgefragt; danach führt der Schreibpfad sie selbst mit.
+ * Segmente, die nicht mehr in die Buchführung passen, werden gelöscht.
+ */
+void LLog::scanSegments() {
+	_segments.clear();
+	std::vector<uint32_t> found;
+	File root = LittleFS.open(JOURNAL_DIR);
+	if (root && root.isDirectory()) {
+		File f;
+		while ((f = root.openNextFile())) {
+			String name = f.name();
+			int idx = name.lastIndexOf('/');
+			if (idx >= 0) name = name.substring(idx + 1);
+			// journal.<n>.log
+			if (name.startsWith("journal.") && name.endsWith(".log") && name.length() > 12) {
+				String num = name.substring(8, name.length() - 4);
+				bool digits = true;
+				for (size_t i = 0; i < num.length(); ++i) digits = digits && isDigit(num[i]);
+				if (digits) {
+					uint32_t seq = (uint32_t)strtoul(num.c_str(), nullptr, 10);
+					found.push_back(seq);
+					_segments.add(seq, (uint32_t)f.size());
+				}
+			}
+			f.close();
+		}
+		root.close();
+	}
+	// Segmente, die nicht in die Buchführung passen (älter als das älteste bekannte)
+	for (uint32_t seq : found) {
+		if (seq < _segments.seqAt(0)) LittleFS.remove(segmentPath(seq));
+	}
+
+	// Ungeteiltes Journal (vor der Rotation) als jüngstes Segment übernehmen
+	String single = String(JOURNAL_DIR) + "/journal.log";
+	if (LittleFS.exists(single)) {
+		File f = LittleFS.open(single, "r");
+		uint32_t bytes = f ? (uint32_t)f.size() : 0;
+		if (f) f.close();
+		uint32_t seq = _segments.count() ? _segments.active() + 1 : 0;
+		if (LittleFS.rename(single, segmentPath(seq))) _segments.add(seq, bytes);
+	}
+	_segments.setExternalBytes(deviceLogBytes());
+}
+
+/**
+ * @brief Löscht älteste Segmente, solange eine Grenze überschritten ist.
+ */
+void LLog::enforceLimits() {
+	uint32_t seq;
+	while (_segments.overLimit(seq)) {
+		LittleFS.remove(segmentPath(seq));
+		_segments.dropOldest();
+	}
+}
+
+/**
+ * @brief Summe der Gerätelogs und Mitschnitte.
+ *
+ * Wird nur beim Start, beim Segmentwechsel und beim Ändern der Grenzen gelesen.
+ *
+ * @return Bytes unter `/logs/device`.
+ */
+uint32_t LLog::deviceLogBytes() {
+	uint32_t total = 0;
+	File root = LittleFS.open("/logs/device");
+	if (!root || !root.isDirectory()) return 0;
+	File f;
+	while ((f = root.openNextFile())) {
+		if (!f.isDirectory()) total += (uint32_t)f.size();
 		f.close();
-	} else {
-		logger.log({"system", "error", "filsystem", "llog"}, "Fehler beim Öffnen von " + path);
 	}
+	root.close();
+	return total;
+}
+
+/**
+ * @brief Übernimmt alte Kategoriedateien ins Journal.
+ *
+ * Jede Datei wird nach dem Kopieren gelöscht, ein Abbruch wiederholt höchstens die Datei, die
+ * gerade übernommen wurde. Überlange Zeilen werden in Stücken übernommen.
+ */
+void LLog::migrateLegacyLogs() {
+	File journal;
+	for (size_t e = 0; e < Events.size(); ++e) {
+		String path = "/logs/system/" + Events[e] + ".log";
+		if (!LittleFS.exists(path)) continue;
+		File src = LittleFS.open(path, "r");
+		if (!src) continue;
+		if (!journal) journal = openJournal();
+		if (!journal) {
+			src.close();
+			return;
+		}
+		char head[LogJournal::PREFIX_LEN + 1];
+		LogJournal::prefix((uint16_t)(1u << e), head);
+		char buf[256];
+		size_t lines = 0;
+		while (src.available()) {
+			size_t n = src.readBytesUntil('\n', buf, sizeof(buf));
+			if (n == 0) continue;
+			size_t written = journal.print(head);
+			written += journal.write((const uint8_t *)buf, n);
+			written += journal.print('\n');
+			_segments.appended((uint32_t)written);
+			lines++;
+		}
+		src.close();
+		LittleFS.remove(path);
+		Serial.println("[LLOG] " + path + " ins Journal übernommen (" + String(lines) + " Zeilen)");
+	}
+	if (journal) journal.close();
+}
+
+/**
+ * @brief Schreibt jedes Segment ohne die angegebenen Kategorien in eine temporäre Datei und
+ *        ersetzt es danach; Zeilen ohne verbleibende Kategorie entfallen.
+ *
+ * @param bits Zu entfernende Kategorien.
+ */
+void LLog::clearCategories(uint16_t bits) {
+	if (bits == 0) return;
+	static const char *const TMP_PATH = "/logs/system/journal.tmp";
+	xSemaphoreTake(_drainLock, portMAX_DELAY);
+	for (size_t s = 0; s < _segments.count(); ++s) {
+		uint32_t seq = _segments.seqAt(s);
+		String path = segmentPath(seq);
+		File src = LittleFS.open(path, "r");
+		File dst = src ? LittleFS.open(TMP_PATH, FILE_WRITE) : File();
+		if (!src || !dst) {
+			if (src) src.close();
+			if (dst) dst.close();
+			continue;
+		}
+		// Längste mögliche Zeile (auch binär), unter _drainLock
+		char *buf = _binaryLine;
+		uint32_t bytes = 0;
+		while (src.available()) {
+			size_t n = src.readBytesUntil('\n', buf, sizeof(_binaryLine) - 1);
+			uint16_t files;
+			const char *text;
+			if (LogJournal::isBinary(buf, n)) {
+				// Binäre Einträge; Zeitmarken bleiben für die folgenden Einträge erhalten
+				n = LogJournal::clearBinaryBits(buf, n, sizeof(_binaryLine) - 1, bits);
+				if (n == 0) continue;
+			} else if (LogJournal::parse(buf, n, files, text) && !LogJournal::clearBits(buf, n, bits)) {
+				// Ungültige Zeilen bleiben unverändert
+				continue;
+			}
+			bytes += dst.write((const uint8_t *)buf, n);
+			bytes += dst.print('\n');
+		}
+		src.close();
+		dst.close();
+		LittleFS.remove(path);
+		LittleFS.rename(TMP_PATH, path);
+		_segments.resize(seq, bytes);
+	}
+	xSemaphoreGive(_drainLock);
+}
+
+/**
+ * @brief Pfade aller Segmente, ältestes zuerst.
+ *
+ * @return Liste der Pfade.
+ */
+std::vector<String> LLog::journalSegments() {
+	std::vector<String> paths;
+	xSemaphoreTake(_drainLock, portMAX_DELAY);
+	for (size_t i = 0; i < _segments.count(); ++i) paths.push_back(segmentPath(_segments.seqAt(i)));
+	xSemaphoreGive(_drainLock);
+	return paths;
+}
+
+/**
+ * @brief Gesamtgröße des Journals.
+ *
+ * @return Bytes aller Segmente.
+ */
+uint32_t LLog::journalBytes() {
+	xSemaphoreTake(_drainLock, portMAX_DELAY);
+	uint32_t bytes = _segments.journalBytes();
+	xSemaphoreGive(_drainLock);
+	return bytes;
+}
+
+/**
+ * @brief Setzt die Grenzen der Rotation.
+ *
+ * Die Werte werden in den Preferences gespeichert; überzählige Segmente werden sofort gelöscht.
+ *
+ * @param config Segmentgröße, Segmentzahl und Budget.
+ */
+void LLog::setRotation(const LogRotationConfig &config) {
+	xSemaphoreTake(_drainLock, portMAX_DELAY);
+	_segments.configure(config);
+	LogRotationConfig applied = _segments.config();
+	_segments.setExternalBytes(deviceLogBytes());
+	enforceLimits();
+	xSemaphoreGive(_drainLock);
+
+	Preferences pref;
+	if (pref.begin("debug", false)) {
+		pref.putUInt("logSegBytes", applied.segmentBytes);
+		pref.putUShort("logSegments", applied.segments);
+		pref.putUInt("logBudget", applied.budget);
+		pref.end();
+	}
+}
+
+/**
+ * @brief Aktuelle Grenzen der Rotation.
+ *
+ * @return Segmentgröße, Segmentzahl und Budget.
+ */
+LogRotationConfig LLog::rotationConfig() {
+	xSemaphoreTake(_drainLock, portMAX_DELAY);
+	LogRotationConfig config = _segments.config();
+	xSemaphoreGive(_drainLock);
+	return config;
+}
+
+/**
+ * @brief Schreibt alle fertigen Einträge.
+ *
+ * Je Block aus WRITER_BATCH Einträgen wird das aktuelle Segment nur einmal geöffnet; passt der
+ * Block nicht mehr hinein, beginnt vorher ein neues. Binäre Einträge (LOGB) werden nur für die
+ * serielle Konsole formatiert, ins Journal gehen Format-ID und Argumente.
+ * Verworfene Einträge (Warteschlange voll) werden als Warnung nachgetragen. Fehler beim
+ * Öffnen gehen nur auf die Konsole, damit kein neuer Eintrag entsteht.
+ *
+ * @return Anzahl der geschriebenen Einträge.
+ */
+size_t LLog::drain() {
+	const LogRecord *recs[WRITER_BATCH];
+	size_t total = 0;
+	size_t n;
+	while ((n = _queue.peek(recs, WRITER_BATCH)) > 0) {
+		uint16_t all = 0;
+		uint32_t bytes = 0;
+		for (size_t i = 0; i < n; ++i) {
+			size_t len = LogQueue::format(*recs[i], _lines[i], sizeof(_lines[i]));
+			if (recs[i]->files) {
+				if (recs[i]->flags & LOG_RECORD_BINARY) {
+					// Schätzung: Markierung, Bitmaske, Kopf, Argumente und '\n'
+					bytes += (uint32_t)(recs[i]->argBytes + 6);
+				} else {
+					// Präfix, Zeile und "\r\n" von println()
+					bytes += (uint32_t)(LogJournal::PREFIX_LEN + len + 2);
+				}
+			}
+			if (recs[i]->flags & LOG_RECORD_NEWLINE) {
+				Serial.println(_lines[i]);
+			} else {
+				Serial.print(_lines[i]);
+			}
+			all |= recs[i]->files;
+		}
+		if (m_fileLogging && all) {
+			// Segmentwechsel anhand der mitgeführten Größe, ohne open/size
+			if (_segments.needsRotation(bytes)) {
+				_segments.rotate();
+				_segments.setExternalBytes(deviceLogBytes());
+				enforceLimits();
+			}
+			// Jede Meldung genau einmal, unabhängig von der Zahl ihrer Kategorien
+			File f = openJournal();
+			if (f) {
+				char head[LogJournal::PREFIX_LEN + 1];
+				size_t written = 0;
+				for (size_t i = 0; i < n; ++i) {
+					if (!recs[i]->files) continue;
+					if (recs[i]->flags & LOG_RECORD_BINARY) {
+						written += writeBinary(f, *recs[i]);
+						continue;
+					}
+					LogJournal::prefix(recs[i]->files, head);
+					written += f.print(head);
+					written += f.println(_lines[i]);
+				}
+				f.close();
+				_segments.appended((uint32_t)written);
+			} else {
+				Serial.println("[LLOG] Fehler beim Öffnen von " + segmentPath(_segments.active()));
+			}
+		}
+		_queue.release(n);
+		total += n;
+	}
+
+	uint32_t dropped = _queue.stats().dropped;
+	if (dropped != _reportedDrops) {
+		String msg = String(dropped - _reportedDrops) + " Logmeldungen verworfen (Warteschlange voll)";
+		_reportedDrops = dropped;
+		_queue.push("[SYSTEM][WARNING]", categoryBit("system") | categoryBit("warning"), LOG_RECORD_NEWLINE | LOG_RECORD_TIMESTAMP, (uint32_t)time(nullptr), msg.c_str(), msg.length());
+	}
+	return total;
+}
+
+/**
+ * @brief Schreibt Zeitmarke (bei Bedarf) und Eintrag als binäre Zeilen.
+ *
+ * @param f Geöffnetes aktuelles Segment.
+ * @param rec Binärer Eintrag.
+ * @return Geschriebene Bytes.
+ */
+size_t LLog::writeBinary(File &f, const LogRecord &rec) {
+	size_t written = 0;
+	uint32_t seq = _segments.active();
+	if (_markSeq != seq || rec.time < _markTime || rec.time - _markTime > LogCodec::MARK_SPAN) {
+		size_t n = LogCodec::encodeMark(rec.time, _payload, sizeof(_payload));
+		size_t len = LogJournal::encodeBinary(0, _payload, n, _binaryLine, sizeof(_binaryLine));
+		written += f.write((const uint8_t *)_binaryLine, len);
+		written += f.print('\n');
+		_markTime = rec.time;
+		_markSeq = seq;
+	}
+	size_t n = LogCodec::encodeEntry(rec.cats, rec.time - _markTime, rec.format, (const uint8_t *)rec.text, rec.argBytes, _payload, sizeof(_payload));
+	size_t len = LogJournal::encodeBinary((uint8_t)rec.files, _payload, n, _binaryLine, sizeof(_binaryLine));
+	if (n == 0 || len == 0) return written;
+	written += f.write((const uint8_t *)_binaryLine, len);
+	written += f.print('\n');
+	return written;
+}
+
+/**
+ * @brief FreeRTOS-Task, die die Warteschlange gebündelt schreibt.
+ *
+ * Wacht alle WRITER_INTERVAL_MS auf oder früher, wenn die Warteschlange halb voll ist.
+ *
+ * @param param Pointer auf die LLog-Instanz.
+ */
+void LLog::writerTaskFunc(void *param) {
+	auto *self = static_cast<LLog *>(param);
+	for (;;) {
+		ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WRITER_INTERVAL_MS));
+		xSemaphoreTake(self->_drainLock, portMAX_DELAY);
+		self->drain();
+		xSemaphoreGive(self->_drainLock);
+	}
+}
+
+/**
+ * @brief Startet die Schreib-Task und registriert den Shutdown-Handler.
+ *
+ * @param priority FreeRTOS-Priorität.
+ * @param core CPU-Kern.
+ */
+void LLog::startWriter(UBaseType_t priority, BaseType_t core) {
+	if (_writerTask) return;
+	xTaskCreatePinnedToCore(writerTaskFunc, "LogWriter", 4096, this, priority, &_writerTask, core);
+	esp_register_shutdown_handler(onShutdown);
+}
+
+/**
+ * @brief Schreibt alle wartenden Einträge im aufrufenden Task.
+ */
+void LLog::flush() {
+	if (xSemaphoreTake(_drainLock, pdMS_TO_TICKS(FLUSH_WAIT_MS)) != pdTRUE) return;
+	drain();
+	xSemaphoreGive(_drainLock);
+	Serial.flush();
+}
+
+/**
+ * @brief Shutdown-Handler für `esp_restart()`.
+ */
+void LLog::onShutdown() {
+	getInstance().flush();
+}
+
+/**
+ * @brief Zähler der Warteschlange.
+ *
+ * @return Eingereiht, verworfen und höchster Füllstand.
+ */
+LogQueueStats LLog::queueStats() const {
+	return _queue.stats();
 }
 
 /**
@@ -308,58 +718,31 @@ void LLog::println(const String &message, bool timestamp) {
 }
 
 /**
- * @brief Leert die Log-Datei für ein bestimmtes Event.
+ * @brief Entfernt die Einträge einer Kategorie aus dem Journal.
  *
- * Öffnet die Datei im Schreibmodus, wodurch ihr Inhalt überschrieben wird.
+ * Einträge mit weiteren Kategorien bleiben für diese erhalten.
  *
- * @param event Name des Events (z. B. "info", "debug").
+ * @param event Name des Events (z. B. "info", "debug").
  */
 void LLog::clearLog(const String &event) {
-	String path = "/logs/system/" + event + ".log";
-	// Öffnen im WRITE-Modus leert die Datei
-	File f = LittleFS.open(path, FILE_WRITE);
-	if (f) f.close();
+	clearLogs({event});
 }
 
 /**
- * @brief Leert mehrere Log-Dateien.
+ * @brief Entfernt die Einträge mehrerer Kategorien in einem Durchlauf.
  *
- * Diese Methode ruft `clearLog()` für jedes übergebene Event auf.
+ * Unbekannte Namen werden ignoriert.
  *
- * @param events Liste von Event-Namen, deren Logs geleert werden sollen.
+ * @param events Liste von Event-Namen, deren Einträge entfernt werden sollen.
  */
 void LLog::clearLogs(const std::vector<String> &events) {
+	uint16_t bits = 0;
 	for (const auto &evt : events) {
-		clearLog(evt);
-	}
-}
-
-/**
- * @brief Löscht Logdateien, deren Größe das Limit überschreitet.
- *
- * Diese Methode prüft die Größe aller bekannten Event-Logdateien im Verzeichnis
- * `/logs/system/` und leert jene, die größer als `maxSize` sind.
- *
- * @param maxSize Maximale erlaubte Dateigröße in Bytes (Standard: 32.000).
- */
-void LLog::clearLargeLogs(size_t maxSize) {
-	for (const auto &evt : Events) {
-		String fname = evt + ".log";
-		String path = "/logs/system/" + fname;
-		if (LittleFS.exists(path)) {
-			File f = LittleFS.open(path, "r");
-			if (f) {
-				if (f.size() > maxSize) {
-					f.close();
-					// Leeren
-					File t = LittleFS.open(path, FILE_WRITE);
-					if (t) t.close();
-				} else {
-					f.close();
-				}
-			}
-		}
+		String name = evt;
+		name.toLowerCase();
+		if (std::find(Events.begin(), Events.end(), name) != Events.end()) bits |= categoryBit(name.c_str());
 	}
+	clearCategories(bits);
 }
 
 /**
@@ -405,6 +788,23 @@ void LLog::setFileLogging(bool enabled) {
 	}
 }
 
+/**
+ * @brief Setzt die zur Laufzeit freigegebenen Kategorien.
+ *
+ * Gesperrte Kategorien werden von LOGF() vor der Formatierung und von log()/info()/... vor dem
+ * Einreihen verworfen. Die Maske wird in den Preferences gespeichert.
+ *
+ * @param mask Bitmaske aus LogCategory.
+ */
+void LLog::setCategories(uint32_t mask) {
+	LogFilter::setEnabled(mask);
+	Preferences preferences;
+	if (preferences.begin("debug", false)) {
+		preferences.putUInt("logMask", mask);
+		preferences.end();
+	}
+}
+
 /**
  * @brief Gibt zurück, ob Dateilogging derzeit aktiviert ist.
  *
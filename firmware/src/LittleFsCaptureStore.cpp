@@ -0,0 +1,138 @@
+/**
+ * @file LittleFsCaptureStore.cpp
+ * @brief Ablage der Mitschnitte auf LittleFS.
+ *
+ * Als älteste Datei gilt die mit dem frühesten Änderungszeitpunkt; ohne gestellte Uhr
+ * (Zeitpunkt 0) entscheidet der Dateiname.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "LittleFsCaptureStore.h"
+
+LittleFsCaptureStore *LittleFsCaptureStore::_stores[LittleFsCaptureStore::MAX_STORES] = {};
+
+/**
+ * @brief Trägt die Instanz in die Liste aller Ablagen ein.
+ */
+LittleFsCaptureStore::LittleFsCaptureStore() {
+	for (size_t i = 0; i < MAX_STORES; ++i) {
+		if (!_stores[i]) {
+			_stores[i] = this;
+			break;
+		}
+	}
+}
+
+/**
+ * @brief Trägt die Instanz aus der Liste aus und schließt das Segment.
+ */
+LittleFsCaptureStore::~LittleFsCaptureStore() {
+	close();
+	for (size_t i = 0; i < MAX_STORES; ++i) {
+		if (_stores[i] == this) _stores[i] = nullptr;
+	}
+}
+
+/**
+ * @brief Prüft, ob irgendeine Instanz das Segment gerade geöffnet hat.
+ */
+bool LittleFsCaptureStore::isOpen(const String &name) {
+	for (size_t i = 0; i < MAX_STORES; ++i) {
+		if (_stores[i] && _stores[i]->_file && _stores[i]->_name == name) return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Prüft, ob ein Dateiname ein Mitschnitt ist.
+ */
+static bool isCapture(const String &name) {
+	return name.endsWith(".cap");
+}
+
+/**
+ * @brief Legt das Segment neu an und öffnet es zum Anhängen.
+ *
+ * @param name Dateiname ohne Verzeichnis.
+ * @return false, wenn die Datei nicht angelegt werden konnte.
+ */
+bool LittleFsCaptureStore::open(const char *name) {
+	close();
+	if (!LittleFS.exists(DIR)) LittleFS.mkdir(DIR);
+	_file = LittleFS.open(String(DIR) + "/" + name, FILE_WRITE);
+	_name = _file ? name : "";
+	return (bool)_file;
+}
+
+/**
+ * @brief Hängt einen Puffer an das Segment an.
+ */
+size_t LittleFsCaptureStore::write(const uint8_t *data, size_t len) {
+	if (!_file) return 0;
+	size_t n = _file.write(data, len);
+	_file.flush();
+	return n;
+}
+
+/**
+ * @brief Schließt das Segment.
+ */
+void LittleFsCaptureStore::close() {
+	if (_file) _file.close();
+	_name = "";
+}
+
+/**
+ * @brief Summe der Größen aller `*.cap`-Dateien.
+ */
+size_t LittleFsCaptureStore::usedBytes() {
+	size_t sum = 0;
+	File dir = LittleFS.open(DIR);
+	if (!dir || !dir.isDirectory()) return 0;
+	for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+		if (!f.isDirectory() && isCapture(f.name())) sum += f.size();
+	}
+	return sum;
+}
+
+/**
+ * @brief Freier Platz im Dateisystem.
+ */
+size_t LittleFsCaptureStore::freeBytes() {
+	size_t total = LittleFS.totalBytes();
+	size_t used = LittleFS.usedBytes();
+	return used < total ? total - used : 0;
+}
+
+/**
+ * @brief Löscht den ältesten Mitschnitt außer `keep` und außer Segmenten anderer Kanäle.
+ *
+ * @param keep Aktuelles Segment.
+ * @return Größe der gelöschten Datei oder 0.
+ */
+size_t LittleFsCaptureStore::removeOldest(const char *keep) {
+	File dir = LittleFS.open(DIR);
+	if (!dir || !dir.isDirectory()) return 0;
+
+	String oldest;
+	time_t oldestTime = 0;
+	size_t oldestSize = 0;
+	for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+		String name = f.name();
+		int slash = name.lastIndexOf('/');
+		if (slash >= 0) name = name.substring(slash + 1);
+		if (f.isDirectory() || !isCapture(name) || name == keep || isOpen(name)) continue;
+		time_t t = f.getLastWrite();
+		if (oldest.length() == 0 || t < oldestTime || (t == oldestTime && name < oldest)) {
+			oldest = name;
+			oldestTime = t;
+			oldestSize = f.size();
+		}
+	}
+	dir.close();
+	if (oldest.length() == 0) return 0;
+	if (!LittleFS.remove(String(DIR) + "/" + oldest)) return 0;
+	return oldestSize > 0 ? oldestSize : 1;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file LogCodec.cpp
+ * @brief Kompakte Kodierung binärer Logeinträge (Format-ID plus rohe Argumente).
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "LogCodec.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "LogFilter.h"
+#include "LogQueue.h"
+
+/**
+ * @brief Schreibt eine Zahl als Varint (7 Bit je Byte, niederwertige zuerst).
+ *
+ * @return Geschriebene Bytes oder 0.
+ */
+size_t LogCodec::putUnsigned(uint8_t *buf, size_t size, uint32_t value) {
+	size_t n = 0;
+	do {
+		if (n >= size) return 0;
+		uint8_t b = value & 0x7F;
+		value >>= 7;
+		buf[n++] = value ? (uint8_t)(b | 0x80) : b;
+	} while (value);
+	return n;
+}
+
+/**
+ * @brief Schreibt eine vorzeichenbehaftete Zahl; kleine Beträge bleiben kurz (Zigzag).
+ *
+ * @return Geschriebene Bytes oder 0.
+ */
+size_t LogCodec::putSigned(uint8_t *buf, size_t size, int32_t value) {
+	return putUnsigned(buf, size, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+/**
+ * @brief Schreibt Länge und Bytes eines Texts.
+ *
+ * Zu lange Texte werden auf MAX_STRING bzw. den Platz im Puffer gekürzt.
+ *
+ * @return Geschriebene Bytes oder 0.
+ */
+size_t LogCodec::putString(uint8_t *buf, size_t size, const char *text) {
+	if (size == 0) return 0;
+	size_t len = text ? strlen(text) : 0;
+	if (len > MAX_STRING) len = MAX_STRING;
+	if (len + 1 > size) len = size - 1;
+	size_t n = putUnsigned(buf, size, (uint32_t)len);
+	memcpy(buf + n, text, len);
+	return n + len;
+}
+
+/**
+ * @brief Liest einen Varint.
+ *
+ * @return false bei unvollständigen Daten.
+ */
+bool LogCodec::getUnsigned(const uint8_t *&p, const uint8_t *end, uint32_t &value) {
+	uint32_t v = 0;
+	for (unsigned shift = 0; shift < 35; shift += 7) {
+		if (p >= end) return false;
+		uint8_t b = *p++;
+		v |= (uint32_t)(b & 0x7F) << shift;
+		if (!(b & 0x80)) {
+			value = v;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Formattext zu einer ID.
+ *
+ * @return Format oder nullptr.
+ */
+const char *LogCodec::format(uint16_t id) {
+	return id > LOG_FMT_NONE && id < LOG_FMT_COUNT ? LOG_FORMAT_STRINGS[id] : nullptr;
+}
+
+/**
+ * @brief Hängt Text an die Ausgabe an (gekürzt, immer mit '\0').
+ */
+static void append(char *out, size_t size, size_t &n, const char *text, size_t len) {
+	if (n + 1 >= size) return;
+	if (len > size - 1 - n) len = size - 1 - n;
+	memcpy(out + n, text, len);
+	n += len;
+	out[n] = '\0';
+}
+
+/**
+ * @brief Ersetzt jede Umwandlung des Formats durch ihr Argument (per snprintf mit der
+ *        originalen Angabe, damit Breite und Flags wirken).
+ *
+ * @return Länge ohne '\0'.
+ */
+size_t LogCodec::render(uint16_t id, const uint8_t *args, size_t argBytes, char *out, size_t size) {
+	if (size == 0) return 0;
+	size_t n = 0;
+	out[0] = '\0';
+	const char *fmt = format(id);
+	if (!fmt) {
+		char unknown[24];
+		int len = snprintf(unknown, sizeof(unknown), "<Format #%u>", (unsigned)id);
+		append(out, size, n, unknown, (size_t)len);
+		return n;
+	}
+	const uint8_t *p = args;
+	const uint8_t *end = args + argBytes;
+	for (const char *f = fmt; *f;) {
+		if (*f != '%') {
+			const char *lit = f;
+			while (*f && *f != '%') f++;
+			append(out, size, n, lit, (size_t)(f - lit));
+			continue;
+		}
+		if (f[1] == '%') {
+			append(out, size, n, "%", 1);
+			f += 2;
+			continue;
+		}
+		// Angabe "%[Flags][Breite][.Genauigkeit]<Umwandlung>" für snprintf kopieren
+		const char *conv = logSpecEnd(f + 1);
+		char spec[16];
+		size_t specLen = (size_t)(conv - f) + 1;
+		uint32_t value;
+		if (!logIsConversion(*conv) || specLen >= sizeof(spec) || !getUnsigned(p, end, value)) {
+			append(out, size, n, "<?>", 3);
+			return n;
+		}
+		memcpy(spec, f, specLen);
+		spec[specLen] = '\0';
+		char piece[MAX_STRING + 32];
+		int len;
+		if (*conv == 's') {
+			char text[MAX_STRING + 1];
+			if (value > MAX_STRING || value > (size_t)(end - p)) {
+				append(out, size, n, "<?>", 3);
+				return n;
+			}
+			memcpy(text, p, value);
+			text[value] = '\0';
+			p += value;
+			len = snprintf(piece, sizeof(piece), spec, text);
+		} else if (*conv == 'd' || *conv == 'i') {
+			int32_t v = (int32_t)((value >> 1) ^ (0u - (value & 1)));
+			len = snprintf(piece, sizeof(piece), spec, (int)v);
+		} else {
+			len = snprintf(piece, sizeof(piece), spec, (unsigned)value);
+		}
+		if (len > 0) append(out, size, n, piece, (size_t)len < sizeof(piece) ? (size_t)len : sizeof(piece) - 1);
+		f = conv + 1;
+	}
+	return n;
+}
+
+/**
+ * @brief Setzt Präfix, Zeitstempel und Text zu einer Logzeile zusammen.
+ *
+ * @return Länge ohne '\0'.
+ */
+size_t LogCodec::renderLine(uint32_t cats, uint32_t time, uint16_t id, const uint8_t *args, size_t argBytes, char *out, size_t size) {
+	char tags[LogRecord::TAGS];
+	char text[LogRecord::TEXT];
+	LogFilter::tags(cats, tags, sizeof(tags));
+	render(id, args, argBytes, text, sizeof(text));
+	return LogQueue::formatLine(tags, LOG_RECORD_TIMESTAMP, time, text, out, size);
+}
+
+/**
+ * @brief Kodiert eine Zeitmarke.
+ *
+ * @return Länge.
+ */
+size_t LogCodec::encodeMark(uint32_t time, uint8_t *buf, size_t size) {
+	return putUnsigned(buf, size, time);
+}
+
+/**
+ * @brief Liest eine Zeitmarke.
+ *
+ * @return false bei ungültigem Inhalt.
+ */
+bool LogCodec::decodeMark(const uint8_t *buf, size_t len, uint32_t &time) {
+	const uint8_t *p = buf;
+	return getUnsigned(p, buf + len, time) && p == buf + len;
+}
+
+/**
+ * @brief Kodiert Kategorien, Zeitabstand, ID und Argumente.
+ *
+ * @return Länge oder 0.
+ */
+size_t LogCodec::encodeEntry(uint32_t cats, uint32_t delta, uint16_t id, const uint8_t *args, size_t argBytes, uint8_t *buf, size_t size) {
+	size_t n = putUnsigned(buf, size, cats);
+	size_t m = n ? putUnsigned(buf + n, size - n, delta) : 0;
+	if (!m) return 0;
+	n += m;
+	m = putUnsigned(buf + n, size - n, id);
+	if (!m || n + m + argBytes > size) return 0;
+	n += m;
+	memcpy(buf + n, args, argBytes);
+	return n + argBytes;
+}
+
+/**
+ * @brief Zerlegt einen Eintrag.
+ *
+ * @return false bei unvollständigem Kopf.
+ */
+bool LogCodec::decodeEntry(const uint8_t *buf, size_t len, LogBinaryEntry &entry) {
+	const uint8_t *p = buf;
+	const uint8_t *end = buf + len;
+	uint32_t id;
+	if (!getUnsigned(p, end, entry.cats) || !getUnsigned(p, end, entry.delta) || !getUnsigned(p, end, id) || id > 0xFFFF) return false;
+	entry.format = (uint16_t)id;
+	entry.args = p;
+	entry.argBytes = (size_t)(end - p);
+	return true;
+}
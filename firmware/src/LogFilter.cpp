@@ -0,0 +1,122 @@
+/**
+ * @file LogFilter.cpp
+ * @brief Log-Kategorien als Bitmaske mit Filter zur Übersetzungs- und Laufzeit.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "LogFilter.h"
+
+#include <cctype>
+#include <cstring>
+
+std::atomic<uint32_t> LogFilter::_enabled(0xFFFFFFFFu);
+
+/**
+ * @struct LogCategoryName
+ * @brief Name und Präfix einer Kategorie.
+ */
+struct LogCategoryName {
+	uint32_t bit;      ///< Kategorie
+	const char *name;  ///< Name in Kleinbuchstaben
+	const char *tag;   ///< Präfix in der Logzeile
+};
+
+/// Kategorien in der Reihenfolge ihrer Präfixe: Quelle, Level, Thema
+static const LogCategoryName CATEGORIES[] = {
+    {LOG_CAT_SYSTEM, "system", "[SYSTEM]"},
+    {LOG_CAT_SOCKET, "socket", "[SOCKET]"},
+    {LOG_CAT_SERIAL, "serial", "[SERIAL]"},
+    {LOG_CAT_HTTP, "http", "[HTTP]"},
+    {LOG_CAT_DEBUG, "debug", "[DEBUG]"},
+    {LOG_CAT_INFO, "info", "[INFO]"},
+    {LOG_CAT_WARNING, "warning", "[WARNING]"},
+    {LOG_CAT_ERROR, "error", "[ERROR]"},
+    {LOG_CAT_WIFI, "wifi", "[WIFI]"},
+    {LOG_CAT_DEVICE, "device", "[DEVICE]"},
+    {LOG_CAT_FILESYSTEM, "filesystem", "[FILESYSTEM]"},
+    {LOG_CAT_LLOG, "llog", "[LLOG]"},
+    {LOG_CAT_GENERAL, "general", "[GENERAL]"},
+};
+
+/**
+ * @brief Setzt die freigegebenen Kategorien.
+ *
+ * @param mask Bitmaske aus LogCategory.
+ */
+void LogFilter::setEnabled(uint32_t mask) {
+	_enabled.store(mask, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Freigegebene Kategorien.
+ *
+ * @return Bitmaske.
+ */
+uint32_t LogFilter::enabledMask() {
+	return _enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Kategorie zu einem Namen.
+ *
+ * @return Bit oder 0.
+ */
+uint32_t LogFilter::parse(const char *name) {
+	char lower[16];
+	size_t n = 0;
+	for (const char *p = name; *p && n < sizeof(lower) - 1; ++p) {
+		if (*p != '[' && *p != ']') lower[n++] = (char)tolower((unsigned char)*p);
+	}
+	lower[n] = '\0';
+	for (const auto &c : CATEGORIES) {
+		if (strcmp(c.name, lower) == 0) return c.bit;
+	}
+	return 0;
+}
+
+/**
+ * @brief Name einer Kategorie.
+ *
+ * @return Name oder nullptr.
+ */
+const char *LogFilter::name(uint32_t bit) {
+	for (const auto &c : CATEGORIES) {
+		if (c.bit == bit) return c.name;
+	}
+	return nullptr;
+}
+
+/**
+ * @brief Schreibt die Präfixe aller gesetzten Kategorien.
+ *
+ * @return Länge ohne '\0'.
+ */
+size_t LogFilter::tags(uint32_t cats, char *buf, size_t size) {
+	size_t n = 0;
+	if (size == 0) return 0;
+	for (const auto &c : CATEGORIES) {
+		if (!(cats & c.bit)) continue;
+		size_t len = strlen(c.tag);
+		if (n + len >= size) continue;
+		memcpy(buf + n, c.tag, len);
+		n += len;
+	}
+	buf[n] = '\0';
+	return n;
+}
+
+/**
+ * @brief Bitmaske im Log-Journal.
+ *
+ * Entspricht LLog::categoryBit() je Name: Themen ohne eigene Journal-Kategorie zählen zu
+ * "general".
+ *
+ * @return Journal-Bits.
+ */
+uint16_t LogFilter::journalBits(uint32_t cats) {
+	uint16_t bits = (uint16_t)(cats & JOURNAL_MASK);
+	if (cats & ~JOURNAL_MASK) bits |= (uint16_t)LOG_CAT_GENERAL;
+	return bits;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file LogJournal.cpp
+ * @brief Zeilenformat des gemeinsamen Logjournals aller Kategorien.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "LogJournal.h"
+
+#include <cstring>
+
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+/**
+ * @brief Wert einer Hex-Ziffer.
+ *
+ * @return 0–15 oder -1.
+ */
+static int hexValue(char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	return -1;
+}
+
+/**
+ * @brief Schreibt "XXXX " und ein abschließendes '\0'.
+ *
+ * @return PREFIX_LEN.
+ */
+size_t LogJournal::prefix(uint16_t files, char *buf) {
+	for (int i = 0; i < 4; ++i) buf[i] = HEX_DIGITS[(files >> (12 - 4 * i)) & 0x0F];
+	buf[4] = ' ';
+	buf[5] = '\0';
+	return PREFIX_LEN;
+}
+
+/**
+ * @brief Zerlegt eine Journalzeile.
+ *
+ * @return false ohne gültiges Präfix.
+ */
+bool LogJournal::parse(const char *line, size_t len, uint16_t &files, const char *&text) {
+	if (len < PREFIX_LEN || line[4] != ' ') return false;
+	uint16_t value = 0;
+	for (int i = 0; i < 4; ++i) {
+		int v = hexValue(line[i]);
+		if (v < 0) return false;
+		value = (uint16_t)((value << 4) | v);
+	}
+	files = value;
+	text = line + PREFIX_LEN;
+	return true;
+}
+
+/**
+ * @brief Entfernt Kategorien aus einer Zeile.
+ *
+ * @return false, wenn die Zeile entfällt.
+ */
+bool LogJournal::clearBits(char *line, size_t len, uint16_t bits) {
+	uint16_t files;
+	const char *text;
+	if (!parse(line, len, files, text)) return false;
+	files &= (uint16_t)~bits;
+	if (files == 0) return false;
+	char head[PREFIX_LEN + 1];
+	prefix(files, head);
+	for (size_t i = 0; i < PREFIX_LEN; ++i) line[i] = head[i];
+	return true;
+}
+
+/**
+ * @brief Prüft, ob ein Byte in binären Zeilen maskiert wird.
+ */
+static bool needsEscape(uint8_t b) {
+	return b == 0x00 || b == '\n' || b == '\r' || b == (uint8_t)LogJournal::ESCAPE;
+}
+
+/**
+ * @brief Schreibt ein Byte, bei Bedarf maskiert.
+ *
+ * @return false, wenn der Puffer nicht reicht.
+ */
+static bool putEscaped(uint8_t b, char *line, size_t size, size_t &n) {
+	if (needsEscape(b)) {
+		if (n + 2 >= size) return false;
+		line[n++] = LogJournal::ESCAPE;
+		line[n++] = (char)(b ^ 0x40);
+	} else {
+		if (n + 1 >= size) return false;
+		line[n++] = (char)b;
+	}
+	return true;
+}
+
+/**
+ * @brief Prüft das erste Zeichen.
+ */
+bool LogJournal::isBinary(const char *line, size_t len) {
+	return len >= 2 && line[0] == BINARY_MARK;
+}
+
+/**
+ * @brief Schreibt Markierung, Bitmaske und Inhalt maskiert.
+ *
+ * @return Länge der Zeile oder 0.
+ */
+size_t LogJournal::encodeBinary(uint8_t files, const uint8_t *payload, size_t len, char *line, size_t size) {
+	size_t n = 0;
+	if (size < 2) return 0;
+	line[n++] = BINARY_MARK;
+	if (!putEscaped(files, line, size, n)) return 0;
+	for (size_t i = 0; i < len; ++i) {
+		if (!putEscaped(payload[i], line, size, n)) return 0;
+	}
+	line[n] = '\0';
+	return n;
+}
+
+/**
+ * @brief Hebt die Maskierung auf.
+ *
+ * @return false bei beschädigter Zeile oder zu kleinem Puffer.
+ */
+bool LogJournal::parseBinary(const char *line, size_t len, uint8_t &files, uint8_t *payload, size_t size, size_t &payloadLen) {
+	if (!isBinary(line, len)) return false;
+	size_t n = 0;
+	bool first = true;
+	for (size_t i = 1; i < len; ++i) {
+		uint8_t b = (uint8_t)line[i];
+		if (b == (uint8_t)ESCAPE) {
+			if (++i >= len) return false;
+			b = (uint8_t)(line[i] ^ 0x40);
+		}
+		if (first) {
+			files = b;
+			first = false;
+		} else {
+			if (n >= size) return false;
+			payload[n++] = b;
+		}
+	}
+	payloadLen = n;
+	return !first;
+}
+
+/**
+ * @brief Ersetzt das (ggf. maskierte) Byte der Bitmaske.
+ *
+ * @return Neue Länge oder 0.
+ */
+size_t LogJournal::clearBinaryBits(char *line, size_t len, size_t size, uint16_t bits) {
+	if (!isBinary(line, len)) return 0;
+	size_t oldLen = line[1] == ESCAPE ? 2 : 1;
+	if (1 + oldLen > len) return 0;
+	uint8_t files = oldLen == 2 ? (uint8_t)(line[2] ^ 0x40) : (uint8_t)line[1];
+	if (files == 0) return len;
+	files &= (uint8_t)~bits;
+	if (files == 0) return 0;
+	size_t newLen = needsEscape(files) ? 2 : 1;
+	if (len - oldLen + newLen > size) return 0;
+	memmove(line + 1 + newLen, line + 1 + oldLen, len - 1 - oldLen);
+	if (newLen == 2) {
+		line[1] = ESCAPE;
+		line[2] = (char)(files ^ 0x40);
+	} else {
+		line[1] = (char)files;
+	}
+	return len - oldLen + newLen;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file LogQueue.cpp
+ * @brief Sperrfreie Warteschlange (mehrere Erzeuger, ein Verbraucher) für Logeinträge.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "LogQueue.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "LogCodec.h"
+
+static_assert((LogQueue::SLOTS & (LogQueue::SLOTS - 1)) == 0, "SLOTS muss eine Zweierpotenz sein");
+
+/**
+ * @brief Konstruktor: alle Zellen sind frei.
+ */
+LogQueue::LogQueue() : _head(0), _tail(0), _enqueued(0), _dropped(0), _highWater(0) {
+	for (size_t i = 0; i < SLOTS; ++i) _cells[i].seq.store((uint32_t)i, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Reserviert die nächste freie Zelle per Compare-and-Swap auf der Schreibposition.
+ *
+ * @param ticket Erhält die Position.
+ * @return Eintrag oder nullptr bei vollem Ring.
+ */
+LogRecord *LogQueue::reserve(uint32_t &ticket) {
+	uint32_t pos = _head.load(std::memory_order_relaxed);
+	for (;;) {
+		Cell &cell = _cells[pos & (SLOTS - 1)];
+		uint32_t seq = cell.seq.load(std::memory_order_acquire);
+		int32_t diff = (int32_t)(seq - pos);
+		if (diff == 0) {
+			if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				ticket = pos;
+				uint32_t fill = pos + 1 - _tail.load(std::memory_order_relaxed);
+				uint32_t high = _highWater.load(std::memory_order_relaxed);
+				while (fill > high && !_highWater.compare_exchange_weak(high, fill, std::memory_order_relaxed)) {
+				}
+				return &cell.record;
+			}
+		} else if (diff < 0) {
+			// Zelle noch vom letzten Umlauf belegt: Ring voll
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		} else {
+			pos = _head.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+/**
+ * @brief Markiert die Zelle als befüllt.
+ *
+ * @param ticket Position aus reserve().
+ */
+void LogQueue::commit(uint32_t ticket) {
+	_cells[ticket & (SLOTS - 1)].seq.store(ticket + 1, std::memory_order_release);
+	_enqueued.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Kürzt einen zu langen Text an einer UTF-8-Zeichengrenze und hängt "..." an.
+ *
+ * @param rec Eintrag mit mindestens TEXT - 4 gültigen Bytes im Text.
+ */
+static void truncateText(LogRecord *rec) {
+	// Nicht mitten in einem UTF-8-Zeichen kürzen
+	size_t len = LogRecord::TEXT - 4;
+	while (len > 0 && ((uint8_t)rec->text[len] & 0xC0) == 0x80) len--;
+	memcpy(rec->text + len, "...", 4);
+	rec->flags |= LOG_RECORD_TRUNCATED;
+}
+
+/**
+ * @brief Reiht einen Eintrag ein.
+ *
+ * @return false, wenn der Ring voll ist.
+ */
+bool LogQueue::push(const char *tags, uint16_t files, uint8_t flags, uint32_t time, const char *text, size_t len) {
+	uint32_t ticket;
+	LogRecord *rec = reserve(ticket);
+	if (!rec) return false;
+	rec->time = time;
+	rec->files = files;
+	rec->flags = flags;
+	rec->argBytes = 0;
+	snprintf(rec->tags, sizeof(rec->tags), "%s", tags);
+	if (len >= LogRecord::TEXT) {
+		memcpy(rec->text, text, LogRecord::TEXT - 1);
+		truncateText(rec);
+	} else {
+		memcpy(rec->text, text, len);
+		rec->text[len] = '\0';
+	}
+	commit(ticket);
+	return true;
+}
+
+/**
+ * @brief Reiht einen Eintrag ein und formatiert den Text in der Zelle.
+ *
+ * @return false, wenn der Ring voll ist.
+ */
+bool LogQueue::pushv(const char *tags, uint16_t files, uint8_t flags, uint32_t time, const char *fmt, va_list args) {
+	uint32_t ticket;
+	LogRecord *rec = reserve(ticket);
+	if (!rec) return false;
+	rec->time = time;
+	rec->files = files;
+	rec->flags = flags;
+	rec->argBytes = 0;
+	snprintf(rec->tags, sizeof(rec->tags), "%s", tags);
+	int n = vsnprintf(rec->text, sizeof(rec->text), fmt, args);
+	if (n < 0) {
+		rec->text[0] = '\0';
+	} else if ((size_t)n >= LogRecord::TEXT) {
+		truncateText(rec);
+	}
+	commit(ticket);
+	return true;
+}
+
+/**
+ * @brief Formatiert einen Eintrag wie bisher LLog::logMessage().
+ *
+ * @return Länge der Zeile.
+ */
+size_t LogQueue::format(const LogRecord &record, char *buf, size_t size) {
+	if (record.flags & LOG_RECORD_BINARY) {
+		return LogCodec::renderLine(record.cats, record.time, record.format, (const uint8_t *)record.text, record.argBytes, buf, size);
+	}
+	return formatLine(record.tags, record.flags, record.time, record.text, buf, size);
+}
+
+/**
+ * @brief Setzt Kategorien, Zeitstempel und Text zusammen.
+ *
+ * @return Länge der Zeile.
+ */
+size_t LogQueue::formatLine(const char *tags, uint8_t flags, uint32_t time, const char *text, char *buf, size_t size) {
+	int n;
+	if (flags & LOG_RECORD_TIMESTAMP) {
+		time_t t = (time_t)time;
+		struct tm tm;
+		localtime_r(&t, &tm);
+		n = snprintf(buf, size, "%s%s[%04d-%02d-%02d %02d:%02d:%02d] %s", tags, (flags & LOG_RECORD_SPACED) ? " " : "", tm.tm_year + 1900, tm.tm_mon + 1,
+		             tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, text);
+	} else {
+		n = snprintf(buf, size, "%s %s", tags, text);
+	}
+	if (n < 0) n = 0;
+	return (size_t)n < size ? (size_t)n : size - 1;
+}
+
+/**
+ * @brief Liefert die fertigen Einträge ab der Leseposition.
+ *
+ * @param out Feld für die Zeiger.
+ * @param max Größe des Felds.
+ * @return Anzahl der Einträge.
+ */
+size_t LogQueue::peek(const LogRecord **out, size_t max) const {
+	uint32_t pos = _tail.load(std::memory_order_relaxed);
+	size_t n = 0;
+	while (n < max && n < SLOTS) {
+		const Cell &cell = _cells[(pos + n) & (SLOTS - 1)];
+		if (cell.seq.load(std::memory_order_acquire) != pos + n + 1) break;
+		out[n++] = &cell.record;
+	}
+	return n;
+}
+
+/**
+ * @brief Gibt Zellen für den nächsten Umlauf frei.
+ *
+ * @param count Anzahl aus peek().
+ */
+void LogQueue::release(size_t count) {
+	uint32_t pos = _tail.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < count; ++i, ++pos) {
+		_cells[pos & (SLOTS - 1)].seq.store(pos + SLOTS, std::memory_order_release);
+	}
+	_tail.store(pos, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Reservierte, noch nicht entfernte Einträge.
+ *
+ * @return Füllstand.
+ */
+size_t LogQueue::pending() const {
+	return _head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Kopie der Zähler.
+ *
+ * @return Zähler.
+ */
+LogQueueStats LogQueue::stats() const {
+	return {_enqueued.load(std::memory_order_relaxed), _dropped.load(std::memory_order_relaxed), _highWater.load(std::memory_order_relaxed)};
+}
@@ -0,0 +1,185 @@
+/**
+ * @file LogSegments.cpp
+ * @brief Buchführung und Rotationsregeln für die Segmente des Log-Journals.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "LogSegments.h"
+
+/**
+ * @brief Konstruktor: noch keine Segmente bekannt.
+ */
+LogSegments::LogSegments(const LogRotationConfig &config) : _count(0), _externalBytes(0) {
+	configure(config);
+}
+
+/**
+ * @brief Setzt neue Grenzen.
+ *
+ * Die Segmentzahl wird auf 1 bis MAX_SEGMENTS, die Segmentgröße auf mindestens
+ * MIN_SEGMENT_BYTES begrenzt.
+ */
+void LogSegments::configure(const LogRotationConfig &config) {
+	_config = config;
+	if (_config.segments < 1) _config.segments = 1;
+	if (_config.segments > MAX_SEGMENTS) _config.segments = MAX_SEGMENTS;
+	if (_config.segmentBytes < MIN_SEGMENT_BYTES) _config.segmentBytes = MIN_SEGMENT_BYTES;
+}
+
+/**
+ * @brief Gibt die aktuellen Grenzen zurück.
+ */
+LogRotationConfig LogSegments::config() const {
+	return _config;
+}
+
+/**
+ * @brief Vergisst alle Segmente.
+ */
+void LogSegments::clear() {
+	_count = 0;
+}
+
+/**
+ * @brief Sortiert ein Segment ein.
+ *
+ * @return false, wenn kein Platz ist und das Segment älter als alle bekannten ist.
+ */
+bool LogSegments::add(uint32_t seq, uint32_t bytes) {
+	size_t pos = 0;
+	while (pos < _count && _seq[pos] < seq) pos++;
+	if (pos < _count && _seq[pos] == seq) {
+		_bytes[pos] = bytes;
+		return true;
+	}
+	if (_count == CAPACITY) {
+		// Voll: das älteste weicht, sofern das neue jünger ist
+		if (pos == 0) return false;
+		for (size_t i = 1; i < pos; ++i) {
+			_seq[i - 1] = _seq[i];
+			_bytes[i - 1] = _bytes[i];
+		}
+		pos--;
+	} else {
+		for (size_t i = _count; i > pos; --i) {
+			_seq[i] = _seq[i - 1];
+			_bytes[i] = _bytes[i - 1];
+		}
+		_count++;
+	}
+	_seq[pos] = seq;
+	_bytes[pos] = bytes;
+	return true;
+}
+
+/**
+ * @brief Nummer des aktuellen Segments.
+ */
+uint32_t LogSegments::active() {
+	if (_count == 0) add(0, 0);
+	return _seq[_count - 1];
+}
+
+/**
+ * @brief Anzahl bekannter Segmente.
+ */
+size_t LogSegments::count() const {
+	return _count;
+}
+
+/**
+ * @brief Nummer des i-ten Segments.
+ */
+uint32_t LogSegments::seqAt(size_t index) const {
+	return index < _count ? _seq[index] : 0;
+}
+
+/**
+ * @brief Größe des i-ten Segments.
+ */
+uint32_t LogSegments::bytesAt(size_t index) const {
+	return index < _count ? _bytes[index] : 0;
+}
+
+/**
+ * @brief Summe aller Segmente.
+ */
+uint32_t LogSegments::journalBytes() const {
+	uint32_t total = 0;
+	for (size_t i = 0; i < _count; ++i) total += _bytes[i];
+	return total;
+}
+
+/**
+ * @brief Setzt den übrigen Platzbedarf unter `/logs`.
+ */
+void LogSegments::setExternalBytes(uint32_t bytes) {
+	_externalBytes = bytes;
+}
+
+/**
+ * @brief Prüft, ob ein neues Segment beginnen muss.
+ */
+bool LogSegments::needsRotation(uint32_t incoming) const {
+	if (_count == 0) return false;
+	uint32_t current = _bytes[_count - 1];
+	return current > 0 && current + incoming > _config.segmentBytes;
+}
+
+/**
+ * @brief Beginnt ein neues Segment mit der nächsten Nummer.
+ *
+ * Die Buchführung fasst ein Segment mehr als erlaubt; overLimit() meldet danach das
+ * älteste zum Löschen.
+ */
+uint32_t LogSegments::rotate() {
+	uint32_t next = active() + 1;
+	add(next, 0);
+	return next;
+}
+
+/**
+ * @brief Verbucht geschriebene Bytes.
+ */
+void LogSegments::appended(uint32_t bytes) {
+	active();
+	_bytes[_count - 1] += bytes;
+}
+
+/**
+ * @brief Setzt die Größe eines Segments.
+ */
+void LogSegments::resize(uint32_t seq, uint32_t bytes) {
+	for (size_t i = 0; i < _count; ++i) {
+		if (_seq[i] == seq) {
+			_bytes[i] = bytes;
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Prüft Segmentzahl und Gesamtbudget.
+ */
+bool LogSegments::overLimit(uint32_t &seq) const {
+	if (_count <= 1) return false;
+	if (_count > _config.segments || journalBytes() + _externalBytes > _config.budget) {
+		seq = _seq[0];
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Entfernt das älteste Segment.
+ */
+void LogSegments::dropOldest() {
+	if (_count == 0) return;
+	for (size_t i = 1; i < _count; ++i) {
+		_seq[i - 1] = _seq[i];
+		_bytes[i - 1] = _bytes[i];
+	}
+	_count--;
+}
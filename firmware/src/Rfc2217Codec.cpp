@@ -0,0 +1,445 @@
+/**
+ * @file Rfc2217Codec.cpp
+ * @brief Telnet-Zustandsautomat und COM-Port-Befehle nach RFC 2217.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "Rfc2217Codec.h"
+
+#include <cstring>
+
+namespace {
+
+// COM-PORT-OPTION: Befehlscodes des Clients (Antwort des Servers jeweils + 100)
+constexpr uint8_t CPO_SIGNATURE = 0;
+constexpr uint8_t CPO_SET_BAUDRATE = 1;
+constexpr uint8_t CPO_SET_DATASIZE = 2;
+constexpr uint8_t CPO_SET_PARITY = 3;
+constexpr uint8_t CPO_SET_STOPSIZE = 4;
+constexpr uint8_t CPO_SET_CONTROL = 5;
+constexpr uint8_t CPO_SET_LINESTATE_MASK = 10;
+constexpr uint8_t CPO_SET_MODEMSTATE_MASK = 11;
+constexpr uint8_t CPO_PURGE_DATA = 12;
+
+// Einzig unterstütztes Datenformat: 8 Datenbits, keine Parität, 1 Stoppbit
+constexpr uint8_t DATASIZE_8 = 8;
+constexpr uint8_t PARITY_NONE = 1;
+constexpr uint8_t STOPSIZE_1 = 1;
+
+// SET-CONTROL-Werte (RFC 2217, Abschnitt "SET-CONTROL")
+constexpr uint8_t CTRL_FLOW_QUERY = 0;
+constexpr uint8_t CTRL_FLOW_NONE = 1;
+constexpr uint8_t CTRL_FLOW_HARDWARE = 3;
+constexpr uint8_t CTRL_BREAK_QUERY = 4;
+constexpr uint8_t CTRL_BREAK_ON = 5;
+constexpr uint8_t CTRL_BREAK_OFF = 6;
+constexpr uint8_t CTRL_DTR_QUERY = 7;
+constexpr uint8_t CTRL_DTR_ON = 8;
+constexpr uint8_t CTRL_DTR_OFF = 9;
+constexpr uint8_t CTRL_RTS_QUERY = 10;
+constexpr uint8_t CTRL_RTS_ON = 11;
+constexpr uint8_t CTRL_RTS_OFF = 12;
+
+}  // namespace
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param port Serielle Seite.
+ */
+Rfc2217Codec::Rfc2217Codec(SerialTcpPort &port) : _port(port) {
+	begin();
+}
+
+/**
+ * @brief Setzt den Zustand zurück und fordert die eigenen Optionen an.
+ */
+void Rfc2217Codec::begin() {
+	_state = ST_DATA;
+	_verb = 0;
+	_local = 0;
+	_remote = 0;
+	_localPending = 0;
+	_remotePending = 0;
+	_lastCr = false;
+	_sbLen = 0;
+	_sbOverflow = false;
+	_replyLen = 0;
+	_droppedReplies = 0;
+	_flow = CTRL_FLOW_NONE;
+	_breakState = CTRL_BREAK_OFF;
+	_dtr = CTRL_DTR_ON;
+	_rts = CTRL_RTS_ON;
+	_lineMask = 0;
+	_modemMask = 0;
+
+	sendOption(WILL, OPT_BINARY);
+	sendOption(DO, OPT_BINARY);
+	sendOption(WILL, OPT_SGA);
+	sendOption(DO, OPT_SGA);
+	sendOption(DO, OPT_COM_PORT);
+}
+
+/**
+ * @brief Bit einer unterstützten Option in den Bitmasken oder 0.
+ */
+uint8_t Rfc2217Codec::optionBit(uint8_t option) {
+	switch (option) {
+		case OPT_BINARY:
+			return 0x01;
+		case OPT_SGA:
+			return 0x02;
+		case OPT_COM_PORT:
+			return 0x04;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief Verarbeitet empfangene Bytes.
+ *
+ * @param in Empfangene Bytes.
+ * @param len Anzahl der Bytes.
+ * @param data Ausgabe der Nutzdaten.
+ * @param control true, wenn der Client die UART steuern darf.
+ * @return Anzahl der Nutzdaten.
+ */
+size_t Rfc2217Codec::decode(const uint8_t *in, size_t len, uint8_t *data, bool control) {
+	size_t out = 0;
+	const bool binary = (_remote & optionBit(OPT_BINARY)) != 0;
+	for (size_t i = 0; i < len; ++i) {
+		uint8_t c = in[i];
+		switch (_state) {
+			case ST_DATA:
+				if (c == IAC) {
+					_state = ST_IAC;
+				} else if (!(c == 0 && _lastCr && !binary)) {
+					data[out++] = c;
+					_lastCr = c == '\r';
+				} else {
+					_lastCr = false;
+				}
+				break;
+			case ST_IAC:
+				if (c == IAC) {
+					data[out++] = IAC;
+					_lastCr = false;
+					_state = ST_DATA;
+				} else if (c == WILL || c == WONT || c == DO || c == DONT) {
+					_verb = c;
+					_state = ST_OPTION;
+				} else if (c == SB) {
+					_sbLen = 0;
+					_sbOverflow = false;
+					_state = ST_SB;
+				} else {
+					_state = ST_DATA;  // NOP, AYT, GA, ... werden ignoriert
+				}
+				break;
+			case ST_OPTION:
+				negotiate(_verb, c);
+				_state = ST_DATA;
+				break;
+			case ST_SB:
+				if (c == IAC) {
+					_state = ST_SB_IAC;
+				} else if (_sbLen < SUBNEG_MAX) {
+					_sb[_sbLen++] = c;
+				} else {
+					_sbOverflow = true;
+				}
+				break;
+			case ST_SB_IAC:
+				if (c == SE) {
+					if (!_sbOverflow) subnegotiation(control);
+					_state = ST_DATA;
+				} else if (c == IAC) {
+					if (_sbLen < SUBNEG_MAX) {
+						_sb[_sbLen++] = IAC;
+					} else {
+						_sbOverflow = true;
+					}
+					_state = ST_SB;
+				} else {
+					_state = ST_SB;  // ungültig, wie bei anderen Implementierungen ignorieren
+				}
+				break;
+		}
+	}
+	return out;
+}
+
+/**
+ * @brief Beantwortet WILL/WONT/DO/DONT des Clients.
+ *
+ * Antworten auf eigene Anfragen werden nur übernommen, ohne erneut zu antworten, damit keine
+ * Aushandlungsschleife entsteht (RFC 1143).
+ *
+ * @param verb Empfangenes WILL, WONT, DO oder DONT.
+ * @param option Betroffene Option.
+ */
+void Rfc2217Codec::negotiate(uint8_t verb, uint8_t option) {
+	uint8_t bit = optionBit(option);
+	switch (verb) {
+		case WILL:
+			if (_remotePending & bit) {
+				_remotePending &= (uint8_t)~bit;
+				_remote |= bit;
+			} else if (!bit) {
+				sendOption(DONT, option);
+			} else if (!(_remote & bit)) {
+				_remote |= bit;
+				sendOption(DO, option);
+			}
+			break;
+		case WONT:
+			if (_remotePending & bit) {
+				_remotePending &= (uint8_t)~bit;
+				_remote &= (uint8_t)~bit;
+			} else if (_remote & bit) {
+				_remote &= (uint8_t)~bit;
+				sendOption(DONT, option);
+			}
+			break;
+		case DO:
+			// COM-PORT-OPTION bietet nur der Client an (WILL), der Server fordert sie an (DO)
+			if (bit == optionBit(OPT_COM_PORT)) bit = 0;
+			if (_localPending & bit) {
+				_localPending &= (uint8_t)~bit;
+				_local |= bit;
+			} else if (!bit) {
+				sendOption(WONT, option);
+			} else if (!(_local & bit)) {
+				_local |= bit;
+				sendOption(WILL, option);
+			}
+			break;
+		case DONT:
+			if (_localPending & bit) {
+				_localPending &= (uint8_t)~bit;
+				_local &= (uint8_t)~bit;
+			} else if (_local & bit) {
+				_local &= (uint8_t)~bit;
+				sendOption(WONT, option);
+			}
+			break;
+	}
+}
+
+/**
+ * @brief Wertet eine vollständige Subnegotiation aus (nur COM-PORT-OPTION).
+ *
+ * @param control true, wenn der Client die UART steuern darf.
+ */
+void Rfc2217Codec::subnegotiation(bool control) {
+	if (_sbLen < 2 || _sb[0] != OPT_COM_PORT) return;
+	comPortCommand(_sb[1], _sb + 2, _sbLen - 2, control);
+}
+
+/**
+ * @brief Führt einen COM-PORT-Befehl aus und beantwortet ihn.
+ *
+ * @param code Befehlscode des Clients.
+ * @param arg Argument.
+ * @param len Länge des Arguments.
+ * @param control true, wenn der Client die UART steuern darf.
+ */
+void Rfc2217Codec::comPortCommand(uint8_t code, const uint8_t *arg, size_t len, bool control) {
+	uint8_t value = len > 0 ? arg[0] : 0;
+	switch (code) {
+		case CPO_SIGNATURE:
+			// Leere Anfrage = Signatur des Servers abfragen; eine Signatur des Clients wird nur angenommen
+			if (len == 0) sendComPort(CPO_SIGNATURE, (const uint8_t *)SIGNATURE, strlen(SIGNATURE));
+			break;
+		case CPO_SET_BAUDRATE: {
+			if (len < 4) return;
+			uint32_t baud = ((uint32_t)arg[0] << 24) | ((uint32_t)arg[1] << 16) | ((uint32_t)arg[2] << 8) | arg[3];
+			uint32_t active = baud != 0 && control ? _port.setBaud(baud) : _port.baud();
+			uint8_t reply[4] = {(uint8_t)(active >> 24), (uint8_t)(active >> 16), (uint8_t)(active >> 8), (uint8_t)active};
+			sendComPort(code, reply, sizeof(reply));
+			break;
+		}
+		case CPO_SET_DATASIZE:
+			sendComPort(code, &DATASIZE_8, 1);
+			break;
+		case CPO_SET_PARITY:
+			sendComPort(code, &PARITY_NONE, 1);
+			break;
+		case CPO_SET_STOPSIZE:
+			sendComPort(code, &STOPSIZE_1, 1);
+			break;
+		case CPO_SET_CONTROL: {
+			uint8_t state = setControl(value, control);
+			sendComPort(code, &state, 1);
+			break;
+		}
+		case CPO_SET_LINESTATE_MASK:
+			_lineMask = value;
+			sendComPort(code, &_lineMask, 1);
+			break;
+		case CPO_SET_MODEMSTATE_MASK:
+			_modemMask = value;
+			sendComPort(code, &_modemMask, 1);
+			break;
+		case CPO_PURGE_DATA:
+			if (control && value >= 1 && value <= 3) _port.purge(value != 2, value != 1);
+			sendComPort(code, &value, 1);
+			break;
+		default:
+			// NOTIFY-* und FLOWCONTROL-SUSPEND/-RESUME erwarten keine Antwort
+			break;
+	}
+}
+
+/**
+ * @brief Wertet SET-CONTROL aus.
+ *
+ * Die Firmware hat keine DTR/RTS/BREAK-Ausgänge für den Client; deren Zustand wird nur
+ * gemerkt und gemeldet. Flusskontrolle ist über `serial txconfig` einzustellen und wird hier
+ * nur zwischen "keine" und "Hardware" gemeldet.
+ *
+ * @param value SET-CONTROL-Wert des Clients.
+ * @param control true, wenn der Client die UART steuern darf.
+ * @return Wert für die Antwort.
+ */
+uint8_t Rfc2217Codec::setControl(uint8_t value, bool control) {
+	switch (value) {
+		case CTRL_FLOW_QUERY:
+			return _flow;
+		case CTRL_BREAK_QUERY:
+			return _breakState;
+		case CTRL_BREAK_ON:
+		case CTRL_BREAK_OFF:
+			if (control) _breakState = value;
+			return _breakState;
+		case CTRL_DTR_QUERY:
+			return _dtr;
+		case CTRL_DTR_ON:
+		case CTRL_DTR_OFF:
+			if (control) _dtr = value;
+			return _dtr;
+		case CTRL_RTS_QUERY:
+			return _rts;
+		case CTRL_RTS_ON:
+		case CTRL_RTS_OFF:
+			if (control) _rts = value;
+			return _rts;
+		default:
+			if (value > CTRL_FLOW_NONE && value <= CTRL_FLOW_HARDWARE) {
+				if (control) _flow = value;
+				return _flow;
+			}
+			return value;  // eingehende Flusskontrolle (13..19): übernommen melden
+	}
+}
+
+/**
+ * @brief Legt `IAC <verb> <option>` in den Antwortpuffer und merkt die Anfrage.
+ */
+void Rfc2217Codec::sendOption(uint8_t verb, uint8_t option) {
+	uint8_t bit = optionBit(option);
+	if (verb == WILL || verb == WONT) {
+		_localPending |= bit;
+	} else {
+		_remotePending |= bit;
+	}
+	uint8_t msg[3] = {IAC, verb, option};
+	if (!queue(msg, sizeof(msg))) _droppedReplies++;
+}
+
+/**
+ * @brief Legt eine Antwort `IAC SB COM-PORT-OPTION <code+100> <arg> IAC SE` in den Antwortpuffer.
+ */
+void Rfc2217Codec::sendComPort(uint8_t code, const uint8_t *arg, size_t len) {
+	uint8_t msg[4 + 2 * SUBNEG_MAX + 2];
+	size_t n = 0;
+	msg[n++] = IAC;
+	msg[n++] = SB;
+	msg[n++] = OPT_COM_PORT;
+	msg[n++] = (uint8_t)(code + SERVER_OFFSET);
+	for (size_t i = 0; i < len && i < SUBNEG_MAX; ++i) {
+		if (arg[i] == IAC) msg[n++] = IAC;
+		msg[n++] = arg[i];
+	}
+	msg[n++] = IAC;
+	msg[n++] = SE;
+	if (!queue(msg, n)) _droppedReplies++;
+}
+
+/**
+ * @brief Hängt eine vollständige Antwort an oder verwirft sie ganz.
+ */
+bool Rfc2217Codec::queue(const uint8_t *data, size_t len) {
+	if (_replyLen + len > REPLY_MAX) return false;
+	memcpy(_reply + _replyLen, data, len);
+	_replyLen += len;
+	return true;
+}
+
+/**
+ * @brief Anzahl der Bytes im Antwortpuffer.
+ */
+size_t Rfc2217Codec::pendingReply() const {
+	return _replyLen;
+}
+
+/**
+ * @brief Entnimmt Antworten aus dem Antwortpuffer.
+ *
+ * @param out Zielpuffer.
+ * @param cap Größe des Zielpuffers.
+ * @return Anzahl der kopierten Bytes.
+ */
+size_t Rfc2217Codec::takeReply(uint8_t *out, size_t cap) {
+	size_t n = _replyLen < cap ? _replyLen : cap;
+	memcpy(out, _reply, n);
+	memmove(_reply, _reply + n, _replyLen - n);
+	_replyLen -= n;
+	return n;
+}
+
+/**
+ * @brief true, sobald der Client COM-PORT-OPTION angeboten hat.
+ */
+bool Rfc2217Codec::comPortActive() const {
+	return (_remote & optionBit(OPT_COM_PORT)) != 0;
+}
+
+/**
+ * @brief Anzahl der verworfenen Antworten.
+ */
+uint32_t Rfc2217Codec::droppedReplies() const {
+	return _droppedReplies;
+}
+
+/**
+ * @brief Maskiert Nutzdaten für den Versand.
+ *
+ * @param in Nutzdaten.
+ * @param len Anzahl der Nutzdaten.
+ * @param out Zielpuffer.
+ * @param cap Größe des Zielpuffers.
+ * @param consumed Ausgabe: Anzahl der übernommenen Nutzdaten.
+ * @return Anzahl der Bytes in `out`.
+ */
+size_t Rfc2217Codec::escape(const uint8_t *in, size_t len, uint8_t *out, size_t cap, size_t &consumed) {
+	size_t i = 0;
+	size_t n = 0;
+	while (i < len) {
+		const uint8_t *iac = static_cast<const uint8_t *>(memchr(in + i, IAC, len - i));
+		size_t run = (iac ? (size_t)(iac - in) : len) - i;
+		if (run > cap - n) run = cap - n;
+		memcpy(out + n, in + i, run);
+		n += run;
+		i += run;
+		if (!iac || in + i != iac || cap - n < 2) break;
+		out[n++] = IAC;
+		out[n++] = IAC;
+		i++;
+	}
+	consumed = i;
+	return n;
+}
@@ -9,23 +9,98 @@
  * Zusätzlich erkennt sie automatisch, ob ein Gerät verbunden ist (basierend auf RX/TX),
  * ermöglicht die dynamische Änderung der Baudrate und puffert empfangene Zeichen.
  *
+ * Der Empfang läuft standardmäßig ereignisgesteuert über die Event-Queue des UART-Treibers
+ * (siehe SerialRxPump). Mit dem Build-Flag `SERIALBRIDGE_POLLING` wird stattdessen der alte
+ * Pfad mit einem Abfrageintervall von 5 ms verwendet.
+ *
+ * Fertige Zeilen laufen über den SerialCoalescer: Einzelne Zeilen gehen sofort hinaus, bei
+ * Dauerausgabe werden sie innerhalb des Latenzbudgets zu einer Nachricht zusammengefasst.
+ *
+ * Jeder verteilte Block wird im Verlaufspuffer abgelegt (PSRAM, falls vorhanden). Replays
+ * laufen in derselben Task wie der Live-Pfad, aber höchstens REPLAY_BURST Blöcke pro Durchlauf
+ * und nur, solange im Datenpuffer des Clients REPLAY_RESERVE Bytes für Live-Daten frei bleiben.
+ *
+ * Der Versand läuft über eine eigene TX-Task, damit weder WebSocket-Handler noch Empfang auf
+ * die Leitung warten müssen (Pacing, Flusskontrolle, RS-485-Umschaltung).
+ *
+ * Der Mitschnitt übernimmt RX-Blöcke direkt nach dem Lesen aus der UART und TX-Blöcke direkt
+ * nach dem Schreiben; beides kopiert nur in einen RAM-Puffer.
+ *
+ * Jeder aus der UART gelesene Block wird beim Lesen mit `esp_timer_get_time()` gestempelt. Der
+ * Zeitstempel wandert als Wert durch Framer und Coalescer bis in WebSocket-Nachricht,
+ * Verlaufspuffer und Mitschnitt; pro Zeile wird dafür nichts kopiert oder allokiert.
+ *
+ * Der TCP-Zugang bekommt die RX-Blöcke ungeframt direkt nach dem Mitschnitt; Sockets bedient
+ * eine eigene TCP-Task, damit ein langsamer TCP-Client weder Empfang noch WebSocket aufhält.
+ *
+ * Befehlsskripte laufen in einer eigenen Skript-Task. Die Bridge-Task kopiert RX-Blöcke nur
+ * während eines Laufs in deren Ringpuffer und weckt sie; gesendet wird über die TX-Task.
+ *
  * @author Simon Marcel Linden
  * @since 1.0.0
  */
 #include "SerialBridge.h"
 
+#include <esp_timer.h>
+#include <new>
+
+#include "StatusHandler.h"
 #include "global.h"
 
+/// Anzahl der Kanäle mit erkanntem Gerät (für SERIAL_CONNECTED im StatusHandler)
+static uint8_t g_connectedChannels = 0;
+
+/// Schutz von g_connectedChannels (Bridge-Tasks aller Kanäle)
+static portMUX_TYPE g_presenceMux = portMUX_INITIALIZER_UNLOCKED;
+
+/// Kanäle, deren Regeln SERIAL_TRIGGER_WARNING [0] bzw. SERIAL_TRIGGER_ERROR [1] gesetzt haben
+static uint8_t g_triggerChannels[2] = {0, 0};
+
+/// Schutz von g_triggerChannels (Bridge-Tasks und WebSocket-Kontext)
+static portMUX_TYPE g_triggerMux = portMUX_INITIALIZER_UNLOCKED;
+
+/// Namen der SerialTriggerLevel für Log und Alarm
+static const char *const TRIGGER_LEVEL_NAMES[] = {"info", "warning", "error"};
+
 /**
  * @brief Konstruktor der SerialBridge-Klasse.
  *
- * @param serial Referenz auf die verwendete HardwareSerial-Instanz.
- * @param ws Referenz auf die WebSocket-Instanz.
+ * @param port Referenz auf die verwendete UART-Schnittstelle.
+ * @param out Sendewarteschlangen der WebSocket-Clients.
+ * @param captures Ablage für Mitschnitte.
+ * @param channel Kanal-ID.
  * @param rxPin Der RX-Pin (Empfang).
  * @param txPin Der TX-Pin (Senden).
  */
-SerialBridge::SerialBridge(HardwareSerial &serial, AsyncWebSocket &ws, uint8_t rxPin, uint8_t txPin)
-    : _serial(serial), _ws(ws), _rxPin(rxPin), _txPin(txPin), _baudRate(0), _deviceConnected(false), _batchIndex(0), _lastRx(0) {
+SerialBridge::SerialBridge(UartPort &port, WsOutbox &out, CaptureStore &captures, uint8_t channel, uint8_t rxPin, uint8_t txPin)
+    : _port(port), _out(out), _rxPin(rxPin), _txPin(txPin), _baudRate(0), _deviceConnected(false), _rx(port), _channel(channel), _seq(0), _framer(onLine, this), _lastRx(0), _framingConfig(SerialFramer::defaultConfig()), _framingDirty(false),
+      _coalescer(onFrame, this), _coalesceLatency(SerialCoalescer::DEFAULT_LATENCY_MS), _coalesceFrame(SerialCoalescer::DEFAULT_FRAME_BYTES), _coalesceDirty(false), _scrollbackMem(nullptr),
+      _tx(port, onTxDone, this), _txTask(nullptr), _txConfig(_tx.config()), _txDirty(false),
+      _recorder(captures), _recTask(nullptr),
+      _tcpLink(*this), _tcp(_tcpLink), _tcpTask(nullptr), _tcpConfig{false, 0, 0}, _tcpDirty(false),
+      _script(onQueueSend, onScriptDone, this), _scriptTask(nullptr), _poller(onQueueSend, onPollUpdate, this), _pollPending(nullptr), _pollDirty(false),
+      _filterSpecs(nullptr), _filterPending(nullptr), _filterDirty(false), _filter(nullptr),
+      _trigger(nullptr), _triggerPending(nullptr), _triggerDirty(false), _snapshotData(nullptr), _snapshotState(SNAPSHOT_EMPTY),
+      _baudDetector(port), _autoBaud{0, 0.0f, 0, 0, 0}, _autoBaudState(AUTOBAUD_IDLE), _autoBaudRequested(false),
+      _presenceConfig(DevicePresence::defaultConfig()), _presenceDirty(false),
+      _passthrough(port), _passthroughMem(nullptr), _passthroughSeq(0), _passthroughAcked(0), _passthroughRxLen(0), _passthroughRxUs(0), _bootRequest(BOOT_MODE_NONE), _bootRequester(0),
+      _stream(onQueueSend, this), _streamMem(nullptr), _streamReported(0), _streamReportMs(0), _streamWait(UINT32_MAX) {
+	memset(_clients, 0, sizeof(_clients));
+	memset(&_pollConfig, 0, sizeof(_pollConfig));
+	memset(_filterOwner, 0, sizeof(_filterOwner));
+	memset(_filterPendingIds, 0, sizeof(_filterPendingIds));
+	memset(_filterIds, 0, sizeof(_filterIds));
+	for (auto &seq : _filterSeq) seq = 0;
+	memset(&_snapshot, 0, sizeof(_snapshot));
+	if (_channel) {
+		snprintf(_logPrefix, sizeof(_logPrefix), "[ch%u] ", (unsigned)_channel);
+	} else {
+		_logPrefix[0] = '\0';
+	}
+	_tx.onTransmit(onTxData, this);
+	_passthrough.onTransmit(onTxData, this);
+	_recorder.onWake(onRecorderWake, this);
+	_clientsMux = portMUX_INITIALIZER_UNLOCKED;
 	pinMode(_rxPin, INPUT);
 	pinMode(_txPin, OUTPUT);
 }
@@ -37,7 +112,25 @@ SerialBridge::SerialBridge(HardwareSerial &serial, AsyncWebSocket &ws, uint8_t r
  */
 void SerialBridge::begin(uint32_t baud) {
 	_baudRate = baud;
-	_serial.begin(_baudRate, SERIAL_8N1, _rxPin, _txPin);
+	if (!_scrollbackMem) {
+		bool psram = psramFound();
+		size_t size = psram ? SCROLLBACK_PSRAM_BYTES : SCROLLBACK_RAM_BYTES;
+		_scrollbackMem = static_cast<uint8_t *>(psram ? ps_malloc(size) : malloc(size));
+		if (_scrollbackMem) {
+			_scrollback.reset(_scrollbackMem, size);
+			logger.log({"system", "info", "device"}, logTag() + "Verlaufspuffer: " + String(size / 1024) + " KB" + (psram ? " (PSRAM)" : ""));
+		} else {
+			logger.log({"system", "error", "device"}, logTag() + "Verlaufspuffer konnte nicht angelegt werden");
+		}
+	}
+	if (!_port.begin(_baudRate)) {
+		logger.log({"system", "error", "device"}, logTag() + "UART-Treiber konnte nicht installiert werden");
+	}
+	// Bis zum ersten Lebenszeichen gilt kein Gerät als verbunden
+	portENTER_CRITICAL(&g_presenceMux);
+	bool none = g_connectedChannels == 0;
+	portEXIT_CRITICAL(&g_presenceMux);
+	if (none && !isStatusActive(SERIAL_NOT_CONNECTED)) addStatus(SERIAL_NOT_CONNECTED);
 	sendAvailability();
 }
 
@@ -49,24 +142,78 @@ void SerialBridge::begin(uint32_t baud) {
  * @param core CPU-Core, auf dem die Task laufen soll.
  */
 void SerialBridge::start(TaskHandle_t *taskHandle, UBaseType_t priority, BaseType_t core) {
-	xTaskCreatePinnedToCore(taskFunc, "SerialBridgeTask", 4096, this, priority, taskHandle, core);
+	// Eigene Tasks pro Kanal; der Name trägt die Kanal-ID (z. B. "SerialBridge1")
+	char name[16];
+	snprintf(name, sizeof(name), "SerialBridge%u", (unsigned)_channel);
+	xTaskCreatePinnedToCore(taskFunc, name, 4096, this, priority, taskHandle, core);
+	snprintf(name, sizeof(name), "SerialTx%u", (unsigned)_channel);
+	xTaskCreatePinnedToCore(txTaskFunc, name, 4096, this, priority, &_txTask, core);
+	snprintf(name, sizeof(name), "SerialRec%u", (unsigned)_channel);
+	xTaskCreatePinnedToCore(recTaskFunc, name, 4096, this, 1, &_recTask, core);
+	snprintf(name, sizeof(name), "SerialTcp%u", (unsigned)_channel);
+	xTaskCreatePinnedToCore(tcpTaskFunc, name, 4096, this, 2, &_tcpTask, core);
+	snprintf(name, sizeof(name), "SerialScript%u", (unsigned)_channel);
+	xTaskCreatePinnedToCore(scriptTaskFunc, name, 4096, this, 2, &_scriptTask, core);
 }
 
 /**
  * @brief Setzt eine neue Baudrate, falls sie gültig ist.
  *
  * @param newBaud Neue Baudrate als uint32_t.
- * @return true, wenn erfolgreich gesetzt oder identisch.
+ * @return true, wenn erfolgreich gesetzt oder identisch; false während des Durchreichens.
  */
 bool SerialBridge::setBaud(uint32_t newBaud) {
+	// Während des Durchreichens gehört die Rate der Übertragung
+	if (_passthrough.state() != PASSTHROUGH_IDLE) return false;
 	if (newBaud != _baudRate && isValidBaudRate(String(newBaud))) {
 		_baudRate = newBaud;
-		_serial.begin(_baudRate, SERIAL_8N1, _rxPin, _txPin);
+		_port.begin(_baudRate);
 	}
 	sendAvailability();
 	return true;
 }
 
+/**
+ * @brief Fordert die automatische Baudratenerkennung an.
+ *
+ * Die Erkennung liest selbst von der UART und läuft deshalb in der Bridge-Task, die die
+ * Anforderung spätestens nach IDLE_WAKE_MS aufgreift.
+ *
+ * @return false, wenn bereits eine Erkennung angefordert ist oder läuft oder durchgereicht wird.
+ */
+bool SerialBridge::startAutoBaud() {
+	if (_autoBaudRequested || _autoBaudState == AUTOBAUD_RUNNING || _passthrough.state() != PASSTHROUGH_IDLE) return false;
+	_autoBaudRequested = true;
+	return true;
+}
+
+/**
+ * @brief Führt die Baudratenerkennung aus und übernimmt die erkannte Rate.
+ */
+void SerialBridge::runAutoBaud() {
+	_autoBaudRequested = false;
+	_autoBaudState = AUTOBAUD_RUNNING;
+	sendAvailability();
+
+	// Angefangene Zeile der alten Rate noch ausgeben; während der Erkennung wird nichts verteilt
+	if (_framer.pending() > 0) _framer.flush();
+
+	uint32_t candidates[NUM_BAUD_RATES];
+	for (size_t i = 0; i < NUM_BAUD_RATES; ++i) candidates[i] = (uint32_t)baudRates[i];
+	_autoBaud = _baudDetector.detect(candidates, NUM_BAUD_RATES, _baudRate);
+
+	if (_autoBaud.baud) {
+		_baudRate = _autoBaud.baud;
+		_autoBaudState = AUTOBAUD_LOCKED;
+		logger.log({"system", "info", "device"}, logTag() + "Baudrate erkannt: " + String(_baudRate) + " (" + String(_autoBaud.elapsedMs) + " ms, " + String(_autoBaud.probes) + " Versuche)");
+	} else {
+		_autoBaudState = AUTOBAUD_FAILED;
+		logger.log({"system", "warning", "device"}, logTag() + "Baudrate nicht erkannt, bleibe bei " + String(_baudRate));
+	}
+	_lastRx = millis();
+	sendAvailability();
+}
+
 /**
  * @brief Prüft, ob eine übergebene Baudrate in der erlaubten Liste enthalten ist.
  *
@@ -89,6 +236,15 @@ bool SerialBridge::isDeviceConnected() const {
 	return _deviceConnected;
 }
 
+/**
+ * @brief Gibt die Kanal-ID zurück.
+ *
+ * @return Kanal-ID.
+ */
+uint8_t SerialBridge::getChannel() const {
+	return _channel;
+}
+
 /**
  * @brief Gibt die aktuelle Baudrate zurück.
  *
@@ -99,98 +255,2092 @@ uint32_t SerialBridge::getBaudRate() const {
 }
 
 /**
- * @brief Sendet die aktuelle Verfügbarkeit und Baudrate an alle WebSocket-Clients.
+ * @brief Setzt die Schwellen der Geräteerkennung.
+ *
+ * @param config Neue Schwellen.
+ * @return false bei ungültigen Schwellen.
  */
-void SerialBridge::sendAvailability() {
-	StaticJsonDocument<256> doc;
-	doc["event"] = "serial";
-	doc["action"] = "status";
-	doc["status"] = "success";
-	JsonObject details = doc.createNestedObject("details");
-	details["available"] = _deviceConnected;
-	details["baudRate"] = _baudRate;
-	String payload;
-	serializeJson(doc, payload);
-	_ws.textAll(payload);
+bool SerialBridge::setPresence(const DevicePresenceConfig &config) {
+	if (!DevicePresence::validate(config)) return false;
+	portENTER_CRITICAL(&_clientsMux);
+	_presenceConfig = config;
+	_presenceDirty = true;
+	portEXIT_CRITICAL(&_clientsMux);
+	return true;
 }
 
 /**
- * @brief Sendet Daten direkt über die serielle Schnittstelle.
+ * @brief Gibt die zuletzt gesetzten Schwellen der Geräteerkennung zurück.
  *
- * @param data Der zu sendende String.
+ * @return Kopie der Schwellen.
  */
-void SerialBridge::sendData(const String &data) {
-	// direkt auf der HardwareSerial ausgeben
-	_serial.print(data);
+DevicePresenceConfig SerialBridge::getPresence() const {
+	portENTER_CRITICAL(&_clientsMux);
+	DevicePresenceConfig config = _presenceConfig;
+	portEXIT_CRITICAL(&_clientsMux);
+	return config;
 }
 
 /**
- * @brief Interne FreeRTOS-Task-Funktion zur Überwachung des seriellen Eingangs.
+ * @brief Setzt die zyklischen Abfragen.
  *
- * Diese Funktion wird dauerhaft ausgeführt. Sie prüft:
- * - ob ein Gerät verbunden ist (über RX/TX-Leitungen),
- * - ob neue Zeichen empfangen wurden (und sendet sie gebündelt weiter),
- * - ob nach einer definierten Zeit (BATCH_TIMEOUT_MS) die aktuellen Daten geflusht werden.
+ * @param config Abfragen.
+ * @param error Puffer für die Fehlerbeschreibung.
+ * @param size Größe des Puffers.
+ * @return false bei ungültiger Konfiguration.
+ */
+bool SerialBridge::setPoll(const SerialPollerConfig &config, char *error, size_t size) {
+	if (!SerialPoller::validate(config, error, size)) return false;
+	SerialPollerConfig *pending = new (std::nothrow) SerialPollerConfig(config);
+	if (!pending) {
+		snprintf(error, size, "Kein Speicher für die Abfragen");
+		return false;
+	}
+	_pollConfig = config;
+	portENTER_CRITICAL(&_clientsMux);
+	SerialPollerConfig *stale = _pollPending;
+	_pollPending = pending;
+	_pollDirty = true;
+	portEXIT_CRITICAL(&_clientsMux);
+	delete stale;
+	return true;
+}
+
+/**
+ * @brief Gibt die zuletzt gesetzten Abfragen zurück.
  *
- * @param param Pointer auf die SerialBridge-Instanz (this).
+ * Geschrieben wird _pollConfig nur von setPoll() im selben Kontext, daher ohne Kopie; die Task
+ * erhält eine eigene Kopie über _pollPending.
  */
-void SerialBridge::taskFunc(void *param) {
-	auto *self = static_cast<SerialBridge *>(param);
-	self->_batchIndex = 0;
-	self->_lastRx = millis();
+const SerialPollerConfig &SerialBridge::getPoll() const {
+	return _pollConfig;
+}
 
-	for (;;) {
-		int rxState = digitalRead(RXD2);
-		int txState = digitalRead(TXD2);
+/**
+ * @brief Zugriff auf Feldspeicher und Zähler der Abfragen.
+ */
+const SerialPoller &SerialBridge::getPoller() const {
+	return _poller;
+}
 
-		if (!self->_deviceConnected && (rxState == HIGH && txState == HIGH)) {
-			self->_deviceConnected = true;
-			self->sendAvailability();
-			logger.log({"system", "info", "device"}, "Device connected");
+/**
+ * @brief Legt die abonnierten Felder eines Clients fest.
+ *
+ * @param id Client-ID.
+ * @param mask Bitmaske der Feldindizes.
+ * @return false, wenn der Client nicht registriert ist.
+ */
+bool SerialBridge::setFieldSubscription(uint32_t id, uint32_t mask) {
+	bool found = false;
+	portENTER_CRITICAL(&_clientsMux);
+	for (auto &slot : _clients) {
+		if (slot.used && slot.id == id) {
+			slot.fields = mask;
+			found = true;
 		}
+	}
+	portEXIT_CRITICAL(&_clientsMux);
+	return found;
+}
 
-		// 1) Neue Bytes einsammeln
-		while (self->_serial.available()) {
-			char c = self->_serial.read();
-			uint32_t now = millis();
-			self->_lastRx = now;
+/**
+ * @brief Setzt den Zeilenfilter eines Clients.
+ *
+ * Der Speicher für die Regelsätze wird erst beim ersten Filter angelegt. Schlägt das Übersetzen
+ * fehl, wird der bisherige Regelsatz des Clients wiederhergestellt.
+ *
+ * @param id Client-ID.
+ * @param spec Regelsatz (count = 0 hebt den Filter auf).
+ * @param error Puffer für die Fehlerbeschreibung.
+ * @param size Größe des Puffers.
+ * @return false bei unbekanntem Client, ungültigem Regelsatz oder fehlendem Speicher.
+ */
+bool SerialBridge::setFilter(uint32_t id, const SerialFilterSpec &spec, char *error, size_t size) {
+	if (spec.count > SerialFilterSpec::MAX_RULES) {
+		snprintf(error, size, "Zu viele Regeln");
+		return false;
+	}
+	int index = -1;
+	portENTER_CRITICAL(&_clientsMux);
+	for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+		if (_clients[i].used && _clients[i].id == id) index = (int)i;
+	}
+	portEXIT_CRITICAL(&_clientsMux);
+	if (index < 0) {
+		snprintf(error, size, "Client nicht registriert");
+		return false;
+	}
+	if (!_filterSpecs) {
+		if (spec.count == 0) return true;
+		_filterSpecs = new (std::nothrow) SerialFilterSpec[MAX_CLIENTS]();
+		if (!_filterSpecs) {
+			snprintf(error, size, "Kein Speicher für den Filter");
+			return false;
+		}
+	}
+	SerialFilterSpec previous = _filterSpecs[index];
+	uint32_t previousOwner = _filterOwner[index];
+	_filterSpecs[index] = spec;
+	_filterOwner[index] = id;
+	if (!rebuildFilter(error, size)) {
+		_filterSpecs[index] = previous;
+		_filterOwner[index] = previousOwner;
+		return false;
+	}
+	return true;
+}
 
-			// Zeichen in den Puffer
-			if (self->_batchIndex + 1 < sizeof(self->_batchBuffer)) {
-				self->_batchBuffer[self->_batchIndex++] = c;
-			}
+/**
+ * @brief Gibt den Zeilenfilter eines Clients zurück.
+ *
+ * @param id Client-ID.
+ * @param spec Regelsatz (count = 0: kein Filter).
+ * @param lines Bisher zugestellte Zeilen.
+ * @return false, wenn der Client nicht registriert ist.
+ */
+bool SerialBridge::getFilter(uint32_t id, SerialFilterSpec &spec, uint32_t &lines) const {
+	int index = -1;
+	portENTER_CRITICAL(&_clientsMux);
+	for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+		if (_clients[i].used && _clients[i].id == id) index = (int)i;
+	}
+	portEXIT_CRITICAL(&_clientsMux);
+	if (index < 0) return false;
+	spec.count = 0;
+	lines = 0;
+	if (_filterSpecs && _filterOwner[index] == id) {
+		spec = _filterSpecs[index];
+		lines = _filterSeq[index];
+	}
+	return true;
+}
 
-			// SOFORT schicken, wenn wir einen Zeilenumbruch haben
-			if (c == '\r' || c == '\n' || self->_batchIndex + 1 == sizeof(self->_batchBuffer)) {
-				self->_batchBuffer[self->_batchIndex] = '\0';
-				StaticJsonDocument<256> doc;
-				doc["event"] = "serial";
-				doc["action"] = "incoming";
-				doc["status"] = "data";
-				doc["details"] = self->_batchBuffer;
-				String payload;
-				serializeJson(doc, payload);
-				self->_ws.textAll(payload);
-				self->_batchIndex = 0;
-				logger.log({"serial", "info", "device"}, String(self->_batchBuffer));
-			}
+/**
+ * @brief Übersetzt die Regelsätze aller Slots und übergibt den Filter an die Bridge-Task.
+ *
+ * Ohne Regelsatz wird kein Filter angelegt (nullptr schaltet die Auswertung in der Task ab).
+ * Ein noch nicht übernommener Filter wird ersetzt und hier freigegeben.
+ *
+ * @param error Puffer für die Fehlerbeschreibung.
+ * @param size Größe des Puffers.
+ * @return false bei ungültigem Regelsatz oder fehlendem Speicher.
+ */
+bool SerialBridge::rebuildFilter(char *error, size_t size) {
+	bool any = false;
+	for (size_t i = 0; i < MAX_CLIENTS; ++i) any |= _filterSpecs[i].count > 0;
+	SerialLineFilter *filter = nullptr;
+	if (any) {
+		filter = new (std::nothrow) SerialLineFilter();
+		if (!filter) {
+			snprintf(error, size, "Kein Speicher für den Filter");
+			return false;
+		}
+		if (!filter->build(_filterSpecs, MAX_CLIENTS, error, size)) {
+			delete filter;
+			return false;
 		}
+	}
+	portENTER_CRITICAL(&_clientsMux);
+	SerialLineFilter *stale = _filterPending;
+	_filterPending = filter;
+	memcpy(_filterPendingIds, _filterOwner, sizeof(_filterPendingIds));
+	_filterDirty = true;
+	portEXIT_CRITICAL(&_clientsMux);
+	delete stale;
+	return true;
+}
 
-		// 2) Wenn nach BATCH_TIMEOUT_MS keine neuen Bytes kamen, flushen
-		uint32_t since = millis() - self->_lastRx;
-		if (self->_batchIndex > 0 && since >= SerialBridge::BATCH_TIMEOUT_MS) {
-			self->_batchBuffer[self->_batchIndex] = '\0';
-			StaticJsonDocument<256> doc;
-			doc["event"] = "serial";
-			doc["action"] = "incoming";
-			doc["status"] = "data";
-			doc["details"] = self->_batchBuffer;
-			String payload;
-			serializeJson(doc, payload);
-			self->_ws.textAll(payload);
-			self->_batchIndex = 0;
+/**
+ * @brief Übersetzt neue Regeln und übergibt sie an die Bridge-Task.
+ *
+ * Übersetzt wird hier, einmal pro Änderung; die Task tauscht nur noch den Zeiger. Ohne Regeln
+ * wird nichts angelegt.
+ *
+ * @param config Regeln.
+ * @param error Puffer für die Fehlerbeschreibung.
+ * @param size Größe des Puffers.
+ * @return false bei ungültiger Regel oder fehlendem Speicher.
+ */
+bool SerialBridge::setTriggers(const SerialTriggerConfig &config, char *error, size_t size) {
+	SerialTrigger *trigger = nullptr;
+	if (config.count > 0) {
+		trigger = new (std::nothrow) SerialTrigger();
+		if (!trigger) {
+			snprintf(error, size, "Kein Speicher für die Regeln");
+			return false;
+		}
+		if (!trigger->build(config, error, size)) {
+			delete trigger;
+			return false;
+		}
+	}
+	portENTER_CRITICAL(&_clientsMux);
+	SerialTrigger *stale = _triggerPending;
+	_triggerPending = trigger;
+	_triggerDirty = true;
+	portEXIT_CRITICAL(&_clientsMux);
+	delete stale;
+	return true;
+}
+
+/**
+ * @brief Kopie einer aktiven Regel und ihrer Zähler.
+ *
+ * Die Task tauscht die Regeln nur unter _clientsMux aus, daher bleibt der Zeiger hier gültig.
+ *
+ * @return false bei ungültigem Index oder ohne Regeln.
+ */
+bool SerialBridge::getTrigger(size_t index, SerialTriggerRule &rule, SerialTriggerStats &stats) const {
+	portENTER_CRITICAL(&_clientsMux);
+	bool ok = _trigger && _trigger->rule(index, rule, stats);
+	portEXIT_CRITICAL(&_clientsMux);
+	return ok;
+}
+
+/**
+ * @brief Von diesem Kanal gesetzte Status.
+ *
+ * @return Bit 0: SERIAL_TRIGGER_WARNING, Bit 1: SERIAL_TRIGGER_ERROR.
+ */
+uint8_t SerialBridge::getTriggerStatus() const {
+	uint8_t bit = (uint8_t)(1u << _channel);
+	portENTER_CRITICAL(&g_triggerMux);
+	uint8_t result = ((g_triggerChannels[0] & bit) ? 1 : 0) | ((g_triggerChannels[1] & bit) ? 2 : 0);
+	portEXIT_CRITICAL(&g_triggerMux);
+	return result;
+}
+
+/**
+ * @brief Setzt den LED-Status einer Regel für diesen Kanal.
+ *
+ * @param level SerialTriggerLevel; Hinweise und Warnungen setzen SERIAL_TRIGGER_WARNING.
+ */
+void SerialBridge::raiseTriggerStatus(uint8_t level) {
+	size_t idx = level == TRIGGER_ERROR ? 1 : 0;
+	portENTER_CRITICAL(&g_triggerMux);
+	uint8_t before = g_triggerChannels[idx];
+	g_triggerChannels[idx] |= (uint8_t)(1u << _channel);
+	portEXIT_CRITICAL(&g_triggerMux);
+	if (before == 0) addStatus(idx ? SERIAL_TRIGGER_ERROR : SERIAL_TRIGGER_WARNING);
+}
+
+/**
+ * @brief Quittiert die Status dieses Kanals.
+ */
+void SerialBridge::ackTriggers() {
+	for (size_t idx = 0; idx < 2; ++idx) {
+		portENTER_CRITICAL(&g_triggerMux);
+		uint8_t before = g_triggerChannels[idx];
+		g_triggerChannels[idx] &= (uint8_t)~(1u << _channel);
+		uint8_t after = g_triggerChannels[idx];
+		portEXIT_CRITICAL(&g_triggerMux);
+		if (before != 0 && after == 0) removeStatus(idx ? SERIAL_TRIGGER_ERROR : SERIAL_TRIGGER_WARNING);
+	}
+}
+
+/**
+ * @brief Kopiert den letzten Schnappschuss.
+ *
+ * Während des Kopierens ist der Schnappschuss gesperrt; eine Regel, die gerade dann auslöst,
+ * überspringt ihren Schnappschuss.
+ *
+ * @param info Kopf des Schnappschusses.
+ * @param data Zielpuffer (mindestens TRIGGER_SNAPSHOT_BYTES).
+ * @return false, wenn es keinen gibt oder er gerade neu geschrieben wird.
+ */
+bool SerialBridge::getTriggerSnapshot(SerialTriggerSnapshot &info, uint8_t *data) const {
+	portENTER_CRITICAL(&_clientsMux);
+	bool ready = _snapshotState == SNAPSHOT_READY;
+	if (ready) _snapshotState = SNAPSHOT_READING;
+	portEXIT_CRITICAL(&_clientsMux);
+	if (!ready) return false;
+	info = _snapshot;
+	memcpy(data, _snapshotData, _snapshot.len);
+	portENTER_CRITICAL(&_clientsMux);
+	_snapshotState = SNAPSHOT_READY;
+	portEXIT_CRITICAL(&_clientsMux);
+	return true;
+}
+
+/**
+ * @brief Gibt die Zähler der Geräteerkennung zurück.
+ *
+ * @return Kopie der Statistik.
+ */
+DevicePresenceStats SerialBridge::getPresenceStats() const {
+	return _presence.stats();
+}
+
+/**
+ * @brief Millisekunden seit dem letzten Lebenszeichen des Geräts.
+ *
+ * @return Abstand in ms oder UINT32_MAX, wenn noch keines kam.
+ */
+uint32_t SerialBridge::msSinceDeviceSeen() const {
+	return _presence.hasActivity() ? millis() - _presence.lastSeen() : UINT32_MAX;
+}
+
+/**
+ * @brief Gibt die Zähler des Empfangspfads zurück.
+ *
+ * @return Referenz auf die Statistik der SerialRxPump.
+ */
+const SerialRxStats &SerialBridge::getRxStats() const {
+	return _rx.stats();
+}
+
+/**
+ * @brief Registriert einen neu verbundenen WebSocket-Client.
+ *
+ * @param id Client-ID.
+ */
+void SerialBridge::addClient(uint32_t id) {
+	portENTER_CRITICAL(&_clientsMux);
+	for (auto &slot : _clients) {
+		if (!slot.used) {
+			memset(&slot, 0, sizeof(slot));
+			slot.id = id;
+			slot.used = true;
+			break;
+		}
+	}
+	portEXIT_CRITICAL(&_clientsMux);
+}
+
+/**
+ * @brief Entfernt einen getrennten WebSocket-Client.
+ *
+ * @param id Client-ID.
+ */
+void SerialBridge::removeClient(uint32_t id) {
+	int index = -1;
+	portENTER_CRITICAL(&_clientsMux);
+	for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+		if (_clients[i].used && _clients[i].id == id) {
+			_clients[i].used = false;
+			index = (int)i;
+		}
+	}
+	portEXIT_CRITICAL(&_clientsMux);
+	// Ohne Besitzer hat das Durchreichen keinen Sinn mehr
+	if (stopPassthrough(id, true)) {
+		logger.log({"system", "warning", "device"}, logTag() + "Durchreichen abgebrochen: Client getrennt");
+	}
+	// Filter des Clients verwerfen, damit ein neuer Client im Slot ungefiltert beginnt
+	if (index >= 0 && _filterSpecs && _filterSpecs[index].count > 0) {
+		char error[64];
+		_filterSpecs[index].count = 0;
+		_filterOwner[index] = 0;
+		if (!rebuildFilter(error, sizeof(error))) {
+			logger.log({"system", "error", "device"}, logTag() + "Zeilenfilter konnte nicht neu übersetzt werden: " + String(error));
+		}
+	}
+}
+
+/**
+ * @brief Schaltet für einen Client zwischen JSON und binären Frames um.
+ *
+ * @param id Client-ID.
+ * @param enabled true = binäre Frames.
+ * @return false, wenn der Client nicht registriert ist.
+ */
+bool SerialBridge::setBinary(uint32_t id, bool enabled) {
+	bool found = false;
+	portENTER_CRITICAL(&_clientsMux);
+	for (auto &slot : _clients) {
+		if (slot.used && slot.id == id) {
+			slot.binary = enabled;
+			found = true;
 		}
+	}
+	portEXIT_CRITICAL(&_clientsMux);
+	return found;
+}
+
+/**
+ * @brief Setzt Latenzbudget und maximale Nachrichtengröße für das Bündeln.
+ *
+ * @param latencyMs Maximale Verzögerung einer Zeile in ms.
+ * @param maxFrameBytes Maximale Nutzdaten pro Nachricht.
+ */
+void SerialBridge::setCoalescing(uint32_t latencyMs, size_t maxFrameBytes) {
+	portENTER_CRITICAL(&_clientsMux);
+	_coalesceLatency = latencyMs;
+	_coalesceFrame = maxFrameBytes;
+	_coalesceDirty = true;
+	portEXIT_CRITICAL(&_clientsMux);
+}
+
+/**
+ * @brief Gibt die Zähler des Bündelns zurück.
+ *
+ * @return Kopie der Statistik.
+ */
+SerialCoalescerStats SerialBridge::getCoalescerStats() const {
+	return _coalescer.stats();
+}
+
+/**
+ * @brief Setzt das Framing des Empfangsstroms.
+ *
+ * @param config Neue Einstellung.
+ * @return false, wenn die Einstellung ungültig ist.
+ */
+bool SerialBridge::setFraming(const SerialFramerConfig &config) {
+	if (!SerialFramer::validate(config)) return false;
+	portENTER_CRITICAL(&_clientsMux);
+	_framingConfig = config;
+	_framingDirty = true;
+	portEXIT_CRITICAL(&_clientsMux);
+	return true;
+}
+
+/**
+ * @brief Gibt die zuletzt gesetzte Framing-Einstellung zurück.
+ *
+ * @return Kopie der Einstellung.
+ */
+SerialFramerConfig SerialBridge::getFraming() const {
+	portENTER_CRITICAL(&_clientsMux);
+	SerialFramerConfig config = _framingConfig;
+	portEXIT_CRITICAL(&_clientsMux);
+	return config;
+}
+
+/**
+ * @brief Gibt die Zähler des Framers zurück.
+ *
+ * @return Kopie der Statistik.
+ */
+SerialFramerStats SerialBridge::getFramerStats() const {
+	return _framer.stats();
+}
+
+/**
+ * @brief Startet einen Mitschnitt.
+ *
+ * Ist die Uhr bereits per NTP gestellt, wird die Unix-Zeit in den Dateikopf übernommen.
+ *
+ * @param session Sitzungsname.
+ * @param config Rotation und Quote.
+ * @return false bei ungültigen Parametern oder laufendem Mitschnitt.
+ */
+bool SerialBridge::startRecording(const String &session, const SerialRecorderConfig &config) {
+	time_t now = time(nullptr);
+	uint32_t epoch = now > 1600000000 ? (uint32_t)now : 0;
+	if (!_recorder.start(session.c_str(), config, epoch)) return false;
+	logger.log({"system", "info", "device"}, logTag() + "Mitschnitt gestartet: " + session);
+	return true;
+}
+
+/**
+ * @brief Beendet den laufenden Mitschnitt.
+ */
+void SerialBridge::stopRecording() {
+	_recorder.stop();
+}
+
+/**
+ * @brief Zugriff auf den Mitschnitt.
+ *
+ * @return Referenz auf den SerialRecorder.
+ */
+const SerialRecorder &SerialBridge::getRecorder() const {
+	return _recorder;
+}
+
+/**
+ * @brief Öffnet, ändert oder schließt den TCP-Zugang.
+ *
+ * @param config Aktivierung und Ports.
+ * @return false bei ungültigen Ports.
+ */
+bool SerialBridge::setTcp(const SerialTcpConfig &config) {
+	if (config.enabled && (config.rawPort == 0 && config.rfc2217Port == 0)) return false;
+	if (config.enabled && config.rawPort == config.rfc2217Port) return false;
+	portENTER_CRITICAL(&_clientsMux);
+	_tcpConfig = config;
+	_tcpDirty = true;
+	portEXIT_CRITICAL(&_clientsMux);
+	if (_tcpTask) xTaskNotifyGive(_tcpTask);
+	return true;
+}
+
+/**
+ * @brief Gibt die zuletzt gesetzte Einstellung des TCP-Zugangs zurück.
+ *
+ * @return Kopie der Einstellung.
+ */
+SerialTcpConfig SerialBridge::getTcp() const {
+	portENTER_CRITICAL(&_clientsMux);
+	SerialTcpConfig config = _tcpConfig;
+	portEXIT_CRITICAL(&_clientsMux);
+	return config;
+}
+
+/**
+ * @brief Zugriff auf den TCP-Server.
+ *
+ * @return Referenz auf den Server.
+ */
+const SerialTcpServer &SerialBridge::getTcpServer() const {
+	return _tcp;
+}
+
+/**
+ * @brief Reiht ein Befehlsskript ein und weckt die Skript-Task.
+ *
+ * @param clientId Auftraggeber.
+ * @param name Skriptname ("" = direkt übergeben).
+ * @param source Skripttext.
+ * @return Auftragsnummer oder 0 (auch während des Durchreichens oder einer Dateiübertragung).
+ */
+uint32_t SerialBridge::runScript(uint32_t clientId, const String &name, const String &source) {
+	if (_passthrough.state() != PASSTHROUGH_IDLE || _stream.state() != FILE_STREAM_IDLE) return 0;
+	uint32_t job = _script.submit(clientId, name.c_str(), source.c_str(), source.length());
+	if (job && _scriptTask) xTaskNotifyGive(_scriptTask);
+	return job;
+}
+
+/**
+ * @brief Bricht ein Skript ab; die Skript-Task meldet den Abbruch als Ergebnis.
+ *
+ * @param job Auftragsnummer (0 = jedes).
+ * @return false, wenn kein solcher Auftrag existiert.
+ */
+bool SerialBridge::cancelScript(uint32_t job) {
+	if (!_script.cancel(job)) return false;
+	if (_scriptTask) xTaskNotifyGive(_scriptTask);
+	return true;
+}
 
-		vTaskDelay(pdMS_TO_TICKS(5));
+/**
+ * @brief Zugriff auf die Skriptausführung.
+ *
+ * @return Referenz auf die Engine.
+ */
+const SerialScriptEngine &SerialBridge::getScriptEngine() const {
+	return _script;
+}
+
+/**
+ * @brief Fordert das Nachladen aus dem Verlaufspuffer an.
+ *
+ * Der Startpunkt wird erst in der Bridge-Task bestimmt, da nur sie den Puffer verändert.
+ *
+ * @param id Client-ID.
+ * @param mode Startpunkt.
+ * @param arg Laufende Nummer bzw. Anzahl Bytes.
+ * @return false, wenn der Client nicht registriert ist.
+ */
+bool SerialBridge::requestReplay(uint32_t id, SerialReplayMode mode, uint32_t arg) {
+	bool found = false;
+	portENTER_CRITICAL(&_clientsMux);
+	for (auto &slot : _clients) {
+		if (slot.used && slot.id == id) {
+			slot.replay = REPLAY_REQUESTED;
+			slot.replayMode = (uint8_t)mode;
+			slot.replayArg = arg;
+			found = true;
+		}
+	}
+	portEXIT_CRITICAL(&_clientsMux);
+	return found;
+}
+
+/**
+ * @brief Startet das Durchreichen; Rate und Boot-Sequenz stellt die TX-Task ein.
+ *
+ * Der Speicher (SerialPassthrough::MEMORY_BYTES) wird nur für die Dauer der Übertragung
+ * angelegt und in finishPassthrough() wieder freigegeben.
+ *
+ * @param id Client-ID des Besitzers.
+ * @param config Parameter der Übertragung.
+ * @param error Puffer für die Fehlerbeschreibung.
+ * @param size Größe des Puffers.
+ * @return false, wenn das Durchreichen nicht gestartet werden kann.
+ */
+bool SerialBridge::startPassthrough(uint32_t id, const SerialPassthroughConfig &config, char *error, size_t size) {
+	if (!SerialPassthrough::validate(config)) {
+		snprintf(error, size, "Ungültige Parameter");
+		return false;
+	}
+	if (_passthrough.state() != PASSTHROUGH_IDLE) {
+		snprintf(error, size, "Durchreichen läuft bereits");
+		return false;
+	}
+	if (_autoBaudRequested || _autoBaudState == AUTOBAUD_RUNNING) {
+		snprintf(error, size, "Baudratenerkennung läuft");
+		return false;
+	}
+	if (_script.busy()) {
+		snprintf(error, size, "Skript läuft");
+		return false;
+	}
+	if (_stream.state() != FILE_STREAM_IDLE) {
+		snprintf(error, size, "Dateiübertragung läuft");
+		return false;
+	}
+	uint8_t *mem = static_cast<uint8_t *>(malloc(SerialPassthrough::MEMORY_BYTES));
+	if (!mem) {
+		snprintf(error, size, "Kein Speicher");
+		return false;
+	}
+	_passthroughSeq = 0;
+	_passthroughAcked = 0;
+	if (!_passthrough.begin(id, config, mem)) {
+		free(mem);
+		snprintf(error, size, "Durchreichen läuft bereits");
+		return false;
+	}
+	_passthroughMem = mem;
+	if (_txTask) xTaskNotifyGive(_txTask);
+	logger.log({"system", "info", "device"}, logTag() + "Durchreichen angefordert: " + String(config.baud) + " Baud, " + (config.size ? String(config.size) + " Bytes" : String("offen")));
+	return true;
+}
+
+/**
+ * @brief Fordert das Ende des Durchreichens an; die TX-Task schließt ab und meldet das Ergebnis.
+ *
+ * @param id Client-ID (muss der Besitzer sein).
+ * @param discard true = noch nicht geschriebene Daten verwerfen.
+ * @return false, wenn der Client nicht Besitzer ist.
+ */
+bool SerialBridge::stopPassthrough(uint32_t id, bool discard) {
+	if (id == 0 || _passthrough.owner() != id) return false;
+	_passthrough.requestStop(discard);
+	if (_txTask) xTaskNotifyGive(_txTask);
+	return true;
+}
+
+/**
+ * @brief Übergibt einen Upload-Block an den Puffer und weckt die TX-Task.
+ *
+ * @param id Client-ID.
+ * @param offset Position des Blocks.
+ * @param data Nutzdaten.
+ * @param len Länge der Nutzdaten.
+ * @return Ergebnis von SerialPassthrough::offer() bzw. UPLOAD_INACTIVE.
+ */
+SerialUploadResult SerialBridge::uploadPassthrough(uint32_t id, uint32_t offset, const uint8_t *data, size_t len) {
+	if (id == 0 || _passthrough.owner() != id) return UPLOAD_INACTIVE;
+	SerialUploadResult result = _passthrough.offer(offset, data, len);
+	if (result == UPLOAD_OK && _txTask) xTaskNotifyGive(_txTask);
+	return result;
+}
+
+/**
+ * @brief Zugriff auf das Durchreichen.
+ *
+ * @return Referenz auf den Zustand.
+ */
+const SerialPassthrough &SerialBridge::getPassthrough() const {
+	return _passthrough;
+}
+
+/**
+ * @brief Fordert einen Reset des Controllers an (Ausführung in der TX-Task).
+ *
+ * @param id Client für die Rückmeldung.
+ * @param mode BOOT_MODE_BOOTLOADER oder BOOT_MODE_RUN.
+ * @return false bei ungültigem Modus, laufendem Durchreichen oder offener Anforderung.
+ */
+bool SerialBridge::requestTargetReset(uint32_t id, uint8_t mode) {
+	if (mode != BOOT_MODE_BOOTLOADER && mode != BOOT_MODE_RUN) return false;
+	if (_passthrough.state() != PASSTHROUGH_IDLE || _bootRequest != BOOT_MODE_NONE) return false;
+	_bootRequester = id;
+	_bootRequest = mode;
+	if (_txTask) xTaskNotifyGive(_txTask);
+	return true;
+}
+
+/**
+ * @brief Beginnt eine Dateiübertragung; gesendet wird in der TX-Task.
+ *
+ * Der Speicher (SerialFileStream::MEMORY_BYTES) wird nur für die Dauer der Übertragung
+ * angelegt und in finishStream() wieder freigegeben.
+ *
+ * @param config Parameter der Übertragung.
+ * @param error Puffer für die Fehlerbeschreibung.
+ * @param size Größe des Puffers.
+ * @return false, wenn die Übertragung nicht gestartet werden kann.
+ */
+bool SerialBridge::startStream(const SerialFileStreamConfig &config, char *error, size_t size) {
+	if (!SerialFileStream::validate(config)) {
+		snprintf(error, size, "Ungültige Parameter");
+		return false;
+	}
+	if (_stream.state() != FILE_STREAM_IDLE) {
+		snprintf(error, size, "Dateiübertragung läuft bereits");
+		return false;
+	}
+	if (_passthrough.state() != PASSTHROUGH_IDLE) {
+		snprintf(error, size, "Durchreichen aktiv");
+		return false;
+	}
+	if (_autoBaudRequested || _autoBaudState == AUTOBAUD_RUNNING) {
+		snprintf(error, size, "Baudratenerkennung läuft");
+		return false;
+	}
+	if (_script.busy()) {
+		snprintf(error, size, "Skript läuft");
+		return false;
+	}
+	uint8_t *mem = static_cast<uint8_t *>(malloc(SerialFileStream::MEMORY_BYTES));
+	if (!mem) {
+		snprintf(error, size, "Kein Speicher");
+		return false;
+	}
+	if (!_stream.begin(config, mem, millis())) {
+		free(mem);
+		snprintf(error, size, "Dateiübertragung läuft bereits");
+		return false;
+	}
+	_streamMem = mem;
+	logger.log({"system", "info", "device"}, logTag() + "Dateiübertragung gestartet: " + (config.size ? String(config.size) + " Bytes" : String("Größe offen")) + ", Pause " + String(config.lineDelayMs) + " ms" + (config.prompt[0] ? ", Prompt \"" + String(config.prompt) + "\"" : String("")));
+	StaticJsonDocument<192> det;
+	det["size"] = config.size;
+	det["lineDelayMs"] = config.lineDelayMs;
+	det["prompt"] = config.prompt;
+	det["crlf"] = config.crlf;
+	sendStreamEvent("started", det.as<JsonObjectConst>());
+	return true;
+}
+
+/**
+ * @brief Übergibt einen Teil der Datei an den Puffer und weckt die TX-Task.
+ *
+ * @param data Daten.
+ * @param len Länge.
+ * @return Anzahl der übernommenen Bytes.
+ */
+size_t SerialBridge::feedStream(const uint8_t *data, size_t len) {
+	size_t n = _stream.offer(data, len);
+	if (n > 0 && _txTask) xTaskNotifyGive(_txTask);
+	return n;
+}
+
+/**
+ * @brief Meldet das Ende der Datei; die TX-Task sendet den Rest und schließt ab.
+ */
+void SerialBridge::endStream() {
+	_stream.endInput();
+	if (_txTask) xTaskNotifyGive(_txTask);
+}
+
+/**
+ * @brief Bricht die Dateiübertragung ab; die TX-Task meldet den Abbruch.
+ *
+ * @return false, wenn keine Übertragung läuft.
+ */
+bool SerialBridge::cancelStream() {
+	if (_stream.state() != FILE_STREAM_RUNNING) return false;
+	_stream.cancel();
+	if (_txTask) xTaskNotifyGive(_txTask);
+	return true;
+}
+
+/**
+ * @brief Zugriff auf die Dateiübertragung.
+ *
+ * @return Referenz auf den Zustand.
+ */
+const SerialFileStream &SerialBridge::getStream() const {
+	return _stream;
+}
+
+/**
+ * @brief Sendet die aktuelle Verfügbarkeit und Baudrate an alle WebSocket-Clients.
+ */
+void SerialBridge::sendAvailability() {
+	StaticJsonDocument<256> doc;
+	doc["event"] = "serial";
+	doc["channel"] = _channel;
+	doc["action"] = "status";
+	doc["status"] = "success";
+	JsonObject details = doc.createNestedObject("details");
+	details["available"] = _deviceConnected;
+	details["baudRate"] = _baudRate;
+	if (_autoBaudState != AUTOBAUD_IDLE) {
+		static const char *const states[] = {"idle", "running", "locked", "failed"};
+		JsonObject ab = details.createNestedObject("autoBaud");
+		ab["state"] = states[_autoBaudState];
+		if (_autoBaudState != AUTOBAUD_RUNNING) {
+			ab["score"] = _autoBaud.score;
+			ab["measured"] = _autoBaud.measured;
+			ab["probes"] = _autoBaud.probes;
+			ab["elapsedMs"] = _autoBaud.elapsedMs;
+		}
+	}
+	String payload;
+	serializeJson(doc, payload);
+	_out.broadcast(WS_PRIO_CONTROL, (const uint8_t *)payload.c_str(), payload.length(), false, millis());
+}
+
+/**
+ * @brief Reiht Daten für die TX-Task ein.
+ *
+ * @param data Der zu sendende String.
+ * @param clientId Client für die Abschlussmeldung (0 = keiner).
+ * @return Auftragsnummer oder 0 bei voller Sendewarteschlange oder während des Durchreichens.
+ */
+uint32_t SerialBridge::sendData(const String &data, uint32_t clientId) {
+	if (_passthrough.state() != PASSTHROUGH_IDLE) return 0;
+	uint32_t job = _tx.submit(clientId, (const uint8_t *)data.c_str(), data.length());
+	if (job && _txTask) xTaskNotifyGive(_txTask);
+	return job;
+}
+
+/**
+ * @brief Prüft neue Einstellungen des Sendepfads und übergibt sie der TX-Task.
+ *
+ * @param config Neue Einstellungen.
+ * @return false bei ungültigen Einstellungen.
+ */
+bool SerialBridge::setTxConfig(const SerialTxConfig &config) {
+	if (!SerialTx::validate(config)) return false;
+	portENTER_CRITICAL(&_clientsMux);
+	_txConfig = config;
+	_txDirty = true;
+	portEXIT_CRITICAL(&_clientsMux);
+	if (_txTask) {
+		xTaskNotifyGive(_txTask);
+	} else {
+		// TX-Task läuft noch nicht: direkt übernehmen
+		_txDirty = false;
+		_tx.configure(config);
+	}
+	return true;
+}
+
+/**
+ * @brief Gibt die zuletzt gesetzten Einstellungen des Sendepfads zurück.
+ *
+ * @return Kopie der Einstellungen.
+ */
+SerialTxConfig SerialBridge::getTxConfig() const {
+	portENTER_CRITICAL(&_clientsMux);
+	SerialTxConfig cfg = _txConfig;
+	portEXIT_CRITICAL(&_clientsMux);
+	return cfg;
+}
+
+/**
+ * @brief Gibt die Zähler des Sendepfads zurück.
+ *
+ * @return Kopie der Statistik.
+ */
+SerialTxStats SerialBridge::getTxStats() const {
+	return _tx.stats();
+}
+
+/**
+ * @brief Meldet dem anfragenden Client, dass sein Auftrag die Leitung verlassen hat.
+ *
+ * @param ctx Zeiger auf die SerialBridge-Instanz.
+ * @param client Client-ID (0 = keine Meldung).
+ * @param job Auftragsnummer.
+ * @param bytes Übertragene Bytes.
+ * @param ok false, wenn das Sendeende nicht bestätigt wurde.
+ */
+void SerialBridge::onTxDone(void *ctx, uint32_t client, uint32_t job, size_t bytes, bool ok) {
+	if (client == 0) return;
+	auto *self = static_cast<SerialBridge *>(ctx);
+	StaticJsonDocument<192> doc;
+	doc["event"] = "serial";
+	doc["channel"] = self->_channel;
+	doc["action"] = "send";
+	doc["status"] = ok ? "done" : "error";
+	JsonObject det = doc.createNestedObject("details");
+	det["job"] = job;
+	det["bytes"] = (uint32_t)bytes;
+	if (!ok) doc["error"] = "Sendeende nicht bestätigt";
+	String msg;
+	serializeJson(doc, msg);
+	self->_out.enqueue(client, WS_PRIO_CONTROL, (const uint8_t *)msg.c_str(), msg.length(), false, millis());
+}
+
+/**
+ * @brief Wertet die Geräteerkennung aus und meldet Wechsel.
+ *
+ * Lebenszeichen sind die in der Task gelesenen Blöcke (siehe taskFunc) und, mit
+ * Pegelauswertung, ein HIGH auf RX. Nur bei einem Wechsel wird geloggt, der StatusHandler
+ * nachgeführt und `sendAvailability()` aufgerufen.
+ */
+void SerialBridge::checkDevice() {
+	uint32_t now = millis();
+	if (_presenceDirty) {
+		portENTER_CRITICAL(&_clientsMux);
+		DevicePresenceConfig cfg = _presenceConfig;
+		_presenceDirty = false;
+		portEXIT_CRITICAL(&_clientsMux);
+		_presence.configure(cfg);
+	}
+	if (_presence.config().levelSense) _presence.level(digitalRead(_rxPin) == HIGH, now);
+
+	DevicePresenceEvent evt = _presence.update(now);
+	if (evt == PRESENCE_NONE) return;
+	_deviceConnected = evt == PRESENCE_CONNECTED;
+	updateSerialStatus(_deviceConnected);
+	if (_deviceConnected) {
+		LOGB(LOG_CAT_SYSTEM | LOG_CAT_INFO | LOG_CAT_DEVICE, LOG_FMT_DEVICE_CONNECTED, _logPrefix);
+	} else {
+		LOGB(LOG_CAT_SYSTEM | LOG_CAT_WARNING | LOG_CAT_DEVICE, LOG_FMT_DEVICE_DISCONNECTED, _logPrefix, (uint32_t)(now - _presence.lastSeen()));
+	}
+	sendAvailability();
+}
+
+/**
+ * @brief Führt SERIAL_CONNECTED/SERIAL_NOT_CONNECTED über alle Kanäle nach.
+ *
+ * SERIAL_CONNECTED gilt, solange mindestens ein Kanal ein Gerät erkannt hat.
+ *
+ * @param connected true, wenn dieser Kanal ein Gerät erkannt hat.
+ */
+void SerialBridge::updateSerialStatus(bool connected) {
+	portENTER_CRITICAL(&g_presenceMux);
+	uint8_t before = g_connectedChannels;
+	if (connected) {
+		g_connectedChannels++;
+	} else if (g_connectedChannels > 0) {
+		g_connectedChannels--;
+	}
+	uint8_t after = g_connectedChannels;
+	portEXIT_CRITICAL(&g_presenceMux);
+
+	if (before == 0 && after > 0) {
+		removeStatus(SERIAL_NOT_CONNECTED);
+		addStatus(SERIAL_CONNECTED);
+	} else if (before > 0 && after == 0) {
+		removeStatus(SERIAL_CONNECTED);
+		addStatus(SERIAL_NOT_CONNECTED);
+	}
+}
+
+/**
+ * @brief Präfix für Logmeldungen, damit Kanäle im selben Log unterscheidbar bleiben.
+ *
+ * @return "" auf Kanal 0 (unverändertes Logformat), sonst "[chN] ".
+ */
+String SerialBridge::logTag() const {
+	return String(_logPrefix);
+}
+
+/**
+ * @brief Callback des Framers: verteilt einen fertigen Datensatz und loggt ihn ggf.
+ *
+ * Text-Datensätze werden unverändert geloggt, Binär-Datensätze als Hex-Dump der ersten
+ * LOG_HEX_BYTES Bytes.
+ *
+ * @param ctx Zeiger auf die SerialBridge-Instanz.
+ * @param line Datensatz (nicht nullterminiert).
+ * @param len Länge des Datensatzes.
+ * @param complete true, wenn der Datensatz zusätzlich in das Geräte-Log geschrieben wird.
+ * @param rxUs Empfangszeitpunkt des ersten Bytes in µs.
+ */
+void SerialBridge::onLine(void *ctx, const uint8_t *line, size_t len, bool complete, uint64_t rxUs) {
+	auto *self = static_cast<SerialBridge *>(ctx);
+	// Antworten auf zyklische Abfragen gehen auf Wunsch nur in den Feldspeicher
+	if (complete && self->_poller.onRecord(line, len, millis()) && self->_poller.config().hideReplies) return;
+	uint16_t flags = complete ? SERIAL_FRAME_FLAG_NONE : SERIAL_FRAME_FLAG_PARTIAL;
+	self->_coalescer.add(line, len, flags, millis(), rxUs);
+	if (self->_filter) self->deliverFiltered(line, len, flags, rxUs);
+	if (self->_trigger) {
+		uint32_t fired = self->_trigger->onLine(line, len, millis());
+		if (fired) self->fireTriggers(fired, line, len, rxUs);
+	}
+	if (!complete) return;
+	constexpr uint32_t lineCats = LOG_CAT_SERIAL | LOG_CAT_INFO | LOG_CAT_DEVICE;
+	if (self->_framer.isText()) {
+		// Direkt aus dem Datensatz formatieren, ohne Zwischenkopie
+		LOGF(lineCats, "%s%.*s", self->_logPrefix, (int)len, (const char *)line);
+		return;
+	}
+	// Hex-Dump nur aufbauen, wenn die Meldung ausgegeben wird
+	if (!LogBuilt<lineCats>::value || !LogFilter::enabled(lineCats)) return;
+	static const char HEX_DIGITS[] = "0123456789ABCDEF";
+	size_t shown = len < LOG_HEX_BYTES ? len : LOG_HEX_BYTES;
+	char *out = self->_lineBuffer;
+	out += snprintf(out, 16, "[%u] ", (unsigned)len);
+	for (size_t i = 0; i < shown; ++i) {
+		*out++ = HEX_DIGITS[line[i] >> 4];
+		*out++ = HEX_DIGITS[line[i] & 0x0F];
+		*out++ = ' ';
+	}
+	if (shown < len) {
+		memcpy(out, "...", 3);
+		out += 3;
+	}
+	*out = '\0';
+	LOGF(lineCats, "%s%s", self->_logPrefix, self->_lineBuffer);
+}
+
+/**
+ * @brief Callback des Coalescers: reicht die Nachricht an broadcast() weiter.
+ *
+ * @param ctx Zeiger auf die SerialBridge-Instanz.
+ * @param data Eine oder mehrere Zeilen.
+ * @param len Länge der Daten.
+ * @param lines Anzahl der Zeilen (nur für die Statistik relevant).
+ * @param flags SerialFrameFlags der letzten Zeile.
+ * @param rxUs Empfangszeitpunkt der ersten Zeile in µs.
+ */
+void SerialBridge::onFrame(void *ctx, const uint8_t *data, size_t len, uint16_t lines, uint16_t flags, uint64_t rxUs) {
+	(void)lines;
+	static_cast<SerialBridge *>(ctx)->broadcast(data, len, flags, rxUs);
+}
+
+/**
+ * @brief Verteilt einen Datenblock an alle Clients.
+ *
+ * Solange kein Client den Binärkanal nutzt, wird wie bisher ein JSON-"incoming"-Event an alle
+ * Clients gesendet. Andernfalls bekommt jeder Client sein Format: binäre Frames mit
+ * Header und Rohdaten oder das JSON-Dokument, das dabei höchstens einmal erzeugt wird.
+ * Alle Nachrichten landen als WS_PRIO_BULK in den Sendewarteschlangen der Clients.
+ *
+ * @param data Rohdaten.
+ * @param len Länge der Daten (höchstens SerialCoalescer::MAX_FRAME).
+ * @param flags SerialFrameFlags für den Binär-Header.
+ * @param rxUs Empfangszeitpunkt in µs.
+ */
+void SerialBridge::broadcast(const uint8_t *data, size_t len, uint16_t flags, uint64_t rxUs) {
+	ClientSlot clients[MAX_CLIENTS];
+	portENTER_CRITICAL(&_clientsMux);
+	memcpy(clients, _clients, sizeof(clients));
+	portEXIT_CRITICAL(&_clientsMux);
+
+	bool anyBinary = false;
+	for (const auto &slot : clients) anyBinary |= slot.used && slot.binary;
+	// Clients mit Zeilenfilter bekommen ihre Zeilen einzeln über deliverFiltered()
+	uint32_t skip = filteredSlots(clients);
+
+	SerialFrameHeader hdr{SERIAL_FRAME_VERSION, _channel, flags, _seq++, rxUs};
+
+	// ArduinoJson benötigt einen nullterminierten String: Zeile einmal am Stück kopieren
+	memcpy(_textBuffer, data, len);
+	_textBuffer[len] = '\0';
+	String json;
+	auto buildJson = [&]() {
+		StaticJsonDocument<256> doc;
+		doc["event"] = "serial";
+		doc["channel"] = _channel;
+		doc["action"] = "incoming";
+		doc["status"] = "data";
+		doc["seq"] = hdr.seq;
+		doc["ts"] = hdr.timestamp;
+		doc["details"] = (const char *)_textBuffer;
+		serializeJson(doc, json);
+	};
+
+	_scrollback.append(hdr.seq, hdr.timestamp, flags, data, len);
+
+	uint32_t now = millis();
+	if (!anyBinary && skip == 0) {
+		buildJson();
+		_out.broadcast(WS_PRIO_BULK, (const uint8_t *)json.c_str(), json.length(), false, now);
+		return;
+	}
+
+	uint8_t *frame = _frameBuffer;
+	size_t frameLen = encodeSerialFrameHeader(hdr, frame);
+	memcpy(frame + frameLen, data, len);
+	frameLen += len;
+
+	for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+		const ClientSlot &slot = clients[i];
+		if (!slot.used || (skip & (1UL << i))) continue;
+		if (slot.binary) {
+			_out.enqueue(slot.id, WS_PRIO_BULK, frame, frameLen, true, now);
+		} else {
+			if (json.length() == 0) buildJson();
+			_out.enqueue(slot.id, WS_PRIO_BULK, (const uint8_t *)json.c_str(), json.length(), false, now);
+		}
+	}
+}
+
+/**
+ * @brief Führt die Aktionen ausgelöster Regeln aus.
+ *
+ * Alarme gehen vorrangig (WS_PRIO_CONTROL) an alle Clients. Lösen mehrere Regeln mit
+ * Schnappschuss auf derselben Zeile aus, gibt es nur einen, benannt nach der ersten.
+ *
+ * @param fired Bitmaske der ausgelösten Regeln.
+ * @param line Auslösende Zeile.
+ * @param len Länge der Zeile.
+ * @param rxUs Empfangszeitpunkt in µs.
+ */
+void SerialBridge::fireTriggers(uint32_t fired, const uint8_t *line, size_t len, uint64_t rxUs) {
+	char text[ALERT_TEXT + 1];
+	size_t shown = len < ALERT_TEXT ? len : ALERT_TEXT;
+	memcpy(text, line, shown);
+	text[shown] = '\0';
+	const char *snapshotRule = nullptr;
+	for (size_t i = 0; i < SerialTriggerConfig::MAX_RULES; ++i) {
+		if (!(fired & (1UL << i))) continue;
+		const SerialTriggerRule &rule = _trigger->rule(i);
+		const char *level = TRIGGER_LEVEL_NAMES[rule.level];
+		if (rule.actions & TRIGGER_ACTION_LOG) {
+			logger.log({"serial", level, "device"}, logTag() + "Regel " + rule.name + ": " + text);
+		}
+		if (rule.actions & TRIGGER_ACTION_STATUS) raiseTriggerStatus(rule.level);
+		if ((rule.actions & TRIGGER_ACTION_SNAPSHOT) && !snapshotRule) snapshotRule = rule.name;
+		if (rule.actions & TRIGGER_ACTION_ALERT) {
+			SerialTriggerRule copy;
+			SerialTriggerStats stats;
+			_trigger->rule(i, copy, stats);
+			StaticJsonDocument<384> doc;
+			doc["event"] = "serial";
+			doc["channel"] = _channel;
+			doc["action"] = "alert";
+			doc["status"] = level;
+			JsonObject det = doc.createNestedObject("details");
+			det["rule"] = (const char *)rule.name;
+			det["line"] = (const char *)text;
+			det["ts"] = rxUs;
+			det["hits"] = stats.hits;
+			det["snapshot"] = (rule.actions & TRIGGER_ACTION_SNAPSHOT) != 0;
+			String msg;
+			serializeJson(doc, msg);
+			_out.broadcast(WS_PRIO_CONTROL, (const uint8_t *)msg.c_str(), msg.length(), false, millis());
+		}
+	}
+	if (snapshotRule) takeSnapshot(snapshotRule, rxUs);
+}
+
+/**
+ * @brief Hält das Ende des Verlaufspuffers einschließlich der auslösenden Zeile fest.
+ *
+ * Gebündelte Zeilen werden vorher verteilt, damit die auslösende Zeile im Verlaufspuffer
+ * steht. Der Speicher wird beim ersten Schnappschuss angelegt.
+ *
+ * @param rule Name der auslösenden Regel.
+ * @param rxUs Empfangszeitpunkt der Zeile in µs.
+ */
+void SerialBridge::takeSnapshot(const char *rule, uint64_t rxUs) {
+	portENTER_CRITICAL(&_clientsMux);
+	uint8_t previous = _snapshotState;
+	if (previous != SNAPSHOT_READING) _snapshotState = SNAPSHOT_FILLING;
+	portEXIT_CRITICAL(&_clientsMux);
+	if (previous == SNAPSHOT_READING) {
+		logger.log({"system", "warning", "device"}, logTag() + "Schnappschuss für " + rule + " übersprungen (wird gerade gelesen)");
+		return;
+	}
+	if (!_snapshotData) _snapshotData = static_cast<uint8_t *>(malloc(TRIGGER_SNAPSHOT_BYTES));
+	if (!_snapshotData) {
+		logger.log({"system", "error", "device"}, logTag() + "Kein Speicher für den Schnappschuss");
+		portENTER_CRITICAL(&_clientsMux);
+		_snapshotState = SNAPSHOT_EMPTY;
+		portEXIT_CRITICAL(&_clientsMux);
+		return;
+	}
+
+	_coalescer.flush(millis());
+	SerialTriggerSnapshot snap;
+	memset(&snap, 0, sizeof(snap));
+	strncpy(snap.rule, rule, sizeof(snap.rule) - 1);
+	snap.timestamp = rxUs;
+	snap.takenMs = millis();
+	uint64_t cursor = _scrollback.seekTail(TRIGGER_SNAPSHOT_BYTES);
+	SerialScrollbackRecord rec;
+	bool first = true;
+	while (snap.len < TRIGGER_SNAPSHOT_BYTES && _scrollback.read(cursor, rec, _snapshotData + snap.len, TRIGGER_SNAPSHOT_BYTES - snap.len)) {
+		if (first) snap.firstSeq = rec.seq;
+		first = false;
+		snap.lastSeq = rec.seq;
+		size_t room = TRIGGER_SNAPSHOT_BYTES - snap.len;
+		snap.len += rec.len < room ? rec.len : room;
+	}
+	_snapshot = snap;
+
+	portENTER_CRITICAL(&_clientsMux);
+	_snapshotState = SNAPSHOT_READY;
+	portEXIT_CRITICAL(&_clientsMux);
+}
+
+/**
+ * @brief Slots, deren Client gerade einen aktiven Filter hat.
+ *
+ * Der Filter gilt nur für den Client, für den er gesetzt wurde; ein neuer Client im selben
+ * Slot bleibt bis zum nächsten Filterwechsel ungefiltert.
+ *
+ * @param clients Kopie der Client-Slots.
+ * @return Bitmaske der Slots.
+ */
+uint32_t SerialBridge::filteredSlots(const ClientSlot *clients) const {
+	if (!_filter) return 0;
+	uint32_t filtered = _filter->filtered();
+	uint32_t mask = 0;
+	for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+		if ((filtered & (1UL << i)) && clients[i].used && clients[i].id == _filterIds[i]) mask |= 1UL << i;
+	}
+	return mask;
+}
+
+/**
+ * @brief Stellt eine Zeile den Clients zu, deren Filter sie durchlässt.
+ *
+ * Die Zeile wird einmal für alle Clients bewertet. Jeder Client erhält sie als eigenes
+ * `serial`/`incoming`-Event mit `filtered: true` bzw. als Frame mit
+ * SERIAL_FRAME_FLAG_FILTERED; `seq` zählt die Zeilen pro Client.
+ *
+ * @param line Zeile.
+ * @param len Länge der Zeile.
+ * @param flags SERIAL_FRAME_FLAG_PARTIAL bei Zeilen ohne Zeilenende.
+ * @param rxUs Empfangszeitpunkt in µs.
+ */
+void SerialBridge::deliverFiltered(const uint8_t *line, size_t len, uint16_t flags, uint64_t rxUs) {
+	uint32_t mask = _filter->evaluate(line, len);
+	if (mask == 0) return;
+	ClientSlot clients[MAX_CLIENTS];
+	portENTER_CRITICAL(&_clientsMux);
+	memcpy(clients, _clients, sizeof(clients));
+	portEXIT_CRITICAL(&_clientsMux);
+	mask &= filteredSlots(clients);
+	if (mask == 0) return;
+
+	memcpy(_textBuffer, line, len);
+	_textBuffer[len] = '\0';
+	StaticJsonDocument<256> doc;
+	bool hasDoc = false;
+	uint32_t now = millis();
+	for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+		if (!(mask & (1UL << i))) continue;
+		const ClientSlot &slot = clients[i];
+		uint32_t seq = _filterSeq[i];
+		_filterSeq[i] = seq + 1;
+		if (slot.binary) {
+			SerialFrameHeader hdr{SERIAL_FRAME_VERSION, _channel, (uint16_t)(flags | SERIAL_FRAME_FLAG_FILTERED), seq, rxUs};
+			size_t frameLen = encodeSerialFrameHeader(hdr, _frameBuffer);
+			memcpy(_frameBuffer + frameLen, line, len);
+			_out.enqueue(slot.id, WS_PRIO_BULK, _frameBuffer, frameLen + len, true, now);
+			continue;
+		}
+		if (!hasDoc) {
+			doc["event"] = "serial";
+			doc["channel"] = _channel;
+			doc["action"] = "incoming";
+			doc["status"] = "data";
+			doc["ts"] = rxUs;
+			doc["filtered"] = true;
+			doc["details"] = (const char *)_textBuffer;
+			hasDoc = true;
+		}
+		doc["seq"] = seq;
+		String json;
+		serializeJson(doc, json);
+		_out.enqueue(slot.id, WS_PRIO_BULK, (const uint8_t *)json.c_str(), json.length(), false, now);
+	}
+}
+
+/**
+ * @brief Sendet für alle Clients mit laufendem Replay die nächsten Blöcke.
+ *
+ * Wurde die Leseposition eines langsamen Replays inzwischen überschrieben, wird beim ältesten
+ * noch vorhandenen Block fortgesetzt und die Lücke in `missing` gemeldet.
+ *
+ * @return true, solange noch ein Replay läuft.
+ */
+bool SerialBridge::pumpReplay() {
+	bool active = false;
+	SerialScrollbackRecord rec;
+
+	for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+		portENTER_CRITICAL(&_clientsMux);
+		ClientSlot slot = _clients[i];
+		portEXIT_CRITICAL(&_clientsMux);
+		if (!slot.used || slot.replay == REPLAY_IDLE) continue;
+
+		StaticJsonDocument<256> doc;
+		String msg;
+
+		if (slot.replay == REPLAY_REQUESTED) {
+			uint32_t missing = 0;
+			slot.replayPos = slot.replayMode == SERIAL_REPLAY_FROM_SEQ ? _scrollback.seekSeq(slot.replayArg, missing) : _scrollback.seekTail(slot.replayArg);
+			slot.replayEnd = _scrollback.end();
+			slot.replayMissing = missing;
+			slot.replayChunks = 0;
+			slot.replay = REPLAY_ACTIVE;
+
+			doc["event"] = "serial";
+			doc["channel"] = _channel;
+			doc["action"] = "replay";
+			doc["status"] = "success";
+			JsonObject det = doc.createNestedObject("details");
+			det["firstSeq"] = _scrollback.firstSeq();
+			det["nextSeq"] = _seq;
+			det["bytes"] = (uint32_t)(slot.replayEnd - slot.replayPos);
+			det["missing"] = missing;
+			serializeJson(doc, msg);
+			_out.enqueue(slot.id, WS_PRIO_CONTROL, (const uint8_t *)msg.c_str(), msg.length(), false, millis());
+		}
+
+		for (size_t n = 0; n < REPLAY_BURST; ++n) {
+			if (!_scrollback.valid(slot.replayPos)) {
+				slot.replayPos = _scrollback.begin();
+				slot.replayMissing++;
+			}
+			if (slot.replayPos >= slot.replayEnd) {
+				doc.clear();
+				msg = "";
+				doc["event"] = "serial";
+				doc["channel"] = _channel;
+				doc["action"] = "replay";
+				doc["status"] = "done";
+				JsonObject det = doc.createNestedObject("details");
+				det["chunks"] = slot.replayChunks;
+				det["missing"] = slot.replayMissing;
+				det["nextSeq"] = _seq;
+				serializeJson(doc, msg);
+				// Als Datennachricht einreihen, damit sie nach den Replay-Blöcken ankommt
+				_out.enqueue(slot.id, WS_PRIO_BULK, (const uint8_t *)msg.c_str(), msg.length(), false, millis());
+				slot.replay = REPLAY_IDLE;
+				break;
+			}
+			if (_out.bulkSpace(slot.id) < SERIAL_FRAME_HEADER_LEN + SerialCoalescer::MAX_FRAME + REPLAY_RESERVE) break;
+			if (!_scrollback.read(slot.replayPos, rec, _frameBuffer + SERIAL_FRAME_HEADER_LEN, SerialCoalescer::MAX_FRAME)) break;
+			sendReplayChunk(slot, rec);
+			slot.replayChunks++;
+		}
+
+		// Zustand zurückschreiben, sofern der Client nicht inzwischen getrennt wurde oder neu angefragt hat
+		portENTER_CRITICAL(&_clientsMux);
+		ClientSlot &live = _clients[i];
+		if (live.used && live.id == slot.id && live.replay != REPLAY_REQUESTED) {
+			live.replay = slot.replay;
+			live.replayChunks = slot.replayChunks;
+			live.replayMissing = slot.replayMissing;
+			live.replayPos = slot.replayPos;
+			live.replayEnd = slot.replayEnd;
+		}
+		active |= live.used && live.replay != REPLAY_IDLE;
+		portEXIT_CRITICAL(&_clientsMux);
+	}
+	return active;
+}
+
+/**
+ * @brief Verschickt einen Block aus dem Verlaufspuffer an einen Client.
+ *
+ * Die Nutzdaten liegen bereits hinter dem Header-Platz in _frameBuffer. Binär-Clients
+ * erhalten ein Frame mit SERIAL_FRAME_FLAG_REPLAY, JSON-Clients ein `serial`/`replay`-Event.
+ *
+ * @param slot Client.
+ * @param rec Kopf des Blocks.
+ */
+void SerialBridge::sendReplayChunk(const ClientSlot &slot, const SerialScrollbackRecord &rec) {
+	uint8_t *payload = _frameBuffer + SERIAL_FRAME_HEADER_LEN;
+	if (slot.binary) {
+		SerialFrameHeader hdr{SERIAL_FRAME_VERSION, _channel, (uint16_t)(rec.flags | SERIAL_FRAME_FLAG_REPLAY), rec.seq, rec.timestamp};
+		encodeSerialFrameHeader(hdr, _frameBuffer);
+		_out.enqueue(slot.id, WS_PRIO_BULK, _frameBuffer, SERIAL_FRAME_HEADER_LEN + rec.len, true, millis());
+		return;
+	}
+	memcpy(_textBuffer, payload, rec.len);
+	_textBuffer[rec.len] = '\0';
+	StaticJsonDocument<256> doc;
+	doc["event"] = "serial";
+	doc["channel"] = _channel;
+	doc["action"] = "replay";
+	doc["status"] = "data";
+	doc["seq"] = rec.seq;
+	doc["ts"] = rec.timestamp;
+	doc["details"] = (const char *)_textBuffer;
+	String json;
+	serializeJson(doc, json);
+	_out.enqueue(slot.id, WS_PRIO_BULK, (const uint8_t *)json.c_str(), json.length(), false, millis());
+}
+
+/**
+ * @brief Interne FreeRTOS-Task-Funktion zur Überwachung des seriellen Eingangs.
+ *
+ * Diese Funktion wird dauerhaft ausgeführt. Sie
+ * - blockiert auf neuen Daten (Event-Queue bzw. 5-ms-Polling, siehe SerialRxPump),
+ * - meldet ein erkanntes bzw. getrenntes Gerät (DevicePresence, entprellt),
+ * - übergibt empfangene Bytes blockweise an den SerialFramer, der fertige Datensätze an den
+ *   SerialCoalescer weiterreicht,
+ * - gibt einen angefangenen Datensatz aus, wenn `timeoutMs` des Framings lang keine Bytes
+ *   kamen (im Modus IDLE ist das das reguläre Datensatzende),
+ * - sendet gebündelte Zeilen spätestens nach Ablauf des Latenzbudgets,
+ * - setzt laufende Replays blockweise fort (dann wacht sie alle REPLAY_INTERVAL_MS auf).
+ *
+ * Während des Durchreichens gehen empfangene Bytes ungeframt als RAW-Frames an den Besitzer
+ * (siehe collectPassthroughRx()); Framer, TCP-Zugang, Skripte und Abfragen bekommen nichts.
+ *
+ * Ohne ausstehende Daten wacht die Task im Ereignisbetrieb nur alle IDLE_WAKE_MS auf.
+ *
+ * @param param Pointer auf die SerialBridge-Instanz (this).
+ */
+void SerialBridge::taskFunc(void *param) {
+	auto *self = static_cast<SerialBridge *>(param);
+	self->_lastRx = millis();
+
+	uint8_t chunk[RX_CHUNK];
+	uint32_t lastOverflows = 0;
+	bool replaying = false;
+	bool wasPassing = false;
+
+	for (;;) {
+		if (self->_autoBaudRequested) self->runAutoBaud();
+
+		// Beim Wechsel ins Durchreichen Angefangenes noch regulär verteilen
+		bool passing = self->_passthrough.state() != PASSTHROUGH_IDLE;
+		if (passing && !wasPassing) {
+			if (self->_framer.pending() > 0) self->_framer.flush();
+			self->_coalescer.flush(millis());
+			self->_passthroughRxLen = 0;
+		}
+		wasPassing = passing;
+
+		// 1) Auf neue Bytes warten; mit angefangenem Datensatz höchstens bis zum Framing-Timeout
+		//    bzw. bis gebündelte Zeilen fällig sind
+		if (self->_framingDirty) {
+			portENTER_CRITICAL(&self->_clientsMux);
+			SerialFramerConfig framing = self->_framingConfig;
+			self->_framingDirty = false;
+			portEXIT_CRITICAL(&self->_clientsMux);
+			self->_framer.configure(framing);
+		}
+		if (self->_coalesceDirty) {
+			portENTER_CRITICAL(&self->_clientsMux);
+			uint32_t latency = self->_coalesceLatency;
+			size_t frame = self->_coalesceFrame;
+			self->_coalesceDirty = false;
+			portEXIT_CRITICAL(&self->_clientsMux);
+			self->_coalescer.flush(millis());
+			self->_coalescer.configure(latency, frame);
+		}
+		if (self->_pollDirty) {
+			// Wie beim Filter nur den Zeiger tauschen; übernommen wird außerhalb der Sperre
+			portENTER_CRITICAL(&self->_clientsMux);
+			SerialPollerConfig *poll = self->_pollPending;
+			self->_pollPending = nullptr;
+			self->_pollDirty = false;
+			portEXIT_CRITICAL(&self->_clientsMux);
+			if (poll) self->_poller.configure(*poll, millis());
+			delete poll;
+			// Feldindizes sind neu vergeben: Abonnements einzelner Felder entfallen
+			portENTER_CRITICAL(&self->_clientsMux);
+			for (auto &slot : self->_clients) {
+				if (slot.fields != POLL_ALL_FIELDS) slot.fields = 0;
+			}
+			portEXIT_CRITICAL(&self->_clientsMux);
+		}
+		if (self->_filterDirty) {
+			portENTER_CRITICAL(&self->_clientsMux);
+			SerialLineFilter *filter = self->_filterPending;
+			self->_filterPending = nullptr;
+			for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+				// Neuer Besitzer des Slots: Zeilenzähler beginnt wieder bei 0
+				if (self->_filterIds[i] != self->_filterPendingIds[i]) self->_filterSeq[i] = 0;
+				self->_filterIds[i] = self->_filterPendingIds[i];
+			}
+			self->_filterDirty = false;
+			portEXIT_CRITICAL(&self->_clientsMux);
+			delete self->_filter;
+			self->_filter = filter;
+		}
+		if (self->_triggerDirty) {
+			portENTER_CRITICAL(&self->_clientsMux);
+			SerialTrigger *old = self->_trigger;
+			self->_trigger = self->_triggerPending;
+			self->_triggerPending = nullptr;
+			self->_triggerDirty = false;
+			portEXIT_CRITICAL(&self->_clientsMux);
+			delete old;
+		}
+		uint32_t timeout = IDLE_WAKE_MS;
+		// Zyklische Abfragen senden, solange kein Skript mit dem Gerät spricht, keine Datei gesendet
+		// und nicht durchgereicht wird
+		bool quiet = !self->_script.busy() && self->_stream.state() == FILE_STREAM_IDLE && !passing;
+		uint32_t pollWait = self->_poller.service(millis(), quiet);
+		if (pollWait < timeout) timeout = pollWait;
+		uint32_t frameTimeout = self->_framer.config().timeoutMs;
+		if (self->_framer.pending() > 0 && frameTimeout > 0) {
+			uint32_t since = millis() - self->_lastRx;
+			if (since >= frameTimeout) {
+				timeout = 0;
+			} else if (frameTimeout - since < timeout) {
+				timeout = frameTimeout - since;
+			}
+		}
+		uint32_t due = self->_coalescer.msUntilDue(millis());
+		if (due < timeout) timeout = due;
+		if (replaying && REPLAY_INTERVAL_MS < timeout) timeout = REPLAY_INTERVAL_MS;
+		size_t n = self->_rx.wait(chunk, sizeof(chunk), timeout);
+
+		if (self->_rx.stats().overflows != lastOverflows) {
+			lastOverflows = self->_rx.stats().overflows;
+			LOGB(LOG_CAT_SYSTEM | LOG_CAT_WARNING | LOG_CAT_DEVICE, LOG_FMT_UART_OVERFLOW, self->_logPrefix);
+		}
+
+		// 2) Alle anstehenden Bytes blockweise an den Framer geben; fertige Zeilen gehen sofort raus.
+		//    Jeder Block wird direkt nach dem Lesen mit µs-Auflösung gestempelt.
+		while (n > 0) {
+			uint64_t rxUs = (uint64_t)esp_timer_get_time();
+			self->_lastRx = millis();
+			self->_presence.activity(self->_lastRx);
+			self->_recorder.append(CAPTURE_RX, chunk, n, rxUs);
+			if (passing) {
+				self->collectPassthroughRx(chunk, n, rxUs);
+			} else {
+				self->_tcp.onRx(chunk, n);
+				if (self->_script.onRx(chunk, n) && self->_scriptTask) xTaskNotifyGive(self->_scriptTask);
+				if (self->_stream.onRx(chunk, n) && self->_txTask) xTaskNotifyGive(self->_txTask);
+				self->_framer.feed(chunk, n, rxUs);
+			}
+			n = self->_port.available() ? self->_port.read(chunk, sizeof(chunk)) : 0;
+		}
+		if (passing) self->flushPassthroughRx();
+
+		// 3) Geräteerkennung: Wechsel verbunden/getrennt melden
+		self->checkDevice();
+
+		// 4) Wenn nach dem Framing-Timeout keine neuen Bytes kamen, flushen
+		uint32_t since = millis() - self->_lastRx;
+		if (self->_framer.pending() > 0 && frameTimeout > 0 && since >= frameTimeout) {
+			self->_framer.flush();
+		}
+
+		// 5) Gebündelte Zeilen senden, sobald das Latenzbudget abgelaufen ist
+		self->_coalescer.poll(millis());
+
+		// 6) Replays blockweise fortsetzen
+		replaying = self->pumpReplay();
+	}
+}
+
+/**
+ * @brief FreeRTOS-Task für den Versand.
+ *
+ * Schläft, bis sendData() oder setTxConfig() sie benachrichtigt, übernimmt ggf. neue
+ * Einstellungen und überträgt dann alle wartenden Aufträge.
+ * Während einer Dateiübertragung wacht sie zusätzlich zum Ende von Zeilenpause bzw.
+ * Prompt-Wartezeit und für die Fortschrittsmeldungen auf.
+ *
+ * @param param Pointer auf die SerialBridge-Instanz (this).
+ */
+void SerialBridge::txTaskFunc(void *param) {
+	auto *self = static_cast<SerialBridge *>(param);
+	for (;;) {
+		TickType_t wait = portMAX_DELAY;
+		if (self->_passthrough.state() != PASSTHROUGH_IDLE) {
+			wait = pdMS_TO_TICKS(PASSTHROUGH_WAKE_MS);
+		} else if (self->_stream.state() != FILE_STREAM_IDLE && self->_streamWait != UINT32_MAX) {
+			wait = pdMS_TO_TICKS(self->_streamWait);
+		}
+		ulTaskNotifyTake(pdTRUE, wait);
+		if (self->_txDirty) {
+			portENTER_CRITICAL(&self->_clientsMux);
+			SerialTxConfig cfg = self->_txConfig;
+			self->_txDirty = false;
+			portEXIT_CRITICAL(&self->_clientsMux);
+			if (!self->_tx.configure(cfg)) {
+				logger.log({"system", "error", "device"}, self->logTag() + "Flusskontrolle wird von der UART nicht unterstützt");
+			}
+		}
+		if (self->_bootRequest != BOOT_MODE_NONE) {
+			uint8_t mode = self->_bootRequest;
+			bool ok = self->_passthrough.resetTarget(mode);
+			self->_bootRequest = BOOT_MODE_NONE;
+			const char *target = mode == BOOT_MODE_BOOTLOADER ? "bootloader" : "run";
+			logger.log({"system", ok ? "info" : "warning", "device"}, self->logTag() + (ok ? "Controller zurückgesetzt: " + String(target) : String("Reset nicht möglich: keine Boot-Leitungen")));
+			StaticJsonDocument<64> det;
+			det["mode"] = target;
+			self->sendPassthroughEvent(self->_bootRequester, ok ? "reset" : "error", det.as<JsonObjectConst>(), ok ? nullptr : "Keine Boot-Leitungen");
+		}
+		if (self->_passthrough.state() != PASSTHROUGH_IDLE) {
+			self->servicePassthrough();
+			continue;
+		}
+		self->_tx.service();
+		if (self->_stream.state() != FILE_STREAM_IDLE) self->serviceStream();
+	}
+}
+
+/**
+ * @brief Bedient die Dateiübertragung in der TX-Task.
+ *
+ * Jeder Block wird sofort übertragen, bevor SerialFileStream::poll() den nächsten entnimmt;
+ * Zeilenpause und Prompt-Wartezeit beginnen so erst nach dem tatsächlichen Senden. Der
+ * Fortschritt geht höchstens alle STREAM_PROGRESS_MS an die Clients.
+ */
+void SerialBridge::serviceStream() {
+	uint32_t wait;
+	while ((wait = _stream.poll(millis())) == 0) _tx.service();
+	SerialFileStreamState state = _stream.state();
+	if (state == FILE_STREAM_DONE || state == FILE_STREAM_FAILED) {
+		finishStream();
+		return;
+	}
+	uint32_t now = millis();
+	if (now - _streamReportMs >= STREAM_PROGRESS_MS) {
+		_streamReportMs = now;
+		SerialFileStreamStats st = _stream.stats();
+		if (st.sent != _streamReported) {
+			_streamReported = st.sent;
+			uint32_t total = _stream.config().size;
+			StaticJsonDocument<192> det;
+			det["received"] = st.received;
+			det["sent"] = st.sent;
+			det["lines"] = st.lines;
+			det["total"] = total;
+			if (total > 0) det["percent"] = st.received >= total ? 100 : (uint32_t)((uint64_t)st.received * 100 / total);
+			sendStreamEvent("progress", det.as<JsonObjectConst>());
+		}
+	}
+	_streamWait = wait < STREAM_PROGRESS_MS ? wait : STREAM_PROGRESS_MS;
+}
+
+/**
+ * @brief Schließt die Dateiübertragung ab.
+ *
+ * Der Speicher wird vor close() übernommen: danach kann bereits eine neue Übertragung beginnen.
+ */
+void SerialBridge::finishStream() {
+	uint8_t *mem = _streamMem;
+	_streamMem = nullptr;
+	uint32_t total = _stream.config().size;
+	SerialFileStreamStats st = _stream.close(millis());
+	free(mem);
+	_streamReported = 0;
+	_streamWait = UINT32_MAX;
+
+	const char *error = st.error != FILE_STREAM_OK ? SerialFileStream::errorText(st.error) : nullptr;
+	if (!error && total > 0 && st.received != total) error = "Datei unvollständig";
+	String summary = String(st.received) + " Bytes, " + String(st.lines) + " Zeilen in " + String(st.elapsedMs) + " ms";
+	if (error) {
+		logger.log({"system", "warning", "device"}, logTag() + "Dateiübertragung beendet (" + String(error) + "): " + summary);
+	} else {
+		logger.log({"system", "info", "device"}, logTag() + "Datei gesendet: " + summary);
+	}
+	StaticJsonDocument<256> det;
+	det["bytes"] = st.received;
+	det["sent"] = st.sent;
+	det["lines"] = st.lines;
+	det["prompts"] = st.prompts;
+	det["ms"] = st.elapsedMs;
+	det["maxBuffered"] = (uint32_t)st.maxBuffered;
+	sendStreamEvent(error ? "error" : "done", det.as<JsonObjectConst>(), error);
+}
+
+/**
+ * @brief Sendet ein `serial`/`stream`-Event an alle Clients.
+ *
+ * @param status Status des Events.
+ * @param details Details.
+ * @param error Fehlerbeschreibung oder nullptr.
+ */
+void SerialBridge::sendStreamEvent(const char *status, JsonObjectConst details, const char *error) {
+	StaticJsonDocument<384> doc;
+	doc["event"] = "serial";
+	doc["channel"] = _channel;
+	doc["action"] = "stream";
+	doc["status"] = status;
+	doc["details"] = details;
+	if (error) doc["error"] = error;
+	String msg;
+	serializeJson(doc, msg);
+	_out.broadcast(WS_PRIO_CONTROL, (const uint8_t *)msg.c_str(), msg.length(), false, millis());
+}
+
+/**
+ * @brief Bedient das Durchreichen in der TX-Task.
+ *
+ * Beim Start gehen zuvor eingereihte Aufträge noch mit der alten Rate hinaus; danach stellt
+ * SerialPassthrough::enter() Rate und Boot-Leitungen ein. Geschrieben wird, bis der Puffer
+ * leer ist. Der Besitzer erhält nach je PASSTHROUGH_ACK_BYTES und bei leerem Puffer eine
+ * Quittung mit dem neuen Limit, bis zu dem er senden darf.
+ */
+void SerialBridge::servicePassthrough() {
+	uint32_t owner = _passthrough.owner();
+	if (_passthrough.state() == PASSTHROUGH_STARTING) {
+		_tx.service();
+		bool lines = _passthrough.enter();
+		const SerialPassthroughConfig &cfg = _passthrough.config();
+		if (!lines) {
+			logger.log({"system", "warning", "device"}, logTag() + "Keine Boot-Leitungen, Controller wurde nicht zurückgesetzt");
+		}
+		logger.log({"system", "info", "device"}, logTag() + "Durchreichen aktiv: " + String(cfg.baud) + " Baud");
+		StaticJsonDocument<192> det;
+		det["baud"] = cfg.baud;
+		det["size"] = cfg.size;
+		det["window"] = (uint32_t)SerialPassthrough::BUFFER_BYTES;
+		det["limit"] = _passthrough.limit();
+		det["bootLines"] = lines;
+		sendPassthroughEvent(owner, "ready", det.as<JsonObjectConst>());
+	}
+
+	auto ack = [&]() {
+		_passthroughAcked = _passthrough.written();
+		StaticJsonDocument<96> det;
+		det["acked"] = _passthroughAcked;
+		det["limit"] = _passthrough.limit();
+		sendPassthroughEvent(owner, "ack", det.as<JsonObjectConst>());
+	};
+	while (_passthrough.drain() > 0) {
+		if (_passthrough.written() - _passthroughAcked >= PASSTHROUGH_ACK_BYTES) ack();
+	}
+	if (_passthrough.written() != _passthroughAcked) ack();
+
+	if (_passthrough.complete()) {
+		finishPassthrough(_passthrough.aborted() ? "Abgebrochen" : nullptr);
+	} else if (_passthrough.idle()) {
+		finishPassthrough("Zeitüberschreitung: keine Daten");
+	}
+}
+
+/**
+ * @brief Schließt das Durchreichen ab.
+ *
+ * Ohne `restoreBaud` bleibt die Rate der Übertragung als neue Rate des Kanals aktiv.
+ *
+ * @param error Fehlerbeschreibung oder nullptr.
+ */
+void SerialBridge::finishPassthrough(const char *error) {
+	uint32_t owner = _passthrough.owner();
+	bool restore = _passthrough.config().restoreBaud;
+	SerialPassthroughStats st = _passthrough.finish(restore ? _baudRate : 0);
+	if (!restore) _baudRate = st.baud;
+	free(_passthroughMem);
+	_passthroughMem = nullptr;
+	_passthrough.close();
+
+	String summary = String(st.written) + " Bytes in " + String(st.elapsedMs) + " ms (" + String(st.bytesPerSec) + " B/s, " + String(st.linePercent) + " % der Leitungsrate)";
+	if (error) {
+		logger.log({"system", "warning", "device"}, logTag() + "Durchreichen beendet (" + String(error) + "): " + summary);
+	} else {
+		logger.log({"system", "info", "device"}, logTag() + "Durchreichen beendet: " + summary);
+	}
+	StaticJsonDocument<384> det;
+	det["baud"] = st.baud;
+	det["bytes"] = st.written;
+	det["received"] = st.received;
+	det["rxBytes"] = st.rxBytes;
+	det["chunks"] = st.chunks;
+	det["rejected"] = st.rejected;
+	det["ms"] = st.elapsedMs;
+	det["bytesPerSec"] = st.bytesPerSec;
+	det["linePercent"] = st.linePercent;
+	det["maxBuffered"] = (uint32_t)st.maxBuffered;
+	sendPassthroughEvent(owner, error ? "error" : "done", det.as<JsonObjectConst>(), error);
+	sendAvailability();
+}
+
+/**
+ * @brief Sendet ein `serial`/`passthrough`-Event vorrangig an einen Client.
+ *
+ * @param id Client-ID (0 = keine Meldung).
+ * @param status Status des Events.
+ * @param details Details.
+ * @param error Fehlerbeschreibung oder nullptr.
+ */
+void SerialBridge::sendPassthroughEvent(uint32_t id, const char *status, JsonObjectConst details, const char *error) {
+	if (id == 0) return;
+	StaticJsonDocument<512> doc;
+	doc["event"] = "serial";
+	doc["channel"] = _channel;
+	doc["action"] = "passthrough";
+	doc["status"] = status;
+	doc["details"] = details;
+	if (error) doc["error"] = error;
+	String msg;
+	serializeJson(doc, msg);
+	_out.enqueue(id, WS_PRIO_CONTROL, (const uint8_t *)msg.c_str(), msg.length(), false, millis());
+}
+
+/**
+ * @brief Sammelt Empfangsdaten hinter dem Header-Platz in _frameBuffer.
+ *
+ * Ein voller Block geht sofort hinaus, der Rest mit flushPassthroughRx() am Ende des
+ * Durchlaufs.
+ *
+ * @param data Empfangene Bytes.
+ * @param len Anzahl der Bytes.
+ * @param rxUs Empfangszeitpunkt in µs.
+ */
+void SerialBridge::collectPassthroughRx(const uint8_t *data, size_t len, uint64_t rxUs) {
+	_passthrough.onRx(len);
+	while (len > 0) {
+		if (_passthroughRxLen == 0) _passthroughRxUs = rxUs;
+		size_t room = SerialCoalescer::MAX_FRAME - _passthroughRxLen;
+		size_t n = len < room ? len : room;
+		memcpy(_frameBuffer + SERIAL_FRAME_HEADER_LEN + _passthroughRxLen, data, n);
+		_passthroughRxLen += n;
+		data += n;
+		len -= n;
+		if (_passthroughRxLen == SerialCoalescer::MAX_FRAME) flushPassthroughRx();
+	}
+}
+
+/**
+ * @brief Sendet die gesammelten Empfangsdaten als Binär-Frame mit SERIAL_FRAME_FLAG_RAW.
+ *
+ * Die Daten gehen nur an den Besitzer und nicht in den Verlaufspuffer.
+ */
+void SerialBridge::flushPassthroughRx() {
+	if (_passthroughRxLen == 0) return;
+	SerialFrameHeader hdr{SERIAL_FRAME_VERSION, _channel, SERIAL_FRAME_FLAG_RAW, _passthroughSeq++, _passthroughRxUs};
+	encodeSerialFrameHeader(hdr, _frameBuffer);
+	uint32_t owner = _passthrough.owner();
+	if (owner) _out.enqueue(owner, WS_PRIO_BULK, _frameBuffer, SERIAL_FRAME_HEADER_LEN + _passthroughRxLen, true, millis());
+	_passthroughRxLen = 0;
+}
+
+/**
+ * @brief Mithörer der SerialTx: übergibt gesendete Bytes an den Mitschnitt.
+ *
+ * @param ctx Zeiger auf die SerialBridge-Instanz.
+ * @param data Gesendete Bytes.
+ * @param len Anzahl der Bytes.
+ */
+void SerialBridge::onTxData(void *ctx, const uint8_t *data, size_t len) {
+	static_cast<SerialBridge *>(ctx)->_recorder.append(CAPTURE_TX, data, len, (uint64_t)esp_timer_get_time());
+}
+
+/**
+ * @brief Weckt die Schreib-Task des Mitschnitts.
+ *
+ * @param ctx Zeiger auf die SerialBridge-Instanz.
+ */
+void SerialBridge::onRecorderWake(void *ctx) {
+	auto *self = static_cast<SerialBridge *>(ctx);
+	if (self->_recTask) xTaskNotifyGive(self->_recTask);
+}
+
+/**
+ * @brief FreeRTOS-Task für den Mitschnitt.
+ *
+ * Schreibt volle Puffer, sobald der SerialRecorder weckt, und teilweise gefüllte spätestens
+ * nach SerialRecorder::FLUSH_INTERVAL_MS. Bricht der Mitschnitt ab (Quote, Schreibfehler),
+ * wird das geloggt und allen Clients als `serial`/`record`/`error` gemeldet.
+ *
+ * @param param Pointer auf die SerialBridge-Instanz (this).
+ */
+void SerialBridge::recTaskFunc(void *param) {
+	auto *self = static_cast<SerialBridge *>(param);
+	for (;;) {
+		bool wasActive = self->_recorder.active();
+		uint32_t wait = self->_recorder.service(millis());
+		if (wasActive && !self->_recorder.active()) {
+			const char *error = self->_recorder.lastError();
+			if (error[0] == '\0') {
+				logger.log({"system", "info", "device"}, self->logTag() + "Mitschnitt beendet: " + String(self->_recorder.session()));
+			} else {
+				logger.log({"system", "error", "device"}, self->logTag() + "Mitschnitt abgebrochen: " + String(error));
+				StaticJsonDocument<192> doc;
+				doc["event"] = "serial";
+				doc["channel"] = self->_channel;
+				doc["action"] = "record";
+				doc["status"] = "error";
+				doc["details"] = self->_recorder.session();
+				doc["error"] = error;
+				String msg;
+				serializeJson(doc, msg);
+				self->_out.broadcast(WS_PRIO_CONTROL, (const uint8_t *)msg.c_str(), msg.length(), false, millis());
+			}
+		}
+		ulTaskNotifyTake(pdTRUE, wait == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(wait));
+	}
+}
+
+/**
+ * @brief FreeRTOS-Task für den TCP-Zugang.
+ *
+ * Übernimmt neue Einstellungen (Ports öffnen/schließen) und bedient danach die Sockets mit
+ * SerialTcpServer::poll(). Ist der Zugang aus, schläft die Task bis zur nächsten Einstellung.
+ *
+ * @param param Pointer auf die SerialBridge-Instanz (this).
+ */
+void SerialBridge::tcpTaskFunc(void *param) {
+	auto *self = static_cast<SerialBridge *>(param);
+	uint32_t wait = SerialTcpServer::IDLE_POLL_MS;
+	for (;;) {
+		if (self->_tcpDirty) {
+			portENTER_CRITICAL(&self->_clientsMux);
+			SerialTcpConfig cfg = self->_tcpConfig;
+			self->_tcpDirty = false;
+			portEXIT_CRITICAL(&self->_clientsMux);
+			self->_tcp.end();
+			if (cfg.enabled) {
+				if (self->_tcp.begin(cfg.rawPort, cfg.rfc2217Port)) {
+					logger.log({"system", "info", "device"}, self->logTag() + "TCP-Zugang offen (roh: " + String(cfg.rawPort) + ", RFC 2217: " + String(cfg.rfc2217Port) + ")");
+				} else {
+					logger.log({"system", "error", "device"}, self->logTag() + "TCP-Ports konnten nicht geöffnet werden");
+				}
+			}
+		}
+		if (self->_tcp.running()) {
+			wait = self->_tcp.poll(wait);
+		} else {
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		}
+	}
+}
+
+/**
+ * @brief Reiht Daten des schreibenden TCP-Clients in die Sendewarteschlange ein.
+ *
+ * @param data Zu sendende Bytes.
+ * @param len Anzahl der Bytes.
+ * @return `len` oder 0, wenn die Warteschlange voll ist oder durchgereicht wird (der Server
+ *         versucht es später erneut).
+ */
+size_t SerialBridge::TcpLink::write(const uint8_t *data, size_t len) {
+	if (_bridge._passthrough.state() != PASSTHROUGH_IDLE) return 0;
+	if (!_bridge._tx.submit(0, data, len)) return 0;
+	if (_bridge._txTask) xTaskNotifyGive(_bridge._txTask);
+	return len;
+}
+
+/**
+ * @brief Setzt die Baudrate auf Wunsch eines RFC-2217-Clients.
+ *
+ * @param baud Gewünschte Rate.
+ * @return Danach aktive Rate.
+ */
+uint32_t SerialBridge::TcpLink::setBaud(uint32_t baud) {
+	_bridge.setBaud(baud);
+	return _bridge._baudRate;
+}
+
+/**
+ * @brief Aktuelle Baudrate.
+ */
+uint32_t SerialBridge::TcpLink::baud() {
+	return _bridge._baudRate;
+}
+
+/**
+ * @brief Verwirft empfangene bzw. noch nicht gesendete Bytes (RFC 2217 PURGE-DATA).
+ *
+ * @param rx Empfangspuffer der UART leeren.
+ * @param tx Wartende Sendeaufträge verwerfen.
+ */
+void SerialBridge::TcpLink::purge(bool rx, bool tx) {
+	if (rx) _bridge._port.flushInput();
+	if (tx) _bridge._tx.clear();
+}
+
+/**
+ * @brief Reiht Sendetext eines Skripts oder eine Abfrage in die Sendewarteschlange ein.
+ *
+ * @param ctx Zeiger auf die SerialBridge-Instanz.
+ * @param data Zu sendende Bytes.
+ * @param len Anzahl der Bytes.
+ * @return false, wenn die Warteschlange voll ist (der Aufrufer versucht es erneut).
+ */
+bool SerialBridge::onQueueSend(void *ctx, const uint8_t *data, size_t len) {
+	auto *self = static_cast<SerialBridge *>(ctx);
+	if (!self->_tx.submit(0, data, len)) return false;
+	if (self->_txTask) xTaskNotifyGive(self->_txTask);
+	return true;
+}
+
+/**
+ * @brief Meldet das Ergebnis eines Skriptlaufs an den Auftraggeber und ins Log.
+ *
+ * @param ctx Zeiger auf die SerialBridge-Instanz.
+ * @param result Ergebnis.
+ */
+void SerialBridge::onScriptDone(void *ctx, const SerialScriptResult &result) {
+	static const char *const states[] = {"ok", "failed", "timeout", "error", "cancelled"};
+	auto *self = static_cast<SerialBridge *>(ctx);
+	String label = result.name[0] ? String(result.name) : String("#") + String(result.job);
+	logger.log({"system", result.status == SCRIPT_OK ? "info" : "warning", "device"},
+	           self->logTag() + "Skript " + label + ": " + states[result.status] + " nach " + String(result.elapsedMs) + " ms" +
+	               (result.message[0] ? String(" (") + result.message + ")" : String("")));
+	if (result.client == 0) return;
+
+	StaticJsonDocument<1024> doc;
+	doc["event"] = "serial";
+	doc["channel"] = self->_channel;
+	doc["action"] = "run";
+	doc["status"] = "done";
+	JsonObject det = doc.createNestedObject("details");
+	det["job"] = result.job;
+	det["script"] = result.name;
+	det["result"] = states[result.status];
+	det["line"] = result.line;
+	det["elapsedMs"] = result.elapsedMs;
+	det["steps"] = result.steps;
+	det["sent"] = result.sentBytes;
+	det["received"] = result.rxBytes;
+	JsonObject fields = det.createNestedObject("fields");
+	for (size_t i = 0; i < result.fieldCount; ++i) {
+		if (result.fields[i].set) {
+			fields[result.fields[i].name] = result.fields[i].value;
+		} else {
+			fields[result.fields[i].name] = nullptr;
+		}
+	}
+	if (result.status != SCRIPT_OK) {
+		det["tail"] = result.tail;
+		doc["error"] = result.message;
+	}
+	String msg;
+	serializeJson(doc, msg);
+	self->_out.enqueue(result.client, WS_PRIO_CONTROL, (const uint8_t *)msg.c_str(), msg.length(), false, millis());
+}
+
+/**
+ * @brief FreeRTOS-Task für Befehlsskripte.
+ *
+ * Schläft ohne Auftrag bis runScript(); während eines Laufs bis zum nächsten RX-Block oder
+ * bis zur von SerialScriptEngine::poll() empfohlenen Zeit (Timeout, Wartezeit).
+ *
+ * @param param Pointer auf die SerialBridge-Instanz (this).
+ */
+void SerialBridge::scriptTaskFunc(void *param) {
+	auto *self = static_cast<SerialBridge *>(param);
+	for (;;) {
+		uint32_t wait = self->_script.poll(millis());
+		if (wait == 0) continue;
+		ulTaskNotifyTake(pdTRUE, wait == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(wait));
+	}
+}
+
+/**
+ * @brief Meldet geänderte Felder an alle Clients, die sie abonniert haben.
+ *
+ * Clients mit derselben Schnittmenge aus Abonnement und Änderung teilen sich ein Dokument;
+ * üblicherweise wird es also nur einmal erzeugt.
+ *
+ * @param ctx Zeiger auf die SerialBridge-Instanz.
+ * @param changed Bitmaske der geänderten Felder.
+ */
+void SerialBridge::onPollUpdate(void *ctx, uint32_t changed) {
+	auto *self = static_cast<SerialBridge *>(ctx);
+	ClientSlot clients[MAX_CLIENTS];
+	portENTER_CRITICAL(&self->_clientsMux);
+	memcpy(clients, self->_clients, sizeof(clients));
+	portEXIT_CRITICAL(&self->_clientsMux);
+
+	uint32_t now = millis();
+	bool done[MAX_CLIENTS] = {};
+	for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+		uint32_t mask = clients[i].fields & changed;
+		if (!clients[i].used || done[i] || mask == 0) continue;
+
+		DynamicJsonDocument doc(768);
+		doc["event"] = "serial";
+		doc["channel"] = self->_channel;
+		doc["action"] = "field";
+		doc["status"] = "changed";
+		JsonObject det = doc.createNestedObject("details");
+		SerialPollField f;
+		for (size_t idx = 0; idx < SerialPoller::MAX_FIELDS; ++idx) {
+			if (!(mask & (1UL << idx)) || !self->_poller.field(idx, f)) continue;
+			JsonObject o = det.createNestedObject(f.name);
+			o["value"] = f.set ? (char *)f.value : nullptr;
+			o["stale"] = f.stale;
+		}
+		String msg;
+		serializeJson(doc, msg);
+		for (size_t j = i; j < MAX_CLIENTS; ++j) {
+			if (clients[j].used && (clients[j].fields & changed) == mask) {
+				self->_out.enqueue(clients[j].id, WS_PRIO_CONTROL, (const uint8_t *)msg.c_str(), msg.length(), false, now);
+				done[j] = true;
+			}
+		}
 	}
 }
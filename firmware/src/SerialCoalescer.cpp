@@ -0,0 +1,176 @@
+/**
+ * @file SerialCoalescer.cpp
+ * @brief Implementierung des adaptiven Bündelns serieller Zeilen.
+ *
+ * Regel: Eine Zeile geht sofort hinaus, wenn seit der letzten Nachricht mindestens das
+ * Latenzbudget vergangen ist (ruhiger Verkehr). Andernfalls wird gesammelt, bis das Budget
+ * seit der letzten Nachricht abgelaufen ist oder die maximale Nachrichtengröße erreicht wird.
+ * Damit entsteht unter Last höchstens eine Nachricht pro Budget-Fenster, und keine Zeile
+ * wartet länger als das Budget.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialCoalescer.h"
+
+#include <cstring>
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param sink Callback für fertige Nachrichten.
+ * @param ctx Benutzerkontext.
+ */
+SerialCoalescer::SerialCoalescer(FrameSink sink, void *ctx)
+    : _sink(sink),
+      _ctx(ctx),
+      _latencyMs(DEFAULT_LATENCY_MS),
+      _maxFrame(DEFAULT_FRAME_BYTES),
+      _len(0),
+      _lines(0),
+      _flags(0),
+      _firstUs(0),
+      _dueAt(0),
+      _lastEmit(0),
+      _emitted(false),
+      _stats{0, 0, 0, 0, 0, 0.0f, 0.0f},
+      _windowStart(0),
+      _windowFrames(0),
+      _windowLines(0) {
+}
+
+/**
+ * @brief Setzt Latenzbudget und maximale Nachrichtengröße.
+ *
+ * @param latencyMs Maximale Verzögerung einer Zeile (0 = nie bündeln), begrenzt auf MAX_LATENCY_MS.
+ * @param maxFrameBytes Maximale Nachrichtengröße, begrenzt auf MAX_FRAME.
+ */
+void SerialCoalescer::configure(uint32_t latencyMs, size_t maxFrameBytes) {
+	_latencyMs = latencyMs > MAX_LATENCY_MS ? MAX_LATENCY_MS : latencyMs;
+	_maxFrame = maxFrameBytes;
+	if (_maxFrame == 0 || _maxFrame > MAX_FRAME) _maxFrame = MAX_FRAME;
+}
+
+/**
+ * @brief Nimmt eine Zeile entgegen und gibt sie sofort oder später aus.
+ *
+ * @param line Zeile.
+ * @param len Länge der Zeile.
+ * @param flags SerialFrameFlags der Zeile.
+ * @param now Aktuelle Zeit in ms.
+ * @param rxUs Empfangszeitpunkt der Zeile in µs.
+ */
+void SerialCoalescer::add(const uint8_t *line, size_t len, uint16_t flags, uint32_t now, uint64_t rxUs) {
+	_stats.lines++;
+	_windowLines++;
+	updateRates(now);
+
+	bool quiet = !_emitted || now - _lastEmit >= _latencyMs;
+	if (_len == 0 && quiet) {
+		_stats.immediate++;
+		emit(line, len, 1, flags, now, rxUs);
+		return;
+	}
+
+	// Passt nicht mehr in die laufende Nachricht: zuerst das Gesammelte ausgeben
+	if (_len + len > _maxFrame) flush(now);
+	if (len >= _maxFrame) {
+		emit(line, len, 1, flags, now, rxUs);
+		return;
+	}
+
+	if (_len == 0) {
+		_dueAt = _lastEmit + _latencyMs;
+		_firstUs = rxUs;
+	}
+	memcpy(_buf + _len, line, len);
+	_len += len;
+	_lines++;
+	_flags = flags;
+	if (_len == _maxFrame) flush(now);
+}
+
+/**
+ * @brief Gibt gesammelte Zeilen aus, wenn das Latenzbudget abgelaufen ist.
+ *
+ * @param now Aktuelle Zeit in ms.
+ * @return true, wenn eine Nachricht ausgegeben wurde.
+ */
+bool SerialCoalescer::poll(uint32_t now) {
+	updateRates(now);
+	if (_len == 0 || (int32_t)(_dueAt - now) > 0) return false;
+	flush(now);
+	return true;
+}
+
+/**
+ * @brief Gibt gesammelte Zeilen sofort aus.
+ *
+ * @param now Aktuelle Zeit in ms.
+ */
+void SerialCoalescer::flush(uint32_t now) {
+	if (_len == 0) return;
+	emit(_buf, _len, _lines, _flags, now, _firstUs);
+	_len = 0;
+	_lines = 0;
+}
+
+/**
+ * @brief Millisekunden bis zur nächsten fälligen Ausgabe.
+ *
+ * @param now Aktuelle Zeit in ms.
+ * @return Wartezeit oder UINT32_MAX, wenn nichts gesammelt ist.
+ */
+uint32_t SerialCoalescer::msUntilDue(uint32_t now) const {
+	if (_len == 0) return UINT32_MAX;
+	int32_t left = (int32_t)(_dueAt - now);
+	return left > 0 ? (uint32_t)left : 0;
+}
+
+/**
+ * @brief Gibt die Zähler zurück.
+ */
+const SerialCoalescerStats &SerialCoalescer::stats() const {
+	return _stats;
+}
+
+/**
+ * @brief Gibt das aktuelle Latenzbudget in ms zurück.
+ */
+uint32_t SerialCoalescer::latencyMs() const {
+	return _latencyMs;
+}
+
+/**
+ * @brief Gibt die aktuelle maximale Nachrichtengröße zurück.
+ */
+size_t SerialCoalescer::maxFrameBytes() const {
+	return _maxFrame;
+}
+
+/**
+ * @brief Reicht eine Nachricht an den Callback weiter und führt die Zähler nach.
+ */
+void SerialCoalescer::emit(const uint8_t *data, size_t len, uint16_t lines, uint16_t flags, uint32_t now, uint64_t rxUs) {
+	_sink(_ctx, data, len, lines, flags, rxUs);
+	_stats.frames++;
+	_stats.bytes += len;
+	if (lines > _stats.maxLinesPerFrame) _stats.maxLinesPerFrame = lines;
+	_windowFrames++;
+	_lastEmit = now;
+	_emitted = true;
+}
+
+/**
+ * @brief Schließt nach RATE_WINDOW_MS das Messfenster ab und berechnet die Raten.
+ */
+void SerialCoalescer::updateRates(uint32_t now) {
+	uint32_t elapsed = now - _windowStart;
+	if (elapsed < RATE_WINDOW_MS) return;
+	_stats.framesPerSec = _windowFrames * 1000.0f / elapsed;
+	_stats.linesPerFrame = _windowFrames ? (float)_windowLines / _windowFrames : 0.0f;
+	_windowStart = now;
+	_windowFrames = 0;
+	_windowLines = 0;
+}
@@ -0,0 +1,319 @@
+/**
+ * @file SerialFileStream.cpp
+ * @brief Ringpuffer, Zeilentakt und Prompt-Erkennung einer Dateiübertragung.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialFileStream.h"
+
+#include <cstring>
+
+/**
+ * @brief Konstruktor: ohne begin() nimmt offer() nichts an.
+ */
+SerialFileStream::SerialFileStream(SendFn send, void *ctx)
+    : _send(send), _ctx(ctx), _state(FILE_STREAM_IDLE), _inputDone(false), _cancel(false), _armed(false), _promptSeen(false), _matchPos(0), _promptLen(0),
+      _startMs(0), _piece(nullptr), _pieceLen(0), _pieceEol(false), _lineSent(false), _pacing(false), _waitFrom(0), _last(0) {
+	memset(&_config, 0, sizeof(_config));
+	memset(_fail, 0, sizeof(_fail));
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+/**
+ * @brief Prüft die Parameter.
+ *
+ * @return false bei zu langer Pause, zu langem Prompt oder ungültigem Timeout.
+ */
+bool SerialFileStream::validate(const SerialFileStreamConfig &config) {
+	if (config.lineDelayMs > MAX_LINE_DELAY_MS) return false;
+	size_t len = strnlen(config.prompt, SerialFileStreamConfig::MAX_PROMPT);
+	if (len >= SerialFileStreamConfig::MAX_PROMPT) return false;
+	return len == 0 || (config.promptTimeoutMs > 0 && config.promptTimeoutMs <= MAX_PROMPT_TIMEOUT_MS);
+}
+
+/**
+ * @brief Beginnt eine Übertragung und übersetzt den Prompt in die KMP-Tabelle.
+ *
+ * @param config Parameter.
+ * @param mem Speicher mit MEMORY_BYTES.
+ * @param nowMs Aktuelle Zeit in ms.
+ * @return false bei ungültigen Parametern oder laufender Übertragung.
+ */
+bool SerialFileStream::begin(const SerialFileStreamConfig &config, uint8_t *mem, uint32_t nowMs) {
+	if (!validate(config) || !mem) return false;
+	bool ok = false;
+	_lock.enter();
+	if (_state == FILE_STREAM_IDLE) {
+		_config = config;
+		_promptLen = strlen(_config.prompt);
+		size_t k = 0;
+		if (_promptLen > 0) _fail[0] = 0;
+		for (size_t i = 1; i < _promptLen; ++i) {
+			while (k > 0 && _config.prompt[i] != _config.prompt[k]) k = _fail[k - 1];
+			if (_config.prompt[i] == _config.prompt[k]) k++;
+			_fail[i] = (uint8_t)k;
+		}
+		_ring.reset(mem, BUFFER_BYTES);
+		_piece = mem + BUFFER_BYTES;
+		_pieceLen = 0;
+		_pieceEol = false;
+		_lineSent = false;
+		_pacing = false;
+		_last = 0;
+		_inputDone = false;
+		_cancel = false;
+		_armed = false;
+		_promptSeen = false;
+		_matchPos = 0;
+		_startMs = nowMs;
+		memset(&_stats, 0, sizeof(_stats));
+		_state = FILE_STREAM_RUNNING;
+		ok = true;
+	}
+	_lock.exit();
+	return ok;
+}
+
+/**
+ * @brief Übernimmt so viele Bytes, wie in den Ringpuffer passen.
+ *
+ * @return Anzahl der übernommenen Bytes.
+ */
+size_t SerialFileStream::offer(const uint8_t *data, size_t len) {
+	_lock.enter();
+	size_t n = 0;
+	if (_state == FILE_STREAM_RUNNING && !_inputDone && !_cancel) {
+		n = len < _ring.space() ? len : _ring.space();
+		_ring.push(data, n);
+		_stats.received += (uint32_t)n;
+		if (_ring.size() > _stats.maxBuffered) _stats.maxBuffered = _ring.size();
+	}
+	_lock.exit();
+	return n;
+}
+
+/**
+ * @brief Meldet das Ende der Datei.
+ */
+void SerialFileStream::endInput() {
+	_lock.enter();
+	_inputDone = true;
+	_lock.exit();
+}
+
+/**
+ * @brief Fordert den Abbruch an; poll() beendet mit FILE_STREAM_CANCELLED.
+ */
+void SerialFileStream::cancel() {
+	_lock.enter();
+	if (_state == FILE_STREAM_RUNNING) _cancel = true;
+	_lock.exit();
+}
+
+/**
+ * @brief Sucht den Prompt in den empfangenen Bytes, solange er erwartet wird.
+ *
+ * @return true beim Treffer.
+ */
+bool SerialFileStream::onRx(const uint8_t *data, size_t len) {
+	bool hit = false;
+	_lock.enter();
+	if (_state == FILE_STREAM_RUNNING && _armed && !_promptSeen) {
+		const uint8_t *p = reinterpret_cast<const uint8_t *>(_config.prompt);
+		for (size_t i = 0; i < len && !hit; ++i) {
+			while (_matchPos > 0 && p[_matchPos] != data[i]) _matchPos = _fail[_matchPos - 1];
+			if (p[_matchPos] == data[i]) _matchPos++;
+			if (_matchPos == _promptLen) {
+				_promptSeen = true;
+				_matchPos = 0;
+				hit = true;
+			}
+		}
+	}
+	_lock.exit();
+	return hit;
+}
+
+/**
+ * @brief Entnimmt den nächsten Block bis einschließlich Zeilenende (höchstens PIECE_BYTES).
+ *
+ * Mit `crlf` wird vor einem '\n' ohne vorangehendes '\r' eines eingefügt. Endet der Block mit
+ * einem Zeilenende und ist ein Prompt gesetzt, wird die Erkennung schon jetzt scharf
+ * geschaltet, damit eine schnelle Antwort nicht verloren geht.
+ *
+ * @return Länge des Blocks (0 = Puffer leer).
+ */
+size_t SerialFileStream::takePiece() {
+	_lock.enter();
+	size_t n = _ring.peek(_piece, PIECE_BYTES);
+	size_t take = n;
+	_pieceEol = false;
+	for (size_t i = 0; i < n; ++i) {
+		if (_piece[i] == '\n') {
+			take = i + 1;
+			_pieceEol = true;
+			break;
+		}
+	}
+	_ring.drop(take);
+	if (_pieceEol && _promptLen > 0) {
+		_armed = true;
+		_promptSeen = false;
+		_matchPos = 0;
+	}
+	_lock.exit();
+
+	size_t len = take;
+	if (take > 0) {
+		uint8_t before = take > 1 ? _piece[take - 2] : _last;
+		if (_pieceEol && _config.crlf && before != '\r') {
+			_piece[take - 1] = '\r';
+			_piece[take] = '\n';
+			len++;
+		}
+		_last = _pieceEol ? '\n' : _piece[take - 1];
+	}
+	return len;
+}
+
+/**
+ * @brief Ein Durchlauf der TX-Task.
+ *
+ * Nach einer Zeile laufen Zeilenpause und Prompt-Wartezeit ab dem nächsten Aufruf, also erst,
+ * wenn die TX-Task die Zeile tatsächlich gesendet hat. Erst wenn beide erfüllt sind, folgt der
+ * nächste Block. Nach dem letzten Byte (und ggf. dem letzten Prompt) endet die Übertragung.
+ *
+ * @param nowMs Aktuelle Zeit in ms.
+ * @return 0 nach einer Übergabe, sonst die empfohlene Wartezeit in ms.
+ */
+uint32_t SerialFileStream::poll(uint32_t nowMs) {
+	if (_state != FILE_STREAM_RUNNING) return UINT32_MAX;
+	_lock.enter();
+	bool cancel = _cancel;
+	_lock.exit();
+	if (cancel) {
+		fail(FILE_STREAM_CANCELLED, nowMs);
+		return UINT32_MAX;
+	}
+
+	if (_lineSent) {
+		_lineSent = false;
+		_pacing = true;
+		_waitFrom = nowMs;
+	}
+	if (_pacing) {
+		// Pause und Prompt-Wartezeit laufen gleichzeitig
+		uint32_t since = nowMs - _waitFrom;
+		uint32_t wait = since < _config.lineDelayMs ? _config.lineDelayMs - since : 0;
+		if (_promptLen > 0) {
+			_lock.enter();
+			bool seen = _promptSeen;
+			_lock.exit();
+			if (!seen) {
+				if (since >= _config.promptTimeoutMs) {
+					fail(FILE_STREAM_PROMPT_TIMEOUT, nowMs);
+					return UINT32_MAX;
+				}
+				uint32_t left = _config.promptTimeoutMs - since;
+				return wait > 0 && wait < left ? wait : left;
+			}
+		}
+		if (wait > 0) return wait;
+		_pacing = false;
+		_lock.enter();
+		if (_armed) _stats.prompts++;
+		_armed = false;
+		_lock.exit();
+	}
+
+	if (_pieceLen == 0) {
+		_pieceLen = takePiece();
+		if (_pieceLen == 0) {
+			_lock.enter();
+			bool done = _inputDone && _ring.size() == 0;
+			if (done) {
+				_stats.elapsedMs = nowMs - _startMs;
+				_state = FILE_STREAM_DONE;
+			}
+			_lock.exit();
+			return UINT32_MAX;
+		}
+	}
+	if (!_send(_ctx, _piece, _pieceLen)) return SEND_RETRY_MS;
+	_lock.enter();
+	_stats.sent += (uint32_t)_pieceLen;
+	if (_pieceEol) _stats.lines++;
+	_lock.exit();
+	_pieceLen = 0;
+	_lineSent = _pieceEol;
+	return 0;
+}
+
+/**
+ * @brief Beendet die Übertragung mit einem Fehler; Ungesendetes wird verworfen.
+ */
+void SerialFileStream::fail(uint8_t error, uint32_t nowMs) {
+	_lock.enter();
+	_ring.clear();
+	_armed = false;
+	_stats.error = error;
+	_stats.elapsedMs = nowMs - _startMs;
+	_state = FILE_STREAM_FAILED;
+	_lock.exit();
+	_pieceLen = 0;
+}
+
+/**
+ * @brief Schließt eine beendete Übertragung ab.
+ *
+ * @param nowMs Aktuelle Zeit in ms (Laufzeit, falls noch nicht beendet).
+ * @return Endstand der Zähler.
+ */
+SerialFileStreamStats SerialFileStream::close(uint32_t nowMs) {
+	_lock.enter();
+	if (_state == FILE_STREAM_RUNNING) _stats.elapsedMs = nowMs - _startMs;
+	SerialFileStreamStats result = _stats;
+	_ring.reset(nullptr, 0);
+	_piece = nullptr;
+	_pieceLen = 0;
+	_state = FILE_STREAM_IDLE;
+	_lock.exit();
+	return result;
+}
+
+/**
+ * @brief Aktueller Zustand.
+ */
+SerialFileStreamState SerialFileStream::state() const {
+	return (SerialFileStreamState)_state;
+}
+
+/**
+ * @brief Parameter der laufenden Übertragung.
+ */
+const SerialFileStreamConfig &SerialFileStream::config() const {
+	return _config;
+}
+
+/**
+ * @brief Kopie der Zähler.
+ */
+SerialFileStreamStats SerialFileStream::stats() const {
+	_lock.enter();
+	SerialFileStreamStats st = _stats;
+	_lock.exit();
+	return st;
+}
+
+/**
+ * @brief Beschreibung eines Fehlers.
+ *
+ * @param error SerialFileStreamError.
+ * @return Text ("" bei FILE_STREAM_OK).
+ */
+const char *SerialFileStream::errorText(uint8_t error) {
+	static const char *const texts[] = {"", "Prompt nicht erhalten", "Abgebrochen"};
+	return error < sizeof(texts) / sizeof(texts[0]) ? texts[error] : "Unbekannter Fehler";
+}
@@ -0,0 +1,79 @@
+/**
+ * @file SerialFrame.cpp
+ * @brief Kodierung und Dekodierung des binären Frame-Headers für serielle Daten.
+ *
+ * Alle Mehrbytefelder werden explizit als Little Endian geschrieben, damit das Format
+ * unabhängig vom Compiler-Layout der Struktur ist.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialFrame.h"
+
+namespace {
+
+inline void putLe16(uint8_t *p, uint16_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+}
+
+inline void putLe32(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+inline void putLe64(uint8_t *p, uint64_t v) {
+	putLe32(p, (uint32_t)v);
+	putLe32(p + 4, (uint32_t)(v >> 32));
+}
+
+inline uint16_t getLe16(const uint8_t *p) {
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t getLe32(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint64_t getLe64(const uint8_t *p) {
+	return (uint64_t)getLe32(p) | ((uint64_t)getLe32(p + 4) << 32);
+}
+
+}  // namespace
+
+/**
+ * @brief Schreibt den Header in `out`.
+ *
+ * @param hdr Header-Felder.
+ * @param out Zielpuffer (mindestens SERIAL_FRAME_HEADER_LEN Bytes).
+ * @return SERIAL_FRAME_HEADER_LEN.
+ */
+size_t encodeSerialFrameHeader(const SerialFrameHeader &hdr, uint8_t *out) {
+	out[0] = hdr.version;
+	out[1] = hdr.channel;
+	putLe16(out + 2, hdr.flags);
+	putLe32(out + 4, hdr.seq);
+	putLe64(out + 8, hdr.timestamp);
+	return SERIAL_FRAME_HEADER_LEN;
+}
+
+/**
+ * @brief Liest einen Header aus `in`.
+ *
+ * @param in Empfangenes Frame.
+ * @param len Länge des Frames.
+ * @param hdr Ausgabeparameter.
+ * @return false bei zu kurzem Frame oder unbekannter Version.
+ */
+bool decodeSerialFrameHeader(const uint8_t *in, size_t len, SerialFrameHeader &hdr) {
+	if (len < SERIAL_FRAME_HEADER_LEN || in[0] != SERIAL_FRAME_VERSION) return false;
+	hdr.version = in[0];
+	hdr.channel = in[1];
+	hdr.flags = getLe16(in + 2);
+	hdr.seq = getLe32(in + 4);
+	hdr.timestamp = getLe64(in + 8);
+	return true;
+}
@@ -0,0 +1,545 @@
+/**
+ * @file SerialFramer.cpp
+ * @brief Implementierung des konfigurierbaren Framers der SerialBridge.
+ *
+ * Die Suche nach Trennzeichen arbeitet wortweise: Ein Maschinenwort wird mit jedem gesuchten
+ * Byte per XOR verglichen, und die klassische "has zero byte"-Formel markiert Treffer. Das
+ * niedrigste markierte Byte ist immer ein echter Treffer (Little Endian).
+ *
+ * Jeder `feed*()`-Schritt verarbeitet ab `p` so viel wie möglich und gibt die neue Position
+ * zurück. Vollständig im Eingabeblock liegende Datensätze werden direkt von dort ausgegeben;
+ * nur angefangene Datensätze landen in `_carry`.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialFramer.h"
+
+#include <cstring>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "SerialFramer::findAny setzt Little Endian voraus"
+#endif
+
+namespace {
+
+typedef size_t word_t;
+
+constexpr word_t ONES = ~(word_t)0 / 0xFF;  ///< 0x0101...01
+constexpr word_t HIGHS = ONES * 0x80;       ///< 0x8080...80
+
+/// Markiert (Bit 7) jedes Null-Byte in x; das niedrigste markierte Byte ist exakt.
+inline word_t zeroBytes(word_t x) {
+	return (x - ONES) & ~x & HIGHS;
+}
+
+/// Index des niedrigsten markierten Bytes.
+inline unsigned firstMarked(word_t m) {
+	return (sizeof(word_t) == 8 ? (unsigned)__builtin_ctzll((unsigned long long)m) : (unsigned)__builtin_ctz((unsigned)m)) / 8;
+}
+
+/// SWAR-Suche nach N Bytes; N ist zur Übersetzungszeit bekannt, damit die Schleife entrollt wird.
+template <size_t N>
+const uint8_t *scan(const uint8_t *p, const uint8_t *end, const uint8_t *set) {
+	word_t pat[N];
+	for (size_t i = 0; i < N; ++i) pat[i] = ONES * set[i];
+	while ((size_t)(end - p) >= sizeof(word_t)) {
+		word_t w;
+		memcpy(&w, p, sizeof(w));  // unausgerichteter Zugriff, wird zu einem Load
+		word_t m = 0;
+		for (size_t i = 0; i < N; ++i) m |= zeroBytes(w ^ pat[i]);
+		if (m) return p + firstMarked(m);
+		p += sizeof(word_t);
+	}
+	for (; p < end; ++p) {
+		for (size_t i = 0; i < N; ++i) {
+			if (*p == set[i]) return p;
+		}
+	}
+	return end;
+}
+
+inline size_t minSize(size_t a, size_t b) {
+	return a < b ? a : b;
+}
+
+const uint8_t LINE_ENDS[] = {'\r', '\n'};
+
+}  // namespace
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param sink Callback für fertige Datensätze.
+ * @param ctx Benutzerkontext für den Callback.
+ */
+SerialFramer::SerialFramer(LineSink sink, void *ctx) : _sink(sink), _ctx(ctx), _cfg(defaultConfig()), _stats{0, 0, 0, 0}, _feedUs(0), _carryUs(0) {
+	reset();
+}
+
+/**
+ * @brief Standardkonfiguration: Zeilen an `\r`/`\n`, CR+LF als ein Zeilenende.
+ */
+SerialFramerConfig SerialFramer::defaultConfig() {
+	SerialFramerConfig c;
+	memset(&c, 0, sizeof(c));
+	c.mode = SERIAL_FRAMING_LINE;
+	c.delimiters[0] = '\r';
+	c.delimiters[1] = '\n';
+	c.delimiterCount = 2;
+	c.joinCrLf = true;
+	c.terminator[0] = '\r';
+	c.terminator[1] = '\n';
+	c.terminatorLen = 2;
+	c.fixedLen = 16;
+	c.lengthBytes = 1;
+	c.stx = 0x02;
+	c.etx = 0x03;
+	c.timeoutMs = DEFAULT_TIMEOUT_MS;
+	c.maxRecord = DEFAULT_MAX_RECORD;
+	return c;
+}
+
+/**
+ * @brief Liefert ein benanntes Geräteprofil.
+ *
+ * | Profil     | Verfahren                                                    |
+ * | ---------- | ------------------------------------------------------------ |
+ * | `text`     | Zeilen an CR/LF, CR+LF als ein Ende (Standard)                |
+ * | `text-raw` | Zeilen an CR/LF, CR+LF ergibt zwei Datensätze (bisheriges Verhalten) |
+ * | `crlf`     | Nur die Folge CR+LF beendet einen Datensatz, bis 1024 Bytes  |
+ * | `stx-etx`  | Telegramme von STX (0x02) bis ETX (0x03), bis 1024 Bytes     |
+ * | `length8`  | 1-Byte-Längenpräfix (nur Nutzdaten)                          |
+ * | `length16` | 2-Byte-Längenpräfix, Big Endian (nur Nutzdaten)              |
+ * | `idle`     | Ende nach 5 ms Sendepause (z. B. Modbus RTU)                 |
+ *
+ * @param name Profilname.
+ * @param out Ausgabeparameter.
+ * @return false bei unbekanntem Namen.
+ */
+bool SerialFramer::profile(const char *name, SerialFramerConfig &out) {
+	SerialFramerConfig c = defaultConfig();
+	if (strcmp(name, "text") == 0) {
+		// Standard
+	} else if (strcmp(name, "text-raw") == 0) {
+		c.joinCrLf = false;
+	} else if (strcmp(name, "crlf") == 0) {
+		c.mode = SERIAL_FRAMING_TERMINATOR;
+		c.maxRecord = MAX_RECORD;
+	} else if (strcmp(name, "stx-etx") == 0) {
+		c.mode = SERIAL_FRAMING_STX_ETX;
+		c.maxRecord = MAX_RECORD;
+		c.timeoutMs = 100;
+	} else if (strcmp(name, "length8") == 0 || strcmp(name, "length16") == 0) {
+		c.mode = SERIAL_FRAMING_LENGTH;
+		c.lengthBytes = name[6] == '1' ? 2 : 1;
+		c.lengthBigEndian = true;
+		c.maxRecord = MAX_RECORD;
+		c.timeoutMs = 50;
+	} else if (strcmp(name, "idle") == 0) {
+		c.mode = SERIAL_FRAMING_IDLE;
+		c.maxRecord = 256;
+		c.timeoutMs = 5;
+	} else {
+		return false;
+	}
+	out = c;
+	return true;
+}
+
+/**
+ * @brief Prüft eine Konfiguration auf Plausibilität.
+ *
+ * @param config Zu prüfende Konfiguration.
+ * @return true, wenn das gewählte Verfahren mit diesen Werten arbeiten kann.
+ */
+bool SerialFramer::validate(const SerialFramerConfig &config) {
+	if (config.maxRecord == 0 || config.maxRecord > MAX_RECORD) return false;
+	switch (config.mode) {
+		case SERIAL_FRAMING_LINE:
+			return config.delimiterCount >= 1 && config.delimiterCount <= sizeof(config.delimiters);
+		case SERIAL_FRAMING_TERMINATOR:
+			return config.terminatorLen >= 1 && config.terminatorLen <= sizeof(config.terminator) && config.terminatorLen <= config.maxRecord;
+		case SERIAL_FRAMING_FIXED:
+			return config.fixedLen >= 1 && config.fixedLen <= config.maxRecord;
+		case SERIAL_FRAMING_LENGTH:
+			return (config.lengthBytes == 1 || config.lengthBytes == 2) && config.lengthBytes <= config.maxRecord;
+		case SERIAL_FRAMING_STX_ETX:
+			return config.stx != config.etx && config.maxRecord >= 2;
+		case SERIAL_FRAMING_IDLE:
+			return config.timeoutMs > 0;
+	}
+	return false;
+}
+
+/**
+ * @brief Übernimmt eine neue Konfiguration.
+ *
+ * @param config Neue Konfiguration.
+ * @return false bei ungültiger Konfiguration.
+ */
+bool SerialFramer::configure(const SerialFramerConfig &config) {
+	if (!validate(config)) return false;
+	flush();
+	_cfg = config;
+	reset();
+	return true;
+}
+
+/**
+ * @brief Gibt die aktive Konfiguration zurück.
+ */
+const SerialFramerConfig &SerialFramer::config() const {
+	return _cfg;
+}
+
+/**
+ * @brief true bei textbasierten Verfahren (LINE, TERMINATOR).
+ */
+bool SerialFramer::isText() const {
+	return _cfg.mode == SERIAL_FRAMING_LINE || _cfg.mode == SERIAL_FRAMING_TERMINATOR;
+}
+
+/**
+ * @brief Sucht das erste `\r` oder `\n` im Bereich [begin, end).
+ */
+const uint8_t *SerialFramer::findLineEnd(const uint8_t *begin, const uint8_t *end) {
+	return scan<2>(begin, end, LINE_ENDS);
+}
+
+/**
+ * @brief Sucht das erste Byte aus `set` im Bereich [begin, end).
+ */
+const uint8_t *SerialFramer::findAny(const uint8_t *begin, const uint8_t *end, const uint8_t *set, size_t count) {
+	switch (count) {
+		case 1:
+			return scan<1>(begin, end, set);
+		case 2:
+			return scan<2>(begin, end, set);
+		case 3:
+			return scan<3>(begin, end, set);
+		case 4:
+			return scan<4>(begin, end, set);
+		default:
+			return end;
+	}
+}
+
+/**
+ * @brief Übergibt einen Block empfangener Bytes und gibt alle fertigen Datensätze aus.
+ *
+ * @param data Empfangene Bytes.
+ * @param len Anzahl der Bytes.
+ * @param rxUs Empfangszeitpunkt des Blocks in µs.
+ */
+void SerialFramer::feed(const uint8_t *data, size_t len, uint64_t rxUs) {
+	_feedUs = rxUs;
+	const uint8_t *p = data;
+	const uint8_t *end = data + len;
+	while (p < end) {
+		switch (_cfg.mode) {
+			case SERIAL_FRAMING_LINE:
+				p = feedLine(p, end);
+				break;
+			case SERIAL_FRAMING_TERMINATOR:
+				p = feedTerminator(p, end);
+				break;
+			case SERIAL_FRAMING_FIXED:
+			case SERIAL_FRAMING_LENGTH:
+				p = feedCounted(p, end);
+				break;
+			case SERIAL_FRAMING_STX_ETX:
+				p = feedStxEtx(p, end);
+				break;
+			case SERIAL_FRAMING_IDLE:
+				p = feedIdle(p, end);
+				break;
+		}
+	}
+}
+
+/**
+ * @brief Gibt einen angefangenen Datensatz aus.
+ *
+ * Wird von der SerialBridge nach `timeoutMs` ohne neue Bytes aufgerufen.
+ *
+ * @return true, wenn ein Datensatz ausgegeben wurde.
+ */
+bool SerialFramer::flush() {
+	bool had = _carryLen > 0;
+	if (had) {
+		// Nach CR nur noch auf das LF gewartet bzw. Pause im IDLE-Modus: regulär abgeschlossen
+		bool complete = _pendingCr || _cfg.mode == SERIAL_FRAMING_IDLE;
+		if (!complete) _stats.partial++;
+		emitCarry(complete);
+	}
+	reset();
+	return had;
+}
+
+/**
+ * @brief Anzahl der Bytes eines angefangenen Datensatzes.
+ */
+size_t SerialFramer::pending() const {
+	return _carryLen;
+}
+
+/**
+ * @brief Gibt die Zähler zurück.
+ */
+const SerialFramerStats &SerialFramer::stats() const {
+	return _stats;
+}
+
+void SerialFramer::emit(const uint8_t *record, size_t len, bool complete) {
+	_stats.records++;
+	_sink(_ctx, record, len, complete, record == _carry ? _carryUs : _feedUs);
+}
+
+void SerialFramer::append(const uint8_t *data, size_t len) {
+	if (_carryLen == 0) _carryUs = _feedUs;
+	memcpy(_carry + _carryLen, data, len);
+	_carryLen += len;
+}
+
+void SerialFramer::emitCarry(bool complete) {
+	if (_carryLen > 0) emit(_carry, _carryLen, complete);
+	_carryLen = 0;
+	_pendingCr = false;
+}
+
+/**
+ * @brief Schließt einen Datensatz ab, der mit den ersten `n` Bytes ab `p` endet.
+ */
+void SerialFramer::finish(const uint8_t *p, size_t n) {
+	if (_carryLen == 0) {
+		emit(p, n, true);  // direkt aus dem Eingabeblock
+	} else {
+		append(p, n);
+		emitCarry(true);
+	}
+}
+
+void SerialFramer::reset() {
+	_carryLen = 0;
+	_need = 0;
+	_inFrame = false;
+	_pendingCr = false;
+}
+
+/**
+ * @brief LINE: Ende an einem Trennzeichen; CR+LF optional als ein Zeilenende.
+ */
+const uint8_t *SerialFramer::feedLine(const uint8_t *p, const uint8_t *end) {
+	if (_pendingCr) {
+		// Der letzte Block endete mit CR: ein direkt folgendes LF gehört noch dazu
+		if (*p == '\n' && _carryLen < _cfg.maxRecord) {
+			append(p, 1);
+			emitCarry(true);
+			return p + 1;
+		}
+		emitCarry(true);
+		return p;
+	}
+
+	// Höchstens so weit suchen, wie der Datensatz noch wachsen darf
+	size_t room = _cfg.maxRecord - _carryLen;
+	const uint8_t *limit = (size_t)(end - p) > room ? p + room : end;
+	const uint8_t *eol = findAny(p, limit, _cfg.delimiters, _cfg.delimiterCount);
+
+	if (eol == limit) {
+		if (limit == end) {
+			// Kein Zeilenende mehr im Block: Rest für den nächsten Aufruf merken
+			append(p, (size_t)(end - p));
+			if (_carryLen == _cfg.maxRecord) {
+				_stats.split++;
+				emitCarry(true);
+			}
+			return end;
+		}
+		_stats.split++;
+		finish(p, (size_t)(limit - p));
+		return limit;
+	}
+
+	const uint8_t *lineEnd = eol + 1;
+	if (_cfg.joinCrLf && *eol == '\r') {
+		if (lineEnd == end) {
+			append(p, (size_t)(lineEnd - p));
+			_pendingCr = true;
+			return end;
+		}
+		if (*lineEnd == '\n' && _carryLen + (size_t)(lineEnd - p) < _cfg.maxRecord) lineEnd++;
+	}
+	finish(p, (size_t)(lineEnd - p));
+	return lineEnd;
+}
+
+/**
+ * @brief TERMINATOR: Ende an einer mehrbytigen Endekennung, auch über Blockgrenzen hinweg.
+ */
+const uint8_t *SerialFramer::feedTerminator(const uint8_t *p, const uint8_t *end) {
+	const uint8_t *t = _cfg.terminator;
+	size_t tl = _cfg.terminatorLen;
+	size_t avail = (size_t)(end - p);
+
+	// 1) Endekennung, die am Ende von _carry beginnt und in diesem Block weitergeht
+	for (size_t k = minSize(tl - 1, _carryLen); k >= 1; --k) {
+		if (memcmp(_carry + _carryLen - k, t, k) != 0) continue;
+		size_t rest = tl - k;
+		if (avail >= rest) {
+			if (memcmp(p, t + k, rest) == 0 && _carryLen + rest <= _cfg.maxRecord) {
+				append(p, rest);
+				emitCarry(true);
+				return p + rest;
+			}
+		} else if (memcmp(p, t + k, avail) == 0 && _carryLen + avail <= _cfg.maxRecord) {
+			append(p, avail);  // Endekennung noch unvollständig
+			return end;
+		}
+	}
+
+	// 2) Endekennung innerhalb des Blocks
+	size_t room = _cfg.maxRecord - _carryLen;
+	const uint8_t *limit = avail > room ? p + room : end;
+	for (const uint8_t *s = p;;) {
+		const uint8_t *c = findAny(s, limit, t, 1);
+		if (c == limit) break;
+		size_t left = (size_t)(end - c);
+		if (left >= tl) {
+			if (memcmp(c, t, tl) == 0) {
+				const uint8_t *recordEnd = c + tl;
+				if (_carryLen + (size_t)(recordEnd - p) > _cfg.maxRecord) break;
+				finish(p, (size_t)(recordEnd - p));
+				return recordEnd;
+			}
+		} else if (memcmp(c, t, left) == 0) {
+			break;  // Anfang der Endekennung am Blockende
+		}
+		s = c + 1;
+	}
+
+	if (limit < end) {
+		_stats.split++;
+		finish(p, (size_t)(limit - p));
+		return limit;
+	}
+	append(p, avail);
+	if (_carryLen == _cfg.maxRecord) {
+		_stats.split++;
+		emitCarry(true);
+	}
+	return end;
+}
+
+/**
+ * @brief Gesamtlänge eines Datensatzes aus seinem Längenpräfix.
+ */
+size_t SerialFramer::recordLength(const uint8_t *header) const {
+	size_t value = header[0];
+	if (_cfg.lengthBytes == 2) value = _cfg.lengthBigEndian ? (size_t)(header[0] << 8 | header[1]) : (size_t)(header[1] << 8 | header[0]);
+	return _cfg.lengthIncludesHeader ? value : value + _cfg.lengthBytes;
+}
+
+/**
+ * @brief FIXED und LENGTH: Datensätze bekannter Länge.
+ */
+const uint8_t *SerialFramer::feedCounted(const uint8_t *p, const uint8_t *end) {
+	if (_need == 0) {
+		if (_cfg.mode == SERIAL_FRAMING_FIXED) {
+			_need = _cfg.fixedLen;
+		} else {
+			// Präfix kann über Blockgrenzen verteilt sein
+			size_t hb = _cfg.lengthBytes;
+			size_t have = _carryLen;
+			if (have + (size_t)(end - p) < hb) {
+				append(p, (size_t)(end - p));
+				return end;
+			}
+			uint8_t header[2];
+			memcpy(header, _carry, have);
+			memcpy(header + have, p, hb - have);
+			size_t total = recordLength(header);
+			if (total < hb || total > _cfg.maxRecord) {
+				// Ungültige Länge: ein Byte verwerfen und ab dem nächsten neu synchronisieren
+				_stats.discarded++;
+				if (have == 0) return p + 1;
+				memmove(_carry, _carry + 1, --_carryLen);
+				return p;
+			}
+			_need = total;
+		}
+	}
+
+	size_t avail = (size_t)(end - p);
+	if (_carryLen == 0 && avail >= _need) {
+		size_t n = _need;
+		_need = 0;
+		emit(p, n, true);
+		return p + n;
+	}
+	size_t n = minSize(_need - _carryLen, avail);
+	append(p, n);
+	if (_carryLen == _need) {
+		_need = 0;
+		emitCarry(true);
+	}
+	return p + n;
+}
+
+/**
+ * @brief STX_ETX: Telegramme von STX bis einschließlich ETX; Bytes dazwischen werden verworfen.
+ *
+ * Ein STX innerhalb eines Telegramms (ETX verloren) beendet das angefangene Telegramm als
+ * unvollständig und beginnt ein neues.
+ */
+const uint8_t *SerialFramer::feedStxEtx(const uint8_t *p, const uint8_t *end) {
+	if (!_inFrame) {
+		const uint8_t *s = findAny(p, end, &_cfg.stx, 1);
+		_stats.discarded += (uint32_t)(s - p);
+		if (s == end) return end;
+		_inFrame = true;
+		p = s;
+	}
+
+	size_t room = _cfg.maxRecord - _carryLen;
+	const uint8_t *limit = (size_t)(end - p) > room ? p + room : end;
+	const uint8_t *from = _carryLen == 0 ? p + 1 : p;  // eigenes STX überspringen
+	const uint8_t marks[2] = {_cfg.etx, _cfg.stx};
+	const uint8_t *m = from < limit ? findAny(from, limit, marks, 2) : limit;
+
+	if (m < limit && *m == _cfg.etx) {
+		_inFrame = false;
+		finish(p, (size_t)(m + 1 - p));
+		return m + 1;
+	}
+	if (m < limit) {
+		// Neues STX: angefangenes Telegramm unvollständig ausgeben
+		append(p, (size_t)(m - p));
+		_stats.partial++;
+		emitCarry(false);
+		return m;
+	}
+	append(p, (size_t)(limit - p));
+	if (_carryLen == _cfg.maxRecord) {
+		// Länger als erlaubt: unvollständig ausgeben und auf das nächste STX warten
+		_stats.split++;
+		emitCarry(false);
+		_inFrame = false;
+	}
+	return limit;
+}
+
+/**
+ * @brief IDLE: alles sammeln; das Ende setzt flush() nach der Sendepause.
+ */
+const uint8_t *SerialFramer::feedIdle(const uint8_t *p, const uint8_t *end) {
+	size_t n = minSize(_cfg.maxRecord - _carryLen, (size_t)(end - p));
+	append(p, n);
+	if (_carryLen == _cfg.maxRecord) {
+		_stats.split++;
+		emitCarry(true);
+	}
+	return p + n;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file SerialLineFilter.cpp
+ * @brief Übersetzung der Regelsätze und Bewertung einer Zeile für alle Clients.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialLineFilter.h"
+
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief Konstruktor: ohne build() ist kein Slot gefiltert.
+ */
+SerialLineFilter::SerialLineFilter() : _regexCount(0), _filtered(0) {
+	memset(_slots, 0, sizeof(_slots));
+}
+
+/**
+ * @brief Übersetzt alle Regelsätze.
+ *
+ * @param specs Regelsatz je Slot.
+ * @param slots Anzahl der Slots.
+ * @param error Puffer für die Fehlerbeschreibung.
+ * @param size Größe des Puffers.
+ * @return false bei ungültiger Regel oder erschöpften Mustern/Ausdrücken.
+ */
+bool SerialLineFilter::build(const SerialFilterSpec *specs, size_t slots, char *error, size_t size) {
+	_match.clear();
+	_regexCount = 0;
+	_filtered = 0;
+	memset(_slots, 0, sizeof(_slots));
+	if (slots > MAX_SLOTS) slots = MAX_SLOTS;
+
+	for (size_t s = 0; s < slots; ++s) {
+		const SerialFilterSpec &spec = specs[s];
+		if (spec.count == 0) continue;
+		if (spec.count > SerialFilterSpec::MAX_RULES) {
+			snprintf(error, size, "Zu viele Regeln");
+			return false;
+		}
+		Slot &slot = _slots[s];
+		for (size_t r = 0; r < spec.count; ++r) {
+			const SerialFilterRule &rule = spec.rules[r];
+			size_t len = strnlen(rule.text, SerialFilterRule::MAX_TEXT);
+			if (len == 0 || len >= SerialFilterRule::MAX_TEXT) {
+				snprintf(error, size, "Regel %u: Text fehlt oder ist zu lang", (unsigned)(r + 1));
+				return false;
+			}
+			if (rule.kind == FILTER_REGEX) {
+				size_t x = 0;
+				while (x < _regexCount && strcmp(_regexText[x], rule.text) != 0) ++x;
+				if (x == _regexCount) {
+					if (_regexCount >= MAX_REGEX) {
+						snprintf(error, size, "Zu viele Ausdrücke");
+						return false;
+					}
+					if (!_regex[x].compile(rule.text, len)) {
+						snprintf(error, size, "Regel %u: %s", (unsigned)(r + 1), _regex[x].error());
+						return false;
+					}
+					memcpy(_regexText[x], rule.text, len + 1);
+					_regexCount++;
+				}
+				if (rule.exclude) {
+					slot.regexExclude |= (uint8_t)(1u << x);
+				} else {
+					slot.regexInclude |= (uint8_t)(1u << x);
+				}
+			} else if (rule.kind == FILTER_PREFIX || rule.kind == FILTER_CONTAINS) {
+				int id = _match.add((const uint8_t *)rule.text, len, rule.kind == FILTER_PREFIX, rule.ignoreCase);
+				if (id == SerialMultiMatch::NO_PATTERN) {
+					snprintf(error, size, "Zu viele Filtermuster");
+					return false;
+				}
+				if (rule.exclude) {
+					slot.exclude |= 1ULL << id;
+				} else {
+					slot.include |= 1ULL << id;
+				}
+			} else {
+				snprintf(error, size, "Regel %u: Unbekannte Art", (unsigned)(r + 1));
+				return false;
+			}
+			if (!rule.exclude) slot.hasInclude = true;
+		}
+		_filtered |= 1UL << s;
+	}
+	_match.build();
+	if (size > 0) error[0] = '\0';
+	return true;
+}
+
+/**
+ * @brief Slots mit Regelsatz.
+ */
+uint32_t SerialLineFilter::filtered() const {
+	return _filtered;
+}
+
+/**
+ * @brief Bewertet eine Zeile für alle Slots mit Regelsatz.
+ *
+ * Zuerst ein Durchlauf über alle Teilstrings; Ausdrücke werden erst ausgewertet, wenn ein Slot
+ * sie noch braucht, und dann höchstens einmal pro Zeile.
+ *
+ * @param line Zeile.
+ * @param len Länge der Zeile.
+ * @return Bitmaske der Slots, die die Zeile bekommen.
+ */
+uint32_t SerialLineFilter::evaluate(const uint8_t *line, size_t len) const {
+	if (_filtered == 0) return 0;
+	uint64_t hits = _match.scan(line, len);
+	uint8_t tested = 0, matched = 0;
+	auto anyRegex = [&](uint8_t mask) {
+		for (size_t x = 0; x < _regexCount; ++x) {
+			uint8_t bit = (uint8_t)(1u << x);
+			if (!(mask & bit)) continue;
+			if (!(tested & bit)) {
+				SerialPatternMatch m;
+				tested |= bit;
+				if (_regex[x].search(line, len, m)) matched |= bit;
+			}
+			if (matched & bit) return true;
+		}
+		return false;
+	};
+
+	uint32_t result = 0;
+	for (size_t s = 0; s < MAX_SLOTS; ++s) {
+		if (!(_filtered & (1UL << s))) continue;
+		const Slot &slot = _slots[s];
+		if (hits & slot.exclude) continue;
+		bool in = !slot.hasInclude || (hits & slot.include) != 0 || anyRegex(slot.regexInclude);
+		if (!in || anyRegex(slot.regexExclude)) continue;
+		result |= 1UL << s;
+	}
+	return result;
+}
+
+/**
+ * @brief Anzahl der gemeinsamen Teilstringmuster.
+ */
+size_t SerialLineFilter::patterns() const {
+	return _match.patterns();
+}
+
+/**
+ * @brief Anzahl der Ausdrücke.
+ */
+size_t SerialLineFilter::regexes() const {
+	return _regexCount;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file SerialMultiMatch.cpp
+ * @brief Aho-Corasick-Automat: Präfixbaum, Fehlerverweise und Suche.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialMultiMatch.h"
+
+/**
+ * @brief Kleinbuchstabe (nur ASCII).
+ */
+static inline uint8_t foldCase(uint8_t c) {
+	return (c >= 'A' && c <= 'Z') ? (uint8_t)(c + ('a' - 'A')) : c;
+}
+
+/**
+ * @brief Konstruktor: leerer Automat.
+ */
+SerialMultiMatch::SerialMultiMatch() {
+	clear();
+}
+
+/**
+ * @brief Entfernt alle Muster.
+ */
+void SerialMultiMatch::clear() {
+	_nodes[0] = Node{0, NONE, 0, 0};
+	_nodeCount = 1;
+	_patternCount = 0;
+	_prefixMask = 0;
+	_foldMask = 0;
+	_fold = false;
+	_maxPrefix = 0;
+}
+
+/**
+ * @brief Sucht den Kindknoten zu einem Zeichen.
+ *
+ * @return Kindknoten oder NONE.
+ */
+uint16_t SerialMultiMatch::child(uint16_t node, uint8_t ch) const {
+	for (uint16_t e = _nodes[node].first; e != NONE; e = _edges[e].next) {
+		if (_edges[e].ch == ch) return _edges[e].target;
+	}
+	return NONE;
+}
+
+/**
+ * @brief Fügt ein Muster in den Präfixbaum ein.
+ *
+ * @param text Muster.
+ * @param len Länge.
+ * @param prefix true = nur am Zeilenanfang.
+ * @param ignoreCase true = ohne Groß-/Kleinschreibung.
+ * @return Musternummer oder NO_PATTERN.
+ */
+int SerialMultiMatch::add(const uint8_t *text, size_t len, bool prefix, bool ignoreCase) {
+	if (len == 0 || len > MAX_PATTERN_LEN) return NO_PATTERN;
+	uint16_t node = 0;
+	for (size_t i = 0; i < len; ++i) {
+		uint8_t c = ignoreCase ? foldCase(text[i]) : text[i];
+		uint16_t next = child(node, c);
+		if (next == NONE) {
+			if (_nodeCount >= MAX_NODES) return NO_PATTERN;
+			next = (uint16_t)_nodeCount++;
+			_nodes[next] = Node{0, NONE, 0, (uint8_t)(_nodes[node].depth + 1)};
+			// Kante n-1 führt zu Knoten n: jeder Knoten außer der Wurzel hat genau eine
+			Edge &e = _edges[next - 1];
+			e.next = _nodes[node].first;
+			e.target = next;
+			e.ch = c;
+			_nodes[node].first = (uint16_t)(next - 1);
+		}
+		node = next;
+	}
+	for (size_t p = 0; p < _patternCount; ++p) {
+		uint64_t bit = 1ULL << p;
+		if (_patternNode[p] == node && ((_prefixMask & bit) != 0) == prefix && ((_foldMask & bit) != 0) == ignoreCase) return (int)p;
+	}
+	if (_patternCount >= MAX_PATTERNS) return NO_PATTERN;
+	size_t id = _patternCount++;
+	uint64_t bit = 1ULL << id;
+	_patternNode[id] = node;
+	_nodes[node].out |= bit;
+	if (prefix) {
+		_prefixMask |= bit;
+		if (len > _maxPrefix) _maxPrefix = len;
+	}
+	if (ignoreCase) {
+		_foldMask |= bit;
+		_fold = true;
+	}
+	return (int)id;
+}
+
+/**
+ * @brief Berechnet Fehlerverweise in Breitensuche und vererbt die Ausgabemengen.
+ *
+ * Der Fehlerverweis eines Knotens zeigt auf den längsten echten Suffix seines Pfads, der
+ * ebenfalls im Baum liegt; dessen Muster enden dort mit.
+ */
+void SerialMultiMatch::build() {
+	for (size_t c = 0; c < 256; ++c) _root[c] = 0;
+	for (uint16_t e = _nodes[0].first; e != NONE; e = _edges[e].next) _root[_edges[e].ch] = _edges[e].target;
+
+	uint16_t queue[MAX_NODES];
+	size_t head = 0, tail = 0;
+	queue[tail++] = 0;
+	while (head < tail) {
+		uint16_t u = queue[head++];
+		for (uint16_t e = _nodes[u].first; e != NONE; e = _edges[e].next) {
+			uint16_t v = _edges[e].target;
+			uint8_t c = _edges[e].ch;
+			uint16_t f = _nodes[u].fail;
+			while (f != 0 && child(f, c) == NONE) f = _nodes[f].fail;
+			uint16_t w = child(f, c);
+			_nodes[v].fail = (w != NONE && w != v) ? w : 0;
+			_nodes[v].out |= _nodes[_nodes[v].fail].out;
+			queue[tail++] = v;
+		}
+	}
+}
+
+/**
+ * @brief Übergang des Automaten für ein Zeichen (über Fehlerverweise).
+ *
+ * Die Wurzel hat als einziger Knoten eine Tabelle über alle Zeichen: Dort hält sich der
+ * Automat in normalen Zeilen fast immer auf, und dort hat er die meisten Kanten.
+ */
+uint16_t SerialMultiMatch::step(uint16_t state, uint8_t ch) const {
+	while (state != 0) {
+		uint16_t next = child(state, ch);
+		if (next != NONE) return next;
+		state = _nodes[state].fail;
+	}
+	return _root[ch];
+}
+
+/**
+ * @brief Ein Durchlauf über die Daten, roh oder in Kleinbuchstaben.
+ *
+ * @param data Daten.
+ * @param len Länge.
+ * @param fold true = Durchlauf für die Muster ohne Groß-/Kleinschreibung.
+ * @param stopMask Vorzeitiges Ende, sobald alle diese Muster gefunden sind.
+ * @return Gefundene Muster der jeweiligen Art.
+ */
+uint64_t SerialMultiMatch::walk(const uint8_t *data, size_t len, bool fold, uint64_t stopMask) const {
+	uint64_t want = fold ? _foldMask : ~_foldMask;
+	uint64_t hits = 0;
+	uint16_t state = 0;
+	for (size_t i = 0; i < len; ++i) {
+		state = step(state, fold ? foldCase(data[i]) : data[i]);
+		uint64_t out = _nodes[state].out & want & ~hits;
+		if (out == 0) continue;
+		hits |= out & ~_prefixMask;
+		// Präfixmuster zählen nur, wenn ihr Ende genau ihrer Länge entspricht
+		for (uint64_t pre = i < _maxPrefix ? out & _prefixMask : 0; pre != 0; pre &= pre - 1) {
+			int p = __builtin_ctzll(pre);
+			if (_nodes[_patternNode[p]].depth == i + 1) hits |= 1ULL << p;
+		}
+		if (stopMask != 0 && (hits & stopMask) == stopMask) break;
+	}
+	return hits;
+}
+
+/**
+ * @brief Durchsucht Daten nach allen Mustern.
+ *
+ * Gibt es Muster ohne Groß-/Kleinschreibung, folgt ein zweiter Durchlauf in Kleinbuchstaben.
+ *
+ * @param data Daten.
+ * @param len Länge.
+ * @param stopMask Vorzeitiges Ende, sobald alle diese Muster gefunden sind.
+ * @return Bitmaske der gefundenen Muster.
+ */
+uint64_t SerialMultiMatch::scan(const uint8_t *data, size_t len, uint64_t stopMask) const {
+	if (_patternCount == 0) return 0;
+	uint64_t hits = walk(data, len, false, stopMask & ~_foldMask);
+	if (_fold) hits |= walk(data, len, true, stopMask & _foldMask);
+	return hits;
+}
+
+/**
+ * @brief Anzahl der Muster.
+ */
+size_t SerialMultiMatch::patterns() const {
+	return _patternCount;
+}
+
+/**
+ * @brief Anzahl der belegten Knoten.
+ */
+size_t SerialMultiMatch::nodes() const {
+	return _nodeCount;
+}
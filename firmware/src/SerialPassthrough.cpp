@@ -0,0 +1,424 @@
+/**
+ * @file SerialPassthrough.cpp
+ * @brief Zwischenpuffer, Gegendruck und Boot-Sequenzen des Durchreichmodus.
+ *
+ * Die Sperre wird nur für das Ein- und Austragen von Bytes gehalten; das Schreiben auf die
+ * UART, das Warten auf das Sendeende und die Boot-Impulse laufen außerhalb, sodass `offer()`
+ * aus dem WebSocket-Kontext nie auf die Leitung wartet. Weil `offer()` einen ganzen Upload-Block
+ * (bis zum Kreditfenster) unter der Sperre kopiert, ist sie ein TaskMutex statt eines Spinlocks.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialPassthrough.h"
+
+#include <cstring>
+
+namespace {
+
+inline void putLe16(uint8_t *p, uint16_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+}
+
+inline void putLe32(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+inline uint16_t getLe16(const uint8_t *p) {
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t getLe32(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+}  // namespace
+
+/**
+ * @brief Schreibt den Kopf einer Upload-Nachricht.
+ *
+ * @param hdr Kopffelder.
+ * @param out Zielpuffer (mindestens SERIAL_UPLOAD_HEADER_LEN Bytes).
+ * @return SERIAL_UPLOAD_HEADER_LEN.
+ */
+size_t encodeSerialUploadHeader(const SerialUploadHeader &hdr, uint8_t *out) {
+	out[0] = hdr.version;
+	out[1] = hdr.channel;
+	putLe16(out + 2, hdr.flags);
+	putLe32(out + 4, hdr.offset);
+	return SERIAL_UPLOAD_HEADER_LEN;
+}
+
+/**
+ * @brief Liest den Kopf einer Upload-Nachricht.
+ *
+ * @param in Empfangene Nachricht.
+ * @param len Länge der Nachricht.
+ * @param hdr Ausgabeparameter.
+ * @return false bei zu kurzer Nachricht oder unbekannter Version.
+ */
+bool decodeSerialUploadHeader(const uint8_t *in, size_t len, SerialUploadHeader &hdr) {
+	if (len < SERIAL_UPLOAD_HEADER_LEN || in[0] != SERIAL_UPLOAD_VERSION) return false;
+	hdr.version = in[0];
+	hdr.channel = in[1];
+	hdr.flags = getLe16(in + 2);
+	hdr.offset = getLe32(in + 4);
+	return true;
+}
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param port UART, auf die geschrieben wird.
+ */
+SerialPassthrough::SerialPassthrough(UartPort &port)
+    : _port(port), _tap(nullptr), _tapCtx(nullptr), _config(), _state(PASSTHROUGH_IDLE), _work(nullptr), _discard(false), _lastOfferMs(0), _startMs(0), _stats() {
+}
+
+/**
+ * @brief Registriert einen Mithörer für geschriebene Bytes.
+ *
+ * @param tap Callback (nullptr = keiner).
+ * @param ctx Benutzerkontext.
+ */
+void SerialPassthrough::onTransmit(TapFn tap, void *ctx) {
+	_tap = tap;
+	_tapCtx = ctx;
+}
+
+/**
+ * @brief Prüft Rate, Boot-Modi und Wartezeit.
+ *
+ * @param config Zu prüfende Parameter.
+ * @return false bei Rate außerhalb [MIN_BAUD, MAX_BAUD], unbekanntem Boot-Modus oder zu langer Wartezeit.
+ */
+bool SerialPassthrough::validate(const SerialPassthroughConfig &config) {
+	if (config.baud < MIN_BAUD || config.baud > MAX_BAUD) return false;
+	if (config.enter > BOOT_MODE_RUN || config.leave > BOOT_MODE_RUN) return false;
+	return config.idleMs <= MAX_IDLE_MS;
+}
+
+/**
+ * @brief Blockgröße pro Schreibvorgang.
+ *
+ * Bei kleinen Raten kürzere Blöcke, damit Abbruch und Quittungen nicht sekundenlang warten.
+ *
+ * @param baud Rate der Übertragung.
+ * @return Bytes pro Block, zwischen 64 und WRITE_CHUNK.
+ */
+size_t SerialPassthrough::chunkFor(uint32_t baud) {
+	// 8N1: 10 Bit pro Byte
+	size_t chunk = (size_t)((uint64_t)baud * CHUNK_MS / 10000);
+	if (chunk < 64) return 64;
+	return chunk < WRITE_CHUNK ? chunk : WRITE_CHUNK;
+}
+
+/**
+ * @brief Beginnt eine Übertragung.
+ *
+ * @param owner Client-ID des Besitzers.
+ * @param config Parameter.
+ * @param mem Speicher für Zwischen- und Arbeitspuffer (MEMORY_BYTES).
+ * @return false, wenn bereits eine Übertragung läuft oder die Parameter ungültig sind.
+ */
+bool SerialPassthrough::begin(uint32_t owner, const SerialPassthroughConfig &config, uint8_t *mem) {
+	if (!validate(config) || !mem) return false;
+	bool ok = false;
+	_lock.enter();
+	if (_state == PASSTHROUGH_IDLE) {
+		_config = config;
+		_ring.reset(mem, BUFFER_BYTES);
+		_work = mem + BUFFER_BYTES;
+		_discard = false;
+		_startMs = 0;
+		memset(&_stats, 0, sizeof(_stats));
+		_stats.owner = owner;
+		_stats.baud = config.baud;
+		_state = PASSTHROUGH_STARTING;
+		ok = true;
+	}
+	_lock.exit();
+	return ok;
+}
+
+/**
+ * @brief Stellt Rate und Boot-Leitungen ein und gibt das Durchreichen frei.
+ *
+ * @return false, wenn eine Boot-Sequenz angefordert war, aber keine Leitungen verdrahtet sind.
+ */
+bool SerialPassthrough::enter() {
+	if (_state != PASSTHROUGH_STARTING) return true;
+	_port.begin(_config.baud);
+	bool lines = true;
+	if (_config.enter != BOOT_MODE_NONE) {
+		lines = _port.setBootLines(false, false);
+		if (lines) runBootSequence(_config.enter);
+	}
+	uint32_t now = _port.now();
+	_lock.enter();
+	_startMs = now ? now : 1;
+	_lastOfferMs = now;
+	if (_state == PASSTHROUGH_STARTING) _state = PASSTHROUGH_ACTIVE;
+	_lock.exit();
+	return lines;
+}
+
+/**
+ * @brief Nimmt Daten eines Upload-Blocks an.
+ *
+ * Ein Block, der teilweise schon angenommen wurde (Wiederholung nach Ablehnung), wird ab dem
+ * erwarteten Offset übernommen.
+ *
+ * @param offset Position des ersten Bytes in der Übertragung.
+ * @param data Daten.
+ * @param len Länge.
+ * @return UPLOAD_OK bzw. der Grund der Ablehnung.
+ */
+SerialUploadResult SerialPassthrough::offer(uint32_t offset, const uint8_t *data, size_t len) {
+	uint32_t now = _port.now();
+	SerialUploadResult result = UPLOAD_OK;
+	_lock.enter();
+	uint32_t received = _stats.received;
+	uint64_t end = (uint64_t)offset + len;
+	if (_state != PASSTHROUGH_STARTING && _state != PASSTHROUGH_ACTIVE) {
+		result = UPLOAD_INACTIVE;
+	} else if (_config.size > 0 && end > _config.size) {
+		result = UPLOAD_TOO_LONG;
+	} else if (offset > received) {
+		result = UPLOAD_GAP;
+	} else if (end <= received) {
+		result = UPLOAD_DUPLICATE;
+	} else {
+		size_t skip = received - offset;
+		if (!_ring.push(data + skip, len - skip)) {
+			result = UPLOAD_OVERFLOW;
+		} else {
+			_stats.received += (uint32_t)(len - skip);
+			_stats.chunks++;
+			if (_ring.size() > _stats.maxBuffered) _stats.maxBuffered = _ring.size();
+			_lastOfferMs = now;
+		}
+	}
+	if (result == UPLOAD_GAP || result == UPLOAD_OVERFLOW || result == UPLOAD_TOO_LONG) _stats.rejected++;
+	_lock.exit();
+	return result;
+}
+
+/**
+ * @brief Schreibt den nächsten Block auf die UART.
+ *
+ * Kopiert höchstens chunkFor() Bytes unter der Sperre in den Arbeitspuffer und schreibt sie
+ * außerhalb; erst danach werden sie aus dem Zwischenpuffer entfernt und das Limit rückt vor.
+ *
+ * @return Anzahl der geschriebenen Bytes.
+ */
+size_t SerialPassthrough::drain() {
+	if (_state != PASSTHROUGH_ACTIVE && _state != PASSTHROUGH_STOPPING) return 0;
+	_lock.enter();
+	size_t n = (_discard || !_work) ? 0 : _ring.peek(_work, chunkFor(_config.baud));
+	_lock.exit();
+	if (n == 0) return 0;
+
+	size_t done = _port.write(_work, n);
+	if (done > 0 && _tap) _tap(_tapCtx, _work, done);
+
+	_lock.enter();
+	_ring.drop(done);
+	_stats.written += (uint32_t)done;
+	_lock.exit();
+	return done;
+}
+
+/**
+ * @brief Fordert das Ende an.
+ *
+ * @param discard true = noch nicht geschriebene Daten verwerfen.
+ */
+void SerialPassthrough::requestStop(bool discard) {
+	_lock.enter();
+	if (_state != PASSTHROUGH_IDLE) {
+		_state = PASSTHROUGH_STOPPING;
+		if (discard) _discard = true;
+	}
+	_lock.exit();
+}
+
+/**
+ * @brief Ist die Übertragung fertig?
+ */
+bool SerialPassthrough::complete() const {
+	_lock.enter();
+	bool done = false;
+	if (_state == PASSTHROUGH_ACTIVE) {
+		done = _config.size > 0 && _stats.written >= _config.size;
+	} else if (_state == PASSTHROUGH_STOPPING) {
+		done = _discard || _ring.size() == 0;
+	}
+	_lock.exit();
+	return done;
+}
+
+/**
+ * @brief Kam länger als idleMs kein Upload-Block, obwohl nichts mehr zu schreiben ist?
+ */
+bool SerialPassthrough::idle() const {
+	uint32_t now = _port.now();
+	_lock.enter();
+	bool result = _state == PASSTHROUGH_ACTIVE && _config.idleMs > 0 && _ring.size() == 0 && now - _lastOfferMs >= _config.idleMs;
+	_lock.exit();
+	return result;
+}
+
+/**
+ * @brief Beendet die Übertragung.
+ *
+ * @param restoreBaud Rate nach der Übertragung (0 = beibehalten).
+ * @return Endstand der Zähler mit Durchsatz.
+ */
+SerialPassthroughStats SerialPassthrough::finish(uint32_t restoreBaud) {
+	// Durchsatz bis das letzte Bit die Leitung verlassen hat
+	if (!_discard) _port.waitTxDone(TX_DONE_TIMEOUT_MS);
+	uint32_t now = _port.now();
+
+	_lock.enter();
+	_state = PASSTHROUGH_STOPPING;
+	_ring.reset(nullptr, 0);
+	_work = nullptr;
+	fillRate(_stats, _startMs ? now - _startMs : 0);
+	SerialPassthroughStats result = _stats;
+	_lock.exit();
+
+	if (_config.leave != BOOT_MODE_NONE && _port.setBootLines(false, false)) runBootSequence(_config.leave);
+	if (restoreBaud > 0 && restoreBaud != _config.baud) _port.begin(restoreBaud);
+	return result;
+}
+
+/**
+ * @brief Gibt die UART wieder frei.
+ */
+void SerialPassthrough::close() {
+	_lock.enter();
+	_state = PASSTHROUGH_IDLE;
+	_stats.owner = 0;
+	_lock.exit();
+}
+
+/**
+ * @brief Zählt vom Controller empfangene Bytes.
+ */
+void SerialPassthrough::onRx(size_t len) {
+	_lock.enter();
+	_stats.rxBytes += (uint32_t)len;
+	_lock.exit();
+}
+
+/**
+ * @brief Steuert die Boot-Leitungen ohne Übertragung.
+ *
+ * @param mode BOOT_MODE_BOOTLOADER oder BOOT_MODE_RUN.
+ * @return false bei unbekanntem Modus oder ohne verdrahtete Leitungen.
+ */
+bool SerialPassthrough::resetTarget(uint8_t mode) {
+	if (mode != BOOT_MODE_BOOTLOADER && mode != BOOT_MODE_RUN) return false;
+	if (!_port.setBootLines(false, false)) return false;
+	runBootSequence(mode);
+	return true;
+}
+
+/**
+ * @brief Reset-Impuls, bei BOOT_MODE_BOOTLOADER mit aktivem Boot-Pin über die Freigabe hinaus.
+ *
+ * Entspricht der klassischen Sequenz von DTR/RTS an USB-Seriell-Adaptern: Der Boot-Pin
+ * (ESP32 GPIO0, STM32 BOOT0) wird beim Loslassen des Resets abgetastet.
+ */
+void SerialPassthrough::runBootSequence(uint8_t mode) {
+	bool boot = mode == BOOT_MODE_BOOTLOADER;
+	_port.setBootLines(boot, true);
+	_port.sleep(RESET_PULSE_MS);
+	_port.setBootLines(boot, false);
+	if (boot) {
+		_port.sleep(BOOT_HOLD_MS);
+		_port.setBootLines(false, false);
+	}
+}
+
+/**
+ * @brief Trägt Dauer und Durchsatz ein.
+ */
+void SerialPassthrough::fillRate(SerialPassthroughStats &stats, uint32_t elapsedMs) {
+	stats.elapsedMs = elapsedMs;
+	stats.bytesPerSec = elapsedMs ? (uint32_t)((uint64_t)stats.written * 1000 / elapsedMs) : 0;
+	// Leitungsrate 8N1: baud / 10 Bytes pro Sekunde
+	uint64_t percent = stats.baud ? (uint64_t)stats.bytesPerSec * 1000 / stats.baud : 0;
+	stats.linePercent = (uint8_t)(percent > 100 ? 100 : percent);
+}
+
+/**
+ * @brief Aktueller Zustand.
+ */
+SerialPassthroughState SerialPassthrough::state() const {
+	return (SerialPassthroughState)_state;
+}
+
+/**
+ * @brief Besitzer der laufenden Übertragung (0 = keiner).
+ */
+uint32_t SerialPassthrough::owner() const {
+	_lock.enter();
+	uint32_t id = _state == PASSTHROUGH_IDLE ? 0 : _stats.owner;
+	_lock.exit();
+	return id;
+}
+
+/**
+ * @brief Parameter der laufenden Übertragung.
+ */
+const SerialPassthroughConfig &SerialPassthrough::config() const {
+	return _config;
+}
+
+/**
+ * @brief Auf die UART geschriebene Bytes.
+ */
+uint32_t SerialPassthrough::written() const {
+	_lock.enter();
+	uint32_t n = _stats.written;
+	_lock.exit();
+	return n;
+}
+
+/**
+ * @brief Höchster Offset, bis zu dem der Client senden darf.
+ */
+uint32_t SerialPassthrough::limit() const {
+	_lock.enter();
+	uint32_t n = _stats.written + (uint32_t)BUFFER_BYTES;
+	if (_config.size > 0 && n > _config.size) n = _config.size;
+	_lock.exit();
+	return n;
+}
+
+/**
+ * @brief Wurde die Übertragung abgebrochen?
+ */
+bool SerialPassthrough::aborted() const {
+	return _discard;
+}
+
+/**
+ * @brief Kopie der Zähler mit Durchsatz bis jetzt.
+ */
+SerialPassthroughStats SerialPassthrough::stats() const {
+	uint32_t now = _port.now();
+	_lock.enter();
+	SerialPassthroughStats result = _stats;
+	uint32_t start = _startMs;
+	_lock.exit();
+	fillRate(result, start ? now - start : 0);
+	return result;
+}
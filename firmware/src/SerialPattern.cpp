@@ -0,0 +1,576 @@
+/**
+ * @file SerialPattern.cpp
+ * @brief Übersetzer und Backtracking-Ausführung der regulären Ausdrücke für Skripte.
+ *
+ * Das Programm folgt dem bekannten Schema aus CHAR/ANY/CLASS, SPLIT (zwei Zweige, der erste
+ * bevorzugt), JMP und SAVE (Gruppengrenzen). Quantoren und Alternativen fügen ihren SPLIT nach
+ * dem Übersetzen des Teilausdrucks davor ein; insert() verschiebt dabei alle Sprungziele.
+ *
+ * Schleifen über Gruppen (`(a*)*`) könnten leer endlos kreisen. Sie merken sich deshalb mit
+ * OP_MARK die Position beim Eintritt und wiederholen nur, wenn OP_CHECK Fortschritt sieht.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialPattern.h"
+
+#include <cstring>
+
+static constexpr uint8_t OP_CHAR = 0;   ///< Ein bestimmtes Zeichen
+static constexpr uint8_t OP_ANY = 1;    ///< Beliebiges Zeichen außer '\n'
+static constexpr uint8_t OP_CLASS = 2;  ///< Zeichen aus einer Klasse
+static constexpr uint8_t OP_BOL = 3;    ///< Anfang von Daten oder Zeile
+static constexpr uint8_t OP_EOL = 4;    ///< Ende von Daten oder Zeile
+static constexpr uint8_t OP_SPLIT = 5;  ///< Zweig x, bei Fehlschlag y
+static constexpr uint8_t OP_JMP = 6;    ///< Sprung nach x
+static constexpr uint8_t OP_SAVE = 7;   ///< Textposition in Gruppenslot arg merken
+static constexpr uint8_t OP_MATCH = 8;  ///< Treffer
+static constexpr uint8_t OP_MARK = 9;   ///< Textposition beim Schleifeneintritt in Slot arg merken
+static constexpr uint8_t OP_CHECK = 10; ///< Fehlschlag, wenn seit OP_MARK nichts verbraucht wurde
+
+static constexpr uint16_t NONE = 0xFFFF;      ///< Sprungziel noch offen
+static constexpr uint8_t FRAME_BRANCH = 0xFF;  ///< Stapeleintrag ist ein offener Zweig
+
+/**
+ * @brief Setzt ein Bit in einer Zeichenklasse.
+ */
+static inline void setBit(uint8_t *set, uint8_t c) {
+	set[c >> 3] |= (uint8_t)(1u << (c & 7));
+}
+
+/**
+ * @brief Prüft ein Bit einer Zeichenklasse.
+ */
+static inline bool hasBit(const uint8_t *set, uint8_t c) {
+	return (set[c >> 3] >> (c & 7)) & 1;
+}
+
+/**
+ * @brief Füllt eine Klasse für `\d`, `\w` oder `\s` (ggf. negiert).
+ *
+ * @return false, wenn `kind` kein Kürzel ist.
+ */
+static bool shorthand(char kind, uint8_t *set) {
+	uint8_t tmp[32];
+	memset(tmp, 0, sizeof(tmp));
+	char lower = kind | 0x20;
+	if (lower == 'd') {
+		for (int c = '0'; c <= '9'; ++c) setBit(tmp, (uint8_t)c);
+	} else if (lower == 'w') {
+		for (int c = '0'; c <= '9'; ++c) setBit(tmp, (uint8_t)c);
+		for (int c = 'a'; c <= 'z'; ++c) setBit(tmp, (uint8_t)c);
+		for (int c = 'A'; c <= 'Z'; ++c) setBit(tmp, (uint8_t)c);
+		setBit(tmp, '_');
+	} else if (lower == 's') {
+		const char *ws = " \t\r\n\f\v";
+		for (; *ws; ++ws) setBit(tmp, (uint8_t)*ws);
+	} else {
+		return false;
+	}
+	bool negate = kind != lower;
+	for (size_t i = 0; i < sizeof(tmp); ++i) set[i] |= negate ? (uint8_t)~tmp[i] : tmp[i];
+	return true;
+}
+
+/**
+ * @brief Wert einer Hex-Ziffer (-1 bei ungültiger Ziffer).
+ */
+static int hexValue(char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+/**
+ * @brief Konstruktor; ohne compile()/literal() findet search() nichts.
+ */
+SerialPattern::SerialPattern()
+    : _len(0), _classCount(0), _groups(0), _loops(0), _literalLen(0), _isLiteral(false), _error(""), _exhausted(false), _src(nullptr), _srcLen(0), _pos(0), _depth(0) {
+}
+
+/**
+ * @brief Übersetzt einen regulären Ausdruck.
+ *
+ * @param pattern Ausdruck.
+ * @param len Länge des Ausdrucks.
+ * @return false bei Syntaxfehler (siehe error()).
+ */
+bool SerialPattern::compile(const char *pattern, size_t len) {
+	_len = 0;
+	_classCount = 0;
+	_groups = 1;
+	_loops = 0;
+	_isLiteral = false;
+	_error = "";
+	_src = pattern;
+	_srcLen = len;
+	_pos = 0;
+	_depth = 0;
+	if (!emit(OP_SAVE, 0) || !parseAlt()) {
+		_len = 0;
+		return false;
+	}
+	if (_pos < _srcLen) {
+		_len = 0;
+		return fail("Klammer ')' ohne '('");
+	}
+	if (!emit(OP_SAVE, 1) || !emit(OP_MATCH)) {
+		_len = 0;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Setzt einen Teilstring als Muster.
+ *
+ * @param text Gesuchter Text.
+ * @param len Länge des Textes.
+ * @return false bei leerem oder zu langem Text.
+ */
+bool SerialPattern::literal(const char *text, size_t len) {
+	_len = 0;
+	_groups = 1;
+	_error = "";
+	if (len == 0 || len > MAX_LITERAL) {
+		_isLiteral = false;
+		_literalLen = 0;
+		_error = len == 0 ? "Leeres Muster" : "Muster zu lang";
+		return false;
+	}
+	memcpy(_literal, text, len);
+	_literalLen = len;
+	_isLiteral = true;
+	return true;
+}
+
+/**
+ * @brief Gibt die Anzahl der Gruppen einschließlich Gruppe 0 zurück.
+ */
+size_t SerialPattern::groups() const {
+	return _groups;
+}
+
+/**
+ * @brief true, wenn die letzte Suche am Budget abgebrochen ist.
+ */
+bool SerialPattern::exhausted() const {
+	return _exhausted;
+}
+
+/**
+ * @brief Letzter Übersetzungsfehler.
+ */
+const char *SerialPattern::error() const {
+	return _error;
+}
+
+/**
+ * @brief Merkt einen Übersetzungsfehler.
+ *
+ * @return Immer false.
+ */
+bool SerialPattern::fail(const char *msg) {
+	if (_error[0] == '\0') _error = msg;
+	return false;
+}
+
+/**
+ * @brief Hängt eine Instruktion an.
+ */
+bool SerialPattern::emit(uint8_t op, uint8_t arg, uint16_t x, uint16_t y) {
+	if (_len >= MAX_PROGRAM) return fail("Ausdruck zu lang");
+	_prog[_len++] = {op, arg, x, y};
+	return true;
+}
+
+/**
+ * @brief Fügt eine Instruktion an Position `at` ein und verschiebt alle Ziele dahinter.
+ *
+ * Ziele, die genau auf `at` zeigen, bleiben für Instruktionen davor unverändert (sie treffen
+ * jetzt die neue Instruktion) und wandern für Instruktionen ab `at` mit (sie gehören zum
+ * verschobenen Teilausdruck).
+ *
+ * @param at Einfügeposition.
+ * @param op Einzufügende Instruktion (OP_SPLIT, OP_MARK).
+ * @param x Ziel nach dem Einfügen.
+ * @param y Zweites Ziel nach dem Einfügen.
+ */
+bool SerialPattern::insert(size_t at, uint8_t op, uint16_t x, uint16_t y) {
+	if (_len >= MAX_PROGRAM) return fail("Ausdruck zu lang");
+	for (size_t i = 0; i < _len; ++i) {
+		Instr &in = _prog[i];
+		if (in.op != OP_SPLIT && in.op != OP_JMP) continue;
+		if (in.x != NONE && (in.x > at || (in.x == at && i >= at))) in.x++;
+		if (in.op == OP_SPLIT && in.y != NONE && (in.y > at || (in.y == at && i >= at))) in.y++;
+	}
+	memmove(&_prog[at + 1], &_prog[at], (_len - at) * sizeof(Instr));
+	_prog[at] = {op, 0, x, y};
+	_len++;
+	return true;
+}
+
+/**
+ * @brief Alternativen: concat ('|' alt)?
+ */
+bool SerialPattern::parseAlt() {
+	size_t start = _len;
+	if (!parseConcat()) return false;
+	if (_pos >= _srcLen || _src[_pos] != '|') return true;
+	_pos++;
+	if (!insert(start, OP_SPLIT, (uint16_t)(start + 1), NONE)) return false;
+	size_t jmp = _len;
+	if (!emit(OP_JMP, 0, NONE)) return false;
+	_prog[start].y = (uint16_t)_len;
+	if (!parseAlt()) return false;
+	_prog[jmp].x = (uint16_t)_len;
+	return true;
+}
+
+/**
+ * @brief Folge von Teilausdrücken bis '|', ')' oder Ende.
+ */
+bool SerialPattern::parseConcat() {
+	while (_pos < _srcLen && _src[_pos] != '|' && _src[_pos] != ')') {
+		if (!parseRepeat()) return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Teilausdruck mit optionalem Quantor.
+ */
+bool SerialPattern::parseRepeat() {
+	size_t start = _len;
+	bool group = _src[_pos] == '(';
+	if (!parseAtom()) return false;
+	if (_pos >= _srcLen) return true;
+	char q = _src[_pos];
+	if (q != '*' && q != '+' && q != '?') return true;
+	_pos++;
+	bool lazy = _pos < _srcLen && _src[_pos] == '?';
+	if (lazy) _pos++;
+
+	if (q == '?') {
+		// SPLIT L1, L2; L1: e; L2:
+		uint16_t body = (uint16_t)(start + 1), out = (uint16_t)(_len + 1);
+		return insert(start, OP_SPLIT, lazy ? out : body, lazy ? body : out);
+	}
+
+	// Gruppen können leer passen: Wiederholung nur mit Fortschritt (MARK/CHECK)
+	int slot = -1;
+	if (group) {
+		if (_loops >= MAX_LOOPS) return fail("Zu viele Schleifen über Gruppen");
+		slot = (int)(2 * SerialPatternMatch::MAX_GROUPS + _loops++);
+		if (!insert(start, OP_MARK, 0, 0)) return false;
+		_prog[start].arg = (uint8_t)slot;
+	}
+	size_t body = start;  // erste Instruktion der Schleife (MARK bzw. e)
+	if (q == '*') {
+		// L1: SPLIT L2, L3; L2: [MARK] e [CHECK]; JMP L1; L3:
+		size_t extra = slot >= 0 ? 1 : 0;
+		uint16_t in = (uint16_t)(start + 1), out = (uint16_t)(_len + 2 + extra);
+		if (!insert(start, OP_SPLIT, lazy ? out : in, lazy ? in : out)) return false;
+		if (slot >= 0 && !emit(OP_CHECK, (uint8_t)slot)) return false;
+		return emit(OP_JMP, 0, (uint16_t)start);
+	}
+	// '+': L1: [MARK] e; SPLIT L2, L3; L2: [CHECK; JMP L1 | direkt L1]; L3:
+	if (slot < 0) {
+		uint16_t out = (uint16_t)(_len + 1);
+		return emit(OP_SPLIT, 0, lazy ? out : (uint16_t)body, lazy ? (uint16_t)body : out);
+	}
+	uint16_t again = (uint16_t)(_len + 1), out = (uint16_t)(_len + 3);
+	if (!emit(OP_SPLIT, 0, lazy ? out : again, lazy ? again : out)) return false;
+	if (!emit(OP_CHECK, (uint8_t)slot)) return false;
+	return emit(OP_JMP, 0, (uint16_t)body);
+}
+
+/**
+ * @brief Einzelnes Zeichen, Klasse, Anker oder Gruppe.
+ */
+bool SerialPattern::parseAtom() {
+	char c = _src[_pos++];
+	switch (c) {
+		case '(': {
+			if (_depth >= MAX_DEPTH) return fail("Gruppen zu tief geschachtelt");
+			bool capture = true;
+			if (_pos + 1 < _srcLen && _src[_pos] == '?' && _src[_pos + 1] == ':') {
+				capture = false;
+				_pos += 2;
+			}
+			size_t group = 0;
+			if (capture) {
+				if (_groups >= SerialPatternMatch::MAX_GROUPS) return fail("Zu viele Gruppen");
+				group = _groups++;
+				if (!emit(OP_SAVE, (uint8_t)(2 * group))) return false;
+			}
+			_depth++;
+			if (!parseAlt()) return false;
+			_depth--;
+			if (_pos >= _srcLen || _src[_pos] != ')') return fail("Klammer ')' fehlt");
+			_pos++;
+			return capture ? emit(OP_SAVE, (uint8_t)(2 * group + 1)) : true;
+		}
+		case '[':
+			return parseClass();
+		case '.':
+			return emit(OP_ANY);
+		case '^':
+			return emit(OP_BOL);
+		case '$':
+			return emit(OP_EOL);
+		case '*':
+		case '+':
+		case '?':
+			return fail("Quantor ohne Ausdruck");
+		case '\\': {
+			uint8_t set[32];
+			memset(set, 0, sizeof(set));
+			int single = -1;
+			if (!parseEscape(set, single)) return false;
+			if (single >= 0) return emit(OP_CHAR, (uint8_t)single);
+			int cls = newClass();
+			if (cls < 0) return false;
+			memcpy(_classes[cls], set, sizeof(set));
+			return emit(OP_CLASS, (uint8_t)cls);
+		}
+		default:
+			return emit(OP_CHAR, (uint8_t)c);
+	}
+}
+
+/**
+ * @brief Zeichenklasse `[...]` (der Leseposition steht hinter '[').
+ */
+bool SerialPattern::parseClass() {
+	int cls = newClass();
+	if (cls < 0) return false;
+	uint8_t *set = _classes[cls];
+	bool negate = _pos < _srcLen && _src[_pos] == '^';
+	if (negate) _pos++;
+	bool first = true;
+	for (;;) {
+		if (_pos >= _srcLen) return fail("Klammer ']' fehlt");
+		char c = _src[_pos];
+		if (c == ']' && !first) {
+			_pos++;
+			break;
+		}
+		first = false;
+		_pos++;
+		int lo = (uint8_t)c;
+		if (c == '\\') {
+			if (!parseEscape(set, lo)) return false;
+			if (lo < 0) continue;
+		}
+		if (_pos + 1 < _srcLen && _src[_pos] == '-' && _src[_pos + 1] != ']') {
+			_pos++;
+			int hi = (uint8_t)_src[_pos++];
+			if (hi == '\\') {
+				uint8_t dummy[32];
+				if (!parseEscape(dummy, hi)) return false;
+				if (hi < 0) return fail("Ungültiger Bereich");
+			}
+			if (hi < lo) return fail("Ungültiger Bereich");
+			for (int b = lo; b <= hi; ++b) setBit(set, (uint8_t)b);
+		} else {
+			setBit(set, (uint8_t)lo);
+		}
+	}
+	if (negate) {
+		for (size_t i = 0; i < 32; ++i) set[i] = (uint8_t)~set[i];
+	}
+	return emit(OP_CLASS, (uint8_t)cls);
+}
+
+/**
+ * @brief Liest eine Escape-Sequenz (Leseposition steht hinter '\').
+ *
+ * @param set Klasse, in die Kürzel wie `\d` eingetragen werden.
+ * @param single Einzelnes Zeichen oder -1, wenn ein Kürzel in `set` eingetragen wurde.
+ */
+bool SerialPattern::parseEscape(uint8_t *set, int &single) {
+	if (_pos >= _srcLen) return fail("'\\' am Ende");
+	char c = _src[_pos++];
+	single = -1;
+	if (shorthand(c, set)) return true;
+	switch (c) {
+		case 'r':
+			single = '\r';
+			return true;
+		case 'n':
+			single = '\n';
+			return true;
+		case 't':
+			single = '\t';
+			return true;
+		case 'x': {
+			int hi = _pos < _srcLen ? hexValue(_src[_pos]) : -1;
+			int lo = _pos + 1 < _srcLen ? hexValue(_src[_pos + 1]) : -1;
+			if (hi < 0 || lo < 0) return fail("Ungültiges \\x");
+			_pos += 2;
+			single = hi * 16 + lo;
+			return true;
+		}
+		default:
+			single = (uint8_t)c;
+			return true;
+	}
+}
+
+/**
+ * @brief Belegt eine leere Zeichenklasse.
+ *
+ * @return Index oder -1, wenn alle belegt sind.
+ */
+int SerialPattern::newClass() {
+	if (_classCount >= MAX_CLASSES) {
+		fail("Zu viele Zeichenklassen");
+		return -1;
+	}
+	memset(_classes[_classCount], 0, sizeof(_classes[0]));
+	return (int)_classCount++;
+}
+
+/**
+ * @brief Sucht den ersten Treffer.
+ *
+ * @param text Daten.
+ * @param len Länge der Daten.
+ * @param match Treffer mit Gruppen.
+ * @return true bei einem Treffer.
+ */
+bool SerialPattern::search(const uint8_t *text, size_t len, SerialPatternMatch &match) const {
+	_exhausted = false;
+	if (len > MAX_TEXT) len = MAX_TEXT;
+	if (_isLiteral) {
+		for (size_t i = 0; i + _literalLen <= len; ++i) {
+			if (text[i] == (uint8_t)_literal[0] && memcmp(text + i, _literal, _literalLen) == 0) {
+				match.start[0] = (uint16_t)i;
+				match.end[0] = (uint16_t)(i + _literalLen);
+				match.groups = 1;
+				return true;
+			}
+		}
+		return false;
+	}
+	if (_len == 0) return false;
+
+	// Beginnt der Ausdruck mit einem festen Zeichen, werden andere Startpositionen übersprungen
+	int first = _prog[1].op == OP_CHAR ? _prog[1].arg : -1;
+	uint16_t caps[2 * SerialPatternMatch::MAX_GROUPS + MAX_LOOPS];
+	uint32_t steps = 0;
+	for (size_t startPos = 0; startPos <= len; ++startPos) {
+		if (first >= 0 && (startPos == len || text[startPos] != first)) continue;
+		for (size_t i = 0; i < sizeof(caps) / sizeof(caps[0]); ++i) caps[i] = SerialPatternMatch::UNSET;
+		if (run(text, len, startPos, caps, steps)) {
+			for (size_t g = 0; g < _groups; ++g) {
+				bool set = caps[2 * g] != SerialPatternMatch::UNSET && caps[2 * g + 1] != SerialPatternMatch::UNSET;
+				match.start[g] = set ? caps[2 * g] : SerialPatternMatch::UNSET;
+				match.end[g] = set ? caps[2 * g + 1] : SerialPatternMatch::UNSET;
+			}
+			match.groups = _groups;
+			return true;
+		}
+		if (_exhausted) return false;
+	}
+	return false;
+}
+
+/**
+ * @brief Führt das Programm ab einer Startposition aus.
+ *
+ * @param text Daten.
+ * @param len Länge der Daten.
+ * @param startPos Startposition.
+ * @param caps Gruppenslots.
+ * @param steps Bisher verbrauchte Schritte (über alle Startpositionen).
+ * @return true bei einem Treffer.
+ */
+bool SerialPattern::run(const uint8_t *text, size_t len, size_t startPos, uint16_t *caps, uint32_t &steps) const {
+	size_t top = 0;
+	_stack[top++] = {0, (uint16_t)startPos, FRAME_BRANCH};
+	while (top > 0) {
+		Frame f = _stack[--top];
+		if (f.slot != FRAME_BRANCH) {
+			caps[f.slot] = f.pc;
+			continue;
+		}
+		size_t pc = f.pc, sp = f.sp;
+		for (;;) {
+			if (++steps > MAX_STEPS) {
+				_exhausted = true;
+				return false;
+			}
+			const Instr &in = _prog[pc];
+			switch (in.op) {
+				case OP_CHAR:
+					if (sp < len && text[sp] == in.arg) {
+						pc++;
+						sp++;
+						continue;
+					}
+					break;
+				case OP_ANY:
+					if (sp < len && text[sp] != '\n') {
+						pc++;
+						sp++;
+						continue;
+					}
+					break;
+				case OP_CLASS:
+					if (sp < len && hasBit(_classes[in.arg], text[sp])) {
+						pc++;
+						sp++;
+						continue;
+					}
+					break;
+				case OP_BOL:
+					if (sp == 0 || text[sp - 1] == '\n') {
+						pc++;
+						continue;
+					}
+					break;
+				case OP_EOL:
+					if (sp == len || text[sp] == '\n' || text[sp] == '\r') {
+						pc++;
+						continue;
+					}
+					break;
+				case OP_SPLIT:
+					if (top >= MAX_BACKTRACK) {
+						_exhausted = true;
+						return false;
+					}
+					_stack[top++] = {in.y, (uint16_t)sp, FRAME_BRANCH};
+					pc = in.x;
+					continue;
+				case OP_JMP:
+					pc = in.x;
+					continue;
+				case OP_CHECK:
+					if (caps[in.arg] != sp) {
+						pc++;
+						continue;
+					}
+					break;
+				case OP_SAVE:
+				case OP_MARK:
+					if (top >= MAX_BACKTRACK) {
+						_exhausted = true;
+						return false;
+					}
+					_stack[top++] = {caps[in.arg], 0, in.arg};
+					caps[in.arg] = (uint16_t)sp;
+					pc++;
+					continue;
+				case OP_MATCH:
+					return true;
+			}
+			break;
+		}
+	}
+	return false;
+}
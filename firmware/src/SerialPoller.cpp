@@ -0,0 +1,343 @@
+/**
+ * @file SerialPoller.cpp
+ * @brief Zeitplan der zyklischen Abfragen, Auswertung der Antworten und Feldspeicher.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialPoller.h"
+
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param send Sende-Callback.
+ * @param update Änderungs-Callback (darf nullptr sein).
+ * @param ctx Benutzerkontext beider Callbacks.
+ */
+SerialPoller::SerialPoller(SendFn send, UpdateFn update, void *ctx)
+    : _send(send), _update(update), _ctx(ctx), _active(SerialPollerConfig::MAX_POLLS), _sentMs(0), _fieldCount(0) {
+	memset(&_cfg, 0, sizeof(_cfg));
+	memset(_map, 0, sizeof(_map));
+	memset(_due, 0, sizeof(_due));
+	memset(_fields, 0, sizeof(_fields));
+	memset(_stats, 0, sizeof(_stats));
+}
+
+/**
+ * @brief Prüft einen Namen: nicht leer und nullterminiert innerhalb von MAX_NAME.
+ */
+static bool validName(const char *name) {
+	size_t len = strnlen(name, SerialPollEntry::MAX_NAME);
+	return len > 0 && len < SerialPollEntry::MAX_NAME;
+}
+
+/**
+ * @brief Prüft eine Konfiguration vollständig.
+ *
+ * Jeder Ausdruck wird probeweise übersetzt; er muss mindestens so viele Gruppen haben, wie
+ * die Abfrage Felder nennt. Über alle Abfragen hinweg sind höchstens MAX_FIELDS verschiedene
+ * Feldnamen erlaubt (ein Name darf in mehreren Abfragen vorkommen).
+ *
+ * @param cfg Konfiguration.
+ * @param error Puffer für die Fehlerbeschreibung.
+ * @param size Größe des Puffers.
+ * @return true, wenn configure() sie übernehmen kann.
+ */
+bool SerialPoller::validate(const SerialPollerConfig &cfg, char *error, size_t size) {
+	if (cfg.count > SerialPollerConfig::MAX_POLLS) {
+		snprintf(error, size, "Zu viele Abfragen");
+		return false;
+	}
+	const char *names[MAX_FIELDS];
+	size_t distinct = 0;
+	SerialPattern *pattern = new SerialPattern();
+	bool ok = true;
+	for (size_t i = 0; ok && i < cfg.count; ++i) {
+		const SerialPollEntry &e = cfg.polls[i];
+		const char *label = validName(e.name) ? e.name : "?";
+		ok = false;
+		if (!validName(e.name)) {
+			snprintf(error, size, "Abfrage %u: Name fehlt", (unsigned)(i + 1));
+		} else if (e.requestLen == 0 || e.requestLen > SerialPollEntry::MAX_REQUEST) {
+			snprintf(error, size, "%s: Abfragetext fehlt oder ist zu lang", label);
+		} else if (e.intervalMs < MIN_INTERVAL_MS) {
+			snprintf(error, size, "%s: Abstand unter %u ms", label, (unsigned)MIN_INTERVAL_MS);
+		} else if (e.timeoutMs == 0 || e.timeoutMs > MAX_TIMEOUT_MS) {
+			snprintf(error, size, "%s: Ungültige Antwortzeit", label);
+		} else if (strnlen(e.pattern, SerialPollEntry::MAX_PATTERN) >= SerialPollEntry::MAX_PATTERN) {
+			snprintf(error, size, "%s: Ausdruck zu lang", label);
+		} else if (!pattern->compile(e.pattern, strlen(e.pattern))) {
+			snprintf(error, size, "%s: %s", label, pattern->error());
+		} else if (e.fieldCount > SerialPollEntry::MAX_FIELDS || e.fieldCount + 1 > pattern->groups()) {
+			snprintf(error, size, "%s: Mehr Felder als Gruppen", label);
+		} else {
+			ok = true;
+		}
+		for (size_t j = 0; ok && j < i; ++j) {
+			if (strcmp(cfg.polls[j].name, e.name) == 0) {
+				snprintf(error, size, "%s: Name doppelt", label);
+				ok = false;
+			}
+		}
+		for (size_t k = 0; ok && k < e.fieldCount; ++k) {
+			if (!validName(e.fields[k])) {
+				snprintf(error, size, "%s: Feldname fehlt", label);
+				ok = false;
+				break;
+			}
+			size_t n = 0;
+			while (n < distinct && strcmp(names[n], e.fields[k]) != 0) ++n;
+			if (n < distinct) continue;
+			if (distinct >= MAX_FIELDS) {
+				snprintf(error, size, "Zu viele Felder");
+				ok = false;
+				break;
+			}
+			names[distinct++] = e.fields[k];
+		}
+	}
+	delete pattern;
+	if (ok && size > 0) error[0] = '\0';
+	return ok;
+}
+
+/**
+ * @brief Übernimmt eine geprüfte Konfiguration.
+ *
+ * Felder, deren Namen weiter vorkommen, behalten Wert und Zähler; die übrigen entfallen. Die
+ * Indizes werden dabei neu vergeben.
+ *
+ * @param cfg Konfiguration.
+ * @param nowMs Aktuelle Zeit in ms.
+ */
+void SerialPoller::configure(const SerialPollerConfig &cfg, uint32_t nowMs) {
+	_cfg = cfg;
+	_active = SerialPollerConfig::MAX_POLLS;
+	for (size_t i = 0; i < SerialPollerConfig::MAX_POLLS; ++i) _due[i] = nowMs;
+
+	_lock.enter();
+	// 1) Weiter benutzte Felder nach vorn schieben
+	size_t kept = 0;
+	for (size_t f = 0; f < _fieldCount; ++f) {
+		bool used = false;
+		for (size_t i = 0; !used && i < _cfg.count; ++i) {
+			for (size_t k = 0; k < _cfg.polls[i].fieldCount; ++k) {
+				if (strcmp(_cfg.polls[i].fields[k], _fields[f].name) == 0) {
+					used = true;
+					break;
+				}
+			}
+		}
+		if (!used) continue;
+		if (kept != f) _fields[kept] = _fields[f];
+		kept++;
+	}
+	_fieldCount = kept;
+
+	// 2) Gruppen den Feldern zuordnen, neue Namen anhängen
+	for (size_t i = 0; i < _cfg.count; ++i) {
+		for (size_t k = 0; k < _cfg.polls[i].fieldCount; ++k) {
+			const char *name = _cfg.polls[i].fields[k];
+			size_t f = 0;
+			while (f < _fieldCount && strcmp(_fields[f].name, name) != 0) ++f;
+			if (f == _fieldCount) {
+				memset(&_fields[f], 0, sizeof(_fields[f]));
+				strncpy(_fields[f].name, name, sizeof(_fields[f].name) - 1);
+				_fieldCount++;
+			}
+			_map[i][k] = (uint8_t)f;
+		}
+	}
+	memset(_stats, 0, sizeof(_stats));
+	_lock.exit();
+}
+
+/**
+ * @brief Gibt die aktive Konfiguration zurück (nur Bridge-Task).
+ */
+const SerialPollerConfig &SerialPoller::config() const {
+	return _cfg;
+}
+
+/**
+ * @brief Wertet die wartende Abfrage als unbeantwortet: ihre Felder werden veraltet.
+ */
+void SerialPoller::expire() {
+	const SerialPollEntry &e = _cfg.polls[_active];
+	uint32_t changed = 0;
+	_lock.enter();
+	_stats[_active].timeouts++;
+	for (size_t k = 0; k < e.fieldCount; ++k) {
+		SerialPollField &f = _fields[_map[_active][k]];
+		if (!f.stale) {
+			f.stale = true;
+			changed |= 1UL << _map[_active][k];
+		}
+	}
+	_lock.exit();
+	_active = SerialPollerConfig::MAX_POLLS;
+	if (changed && _update) _update(_ctx, changed);
+}
+
+/**
+ * @brief Verwaltet Antwortzeit und Zeitplan.
+ *
+ * Ist keine Abfrage unterwegs, wird die am längsten fällige gesendet und ihr nächster Termin
+ * ein Intervall später gesetzt; verpasste Termine werden nicht nachgeholt.
+ *
+ * @param nowMs Aktuelle Zeit in ms.
+ * @param mayStart false, solange keine neue Abfrage gesendet werden darf.
+ * @return Zeit bis zur nächsten Aktion in ms (UINT32_MAX = nichts zu tun).
+ */
+uint32_t SerialPoller::service(uint32_t nowMs, bool mayStart) {
+	if (_active < _cfg.count && (int32_t)(nowMs - _sentMs - _cfg.polls[_active].timeoutMs) >= 0) expire();
+	if (_cfg.count == 0) return UINT32_MAX;
+
+	if (_active >= _cfg.count && mayStart) {
+		size_t pick = SerialPollerConfig::MAX_POLLS;
+		int32_t most = -1;
+		for (size_t i = 0; i < _cfg.count; ++i) {
+			int32_t late = (int32_t)(nowMs - _due[i]);
+			if (late > most) {
+				most = late;
+				pick = i;
+			}
+		}
+		if (pick < _cfg.count) {
+			const SerialPollEntry &e = _cfg.polls[pick];
+			if (!_send(_ctx, e.request, e.requestLen)) return SEND_RETRY_MS;
+			// validate() hat den Ausdruck geprüft, die Übersetzung kann hier nicht scheitern
+			_pattern.compile(e.pattern, strlen(e.pattern));
+			_active = pick;
+			_sentMs = nowMs;
+			_due[pick] = nowMs + e.intervalMs;
+			_lock.enter();
+			_stats[pick].requests++;
+			_lock.exit();
+		}
+	}
+
+	if (_active < _cfg.count) {
+		uint32_t waited = nowMs - _sentMs;
+		uint32_t timeout = _cfg.polls[_active].timeoutMs;
+		return waited >= timeout ? 0 : timeout - waited;
+	}
+	if (!mayStart) return UINT32_MAX;
+	uint32_t wait = UINT32_MAX;
+	for (size_t i = 0; i < _cfg.count; ++i) {
+		int32_t left = (int32_t)(_due[i] - nowMs);
+		uint32_t w = left > 0 ? (uint32_t)left : 0;
+		if (w < wait) wait = w;
+	}
+	return wait;
+}
+
+/**
+ * @brief Prüft einen Datensatz gegen den Ausdruck der wartenden Abfrage.
+ *
+ * Nicht beteiligte Gruppen lassen ihr Feld unverändert. Ein Feld gilt als geändert, wenn sich
+ * der Wert ändert, es den ersten Wert bekommt oder nicht mehr veraltet ist.
+ *
+ * @param data Datensatz.
+ * @param len Länge des Datensatzes.
+ * @param nowMs Aktuelle Zeit in ms.
+ * @return true, wenn der Datensatz die Antwort war.
+ */
+bool SerialPoller::onRecord(const uint8_t *data, size_t len, uint32_t nowMs) {
+	if (_active >= _cfg.count) return false;
+	SerialPatternMatch match;
+	if (!_pattern.search(data, len, match)) return false;
+
+	const SerialPollEntry &e = _cfg.polls[_active];
+	uint32_t changed = 0;
+	_lock.enter();
+	for (size_t k = 0; k < e.fieldCount && k + 1 < match.groups; ++k) {
+		if (match.start[k + 1] == SerialPatternMatch::UNSET) continue;
+		size_t idx = _map[_active][k];
+		SerialPollField &f = _fields[idx];
+		size_t n = match.end[k + 1] - match.start[k + 1];
+		if (n >= sizeof(f.value)) n = sizeof(f.value) - 1;
+		const char *value = (const char *)data + match.start[k + 1];
+		if (!f.set || strncmp(f.value, value, n) != 0 || f.value[n] != '\0') {
+			memcpy(f.value, value, n);
+			f.value[n] = '\0';
+			f.set = true;
+			f.changes++;
+			changed |= 1UL << idx;
+		}
+		if (f.stale) {
+			f.stale = false;
+			changed |= 1UL << idx;
+		}
+		f.updatedMs = nowMs;
+	}
+	_stats[_active].replies++;
+	_stats[_active].lastRttMs = nowMs - _sentMs;
+	_lock.exit();
+	_active = SerialPollerConfig::MAX_POLLS;
+	if (changed && _update) _update(_ctx, changed);
+	return true;
+}
+
+/**
+ * @brief Anzahl der Felder.
+ */
+size_t SerialPoller::fieldCount() const {
+	_lock.enter();
+	size_t n = _fieldCount;
+	_lock.exit();
+	return n;
+}
+
+/**
+ * @brief Kopiert ein Feld.
+ *
+ * @param index Feldindex.
+ * @param out Ziel.
+ * @return false bei ungültigem Index.
+ */
+bool SerialPoller::field(size_t index, SerialPollField &out) const {
+	_lock.enter();
+	bool ok = index < _fieldCount;
+	if (ok) out = _fields[index];
+	_lock.exit();
+	return ok;
+}
+
+/**
+ * @brief Sucht ein Feld nach Namen.
+ *
+ * @param name Feldname.
+ * @return Index oder NO_FIELD.
+ */
+size_t SerialPoller::findField(const char *name) const {
+	size_t found = NO_FIELD;
+	_lock.enter();
+	for (size_t f = 0; f < _fieldCount; ++f) {
+		if (strcmp(_fields[f].name, name) == 0) {
+			found = f;
+			break;
+		}
+	}
+	_lock.exit();
+	return found;
+}
+
+/**
+ * @brief Kopiert die Zähler einer Abfrage.
+ *
+ * @param index Index der Abfrage.
+ * @param out Ziel.
+ * @return false bei ungültigem Index.
+ */
+bool SerialPoller::stats(size_t index, SerialPollStats &out) const {
+	if (index >= SerialPollerConfig::MAX_POLLS) return false;
+	_lock.enter();
+	out = _stats[index];
+	_lock.exit();
+	return true;
+}
@@ -0,0 +1,484 @@
+/**
+ * @file SerialRecorder.cpp
+ * @brief Doppelpuffer, Segmentrotation und Speicherquote für den Mitschnitt.
+ *
+ * Die Sperre schützt nur das Umschalten und Füllen der RAM-Puffer. Das Schreiben eines vollen
+ * Puffers, das Anlegen neuer Segmente und das Löschen alter Dateien laufen ohne Sperre in der
+ * Schreib-Task. Belegung und freier Platz werden mitgeführt, damit nicht bei jedem Schreiben
+ * das Dateisystem durchsucht werden muss.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialRecorder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+inline void putLe16(uint8_t *p, uint16_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+}
+
+inline void putLe32(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+inline void putLe64(uint8_t *p, uint64_t v) {
+	putLe32(p, (uint32_t)v);
+	putLe32(p + 4, (uint32_t)(v >> 32));
+}
+
+inline uint16_t getLe16(const uint8_t *p) {
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t getLe32(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint64_t getLe64(const uint8_t *p) {
+	return (uint64_t)getLe32(p) | ((uint64_t)getLe32(p + 4) << 32);
+}
+
+}  // namespace
+
+/**
+ * @brief Liest einen Datensatzkopf aus `in`.
+ *
+ * @param in Daten ab Datensatzbeginn.
+ * @param len Verfügbare Bytes.
+ * @param hdr Ausgabeparameter.
+ * @return false bei zu wenigen Bytes.
+ */
+bool decodeCaptureRecordHeader(const uint8_t *in, size_t len, CaptureRecordHeader &hdr) {
+	if (len < CAPTURE_RECORD_HEADER_LEN) return false;
+	hdr.dir = in[0];
+	hdr.flags = in[1];
+	hdr.len = getLe16(in + 2);
+	hdr.seq = getLe32(in + 4);
+	hdr.timestamp = getLe64(in + 8);
+	return true;
+}
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param store Ablage der Segmentdateien.
+ */
+SerialRecorder::SerialRecorder(CaptureStore &store)
+    : _store(store),
+      _wake(nullptr),
+      _wakeCtx(nullptr),
+      _fill(0),
+      _ready(NO_BUFFER),
+      _firstAt(0),
+      _gap(false),
+      _seq(0),
+      _state(STATE_IDLE),
+      _stopRequested(false),
+      _error(""),
+      _epoch(0),
+      _startMs(0),
+      _segmentIndex(0),
+      _segmentBytes(0),
+      _segmentStart(0),
+      _used(0),
+      _free(0),
+      _stats() {
+	_buf[0] = _buf[1] = nullptr;
+	_len[0] = _len[1] = 0;
+	_session[0] = '\0';
+	_segment[0] = '\0';
+	_config.maxFileBytes = DEFAULT_MAX_FILE_BYTES;
+	_config.maxFileAgeMs = DEFAULT_MAX_FILE_AGE_MS;
+	_config.quotaBytes = DEFAULT_QUOTA_BYTES;
+}
+
+/**
+ * @brief Gibt die Puffer frei.
+ */
+SerialRecorder::~SerialRecorder() {
+	free(_buf[0]);
+	free(_buf[1]);
+}
+
+/**
+ * @brief Registriert den Weck-Callback der Schreib-Task.
+ *
+ * @param fn Callback.
+ * @param ctx Kontext.
+ */
+void SerialRecorder::onWake(WakeFn fn, void *ctx) {
+	_wake = fn;
+	_wakeCtx = ctx;
+}
+
+/**
+ * @brief Prüft Sitzungsname und Einstellungen.
+ *
+ * @param session Sitzungsname.
+ * @param config Rotation und Quote.
+ * @return true, wenn beides zulässig ist.
+ */
+bool SerialRecorder::validate(const char *session, const SerialRecorderConfig &config) {
+	size_t n = session ? strlen(session) : 0;
+	if (n == 0 || n > MAX_SESSION) return false;
+	for (size_t i = 0; i < n; ++i) {
+		char c = session[i];
+		bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+		if (!ok) return false;
+	}
+	if (config.maxFileBytes < CAPTURE_FILE_HEADER_LEN + BLOCK || config.maxFileAgeMs == 0) return false;
+	return config.quotaBytes >= 2 * config.maxFileBytes;
+}
+
+/**
+ * @brief Fordert einen neuen Mitschnitt an.
+ *
+ * Die Puffer werden beim ersten Start einmalig angelegt und danach wiederverwendet.
+ *
+ * @param session Sitzungsname.
+ * @param config Rotation und Quote.
+ * @param epoch Unix-Zeit für den Dateikopf.
+ * @return false bei ungültigen Parametern, fehlendem Speicher oder laufendem Mitschnitt.
+ */
+bool SerialRecorder::start(const char *session, const SerialRecorderConfig &config, uint32_t epoch) {
+	if (!validate(session, config)) return false;
+	if (!_buf[0]) {
+		uint8_t *a = static_cast<uint8_t *>(malloc(BLOCK));
+		uint8_t *b = static_cast<uint8_t *>(malloc(BLOCK));
+		if (!a || !b) {
+			free(a);
+			free(b);
+			return false;
+		}
+		_buf[0] = a;
+		_buf[1] = b;
+	}
+
+	_lock.enter();
+	if (_state != STATE_IDLE) {
+		_lock.exit();
+		return false;
+	}
+	strncpy(_session, session, MAX_SESSION);
+	_session[MAX_SESSION] = '\0';
+	_segment[0] = '\0';
+	_config = config;
+	_epoch = epoch;
+	_len[0] = _len[1] = 0;
+	_fill = 0;
+	_ready = NO_BUFFER;
+	_gap = false;
+	_seq = 0;
+	_error = "";
+	_stats = SerialRecorderStats();
+	_stopRequested = false;
+	_state = STATE_STARTING;
+	_lock.exit();
+
+	if (_wake) _wake(_wakeCtx);
+	return true;
+}
+
+/**
+ * @brief Fordert das Beenden an.
+ */
+void SerialRecorder::stop() {
+	_lock.enter();
+	bool running = _state != STATE_IDLE;
+	if (running) _stopRequested = true;
+	_lock.exit();
+	if (running && _wake) _wake(_wakeCtx);
+}
+
+/**
+ * @brief Übernimmt einen Datensatz in den aktiven Puffer.
+ *
+ * Passt er nicht mehr hinein, wird auf den zweiten Puffer umgeschaltet und die Schreib-Task
+ * geweckt. Schreibt diese noch am zweiten Puffer, geht der Datensatz verloren.
+ *
+ * @param dir Richtung.
+ * @param data Rohdaten.
+ * @param len Länge der Rohdaten.
+ * @param timestampUs Zeitstempel in µs seit Systemstart.
+ * @return false, wenn nicht aufgezeichnet oder verworfen wurde.
+ */
+bool SerialRecorder::append(CaptureDirection dir, const uint8_t *data, size_t len, uint64_t timestampUs) {
+	if (_state == STATE_IDLE) return false;
+	if (len > BLOCK - CAPTURE_RECORD_HEADER_LEN) len = BLOCK - CAPTURE_RECORD_HEADER_LEN;
+	size_t need = CAPTURE_RECORD_HEADER_LEN + len;
+	bool wake = false;
+
+	_lock.enter();
+	if (_state == STATE_IDLE || _stopRequested) {
+		_lock.exit();
+		return false;
+	}
+	uint32_t seq = _seq++;
+	if (_len[_fill] + need > BLOCK) {
+		if (_ready != NO_BUFFER) {
+			_stats.dropped++;
+			_stats.droppedBytes += (uint32_t)len;
+			_gap = true;
+			_lock.exit();
+			return false;
+		}
+		_ready = _fill;
+		_fill ^= 1;
+		_len[_fill] = 0;
+		wake = true;
+	}
+	if (_len[_fill] == 0) _firstAt = (uint32_t)(timestampUs / 1000);
+	uint8_t *p = _buf[_fill] + _len[_fill];
+	p[0] = (uint8_t)dir;
+	p[1] = _gap ? CAPTURE_FLAG_GAP : CAPTURE_FLAG_NONE;
+	putLe16(p + 2, (uint16_t)len);
+	putLe32(p + 4, seq);
+	putLe64(p + 8, timestampUs);
+	memcpy(p + CAPTURE_RECORD_HEADER_LEN, data, len);
+	_len[_fill] += need;
+	_gap = false;
+	_stats.records++;
+	_lock.exit();
+
+	if (wake && _wake) _wake(_wakeCtx);
+	return true;
+}
+
+/**
+ * @brief Arbeitet Anforderungen und volle Puffer ab.
+ *
+ * Öffnet bei einem angeforderten Start das erste Segment, schreibt einen vollen Puffer und
+ * tauscht einen nur teilweise gefüllten Puffer, wenn er älter als FLUSH_INTERVAL_MS ist oder
+ * gestoppt werden soll.
+ *
+ * @param now Aktuelle Zeit in ms.
+ * @return Millisekunden bis zum nächsten nötigen Aufruf.
+ */
+uint32_t SerialRecorder::service(uint32_t now) {
+	_lock.enter();
+	uint8_t state = _state;
+	bool stopping = _stopRequested;
+	_lock.exit();
+	if (state == STATE_IDLE) return UINT32_MAX;
+
+	if (state == STATE_STARTING) {
+		_used = _store.usedBytes();
+		_startMs = now;
+		_segmentIndex = 0;
+		if (!openSegment(now)) {
+			finish(_error);
+			return UINT32_MAX;
+		}
+		_lock.enter();
+		_state = STATE_RECORDING;
+		_lock.exit();
+	}
+
+	for (;;) {
+		_lock.enter();
+		int32_t age = (int32_t)(now - _firstAt);
+		if (_ready == NO_BUFFER && _len[_fill] > 0 && (stopping || age >= (int32_t)FLUSH_INTERVAL_MS)) {
+			_ready = _fill;
+			_fill ^= 1;
+			_len[_fill] = 0;
+		}
+		int idx = _ready;
+		size_t len = idx != NO_BUFFER ? _len[idx] : 0;
+		_lock.exit();
+		if (idx == NO_BUFFER) break;
+
+		bool ok = writeBlock(_buf[idx], len, now);
+		_lock.enter();
+		_ready = NO_BUFFER;
+		_lock.exit();
+		if (!ok) {
+			finish(_error);
+			return UINT32_MAX;
+		}
+	}
+
+	if (stopping) {
+		finish(nullptr);
+		return UINT32_MAX;
+	}
+
+	_lock.enter();
+	uint32_t wait = UINT32_MAX;
+	if (_len[_fill] > 0) {
+		int32_t age = (int32_t)(now - _firstAt);
+		if (age < 0) age = 0;
+		wait = age >= (int32_t)FLUSH_INTERVAL_MS ? 0 : FLUSH_INTERVAL_MS - (uint32_t)age;
+	}
+	_lock.exit();
+	return wait;
+}
+
+/**
+ * @brief true, solange aufgezeichnet wird.
+ */
+bool SerialRecorder::active() const {
+	return _state != STATE_IDLE;
+}
+
+/**
+ * @brief Name der laufenden bzw. letzten Sitzung.
+ */
+const char *SerialRecorder::session() const {
+	return _session;
+}
+
+/**
+ * @brief Name des aktuellen Segments.
+ */
+const char *SerialRecorder::segmentName() const {
+	return _segment;
+}
+
+/**
+ * @brief Grund des letzten Abbruchs.
+ */
+const char *SerialRecorder::lastError() const {
+	return _error;
+}
+
+/**
+ * @brief Aktive Einstellungen.
+ */
+SerialRecorderConfig SerialRecorder::config() const {
+	_lock.enter();
+	SerialRecorderConfig cfg = _config;
+	_lock.exit();
+	return cfg;
+}
+
+/**
+ * @brief Kopie der Zähler.
+ */
+SerialRecorderStats SerialRecorder::stats() const {
+	_lock.enter();
+	SerialRecorderStats s = _stats;
+	_lock.exit();
+	return s;
+}
+
+/**
+ * @brief Legt das Segment `_segmentIndex` an und schreibt den Dateikopf.
+ *
+ * @param now Aktuelle Zeit in ms.
+ * @return false, wenn kein Platz geschaffen oder die Datei nicht angelegt werden konnte.
+ */
+bool SerialRecorder::openSegment(uint32_t now) {
+	if (_segmentIndex == 0) {
+		snprintf(_segment, sizeof(_segment), "%s.cap", _session);
+	} else {
+		snprintf(_segment, sizeof(_segment), "%s.%u.cap", _session, (unsigned)_segmentIndex);
+	}
+	_free = _store.freeBytes();
+	if (!makeRoom(CAPTURE_FILE_HEADER_LEN)) return false;
+	if (!_store.open(_segment)) {
+		_error = "Segment konnte nicht angelegt werden";
+		return false;
+	}
+
+	uint8_t hdr[CAPTURE_FILE_HEADER_LEN];
+	memcpy(hdr, "HTCP", 4);
+	hdr[4] = CAPTURE_VERSION;
+	hdr[5] = (uint8_t)_segmentIndex;
+	putLe16(hdr + 6, 0);
+	putLe32(hdr + 8, _epoch ? _epoch + (now - _startMs) / 1000 : 0);
+	putLe32(hdr + 12, now);
+	if (_store.write(hdr, sizeof(hdr)) != sizeof(hdr)) {
+		_error = "Schreibfehler";
+		return false;
+	}
+
+	_segmentBytes = sizeof(hdr);
+	_segmentStart = now;
+	_used += sizeof(hdr);
+	_free = _free > sizeof(hdr) ? _free - sizeof(hdr) : 0;
+	_lock.enter();
+	_stats.segments++;
+	_stats.bytes += (uint32_t)sizeof(hdr);
+	_lock.exit();
+	return true;
+}
+
+/**
+ * @brief Schreibt einen Puffer; beginnt vorher ggf. ein neues Segment.
+ *
+ * @param data Pufferinhalt (ganze Datensätze).
+ * @param len Länge.
+ * @param now Aktuelle Zeit in ms.
+ * @return false bei Schreibfehler oder erschöpfter Quote (`_error` ist gesetzt).
+ */
+bool SerialRecorder::writeBlock(const uint8_t *data, size_t len, uint32_t now) {
+	bool hasData = _segmentBytes > CAPTURE_FILE_HEADER_LEN;
+	if (hasData && (_segmentBytes + len > _config.maxFileBytes || now - _segmentStart >= _config.maxFileAgeMs)) {
+		_store.close();
+		_segmentIndex++;
+		if (!openSegment(now)) return false;
+	}
+	if (!makeRoom(len)) return false;
+
+	size_t n = _store.write(data, len);
+	_segmentBytes += n;
+	_used += n;
+	_free = _free > n ? _free - n : 0;
+	_lock.enter();
+	_stats.bytes += (uint32_t)n;
+	_stats.flushes++;
+	_lock.exit();
+	if (n != len) {
+		_error = "Schreibfehler";
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Löscht die ältesten Mitschnitte, bis `len` Bytes in Quote und Dateisystem passen.
+ *
+ * @param len Benötigter Platz.
+ * @return false, wenn außer dem aktuellen Segment nichts mehr gelöscht werden kann.
+ */
+bool SerialRecorder::makeRoom(size_t len) {
+	while (_used + len > _config.quotaBytes || _free < len + FS_RESERVE_BYTES) {
+		size_t freed = _store.removeOldest(_segment);
+		if (freed == 0) {
+			_error = "Speicherquote erreicht";
+			return false;
+		}
+		_used = freed > _used ? 0 : _used - freed;
+		_free += freed;
+		_lock.enter();
+		_stats.deleted++;
+		_lock.exit();
+	}
+	return true;
+}
+
+/**
+ * @brief Schließt das Segment und beendet den Mitschnitt.
+ *
+ * @param error Abbruchgrund oder nullptr bei regulärem Ende.
+ */
+void SerialRecorder::finish(const char *error) {
+	_store.close();
+	_lock.enter();
+	_error = error ? error : "";
+	_len[0] = _len[1] = 0;
+	_ready = NO_BUFFER;
+	_stopRequested = false;
+	_state = STATE_IDLE;
+	_lock.exit();
+}
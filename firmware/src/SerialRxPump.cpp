@@ -0,0 +1,105 @@
+/**
+ * @file SerialRxPump.cpp
+ * @brief Implementierung des Empfangspfads der SerialBridge (Event-Queue oder Polling).
+ *
+ * Im Ereignisbetrieb schläft die Task so lange, bis der UART-Treiber Daten, einen Überlauf,
+ * ein Break oder ein erkanntes Zeilenende meldet. Dadurch entfällt die bis zu 5 ms lange
+ * Verzögerung pro Zeile und die CPU bleibt frei, solange das angeschlossene Gerät schweigt.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialRxPump.h"
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param port Zu überwachende UART.
+ * @param mode Betriebsart.
+ */
+SerialRxPump::SerialRxPump(UartPort &port, SerialRxMode mode) : _port(port), _mode(mode), _lastEvent(RX_EVT_NONE), _stats{0, 0, 0, 0, 0} {
+}
+
+/**
+ * @brief Wartet auf neue Daten und liest sie blockweise aus.
+ *
+ * @param buf Zielpuffer.
+ * @param cap Größe des Zielpuffers.
+ * @param timeoutMs Maximale Wartezeit im Ereignisbetrieb.
+ * @return Anzahl der gelesenen Bytes.
+ */
+size_t SerialRxPump::wait(uint8_t *buf, size_t cap, uint32_t timeoutMs) {
+	if (_port.available() == 0) {
+		if (_mode == SERIAL_RX_POLLING) {
+			_port.sleep(POLL_INTERVAL_MS);
+			_stats.wakeups++;
+			_lastEvent = _port.available() ? RX_EVT_DATA : RX_EVT_TIMEOUT;
+		} else {
+			UartEvent evt{RX_EVT_NONE, 0};
+			if (!_port.waitEvent(evt, timeoutMs)) evt.type = RX_EVT_TIMEOUT;
+			_stats.wakeups++;
+			_lastEvent = evt.type;
+
+			switch (evt.type) {
+				case RX_EVT_FIFO_OVERFLOW:
+				case RX_EVT_BUFFER_FULL:
+					// Daten sind ohnehin unvollständig: Eingang verwerfen und neu aufsetzen
+					_stats.overflows++;
+					_port.flushInput();
+					return 0;
+				case RX_EVT_BREAK:
+					_stats.breaks++;
+					break;
+				case RX_EVT_PATTERN:
+					_stats.patterns++;
+					break;
+				default:
+					break;
+			}
+		}
+	} else {
+		_lastEvent = RX_EVT_DATA;
+	}
+
+	size_t avail = _port.available();
+	if (avail == 0) return 0;
+	size_t n = _port.read(buf, avail < cap ? avail : cap);
+	_stats.bytes += n;
+	return n;
+}
+
+/**
+ * @brief Typ des zuletzt verarbeiteten Ereignisses.
+ */
+UartEventType SerialRxPump::lastEvent() const {
+	return _lastEvent;
+}
+
+/**
+ * @brief Gibt die aktuelle Betriebsart zurück.
+ */
+SerialRxMode SerialRxPump::mode() const {
+	return _mode;
+}
+
+/**
+ * @brief Gibt die gesammelten Zähler zurück.
+ */
+const SerialRxStats &SerialRxPump::stats() const {
+	return _stats;
+}
+
+/**
+ * @brief Berechnet die Größe des Treiber-Ringpuffers aus der Baudrate.
+ *
+ * @param baud Höchste Baudrate, die der Puffer abdecken soll.
+ * @return Puffergröße in Bytes (Zweierpotenz).
+ */
+size_t SerialRxPump::rxBufferSizeFor(uint32_t baud) {
+	// 8N1: 10 Bit pro Byte
+	size_t needed = (size_t)((uint64_t)baud * RX_BUFFER_HEADROOM_MS / 10000);
+	size_t size = RX_BUFFER_MIN;
+	while (size < needed && size < RX_BUFFER_MAX) size <<= 1;
+	return size;
+}
@@ -0,0 +1,423 @@
+/**
+ * @file SerialScript.cpp
+ * @brief Übersetzer für Befehlsskripte (siehe SerialScript.h für die Syntax).
+ *
+ * Sprungmarken dürfen vor ihrer Definition verwendet werden; Verweise werden zunächst auf den
+ * Index in der Markentabelle gesetzt und nach der letzten Zeile auf den Schrittindex
+ * umgeschrieben.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialScript.h"
+
+#include <cstring>
+
+/**
+ * @brief Zeichen eines Namens (Marke, Feld, Befehl).
+ */
+static inline bool isNameChar(char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/**
+ * @brief Vergleicht ein gelesenes Wort mit einem Schlüsselwort.
+ */
+static inline bool is(const char *word, size_t len, const char *keyword) {
+	return strlen(keyword) == len && memcmp(word, keyword, len) == 0;
+}
+
+/**
+ * @brief Wert einer Hex-Ziffer (-1 bei ungültiger Ziffer).
+ */
+static int hexDigit(char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+/**
+ * @brief Konstruktor; startet mit einem leeren Skript.
+ */
+SerialScript::SerialScript()
+    : _stepCount(0), _textLen(0), _labelCount(0), _fieldCount(0), _error(""), _errorLine(0), _line(nullptr), _lineLen(0), _pos(0) {
+}
+
+/**
+ * @brief Übersetzt einen Skripttext.
+ *
+ * @param source Skripttext.
+ * @param len Länge des Textes.
+ * @return false bei einem Fehler.
+ */
+bool SerialScript::parse(const char *source, size_t len) {
+	_stepCount = 0;
+	_textLen = 0;
+	_labelCount = 0;
+	_fieldCount = 0;
+	_error = "";
+	_errorLine = 0;
+
+	uint16_t lineNo = 0;
+	size_t i = 0;
+	while (i < len) {
+		size_t end = i;
+		while (end < len && source[end] != '\n') end++;
+		lineNo++;
+		_line = source + i;
+		_lineLen = end - i;
+		if (_lineLen > 0 && _line[_lineLen - 1] == '\r') _lineLen--;
+		_pos = 0;
+		if (!parseLine(lineNo)) {
+			_errorLine = lineNo;
+			_stepCount = 0;
+			return false;
+		}
+		i = end + 1;
+	}
+
+	// Sprungziele von Markenindex auf Schrittindex umschreiben
+	for (size_t s = 0; s < _stepCount; ++s) {
+		SerialScriptStep &st = _steps[s];
+		if (st.target < 0) continue;
+		const Label &lbl = _labels[st.target];
+		if (lbl.step < 0) {
+			_errorLine = lbl.line;
+			_stepCount = 0;
+			return fail("Sprungmarke nicht definiert");
+		}
+		st.target = lbl.step;
+	}
+	return true;
+}
+
+/**
+ * @brief Gibt die Anzahl der Schritte zurück.
+ */
+size_t SerialScript::stepCount() const {
+	return _stepCount;
+}
+
+/**
+ * @brief Gibt einen Schritt zurück.
+ */
+const SerialScriptStep &SerialScript::step(size_t index) const {
+	return _steps[index];
+}
+
+/**
+ * @brief Zeiger auf den Text eines Schritts.
+ */
+const char *SerialScript::text(const SerialScriptStep &step) const {
+	return _text + step.text;
+}
+
+/**
+ * @brief Gibt die Anzahl der Felder zurück.
+ */
+size_t SerialScript::fieldCount() const {
+	return _fieldCount;
+}
+
+/**
+ * @brief Name eines Feldes.
+ */
+const char *SerialScript::fieldName(size_t index) const {
+	return _fields[index];
+}
+
+/**
+ * @brief Fehlerbeschreibung der letzten parse().
+ */
+const char *SerialScript::error() const {
+	return _error;
+}
+
+/**
+ * @brief Zeile des letzten Fehlers.
+ */
+uint16_t SerialScript::errorLine() const {
+	return _errorLine;
+}
+
+/**
+ * @brief Merkt eine Fehlerbeschreibung.
+ *
+ * @return Immer false.
+ */
+bool SerialScript::fail(const char *msg) {
+	if (_error[0] == '\0') _error = msg;
+	return false;
+}
+
+/**
+ * @brief Übersetzt eine Zeile: leer, Kommentar, Sprungmarke oder Schritt.
+ */
+bool SerialScript::parseLine(uint16_t lineNo) {
+	skipSpace();
+	if (atEnd()) return true;
+
+	const char *w;
+	size_t wl;
+	if (!word(w, wl)) return fail("Befehl erwartet");
+
+	// Sprungmarke
+	if (_pos < _lineLen && _line[_pos] == ':') {
+		_pos++;
+		int idx = label(w, wl, lineNo);
+		if (idx < 0) return false;
+		if (_labels[idx].step >= 0) return fail("Sprungmarke doppelt definiert");
+		_labels[idx].step = (int16_t)_stepCount;
+		skipSpace();
+		return atEnd() ? true : fail("Zeichen nach Sprungmarke");
+	}
+
+	if (_stepCount >= MAX_STEPS) return fail("Zu viele Schritte");
+	SerialScriptStep &st = _steps[_stepCount];
+	memset(&st, 0, sizeof(st));
+	st.line = lineNo;
+	st.target = -1;
+	st.field = NO_FIELD;
+	memset(st.captures, NO_FIELD, sizeof(st.captures));
+
+	const char *name;
+	size_t nameLen;
+	skipSpace();
+	if (is(w, wl, "send")) {
+		st.op = SCRIPT_OP_SEND;
+		if (!quoted(st.text, st.textLen)) return false;
+		if (st.textLen == 0) return fail("Leerer Sendetext");
+	} else if (is(w, wl, "expect")) {
+		st.op = SCRIPT_OP_EXPECT;
+		if (_pos < _lineLen && _line[_pos] == '/') {
+			st.regex = true;
+			if (!regex(st.text, st.textLen)) return false;
+		} else if (!quoted(st.text, st.textLen)) {
+			return false;
+		}
+		if (st.textLen == 0) return fail("Leeres Muster");
+		st.arg = DEFAULT_TIMEOUT_MS;
+		skipSpace();
+		if (_pos < _lineLen && _line[_pos] >= '0' && _line[_pos] <= '9' && !number(st.arg, MAX_WAIT_MS)) return false;
+		size_t n = 0;
+		for (;;) {
+			skipSpace();
+			if (!word(name, nameLen)) break;
+			if (is(name, nameLen, "else")) {
+				skipSpace();
+				if (!word(name, nameLen)) return fail("Sprungmarke erwartet");
+				int idx = label(name, nameLen, lineNo);
+				if (idx < 0) return false;
+				st.target = (int16_t)idx;
+				break;
+			}
+			if (n >= sizeof(st.captures)) return fail("Zu viele Felder");
+			int f = field(name, nameLen);
+			if (f < 0) return false;
+			st.captures[n++] = (uint8_t)f;
+		}
+	} else if (is(w, wl, "wait")) {
+		st.op = SCRIPT_OP_WAIT;
+		if (!number(st.arg, MAX_WAIT_MS)) return false;
+	} else if (is(w, wl, "flush")) {
+		st.op = SCRIPT_OP_FLUSH;
+	} else if (is(w, wl, "done")) {
+		st.op = SCRIPT_OP_DONE;
+	} else if (is(w, wl, "goto") || is(w, wl, "retry")) {
+		st.op = w[0] == 'g' ? SCRIPT_OP_GOTO : SCRIPT_OP_RETRY;
+		if (!word(name, nameLen)) return fail("Sprungmarke erwartet");
+		int idx = label(name, nameLen, lineNo);
+		if (idx < 0) return false;
+		st.target = (int16_t)idx;
+		if (st.op == SCRIPT_OP_RETRY) {
+			skipSpace();
+			if (!number(st.arg, 255)) return false;
+		}
+	} else if (is(w, wl, "if")) {
+		st.op = SCRIPT_OP_IF;
+		if (!word(name, nameLen)) return fail("Feldname erwartet");
+		int f = field(name, nameLen);
+		if (f < 0) return false;
+		st.field = (uint8_t)f;
+		skipSpace();
+		if (_pos < _lineLen && _line[_pos] == '"' && !quoted(st.text, st.textLen)) return false;
+		skipSpace();
+		if (!word(name, nameLen)) return fail("Sprungmarke erwartet");
+		int idx = label(name, nameLen, lineNo);
+		if (idx < 0) return false;
+		st.target = (int16_t)idx;
+	} else if (is(w, wl, "fail")) {
+		st.op = SCRIPT_OP_FAIL;
+		if (_pos < _lineLen && _line[_pos] == '"' && !quoted(st.text, st.textLen)) return false;
+	} else {
+		return fail("Unbekannter Befehl");
+	}
+
+	skipSpace();
+	if (!atEnd()) return fail("Unerwartete Zeichen am Zeilenende");
+	_stepCount++;
+	return true;
+}
+
+/**
+ * @brief Überspringt Leerzeichen und Tabulatoren.
+ */
+void SerialScript::skipSpace() {
+	while (_pos < _lineLen && (_line[_pos] == ' ' || _line[_pos] == '\t')) _pos++;
+}
+
+/**
+ * @brief true am Zeilenende oder vor einem Kommentar.
+ */
+bool SerialScript::atEnd() {
+	return _pos >= _lineLen || _line[_pos] == '#';
+}
+
+/**
+ * @brief Liest einen Namen aus Buchstaben, Ziffern und '_'.
+ *
+ * @return false, wenn an der Leseposition kein Name steht.
+ */
+bool SerialScript::word(const char *&start, size_t &len) {
+	start = _line + _pos;
+	size_t begin = _pos;
+	while (_pos < _lineLen && isNameChar(_line[_pos])) _pos++;
+	len = _pos - begin;
+	return len > 0;
+}
+
+/**
+ * @brief Liest eine Dezimalzahl.
+ *
+ * @param value Gelesener Wert.
+ * @param max Obergrenze.
+ */
+bool SerialScript::number(uint32_t &value, uint32_t max) {
+	size_t begin = _pos;
+	uint32_t v = 0;
+	while (_pos < _lineLen && _line[_pos] >= '0' && _line[_pos] <= '9') {
+		v = v * 10 + (uint32_t)(_line[_pos] - '0');
+		if (v > max) return fail("Zahl zu groß");
+		_pos++;
+	}
+	if (_pos == begin) return fail("Zahl erwartet");
+	value = v;
+	return true;
+}
+
+/**
+ * @brief Liest einen Text in Anführungszeichen und legt ihn mit aufgelösten Escapes ab.
+ *
+ * @param offset Offset im Textspeicher.
+ * @param len Länge des abgelegten Textes.
+ */
+bool SerialScript::quoted(uint16_t &offset, uint16_t &len) {
+	if (_pos >= _lineLen || _line[_pos] != '"') return fail("Text in \"...\" erwartet");
+	_pos++;
+	offset = (uint16_t)_textLen;
+	for (;;) {
+		if (_pos >= _lineLen) return fail("Anführungszeichen fehlt");
+		char c = _line[_pos++];
+		if (c == '"') break;
+		if (c == '\\') {
+			if (_pos >= _lineLen) return fail("Anführungszeichen fehlt");
+			char e = _line[_pos++];
+			switch (e) {
+				case 'r':
+					c = '\r';
+					break;
+				case 'n':
+					c = '\n';
+					break;
+				case 't':
+					c = '\t';
+					break;
+				case 'x': {
+					int hi = _pos < _lineLen ? hexDigit(_line[_pos]) : -1;
+					int lo = _pos + 1 < _lineLen ? hexDigit(_line[_pos + 1]) : -1;
+					if (hi < 0 || lo < 0) return fail("Ungültiges \\x");
+					_pos += 2;
+					c = (char)(hi * 16 + lo);
+					break;
+				}
+				default:
+					c = e;
+					break;
+			}
+		}
+		if (_textLen >= MAX_TEXT) return fail("Skripttexte zu lang");
+		_text[_textLen++] = c;
+	}
+	len = (uint16_t)(_textLen - offset);
+	return true;
+}
+
+/**
+ * @brief Liest einen Ausdruck zwischen '/' und legt ihn unverändert ab (`\/` bleibt maskiert).
+ *
+ * @param offset Offset im Textspeicher.
+ * @param len Länge des Ausdrucks.
+ */
+bool SerialScript::regex(uint16_t &offset, uint16_t &len) {
+	_pos++;
+	offset = (uint16_t)_textLen;
+	for (;;) {
+		if (_pos >= _lineLen) return fail("Abschließendes '/' fehlt");
+		char c = _line[_pos++];
+		if (c == '/') break;
+		if (_textLen + 2 > MAX_TEXT) return fail("Skripttexte zu lang");
+		_text[_textLen++] = c;
+		if (c == '\\' && _pos < _lineLen) _text[_textLen++] = _line[_pos++];
+	}
+	len = (uint16_t)(_textLen - offset);
+	return true;
+}
+
+/**
+ * @brief Sucht eine Sprungmarke oder legt sie an.
+ *
+ * @return Index in der Markentabelle oder -1 bei Fehler.
+ */
+int SerialScript::label(const char *name, size_t len, uint16_t lineNo) {
+	if (len >= MAX_NAME) {
+		fail("Name zu lang");
+		return -1;
+	}
+	for (size_t i = 0; i < _labelCount; ++i) {
+		if (is(name, len, _labels[i].name)) return (int)i;
+	}
+	if (_labelCount >= MAX_LABELS) {
+		fail("Zu viele Sprungmarken");
+		return -1;
+	}
+	Label &lbl = _labels[_labelCount];
+	memcpy(lbl.name, name, len);
+	lbl.name[len] = '\0';
+	lbl.step = -1;
+	lbl.line = lineNo;
+	return (int)_labelCount++;
+}
+
+/**
+ * @brief Sucht ein Feld oder legt es an.
+ *
+ * @return Feldindex oder -1 bei Fehler.
+ */
+int SerialScript::field(const char *name, size_t len) {
+	if (len >= MAX_NAME) {
+		fail("Name zu lang");
+		return -1;
+	}
+	for (size_t i = 0; i < _fieldCount; ++i) {
+		if (is(name, len, _fields[i])) return (int)i;
+	}
+	if (_fieldCount >= MAX_FIELDS) {
+		fail("Zu viele Felder");
+		return -1;
+	}
+	memcpy(_fields[_fieldCount], name, len);
+	_fields[_fieldCount][len] = '\0';
+	return (int)_fieldCount++;
+}
@@ -0,0 +1,427 @@
+/**
+ * @file SerialScriptEngine.cpp
+ * @brief Zustandsautomat der Skriptausführung (siehe SerialScriptEngine.h).
+ *
+ * Die Sperre schützt nur Auftragsplatz, Ringpuffer und Zähler. Übersetzen, Suchen und Senden
+ * laufen außerhalb in der Skript-Task; die Bridge-Task kopiert in onRx() nur in den Ring.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialScriptEngine.h"
+
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief Kopiert einen Text gekürzt und nullterminiert.
+ */
+static void copyText(char *dst, size_t size, const char *src, size_t len) {
+	if (len >= size) len = size - 1;
+	memcpy(dst, src, len);
+	dst[len] = '\0';
+}
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param send Sende-Callback.
+ * @param done Ergebnis-Callback.
+ * @param ctx Benutzerkontext.
+ */
+SerialScriptEngine::SerialScriptEngine(SendFn send, ResultSink done, void *ctx)
+    : _send(send), _done(done), _ctx(ctx), _pendingLen(0), _pendingJob(0), _pendingClient(0), _nextJob(0), _cancelJob(0), _runningJob(0), _parsing(false), _listening(false),
+      _stats(), _running(false), _pc(0), _stepActive(false), _deadline(0), _started(0), _windowLen(0) {
+	_pendingName[0] = '\0';
+	_rx.reset(_rxMem, sizeof(_rxMem));
+	memset(&_result, 0, sizeof(_result));
+}
+
+/**
+ * @brief Reiht ein Skript ein.
+ *
+ * @param client Auftraggeber.
+ * @param name Skriptname (darf nullptr sein).
+ * @param source Skripttext.
+ * @param len Länge des Textes.
+ * @return Auftragsnummer oder 0.
+ */
+uint32_t SerialScriptEngine::submit(uint32_t client, const char *name, const char *source, size_t len) {
+	_lock.enter();
+	if (_pendingJob != 0 || _parsing || len > MAX_SOURCE) {
+		_stats.rejected++;
+		_lock.exit();
+		return 0;
+	}
+	memcpy(_pending, source, len);
+	_pendingLen = len;
+	_pendingClient = client;
+	copyText(_pendingName, sizeof(_pendingName), name ? name : "", name ? strlen(name) : 0);
+	if (++_nextJob == 0) _nextJob = 1;
+	_pendingJob = _nextJob;
+	uint32_t job = _pendingJob;
+	_lock.exit();
+	return job;
+}
+
+/**
+ * @brief Bricht einen Auftrag ab.
+ *
+ * Ein wartender Auftrag wird sofort verworfen, ein laufender beim nächsten poll() beendet.
+ *
+ * @param job Auftragsnummer (0 = jeder).
+ * @return false, wenn kein solcher Auftrag existiert.
+ */
+bool SerialScriptEngine::cancel(uint32_t job) {
+	bool found = false;
+	_lock.enter();
+	if (_pendingJob != 0 && (job == 0 || job == _pendingJob)) {
+		_pendingJob = 0;
+		_stats.cancelled++;
+		found = true;
+	}
+	if (_runningJob != 0 && (job == 0 || job == _runningJob)) {
+		_cancelJob = _runningJob;
+		found = true;
+	}
+	_lock.exit();
+	return found;
+}
+
+/**
+ * @brief Übergibt empfangene Bytes an das laufende Skript.
+ *
+ * @param data Empfangene Bytes.
+ * @param len Anzahl der Bytes.
+ * @return true, wenn ein Skript läuft.
+ */
+bool SerialScriptEngine::onRx(const uint8_t *data, size_t len) {
+	_lock.enter();
+	bool listening = _listening;
+	if (listening) {
+		size_t n = len < _rx.space() ? len : _rx.space();
+		_rx.push(data, n);
+		_stats.rxDropped += (uint32_t)(len - n);
+	}
+	_lock.exit();
+	return listening;
+}
+
+/**
+ * @brief true, solange ein Auftrag wartet oder läuft.
+ */
+bool SerialScriptEngine::busy() const {
+	_lock.enter();
+	bool b = _pendingJob != 0 || _runningJob != 0;
+	_lock.exit();
+	return b;
+}
+
+/**
+ * @brief Gibt die Zähler zurück.
+ */
+SerialScriptStats SerialScriptEngine::stats() const {
+	_lock.enter();
+	SerialScriptStats s = _stats;
+	_lock.exit();
+	return s;
+}
+
+/**
+ * @brief Ein Durchlauf der Skript-Task.
+ *
+ * @param nowMs Aktuelle Zeit in ms.
+ * @return Empfohlene Wartezeit in ms.
+ */
+uint32_t SerialScriptEngine::poll(uint32_t nowMs) {
+	if (!_running && !start(nowMs)) return UINT32_MAX;
+	if (!_running) return 0;
+
+	_lock.enter();
+	bool cancelled = _cancelJob != 0 && _cancelJob == _runningJob;
+	if (cancelled) _cancelJob = 0;
+	_lock.exit();
+	if (cancelled) {
+		finish(SCRIPT_CANCELLED, "Abgebrochen", nowMs);
+		return 0;
+	}
+
+	drain();
+	uint32_t elapsed = nowMs - _started;
+	if (elapsed >= MAX_RUN_MS) {
+		finish(SCRIPT_TIMEOUT, "Laufzeit überschritten", nowMs);
+		return 0;
+	}
+	uint32_t wait = 0;
+	while (execute(nowMs, wait)) {
+	}
+	if (!_running) return 0;
+	return wait < MAX_RUN_MS - elapsed ? wait : MAX_RUN_MS - elapsed;
+}
+
+/**
+ * @brief Übernimmt den wartenden Auftrag, übersetzt ihn und prüft alle Ausdrücke.
+ *
+ * @return false, wenn kein Auftrag wartet.
+ */
+bool SerialScriptEngine::start(uint32_t nowMs) {
+	_lock.enter();
+	if (_pendingJob == 0) {
+		_lock.exit();
+		return false;
+	}
+	_result.job = _pendingJob;
+	_result.client = _pendingClient;
+	memcpy(_result.name, _pendingName, sizeof(_result.name));
+	_runningJob = _pendingJob;
+	_pendingJob = 0;
+	_parsing = true;
+	_rx.clear();
+	_listening = true;
+	_stats.runs++;
+	_lock.exit();
+
+	_running = true;
+	_started = nowMs;
+	_pc = 0;
+	_stepActive = false;
+	_windowLen = 0;
+	memset(_retries, 0, sizeof(_retries));
+	_result.status = SCRIPT_OK;
+	_result.message[0] = '\0';
+	_result.tail[0] = '\0';
+	_result.line = 0;
+	_result.steps = 0;
+	_result.sentBytes = 0;
+	_result.rxBytes = 0;
+	_result.fieldCount = 0;
+
+	bool ok = _script.parse(_pending, _pendingLen);
+	_lock.enter();
+	_parsing = false;
+	_lock.exit();
+
+	char msg[SerialScriptResult::MAX_MESSAGE];
+	if (!ok) {
+		_result.line = _script.errorLine();
+		snprintf(msg, sizeof(msg), "Zeile %u: %s", (unsigned)_script.errorLine(), _script.error());
+		finish(SCRIPT_ERROR, msg, nowMs);
+		return true;
+	}
+	for (size_t i = 0; i < _script.stepCount(); ++i) {
+		const SerialScriptStep &st = _script.step(i);
+		if (st.op != SCRIPT_OP_EXPECT || !st.regex) continue;
+		if (!_pattern.compile(_script.text(st), st.textLen)) {
+			_result.line = st.line;
+			snprintf(msg, sizeof(msg), "Zeile %u: %s", (unsigned)st.line, _pattern.error());
+			finish(SCRIPT_ERROR, msg, nowMs);
+			return true;
+		}
+	}
+	_result.fieldCount = _script.fieldCount();
+	for (size_t i = 0; i < _result.fieldCount; ++i) {
+		SerialScriptField &f = _result.fields[i];
+		copyText(f.name, sizeof(f.name), _script.fieldName(i), strlen(_script.fieldName(i)));
+		f.value[0] = '\0';
+		f.set = false;
+	}
+	return true;
+}
+
+/**
+ * @brief Überträgt empfangene Bytes aus dem Ring in das Suchfenster.
+ *
+ * Läuft das Fenster über, werden die ältesten Bytes verworfen.
+ */
+void SerialScriptEngine::drain() {
+	_lock.enter();
+	size_t n = _rx.size();
+	if (n > WINDOW) {
+		_rx.drop(n - WINDOW);
+		_result.rxBytes += (uint32_t)(n - WINDOW);
+		n = WINDOW;
+	}
+	if (_windowLen + n > WINDOW) {
+		size_t drop = _windowLen + n - WINDOW;
+		memmove(_window, _window + drop, _windowLen - drop);
+		_windowLen -= drop;
+	}
+	_rx.peek(_window + _windowLen, n);
+	_rx.drop(n);
+	_lock.exit();
+	_windowLen += n;
+	_result.rxBytes += (uint32_t)n;
+}
+
+/**
+ * @brief Führt den aktuellen Schritt aus.
+ *
+ * @param nowMs Aktuelle Zeit in ms.
+ * @param wait Wartezeit, wenn der Schritt warten muss.
+ * @return true, wenn sofort der nächste Schritt folgt.
+ */
+bool SerialScriptEngine::execute(uint32_t nowMs, uint32_t &wait) {
+	wait = 0;
+	if (_pc >= _script.stepCount()) {
+		finish(SCRIPT_OK, "", nowMs);
+		return false;
+	}
+	if (_result.steps >= MAX_EXECUTED) {
+		finish(SCRIPT_ERROR, "Schrittlimit erreicht", nowMs);
+		return false;
+	}
+	const SerialScriptStep &st = _script.step(_pc);
+	const char *text = _script.text(st);
+	_result.line = st.line;
+	size_t next = _pc + 1;
+
+	switch (st.op) {
+		case SCRIPT_OP_SEND:
+			if (!_send(_ctx, (const uint8_t *)text, st.textLen)) {
+				wait = SEND_RETRY_MS;
+				return false;
+			}
+			_result.sentBytes += st.textLen;
+			break;
+		case SCRIPT_OP_EXPECT: {
+			if (!_stepActive) {
+				// Beim Start geprüft; hier nur neu übersetzen
+				if (st.regex) {
+					_pattern.compile(text, st.textLen);
+				} else {
+					_pattern.literal(text, st.textLen);
+				}
+				_deadline = nowMs + st.arg;
+				_stepActive = true;
+			}
+			SerialPatternMatch m;
+			if (_pattern.search(_window, _windowLen, m)) {
+				capture(st, m);
+				size_t used = m.end[0];
+				memmove(_window, _window + used, _windowLen - used);
+				_windowLen -= used;
+				break;
+			}
+			if ((int32_t)(nowMs - _deadline) < 0) {
+				wait = _deadline - nowMs;
+				return false;
+			}
+			if (st.target < 0) {
+				finish(SCRIPT_TIMEOUT, "Keine passende Antwort", nowMs);
+				return false;
+			}
+			next = (size_t)st.target;
+			break;
+		}
+		case SCRIPT_OP_WAIT:
+			if (!_stepActive) {
+				_deadline = nowMs + st.arg;
+				_stepActive = true;
+			}
+			if ((int32_t)(nowMs - _deadline) < 0) {
+				wait = _deadline - nowMs;
+				return false;
+			}
+			break;
+		case SCRIPT_OP_FLUSH:
+			_windowLen = 0;
+			break;
+		case SCRIPT_OP_GOTO:
+			next = (size_t)st.target;
+			break;
+		case SCRIPT_OP_IF: {
+			const SerialScriptField &f = _result.fields[st.field];
+			bool hit = f.set && (st.textLen == 0 ? f.value[0] != '\0' : strlen(f.value) == st.textLen && memcmp(f.value, text, st.textLen) == 0);
+			if (hit) next = (size_t)st.target;
+			break;
+		}
+		case SCRIPT_OP_RETRY:
+			if (_retries[_pc] < st.arg) {
+				_retries[_pc]++;
+				next = (size_t)st.target;
+			}
+			break;
+		case SCRIPT_OP_DONE:
+			_result.steps++;
+			finish(SCRIPT_OK, "", nowMs);
+			return false;
+		case SCRIPT_OP_FAIL: {
+			_result.steps++;
+			char msg[SerialScriptResult::MAX_MESSAGE];
+			if (st.textLen > 0) {
+				copyText(msg, sizeof(msg), text, st.textLen);
+			} else {
+				copyText(msg, sizeof(msg), "fail", 4);
+			}
+			finish(SCRIPT_FAILED, msg, nowMs);
+			return false;
+		}
+	}
+	_result.steps++;
+	_pc = next;
+	_stepActive = false;
+	return true;
+}
+
+/**
+ * @brief Übernimmt die Gruppen eines Treffers in die Felder des Schritts.
+ *
+ * Gruppen, die am Treffer nicht beteiligt waren, setzen ihr Feld zurück.
+ */
+void SerialScriptEngine::capture(const SerialScriptStep &step, const SerialPatternMatch &match) {
+	for (size_t g = 1; g < match.groups; ++g) {
+		uint8_t idx = step.captures[g - 1];
+		if (idx == SerialScript::NO_FIELD) continue;
+		SerialScriptField &f = _result.fields[idx];
+		if (match.start[g] == SerialPatternMatch::UNSET) {
+			f.value[0] = '\0';
+			f.set = false;
+			continue;
+		}
+		copyText(f.value, sizeof(f.value), (const char *)_window + match.start[g], match.end[g] - match.start[g]);
+		f.set = true;
+	}
+}
+
+/**
+ * @brief Beendet den laufenden Auftrag und meldet das Ergebnis.
+ *
+ * @param status Ausgang.
+ * @param message Meldung ("" = keine).
+ * @param nowMs Aktuelle Zeit in ms.
+ */
+void SerialScriptEngine::finish(SerialScriptStatus status, const char *message, uint32_t nowMs) {
+	_result.status = status;
+	copyText(_result.message, sizeof(_result.message), message, strlen(message));
+	_result.elapsedMs = nowMs - _started;
+	_result.tail[0] = '\0';
+	if (status != SCRIPT_OK) {
+		// Letzter unverbrauchter Empfang zur Diagnose, nicht druckbare Zeichen als '.'
+		size_t n = _windowLen < SerialScriptResult::MAX_TAIL - 1 ? _windowLen : SerialScriptResult::MAX_TAIL - 1;
+		const uint8_t *src = _window + _windowLen - n;
+		for (size_t i = 0; i < n; ++i) {
+			uint8_t c = src[i];
+			_result.tail[i] = (c >= 0x20 && c < 0x7F) || c == '\r' || c == '\n' || c == '\t' ? (char)c : '.';
+		}
+		_result.tail[n] = '\0';
+	}
+
+	_lock.enter();
+	_listening = false;
+	_runningJob = 0;
+	if (_cancelJob == _result.job) _cancelJob = 0;
+	_rx.clear();
+	if (status == SCRIPT_OK) {
+		_stats.ok++;
+	} else if (status == SCRIPT_CANCELLED) {
+		_stats.cancelled++;
+	} else {
+		_stats.failed++;
+	}
+	_lock.exit();
+
+	_running = false;
+	_windowLen = 0;
+	if (_done) _done(_ctx, _result);
+}
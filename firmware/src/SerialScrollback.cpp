@@ -0,0 +1,170 @@
+/**
+ * @file SerialScrollback.cpp
+ * @brief Implementierung des Verlaufspuffers für serielle Daten.
+ *
+ * Ein Block liegt im Ring als SerialScrollbackRecord (12 Bytes) plus Nutzdaten. Die Suche nach
+ * einer Startnummer oder -länge läuft einmal pro Replay-Anfrage linear über die Köpfe.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialScrollback.h"
+
+/**
+ * @brief Erzeugt einen Verlaufspuffer ohne Speicher.
+ */
+SerialScrollback::SerialScrollback() : _dropped(0), _count(0), _firstSeq(0) {
+}
+
+/**
+ * @brief Setzt den Speicherbereich und leert den Puffer.
+ *
+ * @param buf Speicherbereich.
+ * @param capacity Größe in Bytes.
+ */
+void SerialScrollback::reset(uint8_t *buf, size_t capacity) {
+	_ring.reset(buf, capacity);
+	_dropped = 0;
+	_count = 0;
+	_firstSeq = 0;
+}
+
+/**
+ * @brief Legt einen Datenblock ab.
+ *
+ * @param seq Laufende Nummer.
+ * @param timestamp Empfangszeit in µs.
+ * @param flags SerialFrameFlags.
+ * @param data Nutzdaten.
+ * @param len Länge der Nutzdaten.
+ */
+void SerialScrollback::append(uint32_t seq, uint64_t timestamp, uint16_t flags, const uint8_t *data, size_t len) {
+	size_t need = sizeof(SerialScrollbackRecord) + len;
+	if (len > UINT16_MAX || need > _ring.capacity()) return;
+	while (_ring.space() < need) dropOldest();
+
+	SerialScrollbackRecord rec{timestamp, seq, (uint16_t)len, flags};
+	_ring.push(&rec, sizeof(rec));
+	_ring.push(data, len);
+	if (_count++ == 0) _firstSeq = seq;
+}
+
+uint64_t SerialScrollback::begin() const {
+	return _dropped;
+}
+
+uint64_t SerialScrollback::end() const {
+	return _dropped + _ring.size();
+}
+
+bool SerialScrollback::valid(uint64_t cursor) const {
+	return cursor >= _dropped && cursor <= end();
+}
+
+/**
+ * @brief Sucht den ersten Block ab einer Nummer.
+ *
+ * Nummern werden mit Überlauf verglichen (Differenz als int32_t).
+ *
+ * @param seq Startnummer.
+ * @param missing Ausgabe: Anzahl fehlender Blöcke vor dem ältesten gespeicherten.
+ * @return Cursor.
+ */
+uint64_t SerialScrollback::seekSeq(uint32_t seq, uint32_t &missing) const {
+	missing = 0;
+	if (_count == 0) return end();
+	int32_t before = (int32_t)(_firstSeq - seq);
+	if (before > 0) {
+		missing = (uint32_t)before;
+		return begin();
+	}
+	uint64_t cursor = begin();
+	SerialScrollbackRecord rec;
+	while (peekAt(cursor, rec)) {
+		if ((int32_t)(rec.seq - seq) >= 0) return cursor;
+		cursor += sizeof(rec) + rec.len;
+	}
+	return cursor;
+}
+
+/**
+ * @brief Sucht den ältesten Block, ab dem höchstens `bytes` Nutzdaten folgen.
+ *
+ * @param bytes Gewünschte Datenmenge.
+ * @return Cursor.
+ */
+uint64_t SerialScrollback::seekTail(size_t bytes) const {
+	// Nutzdaten gesamt bestimmen, dann so viele Blöcke überspringen, bis der Rest passt
+	size_t total = 0;
+	uint64_t cursor = begin();
+	SerialScrollbackRecord rec;
+	while (peekAt(cursor, rec)) {
+		total += rec.len;
+		cursor += sizeof(rec) + rec.len;
+	}
+	cursor = begin();
+	while (total > bytes && peekAt(cursor, rec)) {
+		total -= rec.len;
+		cursor += sizeof(rec) + rec.len;
+	}
+	return cursor;
+}
+
+/**
+ * @brief Liest den Block am Cursor.
+ *
+ * @param cursor Position, wird auf den nächsten Block gesetzt.
+ * @param rec Ausgabe: Kopf.
+ * @param out Zielpuffer.
+ * @param cap Größe des Zielpuffers.
+ * @return false am Ende oder bei ungültigem Cursor.
+ */
+bool SerialScrollback::read(uint64_t &cursor, SerialScrollbackRecord &rec, uint8_t *out, size_t cap) const {
+	if (!peekAt(cursor, rec)) return false;
+	size_t n = rec.len < cap ? rec.len : cap;
+	_ring.peek(out, n, (size_t)(cursor - _dropped) + sizeof(rec));
+	cursor += sizeof(rec) + rec.len;
+	rec.len = (uint16_t)n;
+	return true;
+}
+
+uint32_t SerialScrollback::firstSeq() const {
+	return _firstSeq;
+}
+
+uint32_t SerialScrollback::count() const {
+	return _count;
+}
+
+size_t SerialScrollback::size() const {
+	return _ring.size();
+}
+
+size_t SerialScrollback::capacity() const {
+	return _ring.capacity();
+}
+
+/**
+ * @brief Liest den Kopf am Cursor, ohne ihn zu verschieben.
+ */
+bool SerialScrollback::peekAt(uint64_t cursor, SerialScrollbackRecord &rec) const {
+	if (cursor < _dropped || cursor >= end()) return false;
+	return _ring.peek(&rec, sizeof(rec), (size_t)(cursor - _dropped)) == sizeof(rec);
+}
+
+/**
+ * @brief Verwirft den ältesten Block.
+ */
+void SerialScrollback::dropOldest() {
+	SerialScrollbackRecord rec;
+	if (_ring.peek(&rec, sizeof(rec)) != sizeof(rec)) return;
+	size_t len = sizeof(rec) + rec.len;
+	_ring.drop(len);
+	_dropped += len;
+	_count--;
+	if (_count > 0) {
+		_ring.peek(&rec, sizeof(rec));
+		_firstSeq = rec.seq;
+	}
+}
@@ -0,0 +1,421 @@
+/**
+ * @file SerialTcpServer.cpp
+ * @brief Roh- und RFC-2217-Server über BSD-Sockets mit einem Schreiber und Mithörern.
+ *
+ * Alle Sockets sind nicht blockierend; poll() wartet mit select() auf alle Ports und Clients
+ * gleichzeitig. Pro Client wird beim Verbindungsaufbau ein Speicherblock für Ringpuffer,
+ * Sendepuffer und Schreibrest angelegt und beim Trennen wieder freigegeben.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialTcpServer.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+
+/**
+ * @brief Schaltet einen Socket auf nicht blockierend.
+ */
+bool setNonBlocking(int fd) {
+	int flags = fcntl(fd, F_GETFL, 0);
+	return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * @brief true, wenn ein Socket-Fehler nur "später erneut versuchen" bedeutet.
+ */
+bool wouldBlock() {
+	return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+}  // namespace
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param port Serielle Seite.
+ */
+SerialTcpServer::SerialTcpServer(SerialTcpPort &port) : _port(port), _listenRaw(-1), _listenRfc(-1), _writer(-1), _nextId(1), _stats{0, 0, 0, 0} {
+	for (auto &c : _clients) {
+		c.fd = -1;
+		c.mem = nullptr;
+		c.codec = nullptr;
+	}
+}
+
+/**
+ * @brief Schließt alle Sockets.
+ */
+SerialTcpServer::~SerialTcpServer() {
+	end();
+}
+
+/**
+ * @brief Öffnet einen Port zum Lauschen auf allen Schnittstellen.
+ *
+ * @param port TCP-Port.
+ * @return Socket oder -1.
+ */
+int SerialTcpServer::listenOn(uint16_t port) {
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) return -1;
+	int one = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(port);
+	if (bind(fd, (sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 2) != 0 || !setNonBlocking(fd)) {
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/**
+ * @brief Öffnet die Ports.
+ *
+ * @param rawPort Port für Rohdaten (0 = aus).
+ * @param rfc2217Port Port für RFC 2217 (0 = aus).
+ * @return false, wenn kein Port angegeben ist oder einer nicht geöffnet werden konnte.
+ */
+bool SerialTcpServer::begin(uint16_t rawPort, uint16_t rfc2217Port) {
+	end();
+	if (rawPort == 0 && rfc2217Port == 0) return false;
+	if (rawPort) _listenRaw = listenOn(rawPort);
+	if (rfc2217Port) _listenRfc = listenOn(rfc2217Port);
+	if ((rawPort && _listenRaw < 0) || (rfc2217Port && _listenRfc < 0)) {
+		end();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Trennt alle Clients und schließt die Ports.
+ */
+void SerialTcpServer::end() {
+	for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+		if (_clients[i].fd >= 0) closeClient(i);
+	}
+	if (_listenRaw >= 0) ::close(_listenRaw);
+	if (_listenRfc >= 0) ::close(_listenRfc);
+	_listenRaw = -1;
+	_listenRfc = -1;
+}
+
+/**
+ * @brief true, solange mindestens ein Port offen ist.
+ */
+bool SerialTcpServer::running() const {
+	return _listenRaw >= 0 || _listenRfc >= 0;
+}
+
+/**
+ * @brief Kopiert empfangene UART-Daten in die Ringpuffer aller Clients.
+ *
+ * Was nicht mehr in den Puffer eines Clients passt, wird für diesen Client verworfen.
+ *
+ * @param data Empfangene Bytes.
+ * @param len Anzahl der Bytes.
+ */
+void SerialTcpServer::onRx(const uint8_t *data, size_t len) {
+	_lock.enter();
+	for (auto &c : _clients) {
+		if (c.fd < 0) continue;
+		size_t n = len < c.rx.space() ? len : c.rx.space();
+		c.rx.push(data, n);
+		if (n < len) {
+			c.info.dropped += (uint32_t)(len - n);
+			_stats.dropped += (uint32_t)(len - n);
+		}
+	}
+	_lock.exit();
+}
+
+/**
+ * @brief Ein Durchlauf der Server-Task.
+ *
+ * @param timeoutMs Maximale Wartezeit auf Socket-Ereignisse.
+ * @return Empfohlene Wartezeit bis zum nächsten Aufruf.
+ */
+uint32_t SerialTcpServer::poll(uint32_t timeoutMs) {
+	if (!running()) return IDLE_POLL_MS;
+
+	fd_set rd, wr;
+	FD_ZERO(&rd);
+	FD_ZERO(&wr);
+	int maxFd = -1;
+	auto watch = [&maxFd](int fd, fd_set &set) {
+		FD_SET(fd, &set);
+		if (fd > maxFd) maxFd = fd;
+	};
+	if (_listenRaw >= 0) watch(_listenRaw, rd);
+	if (_listenRfc >= 0) watch(_listenRfc, rd);
+
+	for (auto &c : _clients) {
+		if (c.fd < 0) continue;
+		// Rest des Schreibers zuerst loswerden; bis dahin wird vom Socket nicht gelesen
+		if (c.pendingLen == 0 || flushPending(c)) {
+			watch(c.fd, rd);
+		} else if (timeoutMs > ACTIVE_POLL_MS) {
+			timeoutMs = ACTIVE_POLL_MS;
+		}
+		_lock.enter();
+		bool hasData = c.rx.size() > 0;
+		_lock.exit();
+		if (hasData || c.outPos < c.outLen || (c.codec && c.codec->pendingReply() > 0)) watch(c.fd, wr);
+	}
+
+	timeval tv;
+	tv.tv_sec = timeoutMs / 1000;
+	tv.tv_usec = (timeoutMs % 1000) * 1000;
+	int n = select(maxFd + 1, &rd, &wr, nullptr, &tv);
+	if (n > 0) {
+		if (_listenRaw >= 0 && FD_ISSET(_listenRaw, &rd)) acceptClient(_listenRaw, SERIAL_TCP_RAW);
+		if (_listenRfc >= 0 && FD_ISSET(_listenRfc, &rd)) acceptClient(_listenRfc, SERIAL_TCP_RFC2217);
+		for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+			int fd = _clients[i].fd;
+			if (fd < 0) continue;
+			if (FD_ISSET(fd, &rd)) receive(i);
+			if (_clients[i].fd == fd && FD_ISSET(fd, &wr)) transmit(i);
+		}
+	}
+	return clientCount() > 0 ? ACTIVE_POLL_MS : IDLE_POLL_MS;
+}
+
+/**
+ * @brief Nimmt eine Verbindung an oder weist sie ab, wenn alle Plätze belegt sind.
+ *
+ * @param listenFd Lauschender Socket.
+ * @param mode Protokoll des Ports.
+ */
+void SerialTcpServer::acceptClient(int listenFd, SerialTcpMode mode) {
+	sockaddr_in addr;
+	socklen_t addrLen = sizeof(addr);
+	int fd = ::accept(listenFd, (sockaddr *)&addr, &addrLen);
+	if (fd < 0) return;
+
+	size_t index = MAX_CLIENTS;
+	for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+		if (_clients[i].fd < 0) {
+			index = i;
+			break;
+		}
+	}
+	uint8_t *mem = index < MAX_CLIENTS ? static_cast<uint8_t *>(malloc(CLIENT_BUFFER + OUT_BUFFER + IO_CHUNK)) : nullptr;
+	Rfc2217Codec *codec = mem && mode == SERIAL_TCP_RFC2217 ? new (std::nothrow) Rfc2217Codec(_port) : nullptr;
+	if (!mem || (mode == SERIAL_TCP_RFC2217 && !codec) || !setNonBlocking(fd)) {
+		free(mem);
+		delete codec;
+		::close(fd);
+		_lock.enter();
+		_stats.rejected++;
+		_lock.exit();
+		return;
+	}
+	int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+	Client &c = _clients[index];
+	_lock.enter();
+	memset(&c.info, 0, sizeof(c.info));
+	c.info.id = _nextId++;
+	c.info.addr = addr.sin_addr.s_addr;
+	c.info.port = ntohs(addr.sin_port);
+	c.info.mode = mode;
+	c.mem = mem;
+	c.rx.reset(mem, CLIENT_BUFFER);
+	c.out = mem + CLIENT_BUFFER;
+	c.outLen = 0;
+	c.outPos = 0;
+	c.pending = c.out + OUT_BUFFER;
+	c.pendingLen = 0;
+	c.codec = codec;
+	c.fd = fd;
+	if (_writer < 0) _writer = (int)index;
+	_stats.accepted++;
+	_lock.exit();
+}
+
+/**
+ * @brief Trennt einen Client; das Schreibrecht geht an den am längsten verbundenen Mithörer.
+ *
+ * @param index Index des Clients.
+ */
+void SerialTcpServer::closeClient(size_t index) {
+	Client &c = _clients[index];
+	int fd = c.fd;
+	_lock.enter();
+	c.fd = -1;
+	c.rx.reset(nullptr, 0);
+	if (_writer == (int)index) {
+		_writer = -1;
+		for (size_t i = 0; i < MAX_CLIENTS; ++i) {
+			if (_clients[i].fd >= 0 && (_writer < 0 || _clients[i].info.id < _clients[_writer].info.id)) _writer = (int)i;
+		}
+	}
+	_lock.exit();
+	::close(fd);
+	free(c.mem);
+	delete c.codec;
+	c.mem = nullptr;
+	c.codec = nullptr;
+}
+
+/**
+ * @brief Liest vom Socket eines Clients.
+ *
+ * Daten des Schreibers gehen an die UART, die eines Mithörers werden verworfen. Telnet-Befehle
+ * wertet der Codec in beiden Fällen aus.
+ *
+ * @param index Index des Clients.
+ */
+void SerialTcpServer::receive(size_t index) {
+	Client &c = _clients[index];
+	uint8_t buf[IO_CHUNK];
+	ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+	if (n == 0 || (n < 0 && !wouldBlock())) {
+		closeClient(index);
+		return;
+	}
+	if (n < 0) return;
+
+	bool writer = _writer == (int)index;
+	size_t len = c.codec ? c.codec->decode(buf, (size_t)n, buf, writer) : (size_t)n;
+	if (!writer) {
+		_lock.enter();
+		c.info.ignored += (uint32_t)len;
+		_stats.ignored += (uint32_t)len;
+		_lock.exit();
+		return;
+	}
+	memcpy(c.pending, buf, len);
+	c.pendingLen = len;
+	flushPending(c);
+}
+
+/**
+ * @brief Übergibt den Rest des Schreibers an die UART.
+ *
+ * @return true, wenn nichts mehr aussteht.
+ */
+bool SerialTcpServer::flushPending(Client &c) {
+	size_t n = c.pendingLen > 0 ? _port.write(c.pending, c.pendingLen) : 0;
+	if (n > 0) {
+		memmove(c.pending, c.pending + n, c.pendingLen - n);
+		c.pendingLen -= n;
+		_lock.enter();
+		c.info.txBytes += (uint32_t)n;
+		_lock.exit();
+	}
+	return c.pendingLen == 0;
+}
+
+/**
+ * @brief Füllt den Sendepuffer eines Clients: zuerst Telnet-Antworten, dann UART-Daten.
+ *
+ * @return true, wenn etwas zu senden ist.
+ */
+bool SerialTcpServer::fillOut(Client &c) {
+	if (c.outPos < c.outLen) return true;
+	c.outPos = 0;
+	c.outLen = c.codec ? c.codec->takeReply(c.out, OUT_BUFFER) : 0;
+
+	_lock.enter();
+	if (c.codec) {
+		uint8_t raw[IO_CHUNK];
+		size_t n = c.rx.peek(raw, sizeof(raw));
+		size_t consumed = 0;
+		c.outLen += Rfc2217Codec::escape(raw, n, c.out + c.outLen, OUT_BUFFER - c.outLen, consumed);
+		c.rx.drop(consumed);
+		c.info.rxBytes += (uint32_t)consumed;
+	} else {
+		size_t n = c.rx.peek(c.out, OUT_BUFFER);
+		c.rx.drop(n);
+		c.outLen = n;
+		c.info.rxBytes += (uint32_t)n;
+	}
+	_lock.exit();
+	return c.outLen > 0;
+}
+
+/**
+ * @brief Sendet, bis der Socket voll ist oder nichts mehr ansteht.
+ *
+ * @param index Index des Clients.
+ */
+void SerialTcpServer::transmit(size_t index) {
+	Client &c = _clients[index];
+	while (fillOut(c)) {
+		ssize_t n = send(c.fd, c.out + c.outPos, c.outLen - c.outPos, MSG_NOSIGNAL);
+		if (n < 0) {
+			if (!wouldBlock()) closeClient(index);
+			return;
+		}
+		c.outPos += (size_t)n;
+		if (c.outPos < c.outLen) return;
+	}
+}
+
+/**
+ * @brief Anzahl der verbundenen Clients.
+ */
+size_t SerialTcpServer::clientCount() const {
+	size_t n = 0;
+	for (const auto &c : _clients) {
+		if (c.fd >= 0) n++;
+	}
+	return n;
+}
+
+/**
+ * @brief Liefert den Zustand aller Verbindungen.
+ *
+ * @param out Zielfeld.
+ * @param max Größe des Zielfelds.
+ * @return Anzahl der eingetragenen Verbindungen.
+ */
+size_t SerialTcpServer::clients(SerialTcpClientInfo *out, size_t max) const {
+	size_t n = 0;
+	_lock.enter();
+	for (size_t i = 0; i < MAX_CLIENTS && n < max; ++i) {
+		if (_clients[i].fd < 0) continue;
+		out[n] = _clients[i].info;
+		out[n].writer = _writer == (int)i;
+		n++;
+	}
+	_lock.exit();
+	return n;
+}
+
+/**
+ * @brief Gibt die Zähler zurück.
+ *
+ * @return Kopie der Statistik.
+ */
+SerialTcpStats SerialTcpServer::stats() const {
+	_lock.enter();
+	SerialTcpStats s = _stats;
+	_lock.exit();
+	return s;
+}
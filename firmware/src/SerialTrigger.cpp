@@ -0,0 +1,169 @@
+/**
+ * @file SerialTrigger.cpp
+ * @brief Prüfung und Übersetzung der Regeln, Auswertung einer Zeile mit Sperrzeiten.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialTrigger.h"
+
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief Konstruktor: ohne build() löst keine Regel aus.
+ */
+SerialTrigger::SerialTrigger() : _armed(0), _lines(0) {
+	memset(&_cfg, 0, sizeof(_cfg));
+	memset(_pattern, 0, sizeof(_pattern));
+	memset(_stats, 0, sizeof(_stats));
+}
+
+/**
+ * @brief Prüft einen Text: nicht leer und nullterminiert innerhalb von `max`.
+ */
+static bool validText(const char *text, size_t max) {
+	size_t len = strnlen(text, max);
+	return len > 0 && len < max;
+}
+
+/**
+ * @brief Prüft und übersetzt die Regeln.
+ *
+ * Namen müssen eindeutig sein; gleiche Texte mehrerer Regeln teilen sich ein Muster.
+ *
+ * @param cfg Regeln.
+ * @param error Puffer für die Fehlerbeschreibung.
+ * @param size Größe des Puffers.
+ * @return false bei ungültiger Regel oder vollem Musterspeicher.
+ */
+bool SerialTrigger::build(const SerialTriggerConfig &cfg, char *error, size_t size) {
+	_match.clear();
+	_cfg.count = 0;
+	_armed = 0;
+	_lines = 0;
+	memset(_stats, 0, sizeof(_stats));
+	if (cfg.count > SerialTriggerConfig::MAX_RULES) {
+		snprintf(error, size, "Zu viele Regeln");
+		return false;
+	}
+	for (size_t i = 0; i < cfg.count; ++i) {
+		const SerialTriggerRule &r = cfg.rules[i];
+		if (!validText(r.name, SerialTriggerRule::MAX_NAME)) {
+			snprintf(error, size, "Regel %u: Name fehlt", (unsigned)(i + 1));
+			return false;
+		}
+		bool ok = false;
+		if (!validText(r.text, SerialTriggerRule::MAX_TEXT)) {
+			snprintf(error, size, "%s: Text fehlt oder ist zu lang", r.name);
+		} else if (r.actions == 0 || (r.actions & ~TRIGGER_ACTION_ALL) != 0) {
+			snprintf(error, size, "%s: Keine gültige Aktion", r.name);
+		} else if (r.level > TRIGGER_ERROR) {
+			snprintf(error, size, "%s: Unbekannte Stufe", r.name);
+		} else if (r.cooldownMs > MAX_COOLDOWN_MS) {
+			snprintf(error, size, "%s: Sperrzeit zu lang", r.name);
+		} else {
+			ok = true;
+		}
+		for (size_t j = 0; ok && j < i; ++j) {
+			if (strcmp(cfg.rules[j].name, r.name) == 0) {
+				snprintf(error, size, "%s: Name doppelt", r.name);
+				ok = false;
+			}
+		}
+		int id = ok ? _match.add((const uint8_t *)r.text, strlen(r.text), r.prefix, r.ignoreCase) : SerialMultiMatch::NO_PATTERN;
+		if (ok && id == SerialMultiMatch::NO_PATTERN) {
+			snprintf(error, size, "%s: Musterspeicher voll", r.name);
+			ok = false;
+		}
+		if (!ok) {
+			_match.clear();
+			return false;
+		}
+		_pattern[i] = (uint8_t)id;
+	}
+	_match.build();
+	_lock.enter();
+	_cfg = cfg;
+	_lock.exit();
+	if (size > 0) error[0] = '\0';
+	return true;
+}
+
+/**
+ * @brief Prüft eine Zeile gegen alle Regeln.
+ *
+ * Ohne Treffer im Automaten bleibt es bei dem einen Durchlauf über die Zeile.
+ *
+ * @param line Zeile.
+ * @param len Länge der Zeile.
+ * @param nowMs Aktuelle Zeit in ms.
+ * @return Bitmaske der ausgelösten Regeln.
+ */
+uint32_t SerialTrigger::onLine(const uint8_t *line, size_t len, uint32_t nowMs) {
+	_lines++;
+	if (_cfg.count == 0) return 0;
+	uint64_t hits = _match.scan(line, len);
+	if (hits == 0) return 0;
+
+	uint32_t fired = 0;
+	_lock.enter();
+	for (size_t i = 0; i < _cfg.count; ++i) {
+		if (!(hits & (1ULL << _pattern[i]))) continue;
+		SerialTriggerStats &st = _stats[i];
+		st.hits++;
+		uint32_t bit = 1UL << i;
+		if ((_armed & bit) && nowMs - st.lastMs < _cfg.rules[i].cooldownMs) continue;
+		_armed |= bit;
+		st.fired++;
+		st.lastMs = nowMs;
+		fired |= bit;
+	}
+	_lock.exit();
+	return fired;
+}
+
+/**
+ * @brief Anzahl der Regeln.
+ */
+size_t SerialTrigger::count() const {
+	return _cfg.count;
+}
+
+/**
+ * @brief Kopie einer Regel und ihrer Zähler.
+ *
+ * @return false bei ungültigem Index.
+ */
+bool SerialTrigger::rule(size_t index, SerialTriggerRule &rule, SerialTriggerStats &stats) const {
+	_lock.enter();
+	bool ok = index < _cfg.count;
+	if (ok) {
+		rule = _cfg.rules[index];
+		stats = _stats[index];
+	}
+	_lock.exit();
+	return ok;
+}
+
+/**
+ * @brief Regel ohne Kopie (nur Bridge-Task).
+ */
+const SerialTriggerRule &SerialTrigger::rule(size_t index) const {
+	return _cfg.rules[index];
+}
+
+/**
+ * @brief Anzahl der geprüften Zeilen.
+ */
+uint32_t SerialTrigger::lines() const {
+	return _lines;
+}
+
+/**
+ * @brief Anzahl der verschiedenen Muster im Automaten.
+ */
+size_t SerialTrigger::patterns() const {
+	return _match.patterns();
+}
@@ -0,0 +1,240 @@
+/**
+ * @file SerialTx.cpp
+ * @brief Sendewarteschlange der seriellen Schnittstelle mit Pacing und RS-485-Steuerung.
+ *
+ * Die Sperren werden nur für das Ein- und Austragen von Bytes bzw. das Zählen gehalten; das
+ * Schreiben auf die UART und alle Wartezeiten laufen außerhalb, sodass `submit()` nie auf die
+ * Leitung wartet. Die Warteschlange schützt ein TaskMutex, weil `submit()` einen ganzen Auftrag
+ * (bis QUEUE_BYTES) darunter kopiert; die Zähler bleiben unter dem kurzen Spinlock.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "SerialTx.h"
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param port UART, auf die geschrieben wird.
+ * @param done Callback nach der Übertragung (darf nullptr sein).
+ * @param ctx Benutzerkontext.
+ */
+SerialTx::SerialTx(UartPort &port, DoneSink done, void *ctx)
+    : _port(port), _done(done), _ctx(ctx), _tap(nullptr), _tapCtx(nullptr), _config(), _nextJob(0), _deOn(false), _stats() {
+	_config.flow = SERIAL_FLOW_NONE;
+	_queue.reset(_queueBuf, sizeof(_queueBuf));
+}
+
+/**
+ * @brief Registriert einen Mithörer für gesendete Bytes.
+ *
+ * @param tap Callback (nullptr = keiner).
+ * @param ctx Benutzerkontext.
+ */
+void SerialTx::onTransmit(TapFn tap, void *ctx) {
+	_tap = tap;
+	_tapCtx = ctx;
+}
+
+/**
+ * @brief Prüft Einstellungen auf Grenzwerte und gültige Kombinationen.
+ *
+ * @param config Zu prüfende Einstellungen.
+ * @return false bei RS-485 zusammen mit RTS/CTS oder überschrittenen Grenzwerten.
+ */
+bool SerialTx::validate(const SerialTxConfig &config) {
+	if (config.rs485 && config.flow == SERIAL_FLOW_RTS_CTS) return false;
+	if (config.charDelayUs > MAX_CHAR_DELAY_US || config.lineDelayMs > MAX_LINE_DELAY_MS) return false;
+	return config.deLeadUs <= MAX_DE_DELAY_US && config.deTailUs <= MAX_DE_DELAY_US;
+}
+
+/**
+ * @brief Übernimmt neue Einstellungen und setzt die Flusskontrolle der UART.
+ *
+ * @param config Neue Einstellungen.
+ * @return false bei ungültigen Einstellungen oder nicht unterstützter Flusskontrolle.
+ */
+bool SerialTx::configure(const SerialTxConfig &config) {
+	if (!validate(config)) return false;
+	if (!_port.setFlowControl(config.flow)) return false;
+
+	if (_deOn && !config.rs485) {
+		_port.setDriverEnable(false);
+		_deOn = false;
+	}
+	_config = config;
+	return true;
+}
+
+/**
+ * @brief Gibt die aktiven Einstellungen zurück.
+ */
+const SerialTxConfig &SerialTx::config() const {
+	return _config;
+}
+
+/**
+ * @brief Reiht Daten zum Senden ein.
+ *
+ * @param client Client-ID für den Abschluss-Callback.
+ * @param data Zu sendende Bytes.
+ * @param len Anzahl der Bytes.
+ * @return Auftragsnummer oder 0 bei voller Warteschlange.
+ */
+uint32_t SerialTx::submit(uint32_t client, const uint8_t *data, size_t len) {
+	if (len == 0) return 0;
+	_queueLock.enter();
+	if (sizeof(JobHeader) + len > _queue.space()) {
+		_queueLock.exit();
+		_lock.enter();
+		_stats.rejected++;
+		_lock.exit();
+		return 0;
+	}
+	JobHeader hdr;
+	hdr.job = ++_nextJob;
+	if (hdr.job == 0) hdr.job = ++_nextJob;
+	hdr.client = client;
+	hdr.len = (uint32_t)len;
+	_queue.push(&hdr, sizeof(hdr));
+	_queue.push(data, len);
+	size_t queued = _queue.size();
+	_queueLock.exit();
+
+	_lock.enter();
+	_stats.jobs++;
+	if (queued > _stats.maxQueued) _stats.maxQueued = queued;
+	_lock.exit();
+	return hdr.job;
+}
+
+/**
+ * @brief Überträgt alle wartenden Aufträge.
+ *
+ * Jeder Auftrag wird stückweise aus der Warteschlange geholt; die restlichen Bytes bleiben bis
+ * zum Senden dort, sodass neue Aufträge weiterhin dahinter angehängt werden können.
+ *
+ * @return Anzahl der abgeschlossenen Aufträge.
+ */
+size_t SerialTx::service() {
+	size_t jobs = 0;
+	for (;;) {
+		JobHeader hdr;
+		_queueLock.enter();
+		bool have = _queue.peek(&hdr, sizeof(hdr)) == sizeof(hdr);
+		if (have) _queue.drop(sizeof(hdr));
+		_queueLock.exit();
+		if (!have) break;
+
+		size_t left = hdr.len;
+		while (left > 0) {
+			size_t n = left < CHUNK ? left : CHUNK;
+			_queueLock.enter();
+			_queue.peek(_chunk, n);
+			_queue.drop(n);
+			_queueLock.exit();
+			transmit(_chunk, n);
+			left -= n;
+		}
+		bool ok = finishBurst();
+
+		_lock.enter();
+		_stats.done++;
+		if (!ok) _stats.txTimeouts++;
+		_lock.exit();
+		if (_done) _done(_ctx, hdr.client, hdr.job, hdr.len, ok);
+		jobs++;
+	}
+	return jobs;
+}
+
+/**
+ * @brief Verwirft alle noch nicht begonnenen Aufträge.
+ */
+void SerialTx::clear() {
+	_queueLock.enter();
+	_queue.clear();
+	_queueLock.exit();
+}
+
+/**
+ * @brief Kopie der Zähler.
+ */
+SerialTxStats SerialTx::stats() const {
+	_lock.enter();
+	SerialTxStats s = _stats;
+	_lock.exit();
+	_queueLock.enter();
+	s.queuedBytes = _queue.size();
+	_queueLock.exit();
+	return s;
+}
+
+/**
+ * @brief Schreibt einen Block unter Einhaltung von Zeichen- und Zeilenabstand.
+ *
+ * Ohne Pacing geht der Block in einem Schreibvorgang an den Treiber. Mit Zeilenabstand wird
+ * nach jedem '\n' gewartet, bis die Zeile gesendet ist, und dann pausiert; mit Zeichenabstand
+ * wird jedes Byte einzeln geschrieben.
+ */
+void SerialTx::transmit(const uint8_t *data, size_t len) {
+	if (_config.charDelayUs == 0 && _config.lineDelayMs == 0) {
+		emit(data, len);
+		return;
+	}
+	size_t start = 0;
+	for (size_t i = 0; i < len; ++i) {
+		bool eol = _config.lineDelayMs > 0 && data[i] == '\n';
+		if (_config.charDelayUs > 0) {
+			emit(data + i, 1);
+			_port.waitTxDone(TX_DONE_TIMEOUT_MS);
+			_port.delayMicros(_config.charDelayUs);
+			start = i + 1;
+		} else if (eol) {
+			emit(data + start, i + 1 - start);
+			start = i + 1;
+		}
+		if (eol) {
+			finishBurst();
+			_port.sleep(_config.lineDelayMs);
+		}
+	}
+	if (start < len) emit(data + start, len - start);
+}
+
+/**
+ * @brief Schreibt Bytes und schaltet bei RS-485 vorher den Sendetreiber ein.
+ */
+void SerialTx::emit(const uint8_t *data, size_t len) {
+	if (_config.rs485 && !_deOn) {
+		_port.setDriverEnable(true);
+		_deOn = true;
+		if (_config.deLeadUs) _port.delayMicros(_config.deLeadUs);
+	}
+	size_t off = 0;
+	while (off < len) {
+		size_t n = _port.write(data + off, len - off);
+		if (n == 0) break;
+		off += n;
+	}
+	if (off && _tap) _tap(_tapCtx, data, off);
+	_lock.enter();
+	_stats.bytes += (uint32_t)off;
+	_lock.exit();
+}
+
+/**
+ * @brief Wartet auf das Sendeende und schaltet bei RS-485 den Sendetreiber wieder ab.
+ *
+ * @return false, wenn das Sendeende nicht innerhalb von TX_DONE_TIMEOUT_MS erreicht wurde.
+ */
+bool SerialTx::finishBurst() {
+	bool ok = _port.waitTxDone(TX_DONE_TIMEOUT_MS);
+	if (_deOn) {
+		if (_config.deTailUs) _port.delayMicros(_config.deTailUs);
+		_port.setDriverEnable(false);
+		_deOn = false;
+	}
+	return ok;
+}
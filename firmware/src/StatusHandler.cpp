@@ -46,6 +46,7 @@ int statusPriority(SystemStatus status) {
 		// 2) Kritischer Fehler (Rot blinkend)
 		case LOG_NO_DIR:
 		case WEBSERVER_NO_HTML_DIR:
+		case SERIAL_TRIGGER_ERROR:
 			return 90;
 
 		// 3) Warning (Gelb dauerhaft)
@@ -57,6 +58,7 @@ int statusPriority(SystemStatus status) {
 		case WIFI_STA_NOT_AVAILABLE:
 		case WIFI_AP_NOT_AVAILABLE:
 		case SERIAL_NOT_CONNECTED:
+		case SERIAL_TRIGGER_WARNING:
 			return 70;
 
 		// 5) Alles andere (Grün, etc.)
@@ -150,6 +152,10 @@ static void doBlinkPattern(SystemStatus status) {
 			blinkedLED(RED_LED, 3, delaySlow);
 			break;
 		}
+		case SERIAL_TRIGGER_ERROR: {
+			blinkedLED(RED_LED, 5, delayFast);
+			break;
+		}
 		// 3) Warning (Gelb dauerhaft)
 		case WIFI_AP_NO_DEVICE: {
 			// Gelbe LED dauerhaft an
@@ -173,6 +179,10 @@ static void doBlinkPattern(SystemStatus status) {
 			blinkedLED(YELLOW_LED, 4, delaySlow);
 			break;
 		}
+		case SERIAL_TRIGGER_WARNING: {
+			blinkedLED(YELLOW_LED, 5, delayFast);
+			break;
+		}
 		// 5) Systemstatus (Ready, etc.)
 		case SERIAL_CONNECTED: {
 			digitalWrite(GREEN_LED, HIGH);
@@ -15,7 +15,29 @@
 
 #include <LittleFS.h>
 
+#include <memory>
+
 #include "LLog.h"
+#include "LogCodec.h"
+#include "LogJournal.h"
+#include "SerialBridge.h"
+#include "global.h"
+
+extern SerialBridge *serialBridges[SERIAL_CHANNELS];
+
+/**
+ * @struct StreamUpload
+ * @brief Zustand eines Datei-Uploads an die UART (in `_tempObject`, gibt die Bibliothek frei).
+ */
+struct StreamUpload {
+	SerialBridge *bridge;  ///< Ziel der Übertragung
+	uint32_t bytes;        ///< Angenommene Bytes
+	uint32_t stallMs;      ///< Abbruch, wenn so lange nichts angenommen wird
+	bool started;          ///< Übertragung läuft
+	bool finished;         ///< Dateiende gemeldet oder abgebrochen
+	int code;              ///< HTTP-Fehlercode (0 = kein Fehler)
+	char error[48];        ///< Fehlerbeschreibung
+};
 
 /**
  * @brief Initialisiert die HTTP-Routen des Webservers.
@@ -41,11 +63,17 @@ void WebServerManager::init(AsyncWebServer &server) {
 	// 3) /logs/device?file=... → Device-Logs
 	server.on("/logs/device", HTTP_GET, [this](AsyncWebServerRequest *req) { serveDeviceLog(req); });
 
-	// 4) Assets: /css/style.css, /favicon.ico, ...
+	// 4) POST /serial/stream?channel=... → Datei zeilenweise an die UART (Body roh oder als Multipart)
+	server.on(
+	    "/serial/stream", HTTP_POST, [this](AsyncWebServerRequest *req) { finishStream(req); },
+	    [this](AsyncWebServerRequest *req, const String &, size_t index, uint8_t *data, size_t len, bool) { handleStreamData(req, data, len, index, 0); },
+	    [this](AsyncWebServerRequest *req, uint8_t *data, size_t len, size_t index, size_t total) { handleStreamData(req, data, len, index, total); });
+
+	// 5) Assets: /css/style.css, /favicon.ico, ...
 	server.serveStatic("/css", LittleFS, "/www/html/css");
 	server.serveStatic("/favicon.ico", LittleFS, "/www/html/favicon.ico");
 
-	// 5) SPA-Frontend: alles mit einem Punkt (also echte Dateien) aus /www/html, und als Fallback index.html für "Client-Routes" ohne
+	// 6) SPA-Frontend: alles mit einem Punkt (also echte Dateien) aus /www/html, und als Fallback index.html für "Client-Routes" ohne
 	// Dateierweiterung.
 	auto staticHandler = server.serveStatic("/", LittleFS, "/www/html").setDefaultFile("index.html");
 	staticHandler.setFilter([](AsyncWebServerRequest *req) {
@@ -53,7 +81,7 @@ void WebServerManager::init(AsyncWebServer &server) {
 		return req->url().indexOf('.') != -1;
 	});
 
-	// 6) alle anderen Routen → index.html (Client-Routing)
+	// 7) alle anderen Routen → index.html (Client-Routing)
 	server.onNotFound([](AsyncWebServerRequest *req) { req->send(LittleFS, "/www/html/index.html", "text/html"); });
 }
 
@@ -68,12 +96,12 @@ void WebServerManager::serveSystemLogList(AsyncWebServerRequest *request) {
 }
 
 /**
- * @brief Generiert eine HTML-Liste aller System-Logdateien.
+ * @brief Generiert eine HTML-Liste der Log-Kategorien.
  *
- * Diese Methode durchsucht das Verzeichnis `/logs/system` und erstellt eine
- * formatierte HTML-Seite mit Links zu den jeweiligen Dateien.
+ * Alle Kategorien liegen im gemeinsamen Journal; jede wird als gefilterte Ansicht verlinkt,
+ * dazu die Gesamtansicht mit Segmentzahl, Größe und Budget.
  *
- * @return HTML-String mit Dateiliste.
+ * @return HTML-String mit Kategorienliste.
  */
 String WebServerManager::buildSystemLogListHtml() {
 	String html =
@@ -84,35 +112,152 @@ String WebServerManager::buildSystemLogListHtml() {
 	    "</head><body>"
 	    "<h1>System-Logdateien</h1><ul>";
 
-	File root = LittleFS.open("/logs/system");
-	if (!root || !root.isDirectory()) {
-		html += "<li><strong>Kein Log-Verzeichnis!</strong></li>";
+	std::vector<String> segments = logger.journalSegments();
+	if (segments.empty()) {
+		html += "<li><strong>Kein Log-Journal!</strong></li>";
 	} else {
-		File f;
-		while ((f = root.openNextFile())) {
-			String name = f.name();  // z.B. "/logs/system/info.log"
-			int idx = name.lastIndexOf('/');
-			if (idx >= 0) name = name.substring(idx + 1);
+		for (const auto &level : LLog::Events) {
 			// link auf /logfile?level=info etc.
-			String level = name.substring(0, name.lastIndexOf('.'));
-			String item = "<li><a href=\"/logfile?level=" + level + "\" target=\"_blank\">" + name + "</a> (" + String(f.size()) + " Bytes)</li>";
-			html += item;
-
-			f.close();
+			html += "<li><a href=\"/logfile?level=" + level + "\" target=\"_blank\">" + level + "</a></li>";
 		}
+		LogRotationConfig rot = logger.rotationConfig();
+		html += "<li><a href=\"/logfile?level=all\" target=\"_blank\">alle</a> (" + String(segments.size()) + " von " + String(rot.segments) + " Segmenten, " +
+		        String(logger.journalBytes()) + " Bytes, Budget /logs " + String(rot.budget) + " Bytes)</li>";
+		// Rohdaten für tools/log-decoder
+		html += "<li>Segmente:";
+		for (const auto &path : segments) {
+			String name = path.substring(path.lastIndexOf('/') + 1);
+			html += " <a href=\"/logfile?segment=" + name + "\">" + name + "</a>";
+		}
+		html += "</li>";
 	}
 	html += "</ul></body></html>";
 	return html;
 }
 
 /**
- * @brief Sendet den Inhalt einer System-Logdatei als HTML-Seite.
+ * @struct JournalView
+ * @brief Zustand einer gefilterten Journal-Ausgabe über mehrere Chunks.
+ */
+struct JournalView {
+	std::vector<String> segments;  ///< Segmente, ältestes zuerst
+	size_t next;                   ///< Nächstes zu öffnendes Segment
+	File file;                     ///< Geöffnetes Segment
+	uint16_t mask;                 ///< Angezeigte Kategorien
+	String title;                  ///< Kategorie im Seitentitel
+	uint8_t stage;                 ///< 0 = Kopf, 1 = Zeilen, 2 = Fuß, 3 = fertig
+	String pending;                ///< Noch nicht gesendeter Text
+	size_t offset;                 ///< Bereits gesendeter Teil von pending
+	uint32_t markTime;             ///< Letzte Zeitmarke im Segment (binäre Einträge)
+};
+
+/**
+ * @brief Bettet eine Logzeile mit Hervorhebung nach Log-Level in HTML ein.
+ *
+ * @param line Logzeile ohne Journal-Präfix.
+ * @return HTML-Zeile inkl. Zeilenende.
+ */
+static String highlightLogLine(const String &line) {
+	// Prüfen, ob "[INFO]" / "[ERROR]" / "[WARNING]" im String vorkommt
+	if (line.indexOf("[INFO]") != -1) return "<span class='info'>" + line + "</span>\n";
+	if (line.indexOf("[ERROR]") != -1) return "<span class='error'>" + line + "</span>\n";
+	if (line.indexOf("[WARNING]") != -1) return "<span class='warning'>" + line + "</span>\n";
+	if (line.indexOf("[LLOG]") != -1) return "<span class='warning'>" + line + "</span>\n";
+	return line + "\n";
+}
+
+/**
+ * @brief Füllt den nächsten Abschnitt einer Journal-Ausgabe.
  *
- * Unterstützt Syntax-Highlighting basierend auf Log-Level ([INFO], [ERROR], etc.).
+ * Liest die Segmente nacheinander, bis ein Chunk gefüllt ist; Zeilen ohne passendes
+ * Kategorie-Bit werden übersprungen. Dadurch liegt nie mehr als ein Chunk plus eine Zeile im Speicher.
  *
- * @param request HTTP-Anfrage, die den Parameter `level` enthalten muss.
+ * @return Anzahl geschriebener Bytes (0 beendet die Antwort).
+ */
+static size_t fillJournalView(JournalView &view, uint8_t *buf, size_t maxLen) {
+	size_t written = 0;
+	while (written < maxLen) {
+		if (view.offset >= view.pending.length()) {
+			view.pending = "";
+			view.offset = 0;
+			if (view.stage == 0) {
+				view.pending = "<!DOCTYPE html>\n<html lang=\"de\">\n<head>\n  <meta charset=\"utf-8\">\n  <title>Log-File: " + view.title +
+				               "</title>\n\t<link rel=\"stylesheet\" href=\"css/style.css\">\n</head>\n<body>\n  <h1>Log-File: " + view.title +
+				               "</h1>\n  <pre>\n";
+				view.stage = 1;
+			} else if (view.stage == 1) {
+				if (!view.file || !view.file.available()) {
+					if (view.file) view.file.close();
+					// Nächstes Segment; inzwischen gelöschte werden übersprungen
+					if (view.next < view.segments.size()) {
+						view.file = LittleFS.open(view.segments[view.next++], "r");
+						view.markTime = 0;
+					} else {
+						view.stage = 2;
+					}
+					continue;
+				}
+				String line = view.file.readStringUntil('\n');
+				if (LogJournal::isBinary(line.c_str(), line.length())) {
+					// Binärer Eintrag: Text erst hier aus Format und Argumenten
+					uint8_t payload[LogCodec::ENTRY_HEADER + LogRecord::TEXT];
+					uint8_t bits;
+					size_t len;
+					if (!LogJournal::parseBinary(line.c_str(), line.length(), bits, payload, sizeof(payload), len)) continue;
+					if (bits == 0) {
+						LogCodec::decodeMark(payload, len, view.markTime);
+						continue;
+					}
+					LogBinaryEntry entry;
+					if (!(bits & view.mask) || !LogCodec::decodeEntry(payload, len, entry)) continue;
+					char text[LogQueue::LINE_BYTES];
+					LogCodec::renderLine(entry.cats, view.markTime + entry.delta, entry.format, entry.args, entry.argBytes, text, sizeof(text));
+					view.pending = highlightLogLine(String(text));
+					continue;
+				}
+				uint16_t files;
+				const char *text;
+				if (!LogJournal::parse(line.c_str(), line.length(), files, text) || !(files & view.mask)) continue;
+				view.pending = highlightLogLine(String(text));
+			} else if (view.stage == 2) {
+				view.pending = "  </pre>\n</body>\n</html>\n";
+				view.stage = 3;
+			} else {
+				break;
+			}
+		}
+		size_t n = view.pending.length() - view.offset;
+		if (n > maxLen - written) n = maxLen - written;
+		memcpy(buf + written, view.pending.c_str() + view.offset, n);
+		view.offset += n;
+		written += n;
+	}
+	return written;
+}
+
+/**
+ * @brief Sendet die Einträge einer Kategorie aus dem Journal als HTML-Seite.
+ *
+ * Unterstützt Syntax-Highlighting basierend auf Log-Level ([INFO], [ERROR], etc.). Die Seite wird
+ * in Chunks direkt aus den Journal-Segmenten erzeugt, statt sie vollständig im RAM aufzubauen;
+ * `level=all` zeigt alle Kategorien. Binäre Einträge werden dabei in Text umgesetzt.
+ * `segment=journal.<n>.log` liefert stattdessen ein Segment unverändert (für tools/log-decoder).
+ *
+ * @param request HTTP-Anfrage, die den Parameter `level` oder `segment` enthalten muss.
  */
 void WebServerManager::serveSystemLog(AsyncWebServerRequest *request) {
+	if (request->hasParam("segment", false)) {
+		String name = request->getParam("segment", false)->value();
+		// Nur bekannte Segmente, keine beliebigen Pfade
+		for (const auto &path : logger.journalSegments()) {
+			if (path.endsWith("/" + name)) {
+				request->send(LittleFS, path, "application/octet-stream", true);
+				return;
+			}
+		}
+		request->send(404, "text/plain", "Segment nicht gefunden");
+		return;
+	}
 	// Query-Parameter prüfen
 	if (!request->hasParam("level", false)) {
 		request->send(400, "text/plain", "Missing 'level'");
@@ -120,66 +265,29 @@ void WebServerManager::serveSystemLog(AsyncWebServerRequest *request) {
 	}
 	String lvl = request->getParam("level", false)->value();
 	lvl.toLowerCase();
-	if (std::find(LLog::Events.begin(), LLog::Events.end(), lvl) == LLog::Events.end()) {
-		request->send(400, "text/plain", "Ungültiges Log-Level");
-		return;
+	uint16_t mask = 0xFFFF;
+	if (lvl != "all") {
+		if (std::find(LLog::Events.begin(), LLog::Events.end(), lvl) == LLog::Events.end()) {
+			request->send(400, "text/plain", "Ungültiges Log-Level");
+			return;
+		}
+		mask = LLog::categoryBit(lvl.c_str());
 	}
-	String path = "/logs/system/" + lvl + ".log";
-	if (!LittleFS.exists(path)) {
+	auto view = std::make_shared<JournalView>();
+	view->segments = logger.journalSegments();
+	if (view->segments.empty()) {
 		request->send(404, "text/plain", "Log-Datei nicht gefunden");
 		return;
 	}
+	view->next = 0;
+	view->mask = mask;
+	view->title = lvl;
+	view->stage = 0;
+	view->offset = 0;
+	view->markTime = 0;
 
-	// Datei öffnen
-	File f = LittleFS.open(path, "r");
-	if (!f) {
-		request->send(500, "text/plain", "Konnte Log nicht öffnen");
-		return;
-	}
-
-	// HTML-Kopf mit Titel und Inline-CSS
-	String html = R"rawliteral(
-<!DOCTYPE html>
-<html lang="de">
-<head>
-  <meta charset="utf-8">
-  <title>Log-File: )rawliteral" +
-	              lvl + R"rawliteral(</title>
-	<link rel="stylesheet" href="css/style.css">
-</head>
-<body>
-  <h1>Log-File: )rawliteral" +
-	              lvl + R"rawliteral(</h1>
-  <pre>
-)rawliteral";
-
-	// Zeile für Zeile einlesen und spannen‐weise einfärben
-	while (f.available()) {
-		String line = f.readStringUntil('\n');
-		// Prüfen, ob "[INFO]" / "[ERROR]" / "[WARNING]" im String vorkommt
-		if (line.indexOf("[INFO]") != -1) {
-			html += "<span class='info'>" + line + "</span>\n";
-		} else if (line.indexOf("[ERROR]") != -1) {
-			html += "<span class='error'>" + line + "</span>\n";
-		} else if (line.indexOf("[WARNING]") != -1) {
-			html += "<span class='warning'>" + line + "</span>\n";
-		} else if (line.indexOf("[LLOG]") != -1) {
-			html += "<span class='warning'>" + line + "</span>\n";
-		} else {
-			html += line + "\n";
-		}
-	}
-	f.close();
-
-	// HTML-Fuß
-	html += R"rawliteral(
-  </pre>
-</body>
-</html>
-)rawliteral";
-
-	// Abschicken als HTML
-	request->send(200, "text/html", html);
+	// Abschicken als HTML, Chunk für Chunk
+	request->send(request->beginChunkedResponse("text/html", [view](uint8_t *buf, size_t maxLen, size_t) -> size_t { return fillJournalView(*view, buf, maxLen); }));
 }
 
 /**
@@ -202,7 +310,129 @@ void WebServerManager::serveDeviceLog(AsyncWebServerRequest *request) {
 		request->send(404, "text/plain", "File not found");
 		return;
 	}
-	auto res = request->beginResponse(LittleFS, path, "text/plain");
+	// Mitschnitte (*.cap) sind binär
+	auto res = request->beginResponse(LittleFS, path, fn.endsWith(".cap") ? "application/octet-stream" : "text/plain");
 	res->addHeader("Access-Control-Allow-Origin", "*");
 	request->send(res);
 }
+
+/**
+ * @brief Übernimmt einen Block eines Datei-Uploads.
+ *
+ * Query-Parameter: `channel` (Standard 0), `lineDelayMs`, `prompt`, `promptTimeoutMs`, `crlf`
+ * (Standard an) und bei Multipart-Uploads optional `size` für den Fortschritt. Fehler werden
+ * im Zustand vermerkt und erst in finishStream() beantwortet; der Rest des Bodys wird verworfen.
+ *
+ * Die Bibliothek bietet keinen Weg, einen Block später anzunehmen; bei vollem Puffer wartet der
+ * Handler daher, bis die TX-Task Platz schafft. Abgebrochen wird erst, wenn länger als die
+ * größere von Zeilenpause und Prompt-Wartezeit plus STREAM_STALL_MARGIN_MS nichts angenommen
+ * wurde; Zeilenpause und Prompt-Wartezeit allein lösen den Abbruch so nie aus.
+ *
+ * @param request HTTP-Anfrage.
+ * @param data Daten des Blocks.
+ * @param len Länge des Blocks.
+ * @param index Position des Blocks.
+ * @param total Angekündigte Größe (0 = unbekannt).
+ */
+void WebServerManager::handleStreamData(AsyncWebServerRequest *request, const uint8_t *data, size_t len, size_t index, size_t total) {
+	auto *up = static_cast<StreamUpload *>(request->_tempObject);
+	if (index == 0 && !up) {
+		up = static_cast<StreamUpload *>(calloc(1, sizeof(StreamUpload)));
+		if (!up) return;
+		request->_tempObject = up;
+
+		int channel = request->hasParam("channel") ? request->getParam("channel")->value().toInt() : 0;
+		up->bridge = channel >= 0 && channel < SERIAL_CHANNELS ? serialBridges[channel] : nullptr;
+		if (!up->bridge) {
+			up->code = 404;
+			snprintf(up->error, sizeof(up->error), "Unknown channel");
+			return;
+		}
+		SerialFileStreamConfig cfg;
+		memset(&cfg, 0, sizeof(cfg));
+		cfg.size = total ? (uint32_t)total : request->hasParam("size") ? (uint32_t)request->getParam("size")->value().toInt() : 0;
+		cfg.lineDelayMs = request->hasParam("lineDelayMs") ? (uint32_t)request->getParam("lineDelayMs")->value().toInt() : 0;
+		cfg.promptTimeoutMs = request->hasParam("promptTimeoutMs") ? (uint32_t)request->getParam("promptTimeoutMs")->value().toInt() : SerialFileStream::DEFAULT_PROMPT_TIMEOUT_MS;
+		cfg.crlf = true;
+		if (request->hasParam("crlf")) {
+			const String &v = request->getParam("crlf")->value();
+			cfg.crlf = !(v == "0" || v == "false");
+		}
+		if (request->hasParam("prompt")) {
+			const String &prompt = request->getParam("prompt")->value();
+			if (prompt.length() >= sizeof(cfg.prompt)) {
+				up->code = 400;
+				snprintf(up->error, sizeof(up->error), "Prompt too long");
+				return;
+			}
+			snprintf(cfg.prompt, sizeof(cfg.prompt), "%s", prompt.c_str());
+		}
+		char err[48];
+		if (!up->bridge->startStream(cfg, err, sizeof(err))) {
+			up->code = SerialFileStream::validate(cfg) ? 409 : 400;
+			snprintf(up->error, sizeof(up->error), "%s", err);
+			return;
+		}
+		up->started = true;
+		// Längste reguläre Pause der TX-Task: Zeilenpause bzw. Warten auf den Prompt
+		up->stallMs = (cfg.lineDelayMs > cfg.promptTimeoutMs ? cfg.lineDelayMs : cfg.promptTimeoutMs) + STREAM_STALL_MARGIN_MS;
+		// Abbruch der Verbindung vor dem Dateiende: Rest nicht senden
+		request->onDisconnect([request]() {
+			auto *state = static_cast<StreamUpload *>(request->_tempObject);
+			if (state && state->started && !state->finished) {
+				state->finished = true;
+				state->bridge->cancelStream();
+			}
+		});
+	}
+	if (!up || !up->started || up->finished) return;
+
+	uint32_t lastProgress = millis();
+	while (len > 0) {
+		size_t n = up->bridge->feedStream(data, len);
+		if (n > 0) {
+			data += n;
+			len -= n;
+			up->bytes += (uint32_t)n;
+			lastProgress = millis();
+			continue;
+		}
+		if (up->bridge->getStream().state() != FILE_STREAM_RUNNING) {
+			// z. B. Prompt nicht erhalten oder per WebSocket abgebrochen
+			up->finished = true;
+			up->code = 409;
+			snprintf(up->error, sizeof(up->error), "Transfer aborted");
+			return;
+		}
+		if (millis() - lastProgress >= up->stallMs) {
+			up->finished = true;
+			up->bridge->cancelStream();
+			up->code = 503;
+			snprintf(up->error, sizeof(up->error), "Device not accepting data");
+			return;
+		}
+		vTaskDelay(pdMS_TO_TICKS(STREAM_FEED_WAIT_MS));
+	}
+}
+
+/**
+ * @brief Beantwortet einen Datei-Upload.
+ *
+ * @param request HTTP-Anfrage.
+ */
+void WebServerManager::finishStream(AsyncWebServerRequest *request) {
+	auto *up = static_cast<StreamUpload *>(request->_tempObject);
+	if (!up) {
+		request->send(400, "text/plain", "Empty body");
+		return;
+	}
+	if (up->code) {
+		request->send(up->code, "text/plain", up->error);
+		return;
+	}
+	if (!up->finished) {
+		up->finished = true;
+		up->bridge->endStream();
+	}
+	request->send(202, "application/json", "{\"channel\":" + String(up->bridge->getChannel()) + ",\"bytes\":" + String(up->bytes) + "}");
+}
@@ -11,13 +11,18 @@
  * - WS_EVT_DISCONNECT: Verbindungsabbruch
  * - WS_EVT_ERROR: Fehler beim Client
  * - WS_EVT_PONG: Antwort auf Ping
- * - WS_EVT_DATA: Empfangene Daten (werden an spezialisierte Event-Handler übergeben)
+ * - WS_EVT_DATA: Empfangene Daten (werden an spezialisierte Event-Handler übergeben, binäre
+ *   Nachrichten an handleSerialUpload)
  *
  * Die WebSocketManager-Klasse übernimmt die Weiterleitung an:
  * - System-Events (handleSystemEvent)
  * - Log-Events (handleLogEvent)
  * - Serial-Events (handleSerialEvent)
  *
+ * Gesendet wird nicht direkt, sondern über die WsOutbox (siehe WsOutbox.h). Die Pump-Task
+ * übergibt eine Nachricht erst an AsyncTCP, wenn dort höchstens SINK_QUEUE_DEPTH Nachrichten
+ * des Clients warten.
+ *
  * @author Simon Marcel Linden
  * @since 1.0.0
  */
@@ -28,7 +33,7 @@
 #include "WsEvents.h"
 #include "global.h"
 
-extern SerialBridge *serialBridge;
+extern SerialBridge *serialBridges[SERIAL_CHANNELS];
 /**
  * @brief Konstruktor für WebSocketManager.
  *
@@ -36,7 +41,7 @@ extern SerialBridge *serialBridge;
  *
  * @param path WebSocket-Endpunkt, z. B. "/ws"
  */
-WebSocketManager::WebSocketManager(const String &path) : ws(path) {
+WebSocketManager::WebSocketManager(const String &path) : ws(path), _sink(ws), _outbox(_sink), _pumpTask(nullptr) {
 }
 
 /**
@@ -52,6 +57,10 @@ void WebSocketManager::init(AsyncWebServer &httpServer) {
 
 	// Statischer Callback ruft Member-Methoden auf
 	ws.onEvent(_onEvent);
+
+	// Sendewarteschlangen leeren
+	_outbox.onEnqueue(wakePump, this);
+	xTaskCreatePinnedToCore(pumpTask, "WsOutboxTask", 4096, this, 2, &_pumpTask, 1);
 }
 
 /**
@@ -65,6 +74,92 @@ AsyncWebSocket &WebSocketManager::getSocket() {
 	return ws;
 }
 
+/**
+ * @brief Gibt die Sendewarteschlangen aller Clients zurück.
+ *
+ * @return Referenz auf die WsOutbox.
+ */
+WsOutbox &WebSocketManager::getOutbox() {
+	return _outbox;
+}
+
+/**
+ * @brief Reiht eine Steuerantwort für einen Client ein.
+ *
+ * @param client Ziel-Client.
+ * @param payload JSON-Text.
+ */
+void WebSocketManager::sendControl(AsyncWebSocketClient *client, const String &payload) {
+	_outbox.enqueue(client->id(), WS_PRIO_CONTROL, (const uint8_t *)payload.c_str(), payload.length(), false, millis());
+}
+
+/**
+ * @brief Task zum Leeren der Warteschlangen.
+ *
+ * Wacht beim Einreihen sofort auf, sonst alle PUMP_INTERVAL_MS, damit Nachrichten für
+ * zwischenzeitlich blockierte Clients nachgeschoben werden.
+ *
+ * @param param Zeiger auf die WebSocketManager-Instanz.
+ */
+void WebSocketManager::pumpTask(void *param) {
+	auto *self = static_cast<WebSocketManager *>(param);
+	for (;;) {
+		ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PUMP_INTERVAL_MS));
+		self->_outbox.pump(millis());
+	}
+}
+
+/**
+ * @brief Callback der WsOutbox: weckt die Pump-Task.
+ *
+ * @param ctx Zeiger auf die WebSocketManager-Instanz.
+ */
+void WebSocketManager::wakePump(void *ctx) {
+	auto *self = static_cast<WebSocketManager *>(ctx);
+	if (self->_pumpTask) xTaskNotifyGive(self->_pumpTask);
+}
+
+/**
+ * @brief Kann der Client eine weitere Nachricht annehmen?
+ *
+ * @param id Client-ID.
+ * @return true, wenn verbunden und die AsyncTCP-Warteschlange kurz genug ist.
+ */
+bool WebSocketManager::Sink::canSend(uint32_t id) {
+	AsyncWebSocketClient *client = _ws.client(id);
+	return client && client->status() == WS_CONNECTED && client->queueLen() < SINK_QUEUE_DEPTH;
+}
+
+/**
+ * @brief Übergibt eine Nachricht an AsyncWebSocket.
+ *
+ * @param id Client-ID.
+ * @param data Nachricht.
+ * @param len Länge.
+ * @param binary true = Binär-Frame.
+ */
+void WebSocketManager::Sink::send(uint32_t id, const uint8_t *data, size_t len, bool binary) {
+	AsyncWebSocketClient *client = _ws.client(id);
+	if (!client) return;
+	if (binary) {
+		client->binary((const char *)data, len);
+	} else {
+		client->text((const char *)data, len);
+	}
+}
+
+/**
+ * @brief Trennt einen Client (Strategie WS_SLOW_DISCONNECT).
+ *
+ * @param id Client-ID.
+ */
+void WebSocketManager::Sink::close(uint32_t id) {
+	AsyncWebSocketClient *client = _ws.client(id);
+	if (!client) return;
+	LOGB(LOG_CAT_SOCKET | LOG_CAT_WARNING, LOG_FMT_WS_CLIENT_TOO_SLOW, (unsigned)id);
+	client->close();
+}
+
 /**
  * @brief Statischer Callback-Wrapper zur Weiterleitung auf handleEvent().
  *
@@ -99,19 +194,38 @@ void WebSocketManager::_onEvent(AsyncWebSocket *server, AsyncWebSocketClient *cl
 void WebSocketManager::handleEvent(AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len) {
 	switch (type) {
 		case WS_EVT_CONNECT:
-			logger.log({"socket", "info"}, "WS Client connected: " + String(client->id()));
-			if (serialBridge) serialBridge->sendAvailability();
+			LOGB(LOG_CAT_SOCKET | LOG_CAT_INFO, LOG_FMT_WS_CLIENT_CONNECTED, (unsigned)client->id());
+			if (!_outbox.attach(client->id())) {
+				LOGB(LOG_CAT_SOCKET | LOG_CAT_ERROR, LOG_FMT_WS_NO_SEND_BUFFER, (unsigned)client->id());
+				client->close();
+				break;
+			}
+			for (SerialBridge *bridge : serialBridges) {
+				if (!bridge) continue;
+				bridge->addClient(client->id());
+				bridge->sendAvailability();
+			}
 			break;
 		case WS_EVT_DISCONNECT:
-			logger.log({"socket", "info"}, "WS Client disconnected: " + String(client->id()));
+			LOGB(LOG_CAT_SOCKET | LOG_CAT_INFO, LOG_FMT_WS_CLIENT_DISCONNECTED, (unsigned)client->id());
+			for (SerialBridge *bridge : serialBridges) {
+				if (bridge) bridge->removeClient(client->id());
+			}
+			_outbox.detach(client->id());
 			break;
 		case WS_EVT_ERROR:
-			logger.log({"socket", "error"}, "WS Error on client " + String(client->id()));
+			LOGB(LOG_CAT_SOCKET | LOG_CAT_ERROR, LOG_FMT_WS_CLIENT_ERROR, (unsigned)client->id());
 			break;
 		case WS_EVT_PONG:
-			logger.log({"socket", "info"}, "WS Pong from client " + String(client->id()));
+			LOGB(LOG_CAT_SOCKET | LOG_CAT_INFO, LOG_FMT_WS_CLIENT_PONG, (unsigned)client->id());
 			break;
 		case WS_EVT_DATA: {
+			// Binäre Nachrichten sind Upload-Blöcke des Durchreichens
+			const AwsFrameInfo *info = static_cast<const AwsFrameInfo *>(arg);
+			if (info->message_opcode == WS_BINARY) {
+				handleSerialUpload(client, info, data, len);
+				break;
+			}
 			// parse und dispatch
 			ParsedMessage msg = parseWebSocketMessage((char *)data);
 			onData(client, msg);
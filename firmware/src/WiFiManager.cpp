@@ -210,7 +210,7 @@ std::vector<Network> WiFiManager::scan() const {
 	for (int i = 0; i < n; ++i) {
 		results.push_back({WiFi.SSID(i), WiFi.RSSI(i), WiFi.encryptionType(i), WiFi.channel(i)});
 	}
-	logger.log({"system", "info", "wifi"}, String("Scan gefunden: ") + String(n) + " Netze");
+	LOGB(LOG_CAT_SYSTEM | LOG_CAT_INFO | LOG_CAT_WIFI, LOG_FMT_WIFI_SCAN_FOUND, n);
 	return results;
 }
 
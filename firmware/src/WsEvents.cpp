@@ -13,8 +13,11 @@
 #include <LittleFS.h>
 
 #include "SerialBridge.h"
+#include "WebSocketManager.h"
+#include "global.h"
 
-extern SerialBridge *serialBridge;
+extern SerialBridge *serialBridges[SERIAL_CHANNELS];
+extern WebSocketManager webSocketManager;
 
 /**
  * @brief Konvertiert einen Event-Typ-String in das passende Enum.
@@ -32,21 +35,408 @@ WsEvents getEventType(const String &type) {
 /**
  * @brief Parst eine WebSocket-Nachricht aus JSON zu einer `ParsedMessage`.
  *
+ * Das Dokument wächst mit der Nachricht, damit auch Skripte in `value` Platz haben.
+ *
  * @param jsonData Die rohen JSON-Daten.
- * @return ParsedMessage mit Feldern `eventType`, `command`, `key`, `value`.
+ * @return ParsedMessage mit Feldern `eventType`, `command`, `key`, `value`, `channel`.
  */
 ParsedMessage parseWebSocketMessage(const char *jsonData) {
-	ParsedMessage msg{WS_EVT_SYSTEM, "", "", ""};
-	StaticJsonDocument<256> doc;
+	ParsedMessage msg{WS_EVT_SYSTEM, "", "", "", 0};
+	DynamicJsonDocument doc(strlen(jsonData) + 256);
 	if (deserializeJson(doc, jsonData) == DeserializationError::Ok) {
 		msg.eventType = getEventType(doc["type"].as<String>());
 		msg.command = doc["command"].as<String>();
 		msg.key = doc["key"].as<String>();
 		msg.value = doc["value"].as<String>();
+		// Als int lesen: ein uint8_t machte aus 256 still Kanal 0
+		JsonVariantConst channel = doc["channel"];
+		msg.channel = channel.isNull() ? 0 : channel.is<int>() ? channel.as<int>() : -1;
 	}
 	return msg;
 }
 
+/**
+ * @brief Liefert die SerialBridge eines Kanals.
+ *
+ * @param channel Kanal-ID aus der Nachricht.
+ * @return Bridge oder nullptr bei unbekanntem Kanal.
+ */
+static SerialBridge *serialBridgeFor(int channel) {
+	return channel >= 0 && channel < SERIAL_CHANNELS ? serialBridges[channel] : nullptr;
+}
+
+/**
+ * @brief Gibt an, ob auf dem Kanal gerade durchgereicht wird (Senden, Baudrate, Skripte gesperrt).
+ */
+static bool passthroughBusy(const SerialBridge *bridge) {
+	return bridge->getPassthrough().state() != PASSTHROUGH_IDLE;
+}
+
+/**
+ * @brief Gibt an, ob auf dem Kanal gerade eine Datei gesendet wird (Skripte gesperrt).
+ */
+static bool streamBusy(const SerialBridge *bridge) {
+	return bridge->getStream().state() != FILE_STREAM_IDLE;
+}
+
+/**
+ * @brief Trägt Verfügbarkeit und Baudrate aller Kanäle in ein Array ein.
+ *
+ * @param arr Zielarray.
+ */
+static void addSerialChannels(JsonArray arr) {
+	for (uint8_t ch = 0; ch < SERIAL_CHANNELS; ++ch) {
+		if (!serialBridges[ch]) continue;
+		JsonObject o = arr.createNestedObject();
+		o["channel"] = ch;
+		o["available"] = serialBridges[ch]->isDeviceConnected();
+		o["baudRate"] = serialBridges[ch]->getBaudRate();
+	}
+}
+
+/**
+ * @brief Liest eine Bytefolge aus einem String (`"\r\n"`) oder einem Array von Bytewerten.
+ *
+ * @param src JSON-Wert.
+ * @param out Zielpuffer.
+ * @param max Größe des Zielpuffers.
+ * @return Anzahl der Bytes oder -1, wenn der Wert ungültig oder zu lang ist.
+ */
+static int readFramingBytes(JsonVariantConst src, uint8_t *out, size_t max) {
+	size_t n = 0;
+	if (src.is<const char *>()) {
+		const char *str = src.as<const char *>();
+		for (; str[n] != '\0'; ++n) {
+			if (n >= max) return -1;
+			out[n] = (uint8_t)str[n];
+		}
+		return (int)n;
+	}
+	if (!src.is<JsonArrayConst>()) return -1;
+	for (JsonVariantConst v : src.as<JsonArrayConst>()) {
+		if (n >= max || !v.is<uint8_t>()) return -1;
+		out[n++] = v.as<uint8_t>();
+	}
+	return (int)n;
+}
+
+/**
+ * @brief Trägt eine Bytefolge als Array von Bytewerten ein.
+ */
+static void addFramingBytes(JsonObject det, const char *key, const uint8_t *bytes, size_t len) {
+	JsonArray arr = det.createNestedArray(key);
+	for (size_t i = 0; i < len; ++i) arr.add(bytes[i]);
+}
+
+/**
+ * @brief Prüft einen Skriptnamen (1–31 Zeichen aus Buchstaben, Ziffern, `_` und `-`).
+ */
+static bool isValidScriptName(const String &name) {
+	if (name.length() == 0 || name.length() > 31) return false;
+	for (size_t i = 0; i < name.length(); ++i) {
+		char c = name[i];
+		if (!isalnum((unsigned char)c) && c != '_' && c != '-') return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Pfad eines abgelegten Skripts.
+ */
+static String scriptPath(const String &name) {
+	return "/scripts/" + name + ".txt";
+}
+
+/**
+ * @brief Lädt ein abgelegtes Skript.
+ *
+ * @param name Gültiger Skriptname.
+ * @param out Skripttext.
+ * @return false, wenn die Datei fehlt oder größer als SerialScriptEngine::MAX_SOURCE ist.
+ */
+static bool loadScript(const String &name, String &out) {
+	File f = LittleFS.open(scriptPath(name), "r");
+	if (!f) return false;
+	if (f.size() > SerialScriptEngine::MAX_SOURCE) {
+		f.close();
+		return false;
+	}
+	out = f.readString();
+	f.close();
+	return true;
+}
+
+/**
+ * @brief Pfad der gespeicherten Abfragen eines Kanals.
+ */
+static String pollPath(uint8_t channel) {
+	return "/poll/ch" + String(channel) + ".json";
+}
+
+/**
+ * @brief Kopiert einen String in einen festen Puffer.
+ *
+ * @return false, wenn er (inkl. '\0') nicht hineinpasst.
+ */
+static bool copyText(char *out, size_t size, const char *text) {
+	size_t len = strlen(text);
+	if (len >= size) return false;
+	memcpy(out, text, len + 1);
+	return true;
+}
+
+/**
+ * @brief Liest die Abfragen aus JSON: `{"polls":[{name, send, expect, fields, intervalMs, timeoutMs}], "hideReplies"}`.
+ *
+ * @param json JSON-Text.
+ * @param cfg Ziel (wird vollständig überschrieben).
+ * @param error Fehlerbeschreibung bei Rückgabe false.
+ * @return false bei ungültigem JSON oder zu langen Texten; die Prüfung der Werte macht setPoll().
+ */
+static bool readPollConfig(const String &json, SerialPollerConfig &cfg, String &error) {
+	memset(&cfg, 0, sizeof(cfg));
+	DynamicJsonDocument doc(json.length() + 1024);
+	if (deserializeJson(doc, json) != DeserializationError::Ok) {
+		error = "Invalid JSON";
+		return false;
+	}
+	cfg.hideReplies = doc["hideReplies"] | false;
+	JsonArrayConst polls = doc["polls"].as<JsonArrayConst>();
+	if (polls.size() > SerialPollerConfig::MAX_POLLS) {
+		error = "Zu viele Abfragen";
+		return false;
+	}
+	for (JsonVariantConst v : polls) {
+		JsonObjectConst o = v.as<JsonObjectConst>();
+		SerialPollEntry &e = cfg.polls[cfg.count++];
+		const char *send = o["send"] | "";
+		e.requestLen = strlen(send);
+		JsonArrayConst fields = o["fields"].as<JsonArrayConst>();
+		bool ok = copyText(e.name, sizeof(e.name), o["name"] | "") && copyText(e.pattern, sizeof(e.pattern), o["expect"] | "") &&
+		          e.requestLen <= sizeof(e.request) && fields.size() <= SerialPollEntry::MAX_FIELDS;
+		for (JsonVariantConst f : fields) {
+			if (!ok) break;
+			ok = copyText(e.fields[e.fieldCount++], SerialPollEntry::MAX_NAME, f | "");
+		}
+		if (!ok) {
+			error = "Abfrage " + String(cfg.count) + ": Text zu lang oder zu viele Felder";
+			return false;
+		}
+		memcpy(e.request, send, e.requestLen);
+		e.intervalMs = o["intervalMs"] | 1000;
+		e.timeoutMs = o["timeoutMs"] | SerialPoller::DEFAULT_TIMEOUT_MS;
+	}
+	return true;
+}
+
+/**
+ * @brief Trägt Felder des Pollers mit Wert, Zustand und Alter ein.
+ *
+ * @param det Zielobjekt.
+ * @param poller Feldspeicher.
+ * @param mask Bitmaske der Felder.
+ */
+static void addPollFields(JsonObject det, const SerialPoller &poller, uint32_t mask) {
+	JsonObject fields = det.createNestedObject("fields");
+	SerialPollField f;
+	uint32_t now = millis();
+	for (size_t idx = 0; poller.field(idx, f); ++idx) {
+		if (!(mask & (1UL << idx))) continue;
+		JsonObject o = fields.createNestedObject(f.name);
+		if (f.set) {
+			o["value"] = (char *)f.value;
+			o["ageMs"] = now - f.updatedMs;
+		} else {
+			o["value"] = nullptr;
+		}
+		o["stale"] = f.stale;
+		o["changes"] = f.changes;
+	}
+}
+
+/**
+ * @brief Pfad der gespeicherten Regeln eines Kanals.
+ */
+static String triggerPath(uint8_t channel) {
+	return "/triggers/ch" + String(channel) + ".json";
+}
+
+/// Namen der Aktionen in JSON, Index = Bitnummer in SerialTriggerAction
+static const char *const TRIGGER_ACTIONS[] = {"alert", "log", "status", "snapshot"};
+
+/// Namen der Stufen in JSON, Index = SerialTriggerLevel
+static const char *const TRIGGER_LEVELS[] = {"info", "warning", "error"};
+
+/**
+ * @brief Liest Regeln aus JSON: `{"rules":[{name, contains|prefix, ignoreCase, actions, level, cooldownMs}]}`.
+ *
+ * Ohne `actions` gelten `alert` und `log`, ohne `level` gilt `warning`.
+ *
+ * @param json JSON-Text.
+ * @param cfg Ziel (wird vollständig überschrieben).
+ * @param error Fehlerbeschreibung bei Rückgabe false.
+ * @return false bei ungültigem JSON, unbekannten Namen oder zu langen Texten; die übrigen
+ *         Prüfungen macht setTriggers().
+ */
+static bool readTriggerConfig(const String &json, SerialTriggerConfig &cfg, String &error) {
+	memset(&cfg, 0, sizeof(cfg));
+	DynamicJsonDocument doc(json.length() + 2048);
+	if (deserializeJson(doc, json) != DeserializationError::Ok) {
+		error = "Invalid JSON";
+		return false;
+	}
+	JsonArrayConst rules = doc["rules"].as<JsonArrayConst>();
+	if (rules.size() > SerialTriggerConfig::MAX_RULES) {
+		error = "Zu viele Regeln";
+		return false;
+	}
+	for (JsonVariantConst v : rules) {
+		JsonObjectConst o = v.as<JsonObjectConst>();
+		SerialTriggerRule &r = cfg.rules[cfg.count++];
+		const char *prefix = o["prefix"].as<const char *>();
+		r.prefix = prefix != nullptr;
+		r.ignoreCase = o["ignoreCase"] | false;
+		r.cooldownMs = o["cooldownMs"] | SerialTrigger::DEFAULT_COOLDOWN_MS;
+		if (!copyText(r.name, sizeof(r.name), o["name"] | "") || !copyText(r.text, sizeof(r.text), prefix ? prefix : (o["contains"] | ""))) {
+			error = "Regel " + String(cfg.count) + ": Name oder Text zu lang";
+			return false;
+		}
+		const char *level = o["level"] | "warning";
+		r.level = 0xFF;
+		for (uint8_t k = 0; k <= TRIGGER_ERROR; ++k) {
+			if (strcmp(level, TRIGGER_LEVELS[k]) == 0) r.level = k;
+		}
+		if (r.level == 0xFF) {
+			error = String(r.name) + ": Unbekannte Stufe " + level;
+			return false;
+		}
+		if (o["actions"].isNull()) {
+			r.actions = TRIGGER_ACTION_ALERT | TRIGGER_ACTION_LOG;
+			continue;
+		}
+		for (JsonVariantConst a : o["actions"].as<JsonArrayConst>()) {
+			const char *name = a | "";
+			uint8_t bit = 0;
+			for (size_t k = 0; k < sizeof(TRIGGER_ACTIONS) / sizeof(TRIGGER_ACTIONS[0]); ++k) {
+				if (strcmp(name, TRIGGER_ACTIONS[k]) == 0) bit = (uint8_t)(1u << k);
+			}
+			if (bit == 0) {
+				error = String(r.name) + ": Unbekannte Aktion " + name;
+				return false;
+			}
+			r.actions |= bit;
+		}
+	}
+	return true;
+}
+
+/// Schlüssel der Filterregeln in JSON, Index = SerialFilterKind
+static const char *const FILTER_KINDS[] = {"prefix", "contains", "regex"};
+
+/**
+ * @brief Liest einen Zeilenfilter aus JSON: `{"include":[{"prefix"|"contains"|"regex": text, "ignoreCase"}], "exclude":[...]}`.
+ *
+ * @param json JSON-Text.
+ * @param spec Ziel (wird vollständig überschrieben).
+ * @param error Fehlerbeschreibung bei Rückgabe false.
+ * @return false bei ungültigem JSON, unbekannter Regel oder zu vielen/zu langen Regeln.
+ */
+static bool readFilterSpec(const String &json, SerialFilterSpec &spec, String &error) {
+	memset(&spec, 0, sizeof(spec));
+	DynamicJsonDocument doc(json.length() + 512);
+	if (deserializeJson(doc, json) != DeserializationError::Ok || !doc.is<JsonObject>()) {
+		error = "Invalid JSON";
+		return false;
+	}
+	for (int exclude = 0; exclude < 2; ++exclude) {
+		for (JsonVariantConst v : doc[exclude ? "exclude" : "include"].as<JsonArrayConst>()) {
+			JsonObjectConst o = v.as<JsonObjectConst>();
+			if (spec.count >= SerialFilterSpec::MAX_RULES) {
+				error = "Zu viele Regeln";
+				return false;
+			}
+			SerialFilterRule &rule = spec.rules[spec.count++];
+			rule.exclude = exclude != 0;
+			rule.ignoreCase = o["ignoreCase"] | false;
+			const char *text = nullptr;
+			for (uint8_t kind = FILTER_PREFIX; kind <= FILTER_REGEX && !text; ++kind) {
+				text = o[FILTER_KINDS[kind]].as<const char *>();
+				rule.kind = kind;
+			}
+			if (!text || !copyText(rule.text, sizeof(rule.text), text)) {
+				error = "Regel " + String(spec.count) + ": prefix, contains oder regex fehlt oder ist zu lang";
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Trägt die Regeln eines Zeilenfilters im Format von readFilterSpec() ein.
+ *
+ * @param det Zielobjekt.
+ * @param spec Regelsatz.
+ */
+static void addFilterRules(JsonObject det, const SerialFilterSpec &spec) {
+	JsonArray include = det.createNestedArray("include");
+	JsonArray exclude = det.createNestedArray("exclude");
+	for (size_t i = 0; i < spec.count; ++i) {
+		const SerialFilterRule &rule = spec.rules[i];
+		JsonObject o = (rule.exclude ? exclude : include).createNestedObject();
+		o[FILTER_KINDS[rule.kind]] = rule.text;
+		if (rule.ignoreCase) o["ignoreCase"] = true;
+	}
+}
+
+/**
+ * @brief Lädt und übersetzt die gespeicherten Regeln aller Kanäle.
+ */
+void loadSerialTriggers() {
+	for (uint8_t ch = 0; ch < SERIAL_CHANNELS; ++ch) {
+		if (!serialBridges[ch]) continue;
+		File f = LittleFS.open(triggerPath(ch), "r");
+		if (!f) continue;
+		String json = f.readString();
+		f.close();
+		SerialTriggerConfig *cfg = new SerialTriggerConfig();
+		String error;
+		char err[64];
+		if (!readTriggerConfig(json, *cfg, error)) {
+			logger.log({"system", "error", "device"}, "Regeln Kanal " + String(ch) + ": " + error);
+		} else if (!serialBridges[ch]->setTriggers(*cfg, err, sizeof(err))) {
+			logger.log({"system", "error", "device"}, "Regeln Kanal " + String(ch) + ": " + err);
+		} else {
+			logger.log({"system", "info", "device"}, "Regeln Kanal " + String(ch) + ": " + String(cfg->count) + " geladen");
+		}
+		delete cfg;
+	}
+}
+
+/**
+ * @brief Lädt die gespeicherten Abfragen aller Kanäle.
+ */
+void loadSerialPolls() {
+	for (uint8_t ch = 0; ch < SERIAL_CHANNELS; ++ch) {
+		if (!serialBridges[ch]) continue;
+		File f = LittleFS.open(pollPath(ch), "r");
+		if (!f) continue;
+		String json = f.readString();
+		f.close();
+		SerialPollerConfig *cfg = new SerialPollerConfig();
+		String error;
+		char err[64];
+		if (!readPollConfig(json, *cfg, error)) {
+			logger.log({"system", "error", "device"}, "Abfragen Kanal " + String(ch) + ": " + error);
+		} else if (!serialBridges[ch]->setPoll(*cfg, err, sizeof(err))) {
+			logger.log({"system", "error", "device"}, "Abfragen Kanal " + String(ch) + ": " + err);
+		} else {
+			logger.log({"system", "info", "device"}, "Abfragen Kanal " + String(ch) + ": " + String(cfg->count) + " geladen");
+		}
+		delete cfg;
+	}
+}
+
 /**
  * @brief Behandelt WebSocket-Nachrichten vom Typ "system".
  *
@@ -55,7 +445,7 @@ ParsedMessage parseWebSocketMessage(const char *jsonData) {
  */
 void handleSystemEvent(AsyncWebSocketClient *client, const ParsedMessage &msg) {
 	if (msg.command == "init") {
-		StaticJsonDocument<512> doc;
+		StaticJsonDocument<768> doc;
 		JsonObject details = doc.createNestedObject("details");
 
 		// 1) logging
@@ -69,10 +459,11 @@ void handleSystemEvent(AsyncWebSocketClient *client, const ParsedMessage &msg) {
 		routes.add("/logs");  // dein Listing-Endpunkt
 		routes.add("/ws");
 
-		// 3) serial
+		// 3) serial (Kanal 0 wie bisher, alle Kanäle unter "channels")
 		JsonObject serial = details.createNestedObject("serial");
-		serial["available"] = serialBridge->isDeviceConnected();
-		serial["baudRate"] = serialBridge->getBaudRate();
+		serial["available"] = serialBridges[0]->isDeviceConnected();
+		serial["baudRate"] = serialBridges[0]->getBaudRate();
+		addSerialChannels(serial.createNestedArray("channels"));
 
 		// 4) version
 		JsonObject version = details.createNestedObject("version");
@@ -104,6 +495,62 @@ void handleSystemEvent(AsyncWebSocketClient *client, const ParsedMessage &msg) {
 		sendResponse(client, "system", "init", "success", details);
 		return;
 	}
+	if (msg.command == "clients") {
+		// Sendewarteschlangen aller Clients
+		WsClientStats stats[WsOutbox::MAX_CLIENTS];
+		size_t n = webSocketManager.getOutbox().stats(stats, WsOutbox::MAX_CLIENTS);
+		DynamicJsonDocument doc(1536);
+		JsonArray arr = doc.to<JsonArray>();
+		for (size_t i = 0; i < n; ++i) {
+			JsonObject o = arr.createNestedObject();
+			o["id"] = stats[i].id;
+			o["self"] = stats[i].id == client->id();
+			o["budget"] = stats[i].budget;
+			o["queuedBytes"] = stats[i].queuedBytes;
+			o["queued"] = stats[i].queued;
+			o["sent"] = stats[i].sent;
+			o["drops"] = stats[i].drops;
+			o["droppedBytes"] = stats[i].droppedBytes;
+			o["maxDelayMs"] = stats[i].maxDelayMs;
+		}
+		sendResponse(client, "system", "clients", "success", arr);
+		return;
+	}
+	if (msg.command == "outbox") {
+		// Speicherbudget und Strategie für langsame Clients
+		StaticJsonDocument<192> req;
+		if (deserializeJson(req, msg.value) != DeserializationError::Ok) {
+			sendResponse(client, "system", "outbox", "error", "", "Invalid JSON");
+			return;
+		}
+		WsOutboxConfig cfg = webSocketManager.getOutbox().config();
+		cfg.clientBudget = req["clientBudget"] | (uint32_t)cfg.clientBudget;
+		cfg.totalBudget = req["totalBudget"] | (uint32_t)cfg.totalBudget;
+		String policy = req["policy"] | "";
+		if (policy == "dropOldest") {
+			cfg.policy = WS_SLOW_DROP_OLDEST;
+		} else if (policy == "coalesce") {
+			cfg.policy = WS_SLOW_COALESCE;
+		} else if (policy == "disconnect") {
+			cfg.policy = WS_SLOW_DISCONNECT;
+		} else if (policy.length() != 0) {
+			sendResponse(client, "system", "outbox", "error", "", "Unknown policy");
+			return;
+		}
+		if (cfg.clientBudget < WsOutbox::MIN_CLIENT_BUDGET || cfg.totalBudget < cfg.clientBudget) {
+			sendResponse(client, "system", "outbox", "error", "", "Ungültiges Budget");
+			return;
+		}
+		webSocketManager.getOutbox().configure(cfg);
+		static const char *const policies[] = {"dropOldest", "coalesce", "disconnect"};
+		StaticJsonDocument<128> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["clientBudget"] = cfg.clientBudget;
+		det["totalBudget"] = cfg.totalBudget;
+		det["policy"] = policies[cfg.policy];
+		sendResponse(client, "system", "outbox", "success", det);
+		return;
+	}
 	if (msg.command != "wifi") {
 		sendResponse(client, "system", "response", "error", "", "Unknown command");
 		return;
@@ -192,12 +639,184 @@ void handleLogEvent(AsyncWebSocketClient *client, const ParsedMessage &msg) {
 		} else {
 			sendResponse(client, "log", "debug", "error", "Unbekannter Key für 'debug'", "");
 		}
+	} else if (msg.command == "rotation") {
+		// 2) log rotation <-> Segmentgröße, Segmentzahl und Budget für /logs (leer = nur Status)
+		LogRotationConfig cfg = logger.rotationConfig();
+		if (msg.value.length() > 0) {
+			StaticJsonDocument<128> req;
+			if (deserializeJson(req, msg.value) != DeserializationError::Ok) {
+				sendResponse(client, "log", "rotation", "error", "", "Invalid JSON");
+				return;
+			}
+			cfg.segmentBytes = req["segmentBytes"] | cfg.segmentBytes;
+			cfg.segments = req["segments"] | cfg.segments;
+			cfg.budget = req["budget"] | cfg.budget;
+			if (cfg.segments == 0 || cfg.segments > LogSegments::MAX_SEGMENTS || cfg.segmentBytes < LogSegments::MIN_SEGMENT_BYTES || cfg.budget < cfg.segmentBytes) {
+				sendResponse(client, "log", "rotation", "error", "", "Ungültige Grenzen");
+				return;
+			}
+			logger.setRotation(cfg);
+			cfg = logger.rotationConfig();
+		}
+		StaticJsonDocument<192> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["segmentBytes"] = cfg.segmentBytes;
+		det["segments"] = cfg.segments;
+		det["budget"] = cfg.budget;
+		det["used"] = (uint32_t)logger.journalSegments().size();
+		det["journalBytes"] = logger.journalBytes();
+		sendResponse(client, "log", "rotation", "success", det);
+	} else if (msg.command == "categories") {
+		// 3) log categories <-> zur Laufzeit gesperrte Kategorien (leer = nur Status)
+		if (msg.value.length() > 0) {
+			StaticJsonDocument<384> req;
+			if (deserializeJson(req, msg.value) != DeserializationError::Ok || !req["disabled"].is<JsonArray>()) {
+				sendResponse(client, "log", "categories", "error", "", "Invalid JSON");
+				return;
+			}
+			uint32_t disabled = 0;
+			for (JsonVariant v : req["disabled"].as<JsonArray>()) {
+				uint32_t bit = LogFilter::parse(v | "");
+				if (!bit) {
+					sendResponse(client, "log", "categories", "error", "", "Unbekannte Kategorie");
+					return;
+				}
+				disabled |= bit;
+			}
+			LLog::setCategories(~disabled);
+		}
+		StaticJsonDocument<512> doc;
+		JsonObject det = doc.to<JsonObject>();
+		JsonArray off = det.createNestedArray("disabled");
+		JsonArray notBuilt = det.createNestedArray("notBuilt");
+		uint32_t enabled = LogFilter::enabledMask();
+		for (uint32_t bit = 1; bit != 0 && LogFilter::name(bit); bit <<= 1) {
+			if (!(enabled & bit)) off.add(LogFilter::name(bit));
+			if (!LogFilter::built(bit)) notBuilt.add(LogFilter::name(bit));
+		}
+		sendResponse(client, "log", "categories", "success", det);
 	} else {
 		// Unbekanntes Command
 		sendResponse(client, "log", "response", "error", "Unbekannter Command bei 'log'", "");
 	}
 }
 
+/**
+ * @brief Namen der SerialBootMode im Kommando `passthrough` (Index = Modus).
+ */
+static const char *const BOOT_MODES[] = {"none", "bootloader", "run"};
+
+/**
+ * @brief Liefert den SerialBootMode zu einem Namen.
+ *
+ * @param name Name aus BOOT_MODES.
+ * @return Modus oder -1 bei unbekanntem Namen.
+ */
+static int bootModeIndex(const char *name) {
+	for (size_t i = 0; i < sizeof(BOOT_MODES) / sizeof(BOOT_MODES[0]); ++i)
+		if (strcmp(name, BOOT_MODES[i]) == 0) return (int)i;
+	return -1;
+}
+
+/**
+ * @struct UploadCursor
+ * @brief Position einer binären Nachricht, die AsyncWebSocket in mehreren Teilen liefert.
+ */
+struct UploadCursor {
+	uint32_t client;  ///< Client-ID (0 = frei)
+	uint8_t channel;  ///< Kanal aus dem Upload-Kopf
+	uint32_t offset;  ///< Offset des nächsten Teils
+	bool failed;      ///< Nachricht wurde abgelehnt, Rest ignorieren
+};
+
+/**
+ * @brief Offene binäre Nachrichten, höchstens eine je Client.
+ *
+ * Ein Eintrag lebt nur bis zum letzten Teil seiner Nachricht.
+ */
+static UploadCursor uploadCursors[SerialBridge::MAX_CLIENTS];
+
+/**
+ * @brief Sucht den Eintrag eines Clients bzw. legt ihn an (ein belegter wird notfalls ersetzt).
+ *
+ * @param id Client-ID.
+ * @return Eintrag des Clients.
+ */
+static UploadCursor &uploadCursorFor(uint32_t id) {
+	UploadCursor *spare = nullptr;
+	for (auto &c : uploadCursors) {
+		if (c.client == id) return c;
+		if (!spare && c.client == 0) spare = &c;
+	}
+	UploadCursor &c = spare ? *spare : uploadCursors[0];
+	memset(&c, 0, sizeof(c));
+	c.client = id;
+	return c;
+}
+
+/**
+ * @brief Verarbeitet eine binäre Nachricht: Upload-Block des Durchreichens.
+ *
+ * Kopf (SerialUploadHeader) und Nutzdaten werden ohne Kopie an die Bridge gereicht. Liefert
+ * AsyncWebSocket eine große Nachricht in mehreren Teilen, trägt nur der erste den Kopf; die
+ * weiteren werden am gemerkten Offset angehängt. Eine Ablehnung wird einmal pro Nachricht als
+ * `serial`/`passthrough`/`error` gemeldet, der Client setzt bei `received` bzw. nach der
+ * nächsten Quittung neu auf.
+ *
+ * @param client Der WebSocket-Client.
+ * @param info Frame-Information von AsyncWebSocket.
+ * @param data Empfangener Teil.
+ * @param len Länge des Teils.
+ */
+void handleSerialUpload(AsyncWebSocketClient *client, const AwsFrameInfo *info, const uint8_t *data, size_t len) {
+	uint32_t id = client->id();
+	bool first = info->index == 0 && info->num == 0;
+	bool last = info->final && info->index + len >= info->len;
+	UploadCursor *cursor = nullptr;
+	SerialUploadHeader hdr;
+	if (first) {
+		if (!decodeSerialUploadHeader(data, len, hdr)) {
+			sendSerialResponse(client, 0, "passthrough", "error", "", "Ungültiger Upload-Kopf");
+			if (!last) uploadCursorFor(id).failed = true;
+			return;
+		}
+		data += SERIAL_UPLOAD_HEADER_LEN;
+		len -= SERIAL_UPLOAD_HEADER_LEN;
+		if (!last) {
+			cursor = &uploadCursorFor(id);
+			cursor->channel = hdr.channel;
+		}
+	} else {
+		cursor = &uploadCursorFor(id);
+		if (cursor->failed) {
+			if (last) cursor->client = 0;
+			return;
+		}
+		hdr.channel = cursor->channel;
+		hdr.offset = cursor->offset;
+	}
+
+	SerialBridge *bridge = serialBridgeFor(hdr.channel);
+	SerialUploadResult result = bridge ? bridge->uploadPassthrough(id, hdr.offset, data, len) : UPLOAD_INACTIVE;
+	if (cursor) {
+		cursor->offset = hdr.offset + (uint32_t)len;
+		cursor->failed = result != UPLOAD_OK && result != UPLOAD_DUPLICATE;
+		if (last) cursor->client = 0;
+	}
+	if (result == UPLOAD_OK || result == UPLOAD_DUPLICATE) return;
+
+	// Offset, angenommene Bytes und Limit: der Client setzt danach neu auf
+	static const char *const errors[] = {"", "", "Lücke im Upload", "Fenster überschritten", "Größer als angekündigt", "Kein Durchreichen aktiv"};
+	char text[96];
+	if (bridge && result != UPLOAD_INACTIVE) {
+		const SerialPassthrough &pt = bridge->getPassthrough();
+		snprintf(text, sizeof(text), "%s (Offset %u, angenommen %u, Limit %u)", errors[result], (unsigned)hdr.offset, (unsigned)pt.stats().received, (unsigned)pt.limit());
+	} else {
+		snprintf(text, sizeof(text), "%s", errors[UPLOAD_INACTIVE]);
+	}
+	sendSerialResponse(client, hdr.channel, "passthrough", "error", "", text);
+}
+
 /**
  * @brief Behandelt WebSocket-Nachrichten vom Typ "serial".
  *
@@ -205,30 +824,898 @@ void handleLogEvent(AsyncWebSocketClient *client, const ParsedMessage &msg) {
  * @param msg Die geparste Nachricht.
  */
 void handleSerialEvent(AsyncWebSocketClient *client, const ParsedMessage &msg) {
+	if (msg.command == "channels") {
+		// Übersicht aller gebrückten Kanäle
+		DynamicJsonDocument doc(512);
+		JsonArray arr = doc.to<JsonArray>();
+		addSerialChannels(arr);
+		sendSerialResponse(client, msg.channel, "channels", "success", arr);
+		return;
+	}
+	SerialBridge *bridge = serialBridgeFor(msg.channel);
+	if (!bridge) {
+		sendSerialResponse(client, msg.channel, msg.command, "error", "", "Unbekannter Kanal");
+		return;
+	}
 	if (msg.command == "incoming") {
-		sendResponse(client, "serial", "incoming", "success", msg.value);
+		sendSerialResponse(client, msg.channel, "incoming", "success", msg.value);
 		return;
 	} else if (msg.command == "setBaud") {
 		const String &val = msg.value;
+		if (val == "auto") {
+			// Ergebnis folgt über serial/status mit dem Feld autoBaud
+			if (!bridge->startAutoBaud()) {
+				sendSerialResponse(client, msg.channel, "setBaud", "error", "", passthroughBusy(bridge) ? "Durchreichen aktiv" : "Erkennung läuft bereits");
+			} else {
+				sendSerialResponse(client, msg.channel, "setBaud", "success", "Automatische Erkennung gestartet");
+			}
+			return;
+		}
 		uint32_t newBaud = val.toInt();
-		if (!serialBridge->setBaud(newBaud)) {
-			sendResponse(client, "serial", "setBaud", "error", "", "Ungültige Baud-Rate");
+		if (!bridge->setBaud(newBaud)) {
+			sendSerialResponse(client, msg.channel, "setBaud", "error", "", passthroughBusy(bridge) ? "Durchreichen aktiv" : "Ungültige Baud-Rate");
 			return;
 		}
 	} else if (msg.command == "send") {
-		if (serialBridge->isDeviceConnected()) {
+		if (bridge->isDeviceConnected()) {
 			String out = msg.value;
 			out.replace("\n", "\r\n");
 
-			serialBridge->sendData(out);
-			logger.log({"socket", "info", "device"}, "Gesendet: " + out);
-			sendResponse(client, "serial", "send", "success", out, "");
+			// Nur einreihen: "success" bestätigt die Annahme, "done" folgt aus der TX-Task
+			uint32_t job = bridge->sendData(out, client->id());
+			if (!job) {
+				sendSerialResponse(client, msg.channel, "send", "error", "", passthroughBusy(bridge) ? "Durchreichen aktiv" : "TX-Puffer voll");
+				return;
+			}
+			LOGF(LOG_CAT_SOCKET | LOG_CAT_INFO | LOG_CAT_DEVICE, "Gesendet: %s", out.c_str());
+			StaticJsonDocument<128> doc;
+			JsonObject det = doc.to<JsonObject>();
+			det["job"] = job;
+			det["bytes"] = out.length();
+			det["queued"] = (uint32_t)bridge->getTxStats().queuedBytes;
+			sendSerialResponse(client, msg.channel, "send", "success", det);
+		} else {
+			sendSerialResponse(client, msg.channel, "send", "error", "Gerät nicht verbunden", "");
+		}
+		return;
+	} else if (msg.command == "binary") {
+		// Binärkanal für serielle Daten aushandeln (siehe SerialFrame.h)
+		bool enable = msg.key == "enable";
+		if (!enable && msg.key != "disable") {
+			sendSerialResponse(client, msg.channel, "binary", "error", "", "Unknown key");
+			return;
+		}
+		if (!bridge->setBinary(client->id(), enable)) {
+			sendSerialResponse(client, msg.channel, "binary", "error", "", "Client nicht registriert");
+			return;
+		}
+		StaticJsonDocument<128> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["binary"] = enable;
+		det["version"] = SERIAL_FRAME_VERSION;
+		det["headerLength"] = SERIAL_FRAME_HEADER_LEN;
+		sendSerialResponse(client, msg.channel, "binary", "success", det);
+		return;
+	} else if (msg.command == "coalesce") {
+		// Latenzbudget und Nachrichtengröße für das Bündeln serieller Zeilen
+		StaticJsonDocument<128> req;
+		if (deserializeJson(req, msg.value) != DeserializationError::Ok) {
+			sendSerialResponse(client, msg.channel, "coalesce", "error", "", "Invalid JSON");
+			return;
+		}
+		uint32_t latency = req["latencyMs"] | (uint32_t)SerialCoalescer::DEFAULT_LATENCY_MS;
+		uint32_t maxFrame = req["maxFrame"] | (uint32_t)SerialCoalescer::DEFAULT_FRAME_BYTES;
+		if (latency > SerialCoalescer::MAX_LATENCY_MS) {
+			sendSerialResponse(client, msg.channel, "coalesce", "error", "", "Ungültiges Latenzbudget");
+			return;
+		}
+		if (maxFrame == 0 || maxFrame > SerialCoalescer::MAX_FRAME) {
+			sendSerialResponse(client, msg.channel, "coalesce", "error", "", "Ungültige Nachrichtengröße");
+			return;
+		}
+		bridge->setCoalescing(latency, maxFrame);
+		StaticJsonDocument<128> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["latencyMs"] = latency;
+		det["maxFrame"] = maxFrame;
+		sendSerialResponse(client, msg.channel, "coalesce", "success", det);
+		return;
+	} else if (msg.command == "framing") {
+		// Zerlegung des Empfangsstroms: Profil und/oder einzelne Felder; ohne Wert nur abfragen
+		static const char *const modes[] = {"line", "terminator", "fixed", "length", "stxetx", "idle"};
+		SerialFramerConfig cfg = bridge->getFraming();
+		if (msg.value.length() > 0) {
+			StaticJsonDocument<512> req;
+			if (deserializeJson(req, msg.value) != DeserializationError::Ok) {
+				sendSerialResponse(client, msg.channel, "framing", "error", "", "Invalid JSON");
+				return;
+			}
+			if (req.containsKey("profile") && !SerialFramer::profile(req["profile"] | "", cfg)) {
+				sendSerialResponse(client, msg.channel, "framing", "error", "", "Unbekanntes Profil");
+				return;
+			}
+			if (req.containsKey("mode")) {
+				String mode = req["mode"].as<String>();
+				size_t i = 0;
+				while (i < sizeof(modes) / sizeof(modes[0]) && mode != modes[i]) ++i;
+				if (i == sizeof(modes) / sizeof(modes[0])) {
+					sendSerialResponse(client, msg.channel, "framing", "error", "", "Unbekanntes Verfahren");
+					return;
+				}
+				cfg.mode = (SerialFramingMode)i;
+			}
+			// Ungültige Bytefolge: Fehler melden, aktive Einstellungen bleiben (cfg ist eine Kopie)
+			if (req.containsKey("delimiters")) {
+				int n = readFramingBytes(req["delimiters"], cfg.delimiters, sizeof(cfg.delimiters));
+				if (n < 0) {
+					sendSerialResponse(client, msg.channel, "framing", "error", "", "Ungültige Trennzeichen");
+					return;
+				}
+				cfg.delimiterCount = (uint8_t)n;
+			}
+			if (req.containsKey("terminator")) {
+				int n = readFramingBytes(req["terminator"], cfg.terminator, sizeof(cfg.terminator));
+				if (n < 0) {
+					sendSerialResponse(client, msg.channel, "framing", "error", "", "Ungültiges Endezeichen");
+					return;
+				}
+				cfg.terminatorLen = (uint8_t)n;
+			}
+			cfg.joinCrLf = req["joinCrLf"] | cfg.joinCrLf;
+			cfg.fixedLen = req["fixedLen"] | cfg.fixedLen;
+			cfg.lengthBytes = req["lengthBytes"] | cfg.lengthBytes;
+			cfg.lengthBigEndian = req["lengthBigEndian"] | cfg.lengthBigEndian;
+			cfg.lengthIncludesHeader = req["lengthIncludesHeader"] | cfg.lengthIncludesHeader;
+			cfg.stx = req["stx"] | cfg.stx;
+			cfg.etx = req["etx"] | cfg.etx;
+			cfg.timeoutMs = req["timeoutMs"] | cfg.timeoutMs;
+			cfg.maxRecord = req["maxRecord"] | cfg.maxRecord;
+			if (!bridge->setFraming(cfg)) {
+				sendSerialResponse(client, msg.channel, "framing", "error", "", "Ungültige Framing-Einstellungen");
+				return;
+			}
+		}
+		SerialFramerStats st = bridge->getFramerStats();
+		StaticJsonDocument<512> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["mode"] = modes[cfg.mode];
+		addFramingBytes(det, "delimiters", cfg.delimiters, cfg.delimiterCount);
+		det["joinCrLf"] = cfg.joinCrLf;
+		addFramingBytes(det, "terminator", cfg.terminator, cfg.terminatorLen);
+		det["fixedLen"] = cfg.fixedLen;
+		det["lengthBytes"] = cfg.lengthBytes;
+		det["lengthBigEndian"] = cfg.lengthBigEndian;
+		det["lengthIncludesHeader"] = cfg.lengthIncludesHeader;
+		det["stx"] = cfg.stx;
+		det["etx"] = cfg.etx;
+		det["timeoutMs"] = cfg.timeoutMs;
+		det["maxRecord"] = cfg.maxRecord;
+		det["records"] = st.records;
+		det["split"] = st.split;
+		det["partial"] = st.partial;
+		det["discarded"] = st.discarded;
+		sendSerialResponse(client, msg.channel, "framing", "success", det);
+		return;
+	} else if (msg.command == "tx") {
+		// Sendepfad: Flusskontrolle, Zeichen-/Zeilenabstand, RS-485-Umschaltung
+		SerialTxConfig cfg = bridge->getTxConfig();
+		if (msg.value.length() > 0) {
+			StaticJsonDocument<256> req;
+			if (deserializeJson(req, msg.value) != DeserializationError::Ok) {
+				sendSerialResponse(client, msg.channel, "tx", "error", "", "Invalid JSON");
+				return;
+			}
+			if (req.containsKey("flow")) {
+				String flow = req["flow"].as<String>();
+				if (flow == "none") {
+					cfg.flow = SERIAL_FLOW_NONE;
+				} else if (flow == "rtscts") {
+					cfg.flow = SERIAL_FLOW_RTS_CTS;
+				} else if (flow == "xonxoff") {
+					cfg.flow = SERIAL_FLOW_XON_XOFF;
+				} else {
+					sendSerialResponse(client, msg.channel, "tx", "error", "", "Unbekannte Flusskontrolle");
+					return;
+				}
+			}
+			cfg.charDelayUs = req["charDelayUs"] | cfg.charDelayUs;
+			cfg.lineDelayMs = req["lineDelayMs"] | cfg.lineDelayMs;
+			cfg.rs485 = req["rs485"] | cfg.rs485;
+			cfg.deLeadUs = req["deLeadUs"] | cfg.deLeadUs;
+			cfg.deTailUs = req["deTailUs"] | cfg.deTailUs;
+			if (!bridge->setTxConfig(cfg)) {
+				sendSerialResponse(client, msg.channel, "tx", "error", "", "Ungültige TX-Einstellungen");
+				return;
+			}
+		}
+		static const char *const flows[] = {"none", "rtscts", "xonxoff"};
+		SerialTxStats st = bridge->getTxStats();
+		StaticJsonDocument<384> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["flow"] = flows[cfg.flow];
+		det["charDelayUs"] = cfg.charDelayUs;
+		det["lineDelayMs"] = cfg.lineDelayMs;
+		det["rs485"] = cfg.rs485;
+		det["deLeadUs"] = cfg.deLeadUs;
+		det["deTailUs"] = cfg.deTailUs;
+		det["jobs"] = st.jobs;
+		det["done"] = st.done;
+		det["rejected"] = st.rejected;
+		det["txBytes"] = st.bytes;
+		det["txTimeouts"] = st.txTimeouts;
+		det["queued"] = (uint32_t)st.queuedBytes;
+		det["maxQueued"] = (uint32_t)st.maxQueued;
+		sendSerialResponse(client, msg.channel, "tx", "success", det);
+		return;
+	} else if (msg.command == "presence") {
+		// Geräteerkennung: Entprellung, Stille bis "getrennt", Pegelauswertung
+		DevicePresenceConfig cfg = bridge->getPresence();
+		if (msg.value.length() > 0) {
+			StaticJsonDocument<128> req;
+			if (deserializeJson(req, msg.value) != DeserializationError::Ok) {
+				sendSerialResponse(client, msg.channel, "presence", "error", "", "Invalid JSON");
+				return;
+			}
+			cfg.debounceMs = req["debounceMs"] | cfg.debounceMs;
+			cfg.idleMs = req["idleMs"] | cfg.idleMs;
+			cfg.levelSense = req["levelSense"] | cfg.levelSense;
+			if (!bridge->setPresence(cfg)) {
+				sendSerialResponse(client, msg.channel, "presence", "error", "", "Ungültige Schwellen");
+				return;
+			}
+		}
+		DevicePresenceStats st = bridge->getPresenceStats();
+		uint32_t since = bridge->msSinceDeviceSeen();
+		StaticJsonDocument<256> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["available"] = bridge->isDeviceConnected();
+		det["debounceMs"] = cfg.debounceMs;
+		det["idleMs"] = cfg.idleMs;
+		det["levelSense"] = cfg.levelSense;
+		if (since == UINT32_MAX) {
+			det["lastSeenMs"] = nullptr;
+		} else {
+			det["lastSeenMs"] = since;
+		}
+		det["connects"] = st.connects;
+		det["disconnects"] = st.disconnects;
+		det["glitches"] = st.glitches;
+		sendSerialResponse(client, msg.channel, "presence", "success", det);
+		return;
+	} else if (msg.command == "tcp") {
+		// Direkter TCP-Zugang zur UART (roh und RFC 2217), ohne JSON
+		SerialTcpConfig cfg = bridge->getTcp();
+		if (msg.key == "enable") {
+			cfg.enabled = true;
+			if (msg.value.length() > 0) {
+				StaticJsonDocument<128> req;
+				if (deserializeJson(req, msg.value) != DeserializationError::Ok) {
+					sendSerialResponse(client, msg.channel, "tcp", "error", "", "Invalid JSON");
+					return;
+				}
+				cfg.rawPort = req["rawPort"] | cfg.rawPort;
+				cfg.rfc2217Port = req["rfc2217Port"] | cfg.rfc2217Port;
+			}
+			if (!bridge->setTcp(cfg)) {
+				sendSerialResponse(client, msg.channel, "tcp", "error", "", "Ungültige Ports");
+				return;
+			}
+		} else if (msg.key == "disable") {
+			cfg.enabled = false;
+			bridge->setTcp(cfg);
+		} else if (msg.key != "status") {
+			sendSerialResponse(client, msg.channel, "tcp", "error", "", "Unknown key");
+			return;
+		}
+		const SerialTcpServer &tcp = bridge->getTcpServer();
+		SerialTcpStats st = tcp.stats();
+		SerialTcpClientInfo infos[SerialTcpServer::MAX_CLIENTS];
+		size_t count = tcp.clients(infos, SerialTcpServer::MAX_CLIENTS);
+		StaticJsonDocument<1024> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["enabled"] = cfg.enabled;
+		det["running"] = tcp.running();
+		det["rawPort"] = cfg.rawPort;
+		det["rfc2217Port"] = cfg.rfc2217Port;
+		det["accepted"] = st.accepted;
+		det["rejected"] = st.rejected;
+		det["dropped"] = st.dropped;
+		det["ignored"] = st.ignored;
+		JsonArray list = det.createNestedArray("clients");
+		for (size_t i = 0; i < count; ++i) {
+			JsonObject c = list.createNestedObject();
+			c["id"] = infos[i].id;
+			c["ip"] = IPAddress(infos[i].addr).toString();
+			c["port"] = infos[i].port;
+			c["mode"] = infos[i].mode == SERIAL_TCP_RFC2217 ? "rfc2217" : "raw";
+			c["writer"] = infos[i].writer;
+			c["rxBytes"] = infos[i].rxBytes;
+			c["txBytes"] = infos[i].txBytes;
+			c["dropped"] = infos[i].dropped;
+			c["ignored"] = infos[i].ignored;
+		}
+		sendSerialResponse(client, msg.channel, "tcp", "success", det);
+		return;
+	} else if (msg.command == "record") {
+		// Mitschnitt des rohen RX/TX-Stroms nach /logs/device/<session>.cap
+		if (msg.key == "start") {
+			SerialRecorderConfig cfg;
+			cfg.maxFileBytes = SerialRecorder::DEFAULT_MAX_FILE_BYTES;
+			cfg.maxFileAgeMs = SerialRecorder::DEFAULT_MAX_FILE_AGE_MS;
+			cfg.quotaBytes = SerialRecorder::DEFAULT_QUOTA_BYTES;
+			String session;
+			if (msg.value.length() > 0) {
+				StaticJsonDocument<256> req;
+				if (deserializeJson(req, msg.value) != DeserializationError::Ok) {
+					sendSerialResponse(client, msg.channel, "record", "error", "", "Invalid JSON");
+					return;
+				}
+				session = req["session"] | "";
+				cfg.maxFileBytes = req["maxFileBytes"] | (uint32_t)cfg.maxFileBytes;
+				cfg.maxFileAgeMs = (req["maxAgeSec"] | cfg.maxFileAgeMs / 1000) * 1000;
+				cfg.quotaBytes = req["quotaBytes"] | (uint32_t)cfg.quotaBytes;
+			}
+			if (session.length() == 0) {
+				// Standardname aus der Uhrzeit, ohne gestellte Uhr aus der Laufzeit
+				time_t now = time(nullptr);
+				char name[24];
+				if (now > 1600000000) {
+					strftime(name, sizeof(name), "%Y%m%d-%H%M%S", localtime(&now));
+				} else {
+					snprintf(name, sizeof(name), "boot-%lu", (unsigned long)millis());
+				}
+				session = name;
+				if (msg.channel > 0) session += "-ch" + String(msg.channel);
+			}
+			if (!bridge->startRecording(session, cfg)) {
+				sendSerialResponse(client, msg.channel, "record", "error", "", bridge->getRecorder().active() ? "Mitschnitt läuft bereits" : "Ungültige Mitschnitt-Einstellungen");
+				return;
+			}
+		} else if (msg.key == "stop") {
+			bridge->stopRecording();
+		} else if (msg.key != "status") {
+			sendSerialResponse(client, msg.channel, "record", "error", "", "Unknown key");
+			return;
+		}
+		const SerialRecorder &rec = bridge->getRecorder();
+		SerialRecorderConfig cfg = rec.config();
+		SerialRecorderStats st = rec.stats();
+		StaticJsonDocument<512> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["active"] = rec.active();
+		det["session"] = rec.session();
+		det["segment"] = rec.segmentName();
+		det["maxFileBytes"] = (uint32_t)cfg.maxFileBytes;
+		det["maxAgeSec"] = cfg.maxFileAgeMs / 1000;
+		det["quotaBytes"] = (uint32_t)cfg.quotaBytes;
+		det["records"] = st.records;
+		det["bytes"] = st.bytes;
+		det["dropped"] = st.dropped;
+		det["droppedBytes"] = st.droppedBytes;
+		det["flushes"] = st.flushes;
+		det["segments"] = st.segments;
+		det["deleted"] = st.deleted;
+		det["lastError"] = rec.lastError();
+		sendSerialResponse(client, msg.channel, "record", "success", det);
+		return;
+	} else if (msg.command == "replay") {
+		// Verlauf nachladen: ab laufender Nummer oder die letzten N Bytes
+		SerialReplayMode mode;
+		if (msg.key == "seq") {
+			mode = SERIAL_REPLAY_FROM_SEQ;
+		} else if (msg.key == "tail") {
+			mode = SERIAL_REPLAY_TAIL;
 		} else {
-			sendResponse(client, "serial", "send", "error", "Serial2 nicht verbunden", "");
+			sendSerialResponse(client, msg.channel, "replay", "error", "", "Unknown key");
+			return;
+		}
+		uint32_t arg = strtoul(msg.value.c_str(), nullptr, 10);
+		if (!bridge->requestReplay(client->id(), mode, arg)) {
+			sendSerialResponse(client, msg.channel, "replay", "error", "", "Client nicht registriert");
 		}
 		return;
+	} else if (msg.command == "run") {
+		// Befehlsskript auf dem ESP32 ausführen; das Ergebnis folgt als serial/run/done
+		if (msg.key == "cancel") {
+			uint32_t job = strtoul(msg.value.c_str(), nullptr, 10);
+			if (!bridge->cancelScript(job)) {
+				sendSerialResponse(client, msg.channel, "run", "error", "", "Kein laufendes Skript");
+				return;
+			}
+			sendSerialResponse(client, msg.channel, "run", "success", "", "");
+			return;
+		}
+		if (msg.key == "status") {
+			const SerialScriptEngine &engine = bridge->getScriptEngine();
+			SerialScriptStats st = engine.stats();
+			StaticJsonDocument<256> doc;
+			JsonObject det = doc.to<JsonObject>();
+			det["busy"] = engine.busy();
+			det["runs"] = st.runs;
+			det["ok"] = st.ok;
+			det["failed"] = st.failed;
+			det["cancelled"] = st.cancelled;
+			det["rejected"] = st.rejected;
+			det["rxDropped"] = st.rxDropped;
+			sendSerialResponse(client, msg.channel, "run", "success", det);
+			return;
+		}
+		DynamicJsonDocument req(msg.value.length() + 128);
+		if (deserializeJson(req, msg.value) != DeserializationError::Ok) {
+			sendSerialResponse(client, msg.channel, "run", "error", "", "Invalid JSON");
+			return;
+		}
+		String name = req["script"] | "";
+		String source;
+		if (name.length() > 0) {
+			if (!isValidScriptName(name)) {
+				sendSerialResponse(client, msg.channel, "run", "error", "", "Ungültiger Skriptname");
+				return;
+			}
+			if (!loadScript(name, source)) {
+				sendSerialResponse(client, msg.channel, "run", "error", "", "Skript nicht gefunden");
+				return;
+			}
+		} else {
+			source = req["source"] | "";
+		}
+		if (source.length() == 0) {
+			sendSerialResponse(client, msg.channel, "run", "error", "", "Kein Skript angegeben");
+			return;
+		}
+		if (source.length() > SerialScriptEngine::MAX_SOURCE) {
+			sendSerialResponse(client, msg.channel, "run", "error", "", "Skript zu groß");
+			return;
+		}
+		uint32_t job = bridge->runScript(client->id(), name, source);
+		if (job == 0) {
+			const char *reason = passthroughBusy(bridge) ? "Durchreichen aktiv" : streamBusy(bridge) ? "Dateiübertragung läuft" : "Skript läuft bereits";
+			sendSerialResponse(client, msg.channel, "run", "error", "", reason);
+			return;
+		}
+		StaticJsonDocument<128> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["job"] = job;
+		det["script"] = name;
+		sendSerialResponse(client, msg.channel, "run", "success", det);
+		return;
+	} else if (msg.command == "script") {
+		// Ablage der Befehlsskripte unter /scripts/<name>.txt
+		if (msg.key == "list") {
+			DynamicJsonDocument doc(2048);
+			JsonArray list = doc.to<JsonArray>();
+			File dir = LittleFS.open("/scripts");
+			if (dir && dir.isDirectory()) {
+				File f;
+				while ((f = dir.openNextFile())) {
+					String file = f.name();
+					if (file.endsWith(".txt")) {
+						JsonObject o = list.createNestedObject();
+						o["name"] = file.substring(file.lastIndexOf('/') + 1, file.length() - 4);
+						o["size"] = f.size();
+					}
+					f.close();
+				}
+			}
+			sendSerialResponse(client, msg.channel, "script", "success", list);
+			return;
+		}
+		if (msg.key == "save") {
+			DynamicJsonDocument req(msg.value.length() + 128);
+			if (deserializeJson(req, msg.value) != DeserializationError::Ok) {
+				sendSerialResponse(client, msg.channel, "script", "error", "", "Invalid JSON");
+				return;
+			}
+			String name = req["name"] | "";
+			const char *source = req["source"] | "";
+			if (!isValidScriptName(name)) {
+				sendSerialResponse(client, msg.channel, "script", "error", "", "Ungültiger Skriptname");
+				return;
+			}
+			if (strlen(source) > SerialScriptEngine::MAX_SOURCE) {
+				sendSerialResponse(client, msg.channel, "script", "error", "", "Skript zu groß");
+				return;
+			}
+			// Vor dem Ablegen übersetzen, damit Fehler beim Speichern und nicht erst beim Lauf auffallen
+			SerialScript *check = new SerialScript();
+			bool ok = check->parse(source, strlen(source));
+			String err = ok ? String("") : "Zeile " + String(check->errorLine()) + ": " + check->error();
+			delete check;
+			if (!ok) {
+				sendSerialResponse(client, msg.channel, "script", "error", "", err);
+				return;
+			}
+			File f = LittleFS.open(scriptPath(name), FILE_WRITE);
+			if (!f) {
+				sendSerialResponse(client, msg.channel, "script", "error", "", "Datei konnte nicht geschrieben werden");
+				return;
+			}
+			f.print(source);
+			f.close();
+			sendSerialResponse(client, msg.channel, "script", "success", "", "");
+			return;
+		}
+		if (!isValidScriptName(msg.value)) {
+			sendSerialResponse(client, msg.channel, "script", "error", "", "Ungültiger Skriptname");
+			return;
+		}
+		if (msg.key == "get") {
+			String source;
+			if (!loadScript(msg.value, source)) {
+				sendSerialResponse(client, msg.channel, "script", "error", "", "Skript nicht gefunden");
+				return;
+			}
+			DynamicJsonDocument doc(source.length() + 128);
+			JsonObject det = doc.to<JsonObject>();
+			det["name"] = msg.value;
+			det["source"] = source;
+			sendSerialResponse(client, msg.channel, "script", "success", det);
+		} else if (msg.key == "delete") {
+			if (!LittleFS.remove(scriptPath(msg.value))) {
+				sendSerialResponse(client, msg.channel, "script", "error", "", "Skript nicht gefunden");
+				return;
+			}
+			sendSerialResponse(client, msg.channel, "script", "success", "", "");
+		} else {
+			sendSerialResponse(client, msg.channel, "script", "error", "", "Unknown key");
+		}
+		return;
+	} else if (msg.command == "poll") {
+		// Zyklische Abfragen mit Feldspeicher; Clients abonnieren Feldänderungen
+		const SerialPoller &poller = bridge->getPoller();
+		if (msg.key == "set" || msg.key == "clear") {
+			SerialPollerConfig *cfg = new SerialPollerConfig();
+			String error;
+			char err[64];
+			bool ok;
+			if (msg.key == "clear") {
+				memset(cfg, 0, sizeof(*cfg));
+				ok = bridge->setPoll(*cfg, err, sizeof(err));
+			} else {
+				ok = readPollConfig(msg.value, *cfg, error);
+				if (ok && !bridge->setPoll(*cfg, err, sizeof(err))) {
+					error = err;
+					ok = false;
+				}
+			}
+			delete cfg;
+			if (!ok) {
+				sendSerialResponse(client, msg.channel, "poll", "error", "", error);
+				return;
+			}
+			// Dauerhaft ablegen; `clear` löscht die Datei
+			if (msg.key == "clear") {
+				LittleFS.remove(pollPath(msg.channel));
+			} else {
+				File f = LittleFS.open(pollPath(msg.channel), FILE_WRITE);
+				if (f) {
+					f.print(msg.value);
+					f.close();
+				} else {
+					logger.log({"system", "error", "device"}, "Abfragen konnten nicht gespeichert werden");
+				}
+			}
+		} else if (msg.key == "get") {
+			DynamicJsonDocument doc(4096);
+			JsonObject det = doc.to<JsonObject>();
+			addPollFields(det, poller, SerialBridge::POLL_ALL_FIELDS);
+			sendSerialResponse(client, msg.channel, "poll", "success", det);
+			return;
+		} else if (msg.key == "subscribe" || msg.key == "unsubscribe") {
+			uint32_t mask = 0;
+			if (msg.key == "subscribe" && msg.value == "*") {
+				mask = SerialBridge::POLL_ALL_FIELDS;
+			} else if (msg.key == "subscribe") {
+				StaticJsonDocument<512> req;
+				if (deserializeJson(req, msg.value) != DeserializationError::Ok || !req.is<JsonArray>()) {
+					sendSerialResponse(client, msg.channel, "poll", "error", "", "Invalid JSON");
+					return;
+				}
+				for (JsonVariantConst v : req.as<JsonArrayConst>()) {
+					size_t idx = poller.findField(v | "");
+					if (idx == SerialPoller::NO_FIELD) {
+						sendSerialResponse(client, msg.channel, "poll", "error", "", "Unbekanntes Feld: " + String(v | ""));
+						return;
+					}
+					mask |= 1UL << idx;
+				}
+			}
+			if (!bridge->setFieldSubscription(client->id(), mask)) {
+				sendSerialResponse(client, msg.channel, "poll", "error", "", "Client nicht registriert");
+				return;
+			}
+			// Aktuelle Werte gleich mitschicken, danach folgen nur Änderungen
+			DynamicJsonDocument doc(4096);
+			JsonObject det = doc.to<JsonObject>();
+			addPollFields(det, poller, mask);
+			sendSerialResponse(client, msg.channel, "poll", "success", det);
+			return;
+		} else if (msg.key != "status") {
+			sendSerialResponse(client, msg.channel, "poll", "error", "", "Unknown key");
+			return;
+		}
+		const SerialPollerConfig &cfg = bridge->getPoll();
+		DynamicJsonDocument doc(4096);
+		JsonObject det = doc.to<JsonObject>();
+		det["hideReplies"] = cfg.hideReplies;
+		JsonArray list = det.createNestedArray("polls");
+		for (size_t i = 0; i < cfg.count; ++i) {
+			const SerialPollEntry &e = cfg.polls[i];
+			SerialPollStats st;
+			poller.stats(i, st);
+			JsonObject o = list.createNestedObject();
+			o["name"] = e.name;
+			char send[SerialPollEntry::MAX_REQUEST + 1];
+			memcpy(send, e.request, e.requestLen);
+			send[e.requestLen] = '\0';
+			o["send"] = send;
+			o["expect"] = e.pattern;
+			JsonArray fields = o.createNestedArray("fields");
+			for (size_t k = 0; k < e.fieldCount; ++k) fields.add(e.fields[k]);
+			o["intervalMs"] = e.intervalMs;
+			o["timeoutMs"] = e.timeoutMs;
+			o["requests"] = st.requests;
+			o["replies"] = st.replies;
+			o["timeouts"] = st.timeouts;
+			o["lastRttMs"] = st.lastRttMs;
+		}
+		sendSerialResponse(client, msg.channel, "poll", "success", det);
+		return;
+	} else if (msg.command == "trigger") {
+		// Regeln auf dem Datenstrom: Alarm, Log, LED-Status, Schnappschuss
+		if (msg.key == "set" || msg.key == "clear") {
+			SerialTriggerConfig *cfg = new SerialTriggerConfig();
+			String error;
+			char err[64];
+			bool ok = true;
+			if (msg.key == "clear") {
+				memset(cfg, 0, sizeof(*cfg));
+			} else {
+				ok = readTriggerConfig(msg.value, *cfg, error);
+			}
+			if (ok && !bridge->setTriggers(*cfg, err, sizeof(err))) {
+				error = err;
+				ok = false;
+			}
+			delete cfg;
+			if (!ok) {
+				sendSerialResponse(client, msg.channel, "trigger", "error", "", error);
+				return;
+			}
+			// Dauerhaft ablegen; `clear` löscht die Datei
+			if (msg.key == "clear") {
+				LittleFS.remove(triggerPath(msg.channel));
+			} else {
+				File f = LittleFS.open(triggerPath(msg.channel), FILE_WRITE);
+				if (f) {
+					f.print(msg.value);
+					f.close();
+				} else {
+					logger.log({"system", "error", "device"}, "Regeln konnten nicht gespeichert werden");
+				}
+			}
+			sendSerialResponse(client, msg.channel, "trigger", "success", "", "");
+			return;
+		} else if (msg.key == "ack") {
+			bridge->ackTriggers();
+			sendSerialResponse(client, msg.channel, "trigger", "success", "", "");
+			return;
+		} else if (msg.key == "snapshot") {
+			SerialTriggerSnapshot info;
+			uint8_t *data = static_cast<uint8_t *>(malloc(SerialBridge::TRIGGER_SNAPSHOT_BYTES + 1));
+			if (!data || !bridge->getTriggerSnapshot(info, data)) {
+				free(data);
+				sendSerialResponse(client, msg.channel, "trigger", "error", "", data ? "Kein Schnappschuss vorhanden" : "Kein Speicher");
+				return;
+			}
+			data[info.len] = '\0';
+			DynamicJsonDocument doc(512);
+			JsonObject det = doc.to<JsonObject>();
+			det["rule"] = (const char *)info.rule;
+			det["ts"] = info.timestamp;
+			det["ageMs"] = millis() - info.takenMs;
+			det["firstSeq"] = info.firstSeq;
+			det["lastSeq"] = info.lastSeq;
+			det["bytes"] = info.len;
+			det["data"] = (const char *)data;
+			sendSerialResponse(client, msg.channel, "trigger", "success", det);
+			free(data);
+			return;
+		} else if (msg.key != "status") {
+			sendSerialResponse(client, msg.channel, "trigger", "error", "", "Unknown key");
+			return;
+		}
+		DynamicJsonDocument doc(6144);
+		JsonObject det = doc.to<JsonObject>();
+		uint8_t raised = bridge->getTriggerStatus();
+		det["warning"] = (raised & 1) != 0;
+		det["error"] = (raised & 2) != 0;
+		JsonArray list = det.createNestedArray("rules");
+		SerialTriggerRule rule;
+		SerialTriggerStats st;
+		uint32_t now = millis();
+		for (size_t i = 0; bridge->getTrigger(i, rule, st); ++i) {
+			JsonObject o = list.createNestedObject();
+			o["name"] = rule.name;
+			o[rule.prefix ? "prefix" : "contains"] = rule.text;
+			if (rule.ignoreCase) o["ignoreCase"] = true;
+			JsonArray actions = o.createNestedArray("actions");
+			for (size_t k = 0; k < sizeof(TRIGGER_ACTIONS) / sizeof(TRIGGER_ACTIONS[0]); ++k) {
+				if (rule.actions & (1u << k)) actions.add(TRIGGER_ACTIONS[k]);
+			}
+			o["level"] = TRIGGER_LEVELS[rule.level];
+			o["cooldownMs"] = rule.cooldownMs;
+			o["hits"] = st.hits;
+			o["fired"] = st.fired;
+			if (st.fired > 0) o["lastAgoMs"] = now - st.lastMs;
+		}
+		sendSerialResponse(client, msg.channel, "trigger", "success", det);
+		return;
+	} else if (msg.command == "filter") {
+		// Zeilenfilter dieses Clients; gilt bis zum Trennen der Verbindung
+		SerialFilterSpec *spec = new SerialFilterSpec();
+		uint32_t lines = 0;
+		if (msg.key == "set" || msg.key == "clear") {
+			String error;
+			char err[64];
+			bool ok = msg.key == "clear" || readFilterSpec(msg.value, *spec, error);
+			if (ok && !bridge->setFilter(client->id(), *spec, err, sizeof(err))) {
+				error = err;
+				ok = false;
+			}
+			if (!ok) {
+				delete spec;
+				sendSerialResponse(client, msg.channel, "filter", "error", "", error);
+				return;
+			}
+		} else if (msg.key != "status") {
+			delete spec;
+			sendSerialResponse(client, msg.channel, "filter", "error", "", "Unknown key");
+			return;
+		}
+		if (!bridge->getFilter(client->id(), *spec, lines)) {
+			delete spec;
+			sendSerialResponse(client, msg.channel, "filter", "error", "", "Client nicht registriert");
+			return;
+		}
+		DynamicJsonDocument doc(2048);
+		JsonObject det = doc.to<JsonObject>();
+		det["active"] = spec->count > 0;
+		addFilterRules(det, *spec);
+		det["lines"] = lines;
+		delete spec;
+		sendSerialResponse(client, msg.channel, "filter", "success", det);
+		return;
+	} else if (msg.command == "passthrough") {
+		// Durchreichen zum Flashen; Daten kommen als binäre Nachrichten (siehe handleSerialUpload)
+		if (msg.key == "start") {
+			SerialPassthroughConfig cfg{bridge->getBaudRate(), 0, BOOT_MODE_NONE, BOOT_MODE_NONE, true, SerialPassthrough::DEFAULT_IDLE_MS};
+			if (msg.value.length() > 0) {
+				StaticJsonDocument<256> req;
+				if (deserializeJson(req, msg.value) != DeserializationError::Ok) {
+					sendSerialResponse(client, msg.channel, "passthrough", "error", "", "Invalid JSON");
+					return;
+				}
+				int enter = bootModeIndex(req["enter"] | "none");
+				int leave = bootModeIndex(req["leave"] | "none");
+				if (enter < 0 || leave < 0) {
+					sendSerialResponse(client, msg.channel, "passthrough", "error", "", "Unbekannter Boot-Modus");
+					return;
+				}
+				cfg.baud = req["baud"] | cfg.baud;
+				cfg.size = req["size"] | cfg.size;
+				cfg.enter = (uint8_t)enter;
+				cfg.leave = (uint8_t)leave;
+				cfg.restoreBaud = req["restoreBaud"] | cfg.restoreBaud;
+				cfg.idleMs = req["idleMs"] | cfg.idleMs;
+			}
+			char err[64];
+			if (!bridge->startPassthrough(client->id(), cfg, err, sizeof(err))) {
+				sendSerialResponse(client, msg.channel, "passthrough", "error", "", err);
+				return;
+			}
+			// Bereitschaft folgt als serial/passthrough/ready aus der TX-Task
+			StaticJsonDocument<192> doc;
+			JsonObject det = doc.to<JsonObject>();
+			det["baud"] = cfg.baud;
+			det["size"] = cfg.size;
+			det["window"] = (uint32_t)SerialPassthrough::BUFFER_BYTES;
+			det["header"] = (uint32_t)SERIAL_UPLOAD_HEADER_LEN;
+			sendSerialResponse(client, msg.channel, "passthrough", "success", det);
+			return;
+		} else if (msg.key == "stop" || msg.key == "abort") {
+			// Ergebnis folgt als serial/passthrough/done bzw. error
+			if (!bridge->stopPassthrough(client->id(), msg.key == "abort")) {
+				sendSerialResponse(client, msg.channel, "passthrough", "error", "", "Kein eigenes Durchreichen aktiv");
+				return;
+			}
+			sendSerialResponse(client, msg.channel, "passthrough", "success", msg.key, "");
+			return;
+		} else if (msg.key == "reset") {
+			int mode = bootModeIndex(msg.value.length() > 0 ? msg.value.c_str() : "run");
+			if (mode <= BOOT_MODE_NONE || !bridge->requestTargetReset(client->id(), (uint8_t)mode)) {
+				sendSerialResponse(client, msg.channel, "passthrough", "error", "", mode <= BOOT_MODE_NONE ? "Unbekannter Boot-Modus" : "Durchreichen oder Reset läuft");
+				return;
+			}
+			sendSerialResponse(client, msg.channel, "passthrough", "success", "reset", "");
+			return;
+		} else if (msg.key != "status") {
+			sendSerialResponse(client, msg.channel, "passthrough", "error", "", "Unknown key");
+			return;
+		}
+		static const char *const states[] = {"idle", "starting", "active", "stopping"};
+		const SerialPassthrough &pt = bridge->getPassthrough();
+		SerialPassthroughStats st = pt.stats();
+		StaticJsonDocument<384> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["state"] = states[pt.state()];
+		det["owner"] = st.owner != 0 && st.owner == client->id();
+		if (pt.state() != PASSTHROUGH_IDLE) {
+			det["baud"] = st.baud;
+			det["size"] = pt.config().size;
+			det["received"] = st.received;
+			det["written"] = st.written;
+			det["limit"] = pt.limit();
+			det["rxBytes"] = st.rxBytes;
+			det["chunks"] = st.chunks;
+			det["rejected"] = st.rejected;
+			det["ms"] = st.elapsedMs;
+			det["bytesPerSec"] = st.bytesPerSec;
+			det["linePercent"] = st.linePercent;
+		}
+		sendSerialResponse(client, msg.channel, "passthrough", "success", det);
+		return;
+	} else if (msg.command == "stream") {
+		// Dateiübertragung; die Datei selbst kommt per HTTP (POST /serial/stream)
+		if (msg.key == "cancel") {
+			if (!bridge->cancelStream()) {
+				sendSerialResponse(client, msg.channel, "stream", "error", "", "Keine Dateiübertragung aktiv");
+				return;
+			}
+			// Ergebnis folgt als serial/stream/error
+			sendSerialResponse(client, msg.channel, "stream", "success", "cancel", "");
+			return;
+		} else if (msg.key != "status") {
+			sendSerialResponse(client, msg.channel, "stream", "error", "", "Unknown key");
+			return;
+		}
+		static const char *const states[] = {"idle", "running", "done", "failed"};
+		const SerialFileStream &stream = bridge->getStream();
+		StaticJsonDocument<320> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["state"] = states[stream.state()];
+		if (stream.state() != FILE_STREAM_IDLE) {
+			SerialFileStreamStats st = stream.stats();
+			det["size"] = stream.config().size;
+			det["lineDelayMs"] = stream.config().lineDelayMs;
+			det["prompt"] = stream.config().prompt;
+			det["received"] = st.received;
+			det["sent"] = st.sent;
+			det["lines"] = st.lines;
+			det["prompts"] = st.prompts;
+			det["maxBuffered"] = (uint32_t)st.maxBuffered;
+		}
+		sendSerialResponse(client, msg.channel, "stream", "success", det);
+		return;
+	} else if (msg.command == "stats") {
+		// Zähler von Empfangspfad und Bündelung
+		const SerialRxStats &rx = bridge->getRxStats();
+		SerialCoalescerStats co = bridge->getCoalescerStats();
+		StaticJsonDocument<384> doc;
+		JsonObject det = doc.to<JsonObject>();
+		det["wakeups"] = rx.wakeups;
+		det["rxBytes"] = rx.bytes;
+		det["overflows"] = rx.overflows;
+		det["frames"] = co.frames;
+		det["lines"] = co.lines;
+		det["immediate"] = co.immediate;
+		det["maxLinesPerFrame"] = co.maxLinesPerFrame;
+		det["framesPerSec"] = co.framesPerSec;
+		det["linesPerFrame"] = co.linesPerFrame;
+		sendSerialResponse(client, msg.channel, "stats", "success", det);
+		return;
 	} else {
-		sendResponse(client, "serial", "response", "error", "", "Not implemented");
+		sendSerialResponse(client, msg.channel, "response", "error", "", "Not implemented");
 	}
 }
 
@@ -311,7 +1798,7 @@ void sendResponse(AsyncWebSocketClient *client, const String &event, const Strin
 	d["error"] = error;
 	String s;
 	serializeJson(d, s);
-	client->text(s);
+	webSocketManager.sendControl(client, s);
 }
 
 /**
@@ -335,7 +1822,7 @@ void sendResponse(AsyncWebSocketClient *client, const String &event, const Strin
 	d["error"] = error;
 	String s;
 	serializeJson(d, s);
-	client->text(s);
+	webSocketManager.sendControl(client, s);
 }
 
 /**
@@ -359,5 +1846,54 @@ void sendResponse(AsyncWebSocketClient *client, const String &event, const Strin
 
 	String s;
 	serializeJson(d, s);
-	client->text(s);
+	webSocketManager.sendControl(client, s);
+}
+
+/**
+ * @brief Sendet eine Antwort auf ein "serial"-Kommando mit Kanal-ID und `details` als String.
+ *
+ * @param client Ziel-Client.
+ * @param channel Kanal-ID.
+ * @param action Aktion.
+ * @param status Status (z.B. "success", "error").
+ * @param details Inhaltliche Details.
+ * @param error Optionaler Fehlertext.
+ */
+void sendSerialResponse(AsyncWebSocketClient *client, int channel, const String &action, const String &status, const String &details,
+                        const String &error) {
+	StaticJsonDocument<256> d;
+	d["event"] = "serial";
+	d["channel"] = channel;
+	d["action"] = action;
+	d["status"] = status;
+	d["details"] = details;
+	d["error"] = error;
+	String s;
+	serializeJson(d, s);
+	webSocketManager.sendControl(client, s);
+}
+
+/**
+ * @brief Sendet eine Antwort auf ein "serial"-Kommando mit Kanal-ID und JSON-Wert als Details.
+ *
+ * @param client Ziel-Client.
+ * @param channel Kanal-ID.
+ * @param action Aktion.
+ * @param status "success" oder "error".
+ * @param details JSON-Wert (z. B. Objekt oder Array).
+ */
+void sendSerialResponse(AsyncWebSocketClient *client, int channel, const String &action, const String &status, const JsonVariantConst &details) {
+	if (status != "success" && status != "error") return;
+
+	// Details können groß sein (Abfragen, Regeln, Schnappschuss): Platz nach deren Bedarf
+	DynamicJsonDocument d(details.memoryUsage() + 256);
+	d["event"] = "serial";
+	d["channel"] = channel;
+	d["action"] = action;
+	d["status"] = status;
+	d["details"] = details;
+
+	String s;
+	serializeJson(d, s);
+	webSocketManager.sendControl(client, s);
 }
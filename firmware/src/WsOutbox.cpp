@@ -0,0 +1,405 @@
+/**
+ * @file WsOutbox.cpp
+ * @brief Implementierung der Sendewarteschlangen pro WebSocket-Client.
+ *
+ * Jeder Client erhält beim Verbinden einen Speicherblock aus dem Gesamtbudget, der in einen
+ * Ring für Steuerantworten (CONTROL_SHARE) und einen Ring für serielle Daten geteilt wird.
+ * Eine Nachricht liegt im Ring als 8-Byte-Kopf (Länge, Binär-Flag, Zeitstempel) plus Nutzdaten.
+ *
+ * Das Senden selbst passiert außerhalb der Sperre: pump() kopiert die nächste Nachricht in
+ * einen Zwischenpuffer und übergibt sie erst danach an den Sink. Weil Einreihen und Entnehmen
+ * bis zu MAX_MESSAGE Bytes (bei broadcast() je Client) unter der Sperre kopieren, ist sie ein
+ * Mutex statt eines Spinlocks; Interrupts bleiben währenddessen frei.
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include "WsOutbox.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+/// Kopf einer Nachricht im Ring
+struct RecordHeader {
+	uint16_t len;      ///< Länge der Nutzdaten
+	uint8_t binary;    ///< 1 = Binär-Frame
+	uint8_t reserved;  ///< Auffüllung
+	uint32_t at;       ///< Zeitpunkt des Einreihens in ms
+};
+
+}  // namespace
+
+/**
+ * @brief Konstruktor.
+ *
+ * @param sink Ziel für gesendete Nachrichten.
+ */
+WsOutbox::WsOutbox(WsOutboxSink &sink)
+    : _sink(sink), _config{DEFAULT_CLIENT_BUDGET, DEFAULT_TOTAL_BUDGET, WS_SLOW_DROP_OLDEST}, _allocated(0), _next(0), _wake(nullptr), _wakeCtx(nullptr) {
+	for (auto &slot : _slots) {
+		slot.used = false;
+		slot.mem = nullptr;
+	}
+}
+
+/**
+ * @brief Destruktor, gibt alle Client-Puffer frei.
+ */
+WsOutbox::~WsOutbox() {
+	for (auto &slot : _slots) free(slot.mem);
+}
+
+void WsOutbox::lock() const {
+	_lock.enter();
+}
+
+void WsOutbox::unlock() const {
+	_lock.exit();
+}
+
+/**
+ * @brief Setzt Budget und Strategie.
+ *
+ * @param config Neue Konfiguration.
+ */
+void WsOutbox::configure(const WsOutboxConfig &config) {
+	lock();
+	_config = config;
+	unlock();
+}
+
+/**
+ * @brief Gibt die aktuelle Konfiguration zurück.
+ */
+WsOutboxConfig WsOutbox::config() const {
+	lock();
+	WsOutboxConfig c = _config;
+	unlock();
+	return c;
+}
+
+/**
+ * @brief Registriert einen Callback zum Wecken der Sende-Task.
+ *
+ * @param wake Callback (darf nullptr sein).
+ * @param ctx Kontext des Callbacks.
+ */
+void WsOutbox::onEnqueue(void (*wake)(void *ctx), void *ctx) {
+	_wake = wake;
+	_wakeCtx = ctx;
+}
+
+/**
+ * @brief Legt die Warteschlange für einen neuen Client an.
+ *
+ * Der Speicher wird außerhalb der Sperre angefordert; bis dahin verwirft der Slot Nachrichten.
+ *
+ * @param id Client-ID.
+ * @return false, wenn kein Slot oder Budget frei ist.
+ */
+bool WsOutbox::attach(uint32_t id) {
+	lock();
+	Slot *slot = nullptr;
+	for (auto &s : _slots) {
+		if (!s.used) {
+			slot = &s;
+			break;
+		}
+	}
+	size_t left = _config.totalBudget > _allocated ? _config.totalBudget - _allocated : 0;
+	size_t budget = _config.clientBudget < left ? _config.clientBudget : left;
+	if (!slot || budget < MIN_CLIENT_BUDGET) {
+		unlock();
+		return false;
+	}
+	slot->used = true;
+	slot->closing = false;
+	slot->closed = false;
+	slot->mem = nullptr;
+	slot->control.reset(nullptr, 0);
+	slot->bulk.reset(nullptr, 0);
+	slot->queued = 0;
+	slot->gapMessages = 0;
+	slot->gapBytes = 0;
+	slot->stats = WsClientStats{id, budget, 0, 0, 0, 0, 0, 0};
+	_allocated += budget;
+	unlock();
+
+	uint8_t *mem = static_cast<uint8_t *>(malloc(budget));
+
+	lock();
+	bool ok = mem && slot->used && slot->stats.id == id;
+	if (ok) {
+		slot->mem = mem;
+		slot->control.reset(mem, CONTROL_SHARE);
+		slot->bulk.reset(mem + CONTROL_SHARE, budget - CONTROL_SHARE);
+	} else if (slot->used && slot->stats.id == id) {
+		release(*slot);
+	}
+	unlock();
+	if (!ok) free(mem);
+	return ok;
+}
+
+/**
+ * @brief Gibt die Warteschlange eines getrennten Clients frei.
+ *
+ * @param id Client-ID.
+ */
+void WsOutbox::detach(uint32_t id) {
+	lock();
+	Slot *slot = find(id);
+	uint8_t *mem = nullptr;
+	if (slot) {
+		mem = slot->mem;
+		release(*slot);
+	}
+	unlock();
+	free(mem);
+}
+
+/**
+ * @brief Reiht eine Nachricht für einen Client ein.
+ *
+ * @param id Client-ID.
+ * @param prio Priorität.
+ * @param data Nachricht.
+ * @param len Länge.
+ * @param binary true = Binär-Frame.
+ * @param now Aktuelle Zeit in ms.
+ * @return false, wenn die Nachricht verworfen wurde.
+ */
+bool WsOutbox::enqueue(uint32_t id, WsPriority prio, const uint8_t *data, size_t len, bool binary, uint32_t now) {
+	lock();
+	Slot *slot = find(id);
+	bool ok = slot && enqueueLocked(*slot, prio, data, len, binary, now);
+	bool wake = slot && (ok || slot->closing);
+	unlock();
+	if (wake && _wake) _wake(_wakeCtx);
+	return ok;
+}
+
+/**
+ * @brief Reiht eine Nachricht für alle Clients ein.
+ *
+ * @param prio Priorität.
+ * @param data Nachricht.
+ * @param len Länge.
+ * @param binary true = Binär-Frame.
+ * @param now Aktuelle Zeit in ms.
+ */
+void WsOutbox::broadcast(WsPriority prio, const uint8_t *data, size_t len, bool binary, uint32_t now) {
+	bool any = false;
+	lock();
+	for (auto &slot : _slots) {
+		if (slot.used) any |= enqueueLocked(slot, prio, data, len, binary, now) || slot.closing;
+	}
+	unlock();
+	if (any && _wake) _wake(_wakeCtx);
+}
+
+/**
+ * @brief Reicht wartende Nachrichten weiter (Round Robin, eine Nachricht pro Client und Runde).
+ *
+ * @param now Aktuelle Zeit in ms.
+ * @return Anzahl der weitergereichten Nachrichten.
+ */
+size_t WsOutbox::pump(uint32_t now) {
+	size_t sent = 0;
+	bool progress = true;
+	while (progress) {
+		progress = false;
+		for (size_t k = 0; k < MAX_CLIENTS; ++k) {
+			Slot &slot = _slots[(_next + k) % MAX_CLIENTS];
+
+			lock();
+			uint32_t id = slot.stats.id;
+			bool close = slot.used && slot.closing && !slot.closed;
+			bool pending = slot.used && !slot.closing && (slot.queued > 0 || slot.gapMessages > 0);
+			if (close) slot.closed = true;
+			unlock();
+
+			if (close) _sink.close(id);
+			if (!pending || !_sink.canSend(id)) continue;
+
+			size_t len = 0;
+			bool binary = false;
+			lock();
+			bool ok = slot.used && slot.stats.id == id && takeNext(slot, now, len, binary);
+			if (ok) slot.stats.sent++;
+			unlock();
+			if (!ok) continue;
+
+			_sink.send(id, _scratch, len, binary);
+			sent++;
+			progress = true;
+		}
+		_next = (_next + 1) % MAX_CLIENTS;
+	}
+	return sent;
+}
+
+/**
+ * @brief Liefert die Zähler aller verbundenen Clients.
+ *
+ * @param out Zielarray.
+ * @param max Größe des Zielarrays.
+ * @return Anzahl der Einträge.
+ */
+size_t WsOutbox::stats(WsClientStats *out, size_t max) const {
+	size_t n = 0;
+	lock();
+	for (const auto &slot : _slots) {
+		if (!slot.used || n >= max) continue;
+		out[n] = slot.stats;
+		out[n].queuedBytes = slot.control.size() + slot.bulk.size();
+		out[n].queued = slot.queued;
+		n++;
+	}
+	unlock();
+	return n;
+}
+
+/**
+ * @brief Freier Platz im Datenpuffer eines Clients.
+ *
+ * @param id Client-ID.
+ * @return Freie Bytes (0 bei unbekanntem oder getrenntem Client).
+ */
+size_t WsOutbox::bulkSpace(uint32_t id) const {
+	lock();
+	const Slot *slot = find(id);
+	size_t space = slot && !slot->closing ? slot->bulk.space() : 0;
+	unlock();
+	return space;
+}
+
+WsOutbox::Slot *WsOutbox::find(uint32_t id) {
+	for (auto &slot : _slots) {
+		if (slot.used && slot.stats.id == id) return &slot;
+	}
+	return nullptr;
+}
+
+const WsOutbox::Slot *WsOutbox::find(uint32_t id) const {
+	for (const auto &slot : _slots) {
+		if (slot.used && slot.stats.id == id) return &slot;
+	}
+	return nullptr;
+}
+
+/**
+ * @brief Gibt das Budget eines Slots zurück und markiert ihn als frei (Sperre gehalten).
+ */
+void WsOutbox::release(Slot &slot) {
+	_allocated -= slot.stats.budget;
+	slot.used = false;
+	slot.mem = nullptr;
+	slot.control.reset(nullptr, 0);
+	slot.bulk.reset(nullptr, 0);
+}
+
+/**
+ * @brief Verwirft die älteste Nachricht eines Rings (Sperre gehalten).
+ *
+ * @return Länge der verworfenen Nutzdaten.
+ */
+size_t WsOutbox::dropOldest(ByteRing &ring, Slot &slot) {
+	RecordHeader hdr;
+	if (ring.peek(&hdr, sizeof(hdr)) != sizeof(hdr)) return 0;
+	ring.drop(sizeof(hdr) + hdr.len);
+	slot.queued--;
+	slot.stats.drops++;
+	slot.stats.droppedBytes += hdr.len;
+	return hdr.len;
+}
+
+/**
+ * @brief Verwirft alle Nachrichten eines Rings und merkt sie für die Lückenmeldung vor.
+ */
+void WsOutbox::dropAll(ByteRing &ring, Slot &slot) {
+	while (ring.size() > 0) {
+		slot.gapBytes += dropOldest(ring, slot);
+		slot.gapMessages++;
+	}
+}
+
+/**
+ * @brief Reiht eine Nachricht ein und wendet bei Platzmangel die Strategie an (Sperre gehalten).
+ *
+ * @return false, wenn die Nachricht verworfen wurde.
+ */
+bool WsOutbox::enqueueLocked(Slot &slot, WsPriority prio, const uint8_t *data, size_t len, bool binary, uint32_t now) {
+	if (slot.closing) return false;
+
+	ByteRing &ring = prio == WS_PRIO_CONTROL ? slot.control : slot.bulk;
+	size_t need = sizeof(RecordHeader) + len;
+	if (len > MAX_MESSAGE || need > ring.capacity()) {
+		slot.stats.drops++;
+		slot.stats.droppedBytes += len;
+		return false;
+	}
+
+	if (need > ring.space()) {
+		if (prio == WS_PRIO_CONTROL || _config.policy == WS_SLOW_DROP_OLDEST) {
+			while (need > ring.space()) dropOldest(ring, slot);
+		} else if (_config.policy == WS_SLOW_COALESCE) {
+			dropAll(ring, slot);
+		} else {
+			// WS_SLOW_DISCONNECT: Rückstand verwerfen, pump() trennt den Client
+			while (slot.control.size() > 0) dropOldest(slot.control, slot);
+			while (slot.bulk.size() > 0) dropOldest(slot.bulk, slot);
+			slot.stats.drops++;
+			slot.stats.droppedBytes += len;
+			slot.closing = true;
+			return false;
+		}
+	}
+
+	RecordHeader hdr{(uint16_t)len, (uint8_t)(binary ? 1 : 0), 0, now};
+	ring.push(&hdr, sizeof(hdr));
+	ring.push(data, len);
+	slot.queued++;
+	return true;
+}
+
+/**
+ * @brief Entnimmt die nächste Nachricht in den Zwischenpuffer (Sperre gehalten).
+ *
+ * Reihenfolge: Steuerantworten, dann eine ggf. ausstehende Lückenmeldung, dann Daten.
+ *
+ * @param slot Client.
+ * @param now Aktuelle Zeit in ms.
+ * @param len Ausgabe: Länge der Nachricht.
+ * @param binary Ausgabe: Binär-Frame?
+ * @return false, wenn nichts wartet.
+ */
+bool WsOutbox::takeNext(Slot &slot, uint32_t now, size_t &len, bool &binary) {
+	if (slot.control.size() == 0 && slot.gapMessages > 0) {
+		int n = snprintf((char *)_scratch, sizeof(_scratch),
+		                 "{\"event\":\"serial\",\"action\":\"gap\",\"status\":\"warning\",\"details\":{\"messages\":%u,\"bytes\":%u}}",
+		                 (unsigned)slot.gapMessages, (unsigned)slot.gapBytes);
+		slot.gapMessages = 0;
+		slot.gapBytes = 0;
+		len = (size_t)n;
+		binary = false;
+		return true;
+	}
+
+	ByteRing &ring = slot.control.size() > 0 ? slot.control : slot.bulk;
+	RecordHeader hdr;
+	if (ring.peek(&hdr, sizeof(hdr)) != sizeof(hdr)) return false;
+	ring.peek(_scratch, hdr.len, sizeof(hdr));
+	ring.drop(sizeof(hdr) + hdr.len);
+	slot.queued--;
+
+	uint32_t delay = now - hdr.at;
+	if (delay > slot.stats.maxDelayMs) slot.stats.maxDelayMs = delay;
+	len = hdr.len;
+	binary = hdr.binary != 0;
+	return true;
+}
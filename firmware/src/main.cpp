@@ -26,8 +26,10 @@
 #include <nvs.h>
 #include <nvs_flash.h>
 
+#include "EspUartPort.h"
 #include "FSHandler.h"
 #include "LLog.h"
+#include "LittleFsCaptureStore.h"
 #include "SerialBridge.h"
 #include "StatusHandler.h"
 #include "WebServerManager.h"
@@ -48,11 +50,40 @@ WebServerManager webServerManager;
 /// WebSocket-Manager für Echtzeitkommunikation mit dem Client
 WebSocketManager webSocketManager("/ws");
 
-/// Task-Handle für die SerialBridge
-static TaskHandle_t serialBridgeTaskHandle = nullptr;
+/// Task-Handles der SerialBridges (ein Eintrag pro Kanal)
+static TaskHandle_t serialBridgeTaskHandles[SERIAL_CHANNELS] = {};
 
-/// Globale SerialBridge-Instanz zur Kommunikation über UART2
-SerialBridge* serialBridge = nullptr;
+/// UART2 über den IDF-Treiber (Event-Queue), Kanal 0
+static EspUartPort serialPort(UART_NUM_2, RXD2, TXD2, RTS2, CTS2, BOOT2, RST2);
+
+#if SERIAL_CHANNELS > 1
+/// UART1 über den IDF-Treiber, Kanal 1 (ohne Flusskontroll-Pins)
+static EspUartPort serialPort1(UART_NUM_1, RXD1, TXD1);
+#endif
+
+/**
+ * @struct SerialChannelDef
+ * @brief Zuordnung eines Kanals zu UART und Pins.
+ */
+struct SerialChannelDef {
+	UartPort &port;  ///< UART des Kanals
+	uint8_t rxPin;   ///< RX-Pin (Anwesenheitserkennung)
+	uint8_t txPin;   ///< TX-Pin (Anwesenheitserkennung)
+};
+
+/// Kanaltabelle; der Index ist die Kanal-ID
+static SerialChannelDef serialChannels[SERIAL_CHANNELS] = {
+    {serialPort, RXD2, TXD2},
+#if SERIAL_CHANNELS > 1
+    {serialPort1, RXD1, TXD1},
+#endif
+};
+
+/// Ablage der seriellen Mitschnitte unter /logs/device (eine Instanz pro Kanal)
+static LittleFsCaptureStore captureStores[SERIAL_CHANNELS];
+
+/// Globale SerialBridge-Instanzen, Index = Kanal-ID (Kanal 0 = UART2)
+SerialBridge* serialBridges[SERIAL_CHANNELS] = {};
 
 /**
  * @brief Gibt den Inhalt eines Verzeichnisses rekursiv im Log aus.
@@ -204,6 +235,9 @@ void setup() {
 	LLog::setFileLogging(fileLog);
 	preferences.end();
 
+	// Ab hier schreibt eine Task mit niedriger Priorität die Logs gebündelt (Konsole und Dateien)
+	logger.startWriter(1, 0);
+
 	logger.log({"system", "info"}, "System startet...");
 
 	// WLAN initialisieren (AP + STA, Konfiguration aus NVS)
@@ -215,11 +249,20 @@ void setup() {
 	server.begin();
 	logger.log({"system", "info"}, "HTTP & WS gestartet");
 
-	// SerialBridge über WS
-	serialBridge = new SerialBridge(Serial2, webSocketManager.getSocket(), RXD2, TXD2);
-	serialBridge->begin(9600);
-	serialBridge->start(&serialBridgeTaskHandle, 3, 1);
-	logger.log({"system", "info", "device"}, "UART2 gestartet auf RX=16, TX=17, 9600 Baud");
+	// SerialBridges über WS, eine pro Kanal mit eigenen Tasks und Puffern
+	for (uint8_t ch = 0; ch < SERIAL_CHANNELS; ++ch) {
+		const SerialChannelDef &def = serialChannels[ch];
+		serialBridges[ch] = new SerialBridge(def.port, webSocketManager.getOutbox(), captureStores[ch], ch, def.rxPin, def.txPin);
+		serialBridges[ch]->begin(9600);
+		serialBridges[ch]->start(&serialBridgeTaskHandles[ch], 3, 1);
+		// TCP-Zugang (roh/RFC 2217) mit Voreinstellung; abschaltbar über `serial`/`tcp`/`disable`
+		serialBridges[ch]->setTcp({SERIAL_TCP_AUTOSTART != 0, (uint16_t)(SERIAL_TCP_RAW_PORT + ch), (uint16_t)(SERIAL_RFC2217_PORT + ch)});
+		logger.log({"system", "info", "device"}, "Kanal " + String(ch) + " gestartet auf RX=" + String(def.rxPin) + ", TX=" + String(def.txPin) + ", 9600 Baud");
+	}
+	// Gespeicherte zyklische Abfragen (serial/poll) wieder aufnehmen
+	loadSerialPolls();
+	// Regeln auf dem Datenstrom (serial/trigger) einmal übersetzen
+	loadSerialTriggers();
 
 	// Kurze Pause
 	vTaskDelay(pdMS_TO_TICKS(1000));
@@ -0,0 +1,55 @@
+/**
+ * @file DeviceCapture.h
+ * @brief Mitschnitt der seriellen Ausgabe einer angeschlossenen Steuerung (Testdaten).
+ *
+ * Enthält Bootmeldungen, zyklische Statuszeilen mit CR+LF, kurze Quittungen und eine
+ * überlange Diagnosezeile. Wird von den nativen Tests und Benchmarks als Eingabe genutzt.
+ */
+
+#ifndef DEVICECAPTURE_H
+#define DEVICECAPTURE_H
+
+#include <cstddef>
+
+static const char DEVICE_CAPTURE[] =
+    "\r\n"
+    "HT-CTRL Bootloader v2.3.1\r\n"
+    "Flash OK, CRC 0x5A3C91F2\r\n"
+    "Starting application...\r\n"
+    "[0000.112] SYS init clocks 168MHz\r\n"
+    "[0000.140] SYS rtc ok 2024-03-11 07:42:19\r\n"
+    "[0000.203] IO  inputs=0x00F3 outputs=0x0000\r\n"
+    "[0000.251] HT  heater zones: 6\r\n"
+    "[0000.298] HT  zone1 sp=180.0 pv=21.4 out=0%\r\n"
+    "[0000.301] HT  zone2 sp=180.0 pv=21.6 out=0%\r\n"
+    "[0000.305] HT  zone3 sp=175.0 pv=21.2 out=0%\r\n"
+    "[0000.309] HT  zone4 sp=175.0 pv=21.9 out=0%\r\n"
+    "[0000.312] HT  zone5 sp=170.0 pv=22.0 out=0%\r\n"
+    "[0000.316] HT  zone6 sp=170.0 pv=21.7 out=0%\r\n"
+    "READY\r\n"
+    "> STATUS\r\n"
+    "OK\r\n"
+    "Z1:21.4;Z2:21.6;Z3:21.2;Z4:21.9;Z5:22.0;Z6:21.7;P:1.013;F:0;ERR:0\r\n"
+    "[0001.002] HT  zone1 pv=24.9 out=100%\r\n"
+    "[0001.004] HT  zone2 pv=25.2 out=100%\r\n"
+    "[0001.007] HT  zone3 pv=24.1 out=100%\r\n"
+    "[0001.009] WARN zone4 thermocouple noise 3.2K\r\n"
+    "[0001.013] HT  zone5 pv=23.8 out=100%\r\n"
+    "[0001.016] HT  zone6 pv=24.0 out=100%\r\n"
+    "> RECIPE 12\r\n"
+    "OK recipe=12 name=\"PA6-GF30 standard\" zones=6 ramp=4.0K/min hold=900s\r\n"
+    "[0002.500] DIAG adc raw=0812 0815 0809 0811 080F 0813 0810 0814 0816 0812 0810 080E 0811 0813 0812 "
+    "0810 0815 0809 0811 080F 0813 0810 0814 0816 0812 0810 080E 0811 0813 0812 0810 0815 0809 0811 080F "
+    "0813 0810 0814 0816 0812 0810 080E 0811 0813 0812 0810 0815 0809 0811 080F 0813 0810 0814 0816\r\n"
+    "ACK\n"
+    "ACK\n"
+    "E:0\n"
+    "[0003.001] HT  zone1 pv=31.7 out=100%\r\n"
+    "[0003.003] HT  zone2 pv=32.0 out=100%\r\n"
+    "[0003.006] ERR 0x21 overtemp zone3 limit=200.0 pv=203.4\r\n"
+    "[0003.009] SYS fault latched, outputs off\r\n";
+
+/// Länge des Mitschnitts ohne abschließendes Nullbyte
+static const size_t DEVICE_CAPTURE_LEN = sizeof(DEVICE_CAPTURE) - 1;
+
+#endif  // DEVICECAPTURE_H
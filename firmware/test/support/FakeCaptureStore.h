@@ -0,0 +1,85 @@
+/**
+ * @file FakeCaptureStore.h
+ * @brief CaptureStore im RAM für die nativen Unit-Tests.
+ *
+ * Dateien liegen in einer std::map; "älteste" Datei ist die zuerst angelegte. Der freie Platz
+ * ergibt sich aus einer festen Dateisystemgröße abzüglich aller Dateien.
+ */
+
+#ifndef FAKECAPTURESTORE_H
+#define FAKECAPTURESTORE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "CaptureStore.h"
+
+class FakeCaptureStore : public CaptureStore {
+   public:
+	std::map<std::string, std::string> files;  ///< Dateiname -> Inhalt
+	std::vector<std::string> order;            ///< Anlagereihenfolge
+	std::vector<std::string> removed;          ///< Gelöschte Dateien
+	size_t capacity = 64 * 1024 * 1024;        ///< Größe des Dateisystems
+	size_t writes = 0;                         ///< Anzahl der write()-Aufrufe
+	bool failWrites = false;                   ///< write() schlägt fehl
+
+	bool open(const char *name) override {
+		_current = name;
+		files[_current].clear();
+		for (auto it = order.begin(); it != order.end(); ++it) {
+			if (*it == _current) {
+				order.erase(it);
+				break;
+			}
+		}
+		order.push_back(_current);
+		return true;
+	}
+
+	size_t write(const uint8_t *data, size_t len) override {
+		if (_current.empty() || failWrites) return 0;
+		writes++;
+		files[_current].append((const char *)data, len);
+		return len;
+	}
+
+	void close() override {
+		_current.clear();
+	}
+
+	size_t usedBytes() override {
+		size_t sum = 0;
+		for (const auto &f : files) sum += f.second.size();
+		return sum;
+	}
+
+	size_t freeBytes() override {
+		size_t used = usedBytes();
+		return used < capacity ? capacity - used : 0;
+	}
+
+	size_t removeOldest(const char *keep) override {
+		for (auto it = order.begin(); it != order.end(); ++it) {
+			if (*it == keep) continue;
+			size_t size = files[*it].size();
+			files.erase(*it);
+			removed.push_back(*it);
+			order.erase(it);
+			return size;
+		}
+		return 0;
+	}
+
+	/**
+	 * @brief Name der gerade geöffneten Datei ("" = keine).
+	 */
+	const std::string &current() const {
+		return _current;
+	}
+
+   private:
+	std::string _current;
+};
+
+#endif  // FAKECAPTURESTORE_H
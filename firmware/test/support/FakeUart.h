@@ -0,0 +1,142 @@
+/**
+ * @file FakeUart.h
+ * @brief Fake-UART mit virtueller Uhr für die nativen Unit-Tests.
+ *
+ * Bytes werden mit einem Ankunftszeitpunkt eingeplant und erst lesbar, wenn die virtuelle Uhr
+ * diesen Zeitpunkt erreicht. `sleep()` und `waitEvent()` lassen die Uhr vorlaufen, sodass
+ * Aufwachvorgänge und Latenzen der SerialBridge ohne Hardware gemessen werden können.
+ */
+
+#ifndef FAKEUART_H
+#define FAKEUART_H
+
+#include <deque>
+#include <string>
+#include <utility>
+
+#include "UartPort.h"
+
+class FakeUart : public UartPort {
+   public:
+	uint32_t clock = 0;                         ///< Virtuelle Zeit in ms
+	uint32_t baud = 0;                          ///< Zuletzt gesetzte Baudrate
+	std::string written;                        ///< Alles, was über write() gesendet wurde
+	std::deque<uint8_t> rx;                     ///< Bereits "empfangene", noch nicht gelesene Bytes
+	std::deque<UartEventType> injected;         ///< Zusätzliche Ereignisse (z. B. Überlauf)
+	std::string trace;                          ///< Gesendete Bytes mit "<DE+>"/"<DE->"-Markern
+	uint64_t busyUs = 0;                        ///< Summe aller delayMicros()-Aufrufe
+	uint32_t txDoneCalls = 0;                   ///< Anzahl der waitTxDone()-Aufrufe
+	SerialFlowControl flow = SERIAL_FLOW_NONE;  ///< Zuletzt gesetzte Flusskontrolle
+	bool hwFlow = true;                         ///< Unterstützt die Fake-UART RTS/CTS?
+	bool bootLines = false;                     ///< Boot-/Reset-Leitungen verdrahtet?
+
+	/**
+	 * @brief Plant `data` zur Ankunft zum Zeitpunkt `atMs` ein.
+	 */
+	void schedule(uint32_t atMs, const std::string &data) {
+		for (char c : data) _pending.push_back(std::make_pair(atMs, (uint8_t)c));
+	}
+
+	bool begin(uint32_t b) override {
+		baud = b;
+		return true;
+	}
+
+	size_t available() override {
+		deliver();
+		return rx.size();
+	}
+
+	size_t read(uint8_t *buf, size_t len) override {
+		size_t n = 0;
+		while (n < len && !rx.empty()) {
+			buf[n++] = rx.front();
+			rx.pop_front();
+		}
+		return n;
+	}
+
+	size_t write(const uint8_t *buf, size_t len) override {
+		written.append((const char *)buf, len);
+		trace.append((const char *)buf, len);
+		return len;
+	}
+
+	void flushInput() override {
+		rx.clear();
+	}
+
+	bool waitEvent(UartEvent &evt, uint32_t timeoutMs) override {
+		evt.size = 0;
+		if (!injected.empty()) {
+			evt.type = injected.front();
+			injected.pop_front();
+			return true;
+		}
+		deliver();
+		if (rx.empty()) {
+			if (_pending.empty() || _pending.front().first > clock + timeoutMs) {
+				clock += timeoutMs;
+				deliver();
+				return false;
+			}
+			clock = _pending.front().first;
+			deliver();
+		}
+		evt.type = rx.back() == '\n' ? RX_EVT_PATTERN : RX_EVT_DATA;
+		evt.size = rx.size();
+		return true;
+	}
+
+	void sleep(uint32_t ms) override {
+		clock += ms;
+		deliver();
+	}
+
+	uint32_t now() override {
+		return clock;
+	}
+
+	bool waitTxDone(uint32_t) override {
+		txDoneCalls++;
+		return true;
+	}
+
+	bool setFlowControl(SerialFlowControl mode) override {
+		if (mode == SERIAL_FLOW_RTS_CTS && !hwFlow) return false;
+		flow = mode;
+		return true;
+	}
+
+	void setDriverEnable(bool on) override {
+		trace += on ? "<DE+>" : "<DE->";
+	}
+
+	void delayMicros(uint32_t us) override {
+		busyUs += us;
+	}
+	bool setBootLines(bool boot, bool reset) override {
+		if (!bootLines) return false;
+		trace += "<B" + std::to_string(boot) + "R" + std::to_string(reset) + "@" + std::to_string(clock) + ">";
+		return true;
+	}
+
+	/**
+	 * @brief true, solange noch eingeplante Bytes ausstehen.
+	 */
+	bool pending() const {
+		return !_pending.empty();
+	}
+
+   private:
+	std::deque<std::pair<uint32_t, uint8_t>> _pending;
+
+	void deliver() {
+		while (!_pending.empty() && _pending.front().first <= clock) {
+			rx.push_back(_pending.front().second);
+			_pending.pop_front();
+		}
+	}
+};
+
+#endif  // FAKEUART_H
@@ -0,0 +1,111 @@
+/**
+ * @file PtyUart.h
+ * @brief UART auf einem Pseudo-Terminal für die nativen Unit-Tests (Linux).
+ *
+ * Die "UART" ist die Master-Seite eines pty; die Slave-Seite (`deviceFd()`) spielt das
+ * angeschlossene Gerät. Was der Test auf die Slave-Seite schreibt, liest die UART, und was
+ * über write() gesendet wird, kommt dort an. Die Slave-Seite ist auf Rohmodus gestellt, damit
+ * der Zeilenpuffer des Terminals keine Bytes umsetzt oder zurückhält.
+ */
+
+#ifndef PTYUART_H
+#define PTYUART_H
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdlib>
+
+#include "UartPort.h"
+
+class PtyUart : public UartPort {
+   public:
+	uint32_t baud = 0;  ///< Zuletzt gesetzte Baudrate
+
+	PtyUart() {
+		_master = posix_openpt(O_RDWR | O_NOCTTY);
+		if (_master < 0 || grantpt(_master) != 0 || unlockpt(_master) != 0) return;
+		_device = open(ptsname(_master), O_RDWR | O_NOCTTY);
+		if (_device < 0) return;
+		termios tio;
+		tcgetattr(_device, &tio);
+		cfmakeraw(&tio);
+		tcsetattr(_device, TCSANOW, &tio);
+		fcntl(_master, F_SETFL, fcntl(_master, F_GETFL) | O_NONBLOCK);
+	}
+
+	~PtyUart() override {
+		if (_device >= 0) ::close(_device);
+		if (_master >= 0) ::close(_master);
+	}
+
+	/**
+	 * @brief true, wenn das Pseudo-Terminal angelegt werden konnte.
+	 */
+	bool ok() const {
+		return _master >= 0 && _device >= 0;
+	}
+
+	/**
+	 * @brief Geräteseite (Slave) des Pseudo-Terminals.
+	 */
+	int deviceFd() const {
+		return _device;
+	}
+
+	bool begin(uint32_t b) override {
+		baud = b;
+		return true;
+	}
+
+	size_t available() override {
+		int n = 0;
+		return ioctl(_master, FIONREAD, &n) == 0 && n > 0 ? (size_t)n : 0;
+	}
+
+	size_t read(uint8_t *buf, size_t len) override {
+		ssize_t n = ::read(_master, buf, len);
+		return n > 0 ? (size_t)n : 0;
+	}
+
+	size_t write(const uint8_t *buf, size_t len) override {
+		ssize_t n = ::write(_master, buf, len);
+		return n > 0 ? (size_t)n : 0;
+	}
+
+	void flushInput() override {
+		uint8_t buf[256];
+		while (read(buf, sizeof(buf)) > 0) {
+		}
+	}
+
+	bool waitEvent(UartEvent &evt, uint32_t timeoutMs) override {
+		pollfd pfd = {_master, POLLIN, 0};
+		evt.size = 0;
+		evt.type = RX_EVT_TIMEOUT;
+		if (::poll(&pfd, 1, (int)timeoutMs) <= 0) return false;
+		evt.type = RX_EVT_DATA;
+		evt.size = available();
+		return true;
+	}
+
+	void sleep(uint32_t ms) override {
+		usleep(ms * 1000);
+	}
+
+	uint32_t now() override {
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+	}
+
+   private:
+	int _master = -1;  ///< UART-Seite
+	int _device = -1;  ///< Geräteseite
+};
+
+#endif  // PTYUART_H
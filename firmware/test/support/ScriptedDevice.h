@@ -0,0 +1,96 @@
+/**
+ * @file ScriptedDevice.h
+ * @brief Gerät mit festem Antwortverhalten für die nativen Tests der Skriptausführung.
+ *
+ * Regeln ordnen einer empfangenen Anfrage (Teilstring) eine Antwort mit Verzögerung zu. Eine
+ * Regel kann die ersten N passenden Anfragen unbeantwortet lassen, um Wiederholungen zu testen.
+ * Die Zeit ist virtuell: Der Test ruft deliver() mit der aktuellen Zeit auf und gibt fällige
+ * Antworten an die SerialScriptEngine weiter.
+ */
+
+#ifndef SCRIPTEDDEVICE_H
+#define SCRIPTEDDEVICE_H
+
+#include <string>
+#include <vector>
+
+#include "SerialScriptEngine.h"
+
+class ScriptedDevice {
+   public:
+	std::string received;  ///< Alles, was das Gerät empfangen hat
+
+	/**
+	 * @brief Legt eine Antwortregel an.
+	 *
+	 * @param request Teilstring der Anfrage.
+	 * @param reply Antwort.
+	 * @param delayMs Verzögerung der Antwort.
+	 * @param ignore Anzahl passender Anfragen, die unbeantwortet bleiben.
+	 */
+	void on(const std::string &request, const std::string &reply, uint32_t delayMs = 5, uint32_t ignore = 0) {
+		_rules.push_back(Rule{request, reply, delayMs, ignore});
+	}
+
+	/**
+	 * @brief Sendet ungefragt Daten (z. B. Statusmeldungen) zum Zeitpunkt `atMs`.
+	 */
+	void emit(uint32_t atMs, const std::string &data) {
+		_due.push_back(Reply{atMs, data});
+	}
+
+	/**
+	 * @brief Nimmt gesendete Bytes entgegen; nach jedem Zeilenende werden die Regeln geprüft.
+	 */
+	void write(const uint8_t *data, size_t len, uint32_t nowMs) {
+		received.append((const char *)data, len);
+		_input.append((const char *)data, len);
+		if (_input.find('\n') == std::string::npos && _input.find('\r') == std::string::npos) return;
+		for (Rule &r : _rules) {
+			if (_input.find(r.request) == std::string::npos) continue;
+			if (r.ignore > 0) {
+				r.ignore--;
+			} else {
+				_due.push_back(Reply{nowMs + r.delayMs, r.reply});
+			}
+			break;
+		}
+		_input.clear();
+	}
+
+	/**
+	 * @brief Übergibt alle bis `nowMs` fälligen Antworten an die Engine.
+	 *
+	 * @return true, wenn etwas übergeben wurde.
+	 */
+	bool deliver(uint32_t nowMs, SerialScriptEngine &engine) {
+		bool any = false;
+		for (size_t i = 0; i < _due.size();) {
+			if (_due[i].atMs <= nowMs) {
+				engine.onRx((const uint8_t *)_due[i].data.data(), _due[i].data.size());
+				_due.erase(_due.begin() + i);
+				any = true;
+			} else {
+				++i;
+			}
+		}
+		return any;
+	}
+
+   private:
+	struct Rule {
+		std::string request;
+		std::string reply;
+		uint32_t delayMs;
+		uint32_t ignore;
+	};
+	struct Reply {
+		uint32_t atMs;
+		std::string data;
+	};
+	std::vector<Rule> _rules;
+	std::vector<Reply> _due;
+	std::string _input;
+};
+
+#endif  // SCRIPTEDDEVICE_H
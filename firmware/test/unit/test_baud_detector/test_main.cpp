@@ -0,0 +1,265 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für die automatische Baudratenerkennung.
+ *
+ * Die Leitung wird bitgenau nachgebildet: Ein Gerät sendet den Mitschnitt aus `DeviceCapture.h`
+ * mit seiner Baudrate, ein UART-Empfänger mit 16-facher Überabtastung dekodiert ihn mit der
+ * gerade eingestellten Rate. So entstehen dieselben Fehlbytes wie an einer echten UART mit
+ * falscher Baudrate, gegen die die Bewertung geprüft wird.
+ */
+
+#include <unity.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BaudDetector.h"
+#include "DeviceCapture.h"
+
+static const uint32_t CANDIDATES[] = {115200, 57600, 38400, 19200, 1200, 2400, 4800, 9600};
+static const size_t NUM_CANDIDATES = sizeof(CANDIDATES) / sizeof(CANDIDATES[0]);
+
+/**
+ * @brief Pegelverlauf einer Leitung, auf der ein Gerät 8N1 sendet (Zeilenpause nach '\n').
+ */
+class Wire {
+   public:
+	Wire(const std::string &text, uint32_t baud, double durationUs, double lineGapUs = 2000.0) : _bitUs(1e6 / baud) {
+		if (text.empty()) return;
+		double t = 0.0;
+		for (size_t i = 0; t < durationUs; i = (i + 1) % text.size()) {
+			_starts.push_back(t);
+			_bytes.push_back((uint8_t)text[i]);
+			t += 10 * _bitUs;
+			if (text[i] == '\n') t += lineGapUs;
+		}
+	}
+
+	/// Pegel zum Zeitpunkt t (true = Ruhepegel/1)
+	bool level(double t) const {
+		auto it = std::upper_bound(_starts.begin(), _starts.end(), t);
+		if (it == _starts.begin()) return true;
+		size_t idx = (it - _starts.begin()) - 1;
+		int bit = (int)((t - _starts[idx]) / _bitUs);
+		if (bit == 0) return false;
+		if (bit <= 8) return (_bytes[idx] >> (bit - 1)) & 1;
+		return true;
+	}
+
+   private:
+	double _bitUs;
+	std::vector<double> _starts;
+	std::vector<uint8_t> _bytes;
+};
+
+/**
+ * @brief Dekodiert die Leitung ab `fromUs` mit der Rate `baud` (Zeitpunkt des Stoppbits, Byte).
+ */
+static std::vector<std::pair<double, uint8_t>> decode(const Wire &wire, uint32_t baud, double fromUs, double toUs) {
+	std::vector<std::pair<double, uint8_t>> out;
+	double bitUs = 1e6 / baud;
+	double step = bitUs / 16;
+	double t = fromUs;
+	bool prev = wire.level(t);
+	while (t < toUs) {
+		t += step;
+		bool l = wire.level(t);
+		if (prev && !l) {
+			double mid = t + bitUs / 2;
+			if (wire.level(mid)) {
+				prev = true;  // Störimpuls, kein Startbit
+				continue;
+			}
+			uint8_t b = 0;
+			for (int i = 0; i < 8; ++i) {
+				if (wire.level(mid + (i + 1) * bitUs)) b |= (uint8_t)(1 << i);
+			}
+			t = mid + 9 * bitUs;  // Stoppbit; Rahmenfehler liefern das Byte trotzdem
+			out.push_back(std::make_pair(t, b));
+			l = wire.level(t);
+		}
+		prev = l;
+	}
+	return out;
+}
+
+/**
+ * @brief UART, die eine simulierte Leitung mit der zuletzt gesetzten Rate dekodiert.
+ */
+class WireUart : public UartPort {
+   public:
+	uint32_t baud = 0;      ///< Zuletzt gesetzte Rate
+	uint32_t begins = 0;    ///< Anzahl der begin()-Aufrufe
+	uint32_t measured = 0;  ///< Ergebnis von measureBaud()
+	double clockUs = 0.0;   ///< Virtuelle Zeit
+
+	explicit WireUart(const Wire &wire) : _wire(wire), _pos(0) {
+	}
+	bool begin(uint32_t b) override {
+		baud = b;
+		begins++;
+		_rx = decode(_wire, b, clockUs, clockUs + 1e6);
+		_pos = 0;
+		return true;
+	}
+	size_t available() override {
+		size_t n = 0;
+		while (_pos + n < _rx.size() && _rx[_pos + n].first <= clockUs) n++;
+		return n;
+	}
+	size_t read(uint8_t *buf, size_t len) override {
+		size_t n = 0;
+		while (n < len && _pos < _rx.size() && _rx[_pos].first <= clockUs) buf[n++] = _rx[_pos++].second;
+		return n;
+	}
+	size_t write(const uint8_t *, size_t len) override {
+		return len;
+	}
+	void flushInput() override {
+		while (_pos < _rx.size() && _rx[_pos].first <= clockUs) _pos++;
+	}
+	bool waitEvent(UartEvent &evt, uint32_t timeoutMs) override {
+		evt.type = RX_EVT_DATA;
+		evt.size = 0;
+		if (available()) return true;
+		double limit = clockUs + timeoutMs * 1000.0;
+		if (_pos < _rx.size() && _rx[_pos].first <= limit) {
+			clockUs = _rx[_pos].first;
+			return true;
+		}
+		clockUs = limit;
+		evt.type = RX_EVT_TIMEOUT;
+		return false;
+	}
+	void sleep(uint32_t ms) override {
+		clockUs += ms * 1000.0;
+	}
+	uint32_t now() override {
+		return (uint32_t)(clockUs / 1000.0);
+	}
+	uint32_t measureBaud(uint32_t windowMs) override {
+		clockUs += windowMs * 1000.0 / 4;
+		return measured;
+	}
+
+   private:
+	const Wire &_wire;
+	std::vector<std::pair<double, uint8_t>> _rx;
+	size_t _pos;
+};
+
+static std::string capture() {
+	return std::string(DEVICE_CAPTURE, DEVICE_CAPTURE_LEN);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_score_accepts_device_output() {
+	TEST_ASSERT_TRUE(BaudDetector::score((const uint8_t *)DEVICE_CAPTURE, DEVICE_CAPTURE_LEN) >= BaudDetector::LOCK_SCORE);
+	const char *german = "Temperatur Zone 3 überschritten: 203,4 °C – Heizung aus\r\n";
+	TEST_ASSERT_TRUE(BaudDetector::score((const uint8_t *)german, strlen(german)) >= BaudDetector::LOCK_SCORE);
+	const uint8_t binary[] = {0x00, 0xFF, 0x80, 0x7F, 0x01, 0xF0, 0x0F, 0xC3, 0x3C, 0x00};
+	TEST_ASSERT_TRUE(BaudDetector::score(binary, sizeof(binary)) < BaudDetector::ACCEPT_SCORE);
+	TEST_ASSERT_TRUE(BaudDetector::score(binary, 0) == 0.0f);
+}
+
+void test_score_rejects_wrong_rates() {
+	// Jede Stichprobe, die an einer falsch eingestellten UART entsteht, muss unter der
+	// Mindestbewertung bleiben; an der richtigen Rate muss jede Stichprobe sofort einrasten.
+	for (uint32_t tx : CANDIDATES) {
+		Wire wire(capture(), tx, 3e6);
+		for (uint32_t rx : CANDIDATES) {
+			auto bytes = decode(wire, rx, 1234.5, 3e6);
+			float worst = 1.0f, bestWrong = 0.0f;
+			for (size_t off = 0; off + BaudDetector::SAMPLE_BYTES <= bytes.size(); off += BaudDetector::SAMPLE_BYTES) {
+				uint8_t sample[BaudDetector::SAMPLE_BYTES];
+				for (size_t i = 0; i < sizeof(sample); ++i) sample[i] = bytes[off + i].second;
+				float s = BaudDetector::score(sample, sizeof(sample));
+				worst = std::min(worst, s);
+				bestWrong = std::max(bestWrong, s);
+			}
+			if (rx == tx) {
+				TEST_ASSERT_TRUE_MESSAGE(worst >= BaudDetector::LOCK_SCORE, "richtige Rate nicht erkannt");
+			} else {
+				if (bestWrong >= BaudDetector::ACCEPT_SCORE) printf("tx=%u rx=%u score=%.2f\n", tx, rx, bestWrong);
+				TEST_ASSERT_TRUE_MESSAGE(bestWrong < BaudDetector::ACCEPT_SCORE, "falsche Rate bewertet wie lesbarer Text");
+			}
+		}
+	}
+}
+
+void test_nearest_baud_tolerance() {
+	TEST_ASSERT_EQUAL(9600, BaudDetector::nearestBaud(9600, CANDIDATES, NUM_CANDIDATES));
+	TEST_ASSERT_EQUAL(115200, BaudDetector::nearestBaud(111000, CANDIDATES, NUM_CANDIDATES));
+	TEST_ASSERT_EQUAL(38400, BaudDetector::nearestBaud(40000, CANDIDATES, NUM_CANDIDATES));
+	TEST_ASSERT_EQUAL(0, BaudDetector::nearestBaud(14400, CANDIDATES, NUM_CANDIDATES));
+	TEST_ASSERT_EQUAL(0, BaudDetector::nearestBaud(0, CANDIDATES, NUM_CANDIDATES));
+}
+
+void test_detect_locks_on_measured_rate() {
+	Wire wire(capture(), 9600, 5e6);
+	WireUart uart(wire);
+	uart.clockUs = 50000.0;
+	uart.measured = 9750;  // Pulsmessung mit Abweichung
+	BaudDetector det(uart);
+	BaudDetectResult res = det.detect(CANDIDATES, NUM_CANDIDATES, 115200);
+	TEST_ASSERT_EQUAL(9600, res.baud);
+	TEST_ASSERT_EQUAL(9600, uart.baud);
+	TEST_ASSERT_EQUAL(1, res.probes);
+	TEST_ASSERT_EQUAL(1, uart.begins);
+	TEST_ASSERT_TRUE(res.score >= BaudDetector::LOCK_SCORE);
+	TEST_ASSERT_TRUE(res.elapsedMs <= BaudDetector::MEASURE_MS + BaudDetector::PROBE_MS);
+}
+
+void test_detect_scans_without_measurement() {
+	for (uint32_t tx : {38400u, 2400u, 115200u}) {
+		Wire wire(capture(), tx, 5e6);
+		WireUart uart(wire);
+		uart.clockUs = 17000.0;
+		BaudDetector det(uart);
+		BaudDetectResult res = det.detect(CANDIDATES, NUM_CANDIDATES, 9600);
+		TEST_ASSERT_EQUAL(tx, res.baud);
+		TEST_ASSERT_EQUAL(tx, uart.baud);
+		TEST_ASSERT_EQUAL(0, res.measured);
+	}
+}
+
+void test_detect_wrong_hint_falls_back_to_scan() {
+	Wire wire(capture(), 57600, 5e6);
+	WireUart uart(wire);
+	uart.measured = 19200;  // z. B. durch Störimpulse verfälscht
+	BaudDetector det(uart);
+	BaudDetectResult res = det.detect(CANDIDATES, NUM_CANDIDATES, 9600);
+	TEST_ASSERT_EQUAL(57600, res.baud);
+	TEST_ASSERT_TRUE(res.probes >= 2);
+}
+
+void test_detect_silent_line_restores_fallback() {
+	Wire wire("", 9600, 0);
+	WireUart uart(wire);
+	BaudDetector det(uart);
+	BaudDetectResult res = det.detect(CANDIDATES, NUM_CANDIDATES, 4800);
+	TEST_ASSERT_EQUAL(0, res.baud);
+	TEST_ASSERT_EQUAL(4800, uart.baud);
+	TEST_ASSERT_EQUAL(NUM_CANDIDATES, res.probes);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_score_accepts_device_output);
+	RUN_TEST(test_score_rejects_wrong_rates);
+	RUN_TEST(test_nearest_baud_tolerance);
+	RUN_TEST(test_detect_locks_on_measured_rate);
+	RUN_TEST(test_detect_scans_without_measurement);
+	RUN_TEST(test_detect_wrong_hint_falls_back_to_scan);
+	RUN_TEST(test_detect_silent_line_restores_fallback);
+	return UNITY_END();
+}
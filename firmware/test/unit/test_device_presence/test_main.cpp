@@ -0,0 +1,144 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für die entprellte Geräteerkennung.
+ */
+
+#include <unity.h>
+
+#include "DevicePresence.h"
+
+static DevicePresenceConfig config(uint32_t debounceMs, uint32_t idleMs, bool levelSense) {
+	DevicePresenceConfig cfg;
+	cfg.debounceMs = debounceMs;
+	cfg.idleMs = idleMs;
+	cfg.levelSense = levelSense;
+	return cfg;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_connect_after_debounce() {
+	DevicePresence p;
+	TEST_ASSERT_TRUE(p.configure(config(50, 1000, true)));
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(0));
+	p.level(true, 100);
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(100));
+	p.level(true, 130);
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(130));
+	p.level(true, 150);
+	TEST_ASSERT_EQUAL(PRESENCE_CONNECTED, p.update(150));
+	TEST_ASSERT_TRUE(p.present());
+	// Weitere Lebenszeichen melden nichts erneut
+	p.activity(200);
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(200));
+	TEST_ASSERT_EQUAL(1, p.stats().connects);
+}
+
+void test_single_byte_connects() {
+	DevicePresence p;
+	p.configure(config(50, 1000, false));
+	// Ein einzelner kurzer Datenstoß ist ein vollständig empfangenes Zeichen, kein Störimpuls
+	p.activity(10);
+	TEST_ASSERT_EQUAL(PRESENCE_CONNECTED, p.update(10));
+	TEST_ASSERT_TRUE(p.present());
+	TEST_ASSERT_EQUAL(0, p.stats().glitches);
+}
+
+void test_single_glitch_is_ignored() {
+	DevicePresence p;
+	p.configure(config(50, 1000, true));
+	// Kurzer HIGH-Pegel beim Einstecken, danach Stille
+	p.level(true, 10);
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(10));
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(1010));
+	TEST_ASSERT_FALSE(p.present());
+	TEST_ASSERT_EQUAL(1, p.stats().glitches);
+
+	// Neuer Anlauf: Entprellung beginnt von vorn, ein empfangenes Byte bestätigt sofort
+	p.level(true, 2000);
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(2020));
+	p.activity(2030);
+	TEST_ASSERT_EQUAL(PRESENCE_CONNECTED, p.update(2030));
+}
+
+void test_disconnect_after_idle() {
+	DevicePresence p;
+	p.configure(config(0, 500, false));
+	p.activity(0);
+	TEST_ASSERT_EQUAL(PRESENCE_CONNECTED, p.update(0));
+	p.activity(400);
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(800));
+	TEST_ASSERT_EQUAL(PRESENCE_DISCONNECTED, p.update(900));
+	TEST_ASSERT_FALSE(p.present());
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(5000));
+	TEST_ASSERT_EQUAL(1, p.stats().disconnects);
+
+	// Wiederkehrendes Gerät
+	p.activity(6000);
+	TEST_ASSERT_EQUAL(PRESENCE_CONNECTED, p.update(6000));
+}
+
+void test_idle_zero_never_disconnects() {
+	DevicePresence p;
+	p.configure(config(0, 0, false));
+	p.activity(5);
+	TEST_ASSERT_EQUAL(PRESENCE_CONNECTED, p.update(5));
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(4000000000u));
+	TEST_ASSERT_TRUE(p.present());
+}
+
+void test_level_keeps_quiet_device_and_detects_unplug() {
+	DevicePresence p;
+	p.configure(config(100, 1000, true));
+	// Leitung HIGH, aber keine Daten: Gerät ist da und bleibt da
+	for (uint32_t t = 0; t <= 250; t += 50) {
+		p.level(true, t);
+		DevicePresenceEvent evt = p.update(t);
+		TEST_ASSERT_EQUAL(t >= 100 ? PRESENCE_CONNECTED : PRESENCE_NONE, evt);
+		if (evt == PRESENCE_CONNECTED) break;
+	}
+	for (uint32_t t = 300; t < 5000; t += 250) {
+		p.level(true, t);
+		TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(t));
+	}
+	// Kabel ab: Pull-down zieht RX auf LOW
+	p.level(false, 5000);
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(5050));
+	p.level(false, 5100);
+	TEST_ASSERT_EQUAL(PRESENCE_DISCONNECTED, p.update(5100));
+}
+
+void test_level_ignored_without_level_sense() {
+	DevicePresence p;
+	p.configure(config(0, 1000, false));
+	p.level(true, 0);
+	TEST_ASSERT_EQUAL(PRESENCE_NONE, p.update(0));
+	TEST_ASSERT_FALSE(p.hasActivity());
+}
+
+void test_validate() {
+	TEST_ASSERT_TRUE(DevicePresence::validate(DevicePresence::defaultConfig()));
+	TEST_ASSERT_TRUE(DevicePresence::validate(config(0, 0, true)));
+	TEST_ASSERT_FALSE(DevicePresence::validate(config(100, 100, false)));
+	TEST_ASSERT_FALSE(DevicePresence::validate(config(0, DevicePresence::MAX_MS + 1, false)));
+	DevicePresence p;
+	TEST_ASSERT_FALSE(p.configure(config(500, 100, false)));
+	TEST_ASSERT_EQUAL(DevicePresence::DEFAULT_IDLE_MS, p.config().idleMs);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_connect_after_debounce);
+	RUN_TEST(test_single_byte_connects);
+	RUN_TEST(test_single_glitch_is_ignored);
+	RUN_TEST(test_disconnect_after_idle);
+	RUN_TEST(test_idle_zero_never_disconnects);
+	RUN_TEST(test_level_keeps_quiet_device_and_detects_unplug);
+	RUN_TEST(test_level_ignored_without_level_sense);
+	RUN_TEST(test_validate);
+	return UNITY_END();
+}
@@ -0,0 +1,229 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests und Größenvergleich für binäre Logeinträge (LogCodec, LOGB-Pfad).
+ */
+
+#include <unity.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "LogCodec.h"
+#include "LogFilter.h"
+#include "LogJournal.h"
+#include "LogQueue.h"
+
+static LogQueue *queue;
+
+void setUp() {
+	queue = new LogQueue();
+}
+
+void tearDown() {
+	delete queue;
+}
+
+/**
+ * @brief Nachbildung von LLog::emitb(): Argumente direkt in die reservierte Zelle.
+ */
+template <uint16_t Id, typename... Args>
+static void emitb(uint32_t cats, uint32_t time, Args... args) {
+	static_assert(LogFormatCheck<Id, Args...>::value, "Argumente passen nicht zum Format");
+	uint32_t ticket;
+	LogRecord *rec = queue->reserve(ticket);
+	if (!rec) return;
+	rec->time = time;
+	rec->files = LogFilter::journalBits(cats);
+	rec->flags = LOG_RECORD_NEWLINE | LOG_RECORD_TIMESTAMP | LOG_RECORD_BINARY;
+	rec->format = Id;
+	rec->cats = (uint16_t)cats;
+	rec->tags[0] = '\0';
+	rec->argBytes = (uint8_t)LogCodec::encode((uint8_t *)rec->text, sizeof(rec->text), args...);
+	queue->commit(ticket);
+}
+
+/// Setzt den Text eines Formats mit Argumenten zusammen
+template <typename... Args>
+static std::string renderWith(uint16_t id, Args... args) {
+	uint8_t buf[LogRecord::TEXT];
+	size_t len = LogCodec::encode(buf, sizeof(buf), args...);
+	char out[LogRecord::TEXT];
+	LogCodec::render(id, buf, len, out, sizeof(out));
+	return out;
+}
+
+void test_varint_and_zigzag() {
+	uint8_t buf[8];
+	const uint8_t *p;
+	uint32_t v;
+	TEST_ASSERT_EQUAL_size_t(1, LogCodec::putUnsigned(buf, sizeof(buf), 127));
+	TEST_ASSERT_EQUAL_size_t(2, LogCodec::putUnsigned(buf, sizeof(buf), 128));
+	TEST_ASSERT_EQUAL_size_t(5, LogCodec::putUnsigned(buf, sizeof(buf), 0xFFFFFFFFu));
+	p = buf;
+	TEST_ASSERT_TRUE(LogCodec::getUnsigned(p, buf + 5, v));
+	TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFFu, v);
+	TEST_ASSERT_EQUAL_size_t(0, LogCodec::putUnsigned(buf, 1, 300));
+
+	// Kleine negative Zahlen bleiben ein Byte
+	TEST_ASSERT_EQUAL_size_t(1, LogCodec::putSigned(buf, sizeof(buf), -3));
+	TEST_ASSERT_EQUAL_UINT8(5, buf[0]);
+	p = buf;
+	TEST_ASSERT_FALSE(LogCodec::getUnsigned(p, buf, v));
+}
+
+void test_render_applies_format_spec() {
+	TEST_ASSERT_EQUAL_STRING("WS Client connected: 3", renderWith(LOG_FMT_WS_CLIENT_CONNECTED, 3u).c_str());
+	TEST_ASSERT_EQUAL_STRING("Scan gefunden: -1 Netze", renderWith(LOG_FMT_WIFI_SCAN_FOUND, -1).c_str());
+	TEST_ASSERT_EQUAL_STRING("[ch1] Device disconnected (1500 ms ohne Lebenszeichen)", renderWith(LOG_FMT_DEVICE_DISCONNECTED, "[ch1] ", 1500u).c_str());
+	TEST_ASSERT_EQUAL_STRING("Device connected", renderWith(LOG_FMT_DEVICE_CONNECTED, "").c_str());
+
+	// Unbekannte ID (neuere Firmware) und fehlende Argumente
+	TEST_ASSERT_EQUAL_STRING("<Format #999>", renderWith(999, 1u).c_str());
+	TEST_ASSERT_EQUAL_STRING("[ch1] Device disconnected (<?>", renderWith(LOG_FMT_DEVICE_DISCONNECTED, "[ch1] ").c_str());
+
+	// Texte werden auf MAX_STRING gekürzt
+	std::string longText(100, 'x');
+	std::string out = renderWith(LOG_FMT_DEVICE_CONNECTED, longText.c_str());
+	TEST_ASSERT_EQUAL_STRING((std::string(LogCodec::MAX_STRING, 'x') + "Device connected").c_str(), out.c_str());
+}
+
+void test_compile_time_check() {
+	static_assert(LogFormatCheck<LOG_FMT_WS_CLIENT_CONNECTED, unsigned>::value, "%u mit unsigned");
+	static_assert(LogFormatCheck<LOG_FMT_DEVICE_DISCONNECTED, char *, uint32_t>::value, "%s%u");
+	static_assert(!LogFormatCheck<LOG_FMT_WS_CLIENT_CONNECTED, int>::value, "Vorzeichen passt nicht");
+	static_assert(!LogFormatCheck<LOG_FMT_WS_CLIENT_CONNECTED>::value, "Argument fehlt");
+	static_assert(!LogFormatCheck<LOG_FMT_WS_CLIENT_CONNECTED, unsigned, unsigned>::value, "Argument zu viel");
+	static_assert(!LogFormatCheck<LOG_FMT_WS_CLIENT_CONNECTED, uint64_t>::value, "64 Bit");
+	static_assert(!LogFormatCheck<LOG_FMT_NONE>::value, "Keine ID");
+	static_assert(logConversion("a %-4.2s %% %08X", 1) == 'X', "Flags und Breite");
+	static_assert(logConversion("%ld", 0) == '?', "Längenangabe nicht erlaubt");
+	TEST_ASSERT_EQUAL_size_t(LOG_FMT_COUNT, sizeof(LOG_FORMAT_STRINGS) / sizeof(LOG_FORMAT_STRINGS[0]));
+	for (uint16_t id = 1; id < LOG_FMT_COUNT; ++id) TEST_ASSERT_NOT_NULL(LogCodec::format(id));
+}
+
+void test_binary_line_escaping() {
+	const uint8_t payload[] = {0x00, '\n', 0x41, '\r', 0x10, 0x1E, 0xFF};
+	char line[LogJournal::binaryLineBytes(sizeof(payload))];
+	size_t len = LogJournal::encodeBinary(0x0A, payload, sizeof(payload), line, sizeof(line));
+	TEST_ASSERT_TRUE(len > 0);
+	TEST_ASSERT_EQUAL_size_t(len, strlen(line));
+	TEST_ASSERT_NULL(memchr(line, '\n', len));
+	TEST_ASSERT_NULL(memchr(line, '\r', len));
+	TEST_ASSERT_TRUE(LogJournal::isBinary(line, len));
+
+	uint16_t files16;
+	const char *text;
+	TEST_ASSERT_FALSE(LogJournal::parse(line, len, files16, text));
+
+	uint8_t files;
+	uint8_t out[16];
+	size_t outLen;
+	TEST_ASSERT_TRUE(LogJournal::parseBinary(line, len, files, out, sizeof(out), outLen));
+	TEST_ASSERT_EQUAL_UINT8(0x0A, files);
+	TEST_ASSERT_EQUAL_size_t(sizeof(payload), outLen);
+	TEST_ASSERT_EQUAL_MEMORY(payload, out, sizeof(payload));
+
+	// 0x0A ist maskiert, 0x02 nicht: die Zeile wird kürzer
+	size_t cleared = LogJournal::clearBinaryBits(line, len, sizeof(line), 0x08);
+	TEST_ASSERT_EQUAL_size_t(len - 1, cleared);
+	TEST_ASSERT_TRUE(LogJournal::parseBinary(line, cleared, files, out, sizeof(out), outLen));
+	TEST_ASSERT_EQUAL_UINT8(0x02, files);
+	TEST_ASSERT_EQUAL_MEMORY(payload, out, sizeof(payload));
+	TEST_ASSERT_EQUAL_size_t(0, LogJournal::clearBinaryBits(line, cleared, sizeof(line), 0x02));
+
+	// Zeitmarken bleiben erhalten
+	len = LogJournal::encodeBinary(0, payload, 1, line, sizeof(line));
+	TEST_ASSERT_EQUAL_size_t(len, LogJournal::clearBinaryBits(line, len, sizeof(line), 0xFF));
+}
+
+void test_queue_record_renders_like_text() {
+	const uint32_t t = 1735732800;
+	emitb<LOG_FMT_WS_CLIENT_CONNECTED>(LOG_CAT_SOCKET | LOG_CAT_INFO, t, 3u);
+	const LogRecord *recs[1];
+	TEST_ASSERT_EQUAL_size_t(1, queue->peek(recs, 1));
+	TEST_ASSERT_EQUAL_UINT16(0x22, recs[0]->files);
+	TEST_ASSERT_EQUAL_UINT8(1, recs[0]->argBytes);
+
+	char binary[LogQueue::LINE_BYTES];
+	char text[LogQueue::LINE_BYTES];
+	LogQueue::format(*recs[0], binary, sizeof(binary));
+	LogQueue::formatLine("[SOCKET][INFO]", LOG_RECORD_TIMESTAMP, t, "WS Client connected: 3", text, sizeof(text));
+	TEST_ASSERT_EQUAL_STRING(text, binary);
+
+	// Journalzeile wie LLog::writeBinary() und zurück
+	uint8_t payload[LogCodec::ENTRY_HEADER + LogRecord::TEXT];
+	size_t n = LogCodec::encodeEntry(recs[0]->cats, 42, recs[0]->format, (const uint8_t *)recs[0]->text, recs[0]->argBytes, payload, sizeof(payload));
+	char line[LogJournal::binaryLineBytes(sizeof(payload))];
+	size_t len = LogJournal::encodeBinary((uint8_t)recs[0]->files, payload, n, line, sizeof(line));
+	uint8_t files;
+	uint8_t raw[sizeof(payload)];
+	size_t rawLen;
+	TEST_ASSERT_TRUE(LogJournal::parseBinary(line, len, files, raw, sizeof(raw), rawLen));
+	LogBinaryEntry entry;
+	TEST_ASSERT_TRUE(LogCodec::decodeEntry(raw, rawLen, entry));
+	TEST_ASSERT_EQUAL_UINT32(42, entry.delta);
+	LogCodec::renderLine(entry.cats, t - 42 + entry.delta, entry.format, entry.args, entry.argBytes, binary, sizeof(binary));
+	TEST_ASSERT_EQUAL_STRING(text, binary);
+}
+
+/**
+ * @brief Vergleicht die Journalgröße typischer Meldungen als Textzeile und binär.
+ *
+ * Die Zeitmarken werden wie in LLog::writeBinary() eingefügt.
+ */
+void test_benchmark_journal_bytes() {
+	const int count = 1000;
+	uint32_t t = 1735732800;
+	uint32_t markTime = 0;
+	bool marked = false;
+	size_t textBytes = 0;
+	size_t binaryBytes = 0;
+	char line[LogQueue::LINE_BYTES];
+	uint8_t payload[LogCodec::ENTRY_HEADER + LogRecord::TEXT];
+	char binLine[LogJournal::binaryLineBytes(sizeof(payload))];
+
+	for (int i = 0; i < count; ++i) {
+		t += 7 + (i % 5) * 60;
+		switch (i % 5) {
+			case 0: emitb<LOG_FMT_WS_CLIENT_CONNECTED>(LOG_CAT_SOCKET | LOG_CAT_INFO, t, (unsigned)(i % 8)); break;
+			case 1: emitb<LOG_FMT_WS_CLIENT_PONG>(LOG_CAT_SOCKET | LOG_CAT_INFO, t, (unsigned)(i % 8)); break;
+			case 2: emitb<LOG_FMT_WIFI_SCAN_FOUND>(LOG_CAT_SYSTEM | LOG_CAT_INFO | LOG_CAT_WIFI, t, i % 12); break;
+			case 3: emitb<LOG_FMT_DEVICE_DISCONNECTED>(LOG_CAT_SYSTEM | LOG_CAT_WARNING | LOG_CAT_DEVICE, t, "", (uint32_t)(1500 + i)); break;
+			default: emitb<LOG_FMT_WS_CLIENT_DISCONNECTED>(LOG_CAT_SOCKET | LOG_CAT_INFO, t, (unsigned)(i % 8)); break;
+		}
+		const LogRecord *recs[1];
+		TEST_ASSERT_EQUAL_size_t(1, queue->peek(recs, 1));
+		const LogRecord &rec = *recs[0];
+
+		// Bisher: Präfix, Textzeile und "\r\n"
+		textBytes += LogJournal::PREFIX_LEN + LogQueue::format(rec, line, sizeof(line)) + 2;
+
+		// Binär: ggf. Zeitmarke, dann der Eintrag, jeweils mit '\n'
+		if (!marked || rec.time < markTime || rec.time - markTime > LogCodec::MARK_SPAN) {
+			size_t n = LogCodec::encodeMark(rec.time, payload, sizeof(payload));
+			binaryBytes += LogJournal::encodeBinary(0, payload, n, binLine, sizeof(binLine)) + 1;
+			markTime = rec.time;
+			marked = true;
+		}
+		size_t n = LogCodec::encodeEntry(rec.cats, rec.time - markTime, rec.format, (const uint8_t *)rec.text, rec.argBytes, payload, sizeof(payload));
+		binaryBytes += LogJournal::encodeBinary((uint8_t)rec.files, payload, n, binLine, sizeof(binLine)) + 1;
+		queue->release(1);
+	}
+
+	printf("[log-codec] %d Meldungen: Text %u Bytes (%.1f/Eintrag), binär %u Bytes (%.1f/Eintrag), Faktor %.1f\n", count, (unsigned)textBytes,
+	       (double)textBytes / count, (unsigned)binaryBytes, (double)binaryBytes / count, (double)textBytes / (double)binaryBytes);
+	// Größen sind deterministisch
+	TEST_ASSERT_TRUE(binaryBytes * 6 < textBytes);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_varint_and_zigzag);
+	RUN_TEST(test_render_applies_format_spec);
+	RUN_TEST(test_compile_time_check);
+	RUN_TEST(test_binary_line_escaping);
+	RUN_TEST(test_queue_record_renders_like_text);
+	RUN_TEST(test_benchmark_journal_bytes);
+	return UNITY_END();
+}
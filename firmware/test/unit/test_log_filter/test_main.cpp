@@ -0,0 +1,214 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests und Allokations-Benchmark für die Log-Kategorien (LogFilter, LOGF-Pfad).
+ */
+
+// DEBUG wird für diese Übersetzungseinheit nicht übersetzt (wie per Build-Flag)
+#define LOG_BUILD_CATEGORIES 0xFFFFFFFEu
+
+#include <unity.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "LogFilter.h"
+#include "LogQueue.h"
+
+// Zählt alle Heap-Allokationen des Prozesses (noinline: sonst meldet GCC new/free als unpassend)
+static std::atomic<uint32_t> allocations(0);
+
+__attribute__((noinline)) void *operator new(size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	void *p = malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept {
+	free(p);
+}
+
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept {
+	free(p);
+}
+
+static LogQueue *queue;
+static uint32_t evaluated;
+
+void setUp() {
+	queue = new LogQueue();
+	evaluated = 0;
+	LogFilter::setEnabled(0xFFFFFFFFu);
+}
+
+void tearDown() {
+	delete queue;
+}
+
+/**
+ * @brief Nachbildung von LLog::emitf(): Präfix aus der Maske, Text direkt in die Zelle.
+ */
+static void emitf(uint32_t cats, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void emitf(uint32_t cats, const char *fmt, ...) {
+	char tags[LogRecord::TAGS];
+	LogFilter::tags(cats, tags, sizeof(tags));
+	va_list args;
+	va_start(args, fmt);
+	queue->pushv(tags, LogFilter::journalBits(cats), LOG_RECORD_NEWLINE, 0, fmt, args);
+	va_end(args);
+}
+
+#define TEST_LOGF(cats, ...) LOG_IF_ENABLED(cats, emitf((cats), __VA_ARGS__))
+
+/// Zählt, wie oft Argumente ausgewertet wurden
+static int countEvaluation() {
+	return (int)++evaluated;
+}
+
+/// Entfernt alle Einträge (Verbraucher)
+static void drainQueue() {
+	const LogRecord *recs[8];
+	size_t n;
+	while ((n = queue->peek(recs, 8)) > 0) queue->release(n);
+}
+
+void test_tags_keep_call_order() {
+	char buf[LogRecord::TAGS];
+	LogFilter::tags(LOG_CAT_WIFI | LOG_CAT_INFO | LOG_CAT_SYSTEM, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("[SYSTEM][INFO][WIFI]", buf);
+	LogFilter::tags(LOG_CAT_SERIAL | LOG_CAT_WARNING | LOG_CAT_DEVICE, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("[SERIAL][WARNING][DEVICE]", buf);
+	LogFilter::tags(LOG_CAT_SYSTEM | LOG_CAT_ERROR | LOG_CAT_FILESYSTEM | LOG_CAT_LLOG, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("[SYSTEM][ERROR][FILESYSTEM][LLOG]", buf);
+	// Zu kleiner Puffer: ganze Kategorien entfallen
+	char small[16];
+	LogFilter::tags(LOG_CAT_SYSTEM | LOG_CAT_INFO | LOG_CAT_WIFI, small, sizeof(small));
+	TEST_ASSERT_EQUAL_STRING("[SYSTEM][INFO]", small);
+}
+
+void test_journal_bits_and_names() {
+	// Wie LLog::categoryBit(): Themen ohne eigene Kategorie zählen zu "general"
+	TEST_ASSERT_EQUAL_UINT16(0x86, LogFilter::journalBits(LOG_CAT_SYSTEM | LOG_CAT_INFO | LOG_CAT_WIFI));
+	TEST_ASSERT_EQUAL_UINT16(0x22, LogFilter::journalBits(LOG_CAT_SOCKET | LOG_CAT_INFO));
+	TEST_ASSERT_EQUAL_UINT32(LOG_CAT_INFO, LogFilter::parse("[INFO]"));
+	TEST_ASSERT_EQUAL_UINT32(LOG_CAT_WIFI, LogFilter::parse("WiFi"));
+	TEST_ASSERT_EQUAL_UINT32(0, LogFilter::parse("unbekannt"));
+	TEST_ASSERT_EQUAL_STRING("filesystem", LogFilter::name(LOG_CAT_FILESYSTEM));
+	TEST_ASSERT_NULL(LogFilter::name(1u << 20));
+}
+
+void test_runtime_filter_skips_arguments() {
+	LogFilter::setEnabled(~(uint32_t)LOG_CAT_SERIAL);
+	TEST_LOGF(LOG_CAT_SERIAL | LOG_CAT_INFO, "%d", countEvaluation());
+	TEST_ASSERT_EQUAL_UINT32(0, evaluated);
+	TEST_ASSERT_EQUAL_size_t(0, queue->pending());
+
+	TEST_LOGF(LOG_CAT_SYSTEM | LOG_CAT_INFO, "Wert %d", countEvaluation());
+	TEST_ASSERT_EQUAL_UINT32(1, evaluated);
+	const LogRecord *recs[1];
+	TEST_ASSERT_EQUAL_size_t(1, queue->peek(recs, 1));
+	TEST_ASSERT_EQUAL_STRING("[SYSTEM][INFO]", recs[0]->tags);
+	TEST_ASSERT_EQUAL_STRING("Wert 1", recs[0]->text);
+	TEST_ASSERT_EQUAL_UINT16(0x06, recs[0]->files);
+}
+
+void test_build_filter_removes_call() {
+	static_assert(!LogBuilt<LOG_CAT_DEBUG | LOG_CAT_SYSTEM>::value, "DEBUG ist nicht übersetzt");
+	static_assert(LogBuilt<LOG_CAT_SYSTEM | LOG_CAT_INFO>::value, "SYSTEM|INFO ist übersetzt");
+	TEST_LOGF(LOG_CAT_DEBUG | LOG_CAT_SYSTEM, "%d", countEvaluation());
+	TEST_ASSERT_EQUAL_UINT32(0, evaluated);
+	TEST_ASSERT_EQUAL_size_t(0, queue->pending());
+}
+
+void test_formatted_text_is_truncated_on_utf8_boundary() {
+	std::string text(LogRecord::TEXT - 6, 'a');
+	text += "\xC3\xA4\xC3\xA4\xC3\xA4";  // äää über die Grenze
+	TEST_LOGF(LOG_CAT_INFO, "%s", text.c_str());
+	const LogRecord *recs[1];
+	TEST_ASSERT_EQUAL_size_t(1, queue->peek(recs, 1));
+	TEST_ASSERT_TRUE(recs[0]->flags & LOG_RECORD_TRUNCATED);
+	size_t len = strlen(recs[0]->text);
+	TEST_ASSERT_EQUAL_STRING("...", recs[0]->text + len - 3);
+	TEST_ASSERT_NOT_EQUAL(0xC3, (uint8_t)recs[0]->text[len - 4]);
+}
+
+/**
+ * @brief Bisheriger Aufruf `logger.log({"system","info","wifi"}, "..." + String(x))`.
+ *
+ * std::string steht für Arduino-String; Vektor und Verkettung allokieren wie dort, auch wenn
+ * die Meldung danach vom Laufzeitfilter verworfen wird.
+ */
+static void logLegacy(const std::vector<std::string> &events, const std::string &message) {
+	uint32_t cats = 0;
+	for (const auto &evt : events) cats |= LogFilter::parse(evt.c_str());
+	if (!LogFilter::enabled(cats)) return;
+	char tags[LogRecord::TAGS];
+	size_t n = 0;
+	for (const auto &evt : events) {
+		if (n + evt.size() + 2 < sizeof(tags)) {
+			tags[n++] = '[';
+			for (char c : evt) tags[n++] = (char)toupper((unsigned char)c);
+			tags[n++] = ']';
+		}
+	}
+	tags[n] = '\0';
+	queue->push(tags, 0x86, LOG_RECORD_NEWLINE, 0, message.c_str(), message.size());
+}
+
+void test_benchmark_allocations_per_call() {
+	const int count = 20000;
+	const std::string ssid = "Werkstatt-Netzwerk";
+	int rssi = -61;
+
+	auto measure = [&](const char *label, bool enabled, void (*call)(const std::string &, int)) {
+		LogFilter::setEnabled(enabled ? 0xFFFFFFFFu : ~(uint32_t)LOG_CAT_WIFI);
+		drainQueue();
+		uint32_t before = allocations.load();
+		auto t0 = std::chrono::steady_clock::now();
+		for (int i = 0; i < count; ++i) {
+			call(ssid, rssi);
+			if ((i & 15) == 15) drainQueue();
+		}
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / count;
+		uint32_t allocated = allocations.load() - before;
+		printf("[log-filter] %-20s %-9s %6.2f Allokationen/Aufruf, %7.1f ns/Aufruf\n", label, enabled ? "an" : "gesperrt", (double)allocated / count, ns);
+		return allocated;
+	};
+
+	auto legacy = [](const std::string &s, int r) {
+		// Bisher: wird immer aufgebaut, das Verwerfen käme erst danach
+		logLegacy({"system", "info", "wifi"}, "Verbunden mit " + s + " (" + std::to_string(r) + " dBm)");
+	};
+	auto front = [](const std::string &s, int r) {
+		TEST_LOGF(LOG_CAT_SYSTEM | LOG_CAT_INFO | LOG_CAT_WIFI, "Verbunden mit %s (%d dBm)", s.c_str(), r);
+	};
+
+	uint32_t legacyOn = measure("log({...}, String)", true, legacy);
+	uint32_t legacyOff = measure("log({...}, String)", false, legacy);
+	uint32_t newOn = measure("LOGF", true, front);
+	uint32_t newOff = measure("LOGF", false, front);
+
+	// Allokationen sind deterministisch, Zeiten nur zur Information
+	TEST_ASSERT_TRUE(legacyOn >= (uint32_t)count);
+	TEST_ASSERT_TRUE(legacyOff >= (uint32_t)count);
+	TEST_ASSERT_EQUAL_UINT32(0, newOn);
+	TEST_ASSERT_EQUAL_UINT32(0, newOff);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_tags_keep_call_order);
+	RUN_TEST(test_journal_bits_and_names);
+	RUN_TEST(test_runtime_filter_skips_arguments);
+	RUN_TEST(test_build_filter_removes_call);
+	RUN_TEST(test_formatted_text_is_truncated_on_utf8_boundary);
+	RUN_TEST(test_benchmark_allocations_per_call);
+	return UNITY_END();
+}
@@ -0,0 +1,66 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für das Zeilenformat des Log-Journals.
+ */
+
+#include <unity.h>
+
+#include <cstring>
+
+#include "LogJournal.h"
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_prefix_roundtrip() {
+	char line[64];
+	size_t n = LogJournal::prefix(0x0006, line);
+	TEST_ASSERT_EQUAL_size_t(LogJournal::PREFIX_LEN, n);
+	TEST_ASSERT_EQUAL_STRING("0006 ", line);
+	strcat(line, "[SYSTEM][INFO][2025-01-01 12:00:00] Start");
+
+	uint16_t files = 0;
+	const char *text = nullptr;
+	TEST_ASSERT_TRUE(LogJournal::parse(line, strlen(line), files, text));
+	TEST_ASSERT_EQUAL_UINT16(0x0006, files);
+	TEST_ASSERT_EQUAL_STRING("[SYSTEM][INFO][2025-01-01 12:00:00] Start", text);
+
+	LogJournal::prefix(0xBEEF, line);
+	TEST_ASSERT_TRUE(LogJournal::parse(line, 5, files, text));
+	TEST_ASSERT_EQUAL_UINT16(0xBEEF, files);
+}
+
+void test_rejects_lines_without_prefix() {
+	uint16_t files = 0x1234;
+	const char *text = nullptr;
+	const char *legacy = "[INFO] [2025-01-01 12:00:00] alt";
+	TEST_ASSERT_FALSE(LogJournal::parse(legacy, strlen(legacy), files, text));
+	TEST_ASSERT_FALSE(LogJournal::parse("00G1 x", 6, files, text));
+	TEST_ASSERT_FALSE(LogJournal::parse("0001", 4, files, text));
+	TEST_ASSERT_FALSE(LogJournal::parse("0001x", 5, files, text));
+	TEST_ASSERT_EQUAL_UINT16(0x1234, files);
+	TEST_ASSERT_TRUE(LogJournal::parse("00ff ", 5, files, text));
+	TEST_ASSERT_EQUAL_UINT16(0x00FF, files);
+}
+
+void test_clear_bits() {
+	char line[] = "0016 [SYSTEM][INFO][WARNING] Text";
+	TEST_ASSERT_TRUE(LogJournal::clearBits(line, strlen(line), 0x0004));
+	TEST_ASSERT_EQUAL_STRING("0012 [SYSTEM][INFO][WARNING] Text", line);
+	TEST_ASSERT_TRUE(LogJournal::clearBits(line, strlen(line), 0x0020));
+	TEST_ASSERT_EQUAL_STRING("0012 [SYSTEM][INFO][WARNING] Text", line);
+	TEST_ASSERT_FALSE(LogJournal::clearBits(line, strlen(line), 0x0012));
+
+	char legacy[] = "[INFO] alt";
+	TEST_ASSERT_FALSE(LogJournal::clearBits(legacy, strlen(legacy), 0x0002));
+	TEST_ASSERT_EQUAL_STRING("[INFO] alt", legacy);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_prefix_roundtrip);
+	RUN_TEST(test_rejects_lines_without_prefix);
+	RUN_TEST(test_clear_bits);
+	return UNITY_END();
+}
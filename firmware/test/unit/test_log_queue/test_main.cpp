@@ -0,0 +1,264 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für die sperrfreie Log-Warteschlange.
+ */
+
+#include <unity.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LogQueue.h"
+
+static LogQueue *queue;
+
+void setUp() {
+	queue = new LogQueue();
+}
+
+void tearDown() {
+	delete queue;
+}
+
+static bool pushText(const char *tags, uint16_t files, uint8_t flags, const char *text) {
+	return queue->push(tags, files, flags, 0, text, strlen(text));
+}
+
+void test_order_and_format() {
+	TEST_ASSERT_TRUE(pushText("[INFO]", 0x02, LOG_RECORD_NEWLINE | LOG_RECORD_TIMESTAMP | LOG_RECORD_SPACED, "eins"));
+	TEST_ASSERT_TRUE(queue->push("[SYSTEM][INFO]", 0x06, LOG_RECORD_NEWLINE | LOG_RECORD_TIMESTAMP, 86400 + 3661, "zwei", 4));
+	TEST_ASSERT_TRUE(pushText("[ERROR]", 0x10, LOG_RECORD_NEWLINE | LOG_RECORD_SPACED, "drei"));
+	TEST_ASSERT_EQUAL_size_t(3, queue->pending());
+
+	const LogRecord *recs[8];
+	TEST_ASSERT_EQUAL_size_t(3, queue->peek(recs, 8));
+	char line[LogQueue::LINE_BYTES];
+	LogQueue::format(*recs[0], line, sizeof(line));
+	TEST_ASSERT_EQUAL_STRING("[INFO] [1970-01-01 00:00:00] eins", line);
+	LogQueue::format(*recs[1], line, sizeof(line));
+	TEST_ASSERT_EQUAL_STRING("[SYSTEM][INFO][1970-01-02 01:01:01] zwei", line);
+	TEST_ASSERT_EQUAL_UINT16(0x06, recs[1]->files);
+	LogQueue::format(*recs[2], line, sizeof(line));
+	TEST_ASSERT_EQUAL_STRING("[ERROR] drei", line);
+
+	// Teilweise entfernen; der Rest bleibt vorne
+	queue->release(2);
+	TEST_ASSERT_EQUAL_size_t(1, queue->peek(recs, 8));
+	TEST_ASSERT_EQUAL_STRING("drei", recs[0]->text);
+	queue->release(1);
+	TEST_ASSERT_EQUAL_size_t(0, queue->peek(recs, 8));
+	TEST_ASSERT_EQUAL_size_t(0, queue->pending());
+}
+
+void test_full_ring_drops_without_blocking() {
+	for (size_t i = 0; i < LogQueue::SLOTS; ++i) TEST_ASSERT_TRUE(pushText("[DEBUG]", 1, 0, "x"));
+	TEST_ASSERT_FALSE(pushText("[DEBUG]", 1, 0, "zu viel"));
+	TEST_ASSERT_FALSE(pushText("[DEBUG]", 1, 0, "zu viel"));
+	LogQueueStats st = queue->stats();
+	TEST_ASSERT_EQUAL_UINT32(LogQueue::SLOTS, st.enqueued);
+	TEST_ASSERT_EQUAL_UINT32(2, st.dropped);
+	TEST_ASSERT_EQUAL_UINT32(LogQueue::SLOTS, st.highWater);
+
+	// Nach dem Entfernen ist wieder Platz, auch über den Umlauf hinweg
+	const LogRecord *recs[LogQueue::SLOTS];
+	queue->release(queue->peek(recs, 4));
+	for (int i = 0; i < 4; ++i) TEST_ASSERT_TRUE(pushText("[DEBUG]", 1, 0, "y"));
+	TEST_ASSERT_FALSE(pushText("[DEBUG]", 1, 0, "z"));
+	TEST_ASSERT_EQUAL_size_t(LogQueue::SLOTS, queue->peek(recs, LogQueue::SLOTS));
+	TEST_ASSERT_EQUAL_STRING("y", recs[LogQueue::SLOTS - 1]->text);
+}
+
+void test_peek_stops_at_uncommitted() {
+	uint32_t first, second;
+	LogRecord *a = queue->reserve(first);
+	LogRecord *b = queue->reserve(second);
+	TEST_ASSERT_NOT_NULL(a);
+	TEST_ASSERT_NOT_NULL(b);
+	snprintf(b->text, sizeof(b->text), "zweiter");
+	queue->commit(second);
+	const LogRecord *recs[4];
+	// Der erste Erzeuger schreibt noch: nichts ausliefern, Reihenfolge bleibt erhalten
+	TEST_ASSERT_EQUAL_size_t(0, queue->peek(recs, 4));
+	snprintf(a->text, sizeof(a->text), "erster");
+	queue->commit(first);
+	TEST_ASSERT_EQUAL_size_t(2, queue->peek(recs, 4));
+	TEST_ASSERT_EQUAL_STRING("erster", recs[0]->text);
+	TEST_ASSERT_EQUAL_STRING("zweiter", recs[1]->text);
+}
+
+void test_truncate_on_utf8_boundary() {
+	std::string text(LogRecord::TEXT - 5, 'a');
+	text += "äöü und mehr";
+	TEST_ASSERT_TRUE(queue->push("[INFO]", 2, 0, 0, text.c_str(), text.size()));
+	const LogRecord *rec;
+	TEST_ASSERT_EQUAL_size_t(1, queue->peek(&rec, 1));
+	TEST_ASSERT_TRUE(rec->flags & LOG_RECORD_TRUNCATED);
+	size_t len = strlen(rec->text);
+	TEST_ASSERT_TRUE(len < LogRecord::TEXT);
+	TEST_ASSERT_EQUAL_STRING("...", rec->text + len - 3);
+	// "ä" (2 Bytes) passt nur halb: es fällt ganz weg
+	TEST_ASSERT_EQUAL_size_t(LogRecord::TEXT - 5, len - 3);
+
+	char tags[64];
+	memset(tags, 'T', sizeof(tags));
+	tags[sizeof(tags) - 1] = '\0';
+	queue->release(1);
+	TEST_ASSERT_TRUE(queue->push(tags, 2, 0, 0, "x", 1));
+	TEST_ASSERT_EQUAL_size_t(1, queue->peek(&rec, 1));
+	TEST_ASSERT_EQUAL_size_t(LogRecord::TAGS - 1, strlen(rec->tags));
+}
+
+void test_concurrent_producers() {
+	const int producers = 4;
+	const int perProducer = 20000;
+	std::atomic<bool> done(false);
+	std::vector<int> last(producers, -1);
+	uint32_t received = 0;
+	bool ordered = true;
+
+	std::thread consumer([&]() {
+		const LogRecord *recs[8];
+		for (;;) {
+			size_t n = queue->peek(recs, 8);
+			for (size_t i = 0; i < n; ++i) {
+				int p, seq;
+				if (sscanf(recs[i]->text, "p%d %d", &p, &seq) != 2 || p < 0 || p >= producers || seq <= last[p]) ordered = false;
+				if (p >= 0 && p < producers) last[p] = seq;
+				received++;
+			}
+			queue->release(n);
+			if (n == 0) {
+				if (done.load() && queue->pending() == 0) break;
+				std::this_thread::yield();
+			}
+		}
+	});
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; ++p) {
+		threads.emplace_back([p]() {
+			char text[32];
+			for (int i = 0; i < perProducer; ++i) {
+				int len = snprintf(text, sizeof(text), "p%d %d", p, i);
+				// Voller Ring: erneut versuchen, damit jede Meldung ankommt (verworfene Versuche zählen mit)
+				while (!queue->push("[DEBUG]", 1, 0, 0, text, (size_t)len)) std::this_thread::yield();
+			}
+		});
+	}
+	for (auto &t : threads) t.join();
+	done.store(true);
+	consumer.join();
+
+	LogQueueStats st = queue->stats();
+	TEST_ASSERT_TRUE(ordered);
+	TEST_ASSERT_EQUAL_UINT32((uint32_t)(producers * perProducer), received);
+	TEST_ASSERT_EQUAL_UINT32(received, st.enqueued);
+	printf("[log-queue] %d producers: %u delivered, %u full retries, high water %u/%u\n", producers, (unsigned)received, (unsigned)st.dropped, (unsigned)st.highWater,
+	       (unsigned)LogQueue::SLOTS);
+}
+
+/**
+ * @brief Bisheriger Weg im Aufrufer: Zeile zusammensetzen, Zeitstempel formatieren, Konsole
+ *        und je Kategorie eine Datei öffnen, anhängen, schließen.
+ */
+static void logSync(const std::vector<std::string> &files, FILE *console, const std::string &message) {
+	char ts[20];
+	time_t now = time(nullptr);
+	struct tm tm;
+	localtime_r(&now, &tm);
+	strftime(ts, sizeof(ts), "%Y-%m-%d %H:%M:%S", &tm);
+	std::string entry = "[SYSTEM][INFO][" + std::string(ts) + "] " + message;
+	fputs(entry.c_str(), console);
+	fputc('\n', console);
+	fflush(console);
+	for (const auto &path : files) {
+		FILE *f = fopen(path.c_str(), "a");
+		if (!f) continue;
+		fputs(entry.c_str(), f);
+		fputc('\n', f);
+		fclose(f);
+	}
+}
+
+void test_benchmark_caller_latency() {
+	const int count = 5000;
+	std::vector<std::string> files = {"/tmp/llog_bench_system.log", "/tmp/llog_bench_info.log", "/tmp/llog_bench_general.log"};
+	for (const auto &f : files) remove(f.c_str());
+	FILE *console = fopen("/dev/null", "w");
+	TEST_ASSERT_NOT_NULL(console);
+	std::string message = "Kanal 0 gestartet auf RX=16, TX=17, 9600 Baud";
+
+	auto percentile = [](std::vector<double> &v, double q) {
+		std::sort(v.begin(), v.end());
+		return v[(size_t)(q * (v.size() - 1))];
+	};
+
+	std::vector<double> before(count);
+	for (int i = 0; i < count; ++i) {
+		auto t0 = std::chrono::steady_clock::now();
+		logSync(files, console, message);
+		before[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+	}
+
+	// Neuer Weg: nur einreihen; eine Schreib-Task formatiert und schreibt gebündelt
+	std::atomic<bool> done(false);
+	std::thread writer([&]() {
+		const LogRecord *recs[8];
+		char line[LogQueue::LINE_BYTES];
+		for (;;) {
+			size_t n = queue->peek(recs, 8);
+			if (n > 0) {
+				FILE *f = fopen(files[0].c_str(), "a");
+				for (size_t i = 0; i < n; ++i) {
+					LogQueue::format(*recs[i], line, sizeof(line));
+					fputs(line, console);
+					if (f) fputs(line, f);
+				}
+				if (f) fclose(f);
+				queue->release(n);
+			} else if (done.load()) {
+				break;
+			} else {
+				std::this_thread::sleep_for(std::chrono::microseconds(200));
+			}
+		}
+	});
+	std::vector<double> after(count);
+	for (int i = 0; i < count; ++i) {
+		auto t0 = std::chrono::steady_clock::now();
+		queue->push("[SYSTEM][INFO]", 0x06, LOG_RECORD_NEWLINE | LOG_RECORD_TIMESTAMP, (uint32_t)time(nullptr), message.c_str(), message.size());
+		after[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+		if (i % 16 == 15) std::this_thread::sleep_for(std::chrono::microseconds(50));
+	}
+	done.store(true);
+	writer.join();
+	fclose(console);
+	for (const auto &f : files) remove(f.c_str());
+
+	LogQueueStats st = queue->stats();
+	TEST_ASSERT_EQUAL_UINT32(count, st.enqueued + st.dropped);
+	double b50 = percentile(before, 0.5), b99 = percentile(before, 0.99);
+	double a50 = percentile(after, 0.5), a99 = percentile(after, 0.99);
+	printf("[log-queue] caller latency sync: p50 %8.0f ns, p99 %8.0f ns | queued: p50 %6.0f ns, p99 %6.0f ns (%u dropped)\n", b50, b99, a50, a99,
+	       (unsigned)st.dropped);
+}
+
+int main() {
+	setenv("TZ", "UTC", 1);
+	tzset();
+	UNITY_BEGIN();
+	RUN_TEST(test_order_and_format);
+	RUN_TEST(test_full_ring_drops_without_blocking);
+	RUN_TEST(test_peek_stops_at_uncommitted);
+	RUN_TEST(test_truncate_on_utf8_boundary);
+	RUN_TEST(test_concurrent_producers);
+	RUN_TEST(test_benchmark_caller_latency);
+	return UNITY_END();
+}
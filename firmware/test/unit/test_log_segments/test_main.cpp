@@ -0,0 +1,117 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für die Rotationsregeln des Log-Journals.
+ */
+
+#include <unity.h>
+
+#include "LogSegments.h"
+
+static const LogRotationConfig CONFIG = {8192, 4, 64 * 1024};
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_first_write_creates_segment_zero() {
+	LogSegments seg(CONFIG);
+	TEST_ASSERT_EQUAL_size_t(0, seg.count());
+	TEST_ASSERT_FALSE(seg.needsRotation(100));
+	TEST_ASSERT_EQUAL_UINT32(0, seg.active());
+	seg.appended(100);
+	TEST_ASSERT_EQUAL_size_t(1, seg.count());
+	TEST_ASSERT_EQUAL_UINT32(100, seg.journalBytes());
+}
+
+void test_rotates_on_cached_size() {
+	LogSegments seg(CONFIG);
+	seg.appended(8000);
+	TEST_ASSERT_FALSE(seg.needsRotation(192));
+	TEST_ASSERT_TRUE(seg.needsRotation(193));
+	TEST_ASSERT_EQUAL_UINT32(1, seg.rotate());
+	TEST_ASSERT_EQUAL_UINT32(1, seg.active());
+	// Ein leeres Segment nimmt auch einen übergroßen Block auf
+	TEST_ASSERT_FALSE(seg.needsRotation(20000));
+	seg.appended(20000);
+	TEST_ASSERT_TRUE(seg.needsRotation(1));
+}
+
+void test_count_limit_drops_oldest() {
+	LogSegments seg(CONFIG);
+	for (int i = 0; i < 5; ++i) {
+		seg.appended(1000);
+		seg.rotate();
+	}
+	TEST_ASSERT_EQUAL_size_t(6, seg.count());
+	uint32_t seq;
+	TEST_ASSERT_TRUE(seg.overLimit(seq));
+	TEST_ASSERT_EQUAL_UINT32(0, seq);
+	seg.dropOldest();
+	TEST_ASSERT_TRUE(seg.overLimit(seq));
+	TEST_ASSERT_EQUAL_UINT32(1, seq);
+	seg.dropOldest();
+	TEST_ASSERT_FALSE(seg.overLimit(seq));
+	TEST_ASSERT_EQUAL_UINT32(2, seg.seqAt(0));
+	TEST_ASSERT_EQUAL_UINT32(5, seg.active());
+}
+
+void test_budget_counts_device_logs_and_keeps_active() {
+	LogSegments seg(CONFIG);
+	seg.add(7, 8000);
+	seg.add(3, 8000);
+	seg.add(5, 8000);
+	TEST_ASSERT_EQUAL_UINT32(3, seg.seqAt(0));
+	TEST_ASSERT_EQUAL_UINT32(7, seg.active());
+	uint32_t seq;
+	TEST_ASSERT_FALSE(seg.overLimit(seq));
+
+	seg.setExternalBytes(50 * 1024);
+	TEST_ASSERT_TRUE(seg.overLimit(seq));
+	TEST_ASSERT_EQUAL_UINT32(3, seq);
+	seg.dropOldest();
+	TEST_ASSERT_TRUE(seg.overLimit(seq));
+	TEST_ASSERT_EQUAL_UINT32(5, seq);
+	seg.dropOldest();
+
+	// Das aktuelle Segment bleibt, auch wenn das Budget weiter überschritten ist
+	seg.setExternalBytes(100 * 1024);
+	TEST_ASSERT_FALSE(seg.overLimit(seq));
+	TEST_ASSERT_EQUAL_size_t(1, seg.count());
+}
+
+void test_resize_and_configure_bounds() {
+	LogSegments seg({100, 0, 1000});
+	LogRotationConfig cfg = seg.config();
+	TEST_ASSERT_EQUAL_UINT32(LogSegments::MIN_SEGMENT_BYTES, cfg.segmentBytes);
+	TEST_ASSERT_EQUAL_UINT16(1, cfg.segments);
+
+	seg.configure(CONFIG);
+	seg.add(1, 5000);
+	seg.add(2, 3000);
+	seg.resize(1, 200);
+	TEST_ASSERT_EQUAL_UINT32(200, seg.bytesAt(0));
+	TEST_ASSERT_EQUAL_UINT32(3200, seg.journalBytes());
+}
+
+void test_scan_keeps_newest_when_full() {
+	LogSegments seg(CONFIG);
+	for (uint32_t i = 0; i <= LogSegments::MAX_SEGMENTS; ++i) TEST_ASSERT_TRUE(seg.add(100 + i, 10));
+	TEST_ASSERT_EQUAL_size_t(LogSegments::MAX_SEGMENTS + 1, seg.count());
+	// Älter als alle bekannten: abgelehnt
+	TEST_ASSERT_FALSE(seg.add(50, 10));
+	// Jünger: das älteste weicht
+	TEST_ASSERT_TRUE(seg.add(500, 10));
+	TEST_ASSERT_EQUAL_UINT32(101, seg.seqAt(0));
+	TEST_ASSERT_EQUAL_UINT32(500, seg.active());
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_first_write_creates_segment_zero);
+	RUN_TEST(test_rotates_on_cached_size);
+	RUN_TEST(test_count_limit_drops_oldest);
+	RUN_TEST(test_budget_counts_device_logs_and_keeps_active);
+	RUN_TEST(test_resize_and_configure_bounds);
+	RUN_TEST(test_scan_keeps_newest_when_full);
+	return UNITY_END();
+}
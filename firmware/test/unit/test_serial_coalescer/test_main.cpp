@@ -0,0 +1,133 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für das adaptive Bündeln serieller Zeilen (SerialCoalescer).
+ */
+
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "SerialCoalescer.h"
+
+struct Frame {
+	uint32_t at;
+	std::string data;
+	uint16_t lines;
+	uint64_t rxUs;
+};
+
+struct Recorder {
+	std::vector<Frame> frames;
+	uint32_t now = 0;
+	static void sink(void *ctx, const uint8_t *data, size_t len, uint16_t lines, uint16_t, uint64_t rxUs) {
+		auto *r = static_cast<Recorder *>(ctx);
+		r->frames.push_back({r->now, std::string((const char *)data, len), lines, rxUs});
+	}
+};
+
+static void addLine(SerialCoalescer &co, Recorder &rec, const char *line) {
+	co.add((const uint8_t *)line, strlen(line), 0, rec.now, (uint64_t)rec.now * 1000 + 7);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_light_traffic_is_sent_immediately() {
+	Recorder rec;
+	SerialCoalescer co(Recorder::sink, &rec);
+	for (int i = 0; i < 5; ++i) {
+		rec.now = i * 100;
+		addLine(co, rec, "OK\r\n");
+		TEST_ASSERT_EQUAL(i + 1, rec.frames.size());
+		TEST_ASSERT_EQUAL(rec.now, rec.frames.back().at);
+	}
+	TEST_ASSERT_EQUAL(5, co.stats().immediate);
+	TEST_ASSERT_EQUAL(UINT32_MAX, co.msUntilDue(rec.now));
+}
+
+void test_burst_is_bundled_within_latency_budget() {
+	Recorder rec;
+	SerialCoalescer co(Recorder::sink, &rec);
+	co.configure(20, 1024);
+	// eine Zeile pro Millisekunde über 1 s
+	for (rec.now = 0; rec.now < 1000; ++rec.now) {
+		co.poll(rec.now);
+		addLine(co, rec, "[0001.002] HT  zone1 pv=24.9\r\n");
+	}
+	co.flush(rec.now);
+
+	size_t lines = 0;
+	uint32_t prev = 0;
+	for (size_t i = 0; i < rec.frames.size(); ++i) {
+		// Zeitstempel einer Nachricht = Empfangszeit ihrer ersten Zeile (Zeile n kam bei n ms)
+		TEST_ASSERT_TRUE(rec.frames[i].rxUs == (uint64_t)lines * 1000 + 7);
+		lines += rec.frames[i].lines;
+		if (i > 0) TEST_ASSERT_TRUE(rec.frames[i].at - prev <= 20);
+		prev = rec.frames[i].at;
+	}
+	TEST_ASSERT_EQUAL(1000, lines);
+	TEST_ASSERT_TRUE(rec.frames.size() <= 1000 / 20 + 2);
+	TEST_ASSERT_EQUAL(20, co.stats().maxLinesPerFrame);
+}
+
+void test_max_frame_size_is_respected() {
+	Recorder rec;
+	SerialCoalescer co(Recorder::sink, &rec);
+	co.configure(1000, 100);
+	addLine(co, rec, "first\r\n");
+	for (int i = 0; i < 50; ++i) addLine(co, rec, "0123456789\r\n");
+	co.flush(rec.now);
+	for (const auto &f : rec.frames) TEST_ASSERT_TRUE(f.data.size() <= 100);
+	TEST_ASSERT_EQUAL(1 + 50, co.stats().lines);
+	TEST_ASSERT_EQUAL(7 + 50 * 12, co.stats().bytes);
+}
+
+void test_zero_latency_never_bundles() {
+	Recorder rec;
+	SerialCoalescer co(Recorder::sink, &rec);
+	co.configure(0, 1024);
+	for (int i = 0; i < 10; ++i) addLine(co, rec, "x\n");
+	TEST_ASSERT_EQUAL(10, rec.frames.size());
+}
+
+void test_latency_is_capped() {
+	Recorder rec;
+	SerialCoalescer co(Recorder::sink, &rec);
+	co.configure(60000, 1024);
+	addLine(co, rec, "a\n");
+	addLine(co, rec, "b\n");
+	// Gesammelte Zeilen warten höchstens MAX_LATENCY_MS
+	TEST_ASSERT_TRUE(co.msUntilDue(rec.now) <= SerialCoalescer::MAX_LATENCY_MS);
+	rec.now = SerialCoalescer::MAX_LATENCY_MS;
+	co.poll(rec.now);
+	TEST_ASSERT_EQUAL(UINT32_MAX, co.msUntilDue(rec.now));
+}
+
+void test_rates_are_measured_per_window() {
+	Recorder rec;
+	SerialCoalescer co(Recorder::sink, &rec);
+	co.configure(10, 1024);
+	for (rec.now = 0; rec.now < SerialCoalescer::RATE_WINDOW_MS; ++rec.now) {
+		co.poll(rec.now);
+		addLine(co, rec, "ACK\n");
+	}
+	co.poll(rec.now);
+	TEST_ASSERT_FLOAT_WITHIN(5.0f, 100.0f, co.stats().framesPerSec);
+	TEST_ASSERT_FLOAT_WITHIN(1.0f, 10.0f, co.stats().linesPerFrame);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_light_traffic_is_sent_immediately);
+	RUN_TEST(test_burst_is_bundled_within_latency_budget);
+	RUN_TEST(test_max_frame_size_is_respected);
+	RUN_TEST(test_zero_latency_never_bundles);
+	RUN_TEST(test_latency_is_capped);
+	RUN_TEST(test_rates_are_measured_per_window);
+	return UNITY_END();
+}
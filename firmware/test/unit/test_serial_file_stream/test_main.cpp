@@ -0,0 +1,232 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für die zeilenweise Dateiübertragung zur UART.
+ */
+
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "SerialFileStream.h"
+
+/// Mitgeschnittene Übergaben an die Sendewarteschlange
+struct Sink {
+	std::string data;
+	size_t calls = 0;
+	bool full = false;
+};
+
+static bool sinkSend(void *ctx, const uint8_t *data, size_t len) {
+	auto *sink = static_cast<Sink *>(ctx);
+	if (sink->full) return false;
+	sink->data.append((const char *)data, len);
+	sink->calls++;
+	return true;
+}
+
+static SerialFileStreamConfig makeConfig(uint32_t lineDelayMs = 0, const char *prompt = "", bool crlf = true) {
+	SerialFileStreamConfig cfg;
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.lineDelayMs = lineDelayMs;
+	snprintf(cfg.prompt, sizeof(cfg.prompt), "%s", prompt);
+	cfg.promptTimeoutMs = SerialFileStream::DEFAULT_PROMPT_TIMEOUT_MS;
+	cfg.crlf = crlf;
+	return cfg;
+}
+
+static size_t offerText(SerialFileStream &s, const char *text) {
+	return s.offer((const uint8_t *)text, strlen(text));
+}
+
+/**
+ * @brief Ruft poll() auf, bis gewartet werden muss.
+ */
+static uint32_t pump(SerialFileStream &s, uint32_t now) {
+	uint32_t wait;
+	while ((wait = s.poll(now)) == 0) {
+	}
+	return wait;
+}
+
+static uint8_t mem[SerialFileStream::MEMORY_BYTES];
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_lines_and_crlf() {
+	Sink sink;
+	SerialFileStream s(sinkSend, &sink);
+	TEST_ASSERT_TRUE(s.begin(makeConfig(), mem, 0));
+	TEST_ASSERT_FALSE(s.begin(makeConfig(), mem, 0));
+	offerText(s, "set a=1\nset b=2\r\n\nend");
+	TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, pump(s, 0));
+	TEST_ASSERT_EQUAL(FILE_STREAM_RUNNING, s.state());
+	s.endInput();
+	TEST_ASSERT_EQUAL_UINT32(0, offerText(s, "x"));
+	pump(s, 5);
+	TEST_ASSERT_EQUAL(FILE_STREAM_DONE, s.state());
+	TEST_ASSERT_EQUAL_STRING("set a=1\r\nset b=2\r\n\r\nend", sink.data.c_str());
+	TEST_ASSERT_EQUAL_size_t(4, sink.calls);
+
+	SerialFileStreamStats st = s.close(5);
+	TEST_ASSERT_EQUAL_UINT32(21, st.received);
+	TEST_ASSERT_EQUAL_UINT32(23, st.sent);
+	TEST_ASSERT_EQUAL_UINT32(3, st.lines);
+	TEST_ASSERT_EQUAL_UINT32(5, st.elapsedMs);
+	TEST_ASSERT_EQUAL(FILE_STREAM_IDLE, s.state());
+
+	// Ohne crlf bleibt die Datei unverändert
+	sink = Sink();
+	TEST_ASSERT_TRUE(s.begin(makeConfig(0, "", false), mem, 0));
+	offerText(s, "a\nb\n");
+	s.endInput();
+	pump(s, 0);
+	TEST_ASSERT_EQUAL_STRING("a\nb\n", sink.data.c_str());
+}
+
+void test_line_delay_after_transmission() {
+	Sink sink;
+	SerialFileStream s(sinkSend, &sink);
+	TEST_ASSERT_TRUE(s.begin(makeConfig(50), mem, 0));
+	offerText(s, "one\ntwo\n");
+	s.endInput();
+
+	TEST_ASSERT_EQUAL_UINT32(0, s.poll(0));
+	// Die Pause beginnt erst beim nächsten Aufruf, also nach dem Senden der Zeile
+	TEST_ASSERT_EQUAL_UINT32(50, s.poll(20));
+	TEST_ASSERT_EQUAL_UINT32(10, s.poll(60));
+	TEST_ASSERT_EQUAL_STRING("one\r\n", sink.data.c_str());
+	TEST_ASSERT_EQUAL_UINT32(0, s.poll(70));
+	TEST_ASSERT_EQUAL_STRING("one\r\ntwo\r\n", sink.data.c_str());
+	// Auch nach der letzten Zeile wird die Pause eingehalten
+	TEST_ASSERT_EQUAL_UINT32(50, s.poll(70));
+	TEST_ASSERT_EQUAL(FILE_STREAM_RUNNING, s.state());
+	TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, s.poll(120));
+	TEST_ASSERT_EQUAL(FILE_STREAM_DONE, s.state());
+}
+
+void test_prompt_wait_and_timeout() {
+	Sink sink;
+	SerialFileStream s(sinkSend, &sink);
+	SerialFileStreamConfig cfg = makeConfig(0, "ok> ");
+	cfg.promptTimeoutMs = 500;
+	TEST_ASSERT_TRUE(s.begin(cfg, mem, 0));
+	offerText(s, "a\nb\nc\n");
+	s.endInput();
+
+	TEST_ASSERT_EQUAL_UINT32(0, s.poll(0));
+	TEST_ASSERT_EQUAL_UINT32(500, s.poll(0));
+	// Echo und Prompt über mehrere Blöcke; "ok" allein reicht nicht
+	TEST_ASSERT_FALSE(s.onRx((const uint8_t *)"a\r\nok", 5));
+	TEST_ASSERT_EQUAL_UINT32(400, s.poll(100));
+	TEST_ASSERT_TRUE(s.onRx((const uint8_t *)"> ", 2));
+	TEST_ASSERT_EQUAL_UINT32(0, s.poll(120));
+	TEST_ASSERT_EQUAL_STRING("a\r\nb\r\n", sink.data.c_str());
+
+	// Prompt kommt schon, während die Zeile noch gesendet wird
+	TEST_ASSERT_TRUE(s.onRx((const uint8_t *)"ok> ", 4));
+	TEST_ASSERT_EQUAL_UINT32(0, s.poll(130));
+
+	// Kein Prompt nach der dritten Zeile
+	TEST_ASSERT_EQUAL_UINT32(500, s.poll(140));
+	TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, s.poll(640));
+	TEST_ASSERT_EQUAL(FILE_STREAM_FAILED, s.state());
+	SerialFileStreamStats st = s.close(700);
+	TEST_ASSERT_EQUAL(FILE_STREAM_PROMPT_TIMEOUT, st.error);
+	TEST_ASSERT_EQUAL_UINT32(2, st.prompts);
+	TEST_ASSERT_EQUAL_UINT32(3, st.lines);
+	TEST_ASSERT_EQUAL_UINT32(640, st.elapsedMs);
+	TEST_ASSERT_EQUAL_STRING("Prompt nicht erhalten", SerialFileStream::errorText(st.error));
+}
+
+void test_prompt_overlap_across_chunks() {
+	Sink sink;
+	SerialFileStream s(sinkSend, &sink);
+	TEST_ASSERT_TRUE(s.begin(makeConfig(0, "aab"), mem, 0));
+	offerText(s, "x\n");
+	TEST_ASSERT_EQUAL_UINT32(0, s.poll(0));
+	// "aaab": nach dem dritten 'a' muss der Abgleich bei "aa" weitermachen
+	TEST_ASSERT_FALSE(s.onRx((const uint8_t *)"a", 1));
+	TEST_ASSERT_FALSE(s.onRx((const uint8_t *)"aa", 2));
+	TEST_ASSERT_TRUE(s.onRx((const uint8_t *)"b", 1));
+	s.endInput();
+	pump(s, 1);
+	TEST_ASSERT_EQUAL(FILE_STREAM_DONE, s.state());
+	TEST_ASSERT_EQUAL_UINT32(1, s.close(1).prompts);
+}
+
+void test_constant_memory_backpressure() {
+	// 100 KB mit langen und kurzen Zeilen durch den 4-KB-Puffer
+	std::string file;
+	for (int i = 0; file.size() < 100000; ++i) {
+		file += "line " + std::to_string(i) + " ";
+		file.append((size_t)(i * 37) % 700, (char)('a' + i % 26));
+		file += "\n";
+	}
+	Sink sink;
+	SerialFileStream s(sinkSend, &sink);
+	TEST_ASSERT_TRUE(s.begin(makeConfig(0, "", false), mem, 0));
+	size_t pos = 0, stalls = 0;
+	uint32_t now = 0;
+	while (pos < file.size()) {
+		size_t n = s.offer((const uint8_t *)file.data() + pos, file.size() - pos < 1460 ? file.size() - pos : 1460);
+		if (n == 0) {
+			stalls++;
+			// Sendewarteschlange zeitweise voll: nichts geht verloren
+			sink.full = stalls % 3 == 0;
+			TEST_ASSERT_NOT_EQUAL(0, pump(s, ++now));
+			sink.full = false;
+		}
+		pos += n;
+	}
+	s.endInput();
+	pump(s, ++now);
+	TEST_ASSERT_EQUAL(FILE_STREAM_DONE, s.state());
+	TEST_ASSERT_TRUE(sink.data == file);
+	SerialFileStreamStats st = s.close(now);
+	TEST_ASSERT_TRUE(stalls > 0);
+	TEST_ASSERT_TRUE(st.maxBuffered <= SerialFileStream::BUFFER_BYTES);
+	TEST_ASSERT_EQUAL_UINT32(file.size(), st.received);
+	printf("[file-stream] %u bytes, %u lines, %u calls, %u stalls, max %u buffered\n", (unsigned)st.received, (unsigned)st.lines, (unsigned)sink.calls,
+	       (unsigned)stalls, (unsigned)st.maxBuffered);
+}
+
+void test_cancel_and_validate() {
+	Sink sink;
+	SerialFileStream s(sinkSend, &sink);
+	TEST_ASSERT_TRUE(s.begin(makeConfig(), mem, 0));
+	offerText(s, "a\nb\n");
+	s.cancel();
+	TEST_ASSERT_EQUAL_UINT32(0, offerText(s, "c\n"));
+	TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, s.poll(3));
+	TEST_ASSERT_EQUAL(FILE_STREAM_FAILED, s.state());
+	TEST_ASSERT_EQUAL_size_t(0, sink.calls);
+	TEST_ASSERT_EQUAL(FILE_STREAM_CANCELLED, s.close(3).error);
+
+	SerialFileStreamConfig cfg = makeConfig(SerialFileStream::MAX_LINE_DELAY_MS + 1);
+	TEST_ASSERT_FALSE(SerialFileStream::validate(cfg));
+	cfg = makeConfig(0, "> ");
+	cfg.promptTimeoutMs = 0;
+	TEST_ASSERT_FALSE(SerialFileStream::validate(cfg));
+	cfg.promptTimeoutMs = SerialFileStream::MAX_PROMPT_TIMEOUT_MS;
+	TEST_ASSERT_TRUE(SerialFileStream::validate(cfg));
+	memset(cfg.prompt, 'x', sizeof(cfg.prompt));
+	TEST_ASSERT_FALSE(SerialFileStream::validate(cfg));
+	TEST_ASSERT_FALSE(s.begin(cfg, mem, 0));
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_lines_and_crlf);
+	RUN_TEST(test_line_delay_after_transmission);
+	RUN_TEST(test_prompt_wait_and_timeout);
+	RUN_TEST(test_prompt_overlap_across_chunks);
+	RUN_TEST(test_constant_memory_backpressure);
+	RUN_TEST(test_cancel_and_validate);
+	return UNITY_END();
+}
@@ -0,0 +1,170 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für den Aho-Corasick-Automaten und die Zeilenfilter pro Client.
+ */
+
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+
+#include "SerialLineFilter.h"
+#include "SerialMultiMatch.h"
+
+static int addText(SerialMultiMatch &m, const char *text, bool prefix = false, bool ignoreCase = false) {
+	return m.add((const uint8_t *)text, strlen(text), prefix, ignoreCase);
+}
+
+static uint64_t scanText(const SerialMultiMatch &m, const char *text, uint64_t stopMask = 0) {
+	return m.scan((const uint8_t *)text, strlen(text), stopMask);
+}
+
+static SerialFilterRule rule(SerialFilterKind kind, const char *text, bool exclude = false, bool ignoreCase = false) {
+	SerialFilterRule r;
+	memset(&r, 0, sizeof(r));
+	r.kind = kind;
+	r.exclude = exclude;
+	r.ignoreCase = ignoreCase;
+	strncpy(r.text, text, sizeof(r.text) - 1);
+	return r;
+}
+
+static uint32_t evalText(const SerialLineFilter &f, const char *line) {
+	return f.evaluate((const uint8_t *)line, strlen(line));
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_multimatch_overlapping_patterns() {
+	SerialMultiMatch m;
+	int he = addText(m, "he");
+	int she = addText(m, "she");
+	int his = addText(m, "his");
+	int hers = addText(m, "hers");
+	m.build();
+	uint64_t hits = scanText(m, "ushers");
+	TEST_ASSERT_TRUE(hits & (1ULL << he));
+	TEST_ASSERT_TRUE(hits & (1ULL << she));
+	TEST_ASSERT_TRUE(hits & (1ULL << hers));
+	TEST_ASSERT_FALSE(hits & (1ULL << his));
+	TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)scanText(m, "xyz"));
+}
+
+void test_multimatch_prefix_case_and_dedupe() {
+	SerialMultiMatch m;
+	int pre = addText(m, "ERR", true);
+	int any = addText(m, "ERR");
+	int fold = addText(m, "warn", false, true);
+	TEST_ASSERT_EQUAL(any, addText(m, "ERR"));
+	TEST_ASSERT_EQUAL(pre, addText(m, "ERR", true));
+	TEST_ASSERT_NOT_EQUAL(pre, any);
+	m.build();
+
+	uint64_t hits = scanText(m, "ERR 42");
+	TEST_ASSERT_TRUE(hits & (1ULL << pre));
+	TEST_ASSERT_TRUE(hits & (1ULL << any));
+	hits = scanText(m, "x ERR 42");
+	TEST_ASSERT_FALSE(hits & (1ULL << pre));
+	TEST_ASSERT_TRUE(hits & (1ULL << any));
+	TEST_ASSERT_TRUE(scanText(m, "** WARNING **") & (1ULL << fold));
+	TEST_ASSERT_FALSE(scanText(m, "err") & (1ULL << any));
+
+	// Vorzeitiges Ende ändert das Ergebnis für die gesuchten Muster nicht
+	TEST_ASSERT_TRUE(scanText(m, "ERR ERR ERR", 1ULL << any) & (1ULL << any));
+}
+
+void test_multimatch_capacity() {
+	SerialMultiMatch m;
+	char text[8];
+	for (size_t i = 0; i < SerialMultiMatch::MAX_PATTERNS; ++i) {
+		snprintf(text, sizeof(text), "p%02u", (unsigned)i);
+		TEST_ASSERT_EQUAL((int)i, addText(m, text));
+	}
+	TEST_ASSERT_EQUAL(SerialMultiMatch::NO_PATTERN, addText(m, "another"));
+	TEST_ASSERT_EQUAL(SerialMultiMatch::NO_PATTERN, m.add((const uint8_t *)"", 0, false));
+	m.build();
+	TEST_ASSERT_EQUAL_UINT32(1u << 7, (uint32_t)scanText(m, "xx p07 yy"));
+	TEST_ASSERT_TRUE(scanText(m, "p63") & (1ULL << 63));
+}
+
+void test_filter_include_exclude_per_slot() {
+	SerialFilterSpec specs[3];
+	memset(specs, 0, sizeof(specs));
+	// Slot 0: Fehler, aber keine Debugzeilen
+	specs[0].rules[specs[0].count++] = rule(FILTER_CONTAINS, "ERROR");
+	specs[0].rules[specs[0].count++] = rule(FILTER_PREFIX, "DBG", true);
+	// Slot 1: ungefiltert
+	// Slot 2: nur Gerät "[m2]" (Präfix) oder Temperaturwerte (Ausdruck)
+	specs[2].rules[specs[2].count++] = rule(FILTER_PREFIX, "[m2]");
+	specs[2].rules[specs[2].count++] = rule(FILTER_REGEX, "T=\\d+");
+
+	SerialLineFilter f;
+	char err[64];
+	TEST_ASSERT_TRUE_MESSAGE(f.build(specs, 3, err, sizeof(err)), err);
+	TEST_ASSERT_EQUAL_UINT32(0x5, f.filtered());
+	TEST_ASSERT_EQUAL(1, f.regexes());
+
+	TEST_ASSERT_EQUAL_UINT32(0x1, evalText(f, "[m1] ERROR 17"));
+	TEST_ASSERT_EQUAL_UINT32(0x0, evalText(f, "DBG ERROR trace"));
+	TEST_ASSERT_EQUAL_UINT32(0x4, evalText(f, "[m2] ready"));
+	TEST_ASSERT_EQUAL_UINT32(0x5, evalText(f, "[m2] ERROR T=80"));
+	TEST_ASSERT_EQUAL_UINT32(0x4, evalText(f, "sensor T=21"));
+	TEST_ASSERT_EQUAL_UINT32(0x0, evalText(f, "idle"));
+}
+
+void test_filter_exclude_only_and_case() {
+	SerialFilterSpec spec;
+	memset(&spec, 0, sizeof(spec));
+	spec.rules[spec.count++] = rule(FILTER_CONTAINS, "heartbeat", true, true);
+	SerialLineFilter f;
+	char err[64];
+	TEST_ASSERT_TRUE(f.build(&spec, 1, err, sizeof(err)));
+	TEST_ASSERT_EQUAL_UINT32(0x1, evalText(f, "temp 21"));
+	TEST_ASSERT_EQUAL_UINT32(0x0, evalText(f, "HeartBeat 1234"));
+}
+
+void test_filter_errors_and_shared_regex() {
+	SerialFilterSpec specs[SerialLineFilter::MAX_SLOTS];
+	memset(specs, 0, sizeof(specs));
+	SerialLineFilter f;
+	char err[64];
+
+	specs[0].rules[specs[0].count++] = rule(FILTER_REGEX, "(a");
+	TEST_ASSERT_FALSE(f.build(specs, 1, err, sizeof(err)));
+	TEST_ASSERT_EQUAL_STRING_LEN("Regel 1: ", err, 9);
+
+	specs[0].rules[0] = rule(FILTER_CONTAINS, "");
+	TEST_ASSERT_FALSE(f.build(specs, 1, err, sizeof(err)));
+
+	// Gleicher Ausdruck in allen Slots zählt nur einmal
+	memset(specs, 0, sizeof(specs));
+	for (size_t s = 0; s < SerialLineFilter::MAX_SLOTS; ++s) specs[s].rules[specs[s].count++] = rule(FILTER_REGEX, "E\\d+");
+	TEST_ASSERT_TRUE(f.build(specs, SerialLineFilter::MAX_SLOTS, err, sizeof(err)));
+	TEST_ASSERT_EQUAL(1, f.regexes());
+	TEST_ASSERT_EQUAL_UINT32(0xFF, evalText(f, "fault E12"));
+
+	// Mehr verschiedene Ausdrücke als MAX_REGEX
+	memset(specs, 0, sizeof(specs));
+	char text[8];
+	for (size_t s = 0; s <= SerialLineFilter::MAX_REGEX; ++s) {
+		snprintf(text, sizeof(text), "R%u\\d", (unsigned)s);
+		specs[s].rules[specs[s].count++] = rule(FILTER_REGEX, text);
+	}
+	TEST_ASSERT_FALSE(f.build(specs, SerialLineFilter::MAX_REGEX + 1, err, sizeof(err)));
+	TEST_ASSERT_EQUAL_STRING("Zu viele Ausdrücke", err);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_multimatch_overlapping_patterns);
+	RUN_TEST(test_multimatch_prefix_case_and_dedupe);
+	RUN_TEST(test_multimatch_capacity);
+	RUN_TEST(test_filter_include_exclude_per_slot);
+	RUN_TEST(test_filter_exclude_only_and_case);
+	RUN_TEST(test_filter_errors_and_shared_regex);
+	return UNITY_END();
+}
@@ -0,0 +1,432 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests und Benchmarks für den Framer der SerialBridge.
+ *
+ * Der alte Framer (Byte für Byte über `read()`, zwei Vergleiche pro Zeichen) ist hier als
+ * Referenz nachgebaut. Mit dem Profil `text-raw` muss der Framer für denselben Gerätemitschnitt
+ * identische Zeilen liefern; der Benchmark gibt MB/s und Zeilen/s beider Varianten aus.
+ * Die übrigen Tests decken jedes Framing-Verfahren bei beliebiger Blockaufteilung ab.
+ */
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DeviceCapture.h"
+#include "SerialFramer.h"
+#include "UartPort.h"
+
+/**
+ * @brief UART, die einen Speicherbereich abspielt.
+ */
+class ReplayUart : public UartPort {
+   public:
+	ReplayUart(const uint8_t *data, size_t len) : _data(data), _len(len), _pos(0) {
+	}
+	bool begin(uint32_t) override {
+		return true;
+	}
+	size_t available() override {
+		return _len - _pos;
+	}
+	size_t read(uint8_t *buf, size_t len) override {
+		size_t n = len < _len - _pos ? len : _len - _pos;
+		memcpy(buf, _data + _pos, n);
+		_pos += n;
+		return n;
+	}
+	size_t write(const uint8_t *, size_t len) override {
+		return len;
+	}
+	void flushInput() override {
+		_pos = _len;
+	}
+	bool waitEvent(UartEvent &, uint32_t) override {
+		return false;
+	}
+	void sleep(uint32_t) override {
+	}
+	uint32_t now() override {
+		return 0;
+	}
+
+   private:
+	const uint8_t *_data;
+	size_t _len, _pos;
+};
+
+/**
+ * @brief Nachbau der bisherigen Zeilenbildung aus SerialBridge::taskFunc.
+ */
+template <typename Sink>
+static void legacyFrame(UartPort &port, Sink sink) {
+	char batch[256];
+	size_t idx = 0;
+	while (port.available()) {
+		uint8_t b;
+		port.read(&b, 1);
+		char c = (char)b;
+		if (idx + 1 < sizeof(batch)) batch[idx++] = c;
+		if (c == '\r' || c == '\n' || idx + 1 == sizeof(batch)) {
+			batch[idx] = '\0';
+			sink(batch, idx);
+			idx = 0;
+		}
+	}
+	if (idx > 0) sink(batch, idx);
+}
+
+struct Collector {
+	std::vector<std::string> lines;
+	std::vector<uint64_t> stamps;
+	static void sink(void *ctx, const uint8_t *line, size_t len, bool, uint64_t rxUs) {
+		auto *c = static_cast<Collector *>(ctx);
+		c->lines.push_back(std::string((const char *)line, len));
+		c->stamps.push_back(rxUs);
+	}
+};
+
+struct Counter {
+	size_t lines = 0;
+	size_t bytes = 0;
+	static void sink(void *ctx, const uint8_t *line, size_t len, bool, uint64_t) {
+		auto *c = static_cast<Counter *>(ctx);
+		c->lines++;
+		c->bytes += len + line[len - 1];
+	}
+};
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_find_line_end_every_offset() {
+	uint8_t buf[40];
+	for (size_t pos = 0; pos < sizeof(buf); ++pos) {
+		for (uint8_t eol : {(uint8_t)'\r', (uint8_t)'\n'}) {
+			memset(buf, 'x', sizeof(buf));
+			buf[pos] = eol;
+			for (size_t start = 0; start <= pos; ++start) {
+				TEST_ASSERT_EQUAL(pos, SerialFramer::findLineEnd(buf + start, buf + sizeof(buf)) - buf);
+			}
+		}
+	}
+	memset(buf, 0x8D, sizeof(buf));  // Bytes mit gesetztem Bit 7 dürfen keine Treffer erzeugen
+	TEST_ASSERT_EQUAL(sizeof(buf), SerialFramer::findLineEnd(buf, buf + sizeof(buf)) - buf);
+}
+
+void test_matches_legacy_framer_for_any_chunking() {
+	const uint8_t *data = (const uint8_t *)DEVICE_CAPTURE;
+
+	std::vector<std::string> expected;
+	ReplayUart uart(data, DEVICE_CAPTURE_LEN);
+	legacyFrame(uart, [&](const char *l, size_t n) { expected.push_back(std::string(l, n)); });
+
+	SerialFramerConfig raw;
+	TEST_ASSERT_TRUE(SerialFramer::profile("text-raw", raw));
+	for (size_t chunk : {1u, 3u, 7u, 64u, 128u, 1000u}) {
+		Collector col;
+		SerialFramer framer(Collector::sink, &col);
+		TEST_ASSERT_TRUE(framer.configure(raw));
+		for (size_t off = 0; off < DEVICE_CAPTURE_LEN; off += chunk) {
+			size_t n = DEVICE_CAPTURE_LEN - off < chunk ? DEVICE_CAPTURE_LEN - off : chunk;
+			framer.feed(data + off, n);
+		}
+		framer.flush();
+		TEST_ASSERT_EQUAL(expected.size(), col.lines.size());
+		for (size_t i = 0; i < expected.size(); ++i) TEST_ASSERT_EQUAL_STRING(expected[i].c_str(), col.lines[i].c_str());
+	}
+}
+
+void test_long_line_is_split_at_max_len() {
+	Collector col;
+	SerialFramer framer(Collector::sink, &col);
+	std::string longLine(600, 'a');
+	framer.feed((const uint8_t *)longLine.data(), longLine.size());
+	TEST_ASSERT_EQUAL(2, col.lines.size());
+	TEST_ASSERT_EQUAL(SerialFramer::DEFAULT_MAX_RECORD, col.lines[0].size());
+	TEST_ASSERT_EQUAL(600 - 2 * SerialFramer::DEFAULT_MAX_RECORD, framer.pending());
+	TEST_ASSERT_EQUAL(2, framer.stats().split);
+	TEST_ASSERT_TRUE(framer.flush());
+	TEST_ASSERT_FALSE(framer.flush());
+}
+
+void test_benchmark_legacy_vs_bulk() {
+	// ~1 MB Mitschnitt
+	std::string input;
+	while (input.size() < (1u << 20)) input.append(DEVICE_CAPTURE, DEVICE_CAPTURE_LEN);
+	const uint8_t *data = (const uint8_t *)input.data();
+	const int rounds = 5;
+
+	size_t legacyLines = 0;
+	auto t0 = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		ReplayUart uart(data, input.size());
+		legacyFrame(uart, [&](const char *, size_t) { legacyLines++; });
+	}
+	double legacySec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+	Counter cnt;
+	t0 = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		ReplayUart uart(data, input.size());
+		SerialFramer framer(Counter::sink, &cnt);
+		SerialFramerConfig raw;
+		SerialFramer::profile("text-raw", raw);
+		framer.configure(raw);
+		uint8_t chunk[256];
+		size_t n;
+		while ((n = uart.read(chunk, sizeof(chunk))) > 0) framer.feed(chunk, n);
+		framer.flush();
+	}
+	double bulkSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+	double mb = (double)input.size() * rounds / (1024.0 * 1024.0);
+	printf("[framer] legacy: %8.1f MB/s %12.0f lines/s\n", mb / legacySec, legacyLines / legacySec);
+	printf("[framer] bulk:   %8.1f MB/s %12.0f lines/s\n", mb / bulkSec, cnt.lines / bulkSec);
+
+	TEST_ASSERT_EQUAL(legacyLines, cnt.lines);
+}
+
+/**
+ * @brief Füttert `input` in Blöcken der Größe `chunk` und gibt alle Datensätze zurück.
+ */
+static std::vector<std::string> frameAll(const SerialFramerConfig &cfg, const std::string &input, size_t chunk, bool flush = true) {
+	Collector col;
+	SerialFramer framer(Collector::sink, &col);
+	TEST_ASSERT_TRUE(framer.configure(cfg));
+	for (size_t off = 0; off < input.size(); off += chunk) {
+		size_t n = input.size() - off < chunk ? input.size() - off : chunk;
+		framer.feed((const uint8_t *)input.data() + off, n);
+	}
+	if (flush) framer.flush();
+	return col.lines;
+}
+
+/**
+ * @brief Prüft, dass jede Blockaufteilung dieselben Datensätze liefert.
+ */
+static void expectRecords(const SerialFramerConfig &cfg, const std::string &input, const std::vector<std::string> &expected) {
+	for (size_t chunk = 1; chunk <= input.size(); ++chunk) {
+		std::vector<std::string> got = frameAll(cfg, input, chunk);
+		TEST_ASSERT_EQUAL(expected.size(), got.size());
+		for (size_t i = 0; i < expected.size(); ++i) TEST_ASSERT_EQUAL_STRING(expected[i].c_str(), got[i].c_str());
+	}
+}
+
+void test_line_joins_crlf() {
+	SerialFramerConfig cfg = SerialFramer::defaultConfig();
+	expectRecords(cfg, "OK\r\nREADY\r\rE:0\n\nX", {"OK\r\n", "READY\r", "\r", "E:0\n", "\n", "X"});
+
+	// Auf ein CR am Blockende folgt kein LF: Zeile geht spätestens mit dem nächsten Byte raus
+	Collector col;
+	SerialFramer framer(Collector::sink, &col);
+	framer.feed((const uint8_t *)"A\r", 2);
+	TEST_ASSERT_EQUAL(0, col.lines.size());
+	TEST_ASSERT_EQUAL(2, framer.pending());
+	TEST_ASSERT_TRUE(framer.flush());
+	TEST_ASSERT_EQUAL(1, col.lines.size());
+	TEST_ASSERT_EQUAL(0, framer.stats().partial);  // nach CR ist die Zeile vollständig
+}
+
+void test_line_custom_delimiters() {
+	SerialFramerConfig cfg = SerialFramer::defaultConfig();
+	cfg.delimiters[0] = ';';
+	cfg.delimiters[1] = '\n';
+	cfg.delimiters[2] = '|';
+	cfg.delimiterCount = 3;
+	cfg.joinCrLf = false;
+	expectRecords(cfg, "Z1:21.4;Z2:21.6|P:1.013\nrest", {"Z1:21.4;", "Z2:21.6|", "P:1.013\n", "rest"});
+}
+
+void test_terminator_across_blocks() {
+	SerialFramerConfig cfg = SerialFramer::defaultConfig();
+	cfg.mode = SERIAL_FRAMING_TERMINATOR;
+	memcpy(cfg.terminator, "\r\n> ", 4);
+	cfg.terminatorLen = 4;
+	cfg.maxRecord = 64;
+	expectRecords(cfg, "STATUS\r\nZ1:21.4\r\n> \r\n>> OK\r\n> \r\n>",
+	              {"STATUS\r\nZ1:21.4\r\n> ", "\r\n>> OK\r\n> ", "\r\n>"});
+
+	// Selbstüberlappende Endekennung
+	cfg.terminator[0] = 'a';
+	cfg.terminator[1] = 'a';
+	cfg.terminator[2] = 'b';
+	cfg.terminatorLen = 3;
+	expectRecords(cfg, "xaaabyaabaab", {"xaaab", "yaab", "aab"});
+}
+
+void test_terminator_split_at_max_record() {
+	SerialFramerConfig cfg;
+	TEST_ASSERT_TRUE(SerialFramer::profile("crlf", cfg));
+	cfg.maxRecord = 8;
+	expectRecords(cfg, "0123456789\r\nAB\r\n", {"01234567", "89\r\n", "AB\r\n"});
+}
+
+void test_fixed_length() {
+	SerialFramerConfig cfg = SerialFramer::defaultConfig();
+	cfg.mode = SERIAL_FRAMING_FIXED;
+	cfg.fixedLen = 4;
+	expectRecords(cfg, "AAAABBBBCCCCDD", {"AAAA", "BBBB", "CCCC", "DD"});
+}
+
+void test_length_prefix() {
+	SerialFramerConfig cfg;
+	TEST_ASSERT_TRUE(SerialFramer::profile("length8", cfg));
+	expectRecords(cfg, std::string("\x03" "abc" "\x00" "\x01" "z", 7), {std::string("\x03" "abc", 4), std::string("\x00", 1), std::string("\x01" "z", 2)});
+
+	TEST_ASSERT_TRUE(SerialFramer::profile("length16", cfg));
+	std::string big = std::string("\x01\x2C", 2) + std::string(300, 'q');
+	expectRecords(cfg, big + std::string("\x00\x01" "!", 3), {big, std::string("\x00\x01" "!", 3)});
+
+	// Längenangabe inklusive Präfix, Little Endian; ungültige Länge wird byteweise übersprungen
+	cfg.lengthBigEndian = false;
+	cfg.lengthIncludesHeader = true;
+	cfg.maxRecord = 16;
+	std::string in = std::string("\x01\x00", 2) + std::string("\x05\x00" "abc", 5);
+	std::vector<std::string> got = frameAll(cfg, in, 1);
+	TEST_ASSERT_EQUAL(1, got.size());
+	TEST_ASSERT_TRUE(got[0] == std::string("\x05\x00" "abc", 5));
+}
+
+void test_stx_etx() {
+	SerialFramerConfig cfg;
+	TEST_ASSERT_TRUE(SerialFramer::profile("stx-etx", cfg));
+	std::string in = "noise\x02" "A1\x03" "xx\x02" "lost\x02" "B2\x03";
+	expectRecords(cfg, in, {"\x02" "A1\x03", "\x02" "lost", "\x02" "B2\x03"});
+
+	Collector col;
+	SerialFramer framer(Collector::sink, &col);
+	framer.configure(cfg);
+	framer.feed((const uint8_t *)in.data(), in.size());
+	TEST_ASSERT_EQUAL(7, framer.stats().discarded);  // "noise" und "xx"
+	TEST_ASSERT_EQUAL(1, framer.stats().partial);
+}
+
+void test_idle_gap() {
+	SerialFramerConfig cfg;
+	TEST_ASSERT_TRUE(SerialFramer::profile("idle", cfg));
+	cfg.maxRecord = 6;
+	Collector col;
+	SerialFramer framer(Collector::sink, &col);
+	TEST_ASSERT_TRUE(framer.configure(cfg));
+	framer.feed((const uint8_t *)"\x01\x03\x00", 3);
+	framer.feed((const uint8_t *)"\x10\x00", 2);
+	TEST_ASSERT_EQUAL(0, col.lines.size());
+	TEST_ASSERT_TRUE(framer.flush());  // Sendepause
+	framer.feed((const uint8_t *)"12345678", 8);
+	framer.flush();
+	TEST_ASSERT_EQUAL(3, col.lines.size());
+	TEST_ASSERT_EQUAL(5, col.lines[0].size());
+	TEST_ASSERT_EQUAL_STRING("123456", col.lines[1].c_str());
+	TEST_ASSERT_EQUAL_STRING("78", col.lines[2].c_str());
+	TEST_ASSERT_EQUAL(0, framer.stats().partial);
+}
+
+void test_record_carries_arrival_of_first_byte() {
+	Collector col;
+	SerialFramer framer(Collector::sink, &col);
+	framer.feed((const uint8_t *)"A\nBB", 4, 1000);
+	framer.feed((const uint8_t *)"B\nC", 3, 1850);
+	framer.feed((const uint8_t *)"\n", 1, 2400);
+	framer.feed((const uint8_t *)"D", 1, 9000);
+	framer.flush();
+	TEST_ASSERT_EQUAL(4, col.lines.size());
+	TEST_ASSERT_TRUE(col.stamps[0] == 1000);  // A
+	TEST_ASSERT_TRUE(col.stamps[1] == 1000);  // BBB, angefangen im ersten Block
+	TEST_ASSERT_TRUE(col.stamps[2] == 1850);  // C
+	TEST_ASSERT_TRUE(col.stamps[3] == 9000);  // D, nach Timeout
+}
+
+void test_invalid_config_is_rejected() {
+	Collector col;
+	SerialFramer framer(Collector::sink, &col);
+	SerialFramerConfig cfg = SerialFramer::defaultConfig();
+	cfg.maxRecord = SerialFramer::MAX_RECORD + 1;
+	TEST_ASSERT_FALSE(framer.configure(cfg));
+	cfg = SerialFramer::defaultConfig();
+	cfg.mode = SERIAL_FRAMING_STX_ETX;
+	cfg.etx = cfg.stx;
+	TEST_ASSERT_FALSE(framer.configure(cfg));
+	cfg = SerialFramer::defaultConfig();
+	cfg.mode = SERIAL_FRAMING_FIXED;
+	cfg.fixedLen = 300;
+	TEST_ASSERT_FALSE(framer.configure(cfg));
+	SerialFramerConfig unknown;
+	TEST_ASSERT_FALSE(SerialFramer::profile("modem", unknown));
+	TEST_ASSERT_EQUAL(SERIAL_FRAMING_LINE, framer.config().mode);
+}
+
+void test_benchmark_terminator_scanner() {
+	// ~1 MB Mitschnitt, Suche nach einem Zeichen aus einer Menge bzw. nach einer Bytefolge
+	std::string input;
+	while (input.size() < (1u << 20)) input.append(DEVICE_CAPTURE, DEVICE_CAPTURE_LEN);
+	const uint8_t *data = (const uint8_t *)input.data();
+	const uint8_t *end = data + input.size();
+	const uint8_t set[3] = {'\r', '\n', ';'};
+	const int rounds = 5;
+
+	size_t naiveHits = 0;
+	auto t0 = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		for (const uint8_t *p = data; p < end; ++p) {
+			if (*p == set[0] || *p == set[1] || *p == set[2]) naiveHits++;
+		}
+	}
+	double naiveSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+	size_t swarHits = 0;
+	t0 = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		for (const uint8_t *p = data; (p = SerialFramer::findAny(p, end, set, 3)) < end; ++p) swarHits++;
+	}
+	double swarSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+	SerialFramerConfig cfg;
+	SerialFramer::profile("crlf", cfg);
+	Counter cnt;
+	t0 = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		SerialFramer framer(Counter::sink, &cnt);
+		framer.configure(cfg);
+		for (size_t off = 0; off < input.size(); off += 256) {
+			size_t n = input.size() - off < 256 ? input.size() - off : 256;
+			framer.feed(data + off, n);
+		}
+		framer.flush();
+	}
+	double termSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+	double mb = (double)input.size() * rounds / (1024.0 * 1024.0);
+	printf("[framer] set naive:  %8.1f MB/s\n", mb / naiveSec);
+	printf("[framer] set swar:   %8.1f MB/s\n", mb / swarSec);
+	printf("[framer] crlf frame: %8.1f MB/s %12.0f records/s\n", mb / termSec, cnt.lines / termSec);
+
+	TEST_ASSERT_EQUAL(naiveHits, swarHits);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_find_line_end_every_offset);
+	RUN_TEST(test_matches_legacy_framer_for_any_chunking);
+	RUN_TEST(test_long_line_is_split_at_max_len);
+	RUN_TEST(test_benchmark_legacy_vs_bulk);
+	RUN_TEST(test_line_joins_crlf);
+	RUN_TEST(test_line_custom_delimiters);
+	RUN_TEST(test_terminator_across_blocks);
+	RUN_TEST(test_terminator_split_at_max_record);
+	RUN_TEST(test_fixed_length);
+	RUN_TEST(test_length_prefix);
+	RUN_TEST(test_stx_etx);
+	RUN_TEST(test_idle_gap);
+	RUN_TEST(test_record_carries_arrival_of_first_byte);
+	RUN_TEST(test_invalid_config_is_rejected);
+	RUN_TEST(test_benchmark_terminator_scanner);
+	return UNITY_END();
+}
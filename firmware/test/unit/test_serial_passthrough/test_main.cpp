@@ -0,0 +1,236 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für den Durchreichmodus (Gegendruck, Boot-Sequenzen, Durchsatz).
+ */
+
+#include <unity.h>
+
+#include <string>
+#include <vector>
+
+#include "FakeUart.h"
+#include "SerialPassthrough.h"
+
+/**
+ * @brief Fake-UART, deren Uhr beim Schreiben mit der Leitungsrate (8N1) vorläuft.
+ */
+struct LineUart : FakeUart {
+	uint64_t lineUs = 0;
+	size_t writes = 0;
+	size_t largest = 0;
+	size_t write(const uint8_t *buf, size_t len) override {
+		writes++;
+		if (len > largest) largest = len;
+		lineUs += (uint64_t)len * 10000000ULL / baud;
+		clock = (uint32_t)(lineUs / 1000);
+		return FakeUart::write(buf, len);
+	}
+};
+
+static std::vector<uint8_t> g_mem(SerialPassthrough::MEMORY_BYTES);
+
+static SerialPassthroughConfig config(uint32_t baud, uint32_t size) {
+	SerialPassthroughConfig cfg = {};
+	cfg.baud = baud;
+	cfg.size = size;
+	cfg.restoreBaud = true;
+	cfg.idleMs = SerialPassthrough::DEFAULT_IDLE_MS;
+	return cfg;
+}
+
+static SerialUploadResult offer(SerialPassthrough &pt, uint32_t offset, const std::string &s) {
+	return pt.offer(offset, (const uint8_t *)s.data(), s.size());
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_upload_header_roundtrip() {
+	uint8_t buf[SERIAL_UPLOAD_HEADER_LEN];
+	SerialUploadHeader in{SERIAL_UPLOAD_VERSION, 1, 0, 0x01020304};
+	TEST_ASSERT_EQUAL(SERIAL_UPLOAD_HEADER_LEN, encodeSerialUploadHeader(in, buf));
+	TEST_ASSERT_EQUAL_HEX8(0x04, buf[4]);
+	SerialUploadHeader out;
+	TEST_ASSERT_TRUE(decodeSerialUploadHeader(buf, sizeof(buf), out));
+	TEST_ASSERT_EQUAL(1, out.channel);
+	TEST_ASSERT_EQUAL_HEX32(0x01020304, out.offset);
+	TEST_ASSERT_FALSE(decodeSerialUploadHeader(buf, sizeof(buf) - 1, out));
+	buf[0] = 9;
+	TEST_ASSERT_FALSE(decodeSerialUploadHeader(buf, sizeof(buf), out));
+}
+
+void test_offsets_and_window() {
+	FakeUart uart;
+	SerialPassthrough pt(uart);
+	TEST_ASSERT_EQUAL(PASSTHROUGH_IDLE, pt.state());
+	TEST_ASSERT_EQUAL(UPLOAD_INACTIVE, offer(pt, 0, "x"));
+	TEST_ASSERT_TRUE(pt.begin(7, config(921600, 0), g_mem.data()));
+	TEST_ASSERT_FALSE(pt.begin(8, config(921600, 0), g_mem.data()));
+	TEST_ASSERT_EQUAL(7, pt.owner());
+
+	// Schon vor enter() wird gepuffert, aber nichts geschrieben
+	TEST_ASSERT_EQUAL(UPLOAD_OK, offer(pt, 0, "abcd"));
+	TEST_ASSERT_EQUAL(0, pt.drain());
+	TEST_ASSERT_TRUE(pt.enter());
+	TEST_ASSERT_EQUAL(921600, uart.baud);
+	TEST_ASSERT_EQUAL(PASSTHROUGH_ACTIVE, pt.state());
+
+	TEST_ASSERT_EQUAL(UPLOAD_DUPLICATE, offer(pt, 0, "abcd"));
+	TEST_ASSERT_EQUAL(UPLOAD_GAP, offer(pt, 6, "gh"));
+	TEST_ASSERT_EQUAL(UPLOAD_OK, offer(pt, 2, "cdef"));  // Überlappung: nur "ef" ist neu
+	TEST_ASSERT_EQUAL(6, pt.drain());
+	TEST_ASSERT_EQUAL_STRING("abcdef", uart.written.c_str());
+
+	// Limit = geschrieben + Puffergröße; darüber wird abgelehnt statt gepuffert
+	TEST_ASSERT_EQUAL_UINT32(6 + SerialPassthrough::BUFFER_BYTES, pt.limit());
+	std::string block(SerialPassthrough::BUFFER_BYTES, 'z');
+	TEST_ASSERT_EQUAL(UPLOAD_OK, offer(pt, 6, block));
+	TEST_ASSERT_EQUAL(UPLOAD_OVERFLOW, offer(pt, 6 + (uint32_t)block.size(), "!"));
+	size_t n = pt.drain();
+	TEST_ASSERT_EQUAL(SerialPassthrough::chunkFor(921600), n);
+	TEST_ASSERT_EQUAL(UPLOAD_OK, offer(pt, 6 + (uint32_t)block.size(), "!"));
+
+	SerialPassthroughStats st = pt.stats();
+	TEST_ASSERT_EQUAL_UINT32(2, st.rejected);
+	TEST_ASSERT_EQUAL_UINT32(4, st.chunks);
+	TEST_ASSERT_EQUAL(SerialPassthrough::BUFFER_BYTES, st.maxBuffered);
+
+	// Offenes Ende: stop schreibt den Rest noch, abort verwirft ihn
+	pt.requestStop(false);
+	TEST_ASSERT_FALSE(pt.complete());
+	TEST_ASSERT_EQUAL(UPLOAD_INACTIVE, offer(pt, 0, "x"));
+	while (pt.drain() > 0) {
+	}
+	TEST_ASSERT_TRUE(pt.complete());
+	st = pt.finish(115200);
+	TEST_ASSERT_EQUAL_UINT32(st.received, st.written);
+	TEST_ASSERT_EQUAL(115200, uart.baud);
+	TEST_ASSERT_EQUAL(PASSTHROUGH_STOPPING, pt.state());
+	pt.close();
+	TEST_ASSERT_EQUAL(0, pt.owner());
+
+	TEST_ASSERT_TRUE(pt.begin(9, config(115200, 0), g_mem.data()));
+	TEST_ASSERT_TRUE(pt.enter());
+	TEST_ASSERT_EQUAL(UPLOAD_OK, offer(pt, 0, "never sent"));
+	pt.requestStop(true);
+	TEST_ASSERT_TRUE(pt.complete());
+	TEST_ASSERT_TRUE(pt.aborted());
+	TEST_ASSERT_EQUAL(0, pt.drain());
+	TEST_ASSERT_EQUAL_UINT32(0, pt.finish(0).written);
+	pt.close();
+}
+
+void test_size_idle_and_validation() {
+	FakeUart uart;
+	SerialPassthrough pt(uart);
+	SerialPassthroughConfig cfg = config(460800, 8);
+	TEST_ASSERT_TRUE(SerialPassthrough::validate(cfg));
+	cfg.baud = SerialPassthrough::MAX_BAUD + 1;
+	TEST_ASSERT_FALSE(SerialPassthrough::validate(cfg));
+	cfg = config(460800, 8);
+	cfg.enter = 3;
+	TEST_ASSERT_FALSE(pt.begin(1, cfg, g_mem.data()));
+	TEST_ASSERT_EQUAL(64, SerialPassthrough::chunkFor(9600));
+	TEST_ASSERT_EQUAL(SerialPassthrough::WRITE_CHUNK, SerialPassthrough::chunkFor(2000000));
+
+	cfg = config(460800, 8);
+	cfg.idleMs = 500;
+	TEST_ASSERT_TRUE(pt.begin(1, cfg, g_mem.data()));
+	TEST_ASSERT_TRUE(pt.enter());
+	TEST_ASSERT_EQUAL(UPLOAD_TOO_LONG, offer(pt, 4, "56789"));
+	TEST_ASSERT_EQUAL(UPLOAD_OK, offer(pt, 0, "0123"));
+	TEST_ASSERT_EQUAL_UINT32(8, pt.limit());
+	pt.drain();
+	TEST_ASSERT_FALSE(pt.complete());
+	uart.sleep(499);
+	TEST_ASSERT_FALSE(pt.idle());
+	uart.sleep(1);
+	TEST_ASSERT_TRUE(pt.idle());
+	TEST_ASSERT_EQUAL(UPLOAD_OK, offer(pt, 4, "4567"));
+	TEST_ASSERT_FALSE(pt.idle());
+	pt.drain();
+	TEST_ASSERT_TRUE(pt.complete());
+	pt.finish(0);
+	TEST_ASSERT_EQUAL(460800, uart.baud);
+	pt.close();
+}
+
+void test_boot_sequences() {
+	FakeUart uart;
+	SerialPassthrough pt(uart);
+	SerialPassthroughConfig cfg = config(921600, 2);
+	cfg.enter = BOOT_MODE_BOOTLOADER;
+	cfg.leave = BOOT_MODE_RUN;
+
+	// Ohne verdrahtete Leitungen: Übertragung trotzdem möglich, enter() meldet es
+	TEST_ASSERT_FALSE(pt.resetTarget(BOOT_MODE_RUN));
+	TEST_ASSERT_TRUE(pt.begin(1, cfg, g_mem.data()));
+	TEST_ASSERT_FALSE(pt.enter());
+	TEST_ASSERT_EQUAL(PASSTHROUGH_ACTIVE, pt.state());
+	pt.requestStop(true);
+	pt.finish(115200);
+	pt.close();
+
+	uart.bootLines = true;
+	uart.trace.clear();
+	uart.clock = 1000;
+	TEST_ASSERT_TRUE(pt.begin(1, cfg, g_mem.data()));
+	TEST_ASSERT_TRUE(pt.enter());
+	// Boot-Pin bleibt über das Loslassen des Resets hinaus aktiv
+	TEST_ASSERT_EQUAL_STRING("<B0R0@1000><B1R1@1000><B1R0@1100><B0R0@1150>", uart.trace.c_str());
+	TEST_ASSERT_EQUAL(UPLOAD_OK, offer(pt, 0, "ok"));
+	pt.drain();
+	uart.trace.clear();
+	pt.finish(115200);
+	TEST_ASSERT_EQUAL_STRING("<B0R0@1150><B0R1@1150><B0R0@1250>", uart.trace.c_str());
+	pt.close();
+
+	uart.trace.clear();
+	TEST_ASSERT_TRUE(pt.resetTarget(BOOT_MODE_BOOTLOADER));
+	TEST_ASSERT_EQUAL_STRING("<B0R0@1250><B1R1@1250><B1R0@1350><B0R0@1400>", uart.trace.c_str());
+}
+
+void test_throughput_report() {
+	// 256 KB bei 921600 Baud in 4-KB-Blöcken, der Client hält das Fenster gefüllt
+	const uint32_t total = 262144;
+	LineUart uart;
+	std::vector<uint32_t> tapped;
+	SerialPassthrough pt(uart);
+	pt.onTransmit([](void *ctx, const uint8_t *, size_t len) { static_cast<std::vector<uint32_t> *>(ctx)->push_back((uint32_t)len); }, &tapped);
+	TEST_ASSERT_TRUE(pt.begin(1, config(921600, total), g_mem.data()));
+	TEST_ASSERT_TRUE(pt.enter());
+
+	std::vector<uint8_t> image(total);
+	for (uint32_t i = 0; i < total; ++i) image[i] = (uint8_t)(i * 31 + 7);
+	uint32_t sent = 0;
+	while (!pt.complete()) {
+		while (sent < total && sent + 4096 <= pt.limit()) {
+			TEST_ASSERT_EQUAL(UPLOAD_OK, pt.offer(sent, image.data() + sent, 4096));
+			sent += 4096;
+		}
+		TEST_ASSERT_NOT_EQUAL(0, pt.drain());
+	}
+	SerialPassthroughStats st = pt.finish(115200);
+	TEST_ASSERT_EQUAL_UINT32(total, st.written);
+	TEST_ASSERT_EQUAL(0, memcmp(image.data(), uart.written.data(), total));
+	TEST_ASSERT_EQUAL(uart.writes, tapped.size());
+	TEST_ASSERT_EQUAL(SerialPassthrough::WRITE_CHUNK, uart.largest);
+	TEST_ASSERT_EQUAL_UINT32(0, st.rejected);
+	TEST_ASSERT_TRUE(st.linePercent >= 99);
+	printf("[passthrough] %u bytes in %u ms: %u B/s (%u %% of line rate), %u writes\n", (unsigned)st.written, (unsigned)st.elapsedMs, (unsigned)st.bytesPerSec,
+	       (unsigned)st.linePercent, (unsigned)uart.writes);
+	pt.close();
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_upload_header_roundtrip);
+	RUN_TEST(test_offsets_and_window);
+	RUN_TEST(test_size_idle_and_validation);
+	RUN_TEST(test_boot_sequences);
+	RUN_TEST(test_throughput_report);
+	return UNITY_END();
+}
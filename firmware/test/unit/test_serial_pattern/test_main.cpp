@@ -0,0 +1,117 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für die regulären Ausdrücke der Befehlsskripte (SerialPattern).
+ */
+
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+
+#include "SerialPattern.h"
+
+static SerialPattern pattern;
+
+/**
+ * @brief Sucht `re` in `text` und gibt Gruppe `group` zurück ("<none>" ohne Treffer).
+ */
+static std::string find(const char *re, const char *text, size_t group = 0) {
+	TEST_ASSERT_TRUE_MESSAGE(pattern.compile(re, strlen(re)), re);
+	SerialPatternMatch m;
+	if (!pattern.search((const uint8_t *)text, strlen(text), m)) return "<none>";
+	if (group >= m.groups) return "<nogroup>";
+	if (m.start[group] == SerialPatternMatch::UNSET) return "<unset>";
+	return std::string(text + m.start[group], m.end[group] - m.start[group]);
+}
+
+static const char *compileError(const char *re) {
+	TEST_ASSERT_FALSE_MESSAGE(pattern.compile(re, strlen(re)), re);
+	return pattern.error();
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_literals_classes_and_groups() {
+	TEST_ASSERT_EQUAL_STRING("VER 12.34", find("VER (\\d+)\\.(\\d+)", "xx VER 12.34\r\n").c_str());
+	TEST_ASSERT_EQUAL_STRING("34", find("VER (\\d+)\\.(\\d+)", "xx VER 12.34\r\n", 2).c_str());
+	TEST_ASSERT_EQUAL_STRING("1.2.3", find("[\\d.]+", "v=1.2.3").c_str());
+	TEST_ASSERT_EQUAL_STRING("abc", find("[^,]+", "abc,def").c_str());
+	TEST_ASSERT_EQUAL_STRING("<none>", find("[a-f0-9]+,X", "DEAD,X").c_str());
+	TEST_ASSERT_EQUAL_STRING("AAA", find("\\x41+", "zAAA").c_str());
+	TEST_ASSERT_EQUAL_STRING("a_1", find("\\w+", "  a_1 ").c_str());
+	TEST_ASSERT_EQUAL_STRING("<none>", find("\\S", " \t\r\n").c_str());
+}
+
+void test_quantifiers() {
+	TEST_ASSERT_EQUAL_STRING("color", find("colou?r", "color").c_str());
+	TEST_ASSERT_EQUAL_STRING("aaab", find("a*b", "aaab").c_str());
+	TEST_ASSERT_EQUAL_STRING("x11y22y", find("x.*y", "x11y22y").c_str());
+	TEST_ASSERT_EQUAL_STRING("x11y", find("x.*?y", "x11y22y").c_str());
+	TEST_ASSERT_EQUAL_STRING("abc", find("(?:ab)?c", "abc").c_str());
+	TEST_ASSERT_EQUAL_STRING("ababc", find("(a|b)+c", "zzababc").c_str());
+	TEST_ASSERT_EQUAL_STRING("b", find("(a|b)+c", "zzababc", 1).c_str());
+}
+
+void test_alternatives_and_unset_groups() {
+	TEST_ASSERT_EQUAL_STRING("ERROR", find("OK|(ERROR)", "foo ERROR").c_str());
+	TEST_ASSERT_EQUAL_STRING("OK", find("OK|(ERROR)", "foo OK ERROR").c_str());
+	TEST_ASSERT_EQUAL_STRING("<unset>", find("OK|(ERROR)", "foo OK ERROR", 1).c_str());
+	TEST_ASSERT_EQUAL_STRING("<nogroup>", find("OK|(ERROR)", "OK", 2).c_str());
+}
+
+void test_anchors_are_line_based() {
+	TEST_ASSERT_EQUAL_STRING("-42", find("^T=([-+]?\\d+)$", "x T=1\nT=-42\r\n", 1).c_str());
+	TEST_ASSERT_EQUAL_STRING("<none>", find("^T=", "xT=1").c_str());
+	TEST_ASSERT_EQUAL_STRING("end", find("\\w+$", "the end").c_str());
+}
+
+void test_literal_search() {
+	SerialPattern p;
+	TEST_ASSERT_TRUE(p.literal("OK\r", 3));
+	SerialPatternMatch m;
+	TEST_ASSERT_TRUE(p.search((const uint8_t *)"xxOKOK\r\n", 8, m));
+	TEST_ASSERT_EQUAL(4, m.start[0]);
+	TEST_ASSERT_EQUAL(7, m.end[0]);
+	TEST_ASSERT_FALSE(p.search((const uint8_t *)"OK", 2, m));
+	TEST_ASSERT_FALSE(p.literal("", 0));
+}
+
+void test_syntax_errors() {
+	TEST_ASSERT_EQUAL_STRING("Klammer ')' fehlt", compileError("a(b"));
+	TEST_ASSERT_EQUAL_STRING("Klammer ')' ohne '('", compileError("a)"));
+	TEST_ASSERT_EQUAL_STRING("Quantor ohne Ausdruck", compileError("*a"));
+	TEST_ASSERT_EQUAL_STRING("Klammer ']' fehlt", compileError("[abc"));
+	TEST_ASSERT_EQUAL_STRING("Ungültiger Bereich", compileError("[z-a]"));
+	TEST_ASSERT_EQUAL_STRING("Ungültiges \\x", compileError("\\x4"));
+	TEST_ASSERT_EQUAL_STRING("Zu viele Gruppen", compileError("(a)(b)(c)(d)(e)(f)(g)(h)"));
+	TEST_ASSERT_EQUAL_STRING("Gruppen zu tief geschachtelt", compileError("(?:(?:(?:(?:(?:(?:(?:(?:(?:a)))))))))"));
+	std::string huge(SerialPattern::MAX_PROGRAM, 'a');
+	TEST_ASSERT_FALSE(pattern.compile(huge.data(), huge.size()));
+}
+
+void test_pathological_pattern_is_bounded() {
+	std::string text(40, 'a');
+	text += 'c';
+	TEST_ASSERT_EQUAL_STRING("<none>", find("(a*)*b", text.c_str()).c_str());
+	TEST_ASSERT_TRUE(pattern.exhausted());
+	TEST_ASSERT_EQUAL_STRING("ab", find("(a*)*b", "ab").c_str());
+	TEST_ASSERT_FALSE(pattern.exhausted());
+	TEST_ASSERT_EQUAL_STRING("b", find("(a*)+b", "b").c_str());
+	TEST_ASSERT_EQUAL_STRING("aab", find("(?:a|)*b", "aab").c_str());
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_literals_classes_and_groups);
+	RUN_TEST(test_quantifiers);
+	RUN_TEST(test_alternatives_and_unset_groups);
+	RUN_TEST(test_anchors_are_line_based);
+	RUN_TEST(test_literal_search);
+	RUN_TEST(test_syntax_errors);
+	RUN_TEST(test_pathological_pattern_is_bounded);
+	return UNITY_END();
+}
@@ -0,0 +1,265 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für die zyklischen Abfragen und den Feldspeicher.
+ */
+
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "SerialPoller.h"
+
+/**
+ * @brief Sammelt gesendete Abfragen und gemeldete Änderungen.
+ */
+struct Probe {
+	std::vector<std::string> sent;
+	std::vector<uint32_t> updates;
+	bool accept = true;
+};
+
+static bool probeSend(void *ctx, const uint8_t *data, size_t len) {
+	Probe *p = static_cast<Probe *>(ctx);
+	if (!p->accept) return false;
+	p->sent.push_back(std::string((const char *)data, len));
+	return true;
+}
+
+static void probeUpdate(void *ctx, uint32_t changed) {
+	static_cast<Probe *>(ctx)->updates.push_back(changed);
+}
+
+static void addPoll(SerialPollerConfig &cfg, const char *name, const char *request, const char *pattern, std::vector<const char *> fields,
+                    uint32_t intervalMs = 1000, uint32_t timeoutMs = 200) {
+	SerialPollEntry &e = cfg.polls[cfg.count++];
+	memset(&e, 0, sizeof(e));
+	strncpy(e.name, name, sizeof(e.name) - 1);
+	e.requestLen = strlen(request);
+	memcpy(e.request, request, e.requestLen);
+	strncpy(e.pattern, pattern, sizeof(e.pattern) - 1);
+	for (const char *f : fields) strncpy(e.fields[e.fieldCount++], f, SerialPollEntry::MAX_NAME - 1);
+	e.intervalMs = intervalMs;
+	e.timeoutMs = timeoutMs;
+}
+
+static SerialPollerConfig emptyConfig() {
+	SerialPollerConfig cfg;
+	memset(&cfg, 0, sizeof(cfg));
+	return cfg;
+}
+
+static bool reply(SerialPoller &p, const char *line, uint32_t now) {
+	return p.onRecord((const uint8_t *)line, strlen(line), now);
+}
+
+static std::string value(const SerialPoller &p, const char *name) {
+	SerialPollField f;
+	if (!p.field(p.findField(name), f) || !f.set) return "<unset>";
+	return f.value;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_poll_parses_fields_and_reports_changes() {
+	Probe probe;
+	SerialPoller p(probeSend, probeUpdate, &probe);
+	SerialPollerConfig cfg = emptyConfig();
+	addPoll(cfg, "env", "ENV?\r\n", "T=(-?\\d+\\.\\d) H=(\\d+)", {"temp", "hum"});
+	char err[64];
+	TEST_ASSERT_TRUE_MESSAGE(SerialPoller::validate(cfg, err, sizeof(err)), err);
+	p.configure(cfg, 0);
+
+	TEST_ASSERT_EQUAL_UINT32(200, p.service(0, true));
+	TEST_ASSERT_EQUAL(1, probe.sent.size());
+	TEST_ASSERT_EQUAL_STRING("ENV?\r\n", probe.sent[0].c_str());
+
+	// Fremde Zeilen sind keine Antwort
+	TEST_ASSERT_FALSE(reply(p, "READY", 10));
+	TEST_ASSERT_TRUE(reply(p, "T=21.5 H=40", 20));
+	TEST_ASSERT_EQUAL(1, probe.updates.size());
+	TEST_ASSERT_EQUAL_HEX32(0x3, probe.updates[0]);
+	TEST_ASSERT_EQUAL_STRING("21.5", value(p, "temp").c_str());
+	TEST_ASSERT_EQUAL_STRING("40", value(p, "hum").c_str());
+
+	// Ohne wartende Abfrage wird nichts ausgewertet
+	TEST_ASSERT_FALSE(reply(p, "T=99.9 H=99", 30));
+	TEST_ASSERT_EQUAL_UINT32(980, p.service(20, true));
+
+	// Nächster Zyklus: nur die Feuchte ändert sich
+	p.service(1020, true);
+	TEST_ASSERT_EQUAL(2, probe.sent.size());
+	TEST_ASSERT_TRUE(reply(p, "T=21.5 H=41", 1030));
+	TEST_ASSERT_EQUAL(2, probe.updates.size());
+	TEST_ASSERT_EQUAL_HEX32(0x2, probe.updates[1]);
+
+	// Unveränderte Antwort meldet nichts
+	p.service(2030, true);
+	TEST_ASSERT_TRUE(reply(p, "T=21.5 H=41", 2040));
+	TEST_ASSERT_EQUAL(2, probe.updates.size());
+
+	SerialPollStats st;
+	TEST_ASSERT_TRUE(p.stats(0, st));
+	TEST_ASSERT_EQUAL_UINT32(3, st.requests);
+	TEST_ASSERT_EQUAL_UINT32(3, st.replies);
+	TEST_ASSERT_EQUAL_UINT32(10, st.lastRttMs);
+}
+
+void test_one_request_in_flight_and_fair_order() {
+	Probe probe;
+	SerialPoller p(probeSend, probeUpdate, &probe);
+	SerialPollerConfig cfg = emptyConfig();
+	addPoll(cfg, "a", "A?\n", "A=(\\d+)", {"a"}, 500);
+	addPoll(cfg, "b", "B?\n", "B=(\\d+)", {"b"}, 500);
+	p.configure(cfg, 0);
+
+	p.service(0, true);
+	TEST_ASSERT_EQUAL(1, probe.sent.size());
+	// "b" ist fällig, wartet aber auf die Antwort von "a"
+	p.service(5, true);
+	TEST_ASSERT_EQUAL(1, probe.sent.size());
+	TEST_ASSERT_FALSE(reply(p, "B=2", 6));
+	TEST_ASSERT_TRUE(reply(p, "A=1", 10));
+	p.service(10, true);
+	TEST_ASSERT_EQUAL(2, probe.sent.size());
+	TEST_ASSERT_EQUAL_STRING("B?\n", probe.sent[1].c_str());
+	TEST_ASSERT_TRUE(reply(p, "B=2", 15));
+	// Beide erst nach dem Intervall wieder
+	TEST_ASSERT_EQUAL_UINT32(485, p.service(15, true));
+	p.service(500, true);
+	TEST_ASSERT_EQUAL_STRING("A?\n", probe.sent[2].c_str());
+}
+
+void test_timeout_marks_fields_stale_until_next_reply() {
+	Probe probe;
+	SerialPoller p(probeSend, probeUpdate, &probe);
+	SerialPollerConfig cfg = emptyConfig();
+	addPoll(cfg, "v", "V?\n", "V=(\\w+)", {"v"}, 1000, 100);
+	p.configure(cfg, 0);
+
+	p.service(0, true);
+	reply(p, "V=on", 5);
+	p.service(1000, true);
+	p.service(1100, true);
+	SerialPollField f;
+	p.field(0, f);
+	TEST_ASSERT_TRUE(f.stale);
+	TEST_ASSERT_EQUAL_STRING("on", f.value);
+	TEST_ASSERT_EQUAL(2, probe.updates.size());
+
+	// Zweiter Timeout meldet nicht erneut
+	p.service(2000, true);
+	p.service(2100, true);
+	TEST_ASSERT_EQUAL(2, probe.updates.size());
+
+	// Gleicher Wert, aber nicht mehr veraltet: wird gemeldet
+	p.service(3100, true);
+	TEST_ASSERT_TRUE(reply(p, "V=on", 3110));
+	TEST_ASSERT_EQUAL(3, probe.updates.size());
+	p.field(0, f);
+	TEST_ASSERT_FALSE(f.stale);
+
+	SerialPollStats st;
+	p.stats(0, st);
+	TEST_ASSERT_EQUAL_UINT32(2, st.timeouts);
+}
+
+void test_paused_and_send_backpressure() {
+	Probe probe;
+	SerialPoller p(probeSend, probeUpdate, &probe);
+	SerialPollerConfig cfg = emptyConfig();
+	addPoll(cfg, "v", "V?\n", "V=(\\w+)", {"v"});
+	p.configure(cfg, 0);
+
+	TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, p.service(0, false));
+	TEST_ASSERT_EQUAL(0, probe.sent.size());
+	probe.accept = false;
+	TEST_ASSERT_EQUAL_UINT32(SerialPoller::SEND_RETRY_MS, p.service(10, true));
+	probe.accept = true;
+	p.service(20, true);
+	TEST_ASSERT_EQUAL(1, probe.sent.size());
+
+	SerialPoller off(probeSend, probeUpdate, &probe);
+	TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, off.service(0, true));
+}
+
+void test_reconfigure_keeps_fields_by_name() {
+	Probe probe;
+	SerialPoller p(probeSend, probeUpdate, &probe);
+	SerialPollerConfig cfg = emptyConfig();
+	addPoll(cfg, "env", "ENV?\n", "T=(\\d+) H=(\\d+)", {"temp", "hum"});
+	p.configure(cfg, 0);
+	p.service(0, true);
+	reply(p, "T=20 H=50", 5);
+
+	SerialPollerConfig next = emptyConfig();
+	addPoll(next, "t", "T?\n", "T=(\\d+)", {"temp"});
+	addPoll(next, "p", "P?\n", "P=(\\d+)", {"pressure"});
+	p.configure(next, 100);
+	TEST_ASSERT_EQUAL(2, p.fieldCount());
+	TEST_ASSERT_EQUAL(0, p.findField("temp"));
+	TEST_ASSERT_EQUAL(SerialPoller::NO_FIELD, p.findField("hum"));
+	TEST_ASSERT_EQUAL_STRING("20", value(p, "temp").c_str());
+	TEST_ASSERT_EQUAL_STRING("<unset>", value(p, "pressure").c_str());
+}
+
+void test_validate() {
+	char err[64];
+	SerialPollerConfig cfg = emptyConfig();
+	TEST_ASSERT_TRUE(SerialPoller::validate(cfg, err, sizeof(err)));
+
+	addPoll(cfg, "x", "X?\n", "X=(\\d+", {"x"});
+	TEST_ASSERT_FALSE(SerialPoller::validate(cfg, err, sizeof(err)));
+	TEST_ASSERT_EQUAL_STRING_LEN("x: ", err, 3);
+
+	cfg = emptyConfig();
+	addPoll(cfg, "x", "X?\n", "X=\\d+", {"x"});
+	TEST_ASSERT_FALSE(SerialPoller::validate(cfg, err, sizeof(err)));
+	TEST_ASSERT_EQUAL_STRING("x: Mehr Felder als Gruppen", err);
+
+	cfg = emptyConfig();
+	addPoll(cfg, "x", "X?\n", "X=(\\d+)", {"x"}, 50);
+	TEST_ASSERT_FALSE(SerialPoller::validate(cfg, err, sizeof(err)));
+
+	cfg = emptyConfig();
+	addPoll(cfg, "x", "", "X=(\\d+)", {"x"});
+	TEST_ASSERT_FALSE(SerialPoller::validate(cfg, err, sizeof(err)));
+
+	cfg = emptyConfig();
+	addPoll(cfg, "x", "X?\n", "X=(\\d+)", {"x"});
+	addPoll(cfg, "x", "Y?\n", "Y=(\\d+)", {"y"});
+	TEST_ASSERT_FALSE(SerialPoller::validate(cfg, err, sizeof(err)));
+	TEST_ASSERT_EQUAL_STRING("x: Name doppelt", err);
+
+	// Gemeinsame Felder zählen einmal, mehr als MAX_FIELDS verschiedene nicht
+	cfg = emptyConfig();
+	static char names[40][8];
+	for (size_t i = 0; i < 5; ++i) {
+		std::vector<const char *> fields;
+		for (size_t k = 0; k < 7; ++k) {
+			snprintf(names[i * 7 + k], sizeof(names[0]), "f%u", (unsigned)(i * 7 + k));
+			fields.push_back(names[i * 7 + k]);
+		}
+		char pname[8];
+		snprintf(pname, sizeof(pname), "p%u", (unsigned)i);
+		addPoll(cfg, pname, "Q\n", "(a)(b)(c)(d)(e)(f)(g)", fields);
+	}
+	TEST_ASSERT_FALSE(SerialPoller::validate(cfg, err, sizeof(err)));
+	TEST_ASSERT_EQUAL_STRING("Zu viele Felder", err);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_poll_parses_fields_and_reports_changes);
+	RUN_TEST(test_one_request_in_flight_and_fair_order);
+	RUN_TEST(test_timeout_marks_fields_stale_until_next_reply);
+	RUN_TEST(test_paused_and_send_backpressure);
+	RUN_TEST(test_reconfigure_keeps_fields_by_name);
+	RUN_TEST(test_validate);
+	return UNITY_END();
+}
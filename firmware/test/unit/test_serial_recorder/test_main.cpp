@@ -0,0 +1,219 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für den Mitschnitt der seriellen Schnittstelle (SerialRecorder).
+ */
+
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "FakeCaptureStore.h"
+#include "SerialRecorder.h"
+
+struct Record {
+	CaptureRecordHeader hdr;
+	std::string data;
+};
+
+/**
+ * @brief Zerlegt eine Mitschnittdatei in Datensätze.
+ */
+static std::vector<Record> parse(const std::string &file) {
+	std::vector<Record> out;
+	TEST_ASSERT_TRUE(file.size() >= CAPTURE_FILE_HEADER_LEN);
+	TEST_ASSERT_EQUAL(0, memcmp(file.data(), "HTCP", 4));
+	TEST_ASSERT_EQUAL(CAPTURE_VERSION, (uint8_t)file[4]);
+	size_t pos = CAPTURE_FILE_HEADER_LEN;
+	while (pos < file.size()) {
+		Record r;
+		TEST_ASSERT_TRUE(decodeCaptureRecordHeader((const uint8_t *)file.data() + pos, file.size() - pos, r.hdr));
+		pos += CAPTURE_RECORD_HEADER_LEN;
+		TEST_ASSERT_TRUE(pos + r.hdr.len <= file.size());
+		r.data = file.substr(pos, r.hdr.len);
+		pos += r.hdr.len;
+		out.push_back(r);
+	}
+	return out;
+}
+
+static SerialRecorderConfig defaults() {
+	SerialRecorderConfig cfg;
+	cfg.maxFileBytes = SerialRecorder::DEFAULT_MAX_FILE_BYTES;
+	cfg.maxFileAgeMs = SerialRecorder::DEFAULT_MAX_FILE_AGE_MS;
+	cfg.quotaBytes = SerialRecorder::DEFAULT_QUOTA_BYTES;
+	return cfg;
+}
+
+/**
+ * @brief Hängt einen Datensatz an; `ms` wird wie auf dem Gerät als µs-Zeitstempel übergeben.
+ */
+static void add(SerialRecorder &rec, CaptureDirection dir, const std::string &s, uint32_t ms) {
+	rec.append(dir, (const uint8_t *)s.data(), s.size(), (uint64_t)ms * 1000);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_records_rx_and_tx_with_timestamps() {
+	FakeCaptureStore store;
+	SerialRecorder rec(store);
+	TEST_ASSERT_FALSE(rec.append(CAPTURE_RX, (const uint8_t *)"x", 1, 0));  // nicht aktiv
+
+	TEST_ASSERT_TRUE(rec.start("bench1", defaults(), 1700000000));
+	TEST_ASSERT_FALSE(rec.start("bench2", defaults(), 0));  // läuft bereits
+	rec.service(100);
+	TEST_ASSERT_EQUAL_STRING("bench1.cap", store.current().c_str());
+
+	add(rec, CAPTURE_TX, "STATUS\r\n", 110);
+	TEST_ASSERT_TRUE(rec.append(CAPTURE_RX, (const uint8_t *)"OK\r\n\0\xff", 6, 125000123ULL));
+	TEST_ASSERT_EQUAL(1, store.writes);  // bisher nur der Dateikopf
+
+	rec.stop();
+	TEST_ASSERT_FALSE(rec.append(CAPTURE_RX, (const uint8_t *)"late", 4, 130));
+	TEST_ASSERT_EQUAL(UINT32_MAX, rec.service(130));
+	TEST_ASSERT_FALSE(rec.active());
+	TEST_ASSERT_EQUAL_STRING("", store.current().c_str());
+
+	auto recs = parse(store.files["bench1.cap"]);
+	TEST_ASSERT_EQUAL(2, recs.size());
+	TEST_ASSERT_EQUAL(CAPTURE_TX, recs[0].hdr.dir);
+	TEST_ASSERT_TRUE(recs[0].hdr.timestamp == 110000);
+	TEST_ASSERT_EQUAL(0, recs[0].hdr.seq);
+	TEST_ASSERT_EQUAL_STRING("STATUS\r\n", recs[0].data.c_str());
+	TEST_ASSERT_EQUAL(CAPTURE_RX, recs[1].hdr.dir);
+	TEST_ASSERT_EQUAL(6, recs[1].data.size());
+	TEST_ASSERT_TRUE(recs[1].hdr.timestamp == 125000123ULL);
+	TEST_ASSERT_EQUAL(1, recs[1].hdr.seq);
+}
+
+void test_full_buffer_is_written_in_one_block_and_overrun_marks_gap() {
+	FakeCaptureStore store;
+	SerialRecorder rec(store);
+	rec.start("load", defaults(), 0);
+	rec.service(0);
+	size_t headerWrites = store.writes;
+
+	std::string chunk(240, 'a');  // 256 Bytes pro Datensatz, 16 passen in einen Puffer
+	for (int i = 0; i < 16; ++i) TEST_ASSERT_TRUE(rec.append(CAPTURE_RX, (const uint8_t *)chunk.data(), chunk.size(), i * 1000ULL));
+	// Der 17. Datensatz schaltet um, der erste Puffer wartet auf die Schreib-Task
+	for (int i = 16; i < 32; ++i) TEST_ASSERT_TRUE(rec.append(CAPTURE_RX, (const uint8_t *)chunk.data(), chunk.size(), i * 1000ULL));
+	// Beide Puffer voll: verwerfen statt blockieren
+	TEST_ASSERT_FALSE(rec.append(CAPTURE_RX, (const uint8_t *)chunk.data(), chunk.size(), 32000));
+	TEST_ASSERT_EQUAL(1, rec.stats().dropped);
+
+	rec.service(40);
+	TEST_ASSERT_EQUAL(headerWrites + 1, store.writes);
+	TEST_ASSERT_EQUAL(CAPTURE_FILE_HEADER_LEN + SerialRecorder::BLOCK, store.files["load.cap"].size());
+
+	TEST_ASSERT_TRUE(rec.append(CAPTURE_RX, (const uint8_t *)"z", 1, 41000));
+	rec.stop();
+	rec.service(50);
+	auto recs = parse(store.files["load.cap"]);
+	TEST_ASSERT_EQUAL(33, recs.size());
+	TEST_ASSERT_EQUAL(CAPTURE_FLAG_GAP, recs[32].hdr.flags);
+	TEST_ASSERT_EQUAL(CAPTURE_FLAG_NONE, recs[31].hdr.flags);
+	TEST_ASSERT_EQUAL(31, recs[31].hdr.seq);
+	TEST_ASSERT_EQUAL(33, recs[32].hdr.seq);  // Nummer 32 wurde verworfen
+}
+
+void test_partial_buffer_is_flushed_after_interval() {
+	FakeCaptureStore store;
+	SerialRecorder rec(store);
+	rec.start("idle", defaults(), 0);
+	rec.service(1000);
+	add(rec, CAPTURE_RX, "ping\r\n", 1000);
+	uint32_t wait = rec.service(1500);
+	TEST_ASSERT_EQUAL(SerialRecorder::FLUSH_INTERVAL_MS - 500, wait);
+	TEST_ASSERT_EQUAL(CAPTURE_FILE_HEADER_LEN, store.files["idle.cap"].size());
+	TEST_ASSERT_EQUAL(UINT32_MAX, rec.service(1000 + SerialRecorder::FLUSH_INTERVAL_MS));
+	TEST_ASSERT_EQUAL(1, parse(store.files["idle.cap"]).size());
+}
+
+void test_rotates_by_size_and_age() {
+	FakeCaptureStore store;
+	SerialRecorder rec(store);
+	SerialRecorderConfig cfg = defaults();
+	cfg.maxFileBytes = CAPTURE_FILE_HEADER_LEN + SerialRecorder::BLOCK;
+	rec.start("rot", cfg, 0);
+	rec.service(0);
+
+	std::string chunk(240, 'b');
+	for (uint32_t t = 0; t < 33; ++t) {
+		rec.append(CAPTURE_RX, (const uint8_t *)chunk.data(), chunk.size(), (uint64_t)t * 1000);
+		rec.service(t);
+	}
+	TEST_ASSERT_EQUAL(cfg.maxFileBytes, store.files["rot.cap"].size());
+	TEST_ASSERT_EQUAL(cfg.maxFileBytes, store.files["rot.1.cap"].size());
+	TEST_ASSERT_EQUAL(2, rec.stats().segments);
+	TEST_ASSERT_EQUAL_STRING("rot.1.cap", rec.segmentName());
+
+	// Altersgrenze: nach 60 s beginnt auch ein kleines Segment neu
+	SerialRecorder aged(store);
+	cfg = defaults();
+	cfg.maxFileAgeMs = 60000;
+	aged.start("age", cfg, 0);
+	aged.service(0);
+	add(aged, CAPTURE_RX, "tick", 100);
+	aged.service(100 + SerialRecorder::FLUSH_INTERVAL_MS);
+	add(aged, CAPTURE_RX, "tock", 70000);
+	aged.service(70000 + SerialRecorder::FLUSH_INTERVAL_MS);
+	TEST_ASSERT_EQUAL_STRING("age.1.cap", aged.segmentName());
+	TEST_ASSERT_EQUAL(CAPTURE_FILE_HEADER_LEN + 20, store.files["age.cap"].size());
+	TEST_ASSERT_EQUAL(CAPTURE_FILE_HEADER_LEN + 20, store.files["age.1.cap"].size());
+}
+
+void test_quota_deletes_oldest_but_never_current_segment() {
+	FakeCaptureStore store;
+	store.files["old-a.cap"] = std::string(7000, 'x');
+	store.order.push_back("old-a.cap");
+	store.files["old-b.cap"] = std::string(7000, 'y');
+	store.order.push_back("old-b.cap");
+
+	SerialRecorder rec(store);
+	SerialRecorderConfig cfg = defaults();
+	cfg.maxFileBytes = 8192;
+	cfg.quotaBytes = 16384;
+	TEST_ASSERT_TRUE(rec.start("q", cfg, 0));
+	rec.service(0);
+
+	std::string chunk(240, 'c');
+	for (int i = 0; i < 17; ++i) rec.append(CAPTURE_RX, (const uint8_t *)chunk.data(), chunk.size(), i * 1000ULL);
+	rec.service(20);
+	TEST_ASSERT_EQUAL(1, store.removed.size());
+	TEST_ASSERT_EQUAL_STRING("old-a.cap", store.removed[0].c_str());
+	TEST_ASSERT_TRUE(store.usedBytes() <= cfg.quotaBytes);
+
+	// Schreibfehler beendet den Mitschnitt mit Fehlermeldung
+	store.failWrites = true;
+	rec.stop();
+	rec.service(30);
+	TEST_ASSERT_FALSE(rec.active());
+	TEST_ASSERT_EQUAL_STRING("Schreibfehler", rec.lastError());
+}
+
+void test_rejects_invalid_session_and_config() {
+	SerialRecorderConfig cfg = defaults();
+	TEST_ASSERT_TRUE(SerialRecorder::validate("line_3-night", cfg));
+	TEST_ASSERT_FALSE(SerialRecorder::validate("", cfg));
+	TEST_ASSERT_FALSE(SerialRecorder::validate("../system/info", cfg));
+	TEST_ASSERT_FALSE(SerialRecorder::validate("a.cap", cfg));
+	TEST_ASSERT_FALSE(SerialRecorder::validate("abcdefghijabcdefghijabcdefghijabc", cfg));
+	cfg.quotaBytes = cfg.maxFileBytes;
+	TEST_ASSERT_FALSE(SerialRecorder::validate("ok", cfg));
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_records_rx_and_tx_with_timestamps);
+	RUN_TEST(test_full_buffer_is_written_in_one_block_and_overrun_marks_gap);
+	RUN_TEST(test_partial_buffer_is_flushed_after_interval);
+	RUN_TEST(test_rotates_by_size_and_age);
+	RUN_TEST(test_quota_deletes_oldest_but_never_current_segment);
+	RUN_TEST(test_rejects_invalid_session_and_config);
+	return UNITY_END();
+}
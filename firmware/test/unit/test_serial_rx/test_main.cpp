@@ -0,0 +1,108 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für den Empfangspfad der SerialBridge (SerialRxPump).
+ *
+ * Vergleicht den alten 5-ms-Polling-Pfad mit dem ereignisgesteuerten Pfad an einer
+ * Fake-UART: Anzahl der Aufwachvorgänge und Latenz vom Eintreffen einer Zeile bis zur
+ * Verarbeitung durch die Bridge.
+ */
+
+#include <unity.h>
+
+#include <cstdio>
+#include <vector>
+
+#include "FakeUart.h"
+#include "SerialRxPump.h"
+
+struct RunResult {
+	uint32_t wakeups;
+	uint32_t lines;
+	double avgLatencyMs;
+	uint32_t maxLatencyMs;
+};
+
+/**
+ * @brief Spielt eine Sekunde Geräteverkehr mit sporadischen Zeilen durch den Empfangspfad.
+ */
+static RunResult runScenario(SerialRxMode mode) {
+	FakeUart uart;
+	SerialRxPump pump(uart, mode);
+
+	// 20 Zeilen mit unregelmäßigen Abständen (teilweise "krumme" Zeitpunkte)
+	std::vector<uint32_t> arrivals;
+	uint32_t t = 3;
+	for (int i = 0; i < 20; ++i) {
+		t += 17 + (i * 13) % 41;
+		arrivals.push_back(t);
+		uart.schedule(t, "TEMP=42.0 OK\n");
+	}
+
+	RunResult r{0, 0, 0.0, 0};
+	uint64_t latencySum = 0;
+	uint8_t buf[64];
+	while (uart.clock < 1000) {
+		size_t n = pump.wait(buf, sizeof(buf), 250);
+		for (size_t i = 0; i < n; ++i) {
+			if (buf[i] != '\n') continue;
+			uint32_t latency = uart.now() - arrivals[r.lines];
+			latencySum += latency;
+			if (latency > r.maxLatencyMs) r.maxLatencyMs = latency;
+			r.lines++;
+		}
+	}
+	r.wakeups = pump.stats().wakeups;
+	r.avgLatencyMs = r.lines ? (double)latencySum / r.lines : 0.0;
+	return r;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_event_mode_wakes_less_and_is_faster() {
+	RunResult poll = runScenario(SERIAL_RX_POLLING);
+	RunResult evt = runScenario(SERIAL_RX_EVENT);
+
+	printf("[serial_rx] polling: %u wakeups, avg latency %.2f ms, max %u ms\n", poll.wakeups, poll.avgLatencyMs, poll.maxLatencyMs);
+	printf("[serial_rx] event:   %u wakeups, avg latency %.2f ms, max %u ms\n", evt.wakeups, evt.avgLatencyMs, evt.maxLatencyMs);
+
+	TEST_ASSERT_EQUAL_UINT32(20, poll.lines);
+	TEST_ASSERT_EQUAL_UINT32(20, evt.lines);
+	TEST_ASSERT_LESS_THAN_UINT32(poll.wakeups / 4, evt.wakeups);
+	TEST_ASSERT_TRUE(evt.avgLatencyMs < poll.avgLatencyMs);
+	TEST_ASSERT_EQUAL_UINT32(0, evt.maxLatencyMs);
+}
+
+void test_overflow_flushes_input() {
+	FakeUart uart;
+	SerialRxPump pump(uart, SERIAL_RX_EVENT);
+	uart.injected.push_back(RX_EVT_FIFO_OVERFLOW);
+
+	uint8_t buf[16];
+	TEST_ASSERT_EQUAL(0, pump.wait(buf, sizeof(buf), 10));
+	TEST_ASSERT_EQUAL(RX_EVT_FIFO_OVERFLOW, pump.lastEvent());
+	TEST_ASSERT_EQUAL_UINT32(1, pump.stats().overflows);
+
+	// Danach läuft der Empfang normal weiter
+	uart.schedule(5, "ok\n");
+	TEST_ASSERT_EQUAL(3, pump.wait(buf, sizeof(buf), 10));
+	TEST_ASSERT_EQUAL(RX_EVT_PATTERN, pump.lastEvent());
+}
+
+void test_rx_buffer_scales_with_baud() {
+	TEST_ASSERT_EQUAL(1024, SerialRxPump::rxBufferSizeFor(9600));
+	TEST_ASSERT_EQUAL(2048, SerialRxPump::rxBufferSizeFor(115200));
+	TEST_ASSERT_EQUAL(16384, SerialRxPump::rxBufferSizeFor(921600));
+	TEST_ASSERT_EQUAL(16384, SerialRxPump::rxBufferSizeFor(4000000));
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_event_mode_wakes_less_and_is_faster);
+	RUN_TEST(test_overflow_flushes_input);
+	RUN_TEST(test_rx_buffer_scales_with_baud);
+	return UNITY_END();
+}
@@ -0,0 +1,267 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für Befehlsskripte (SerialScript, SerialScriptEngine) gegen ein Gerät
+ *        mit festem Antwortverhalten.
+ */
+
+#include <unity.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "ScriptedDevice.h"
+#include "SerialScriptEngine.h"
+
+struct Harness {
+	ScriptedDevice dev;
+	uint32_t now = 0;
+	bool txFull = false;
+	std::vector<SerialScriptResult> results;
+	SerialScriptEngine engine{send, done, this};
+
+	static bool send(void *ctx, const uint8_t *data, size_t len) {
+		auto *h = static_cast<Harness *>(ctx);
+		if (h->txFull) return false;
+		h->dev.write(data, len, h->now);
+		return true;
+	}
+	static void done(void *ctx, const SerialScriptResult &result) {
+		static_cast<Harness *>(ctx)->results.push_back(result);
+	}
+
+	uint32_t submit(const std::string &source) {
+		return engine.submit(42, "test", source.data(), source.size());
+	}
+
+	/**
+	 * @brief Lässt die virtuelle Uhr laufen, bis ein Ergebnis vorliegt (höchstens maxMs).
+	 */
+	const SerialScriptResult &run(const std::string &source, uint32_t maxMs = 10000) {
+		size_t before = results.size();
+		TEST_ASSERT_NOT_EQUAL(0, submit(source));
+		for (uint32_t end = now + maxMs; now < end && results.size() == before; ++now) {
+			dev.deliver(now, engine);
+			engine.poll(now);
+		}
+		TEST_ASSERT_EQUAL(before + 1, results.size());
+		return results.back();
+	}
+};
+
+static const char *field(const SerialScriptResult &r, const char *name) {
+	for (size_t i = 0; i < r.fieldCount; ++i) {
+		if (std::string(r.fields[i].name) == name) return r.fields[i].set ? r.fields[i].value : "<unset>";
+	}
+	return "<missing>";
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_query_captures_fields() {
+	Harness h;
+	h.dev.on("VER?", "VER 2.17\r\n", 20);
+	const SerialScriptResult &r = h.run(
+	    "# Version abfragen\n"
+	    "send \"VER?\\r\\n\"\n"
+	    "expect /VER (\\d+)\\.(\\d+)/ 500 major minor\n"
+	    "done\n");
+	TEST_ASSERT_EQUAL(SCRIPT_OK, r.status);
+	TEST_ASSERT_EQUAL_STRING("2", field(r, "major"));
+	TEST_ASSERT_EQUAL_STRING("17", field(r, "minor"));
+	TEST_ASSERT_EQUAL_STRING("VER?\r\n", h.dev.received.c_str());
+	TEST_ASSERT_EQUAL(42, r.client);
+	TEST_ASSERT_EQUAL_STRING("test", r.name);
+	TEST_ASSERT_EQUAL(6, r.sentBytes);
+	TEST_ASSERT_EQUAL(10, r.rxBytes);
+	TEST_ASSERT_TRUE(r.elapsedMs >= 20 && r.elapsedMs < 30);
+}
+
+static const char *RETRY_SCRIPT =
+    "start:\n"
+    "  send \"PING\\n\"\n"
+    "  expect \"PONG\" 100 else again\n"
+    "  done\n"
+    "again:\n"
+    "  retry start 3   # höchstens drei Wiederholungen\n"
+    "  fail \"keine Antwort\"\n";
+
+void test_retry_until_answer() {
+	Harness h;
+	h.dev.on("PING", "PONG\r\n", 5, 2);
+	const SerialScriptResult &r = h.run(RETRY_SCRIPT);
+	TEST_ASSERT_EQUAL(SCRIPT_OK, r.status);
+	TEST_ASSERT_EQUAL_STRING("PING\nPING\nPING\n", h.dev.received.c_str());
+}
+
+void test_retry_exhausted_fails_with_message() {
+	Harness h;
+	h.dev.on("PING", "PONG\r\n", 5, 10);
+	const SerialScriptResult &r = h.run(RETRY_SCRIPT);
+	TEST_ASSERT_EQUAL(SCRIPT_FAILED, r.status);
+	TEST_ASSERT_EQUAL_STRING("keine Antwort", r.message);
+	TEST_ASSERT_EQUAL(4, std::count(h.dev.received.begin(), h.dev.received.end(), '\n'));
+	TEST_ASSERT_EQUAL(7, r.line);
+}
+
+void test_branch_on_captured_field() {
+	Harness h;
+	h.dev.on("SET 1", "ERROR 7\r\n");
+	h.dev.on("SET 2", "OK\r\n");
+	const char *script =
+	    "send \"SET 1\\r\"\n"
+	    "expect /OK|ERROR (\\d+)/ 200 code\n"
+	    "if code \"7\" locked\n"
+	    "if code bad\n"
+	    "send \"SET 2\\r\"\n"
+	    "expect /OK|ERROR (\\d+)/ 200 code\n"
+	    "if code bad\n"
+	    "done\n"
+	    "locked:\n"
+	    "  fail \"gesperrt\"\n"
+	    "bad:\n"
+	    "  fail \"Fehler\"\n";
+	const SerialScriptResult &r = h.run(script);
+	TEST_ASSERT_EQUAL(SCRIPT_FAILED, r.status);
+	TEST_ASSERT_EQUAL_STRING("gesperrt", r.message);
+	TEST_ASSERT_EQUAL_STRING("7", field(r, "code"));
+}
+
+void test_unset_group_clears_field() {
+	Harness h;
+	h.dev.on("A", "ERROR 3\r\n");
+	h.dev.on("B", "OK\r\n");
+	const SerialScriptResult &r = h.run(
+	    "send \"A\\n\"\n"
+	    "expect /OK|ERROR (\\d+)/ 200 code\n"
+	    "send \"B\\n\"\n"
+	    "expect /OK|ERROR (\\d+)/ 200 code\n"
+	    "if code bad\n"
+	    "done\n"
+	    "bad:\n"
+	    "fail\n");
+	TEST_ASSERT_EQUAL(SCRIPT_OK, r.status);
+	TEST_ASSERT_EQUAL_STRING("<unset>", field(r, "code"));
+}
+
+void test_timeout_reports_unmatched_tail() {
+	Harness h;
+	h.dev.on("STATUS", "busy, try later\r\n");
+	const SerialScriptResult &r = h.run("send \"STATUS\\n\"\nexpect \"READY\" 50\n");
+	TEST_ASSERT_EQUAL(SCRIPT_TIMEOUT, r.status);
+	TEST_ASSERT_EQUAL(2, r.line);
+	TEST_ASSERT_EQUAL_STRING("busy, try later\r\n", r.tail);
+	TEST_ASSERT_TRUE(r.elapsedMs >= 50 && r.elapsedMs < 60);
+}
+
+void test_match_consumes_window_in_order() {
+	Harness h;
+	h.dev.on("DUMP", "T=21\r\nH=40\r\nT=22\r\n");
+	const SerialScriptResult &r = h.run(
+	    "send \"DUMP\\n\"\n"
+	    "expect /T=(\\d+)/ 100 first\n"
+	    "expect /H=(\\d+)/ 100 hum\n"
+	    "expect /T=(\\d+)/ 100 second\n");
+	TEST_ASSERT_EQUAL(SCRIPT_OK, r.status);
+	TEST_ASSERT_EQUAL_STRING("21", field(r, "first"));
+	TEST_ASSERT_EQUAL_STRING("40", field(r, "hum"));
+	TEST_ASSERT_EQUAL_STRING("22", field(r, "second"));
+}
+
+void test_wait_and_flush_drop_earlier_output() {
+	Harness h;
+	h.dev.emit(5, "OK stale\r\n");
+	h.dev.on("GO", "OK fresh\r\n");
+	const SerialScriptResult &r = h.run(
+	    "wait 20\n"
+	    "flush\n"
+	    "send \"GO\\n\"\n"
+	    "expect /OK (\\w+)/ 100 word\n");
+	TEST_ASSERT_EQUAL(SCRIPT_OK, r.status);
+	TEST_ASSERT_EQUAL_STRING("fresh", field(r, "word"));
+}
+
+void test_parse_errors_report_line() {
+	Harness h;
+	const SerialScriptResult &a = h.run("send \"x\"\nbogus\n");
+	TEST_ASSERT_EQUAL(SCRIPT_ERROR, a.status);
+	TEST_ASSERT_EQUAL_STRING("Zeile 2: Unbekannter Befehl", a.message);
+
+	const SerialScriptResult &b = h.run("goto nowhere\n");
+	TEST_ASSERT_EQUAL(SCRIPT_ERROR, b.status);
+	TEST_ASSERT_EQUAL_STRING("Zeile 1: Sprungmarke nicht definiert", b.message);
+
+	const SerialScriptResult &c = h.run("\n\nexpect /(a/ 10\n");
+	TEST_ASSERT_EQUAL(SCRIPT_ERROR, c.status);
+	TEST_ASSERT_EQUAL_STRING("Zeile 3: Klammer ')' fehlt", c.message);
+
+	const SerialScriptResult &d = h.run("send \"unterminated\n");
+	TEST_ASSERT_EQUAL_STRING("Zeile 1: Anführungszeichen fehlt", d.message);
+	TEST_ASSERT_EQUAL_STRING("", h.dev.received.c_str());
+}
+
+void test_endless_loop_hits_step_limit() {
+	Harness h;
+	const SerialScriptResult &r = h.run("top:\ngoto top\n");
+	TEST_ASSERT_EQUAL(SCRIPT_ERROR, r.status);
+	TEST_ASSERT_EQUAL_STRING("Schrittlimit erreicht", r.message);
+	TEST_ASSERT_EQUAL(SerialScriptEngine::MAX_EXECUTED, r.steps);
+}
+
+void test_busy_cancel_and_send_backpressure() {
+	Harness h;
+	h.txFull = true;
+	uint32_t a = h.submit("send \"X\\n\"\nexpect \"Y\" 1000\n");
+	TEST_ASSERT_NOT_EQUAL(0, a);
+	TEST_ASSERT_EQUAL(10, h.engine.poll(0));  // Sendewarteschlange voll: später erneut
+	uint32_t b = h.submit("done\n");
+	TEST_ASSERT_NOT_EQUAL(0, b);
+	TEST_ASSERT_EQUAL(0, h.submit("done\n"));  // nur ein wartender Auftrag
+	TEST_ASSERT_EQUAL(1, h.engine.stats().rejected);
+
+	h.txFull = false;
+	h.engine.poll(10);
+	TEST_ASSERT_EQUAL_STRING("X\n", h.dev.received.c_str());
+	TEST_ASSERT_TRUE(h.engine.cancel(a));
+	h.engine.poll(11);
+	TEST_ASSERT_EQUAL(1, h.results.size());
+	TEST_ASSERT_EQUAL(SCRIPT_CANCELLED, h.results[0].status);
+	TEST_ASSERT_EQUAL(a, h.results[0].job);
+
+	// Der wartende Auftrag startet danach
+	h.engine.poll(12);
+	TEST_ASSERT_EQUAL(2, h.results.size());
+	TEST_ASSERT_EQUAL(b, h.results[1].job);
+	TEST_ASSERT_EQUAL(SCRIPT_OK, h.results[1].status);
+	TEST_ASSERT_FALSE(h.engine.busy());
+	TEST_ASSERT_EQUAL(UINT32_MAX, h.engine.poll(13));
+	TEST_ASSERT_FALSE(h.engine.cancel(0));
+}
+
+void test_rx_ignored_while_idle() {
+	Harness h;
+	TEST_ASSERT_FALSE(h.engine.onRx((const uint8_t *)"READY\r\n", 7));
+	const SerialScriptResult &r = h.run("expect \"READY\" 20\n");
+	TEST_ASSERT_EQUAL(SCRIPT_TIMEOUT, r.status);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_query_captures_fields);
+	RUN_TEST(test_retry_until_answer);
+	RUN_TEST(test_retry_exhausted_fails_with_message);
+	RUN_TEST(test_branch_on_captured_field);
+	RUN_TEST(test_unset_group_clears_field);
+	RUN_TEST(test_timeout_reports_unmatched_tail);
+	RUN_TEST(test_match_consumes_window_in_order);
+	RUN_TEST(test_wait_and_flush_drop_earlier_output);
+	RUN_TEST(test_parse_errors_report_line);
+	RUN_TEST(test_endless_loop_hits_step_limit);
+	RUN_TEST(test_busy_cancel_and_send_backpressure);
+	RUN_TEST(test_rx_ignored_while_idle);
+	return UNITY_END();
+}
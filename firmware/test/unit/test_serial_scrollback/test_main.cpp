@@ -0,0 +1,113 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für den Verlaufspuffer der SerialBridge (SerialScrollback).
+ */
+
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "SerialScrollback.h"
+
+static uint8_t mem[1024];
+
+static void fill(SerialScrollback &sb, uint32_t from, uint32_t to) {
+	for (uint32_t seq = from; seq < to; ++seq) {
+		std::string line = "line " + std::to_string(seq) + "\r\n";
+		sb.append(seq, seq * 10, 0, (const uint8_t *)line.data(), line.size());
+	}
+}
+
+static std::vector<uint32_t> readAll(const SerialScrollback &sb, uint64_t cursor) {
+	std::vector<uint32_t> seqs;
+	SerialScrollbackRecord rec;
+	uint8_t buf[64];
+	while (sb.read(cursor, rec, buf, sizeof(buf))) {
+		std::string expect = "line " + std::to_string(rec.seq) + "\r\n";
+		TEST_ASSERT_EQUAL(expect.size(), rec.len);
+		TEST_ASSERT_EQUAL(0, memcmp(buf, expect.data(), rec.len));
+		seqs.push_back(rec.seq);
+	}
+	return seqs;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_keeps_newest_blocks_when_full() {
+	SerialScrollback sb;
+	sb.reset(mem, sizeof(mem));
+	fill(sb, 0, 500);
+	TEST_ASSERT_TRUE(sb.size() <= sizeof(mem));
+	std::vector<uint32_t> seqs = readAll(sb, sb.begin());
+	TEST_ASSERT_EQUAL(sb.count(), seqs.size());
+	TEST_ASSERT_EQUAL(sb.firstSeq(), seqs.front());
+	TEST_ASSERT_EQUAL(499, seqs.back());
+	for (size_t i = 1; i < seqs.size(); ++i) TEST_ASSERT_EQUAL(seqs[i - 1] + 1, seqs[i]);
+}
+
+void test_seek_seq_resumes_without_gap() {
+	SerialScrollback sb;
+	sb.reset(mem, sizeof(mem));
+	fill(sb, 100, 130);
+	uint32_t missing = 99;
+	std::vector<uint32_t> seqs = readAll(sb, sb.seekSeq(120, missing));
+	TEST_ASSERT_EQUAL(0, missing);
+	TEST_ASSERT_EQUAL(10, seqs.size());
+	TEST_ASSERT_EQUAL(120, seqs.front());
+
+	// zu alt: ab dem ältesten Block, Lücke wird gemeldet
+	sb.seekSeq(90, missing);
+	TEST_ASSERT_EQUAL(10, missing);
+
+	// schon aktuell: nichts nachzuladen
+	TEST_ASSERT_EQUAL(sb.end(), sb.seekSeq(130, missing));
+}
+
+void test_seek_seq_across_wraparound() {
+	SerialScrollback sb;
+	sb.reset(mem, sizeof(mem));
+	fill(sb, 0xFFFFFFF0u, 0xFFFFFFFFu);
+	fill(sb, 0, 5);
+	uint32_t missing = 0;
+	std::vector<uint32_t> seqs = readAll(sb, sb.seekSeq(0xFFFFFFFEu, missing));
+	TEST_ASSERT_EQUAL(6, seqs.size());
+	TEST_ASSERT_EQUAL(4, seqs.back());
+}
+
+void test_seek_tail_limits_bytes() {
+	SerialScrollback sb;
+	sb.reset(mem, sizeof(mem));
+	fill(sb, 0, 20);  // "line 10\r\n" .. "line 19\r\n" = je 9 Bytes
+	std::vector<uint32_t> seqs = readAll(sb, sb.seekTail(27));
+	TEST_ASSERT_EQUAL(3, seqs.size());
+	TEST_ASSERT_EQUAL(17, seqs.front());
+}
+
+void test_overwritten_cursor_becomes_invalid() {
+	SerialScrollback sb;
+	sb.reset(mem, sizeof(mem));
+	fill(sb, 0, 10);
+	uint64_t cursor = sb.begin();
+	fill(sb, 10, 200);
+	TEST_ASSERT_FALSE(sb.valid(cursor));
+	SerialScrollbackRecord rec;
+	uint8_t buf[64];
+	TEST_ASSERT_FALSE(sb.read(cursor, rec, buf, sizeof(buf)));
+	TEST_ASSERT_TRUE(sb.valid(sb.begin()));
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_keeps_newest_blocks_when_full);
+	RUN_TEST(test_seek_seq_resumes_without_gap);
+	RUN_TEST(test_seek_seq_across_wraparound);
+	RUN_TEST(test_seek_tail_limits_bytes);
+	RUN_TEST(test_overwritten_cursor_becomes_invalid);
+	return UNITY_END();
+}
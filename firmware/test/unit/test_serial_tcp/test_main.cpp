@@ -0,0 +1,365 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für den Roh-/RFC-2217-Server und den Telnet-Codec.
+ *
+ * Der Server läuft gegen eine UART auf einem Pseudo-Terminal (`PtyUart.h`); eine Pumpe im
+ * Hintergrund übernimmt die Rollen von Bridge-Task (UART lesen, onRx) und Server-Task (poll).
+ * Die Clients sind echte TCP-Verbindungen auf 127.0.0.1.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "PtyUart.h"
+#include "Rfc2217Codec.h"
+#include "SerialTcpServer.h"
+
+static const uint8_t IAC = Rfc2217Codec::IAC;
+static const uint8_t SB = Rfc2217Codec::SB;
+static const uint8_t SE = Rfc2217Codec::SE;
+static const uint8_t WILL = Rfc2217Codec::WILL;
+static const uint8_t COM_PORT = Rfc2217Codec::OPT_COM_PORT;
+
+/**
+ * @brief Serielle Seite für den Codec allein: merkt sich Aufrufe.
+ */
+class RecordingPort : public SerialTcpPort {
+   public:
+	uint32_t rate = 9600;
+	uint32_t setCalls = 0;
+	uint32_t purges = 0;
+
+	size_t write(const uint8_t *, size_t len) override {
+		return len;
+	}
+	uint32_t setBaud(uint32_t b) override {
+		setCalls++;
+		if (b == 115200 || b == 9600) rate = b;
+		return rate;
+	}
+	uint32_t baud() override {
+		return rate;
+	}
+	void purge(bool, bool) override {
+		purges++;
+	}
+};
+
+/**
+ * @brief Serielle Seite auf einer PtyUart (wie die SerialBridge, nur ohne TX-Task).
+ */
+class PtyLink : public SerialTcpPort {
+   public:
+	explicit PtyLink(PtyUart &uart) : _uart(uart) {
+	}
+	size_t write(const uint8_t *data, size_t len) override {
+		return _uart.write(data, len);
+	}
+	uint32_t setBaud(uint32_t b) override {
+		if (b == 9600 || b == 57600 || b == 115200) _uart.begin(b);
+		return _uart.baud;
+	}
+	uint32_t baud() override {
+		return _uart.baud;
+	}
+	void purge(bool rx, bool) override {
+		if (rx) _uart.flushInput();
+	}
+
+   private:
+	PtyUart &_uart;
+};
+
+/**
+ * @brief Server mit UART, Pumpe im Hintergrund und freien Ports.
+ */
+class Rig {
+   public:
+	PtyUart uart;
+	PtyLink link;
+	SerialTcpServer server;
+	uint16_t rawPort;
+	uint16_t rfcPort;
+
+	Rig() : link(uart), server(link), rawPort(freePort()), rfcPort(freePort()), _run(true) {
+		uart.begin(9600);
+		TEST_ASSERT_TRUE(uart.ok());
+		TEST_ASSERT_TRUE(server.begin(rawPort, rfcPort));
+		_pump = std::thread([this]() {
+			uint8_t buf[256];
+			while (_run) {
+				size_t n;
+				while ((n = uart.read(buf, sizeof(buf))) > 0) server.onRx(buf, n);
+				server.poll(2);
+			}
+		});
+	}
+
+	~Rig() {
+		_run = false;
+		_pump.join();
+		server.end();
+	}
+
+	/// Gerät sendet Bytes an die UART
+	void deviceSend(const std::string &data) {
+		TEST_ASSERT_EQUAL(data.size(), ::write(uart.deviceFd(), data.data(), data.size()));
+	}
+
+	/// Liest bis zu `len` Bytes, die beim Gerät ankommen
+	std::string deviceRead(size_t len, int timeoutMs = 1000) {
+		return readFd(uart.deviceFd(), len, timeoutMs);
+	}
+
+	static std::string readFd(int fd, size_t len, int timeoutMs = 1000) {
+		std::string out;
+		auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+		while (out.size() < len) {
+			int left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(until - std::chrono::steady_clock::now()).count();
+			if (left <= 0) break;
+			pollfd pfd = {fd, POLLIN, 0};
+			if (::poll(&pfd, 1, left) <= 0) break;
+			char buf[512];
+			ssize_t n = ::read(fd, buf, std::min(sizeof(buf), len - out.size()));
+			if (n <= 0) break;
+			out.append(buf, (size_t)n);
+		}
+		return out;
+	}
+
+	static int connectTo(uint16_t port) {
+		int fd = socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(port);
+		TEST_ASSERT_EQUAL(0, connect(fd, (sockaddr *)&addr, sizeof(addr)));
+		return fd;
+	}
+
+	/// Freier TCP-Port auf 127.0.0.1
+	static uint16_t freePort() {
+		int fd = socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		bind(fd, (sockaddr *)&addr, sizeof(addr));
+		socklen_t len = sizeof(addr);
+		getsockname(fd, (sockaddr *)&addr, &len);
+		::close(fd);
+		return ntohs(addr.sin_port);
+	}
+
+	/// Wartet, bis der Server `n` Clients angenommen hat
+	void waitClients(size_t n) {
+		for (int i = 0; i < 500 && server.clientCount() != n; ++i) usleep(1000);
+		TEST_ASSERT_EQUAL(n, server.clientCount());
+	}
+
+   private:
+	std::atomic<bool> _run;
+	std::thread _pump;
+};
+
+static std::string bytes(std::initializer_list<uint8_t> list) {
+	return std::string(list.begin(), list.end());
+}
+
+static std::string baudCommand(uint8_t code, uint32_t baud) {
+	return bytes({IAC, SB, COM_PORT, code, (uint8_t)(baud >> 24), (uint8_t)(baud >> 16), (uint8_t)(baud >> 8), (uint8_t)baud, IAC, SE});
+}
+
+static void sendAll(int fd, const std::string &data) {
+	TEST_ASSERT_EQUAL(data.size(), send(fd, data.data(), data.size(), 0));
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_codec_greeting_and_negotiation() {
+	RecordingPort port;
+	Rfc2217Codec codec(port);
+	uint8_t out[Rfc2217Codec::REPLY_MAX];
+	size_t n = codec.takeReply(out, sizeof(out));
+	TEST_ASSERT_EQUAL(15, n);
+	TEST_ASSERT_EQUAL(0, memcmp(out + 12, bytes({IAC, Rfc2217Codec::DO, COM_PORT}).data(), 3));
+
+	// Bestätigung der eigenen Anfragen wird nicht erneut beantwortet, unbekannte Optionen abgelehnt
+	std::string in = bytes({IAC, WILL, COM_PORT, IAC, Rfc2217Codec::DO, Rfc2217Codec::OPT_BINARY, IAC, Rfc2217Codec::DO, 1});
+	uint8_t data[32];
+	TEST_ASSERT_EQUAL(0, codec.decode((const uint8_t *)in.data(), in.size(), data, true));
+	TEST_ASSERT_TRUE(codec.comPortActive());
+	n = codec.takeReply(out, sizeof(out));
+	TEST_ASSERT_EQUAL(3, n);
+	TEST_ASSERT_EQUAL(0, memcmp(out, bytes({IAC, Rfc2217Codec::WONT, 1}).data(), 3));
+}
+
+void test_codec_commands_split_across_blocks() {
+	RecordingPort port;
+	Rfc2217Codec codec(port);
+	uint8_t out[Rfc2217Codec::REPLY_MAX];
+	codec.takeReply(out, sizeof(out));
+
+	// Daten mit maskiertem 0xFF und SET-BAUDRATE, byteweise zugestellt
+	std::string in = "a" + bytes({IAC, IAC}) + "b" + baudCommand(1, 115200) + "c";
+	std::string data;
+	for (char ch : in) {
+		uint8_t buf[1];
+		size_t n = codec.decode((const uint8_t *)&ch, 1, buf, true);
+		data.append((const char *)buf, n);
+	}
+	TEST_ASSERT_TRUE(data == std::string("a\xFF" "bc"));
+	TEST_ASSERT_EQUAL(115200, port.rate);
+	size_t n = codec.takeReply(out, sizeof(out));
+	TEST_ASSERT_TRUE(std::string((const char *)out, n) == baudCommand(101, 115200));
+}
+
+void test_codec_observer_only_reads_settings() {
+	RecordingPort port;
+	Rfc2217Codec codec(port);
+	uint8_t out[Rfc2217Codec::REPLY_MAX];
+	codec.takeReply(out, sizeof(out));
+
+	std::string in = baudCommand(1, 115200) + bytes({IAC, SB, COM_PORT, 12, 3, IAC, SE});
+	uint8_t data[32];
+	codec.decode((const uint8_t *)in.data(), in.size(), data, false);
+	TEST_ASSERT_EQUAL(0, port.setCalls);
+	TEST_ASSERT_EQUAL(0, port.purges);
+	size_t n = codec.takeReply(out, sizeof(out));
+	TEST_ASSERT_TRUE(std::string((const char *)out, n) == baudCommand(101, 9600) + bytes({IAC, SB, COM_PORT, 112, 3, IAC, SE}));
+}
+
+void test_codec_escape() {
+	const uint8_t in[] = {1, 0xFF, 2, 0xFF, 0xFF};
+	uint8_t out[16];
+	size_t consumed = 0;
+	size_t n = Rfc2217Codec::escape(in, sizeof(in), out, sizeof(out), consumed);
+	TEST_ASSERT_EQUAL(sizeof(in), consumed);
+	TEST_ASSERT_TRUE(std::string((const char *)out, n) == bytes({1, 0xFF, 0xFF, 2, 0xFF, 0xFF, 0xFF, 0xFF}));
+
+	// Zu kleiner Zielpuffer: ein 0xFF wird nie halb maskiert
+	n = Rfc2217Codec::escape(in, sizeof(in), out, 2, consumed);
+	TEST_ASSERT_EQUAL(1, consumed);
+	TEST_ASSERT_EQUAL(1, n);
+}
+
+void test_raw_port_is_transparent() {
+	Rig rig;
+	int fd = Rig::connectTo(rig.rawPort);
+	rig.waitClients(1);
+
+	std::string all;
+	for (int i = 0; i < 256; ++i) all += (char)i;
+	sendAll(fd, all);
+	TEST_ASSERT_TRUE(rig.deviceRead(all.size()) == all);
+
+	rig.deviceSend(all);
+	TEST_ASSERT_TRUE(Rig::readFd(fd, all.size()) == all);
+	::close(fd);
+}
+
+void test_observers_read_only_and_writer_handover() {
+	Rig rig;
+	int writer = Rig::connectTo(rig.rawPort);
+	rig.waitClients(1);
+	int observer = Rig::connectTo(rig.rawPort);
+	rig.waitClients(2);
+
+	rig.deviceSend("boot ok\r\n");
+	TEST_ASSERT_TRUE(Rig::readFd(writer, 9) == "boot ok\r\n");
+	TEST_ASSERT_TRUE(Rig::readFd(observer, 9) == "boot ok\r\n");
+
+	sendAll(observer, "ignored");
+	sendAll(writer, "cmd\n");
+	TEST_ASSERT_TRUE(rig.deviceRead(64, 200) == "cmd\n");
+
+	SerialTcpClientInfo info[SerialTcpServer::MAX_CLIENTS];
+	TEST_ASSERT_EQUAL(2, rig.server.clients(info, SerialTcpServer::MAX_CLIENTS));
+	TEST_ASSERT_TRUE(info[0].writer);
+	TEST_ASSERT_FALSE(info[1].writer);
+	TEST_ASSERT_EQUAL(7, info[1].ignored);
+	TEST_ASSERT_EQUAL(4, info[0].txBytes);
+
+	// Schreiber trennt sich: der Mithörer übernimmt
+	::close(writer);
+	rig.waitClients(1);
+	sendAll(observer, "next\n");
+	TEST_ASSERT_TRUE(rig.deviceRead(5) == "next\n");
+	TEST_ASSERT_EQUAL(1, rig.server.clients(info, SerialTcpServer::MAX_CLIENTS));
+	TEST_ASSERT_TRUE(info[0].writer);
+	::close(observer);
+}
+
+void test_rfc2217_sets_baud_and_escapes_data() {
+	Rig rig;
+	int fd = Rig::connectTo(rig.rfcPort);
+	rig.waitClients(1);
+	TEST_ASSERT_EQUAL(15, Rig::readFd(fd, 15).size());  // WILL/DO BINARY, WILL/DO SGA, DO COM-PORT
+
+	sendAll(fd, bytes({IAC, WILL, COM_PORT}) + baudCommand(1, 115200));
+	TEST_ASSERT_TRUE(Rig::readFd(fd, 10) == baudCommand(101, 115200));
+	TEST_ASSERT_EQUAL(115200, rig.uart.baud);
+
+	// Nicht unterstützte Rate: Antwort mit der weiterhin aktiven Rate
+	sendAll(fd, baudCommand(1, 12345));
+	TEST_ASSERT_TRUE(Rig::readFd(fd, 10) == baudCommand(101, 115200));
+
+	sendAll(fd, bytes({'x', IAC, IAC, 'y'}));
+	TEST_ASSERT_TRUE(rig.deviceRead(3) == bytes({'x', 0xFF, 'y'}));
+
+	rig.deviceSend(bytes({0xFF, 'z'}));
+	TEST_ASSERT_TRUE(Rig::readFd(fd, 3) == bytes({IAC, IAC, 'z'}));
+	::close(fd);
+}
+
+void test_full_client_buffer_drops_and_counts() {
+	PtyUart uart;
+	PtyLink link(uart);
+	SerialTcpServer server(link);
+	uint16_t port = Rig::freePort();
+	TEST_ASSERT_TRUE(server.begin(port, 0));
+	int fd = Rig::connectTo(port);
+	for (int i = 0; i < 100 && server.clientCount() == 0; ++i) server.poll(10);
+	TEST_ASSERT_EQUAL(1, server.clientCount());
+
+	// Ohne poll() läuft der Ringpuffer voll; der Rest wird verworfen und gezählt
+	uint8_t block[1000];
+	memset(block, 'A', sizeof(block));
+	for (int i = 0; i < 5; ++i) server.onRx(block, sizeof(block));
+	SerialTcpStats stats = server.stats();
+	TEST_ASSERT_EQUAL(5000 - SerialTcpServer::CLIENT_BUFFER, stats.dropped);
+
+	for (int i = 0; i < 20; ++i) server.poll(1);
+	TEST_ASSERT_EQUAL(SerialTcpServer::CLIENT_BUFFER, Rig::readFd(fd, 5000, 300).size());
+	::close(fd);
+	server.end();
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_codec_greeting_and_negotiation);
+	RUN_TEST(test_codec_commands_split_across_blocks);
+	RUN_TEST(test_codec_observer_only_reads_settings);
+	RUN_TEST(test_codec_escape);
+	RUN_TEST(test_raw_port_is_transparent);
+	RUN_TEST(test_observers_read_only_and_writer_handover);
+	RUN_TEST(test_rfc2217_sets_baud_and_escapes_data);
+	RUN_TEST(test_full_client_buffer_drops_and_counts);
+	return UNITY_END();
+}
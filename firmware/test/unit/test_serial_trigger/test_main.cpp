@@ -0,0 +1,200 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests und Benchmark für die Regeln auf dem seriellen Datenstrom.
+ */
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DeviceCapture.h"
+#include "SerialTrigger.h"
+
+static SerialTriggerRule makeRule(const char *name, const char *text, uint8_t actions = TRIGGER_ACTION_ALERT, uint32_t cooldownMs = 0) {
+	SerialTriggerRule r;
+	memset(&r, 0, sizeof(r));
+	snprintf(r.name, sizeof(r.name), "%s", name);
+	snprintf(r.text, sizeof(r.text), "%s", text);
+	r.actions = actions;
+	r.level = TRIGGER_WARNING;
+	r.cooldownMs = cooldownMs;
+	return r;
+}
+
+static uint32_t feed(SerialTrigger &t, const char *line, uint32_t now) {
+	return t.onLine((const uint8_t *)line, strlen(line), now);
+}
+
+/**
+ * @brief Zerlegt den Mitschnitt in Zeilen ohne Zeilenende.
+ */
+static std::vector<std::string> captureLines() {
+	std::vector<std::string> lines;
+	std::string cur;
+	for (size_t i = 0; i < DEVICE_CAPTURE_LEN; ++i) {
+		char c = DEVICE_CAPTURE[i];
+		if (c == '\r') continue;
+		if (c == '\n') {
+			lines.push_back(cur);
+			cur.clear();
+		} else {
+			cur += c;
+		}
+	}
+	return lines;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_rules_fire_and_count() {
+	static SerialTriggerConfig cfg;
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.rules[cfg.count++] = makeRule("overtemp", "OVERTEMP");
+	cfg.rules[cfg.count++] = makeRule("boot", "HT-CTRL Bootloader", TRIGGER_ACTION_LOG);
+	cfg.rules[cfg.count] = makeRule("warn", "warn", TRIGGER_ACTION_STATUS);
+	cfg.rules[cfg.count].prefix = false;
+	cfg.rules[cfg.count++].ignoreCase = true;
+	cfg.rules[cfg.count] = makeRule("ack", "OK");
+	cfg.rules[cfg.count++].prefix = true;
+
+	SerialTrigger t;
+	char err[64];
+	TEST_ASSERT_TRUE_MESSAGE(t.build(cfg, err, sizeof(err)), err);
+	TEST_ASSERT_EQUAL(4, t.count());
+
+	TEST_ASSERT_EQUAL_HEX32(0x1, feed(t, "E17 OVERTEMP zone3", 0));
+	TEST_ASSERT_EQUAL_HEX32(0x2, feed(t, "HT-CTRL Bootloader v2.3.1", 0));
+	TEST_ASSERT_EQUAL_HEX32(0x4, feed(t, "[0001.009] WARN zone4", 0));
+	TEST_ASSERT_EQUAL_HEX32(0x8, feed(t, "OK rec", 0));
+	TEST_ASSERT_EQUAL_HEX32(0x0, feed(t, "NOT OK", 0));
+	TEST_ASSERT_EQUAL_HEX32(0x0, feed(t, "overtemp", 0));
+	TEST_ASSERT_EQUAL_UINT32(6, t.lines());
+
+	SerialTriggerRule r;
+	SerialTriggerStats st;
+	TEST_ASSERT_TRUE(t.rule(0, r, st));
+	TEST_ASSERT_EQUAL_STRING("overtemp", r.name);
+	TEST_ASSERT_EQUAL_UINT32(1, st.hits);
+	TEST_ASSERT_EQUAL_UINT32(1, st.fired);
+	TEST_ASSERT_FALSE(t.rule(4, r, st));
+}
+
+void test_cooldown_suppresses_but_counts() {
+	static SerialTriggerConfig cfg;
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.rules[cfg.count++] = makeRule("fault", "FAULT", TRIGGER_ACTION_ALERT, 1000);
+	cfg.rules[cfg.count++] = makeRule("fault-log", "FAULT", TRIGGER_ACTION_LOG, 0);
+	SerialTrigger t;
+	char err[64];
+	TEST_ASSERT_TRUE(t.build(cfg, err, sizeof(err)));
+	TEST_ASSERT_EQUAL(1, t.patterns());
+
+	TEST_ASSERT_EQUAL_HEX32(0x3, feed(t, "FAULT 1", 5000));
+	TEST_ASSERT_EQUAL_HEX32(0x2, feed(t, "FAULT 2", 5500));
+	TEST_ASSERT_EQUAL_HEX32(0x2, feed(t, "FAULT 3", 5999));
+	TEST_ASSERT_EQUAL_HEX32(0x3, feed(t, "FAULT 4", 6000));
+
+	SerialTriggerRule r;
+	SerialTriggerStats st;
+	TEST_ASSERT_TRUE(t.rule(0, r, st));
+	TEST_ASSERT_EQUAL_UINT32(4, st.hits);
+	TEST_ASSERT_EQUAL_UINT32(2, st.fired);
+	TEST_ASSERT_EQUAL_UINT32(6000, st.lastMs);
+}
+
+void test_invalid_rules() {
+	static SerialTriggerConfig cfg;
+	SerialTrigger t;
+	char err[64];
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.rules[cfg.count++] = makeRule("a", "X");
+	cfg.rules[cfg.count++] = makeRule("a", "Y");
+	TEST_ASSERT_FALSE(t.build(cfg, err, sizeof(err)));
+	TEST_ASSERT_EQUAL_STRING("a: Name doppelt", err);
+	TEST_ASSERT_EQUAL(0, t.count());
+	TEST_ASSERT_EQUAL_HEX32(0, feed(t, "X", 0));
+
+	cfg.rules[1] = makeRule("b", "Y", 0);
+	TEST_ASSERT_FALSE(t.build(cfg, err, sizeof(err)));
+	TEST_ASSERT_EQUAL_STRING("b: Keine gültige Aktion", err);
+
+	cfg.rules[1] = makeRule("b", "");
+	TEST_ASSERT_FALSE(t.build(cfg, err, sizeof(err)));
+
+	cfg.rules[1] = makeRule("b", "Y", TRIGGER_ACTION_LOG, SerialTrigger::MAX_COOLDOWN_MS + 1);
+	TEST_ASSERT_FALSE(t.build(cfg, err, sizeof(err)));
+
+	// Lange, paarweise verschiedene Texte füllen den Präfixbaum
+	memset(&cfg, 0, sizeof(cfg));
+	char name[8], text[64];
+	for (size_t i = 0; i < SerialTriggerConfig::MAX_RULES; ++i) {
+		snprintf(name, sizeof(name), "r%u", (unsigned)i);
+		for (size_t k = 0; k < sizeof(text) - 1; ++k) text[k] = (char)('A' + (i + k * 7) % 26);
+		text[sizeof(text) - 1] = '\0';
+		cfg.rules[cfg.count++] = makeRule(name, text);
+	}
+	TEST_ASSERT_FALSE(t.build(cfg, err, sizeof(err)));
+	TEST_ASSERT_NOT_NULL(strstr(err, "Musterspeicher voll"));
+}
+
+void test_benchmark_rule_scaling() {
+	// Kosten pro Zeile mit wachsender Regelzahl: Automat gegen eine Suche pro Regel
+	std::vector<std::string> lines = captureLines();
+	static const char *TEXTS[] = {"OVERTEMP", "E17",      "FAULT",    "WARN",       "Bootloader", "watchdog", "CRC",   "abort",
+	                              "zone9",    "pv=999",   "ERR:1",    "stack",      "brownout",   "panic",    "reset", "timeout",
+	                              "sensor",   "open",     "short",    "underrun",   "overrun",    "NAK",      "retry", "lost",
+	                              "failed",   "denied",   "assert",   "HardFault",  "low batt",   "door",     "estop", "rec99"};
+	static SerialTriggerConfig cfg;
+	const int rounds = 200;
+	for (size_t n : {1u, 8u, 16u, 32u}) {
+		memset(&cfg, 0, sizeof(cfg));
+		char name[8];
+		for (size_t i = 0; i < n; ++i) {
+			snprintf(name, sizeof(name), "r%u", (unsigned)i);
+			cfg.rules[cfg.count++] = makeRule(name, TEXTS[i], TRIGGER_ACTION_LOG);
+		}
+		SerialTrigger t;
+		char err[64];
+		TEST_ASSERT_TRUE_MESSAGE(t.build(cfg, err, sizeof(err)), err);
+
+		size_t autoHits = 0;
+		auto t0 = std::chrono::steady_clock::now();
+		for (int r = 0; r < rounds; ++r) {
+			for (const auto &l : lines) autoHits += t.onLine((const uint8_t *)l.data(), l.size(), 0) != 0;
+		}
+		double autoSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+		size_t naiveHits = 0;
+		t0 = std::chrono::steady_clock::now();
+		for (int r = 0; r < rounds; ++r) {
+			for (const auto &l : lines) {
+				bool hit = false;
+				for (size_t i = 0; i < n; ++i) hit |= l.find(TEXTS[i]) != std::string::npos;
+				naiveHits += hit;
+			}
+		}
+		double naiveSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+		double count = (double)lines.size() * rounds;
+		printf("[trigger] %2u rules: automaton %7.1f ns/line, per-rule search %7.1f ns/line\n", (unsigned)n, autoSec * 1e9 / count,
+		       naiveSec * 1e9 / count);
+		TEST_ASSERT_EQUAL(naiveHits, autoHits);
+	}
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_rules_fire_and_count);
+	RUN_TEST(test_cooldown_suppresses_but_counts);
+	RUN_TEST(test_invalid_rules);
+	RUN_TEST(test_benchmark_rule_scaling);
+	return UNITY_END();
+}
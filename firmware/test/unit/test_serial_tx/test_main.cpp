@@ -0,0 +1,157 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für die Sendewarteschlange der SerialBridge (SerialTx).
+ */
+
+#include <unity.h>
+
+#include <string>
+#include <vector>
+
+#include "FakeUart.h"
+#include "SerialTx.h"
+
+struct Done {
+	uint32_t client;
+	uint32_t job;
+	size_t bytes;
+	std::string writtenAt;  ///< Inhalt der UART zum Zeitpunkt der Meldung
+};
+
+struct Recorder {
+	FakeUart *uart;
+	std::vector<Done> done;
+	static void sink(void *ctx, uint32_t client, uint32_t job, size_t bytes, bool) {
+		auto *r = static_cast<Recorder *>(ctx);
+		r->done.push_back(Done{client, job, bytes, r->uart->written});
+	}
+};
+
+static uint32_t submit(SerialTx &tx, uint32_t client, const std::string &s) {
+	return tx.submit(client, (const uint8_t *)s.data(), s.size());
+}
+
+static SerialTxConfig plain() {
+	SerialTxConfig cfg = {};
+	cfg.flow = SERIAL_FLOW_NONE;
+	return cfg;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_jobs_are_sent_in_order_and_reported_after_transmission() {
+	FakeUart uart;
+	Recorder rec{&uart, {}};
+	SerialTx tx(uart, Recorder::sink, &rec);
+
+	uint32_t a = submit(tx, 7, "first\r\n");
+	uint32_t b = submit(tx, 9, std::string(700, 'x'));
+	TEST_ASSERT_NOT_EQUAL(0, a);
+	TEST_ASSERT_NOT_EQUAL(a, b);
+	TEST_ASSERT_EQUAL_STRING("", uart.written.c_str());  // submit() schreibt nie selbst
+
+	TEST_ASSERT_EQUAL(2, tx.service());
+	TEST_ASSERT_EQUAL(2, rec.done.size());
+	TEST_ASSERT_EQUAL(7, rec.done[0].client);
+	TEST_ASSERT_EQUAL(a, rec.done[0].job);
+	TEST_ASSERT_EQUAL_STRING("first\r\n", rec.done[0].writtenAt.c_str());
+	TEST_ASSERT_EQUAL(700, rec.done[1].bytes);
+	TEST_ASSERT_EQUAL(7 + 700, uart.written.size());
+	TEST_ASSERT_EQUAL(0, tx.stats().queuedBytes);
+	TEST_ASSERT_EQUAL(0, tx.service());
+}
+
+void test_full_queue_rejects_without_partial_write() {
+	FakeUart uart;
+	SerialTx tx(uart, nullptr, nullptr);
+	std::string block(SerialTx::QUEUE_BYTES / 2, 'a');
+	TEST_ASSERT_NOT_EQUAL(0, submit(tx, 1, block));
+	TEST_ASSERT_EQUAL(0, submit(tx, 1, block));  // Verwaltungsdaten passen nicht mehr
+	TEST_ASSERT_EQUAL(1, tx.stats().rejected);
+	tx.service();
+	TEST_ASSERT_EQUAL(block.size(), uart.written.size());
+	TEST_ASSERT_NOT_EQUAL(0, submit(tx, 1, block));
+}
+
+void test_line_pacing_waits_after_each_newline() {
+	FakeUart uart;
+	SerialTx tx(uart, nullptr, nullptr);
+	SerialTxConfig cfg = plain();
+	cfg.lineDelayMs = 50;
+	TEST_ASSERT_TRUE(tx.configure(cfg));
+
+	submit(tx, 1, "a\r\nb\r\nc");
+	tx.service();
+	TEST_ASSERT_EQUAL_STRING("a\r\nb\r\nc", uart.written.c_str());
+	TEST_ASSERT_EQUAL(100, uart.clock);
+}
+
+void test_char_pacing_delays_every_byte() {
+	FakeUart uart;
+	SerialTx tx(uart, nullptr, nullptr);
+	SerialTxConfig cfg = plain();
+	cfg.charDelayUs = 250;
+	TEST_ASSERT_TRUE(tx.configure(cfg));
+
+	submit(tx, 1, "HELLO");
+	tx.service();
+	TEST_ASSERT_EQUAL_STRING("HELLO", uart.written.c_str());
+	TEST_ASSERT_EQUAL(5 * 250, uart.busyUs);
+	TEST_ASSERT_TRUE(uart.txDoneCalls >= 5);
+}
+
+void test_rs485_driver_enable_wraps_each_burst() {
+	FakeUart uart;
+	SerialTx tx(uart, nullptr, nullptr);
+	SerialTxConfig cfg = plain();
+	cfg.rs485 = true;
+	cfg.deLeadUs = 30;
+	cfg.deTailUs = 70;
+	TEST_ASSERT_TRUE(tx.configure(cfg));
+
+	submit(tx, 1, "ping");
+	tx.service();
+	TEST_ASSERT_EQUAL_STRING("<DE+>ping<DE->", uart.trace.c_str());
+	TEST_ASSERT_EQUAL(100, uart.busyUs);
+
+	uart.trace.clear();
+	cfg.lineDelayMs = 10;
+	TEST_ASSERT_TRUE(tx.configure(cfg));
+	submit(tx, 1, "a\nb\n");
+	tx.service();
+	TEST_ASSERT_EQUAL_STRING("<DE+>a\n<DE-><DE+>b\n<DE->", uart.trace.c_str());
+}
+
+void test_flow_control_is_passed_to_port_and_validated() {
+	FakeUart uart;
+	SerialTx tx(uart, nullptr, nullptr);
+	SerialTxConfig cfg = plain();
+
+	cfg.flow = SERIAL_FLOW_XON_XOFF;
+	TEST_ASSERT_TRUE(tx.configure(cfg));
+	TEST_ASSERT_EQUAL(SERIAL_FLOW_XON_XOFF, uart.flow);
+
+	cfg.flow = SERIAL_FLOW_RTS_CTS;
+	cfg.rs485 = true;
+	TEST_ASSERT_FALSE(tx.configure(cfg));  // RTS-Pin kann nicht doppelt belegt werden
+
+	cfg.rs485 = false;
+	uart.hwFlow = false;
+	TEST_ASSERT_FALSE(tx.configure(cfg));
+	TEST_ASSERT_EQUAL(SERIAL_FLOW_XON_XOFF, tx.config().flow);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_jobs_are_sent_in_order_and_reported_after_transmission);
+	RUN_TEST(test_full_queue_rejects_without_partial_write);
+	RUN_TEST(test_line_pacing_waits_after_each_newline);
+	RUN_TEST(test_char_pacing_delays_every_byte);
+	RUN_TEST(test_rs485_driver_enable_wraps_each_burst);
+	RUN_TEST(test_flow_control_is_passed_to_port_and_validated);
+	return UNITY_END();
+}
@@ -0,0 +1,154 @@
+/**
+ * @file test_main.cpp
+ * @brief Native Tests für die Sendewarteschlangen pro WebSocket-Client (WsOutbox).
+ */
+
+#include <unity.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "WsOutbox.h"
+
+/**
+ * @brief Sink, bei dem jeder Client pro pump() nur eine begrenzte Anzahl Nachrichten annimmt.
+ */
+class FakeSink : public WsOutboxSink {
+   public:
+	std::map<uint32_t, int> credit;                    ///< Annahmefähigkeit je Client
+	std::map<uint32_t, std::vector<std::string>> got;  ///< Empfangene Nachrichten
+	std::vector<uint32_t> closed;                      ///< Getrennte Clients
+
+	bool canSend(uint32_t id) override {
+		return credit[id] > 0;
+	}
+	void send(uint32_t id, const uint8_t *data, size_t len, bool) override {
+		credit[id]--;
+		got[id].push_back(std::string((const char *)data, len));
+	}
+	void close(uint32_t id) override {
+		closed.push_back(id);
+	}
+};
+
+static bool put(WsOutbox &out, uint32_t id, WsPriority prio, const std::string &msg, uint32_t now = 0) {
+	return out.enqueue(id, prio, (const uint8_t *)msg.data(), msg.size(), false, now);
+}
+
+static WsClientStats statsOf(WsOutbox &out, uint32_t id) {
+	WsClientStats all[WsOutbox::MAX_CLIENTS];
+	size_t n = out.stats(all, WsOutbox::MAX_CLIENTS);
+	for (size_t i = 0; i < n; ++i)
+		if (all[i].id == id) return all[i];
+	return WsClientStats{};
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_control_overtakes_bulk() {
+	FakeSink sink;
+	WsOutbox out(sink);
+	TEST_ASSERT_TRUE(out.attach(1));
+	for (int i = 0; i < 10; ++i) put(out, 1, WS_PRIO_BULK, "data" + std::to_string(i));
+	put(out, 1, WS_PRIO_CONTROL, "reply");
+	sink.credit[1] = 1;
+	out.pump(0);
+	TEST_ASSERT_EQUAL(1, sink.got[1].size());
+	TEST_ASSERT_EQUAL_STRING("reply", sink.got[1][0].c_str());
+	sink.credit[1] = 100;
+	out.pump(0);
+	TEST_ASSERT_EQUAL(11, sink.got[1].size());
+	TEST_ASSERT_EQUAL_STRING("data0", sink.got[1][1].c_str());
+}
+
+void test_drop_oldest_keeps_budget_and_newest_data() {
+	FakeSink sink;
+	WsOutbox out(sink);
+	out.configure({4096, 65536, WS_SLOW_DROP_OLDEST});
+	TEST_ASSERT_TRUE(out.attach(1));
+	std::string line(100, 'x');
+	for (int i = 0; i < 200; ++i) put(out, 1, WS_PRIO_BULK, line + std::to_string(i));
+
+	WsClientStats st = statsOf(out, 1);
+	TEST_ASSERT_TRUE(st.queuedBytes <= 4096 - WsOutbox::CONTROL_SHARE);
+	TEST_ASSERT_EQUAL(200, st.drops + st.queued);
+
+	sink.credit[1] = 1000;
+	out.pump(0);
+	TEST_ASSERT_EQUAL_STRING((line + "199").c_str(), sink.got[1].back().c_str());
+}
+
+void test_coalesce_sends_single_gap_notice() {
+	FakeSink sink;
+	WsOutbox out(sink);
+	out.configure({4096, 65536, WS_SLOW_COALESCE});
+	TEST_ASSERT_TRUE(out.attach(1));
+	std::string line(100, 'y');
+	for (int i = 0; i < 200; ++i) put(out, 1, WS_PRIO_BULK, line);
+
+	sink.credit[1] = 1000;
+	out.pump(0);
+	TEST_ASSERT_TRUE(sink.got[1].size() > 1);
+	const std::string &gap = sink.got[1][0];
+	TEST_ASSERT_TRUE(gap.find("\"action\":\"gap\"") != std::string::npos);
+	for (size_t i = 1; i < sink.got[1].size(); ++i) TEST_ASSERT_EQUAL_STRING(line.c_str(), sink.got[1][i].c_str());
+	TEST_ASSERT_EQUAL(200, statsOf(out, 1).drops + sink.got[1].size() - 1);
+}
+
+void test_disconnect_policy_closes_slow_client_only() {
+	FakeSink sink;
+	WsOutbox out(sink);
+	out.configure({4096, 65536, WS_SLOW_DISCONNECT});
+	TEST_ASSERT_TRUE(out.attach(1));
+	TEST_ASSERT_TRUE(out.attach(2));
+	std::string line(100, 'z');
+	for (int i = 0; i < 100; ++i) {
+		out.broadcast(WS_PRIO_BULK, (const uint8_t *)line.data(), line.size(), false, i);
+		sink.credit[2] = 1;  // Client 2 ist schnell, Client 1 nimmt nichts an
+		out.pump(i);
+	}
+	TEST_ASSERT_EQUAL(1, sink.closed.size());
+	TEST_ASSERT_EQUAL(1, sink.closed[0]);
+	TEST_ASSERT_EQUAL(100, sink.got[2].size());
+	TEST_ASSERT_FALSE(put(out, 1, WS_PRIO_CONTROL, "late"));
+}
+
+void test_total_budget_limits_clients() {
+	FakeSink sink;
+	WsOutbox out(sink);
+	out.configure({8192, 16384, WS_SLOW_DROP_OLDEST});
+	TEST_ASSERT_TRUE(out.attach(1));
+	TEST_ASSERT_TRUE(out.attach(2));
+	TEST_ASSERT_FALSE(out.attach(3));
+	out.detach(1);
+	TEST_ASSERT_TRUE(out.attach(3));
+	TEST_ASSERT_EQUAL(8192, statsOf(out, 3).budget);
+}
+
+void test_max_queueing_delay_is_recorded() {
+	FakeSink sink;
+	WsOutbox out(sink);
+	TEST_ASSERT_TRUE(out.attach(7));
+	put(out, 7, WS_PRIO_BULK, "a", 100);
+	put(out, 7, WS_PRIO_BULK, "b", 150);
+	sink.credit[7] = 2;
+	out.pump(400);
+	TEST_ASSERT_EQUAL(300, statsOf(out, 7).maxDelayMs);
+	TEST_ASSERT_EQUAL(2, statsOf(out, 7).sent);
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_control_overtakes_bulk);
+	RUN_TEST(test_drop_oldest_keeps_budget_and_newest_data);
+	RUN_TEST(test_coalesce_sends_single_gap_notice);
+	RUN_TEST(test_disconnect_policy_closes_slow_client_only);
+	RUN_TEST(test_total_budget_limits_clients);
+	RUN_TEST(test_max_queueing_delay_is_recorded);
+	return UNITY_END();
+}
@@ -0,0 +1,99 @@
+/**
+ * @file logdecode.cpp
+ * @brief Host-Werkzeug: setzt Journal-Segmente der Firmware wieder in Textzeilen um.
+ *
+ * Liest Segmente (`journal.<n>.log`, z. B. über `/logfile?segment=...` geladen oder aus einem
+ * LittleFS-Abbild) und gibt jede Meldung als Textzeile aus, wie `/logfile` sie zeigt. Binäre
+ * Einträge werden mit der Formattabelle aus `firmware/include/LogFormats.h` zusammengesetzt;
+ * das Werkzeug muss daher aus demselben Stand wie die Firmware übersetzt werden.
+ *
+ * Aufruf: `logdecode [-l <kategorie>] journal.0.log journal.1.log ...` (ohne Datei: stdin)
+ *
+ * @author Simon Marcel Linden
+ * @since 1.1.0
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "LogCodec.h"
+#include "LogFilter.h"
+#include "LogJournal.h"
+#include "LogQueue.h"
+
+/**
+ * @brief Gibt alle Einträge eines Segments aus.
+ *
+ * @param in Geöffnetes Segment.
+ * @param mask Angezeigte Journal-Kategorien.
+ * @return Anzahl ausgegebener Zeilen.
+ */
+static size_t decodeSegment(FILE *in, uint16_t mask) {
+	uint32_t markTime = 0;
+	size_t lines = 0;
+	std::string line;
+	int c;
+	do {
+		c = fgetc(in);
+		if (c != EOF && c != '\n') {
+			line += (char)c;
+			continue;
+		}
+		if (line.empty()) continue;
+		// Textzeilen enden mit "\r" von println()
+		if (line.back() == '\r') line.pop_back();
+		if (LogJournal::isBinary(line.data(), line.size())) {
+			uint8_t payload[LogCodec::ENTRY_HEADER + LogRecord::TEXT];
+			uint8_t bits;
+			size_t len;
+			LogBinaryEntry entry;
+			if (!LogJournal::parseBinary(line.data(), line.size(), bits, payload, sizeof(payload), len)) {
+				fprintf(stderr, "beschädigte binäre Zeile übersprungen\n");
+			} else if (bits == 0) {
+				LogCodec::decodeMark(payload, len, markTime);
+			} else if ((bits & mask) && LogCodec::decodeEntry(payload, len, entry)) {
+				char text[LogQueue::LINE_BYTES];
+				LogCodec::renderLine(entry.cats, markTime + entry.delta, entry.format, entry.args, entry.argBytes, text, sizeof(text));
+				puts(text);
+				lines++;
+			}
+		} else {
+			uint16_t files;
+			const char *text;
+			if (LogJournal::parse(line.data(), line.size(), files, text) && (files & mask)) {
+				puts(text);
+				lines++;
+			}
+		}
+		line.clear();
+	} while (c != EOF);
+	return lines;
+}
+
+int main(int argc, char **argv) {
+	uint16_t mask = 0xFFFF;
+	int first = 1;
+	if (argc > 2 && strcmp(argv[1], "-l") == 0) {
+		mask = (uint16_t)(LogFilter::parse(argv[2]) & LogFilter::JOURNAL_MASK);
+		if (mask == 0) {
+			fprintf(stderr, "Unbekannte Kategorie: %s\n", argv[2]);
+			return 2;
+		}
+		first = 3;
+	}
+	if (first >= argc) {
+		decodeSegment(stdin, mask);
+		return 0;
+	}
+	for (int i = first; i < argc; ++i) {
+		FILE *in = fopen(argv[i], "rb");
+		if (!in) {
+			fprintf(stderr, "%s: kann nicht geöffnet werden\n", argv[i]);
+			return 1;
+		}
+		decodeSegment(in, mask);
+		fclose(in);
+	}
+	return 0;
+}